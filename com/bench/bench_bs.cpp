@@ -0,0 +1,222 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Micro-benchmark of BitSet set algebra, compare each kernel with the
+//byte loop, and check that all kernels compute the same result.
+//Usage: bench_bs.elf [nbit] [iter]
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "ltype.h"
+#include "comf.h"
+#include "smempool.h"
+#include "sstl.h"
+#include "bs.h"
+
+using namespace xcom;
+
+#define NSET 16
+
+static double bench_sec(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+
+//Reference of BitSet::get_next that scans byte by byte, it is
+//the implementation before word-parallel scanning.
+static INT byte_next(BitSet const& bs, INT elem)
+{
+    BYTE const* ptr = bs.get_byte_vec();
+    UINT const size = bs.get_byte_size();
+    for (UINT i = (UINT)(elem + 1); i < size * BITS_PER_BYTE; i++) {
+        if (ptr[i / BITS_PER_BYTE] == 0) {
+            i = (i / BITS_PER_BYTE + 1) * BITS_PER_BYTE - 1;
+            continue;
+        }
+        if ((ptr[i / BITS_PER_BYTE] & (1 << (i % BITS_PER_BYTE))) != 0) {
+            return (INT)i;
+        }
+    }
+    return -1;
+}
+
+
+//Return true if 'a' and 'b' have the same elements, compare byte by byte
+//so that the result does not depend on the kernel in use.
+static bool is_same(BitSet const& a, BitSet const& b)
+{
+    UINT const na = a.get_byte_size();
+    UINT const nb = b.get_byte_size();
+    UINT const n = MAX(na, nb);
+    for (UINT i = 0; i < n; i++) {
+        BYTE x = i < na ? a.get_byte_vec()[i] : 0;
+        BYTE y = i < nb ? b.get_byte_vec()[i] : 0;
+        if (x != y) { return false; }
+    }
+    return true;
+}
+
+
+//Compute the set algebra and predicates of 'sets' by current kernel.
+//'res': record the result of union/intersect/diff of each set.
+//Return the sum of the predicates and the element counts.
+static UINT compute(BitSet const* sets, OUT BitSet * res)
+{
+    UINT sum = 0;
+    for (UINT i = 0; i < NSET; i++) {
+        res[i].copy(sets[i]);
+        res[i].bunion(sets[(i + 1) % NSET]);
+        res[i].intersect(sets[(i + 2) % NSET]);
+        res[i].diff(sets[(i + 3) % NSET]);
+        sum += sets[i].is_intersect(sets[(i + 5) % NSET]);
+        sum += sets[i].is_contain(sets[(i + 7) % NSET]);
+        sum += sets[i].is_equal(sets[(i + 9) % NSET]);
+        sum += sets[i].get_elem_count();
+        sum += res[i].get_elem_count();
+    }
+    return sum;
+}
+
+
+int main(int argc, char const* argv[])
+{
+    UINT const nbit = argc > 1 ? (UINT)atoi(argv[1]) : 8192;
+    UINT const iter = argc > 2 ? (UINT)atoi(argv[2]) : 20000;
+    srand(0);
+    BitSet sets[NSET];
+    for (UINT i = 0; i < NSET; i++) {
+        //Sparse sets, about 1/16 bits are set.
+        for (UINT j = 0; j < nbit / 16; j++) {
+            sets[i].bunion((UINT)rand() % nbit);
+        }
+    }
+    //Make some sets contain or equal to others, so that the predicates
+    //are not always false.
+    sets[7].copy(sets[0]);
+    sets[7].bunion(sets[14]);
+    sets[9].copy(sets[0]);
+
+    //The byte loop is the reference of other kernels.
+    BitSet ref[NSET];
+    bs_set_kernel(BS_KERNEL_BYTE);
+    UINT const ref_sum = compute(sets, ref);
+
+    BS_KERNEL const kinds[] = { BS_KERNEL_BYTE, BS_KERNEL_WORD,
+                                BS_KERNEL_SSE2, BS_KERNEL_AVX2 };
+    int failed = 0;
+    UINT bench_sum = 0;
+    bool has_bench_sum = false;
+    printf("==---- BitSet benchmark: %u bits, %u rounds ----==\n",
+           nbit, iter);
+    for (UINT k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        if (bs_set_kernel(kinds[k]) != kinds[k]) {
+            printf("%s: not supported\n", bs_get_kernel_name(kinds[k]));
+            continue;
+        }
+
+        BitSet res[NSET];
+        if (compute(sets, res) != ref_sum) {
+            printf("%s: predicate or count mismatch\n",
+                   bs_get_kernel_name(kinds[k]));
+            failed = 1;
+        }
+        for (UINT i = 0; i < NSET; i++) {
+            if (!is_same(res[i], ref[i])) {
+                printf("%s: set algebra mismatch on set %u\n",
+                       bs_get_kernel_name(kinds[k]), i);
+                failed = 1;
+                break;
+            }
+        }
+
+        UINT sum = 0;
+        BitSet tmp;
+        clock_t t = clock();
+        for (UINT i = 0; i < iter; i++) {
+            tmp.copy(sets[i % NSET]);
+            tmp.bunion(sets[(i + 1) % NSET]);
+            tmp.intersect(sets[(i + 2) % NSET]);
+            tmp.diff(sets[(i + 3) % NSET]);
+        }
+        double t_alg = bench_sec(t);
+
+        t = clock();
+        for (UINT i = 0; i < iter; i++) {
+            sum += sets[i % NSET].is_intersect(sets[(i + 5) % NSET]);
+            sum += sets[i % NSET].is_contain(sets[(i + 7) % NSET]);
+            sum += sets[i % NSET].is_equal(sets[(i + 9) % NSET]);
+        }
+        double t_pred = bench_sec(t);
+
+        t = clock();
+        for (UINT i = 0; i < iter; i++) {
+            sum += sets[i % NSET].get_elem_count();
+        }
+        double t_cnt = bench_sec(t);
+
+        if (has_bench_sum && sum != bench_sum) {
+            printf("%s: benchmark result mismatch\n",
+                   bs_get_kernel_name(kinds[k]));
+            failed = 1;
+        }
+        bench_sum = sum;
+        has_bench_sum = true;
+        printf("%s: union/intersect/diff %fsec, "
+               "predicate %fsec, popcount %fsec (%u)\n",
+               bs_get_kernel_name(kinds[k]), t_alg, t_pred, t_cnt, sum);
+    }
+    bs_set_kernel(BS_KERNEL_AUTO);
+
+    //Compare the iteration via get_first/get_next.
+    UINT sum_byte = 0;
+    clock_t t = clock();
+    for (UINT i = 0; i < iter / 16; i++) {
+        BitSet const& bs = sets[i % NSET];
+        for (INT j = bs.get_first(); j >= 0; j = byte_next(bs, j)) {
+            sum_byte += (UINT)j;
+        }
+    }
+    double t_byte = bench_sec(t);
+
+    UINT sum_word = 0;
+    t = clock();
+    for (UINT i = 0; i < iter / 16; i++) {
+        BitSet const& bs = sets[i % NSET];
+        for (INT j = bs.get_first(); j >= 0; j = bs.get_next(j)) {
+            sum_word += (UINT)j;
+        }
+    }
+    printf("iterate: byte %fsec, word %fsec\n", t_byte, bench_sec(t));
+    if (sum_byte != sum_word) {
+        printf("iterate: mismatch\n");
+        failed = 1;
+    }
+    printf(failed ? "FAILED\n" : "PASSED\n");
+    return failed;
+}
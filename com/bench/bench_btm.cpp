@@ -0,0 +1,162 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Compare TMap with BTMap on the workloads of AA and DU, and check that
+//both maps compute the same result.
+//Usage: bench_btm.elf
+#include "stdio.h"
+#include "stdlib.h"
+#include "ltype.h"
+#include "comf.h"
+#include "smempool.h"
+#include "sstl.h"
+
+using namespace xcom;
+
+//Insert-heavy workload of AA: record point-to pairs in a map of maps as
+//PtPairMgr does, and rebuild the MD->MDSet map of each BB as the
+//iterative AA does.
+//Return the elapsed time.
+template <class OuterMap, class InnerMap, class MapTy>
+static float btm_bench_aa(UINT nbb, UINT nround, OUT UINT & sum,
+                          OUT size_t & mem)
+{
+    UINT const nmd = 2048;
+    sum = 0;
+    mem = 0;
+    srand(0);
+    LONG t = getclockstart();
+
+    //Point-to pairs, 'from' MD is local variable mostly.
+    OuterMap pt;
+    for (UINT i = 0; i < nbb * 64; i++) {
+        UINT from = (UINT)rand() % 256 + 1;
+        UINT to = (UINT)rand() % nmd + 1;
+        InnerMap * tomap = pt.get(from);
+        if (tomap == NULL) {
+            tomap = new InnerMap();
+            pt.set(from, tomap);
+        }
+        if (!tomap->find(to)) {
+            tomap->set(to, i + 1);
+            sum++;
+        }
+    }
+
+    //MD2MDSet of each BB, it is rebuilt in each round.
+    Vector<MapTy*> bb2map;
+    for (UINT i = 0; i < nbb; i++) {
+        bb2map.set(i, new MapTy());
+    }
+    for (UINT r = 0; r < nround; r++) {
+        for (UINT i = 0; i < nbb; i++) {
+            MapTy * m = bb2map.get(i);
+            m->clean();
+            UINT n = 32 + (UINT)rand() % 96;
+            for (UINT j = 0; j < n; j++) {
+                UINT mdid = (UINT)rand() % nmd + 1;
+                m->setAlways(mdid, (UINT)rand() % 64 + 1);
+            }
+            for (UINT j = 0; j < n; j++) {
+                sum += m->get((UINT)rand() % nmd + 1);
+            }
+        }
+    }
+    float time = getclockend(t);
+
+    mem = pt.count_mem();
+    TMapIter<UINT, InnerMap*> ti;
+    InnerMap * tomap = NULL;
+    for (pt.get_first(ti, &tomap); tomap != NULL; pt.get_next(ti, &tomap)) {
+        mem += tomap->count_mem();
+        delete tomap;
+    }
+    for (UINT i = 0; i < nbb; i++) {
+        mem += bb2map.get(i)->count_mem();
+        delete bb2map.get(i);
+    }
+    return time;
+}
+
+
+//Lookup-heavy workload of DU: build MD->IR-set map once as MDId2IRlist
+//does, then query it for each occurrence, and walk through it.
+//Return the elapsed time.
+template <class MapTy>
+static float btm_bench_du(UINT nmd, UINT nquery, OUT UINT & sum,
+                          OUT size_t & mem)
+{
+    sum = 0;
+    srand(0);
+    LONG t = getclockstart();
+    MapTy m;
+    for (UINT i = 0; i < nmd; i++) {
+        //MD id of stmt is neither ordered nor dense.
+        m.setAlways((UINT)rand() % (nmd * 2) + 1, i + 1);
+    }
+    for (UINT i = 0; i < nquery; i++) {
+        sum += m.get((UINT)rand() % (nmd * 2) + 1);
+    }
+    TMapIter<UINT, UINT> iter;
+    UINT mapped = 0;
+    for (UINT mdid = m.get_first(iter, &mapped);
+         mdid != 0; mdid = m.get_next(iter, &mapped)) {
+        sum += mapped;
+    }
+    float time = getclockend(t);
+    mem = m.count_mem();
+    return time;
+}
+
+
+int main()
+{
+    UINT s1, s2;
+    size_t m1, m2;
+    bool same = true;
+    float t1 = btm_bench_aa<TMap<UINT, TMap<UINT, UINT>*>, TMap<UINT, UINT>,
+                            TMap<UINT, UINT> >(256, 100, s1, m1);
+    float t2 = btm_bench_aa<BTMap<UINT, BTMap<UINT, UINT>*>,
+                            BTMap<UINT, UINT>, BTMap<UINT, UINT> >(
+                                256, 100, s2, m2);
+    printf("==---- TMap vs BTMap ----==\n");
+    printf("AA, insert-heavy: TMap %fsec %lu bytes, "
+           "BTMap %fsec %lu bytes\n", t1, (ULONG)m1, t2, (ULONG)m2);
+    same = same && s1 == s2;
+
+    t1 = btm_bench_du<TMap<UINT, UINT> >(20000, 4000000, s1, m1);
+    t2 = btm_bench_du<BTMap<UINT, UINT> >(20000, 4000000, s2, m2);
+    printf("DU, lookup-heavy: TMap %fsec %lu bytes, "
+           "BTMap %fsec %lu bytes\n", t1, (ULONG)m1, t2, (ULONG)m2);
+    same = same && s1 == s2;
+    if (!same) {
+        printf("FAILED: result mismatch\n");
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
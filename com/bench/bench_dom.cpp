@@ -0,0 +1,159 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Compare dominator set with dominator tree, and check that both
+//representations answer the same dominance query.
+//Usage: bench_dom.elf
+#include "stdio.h"
+#include "stdlib.h"
+#include "ltype.h"
+#include "comf.h"
+#include "smempool.h"
+#include "sstl.h"
+#include "bs.h"
+#include "sbs.h"
+#include "sgraph.h"
+
+using namespace xcom;
+
+//Build a CFG-like graph with 'n' vertices: vertex 1 is entry and 'n'
+//is exit, each vertex falls through to next one, and there are forward
+//branches, backward branches of loop, and switches that have 'ncase'
+//successors.
+static void dom_gen_graph(DGraph & g, UINT n, UINT ncase)
+{
+    srand(0);
+    for (UINT i = 1; i <= n; i++) {
+        g.addVertex(i);
+    }
+    for (UINT i = 1; i < n; i++) {
+        g.addEdge(i, i + 1);
+        UINT r = (UINT)rand() % 100;
+        UINT d = (UINT)rand() % 32;
+        if (r < 20) {
+            g.addEdge(i, MIN(n, i + 2 + d));
+        } else if (r < 25 && i > 2) {
+            g.addEdge(i, i > d + 3 ? i - 1 - d : 2);
+        }
+        if (i % 64 == 0) {
+            for (UINT j = 0; j < ncase; j++) {
+                d = (UINT)rand() % 512;
+                g.addEdge(i, MIN(n, i + 2 + d));
+            }
+        }
+    }
+}
+
+
+//Compare dominator set with dominator tree on graph that has 'n'
+//vertices. The dominator set is computed as IR_CFG did, by iterative
+//idom and bitset of dominators, and the post-dominator set is computed
+//by iterative bitset intersection.
+//Return true if both representations compute the same result.
+static bool dom_bench_graph(UINT n, UINT ncase)
+{
+    BitSetMgr bsm1;
+    DGraph g1;
+    g1.set_bs_mgr(&bsm1);
+    dom_gen_graph(g1, n, ncase);
+
+    BitSetMgr bsm2;
+    DGraph g2;
+    g2.set_bs_mgr(&bsm2);
+    dom_gen_graph(g2, n, ncase);
+
+    LONG t = getclockstart();
+    List<Vertex const*> vlst;
+    g1.computeRpoNoRecursive(g1.get_vertex(1), vlst);
+    g1.computeIdom2(vlst);
+    g1.computeDom2(vlst);
+    g1.computePdomByRpo(g1.get_vertex(1), NULL);
+    g1.computeIpdom();
+    float t1 = getclockend(t);
+    UINT m1 = bsm1.count_mem() + (UINT)g1.count_mem();
+
+    t = getclockstart();
+    g2.computeDomTree();
+    g2.computePdomTree();
+    float t2 = getclockend(t);
+    UINT m2 = bsm2.count_mem() + (UINT)g2.count_mem();
+
+    //Query the dominance relation of random pairs.
+    UINT nquery = 4000000;
+    UINT s1 = 0;
+    srand(1);
+    t = getclockstart();
+    for (UINT i = 0; i < nquery; i++) {
+        UINT v1 = (UINT)rand() % n + 1;
+        UINT v2 = (UINT)rand() % n + 1;
+        s1 += g1.is_dom(v1, v2) ? 1 : 0;
+        s1 += g1.is_pdom(v1, v2) ? 2 : 0;
+    }
+    float q1 = getclockend(t);
+
+    UINT s2 = 0;
+    srand(1);
+    t = getclockstart();
+    for (UINT i = 0; i < nquery; i++) {
+        UINT v1 = (UINT)rand() % n + 1;
+        UINT v2 = (UINT)rand() % n + 1;
+        s2 += g2.is_dom(v1, v2) ? 1 : 0;
+        s2 += g2.is_pdom(v1, v2) ? 2 : 0;
+    }
+    float q2 = getclockend(t);
+
+    printf("%u vertices, %u cases of switch:\n", n, ncase);
+    printf("  compute: set %fsec %u bytes, tree %fsec %u bytes\n",
+           t1, m1, t2, m2);
+    printf("  %u queries: set %fsec, tree %fsec\n", nquery, q1, q2);
+    if (s1 != s2) { return false; }
+
+    //The set built on demand should be identical.
+    for (UINT i = 1; i <= n; i++) {
+        if (g1.get_idom(i) != g2.get_idom(i) ||
+            g1.get_ipdom(i) != g2.get_ipdom(i) ||
+            !g1.get_dom_set(i)->is_equal(*g2.get_dom_set(i)) ||
+            !g1.get_pdom_set(i)->is_equal(*g2.get_pdom_set(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main()
+{
+    printf("==---- Dominator set vs Dominator tree ----==\n");
+    bool same = dom_bench_graph(2000, 4);
+    same = dom_bench_graph(10000, 64) && same;
+    if (!same) {
+        printf("FAILED: result mismatch\n");
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
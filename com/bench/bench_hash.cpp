@@ -0,0 +1,247 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Compare Hash with FlatHash on the key distributions of graph, GVN
+//and GRA, and check that both tables compute the same result.
+//Usage: bench_hash.elf
+#include "stdio.h"
+#include "stdlib.h"
+#include "ltype.h"
+#include "comf.h"
+#include "smempool.h"
+#include "sstl.h"
+
+using namespace xcom;
+
+//Key of hash table benchmark. It mimics the keys that passes put into
+//hash table: vertex id of graph, the (from, to) pair of edge, and the
+//(mdid, ofst, sz) of VNE_SC in GVN.
+typedef struct {
+    UINT a;
+    UINT b;
+    UINT c;
+} FHB_KEY;
+
+
+//The hash function is the same as EdgeHashFunc and VNE_SC_HF.
+class FHB_HF {
+public:
+    UINT get_hash_value(FHB_KEY const* k, UINT bucket_size) const
+    {
+        ASSERT0(isPowerOf2(bucket_size));
+        return hash32bit((k->a << 20) | (k->b << 10) | k->c) &
+               (bucket_size - 1);
+    }
+
+    UINT get_hash_value(OBJTY v, UINT bucket_size) const
+    { return get_hash_value((FHB_KEY const*)v, bucket_size); }
+
+    bool compare(FHB_KEY const* k1, FHB_KEY const* k2) const
+    { return k1->a == k2->a && k1->b == k2->b && k1->c == k2->c; }
+
+    bool compare(FHB_KEY const* k1, OBJTY v) const
+    { return compare(k1, (FHB_KEY const*)v); }
+};
+
+
+//Generate 'n' distinct keys in the distribution of 'kind':
+//  'v': vertex id, dense and ascending.
+//  'e': edge of CFG, fall-through edge plus a few branch edges.
+//  's': VN expression of scalar, MD id, 4-aligned offset and size.
+//Return the number of keys generated.
+static UINT fhb_gen_keys(CHAR kind, UINT n, OUT FHB_KEY * keys)
+{
+    UINT num = 0;
+    switch (kind) {
+    case 'v':
+        for (; num < n; num++) {
+            keys[num].a = num + 1;
+            keys[num].b = 0;
+            keys[num].c = 0;
+        }
+        break;
+    case 'e':
+        for (UINT v = 1; num < n; v++) {
+            keys[num].a = v;
+            keys[num].b = v + 1;
+            keys[num].c = 0;
+            num++;
+            if (num < n && (UINT)rand() % 10 < 3) {
+                //Branch to a near vertex, backward edge is loop.
+                keys[num].a = v;
+                keys[num].b = v + 2 + (UINT)rand() % 32;
+                if ((UINT)rand() % 4 == 0 && v > 32) {
+                    keys[num].b = v - 1 - (UINT)rand() % 32;
+                }
+                keys[num].c = 0;
+                num++;
+            }
+        }
+        break;
+    case 's':
+        for (; num < n; num++) {
+            keys[num].a = num / 8 + 1;
+            keys[num].b = (num % 8) * 4;
+            keys[num].c = (num % 3) == 0 ? 8 : 4;
+        }
+        break;
+    default: ASSERT0(0);
+    }
+
+    //Shuffle the keys except vertex ids.
+    for (UINT i = num - 1; kind != 'v' && i > 0; i--) {
+        UINT j = (UINT)rand() % (i + 1);
+        FHB_KEY t = keys[i];
+        keys[i] = keys[j];
+        keys[j] = t;
+    }
+    return num;
+}
+
+
+//Apply the operations of a pass to table 'h': build the table,
+//look up existing and absent keys, remove and re-append a quarter of
+//keys, and walk through the table.
+//Return the number of successful lookups.
+template <class HashTy>
+static UINT fhb_run(HashTy & h, FHB_KEY const* keys, UINT n, UINT nquery)
+{
+    UINT hit = 0;
+    for (UINT i = 0; i < n; i++) {
+        h.append(&keys[i]);
+    }
+    for (UINT i = 0; i < nquery; i++) {
+        FHB_KEY k = keys[(UINT)rand() % n];
+        if ((i & 1) != 0) {
+            //Absent key.
+            k.c += 1;
+        }
+        if (h.find((OBJTY)&k) != NULL) {
+            hit++;
+        }
+    }
+    for (UINT i = 0; i < n; i += 4) {
+        h.removed(&keys[i]);
+    }
+    for (UINT i = 0; i < n; i += 4) {
+        h.append(&keys[i]);
+    }
+    INT c;
+    for (FHB_KEY const* k = h.get_first(c); k != NULL; k = h.get_next(c)) {
+        hit += k->a & 1;
+    }
+    return hit;
+}
+
+
+//Run 'nround' passes, each pass uses a new table with 'n' keys.
+//Return the elapsed time.
+template <class HashTy>
+static float fhb_bench(CHAR kind, UINT n, UINT nround, OUT UINT & hit,
+                       OUT size_t & mem)
+{
+    FHB_KEY * keys = (FHB_KEY*)::malloc(sizeof(FHB_KEY) * n);
+    hit = 0;
+    mem = 0;
+    srand(0);
+    n = fhb_gen_keys(kind, n, keys);
+    LONG t = getclockstart();
+    for (UINT r = 0; r < nround; r++) {
+        HashTy h(getNearestPowerOf2(n));
+        hit += fhb_run(h, keys, n, n * 4);
+        mem = MAX(mem, h.count_mem());
+    }
+    float time = getclockend(t);
+    ::free(keys);
+    return time;
+}
+
+
+//Map PR number to its lifetime as PR2LT does.
+//Return the elapsed time.
+template <class MapTy>
+static float fhb_bench_map(UINT n, UINT nround, OUT UINT & hit)
+{
+    FHB_KEY lt;
+    hit = 0;
+    srand(0);
+    LONG t = getclockstart();
+    for (UINT r = 0; r < nround; r++) {
+        MapTy m(getNearestPowerOf2(n));
+        for (UINT i = 1; i <= n; i++) {
+            m.set(i, &lt);
+        }
+        for (UINT i = 0; i < n * 4; i++) {
+            hit += m.get((UINT)rand() % (n * 2) + 1) != NULL ? 1 : 0;
+        }
+    }
+    return getclockend(t);
+}
+
+
+int main()
+{
+    struct {
+        CHAR kind;
+        UINT n;
+        UINT nround;
+        CHAR const* name;
+    } const cfg[] = {
+        { 'v', 4096, 200, "vertex of graph" },
+        { 'e', 6144, 200, "edge of graph" },
+        { 's', 24, 40000, "VNE_SC of GVN" },
+        { 's', 2048, 400, "VNE_SC of GVN, large" },
+    };
+    bool same = true;
+    printf("==---- Hash vs FlatHash ----==\n");
+    for (UINT i = 0; i < sizeof(cfg) / sizeof(cfg[0]); i++) {
+        UINT h1, h2;
+        size_t m1, m2;
+        float t1 = fhb_bench<Hash<FHB_KEY const*, FHB_HF> >(
+            cfg[i].kind, cfg[i].n, cfg[i].nround, h1, m1);
+        float t2 = fhb_bench<FlatHash<FHB_KEY const*, FHB_HF> >(
+            cfg[i].kind, cfg[i].n, cfg[i].nround, h2, m2);
+        printf("%s, %u keys x %u: Hash %fsec %lu bytes, "
+               "FlatHash %fsec %lu bytes\n",
+               cfg[i].name, cfg[i].n, cfg[i].nround,
+               t1, (ULONG)m1, t2, (ULONG)m2);
+        same = same && h1 == h2;
+    }
+
+    UINT h1, h2;
+    float t1 = fhb_bench_map<HMap<UINT, FHB_KEY*> >(4096, 200, h1);
+    float t2 = fhb_bench_map<FlatHMap<UINT, FHB_KEY*> >(4096, 200, h2);
+    printf("PR2LT of GRA, 4096 PRs x 200: HMap %fsec, FlatHMap %fsec\n",
+           t1, t2);
+    same = same && h1 == h2;
+    if (!same) {
+        printf("FAILED: result mismatch\n");
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,236 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Replay the trace of sparse bitset operations on both list and flat
+//representation, compare the performance, and check that both
+//representations compute the same result.
+//Usage: bench_sbs.elf [trace_file]
+//'trace_file': trace generated by setting g_sbs_trace_file in debug mode.
+//A synthetic trace will be used if it is not given.
+#include "stdio.h"
+#include "stdlib.h"
+#include "time.h"
+#include "ltype.h"
+#include "comf.h"
+#include "smempool.h"
+#include "sstl.h"
+#include "bs.h"
+#include "sbs.h"
+
+using namespace xcom;
+
+//Record of one sparse bitset operation in trace, see SBS_TRACE.
+typedef struct {
+    CHAR op;
+    UINT a; //the set to be operated.
+    UINT b; //the second set or the element.
+} SBS_OP;
+
+
+static bool sbs_is_binary_op(CHAR op)
+{
+    return op == 'U' || op == 'D' || op == 'I' ||
+           op == 'E' || op == 'X' || op == 'C';
+}
+
+
+//Map the address of set in trace to dense id.
+static UINT sbs_trace_id(TMap<ULONGLONG, UINT> & addr2id,
+                         ULONGLONG addr,
+                         UINT & nset)
+{
+    bool find;
+    UINT id = addr2id.get(addr, &find);
+    if (find) { return id; }
+    addr2id.set(addr, nset);
+    return nset++;
+}
+
+
+//Read trace file that generated by SBS_TRACE.
+//Return the number of sets.
+static UINT sbs_read_trace(CHAR const* trace_file, Vector<SBS_OP> & ops)
+{
+    FILE * h = fopen(trace_file, "r");
+    if (h == NULL) { return 0; }
+    TMap<ULONGLONG, UINT> addr2id;
+    UINT nset = 0;
+    UINT nop = 0;
+    CHAR buf[128];
+    while (fgets(buf, sizeof(buf), h) != NULL) {
+        CHAR op;
+        void * a = NULL;
+        void * b = NULL;
+        UINT elem = 0;
+        SBS_OP o;
+        if (sbs_is_binary_op(buf[0])) {
+            if (sscanf(buf, "%c %p %p", &op, &a, &b) != 3) { continue; }
+            o.b = sbs_trace_id(addr2id, (ULONGLONG)(size_t)b, nset);
+        } else if (buf[0] == 'K' || buf[0] == 'N') {
+            if (sscanf(buf, "%c %p", &op, &a) != 2) { continue; }
+            o.b = 0;
+        } else {
+            if (sscanf(buf, "%c %p %u", &op, &a, &elem) != 3) { continue; }
+            o.b = elem;
+        }
+        o.op = op;
+        o.a = sbs_trace_id(addr2id, (ULONGLONG)(size_t)a, nset);
+        ops.set(nop++, o);
+    }
+    fclose(h);
+    return nset;
+}
+
+
+//Generate trace that simulates the DU chain building: sets are
+//populated with clustered elements, then merged along the CFG.
+//Return the number of sets.
+static UINT sbs_gen_trace(Vector<SBS_OP> & ops)
+{
+    UINT const nset = 512;
+    UINT const nop = 200000;
+    for (UINT i = 0; i < nop; i++) {
+        SBS_OP o;
+        o.a = (UINT)rand() % nset;
+        UINT const base = o.a * 8;
+        UINT r = (UINT)rand() % 100;
+        if (r < 40) {
+            o.op = 'u';
+            o.b = base + (UINT)rand() % 512;
+        } else if (r < 50) {
+            o.op = 'd';
+            o.b = base + (UINT)rand() % 512;
+        } else if (r < 60) {
+            o.op = 'c';
+            o.b = base + (UINT)rand() % 512;
+        } else {
+            o.b = (o.a + 1 + (UINT)rand() % 16) % nset;
+            CHAR const binops[] = { 'U', 'U', 'U', 'U', 'D',
+                                    'I', 'E', 'X', 'C', 'N' };
+            o.op = binops[(UINT)rand() % 10];
+        }
+        ops.set(i, o);
+    }
+    return nset;
+}
+
+
+//Replay the trace, return the elapsed time.
+//'sum': checksum of query results.
+//'content': checksum of the elements of sets at the end of trace.
+//'mem': memory used by the sets.
+static double sbs_replay(Vector<SBS_OP> & ops,
+                         UINT nset,
+                         bool is_flat,
+                         OUT UINT & sum,
+                         OUT UINT & content,
+                         OUT size_t & mem)
+{
+    MiscBitSetMgr<BITS_PER_SEG> m;
+    m.set_flat(is_flat);
+    SBitSetCore<BITS_PER_SEG> ** sets = (SBitSetCore<BITS_PER_SEG>**)
+        ::malloc(sizeof(SBitSetCore<BITS_PER_SEG>*) * nset);
+    for (UINT i = 0; i < nset; i++) {
+        sets[i] = m.allocSBitSetCore();
+    }
+
+    sum = 0;
+    clock_t t = clock();
+    for (INT i = 0; i <= ops.get_last_idx(); i++) {
+        SBS_OP & o = ops[i];
+        SBitSetCore<BITS_PER_SEG> & a = *sets[o.a];
+        if (sbs_is_binary_op(o.op) && o.a == o.b) { continue; }
+        switch (o.op) {
+        case 'u': a.bunion(o.b, m); break;
+        case 'd': a.diff(o.b, m); break;
+        case 'c': sum += a.is_contain(o.b); break;
+        case 'K': a.clean(m); break;
+        case 'N': sum += a.get_elem_count(); break;
+        case 'U': a.bunion(*sets[o.b], m); break;
+        case 'D': a.diff(*sets[o.b], m); break;
+        case 'I': a.intersect(*sets[o.b], m); break;
+        case 'C': a.copy(*sets[o.b], m); break;
+        case 'E': sum += a.is_equal(*sets[o.b]); break;
+        case 'X': sum += a.is_intersect(*sets[o.b]); break;
+        default: break;
+        }
+    }
+    double time = (double)(clock() - t) / CLOCKS_PER_SEC;
+
+    mem = m.count_mem();
+    content = 0;
+    for (UINT i = 0; i < nset; i++) {
+        SC<SEG<BITS_PER_SEG>*> * iter;
+        for (INT j = sets[i]->get_first(&iter); j >= 0;
+             j = sets[i]->get_next((UINT)j, &iter)) {
+            content = content * 31 + (UINT)j + i;
+        }
+        mem += sets[i]->count_mem();
+        m.freeSBitSetCore(sets[i]);
+    }
+    ::free(sets);
+    return time;
+}
+
+
+int main(int argc, char const* argv[])
+{
+    CHAR const* trace_file = argc > 1 ? argv[1] : NULL;
+    Vector<SBS_OP> ops;
+    UINT nset = 0;
+    if (trace_file != NULL) {
+        nset = sbs_read_trace(trace_file, ops);
+        if (nset == 0) {
+            printf("can not read trace %s\n", trace_file);
+            return 1;
+        }
+    } else {
+        trace_file = "synthetic";
+        srand(0);
+        nset = sbs_gen_trace(ops);
+    }
+
+    UINT sum_list, sum_flat;
+    UINT content_list, content_flat;
+    size_t mem_list, mem_flat;
+    double t_list = sbs_replay(ops, nset, false, sum_list, content_list,
+                               mem_list);
+    double t_flat = sbs_replay(ops, nset, true, sum_flat, content_flat,
+                               mem_flat);
+    printf("==---- SBitSet replay: %s, %u sets, %d ops ----==\n",
+           trace_file, nset, ops.get_last_idx() + 1);
+    printf("list: %fsec, %lu bytes (%u)\n",
+           t_list, (ULONG)mem_list, sum_list);
+    printf("flat: %fsec, %lu bytes (%u)\n",
+           t_flat, (ULONG)mem_flat, sum_flat);
+    if (sum_list != sum_flat || content_list != content_flat) {
+        printf("FAILED: result mismatch\n");
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Compare the chunk-walking pool with arena by replaying the
+//allocation traffic of IR, and check that both pools keep the
+//content of live objects.
+//Usage: bench_smp.elf
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "ltype.h"
+#include "comf.h"
+#include "smempool.h"
+#include "sstl.h"
+
+using namespace xcom;
+
+//Replay the allocation traffic of Region::allocIR() and freeIR():
+//IR is taken from the free table of its size at first, otherwise it
+//is allocated from pool. DU is allocated from const size pool, and
+//each pass allocates temporaries that are dead at the end of pass.
+//'content': checksum of live objects at the end of replay.
+//Return the elapsed time.
+static float smp_replay(bool is_arena, OUT SMemPoolStat & stat,
+                        OUT SMemPoolStat & du_stat, OUT UINT & content)
+{
+    UINT const irsz[] = { 48, 48, 48, 56, 56, 64, 64, 72, 80, 96, 112, 128 };
+    UINT const nsz = sizeof(irsz) / sizeof(irsz[0]);
+    UINT const nop = 2000000;
+    UINT const du_size = 24;
+    void * free_tab[129];
+    memset(free_tab, 0, sizeof(free_tab));
+    Vector<void*> live;
+    Vector<UINT> live_size;
+    UINT nlive = 0;
+
+    srand(0);
+    SMemPool * pool = is_arena ? smpoolCreateArena(256, MEM_COMM) :
+                                 smpoolCreate(256, MEM_COMM);
+    SMemPool * du_pool = is_arena ?
+        smpoolCreateArena(du_size * 4, MEM_CONST_SIZE) :
+        smpoolCreate(du_size * 4, MEM_CONST_SIZE);
+
+    LONG t = getclockstart();
+    for (UINT i = 0; i < nop; i++) {
+        UINT r = (UINT)rand() % 100;
+        if (r < 60 || nlive == 0) {
+            //allocIR
+            UINT sz = irsz[(UINT)rand() % nsz];
+            void * p = free_tab[sz];
+            if (p != NULL) {
+                //Classic pool does not align, avoid unaligned load.
+                ::memcpy(&free_tab[sz], p, sizeof(void*));
+            } else {
+                p = smpoolMalloc(sz, pool);
+            }
+            memset(p, (BYTE)i, sz);
+            live.set(nlive, p);
+            live_size.set(nlive, sz);
+            nlive++;
+        } else if (r < 85) {
+            //freeIR
+            UINT k = (UINT)rand() % nlive;
+            void * p = live[k];
+            UINT sz = live_size[k];
+            nlive--;
+            live.set(k, live[nlive]);
+            live_size.set(k, live_size[nlive]);
+            ::memcpy(p, &free_tab[sz], sizeof(void*));
+            free_tab[sz] = p;
+        } else {
+            //allocDU
+            void * p = smpoolMallocConstSize(du_size, du_pool);
+            memset(p, 0, du_size);
+        }
+
+        if (i % 10000 == 0) {
+            //Temporaries of pass.
+            SMemPoolMark mark;
+            if (is_arena) { mark = smpoolMark(pool); }
+            for (UINT j = 0; j < 64; j++) {
+                UINT sz = 16 + (UINT)rand() % 256;
+                memset(smpoolMalloc(sz, pool), 0, sz);
+            }
+            if (is_arena) { smpoolReleaseTo(pool, mark); }
+        }
+    }
+    float time = getclockend(t);
+
+    content = 0;
+    for (UINT i = 0; i < nlive; i++) {
+        BYTE const* p = (BYTE const*)live[i];
+        for (UINT j = 0; j < live_size[i]; j++) {
+            content = content * 31 + p[j];
+        }
+    }
+
+    smpoolGetStat(pool, &stat);
+    smpoolGetStat(du_pool, &du_stat);
+    smpoolDelete(pool);
+    smpoolDelete(du_pool);
+    return time;
+}
+
+
+int main()
+{
+    SMemPoolStat s1, d1, s2, d2;
+    UINT c1, c2;
+    float t_smp = smp_replay(false, s1, d1, c1);
+    float t_arena = smp_replay(true, s2, d2, c2);
+    printf("==---- SMemPool replay of allocIR ----==\n");
+    printf("pool: %fsec, requested:%llu, reserved:%llu, "
+           "chunk:%u; du reserved:%llu, chunk:%u\n",
+           t_smp, s1.requested, s1.reserved, s1.chunk_num,
+           d1.reserved, d1.chunk_num);
+    printf("arena: %fsec, requested:%llu, reserved:%llu, "
+           "chunk:%u, waste:%llu; du reserved:%llu, chunk:%u\n",
+           t_arena, s2.requested, s2.reserved, s2.chunk_num, s2.waste,
+           d2.reserved, d2.chunk_num);
+    if (c1 != c2) {
+        printf("FAILED: result mismatch\n");
+        return 1;
+    }
+    printf("PASSED\n");
+    return 0;
+}
@@ -0,0 +1,2 @@
+g++ $1 ../ltype.cpp ../comf.cpp ../smempool.cpp ../bs.cpp ../sgraph.cpp \
+    ../strbuf.cpp -O2 -g -D_DEBUG_ -D_LINUX_ -I.. -o ${1%.cpp}.elf
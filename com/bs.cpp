@@ -39,6 +39,9 @@ author: Su Zhenyu
 
 namespace xcom {
 
+//Trace file of sparse bitset operations, see SBS_TRACE in sbs.h.
+FILE * g_sbs_trace = NULL;
+
 #if BITS_PER_BYTE == 8
 #define DIVBPB(a) ((a) >> 3)
 #define MULBPB(a) ((a) << 3)
@@ -831,6 +834,501 @@ static BYTE const g_last_one[256] = {
 };
 
 
+//
+//START BitSet Kernels
+//
+//Word-parallel and SIMD kernels of the set algebra. Each kernel handles
+//a vector of arbitrary byte length, although BitSet pads its own vector
+//to BS_PAD_BYTE, the one of ROBitSet may be odd.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BS_HAS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#define BS_WORD_BYTE 8
+
+typedef void (*BSBinOp)(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n);
+typedef bool (*BSPredOp)(BYTE const* a, BYTE const* b, UINT n);
+typedef UINT (*BSCountOp)(BYTE const* a, UINT n);
+
+typedef struct {
+    BS_KERNEL kind;
+    BSBinOp bor; //dst |= src
+    BSBinOp band; //dst &= src
+    BSBinOp bandn; //dst &= ~src
+    BSPredOp is_intersect; //(a & b) != 0
+    BSPredOp is_contain; //(a & b) == b
+    BSCountOp popcount;
+} BSKernel;
+
+
+//Load/Store 64bit word in little-endian order, thus bit 'i' of
+//the word is always the element 'i' counting from 'p'.
+static inline ULONGLONG bs_ld(BYTE const* p)
+{
+    ULONGLONG v;
+    ::memcpy(&v, p, sizeof(v));
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+    #endif
+    return v;
+}
+
+
+static inline void bs_st(BYTE * p, ULONGLONG v)
+{
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+    #endif
+    ::memcpy(p, &v, sizeof(v));
+}
+
+
+//Return true if all bytes in 'p' are zero.
+static bool bs_is_zero(BYTE const* p, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        if (bs_ld(p + i) != 0) { return false; }
+    }
+    for (; i < n; i++) {
+        if (p[i] != 0) { return false; }
+    }
+    return true;
+}
+
+
+//Byte kernel.
+static void bs_byte_or(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    for (UINT i = 0; i < n; i++) { dst[i] |= src[i]; }
+}
+
+
+static void bs_byte_and(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    for (UINT i = 0; i < n; i++) { dst[i] &= src[i]; }
+}
+
+
+static void bs_byte_andn(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    for (UINT i = 0; i < n; i++) { dst[i] &= (BYTE)~src[i]; }
+}
+
+
+static bool bs_byte_is_intersect(BYTE const* a, BYTE const* b, UINT n)
+{
+    for (UINT i = 0; i < n; i++) {
+        if ((a[i] & b[i]) != 0) { return true; }
+    }
+    return false;
+}
+
+
+static bool bs_byte_is_contain(BYTE const* a, BYTE const* b, UINT n)
+{
+    for (UINT i = 0; i < n; i++) {
+        if ((a[i] & b[i]) != b[i]) { return false; }
+    }
+    return true;
+}
+
+
+//Add up the population count of each byte in the set. We get the
+//population counts from the table above.
+static UINT bs_byte_popcount(BYTE const* a, UINT n)
+{
+    UINT count = 0;
+    for (UINT i = 0; i < n; i++) { count += g_bit_count[a[i]]; }
+    return count;
+}
+
+
+//Word kernel.
+static void bs_word_or(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        bs_st(dst + i, bs_ld(dst + i) | bs_ld(src + i));
+    }
+    bs_byte_or(dst + i, src + i, n - i);
+}
+
+
+static void bs_word_and(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        bs_st(dst + i, bs_ld(dst + i) & bs_ld(src + i));
+    }
+    bs_byte_and(dst + i, src + i, n - i);
+}
+
+
+static void bs_word_andn(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        bs_st(dst + i, bs_ld(dst + i) & ~bs_ld(src + i));
+    }
+    bs_byte_andn(dst + i, src + i, n - i);
+}
+
+
+static bool bs_word_is_intersect(BYTE const* a, BYTE const* b, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        if ((bs_ld(a + i) & bs_ld(b + i)) != 0) { return true; }
+    }
+    return bs_byte_is_intersect(a + i, b + i, n - i);
+}
+
+
+static bool bs_word_is_contain(BYTE const* a, BYTE const* b, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        if ((bs_ld(b + i) & ~bs_ld(a + i)) != 0) { return false; }
+    }
+    return bs_byte_is_contain(a + i, b + i, n - i);
+}
+
+
+static UINT bs_word_popcount(BYTE const* a, UINT n)
+{
+    UINT count = 0;
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        count += bs_popcnt64(bs_ld(a + i));
+    }
+    return count + bs_byte_popcount(a + i, n - i);
+}
+
+
+#ifdef BS_HAS_X86_SIMD
+//Same as bs_word_popcount, but compiled with hardware POPCNT instruction.
+__attribute__((target("popcnt")))
+static UINT bs_popcnt_popcount(BYTE const* a, UINT n)
+{
+    UINT count = 0;
+    UINT i = 0;
+    for (; i + BS_WORD_BYTE <= n; i += BS_WORD_BYTE) {
+        count += (UINT)__builtin_popcountll(bs_ld(a + i));
+    }
+    return count + bs_byte_popcount(a + i, n - i);
+}
+
+
+//SSE2 kernel.
+#define BS_SSE2_BYTE 16
+
+__attribute__((target("sse2")))
+static void bs_sse2_or(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_SSE2_BYTE <= n; i += BS_SSE2_BYTE) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(dst + i));
+        __m128i y = _mm_loadu_si128((__m128i const*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(x, y));
+    }
+    bs_word_or(dst + i, src + i, n - i);
+}
+
+
+__attribute__((target("sse2")))
+static void bs_sse2_and(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_SSE2_BYTE <= n; i += BS_SSE2_BYTE) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(dst + i));
+        __m128i y = _mm_loadu_si128((__m128i const*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_and_si128(x, y));
+    }
+    bs_word_and(dst + i, src + i, n - i);
+}
+
+
+__attribute__((target("sse2")))
+static void bs_sse2_andn(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_SSE2_BYTE <= n; i += BS_SSE2_BYTE) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(dst + i));
+        __m128i y = _mm_loadu_si128((__m128i const*)(src + i));
+        //_mm_andnot_si128 computes (~y) & x.
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_andnot_si128(y, x));
+    }
+    bs_word_andn(dst + i, src + i, n - i);
+}
+
+
+__attribute__((target("sse2")))
+static bool bs_sse2_is_intersect(BYTE const* a, BYTE const* b, UINT n)
+{
+    __m128i const zero = _mm_setzero_si128();
+    UINT i = 0;
+    for (; i + BS_SSE2_BYTE <= n; i += BS_SSE2_BYTE) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(a + i));
+        __m128i y = _mm_loadu_si128((__m128i const*)(b + i));
+        __m128i r = _mm_cmpeq_epi8(_mm_and_si128(x, y), zero);
+        if (_mm_movemask_epi8(r) != 0xFFFF) { return true; }
+    }
+    return bs_word_is_intersect(a + i, b + i, n - i);
+}
+
+
+__attribute__((target("sse2")))
+static bool bs_sse2_is_contain(BYTE const* a, BYTE const* b, UINT n)
+{
+    __m128i const zero = _mm_setzero_si128();
+    UINT i = 0;
+    for (; i + BS_SSE2_BYTE <= n; i += BS_SSE2_BYTE) {
+        __m128i x = _mm_loadu_si128((__m128i const*)(a + i));
+        __m128i y = _mm_loadu_si128((__m128i const*)(b + i));
+        __m128i r = _mm_cmpeq_epi8(_mm_andnot_si128(x, y), zero);
+        if (_mm_movemask_epi8(r) != 0xFFFF) { return false; }
+    }
+    return bs_word_is_contain(a + i, b + i, n - i);
+}
+
+
+//AVX2 kernel.
+#define BS_AVX2_BYTE 32
+
+__attribute__((target("avx2")))
+static void bs_avx2_or(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_AVX2_BYTE <= n; i += BS_AVX2_BYTE) {
+        __m256i x = _mm256_loadu_si256((__m256i const*)(dst + i));
+        __m256i y = _mm256_loadu_si256((__m256i const*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(x, y));
+    }
+    bs_word_or(dst + i, src + i, n - i);
+}
+
+
+__attribute__((target("avx2")))
+static void bs_avx2_and(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_AVX2_BYTE <= n; i += BS_AVX2_BYTE) {
+        __m256i x = _mm256_loadu_si256((__m256i const*)(dst + i));
+        __m256i y = _mm256_loadu_si256((__m256i const*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_and_si256(x, y));
+    }
+    bs_word_and(dst + i, src + i, n - i);
+}
+
+
+__attribute__((target("avx2")))
+static void bs_avx2_andn(BYTE * RESTRICT dst, BYTE const* RESTRICT src, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_AVX2_BYTE <= n; i += BS_AVX2_BYTE) {
+        __m256i x = _mm256_loadu_si256((__m256i const*)(dst + i));
+        __m256i y = _mm256_loadu_si256((__m256i const*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_andnot_si256(y, x));
+    }
+    bs_word_andn(dst + i, src + i, n - i);
+}
+
+
+__attribute__((target("avx2")))
+static bool bs_avx2_is_intersect(BYTE const* a, BYTE const* b, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_AVX2_BYTE <= n; i += BS_AVX2_BYTE) {
+        __m256i x = _mm256_loadu_si256((__m256i const*)(a + i));
+        __m256i y = _mm256_loadu_si256((__m256i const*)(b + i));
+        //testz returns 1 if (x & y) == 0.
+        if (!_mm256_testz_si256(x, y)) { return true; }
+    }
+    return bs_word_is_intersect(a + i, b + i, n - i);
+}
+
+
+__attribute__((target("avx2")))
+static bool bs_avx2_is_contain(BYTE const* a, BYTE const* b, UINT n)
+{
+    UINT i = 0;
+    for (; i + BS_AVX2_BYTE <= n; i += BS_AVX2_BYTE) {
+        __m256i x = _mm256_loadu_si256((__m256i const*)(a + i));
+        __m256i y = _mm256_loadu_si256((__m256i const*)(b + i));
+        //testc returns 1 if (~x & y) == 0.
+        if (!_mm256_testc_si256(x, y)) { return false; }
+    }
+    return bs_word_is_contain(a + i, b + i, n - i);
+}
+
+
+//Count bits via nibble lookup table and PSADBW, which is faster than
+//scalar POPCNT on long vectors.
+__attribute__((target("avx2,popcnt")))
+static UINT bs_avx2_popcount(BYTE const* a, UINT n)
+{
+    __m256i const lut = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    __m256i const low_mask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    UINT i = 0;
+    for (; i + BS_AVX2_BYTE <= n; i += BS_AVX2_BYTE) {
+        __m256i v = _mm256_loadu_si256((__m256i const*)(a + i));
+        __m256i lo = _mm256_and_si256(v, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo),
+                                      _mm256_shuffle_epi8(lut, hi));
+        acc = _mm256_add_epi64(acc,
+                               _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    UINT count = (UINT)(_mm256_extract_epi64(acc, 0) +
+                        _mm256_extract_epi64(acc, 1) +
+                        _mm256_extract_epi64(acc, 2) +
+                        _mm256_extract_epi64(acc, 3));
+    return count + bs_popcnt_popcount(a + i, n - i);
+}
+#endif
+
+
+static BSKernel const g_bs_byte_kernel = {
+    BS_KERNEL_BYTE, bs_byte_or, bs_byte_and, bs_byte_andn,
+    bs_byte_is_intersect, bs_byte_is_contain, bs_byte_popcount
+};
+
+
+static BSKernel const g_bs_word_kernel = {
+    BS_KERNEL_WORD, bs_word_or, bs_word_and, bs_word_andn,
+    bs_word_is_intersect, bs_word_is_contain, bs_word_popcount
+};
+
+
+#ifdef BS_HAS_X86_SIMD
+static BSKernel const g_bs_sse2_kernel = {
+    BS_KERNEL_SSE2, bs_sse2_or, bs_sse2_and, bs_sse2_andn,
+    bs_sse2_is_intersect, bs_sse2_is_contain, bs_word_popcount
+};
+
+
+static BSKernel const g_bs_avx2_kernel = {
+    BS_KERNEL_AVX2, bs_avx2_or, bs_avx2_and, bs_avx2_andn,
+    bs_avx2_is_intersect, bs_avx2_is_contain, bs_avx2_popcount
+};
+#endif
+
+
+//Return the kernel that 'k' resolves to on host CPU, which may be
+//weaker than 'k' if host CPU does not support it.
+static BSKernel bs_select_kernel(BS_KERNEL k)
+{
+    BSKernel kernel;
+    #ifdef BS_HAS_X86_SIMD
+    __builtin_cpu_init();
+    bool const has_sse2 = __builtin_cpu_supports("sse2") != 0;
+    bool const has_avx2 = __builtin_cpu_supports("avx2") != 0;
+    bool const has_popcnt = __builtin_cpu_supports("popcnt") != 0;
+    if (k == BS_KERNEL_AUTO) {
+        k = has_avx2 ? BS_KERNEL_AVX2 :
+            has_sse2 ? BS_KERNEL_SSE2 : BS_KERNEL_WORD;
+    }
+    if (k == BS_KERNEL_AVX2 && !(has_avx2 && has_popcnt)) {
+        k = BS_KERNEL_SSE2;
+    }
+    if (k == BS_KERNEL_SSE2 && !has_sse2) {
+        k = BS_KERNEL_WORD;
+    }
+    switch (k) {
+    case BS_KERNEL_BYTE: kernel = g_bs_byte_kernel; break;
+    case BS_KERNEL_SSE2: kernel = g_bs_sse2_kernel; break;
+    case BS_KERNEL_AVX2: kernel = g_bs_avx2_kernel; break;
+    default: kernel = g_bs_word_kernel; break;
+    }
+    if (has_popcnt && k != BS_KERNEL_BYTE && k != BS_KERNEL_AVX2) {
+        kernel.popcount = bs_popcnt_popcount;
+    }
+    #else
+    if (k == BS_KERNEL_BYTE) {
+        kernel = g_bs_byte_kernel;
+    } else {
+        kernel = g_bs_word_kernel;
+    }
+    #endif
+    return kernel;
+}
+
+
+//Return the kernel in use.
+//The kernel is selected once on the first call, thus BitSets used by
+//static constructors of other files are serviced regardless of the
+//order of initialization. The initialization of local static is
+//guarded by compiler, and is thread safe.
+static inline BSKernel & bs_kernel()
+{
+    static BSKernel kernel = bs_select_kernel(BS_KERNEL_AUTO);
+    return kernel;
+}
+
+
+#ifdef _DEBUG_
+//Only used by test and benchmark, it is not thread safe.
+BS_KERNEL bs_set_kernel(BS_KERNEL k)
+{
+    bs_kernel() = bs_select_kernel(k);
+    return bs_kernel().kind;
+}
+#endif
+
+
+BS_KERNEL bs_get_kernel()
+{
+    return bs_kernel().kind;
+}
+
+
+CHAR const* bs_get_kernel_name(BS_KERNEL k)
+{
+    switch (k) {
+    case BS_KERNEL_AUTO: return "auto";
+    case BS_KERNEL_BYTE: return "byte";
+    case BS_KERNEL_WORD: return "word";
+    case BS_KERNEL_SSE2: return "sse2";
+    case BS_KERNEL_AVX2: return "avx2";
+    default: UNREACH();
+    }
+    return NULL;
+}
+
+
+//Allocate bit vector at the alignment of BS_ALIGN.
+void * bs_malloc(size_t size)
+{
+    ASSERT0(size > 0);
+    void * p = NULL;
+    #ifdef _WINDOWS_
+    p = _aligned_malloc(size, BS_ALIGN);
+    #else
+    if (posix_memalign(&p, BS_ALIGN, size) != 0) {
+        p = NULL;
+    }
+    #endif
+    ASSERT(p != NULL, ("malloc failed"));
+    return p;
+}
+
+
+void bs_free(void * p)
+{
+    #ifdef _WINDOWS_
+    _aligned_free(p);
+    #else
+    ::free(p);
+    #endif
+}
+//END BitSet Kernels
+
+
 //
 //START BitSet
 //
@@ -840,11 +1338,12 @@ void * BitSet::realloc(IN void * src, size_t orgsize, size_t newsize)
         clean();
         return src;
     }
-    void * p = ::malloc(newsize);
+    ASSERT0(newsize == BS_ROUNDUP(newsize));
+    void * p = bs_malloc(newsize);
     if (src != NULL) {
         ASSERT0(orgsize > 0);
         ::memcpy(p, src, orgsize);
-        ::free(src);
+        bs_free(src);
         ::memset(((BYTE*)p) + orgsize, 0, newsize - orgsize);
     } else {
         ::memset(p, 0, newsize);
@@ -856,10 +1355,10 @@ void * BitSet::realloc(IN void * src, size_t orgsize, size_t newsize)
 //Allocate bytes
 void BitSet::alloc(UINT size)
 {
-    m_size = size;
-    if (m_ptr != NULL) { ::free(m_ptr);    }
+    m_size = BS_ROUNDUP(size);
+    if (m_ptr != NULL) { bs_free(m_ptr); }
     if (size != 0) {
-        m_ptr = (BYTE*)::malloc(size);
+        m_ptr = (BYTE*)bs_malloc(m_size);
         ::memset(m_ptr, 0, m_size);
     } else {
         m_ptr = NULL;
@@ -880,20 +1379,13 @@ void BitSet::bunion(BitSet const& bs)
         if (l < 0) { return; }
         cp_sz = l / BITS_PER_BYTE + 1;
         if (m_size < cp_sz) {
-            m_ptr = (BYTE*)realloc(m_ptr, m_size, cp_sz);
-            m_size = cp_sz;
+            UINT const newsz = BS_ROUNDUP(cp_sz);
+            m_ptr = (BYTE*)realloc(m_ptr, m_size, newsz);
+            m_size = newsz;
         }
     }
-    UINT const num_of_uint = cp_sz / BYTES_PER_UINT; //floor-div.
     ASSERT(m_ptr, ("not yet init"));
-    UINT * uint_ptr_this = (UINT*)m_ptr;
-    UINT * uint_ptr_bs = (UINT*)bs.m_ptr;
-    for (UINT i = 0; i < num_of_uint; i++) {
-        uint_ptr_this[i] |= uint_ptr_bs[i];
-    }
-    for (UINT i = num_of_uint * BYTES_PER_UINT; i < cp_sz; i++) {
-        m_ptr[i] |= bs.m_ptr[i];
-    }
+    bs_kernel().bor(m_ptr, bs.m_ptr, cp_sz);
 }
 
 
@@ -902,8 +1394,9 @@ void BitSet::bunion(UINT elem)
 {
     UINT const first_byte = DIVBPB(elem);
     if (m_size < (first_byte+1)) {
-        m_ptr = (BYTE*)realloc(m_ptr, m_size, first_byte + 1);
-        m_size = first_byte+1;
+        UINT const newsz = BS_ROUNDUP(first_byte + 1);
+        m_ptr = (BYTE*)realloc(m_ptr, m_size, newsz);
+        m_size = newsz;
     }
     elem = MODBPB(elem);
     m_ptr[first_byte] |= (BYTE)(1 << elem);
@@ -934,28 +1427,9 @@ void BitSet::diff(BitSet const& bs)
 {
     ASSERT0(this != &bs);
     if (m_size == 0 || bs.m_size == 0) { return; }
-    UINT minsize = MIN(m_size, bs.m_size);
-    //Common part: copy the inverse bits.
-    //for (UINT i = 0; i < minsize; i++) {
-    //    m_ptr[i] &= ~bs.m_ptr[i];
-    //}
-    UINT num_of_uint = minsize / BYTES_PER_UINT;
-    UINT * uint_ptr_this = (UINT*)m_ptr;
-    UINT * uint_ptr_bs = (UINT*)bs.m_ptr;
-    for (UINT i = 0; i < num_of_uint; i++) {
-        UINT d = uint_ptr_bs[i];
-        if (d != 0) {
-            uint_ptr_this[i] &= ~d;
-        }
-    }
-
     ASSERT(m_ptr != NULL, ("not yet init"));
-    for (UINT i = num_of_uint * BYTES_PER_UINT; i < minsize; i++) {
-        BYTE d = bs.m_ptr[i];
-        if (d != 0) {
-            m_ptr[i] &= ~d;
-        }
-    }
+    //Common part: clear the bits that set in 'bs'.
+    bs_kernel().bandn(m_ptr, bs.m_ptr, MIN(m_size, bs.m_size));
 }
 
 
@@ -965,14 +1439,10 @@ void BitSet::intersect(BitSet const& bs)
     ASSERT0(this != &bs);
     if (m_ptr == NULL) { return; }
     if (m_size > bs.m_size) {
-        for (UINT i = 0; i < bs.m_size; i++) {
-            m_ptr[i] &= bs.m_ptr[i];
-        }
+        bs_kernel().band(m_ptr, bs.m_ptr, bs.m_size);
         ::memset(m_ptr + bs.m_size, 0, m_size - bs.m_size);
     } else {
-        for (UINT i = 0; i < m_size; i++) {
-            m_ptr[i] &= bs.m_ptr[i];
-        }
+        bs_kernel().band(m_ptr, bs.m_ptr, m_size);
     }
 }
 
@@ -1017,32 +1487,10 @@ void BitSet::complement(BitSet const& univers)
 
 
 //Return the element count in 'set'
-//Add up the population count of each byte in the set.  We get the
-//population counts from the table above.  Great for a machine with
-//effecient loadbyte instructions.
 UINT BitSet::get_elem_count() const
 {
     if (m_ptr == NULL) { return 0; }
-    UINT count = 0;
-//#define HAMMING_WEIGHT_METHOD
-#ifdef HAMMING_WEIGHT_METHOD
-    ASSERT0(BYTES_PER_UINT == 4);
-    UINT const m = m_size / BYTES_PER_UINT;
-    for (UINT i = 0; i < m; i++) {
-        INT v = ((INT*)(m_ptr))[i];
-        v = v - ((v >> 1) & 0x55555555);
-        v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
-        count += (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
-    }
-    for (UINT i = m * BYTES_PER_UINT; i < m_size; i++) {
-        count += g_bit_count[m_ptr[i]];
-    }
-#else
-    for (UINT i = 0; i < m_size; i++) {
-        count += g_bit_count[m_ptr[i]];
-    }
-#endif
-    return count;
+    return bs_kernel().popcount(m_ptr, m_size);
 }
 
 
@@ -1072,31 +1520,8 @@ bool BitSet::is_equal(BitSet const& bs) const
         size2 = tmp1;
     }
 
-    UINT v1 = *(UINT*)ptr1;
-    UINT v2 = *(UINT*)ptr2;
-    switch (size1) {
-    case 1:
-        if ((v1&0xff) != (v2&0xff)) { return false;    }
-        break;
-    case 2:
-        if ((v1&0xffff) != (v2&0xffff)) { return false;    }
-        break;
-    case 3:
-        if ((v1&0xffffff) != (v2&0xffffff)) { return false; }
-        break;
-    case 4:
-        if ((v1&0xffffffff) != (v2&0xffffffff)) { return false; }
-        break;
-    default:
-        if (::memcmp(ptr1, ptr2, size1) != 0) { return false; }
-    }
-
-    for (UINT i = size1; i < size2; i++) {
-        if (ptr2[i] != 0) {
-            return false;
-        }
-    }
-    return true;
+    if (::memcmp(ptr1, ptr2, size1) != 0) { return false; }
+    return bs_is_zero(ptr2 + size1, size2 - size1);
 }
 
 
@@ -1121,97 +1546,45 @@ bool BitSet::is_contain(UINT elem) const
 bool BitSet::is_contain(BitSet const& bs, bool strict) const
 {
     ASSERT0(this != &bs);
-    bool scon = false; //Set to true if 'this' strictly contained 'bs'.
-    INT const first_bit = get_first();
-    if (first_bit == -1) {
+    if (is_empty()) {
         return false;
     }
-    INT const bs_first_bit = bs.get_first();
-    if (bs_first_bit == -1) {
-        //NULL set be contained for any set.
-        return true;
-    }
 
-    if (first_bit > bs_first_bit) {
+    //Note NULL set be contained for any set.
+    UINT const minsize = MIN(m_size, bs.m_size);
+    if (m_size < bs.m_size &&
+        !bs_is_zero(bs.m_ptr + minsize, bs.m_size - minsize)) {
+        //'bs' has more elements than 'this'.
         return false;
-    } else if (strict && first_bit < bs_first_bit) {
-        scon = true;
     }
-
-    INT const start_bit = MAX(first_bit, bs_first_bit);
-    INT const start_byte = DIVBPB(start_bit);
-
-    if (m_size < bs.m_size) {//'this' is smaller
-        if (bs.get_next(MULBPB(m_size) - 1) != -1) {
-            //'bs' has more elements than 'this'.
-            return false;
-        }
-    } else if (strict && m_size > bs.m_size) {//'bs' is smaller
-        if (get_next(MULBPB(bs.m_size) - 1) != -1) {
-            //'this' has more elements than 'this'.
-            scon = true;
-        }
+    if (!bs_kernel().is_contain(m_ptr, bs.m_ptr, minsize)) {
+        return false;
     }
-
-    INT const minsize = MIN(m_size, bs.m_size);
-    for (INT i = start_byte; i < minsize; i++) {
-        if ((m_ptr[i] & bs.m_ptr[i]) != bs.m_ptr[i]) {
-            return false;
-        }
-        if (strict && m_ptr[i] != bs.m_ptr[i]) {
-            scon = true;
-        }
+    if (!strict) {
+        return true;
     }
 
-    if (strict && !scon) {
-        return false;
+    //'this' strictly contains 'bs' if they are not equal.
+    if (m_size > bs.m_size &&
+        !bs_is_zero(m_ptr + minsize, m_size - minsize)) {
+        //'this' has more elements than 'bs'.
+        return true;
     }
-    return true;
+    return ::memcmp(m_ptr, bs.m_ptr, minsize) != 0;
 }
 
 
 bool BitSet::is_empty() const
 {
     if (m_ptr == NULL) { return true; }
-    UINT num_of_uint = m_size / BYTES_PER_UINT;
-    UINT * uint_ptr = (UINT*)m_ptr;
-    for (UINT i = 0; i < num_of_uint; i++) {
-        if (uint_ptr[i] != 0) {
-             return false;
-        }
-    }
-    for (UINT i = num_of_uint * BYTES_PER_UINT; i < m_size; i++) {
-        if (m_ptr[i] != (BYTE)0) {
-             return false;
-        }
-    }
-    return true;
+    return bs_is_zero(m_ptr, m_size);
 }
 
 
 bool BitSet::is_intersect(BitSet const& bs) const
 {
     ASSERT0(this != &bs);
-    INT const first_bit = get_first();
-    if (first_bit == -1) {
-        return false;
-    }
-    INT const bs_first_bit = bs.get_first();
-    if (bs_first_bit == -1) { //Empty set
-        return false;
-    }
-
-    UINT const start_bit = MAX(first_bit, bs_first_bit);
-    UINT const end_bit = MIN(get_last(), bs.get_last());
-    UINT const start_byte = DIVBPB(start_bit);
-    UINT const end_byte = DIVBPB(end_bit);
-
-    for (UINT i = start_byte; i <= end_byte; i++) {
-        if ((m_ptr[i] & bs.m_ptr[i]) != (BYTE)0) {
-            return true;
-        }
-    }
-    return false;
+    return bs_kernel().is_intersect(m_ptr, bs.m_ptr, MIN(m_size, bs.m_size));
 }
 
 
@@ -1353,22 +1726,13 @@ bool BitSet::has_elem_in_range(UINT low, UINT high) const
 //Return -1 if the bitset is empty.
 INT BitSet::get_first() const
 {
-    if (m_size == 0) return -1;
     UINT i = 0;
-    UINT m = m_size / BYTES_PER_UINT * BYTES_PER_UINT;
-    for (UINT const* uint_ptr = ((UINT const*)(m_ptr));
-         i < m; uint_ptr++, i += 4) {
-        if (*uint_ptr == 0) { continue; }
-        for (BYTE const* bptr = ((BYTE*)(uint_ptr));
-             i < m; bptr++, i++) {
-            BYTE byte = *bptr;
-            if (byte != (BYTE)0) {
-                return g_first_one[byte] + (MULBPB(i));
-            }
+    for (; i + BS_WORD_BYTE <= m_size; i += BS_WORD_BYTE) {
+        ULONGLONG v = bs_ld(m_ptr + i);
+        if (v != 0) {
+            return (INT)(MULBPB(i) + bs_ctz64(v));
         }
-        ASSERT(0, ("not arrival"));
     }
-    ASSERT0(i <= m_size);
     for (; i < m_size; i++) {
         BYTE byte = m_ptr[i];
         if (byte != (BYTE)0) {
@@ -1382,32 +1746,20 @@ INT BitSet::get_first() const
 //Get bit postition of the last element.
 INT BitSet::get_last() const
 {
-    if (m_size == 0) return -1;
-    INT i = m_size - 1;
-    UINT m = m_size % BYTES_PER_UINT;
-    if (m == 0) {
-        m = BYTES_PER_UINT;
-    }
-    for (; i >= (INT)(m_size - m); i--) {
-        BYTE byte = m_ptr[i];
+    //Scan the odd tailing bytes which do not fill a word.
+    UINT const m = m_size / BS_WORD_BYTE * BS_WORD_BYTE;
+    for (UINT i = m_size; i > m; i--) {
+        BYTE byte = m_ptr[i - 1];
         if (byte != (BYTE)0) {
-            return g_last_one[byte] + (MULBPB(i));
+            return g_last_one[byte] + (MULBPB(i - 1));
         }
     }
-    if (i < 0) { return -1; }
-    UINT const* uint_ptr;
-    for (uint_ptr = ((UINT const*)(m_ptr)) + i / BYTES_PER_UINT;
-         i >= 0; uint_ptr--, i -= 4) {
-        if (*uint_ptr == 0) { continue; }
-        for (BYTE const* bptr = ((BYTE*)(uint_ptr)) + BYTES_PER_UINT - 1;
-             i >= 0; bptr--, i--) {
-            BYTE byte = *bptr;
-            if (byte != (BYTE)0) {
-                return g_last_one[byte] + (MULBPB(i));
-            }
+    for (UINT i = m; i > 0; i -= BS_WORD_BYTE) {
+        ULONGLONG v = bs_ld(m_ptr + i - BS_WORD_BYTE);
+        if (v != 0) {
+            return (INT)(MULBPB(i - BS_WORD_BYTE) + bs_msb64(v));
         }
     }
-    ASSERT0(m_ptr == ((BYTE*)uint_ptr) + sizeof(UINT));
     return -1;
 }
 
@@ -1532,31 +1884,43 @@ BitSet * BitSet::get_subset_in_range(UINT low, UINT high, OUT BitSet & subset)
 //'elem': return next one to current element.
 INT BitSet::get_next(UINT elem) const
 {
-    if (m_size == 0) return -1;
-    INT first_byte = DIVBPB(elem);
-    if (((UINT)first_byte + 1) > m_size) {
+    UINT const start = elem + 1; //the first candidate.
+    UINT const start_byte = DIVBPB(start);
+    if (start_byte >= m_size) {
         return -1;
     }
-    BYTE byte = m_ptr[first_byte];
-    elem = MODBPB(elem) + 1; //index in 'first_byte'.
-    byte >>= elem; //Erase low 'elem' bits.
-    byte <<= elem;
-    if (byte == 0) {
-        //No elements in this byte.
-        UINT i = first_byte + 1;
-        while (i < m_size) {
-            byte = m_ptr[i];
-            if (byte != 0) {
-                first_byte = i;
-                break;
+
+    //Inspect the word that 'start' belongs to, and erase
+    //the bits lower than 'start'.
+    UINT i = start_byte / BS_WORD_BYTE * BS_WORD_BYTE;
+    if (i + BS_WORD_BYTE <= m_size) {
+        ULONGLONG v = bs_ld(m_ptr + i) & (~0ULL << (start - MULBPB(i)));
+        if (v != 0) {
+            return (INT)(MULBPB(i) + bs_ctz64(v));
+        }
+        for (i += BS_WORD_BYTE; i + BS_WORD_BYTE <= m_size;
+             i += BS_WORD_BYTE) {
+            v = bs_ld(m_ptr + i);
+            if (v != 0) {
+                return (INT)(MULBPB(i) + bs_ctz64(v));
             }
-            i++;
         }
-        if (byte == 0) {
-            return -1;
+    } else {
+        //'start' is in the odd tailing bytes.
+        i = start_byte;
+        BYTE byte = (BYTE)(m_ptr[i] & (0xFF << MODBPB(start)));
+        if (byte != 0) {
+            return g_first_one[byte] + (MULBPB(i));
         }
+        i++;
     }
-    return g_first_one[byte] + (MULBPB(first_byte));
+    for (; i < m_size; i++) {
+        BYTE byte = m_ptr[i];
+        if (byte != (BYTE)0) {
+            return g_first_one[byte] + (MULBPB(i));
+        }
+    }
+    return -1;
 }
 
 
@@ -1587,10 +1951,11 @@ void BitSet::copy(BitSet const& src)
 
         cp_sz = l / BITS_PER_BYTE + 1;
         if (m_size < cp_sz) {
-            ::free(m_ptr);
-            m_ptr = (BYTE*)::malloc(cp_sz);
-            m_size = cp_sz;
-        } else if (m_size > cp_sz) {
+            if (m_ptr != NULL) { bs_free(m_ptr); }
+            m_size = BS_ROUNDUP(cp_sz);
+            m_ptr = (BYTE*)bs_malloc(m_size);
+        }
+        if (m_size > cp_sz) {
             ::memset(m_ptr + cp_sz, 0, m_size - cp_sz);
         }
     } else if (m_size > src.m_size) {
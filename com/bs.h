@@ -42,9 +42,71 @@ namespace xcom {
 #define BITS_PER_BYTE     8
 #define BYTES_PER_UINT    4
 
+//The bit vector of BitSet is allocated at the alignment of BS_ALIGN byte,
+//and its length is padded to multiple of BS_PAD_BYTE byte, thus the
+//word-parallel and SIMD kernels can run over the whole vector without
+//handling odd tailing bytes.
+#define BS_ALIGN          32
+#define BS_PAD_BYTE       8
+#define BS_ROUNDUP(n)     (((n) + BS_PAD_BYTE - 1) & ~(BS_PAD_BYTE - 1))
+
+//Kernel that performs the set algebra of BitSet.
+//BS_KERNEL_AUTO picks the fastest kernel supported by host CPU.
+typedef enum {
+    BS_KERNEL_AUTO = 0,
+    BS_KERNEL_BYTE, //byte-by-byte loop, the original implementation.
+    BS_KERNEL_WORD, //64bit word-parallel loop.
+    BS_KERNEL_SSE2, //128bit SSE2 loop.
+    BS_KERNEL_AVX2, //256bit AVX2 loop.
+} BS_KERNEL;
+
 class BitSet;
 class BitSetMgr;
 
+extern void * bs_malloc(size_t size);
+extern void bs_free(void * p);
+
+//Return the index of the lowest one bit, 'v' can not be 0.
+inline UINT bs_ctz64(ULONGLONG v)
+{
+    ASSERT0(v != 0);
+    #ifdef __GNUC__
+    return (UINT)__builtin_ctzll(v);
+    #else
+    UINT n = 0;
+    for (; (v & 1) == 0; v >>= 1) { n++; }
+    return n;
+    #endif
+}
+
+
+//Return the index of the highest one bit, 'v' can not be 0.
+inline UINT bs_msb64(ULONGLONG v)
+{
+    ASSERT0(v != 0);
+    #ifdef __GNUC__
+    return 63 - (UINT)__builtin_clzll(v);
+    #else
+    UINT n = 0;
+    for (v >>= 1; v != 0; v >>= 1) { n++; }
+    return n;
+    #endif
+}
+
+
+//Return the number of one bits in 'v'.
+inline UINT bs_popcnt64(ULONGLONG v)
+{
+    #ifdef __GNUC__
+    return (UINT)__builtin_popcountll(v);
+    #else
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (UINT)((v * 0x0101010101010101ULL) >> 56);
+    #endif
+}
+
 class BitSet
 {
     friend BitSet * bs_union(BitSet const& set1,
@@ -82,9 +144,9 @@ public:
     void init(UINT init_pool_size = 1)
     {
         if (m_ptr != NULL) return;
-        m_size = init_pool_size;
+        m_size = BS_ROUNDUP(init_pool_size);
         if (init_pool_size == 0) return;
-        m_ptr = (BYTE*)::malloc(init_pool_size);
+        m_ptr = (BYTE*)bs_malloc(m_size);
         ::memset(m_ptr, 0, m_size);
     }
 
@@ -92,7 +154,7 @@ public:
     {
         if (m_ptr == NULL) return;
         ASSERT(m_size > 0, ("bitset is invalid"));
-        ::free(m_ptr);
+        bs_free(m_ptr);
         m_ptr = NULL;
         m_size = 0;
     }
@@ -544,6 +606,11 @@ public:
 
 
 extern BYTE const g_bit_count[];
+
+//Return the kernel of BitSet set algebra in use.
+extern BS_KERNEL bs_get_kernel();
+extern CHAR const* bs_get_kernel_name(BS_KERNEL k);
+
 extern inline BitSet * bs_create(BitSetMgr & bs_mgr)
 {
     return bs_mgr.create();
@@ -557,5 +624,13 @@ extern BitSet * bs_diff(BitSet const& set1,
 extern BitSet * bs_intersect(BitSet const& set1,
                              BitSet const& set2,
                              OUT BitSet & res);
+
+#ifdef _DEBUG_
+//Select the kernel of BitSet set algebra, only used by test and
+//benchmark, it is not thread safe.
+//Return the kernel actually used, which may be weaker than 'k'
+//if host CPU does not support it.
+extern BS_KERNEL bs_set_kernel(BS_KERNEL k);
+#endif
 } //namespace xcom
 #endif
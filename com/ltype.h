@@ -60,6 +60,9 @@ author: Su Zhenyu
     #define SNPRINTF _snprintf
     #define VSNPRINTF _vsnprintf 
     #define RESTRICT __restrict
+
+    //Each thread has its own copy of variable.
+    #define THREAD_LOCAL __declspec(thread)
 #else    
     //Default is linux version
     #include "unistd.h" //for unlink declaration
@@ -67,6 +70,9 @@ author: Su Zhenyu
     #define SNPRINTF snprintf
     #define VSNPRINTF vsnprintf
     #define RESTRICT __restrict__
+
+    //Each thread has its own copy of variable.
+    #define THREAD_LOCAL __thread
 #endif
 
 #include "stdlib.h"
@@ -75,6 +81,12 @@ author: Su Zhenyu
 #include "string.h"
 #include "memory.h"
 
+//SSE2 is used to probe a group of hash tags at one time.
+#if defined(__SSE2__) || defined(_M_X64)
+    #include "emmintrin.h"
+    #define _SSE2_
+#endif
+
 //These types may be defined, but we need to override them.
 #undef STATUS
 #undef BYTE
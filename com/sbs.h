@@ -36,10 +36,28 @@ namespace xcom {
 #endif
 #define BITS_PER_SEG    512
 
+//Number of 64bit words that a flat segment needs.
+#define FSEG_WORD_NUM(bits_per_seg)  (((bits_per_seg) + 63) / 64)
+
+//Number of capacity classes of flat segment array, the capacity of
+//class 'i' is 2^i records.
+#define FSEG_CAP_CLASS_NUM  32
+
 class BitSet;
 class BitSetMgr;
 template <UINT BitsPerSeg> class MiscBitSetMgr;
 
+//Record the set operations of SBitSetCore into the file if it is not NULL.
+//The trace can be replayed by com/bench/bench_sbs.cpp.
+extern FILE * g_sbs_trace;
+
+#ifdef _DEBUG_
+#define SBS_TRACE(params) \
+    do { if (g_sbs_trace != NULL) { fprintf params; } } while (0)
+#else
+#define SBS_TRACE(params)
+#endif
+
 //Templated SEG iter.
 #define TSEGIter SC<SEG<BitsPerSeg>*>
 
@@ -99,6 +117,144 @@ public:
 };
 
 
+//Flat Segment.
+//The record of flat sparse bitset, which holds the bits of segment inline
+//rather than in a separately allocated BitSet. The records of a set are
+//kept sorted by 'start' in one contiguous array.
+template <UINT BitsPerSeg = BITS_PER_SEG>
+class FSEG {
+public:
+    UINT start;
+    ULONGLONG w[FSEG_WORD_NUM(BitsPerSeg)];
+
+public:
+    void init(UINT st)
+    {
+        start = st;
+        ::memset(w, 0, sizeof(w));
+    }
+
+    void bunion(UINT ofst) { w[ofst / 64] |= (1ULL << (ofst % 64)); }
+    void bunion(FSEG const& src)
+    {
+        for (UINT i = 0; i < FSEG_WORD_NUM(BitsPerSeg); i++) {
+            w[i] |= src.w[i];
+        }
+    }
+
+    void diff(UINT ofst) { w[ofst / 64] &= ~(1ULL << (ofst % 64)); }
+
+    //Return true if the result is not empty.
+    bool diff(FSEG const& src)
+    {
+        ULONGLONG r = 0;
+        for (UINT i = 0; i < FSEG_WORD_NUM(BitsPerSeg); i++) {
+            w[i] &= ~src.w[i];
+            r |= w[i];
+        }
+        return r != 0;
+    }
+
+    //Return true if the result is not empty.
+    bool intersect(FSEG const& src)
+    {
+        ULONGLONG r = 0;
+        for (UINT i = 0; i < FSEG_WORD_NUM(BitsPerSeg); i++) {
+            w[i] &= src.w[i];
+            r |= w[i];
+        }
+        return r != 0;
+    }
+
+    bool is_contain(UINT ofst) const
+    { return (w[ofst / 64] & (1ULL << (ofst % 64))) != 0; }
+
+    bool is_empty() const
+    {
+        ULONGLONG r = 0;
+        for (UINT i = 0; i < FSEG_WORD_NUM(BitsPerSeg); i++) {
+            r |= w[i];
+        }
+        return r == 0;
+    }
+
+    bool is_equal(FSEG const& src) const
+    { return start == src.start && ::memcmp(w, src.w, sizeof(w)) == 0; }
+
+    bool is_intersect(FSEG const& src) const
+    {
+        for (UINT i = 0; i < FSEG_WORD_NUM(BitsPerSeg); i++) {
+            if ((w[i] & src.w[i]) != 0) { return true; }
+        }
+        return false;
+    }
+
+    UINT get_elem_count() const
+    {
+        UINT c = 0;
+        for (UINT i = 0; i < FSEG_WORD_NUM(BitsPerSeg); i++) {
+            c += bs_popcnt64(w[i]);
+        }
+        return c;
+    }
+
+    //Return the offset of the first element, or -1 if segment is empty.
+    INT get_first() const
+    {
+        for (UINT i = 0; i < FSEG_WORD_NUM(BitsPerSeg); i++) {
+            if (w[i] != 0) { return (INT)(i * 64 + bs_ctz64(w[i])); }
+        }
+        return -1;
+    }
+
+    //Return the offset of the last element, or -1 if segment is empty.
+    INT get_last() const
+    {
+        for (UINT i = FSEG_WORD_NUM(BitsPerSeg); i > 0; i--) {
+            if (w[i - 1] != 0) {
+                return (INT)((i - 1) * 64 + bs_msb64(w[i - 1]));
+            }
+        }
+        return -1;
+    }
+
+    //Return the offset of the element next to 'ofst', or -1 if
+    //there is not.
+    INT get_next(UINT ofst) const
+    {
+        UINT n = ofst + 1;
+        UINT i = n / 64;
+        if (i >= FSEG_WORD_NUM(BitsPerSeg)) { return -1; }
+        ULONGLONG v = w[i] & (~0ULL << (n % 64));
+        for (;;) {
+            if (v != 0) { return (INT)(i * 64 + bs_ctz64(v)); }
+            i++;
+            if (i >= FSEG_WORD_NUM(BitsPerSeg)) { return -1; }
+            v = w[i];
+        }
+        return -1;
+    }
+};
+
+
+//Flat segment array.
+//The header is followed by 2^cap_class records in one allocation.
+template <UINT BitsPerSeg = BITS_PER_SEG>
+class FSEGVec {
+public:
+    UINT num; //the number of records in use.
+    UINT cap_class; //the capacity is 2^cap_class records.
+
+public:
+    FSEG<BitsPerSeg> * get_fsegs()
+    { return (FSEG<BitsPerSeg>*)(this + 1); }
+    FSEG<BitsPerSeg> const* get_fsegs() const
+    { return (FSEG<BitsPerSeg> const*)(this + 1); }
+
+    UINT get_cap() const { return 1u << cap_class; }
+};
+
+
 //Segment Manager.
 //This class is responsible to allocate and destroy SEG object.
 //Note this class only handle Default SEG.
@@ -116,6 +272,21 @@ public:
 protected:
     SList<SEG<BitsPerSeg>*> m_free_list;
 
+    //True if the sparse bitsets serviced by current SegMgr should use
+    //flat segment array.
+    bool m_is_flat;
+
+    //Free lists of flat segment array. The array of class 'i' has
+    //2^i records, and the first record of freed array records the next one.
+    FSEGVec<BitsPerSeg> * m_fvec_free[FSEG_CAP_CLASS_NUM];
+
+    //Bytes of flat segment arrays allocated.
+    size_t m_fvec_bytes;
+
+    #ifdef _DEBUG_
+    UINT m_fvec_count; //the number of flat segment arrays allocated.
+    #endif
+
 public:
     SegMgr()
     {
@@ -125,6 +296,12 @@ public:
 
         SMemPool * p = smpoolCreate(sizeof(TSEGIter) * 4, MEM_CONST_SIZE);
         m_free_list.set_pool(p);
+        m_is_flat = false;
+        m_fvec_bytes = 0;
+        ::memset(m_fvec_free, 0, sizeof(m_fvec_free));
+        #ifdef _DEBUG_
+        m_fvec_count = 0;
+        #endif
     }
     COPY_CONSTRUCTOR(SegMgr);
     ~SegMgr()
@@ -145,6 +322,56 @@ public:
         ASSERT(m_free_list.get_pool(), ("miss pool"));
 
         smpoolDelete(m_free_list.get_pool());
+
+        //Release the flat segment arrays freed by sets.
+        #ifdef _DEBUG_
+        UINT nfvec = 0;
+        #endif
+        for (UINT i = 0; i < FSEG_CAP_CLASS_NUM; i++) {
+            FSEGVec<BitsPerSeg> * next;
+            for (FSEGVec<BitsPerSeg> * v = m_fvec_free[i];
+                 v != NULL; v = next) {
+                next = *(FSEGVec<BitsPerSeg>**)v->get_fsegs();
+                ::free(v);
+                #ifdef _DEBUG_
+                nfvec++;
+                #endif
+            }
+        }
+        #ifdef _DEBUG_
+        ASSERT(m_fvec_count == nfvec,
+               ("MemLeak! There still are flat segment arrays not freed"));
+        #endif
+    }
+
+    //Allocate flat segment array with 2^'cap_class' records.
+    FSEGVec<BitsPerSeg> * alloc_fvec(UINT cap_class)
+    {
+        ASSERT0(cap_class < FSEG_CAP_CLASS_NUM);
+        FSEGVec<BitsPerSeg> * v = m_fvec_free[cap_class];
+        if (v != NULL) {
+            m_fvec_free[cap_class] = *(FSEGVec<BitsPerSeg>**)v->get_fsegs();
+        } else {
+            size_t const sz = sizeof(FSEGVec<BitsPerSeg>) +
+                sizeof(FSEG<BitsPerSeg>) * ((size_t)1 << cap_class);
+            v = (FSEGVec<BitsPerSeg>*)::malloc(sz);
+            ASSERT(v, ("malloc failed"));
+            m_fvec_bytes += sz;
+            #ifdef _DEBUG_
+            m_fvec_count++;
+            #endif
+        }
+        v->num = 0;
+        v->cap_class = cap_class;
+        return v;
+    }
+
+    //Free flat segment array for next use.
+    void free_fvec(FSEGVec<BitsPerSeg> * v)
+    {
+        ASSERT0(v && v->cap_class < FSEG_CAP_CLASS_NUM);
+        *(FSEGVec<BitsPerSeg>**)v->get_fsegs() = m_fvec_free[v->cap_class];
+        m_fvec_free[v->cap_class] = v;
     }
 
     inline void free(SEG<BitsPerSeg> * s)
@@ -192,6 +419,7 @@ public:
         }
 
         count += m_free_list.count_mem();
+        count += m_fvec_bytes;
         return count;
     }
 
@@ -204,10 +432,46 @@ public:
 
     SList<SEG<BitsPerSeg>*> const* get_free_list() const
     { return &m_free_list; }
+
+    bool is_flat() const { return m_is_flat; }
+
+    //Set to true if the sparse bitsets serviced by current SegMgr use
+    //flat segment array. The representation of a bitset is decided
+    //when it is empty and going to be modified.
+    void set_flat(bool is_flat) { m_is_flat = is_flat; }
+};
+
+
+//List of SEG.
+//The list of a set in flat representation is always empty, and the tail
+//of the empty list records the flat segment array, thus the sets in list
+//representation do not pay for the flat representation.
+template <UINT BitsPerSeg = BITS_PER_SEG>
+class SEGList : public SListEx<SEG<BitsPerSeg>*> {
+    typedef SListEx<SEG<BitsPerSeg>*> Base;
+public:
+    //Return the flat segment array, or NULL if set is in list
+    //representation.
+    FSEGVec<BitsPerSeg> * get_fvec() const
+    {
+        if (Base::m_elem_count != 0) { return NULL; }
+        return (FSEGVec<BitsPerSeg>*)(void*)Base::m_tail;
+    }
+
+    void set_fvec(FSEGVec<BitsPerSeg> * v)
+    {
+        ASSERT0(Base::m_elem_count == 0 && Base::m_head == NULL);
+        Base::m_tail = (SC<SEG<BitsPerSeg>*>*)(void*)v;
+    }
 };
 
 
 //Sparse BitSet Core
+//The set has two kinds of representation, which is decided by the
+//SegMgr while the set is empty and going to be modified:
+//  * List: SEGs are chained in 'segs', each of them owns a BitSet.
+//  * Flat: FSEGs are kept sorted in the contiguous array recorded by
+//    'segs', set operations are merge-joins over the arrays.
 //e.g1:
 //    MiscBitSetMgr<33> mbsm;
 //    SBitSetCore<33> * x = mbsm.allocSBitSetCore() ;
@@ -221,9 +485,70 @@ public:
 template <UINT BitsPerSeg = BITS_PER_SEG>
 class SBitSetCore {
 protected:
-    SListEx<SEG<BitsPerSeg>*> segs;
+    SEGList<BitsPerSeg> segs;
 
     void * realloc(IN void * src, size_t orgsize, size_t newsize);
+
+    //Return the index of the first record whose start is not less
+    //than 'start'.
+    UINT fseg_lower_bound(UINT start) const
+    {
+        FSEGVec<BitsPerSeg> const* v = segs.get_fvec();
+        ASSERT0(v);
+        FSEG<BitsPerSeg> const* f = v->get_fsegs();
+        UINT lo = 0;
+        UINT hi = v->num;
+        while (lo < hi) {
+            UINT mid = (lo + hi) / 2;
+            if (f[mid].start < start) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    //Return the number of records of flat segment array.
+    UINT fseg_num() const
+    {
+        FSEGVec<BitsPerSeg> const* v = segs.get_fvec();
+        return v == NULL ? 0 : v->num;
+    }
+
+    void fseg_free(SegMgr<BitsPerSeg> * sm)
+    {
+        FSEGVec<BitsPerSeg> * v = segs.get_fvec();
+        if (v == NULL) { return; }
+        sm->free_fvec(v);
+        segs.set_fvec(NULL);
+    }
+
+    void fseg_reserve(UINT n, SegMgr<BitsPerSeg> * sm);
+    void fseg_bunion(UINT elem, SegMgr<BitsPerSeg> * sm);
+    void fseg_bunion(SBitSetCore<BitsPerSeg> const& src,
+                     SegMgr<BitsPerSeg> * sm);
+    void fseg_diff(UINT elem);
+    void fseg_diff(SBitSetCore<BitsPerSeg> const& src);
+    void fseg_intersect(SBitSetCore<BitsPerSeg> const& src);
+
+    //Decide the representation of set before modification.
+    //'src': the other operand, may be NULL.
+    inline void select_repr(SegMgr<BitsPerSeg> * sm,
+                            SBitSetCore<BitsPerSeg> const* src)
+    {
+        bool is_flat = src != NULL && !src->is_empty() ?
+                       src->is_flat() : sm->is_flat();
+        if (this->is_flat() == is_flat ||
+            fseg_num() != 0 || segs.get_elem_count() != 0) {
+            return;
+        }
+        if (is_flat) {
+            segs.set_fvec(sm->alloc_fvec(0));
+            return;
+        }
+        fseg_free(sm);
+    }
 public:
     SBitSetCore() {}
     COPY_CONSTRUCTOR(SBitSetCore);
@@ -256,7 +581,18 @@ public:
               SMemPool * pool)
     {
         ASSERT(this != &src, ("operate on same set"));
+        SBS_TRACE((g_sbs_trace, "C %p %p\n", this, &src));
         clean(sm, free_list);
+        FSEGVec<BitsPerSeg> const* sv = src.segs.get_fvec();
+        if (sv != NULL) {
+            if (sv->num == 0) { return; }
+            fseg_reserve(sv->num, sm);
+            FSEGVec<BitsPerSeg> * v = segs.get_fvec();
+            ::memcpy(v->get_fsegs(), sv->get_fsegs(),
+                     sizeof(FSEG<BitsPerSeg>) * sv->num);
+            v->num = sv->num;
+            return;
+        }
         for (TSEGIter * st = src.segs.get_head();
              st != src.segs.end(); st = src.segs.get_next(st)) {
             SEG<BitsPerSeg> * s = st->val();
@@ -303,6 +639,7 @@ public:
     bool is_contain(UINT elem) const;
     bool is_intersect(SBitSetCore<BitsPerSeg> const& src) const;
     bool is_empty() const;
+    bool is_flat() const { return segs.get_fvec() != NULL; }
 };
 
 
@@ -355,6 +692,7 @@ public:
 
             m_sm->free(s);
         }
+        SBitSetCore<BitsPerSeg>::fseg_free(m_sm);
 
         //Unnecessary call clean(), since free pool will free all
         //SEGIter object.
@@ -613,6 +951,10 @@ public:
     INT get_first(TSEGIter ** cur) const
     {
         ASSERT0(cur);
+        if (SBitSetCore<BitsPerSeg>::is_flat()) {
+            ASSERT0(m_is_sparse);
+            return SBitSetCore<BitsPerSeg>::get_first(cur);
+        }
 
         TSEGIter * sc = SBitSetCore<BitsPerSeg>::segs.get_head();
         if (sc == SBitSetCore<BitsPerSeg>::segs.end()) {
@@ -633,6 +975,11 @@ public:
     //*cur will be set to NULL if set is empty.
     INT get_last(TSEGIter ** cur) const
     {
+        if (SBitSetCore<BitsPerSeg>::is_flat()) {
+            ASSERT0(m_is_sparse);
+            return SBitSetCore<BitsPerSeg>::get_last(cur);
+        }
+
         TSEGIter * sc = SBitSetCore<BitsPerSeg>::segs.get_tail();
         if (sc == SBitSetCore<BitsPerSeg>::segs.end()) {
             ASSERT0(SBitSetCore<BitsPerSeg>::segs.get_elem_count() == 0);
@@ -651,7 +998,13 @@ public:
         return s->get_start() + s->bs.get_last();
     }
 
-    void set_sparse(bool is_sparse) { m_is_sparse = (UINT)is_sparse; }
+    //Note dense bitset always uses the list representation.
+    void set_sparse(bool is_sparse)
+    {
+        ASSERT(is_sparse || !SBitSetCore<BitsPerSeg>::is_flat(),
+               ("can not change the type of flat set"));
+        m_is_sparse = (UINT)is_sparse;
+    }
 };
 
 
@@ -701,6 +1054,7 @@ public:
 
             m_sm->free(s);
         }
+        SBitSetCore<BitsPerSeg>::fseg_free(m_sm);
 
         //Unnecessary call clean(), since free pool will free all
         //SEGIter object.
@@ -930,6 +1284,11 @@ public:
     }
 
     SegMgr<BitsPerSeg> * getSegMgr() { return &sm; }
+
+    //Set to true to make sparse bitsets allocated by current manager use
+    //flat segment array.
+    void set_flat(bool is_flat) { sm.set_flat(is_flat); }
+    bool is_flat() const { return sm.is_flat(); }
 };
 //END MiscBitSetMgr
 
@@ -1003,12 +1003,20 @@ DGraph::DGraph(UINT edge_hash_size, UINT vex_hash_size) :
     Graph(edge_hash_size, vex_hash_size)
 {
     m_bs_mgr = NULL;
+    m_is_dom_tree = false;
+    m_is_pdom_tree = false;
+    m_is_dom_order_dirty = false;
+    m_is_pdom_order_dirty = false;
 }
 
 
 DGraph::DGraph(DGraph const& g) : Graph(g)
 {
     m_bs_mgr = g.m_bs_mgr;
+    m_is_dom_tree = false;
+    m_is_pdom_tree = false;
+    m_is_dom_order_dirty = false;
+    m_is_pdom_order_dirty = false;
     if (m_bs_mgr != NULL) {
         cloneDomAndPdom(g);
     }
@@ -1037,6 +1045,16 @@ bool DGraph::cloneDomAndPdom(DGraph const& src)
     } //end for each vertices
     m_idom_set.copy(src.m_idom_set);
     m_ipdom_set.copy(src.m_ipdom_set);
+    m_dom_pre.copy(src.m_dom_pre);
+    m_dom_post.copy(src.m_dom_post);
+    m_pdom_pre.copy(src.m_pdom_pre);
+    m_pdom_post.copy(src.m_pdom_post);
+    m_dom_built.copy(src.m_dom_built);
+    m_pdom_built.copy(src.m_pdom_built);
+    m_is_dom_tree = src.m_is_dom_tree;
+    m_is_pdom_tree = src.m_is_pdom_tree;
+    m_is_dom_order_dirty = src.m_is_dom_order_dirty;
+    m_is_pdom_order_dirty = src.m_is_pdom_order_dirty;
     return true;
 }
 
@@ -1048,6 +1066,12 @@ size_t DGraph::count_mem() const
     count += m_pdom_set.count_mem(); //record post-dominator-set of each vertex.
     count += m_idom_set.count_mem(); //immediate dominator.
     count += m_ipdom_set.count_mem(); //immediate post dominator.
+    count += m_dom_pre.count_mem();
+    count += m_dom_post.count_mem();
+    count += m_pdom_pre.count_mem();
+    count += m_pdom_post.count_mem();
+    count += m_dom_built.count_mem();
+    count += m_pdom_built.count_mem();
     count += sizeof(m_bs_mgr); //Do NOT count up the bitset in BS_MGR.
     return count;
 }
@@ -1060,6 +1084,7 @@ size_t DGraph::count_mem() const
 //'uni': universe.
 bool DGraph::computeDom(List<Vertex const*> const* vlst, BitSet const* uni)
 {
+    m_is_dom_tree = false;
     List<Vertex const*> tmpvlst;
     List<Vertex const*> * pvlst = &tmpvlst;
     if (vlst != NULL) {
@@ -1157,6 +1182,7 @@ bool DGraph::computeDom(List<Vertex const*> const* vlst, BitSet const* uni)
 bool DGraph::computeDom3(List<Vertex const*> const* vlst, BitSet const* uni)
 {
     UNUSED(uni);
+    m_is_dom_tree = false;
     List<Vertex const*> tmpvlst;
     List<Vertex const*> * pvlst = &tmpvlst;
     if (vlst != NULL) {
@@ -1283,6 +1309,7 @@ bool DGraph::computePdom(List<Vertex const*> const* vlst)
 bool DGraph::computePdom(List<Vertex const*> const* vlst, BitSet const* uni)
 {
     ASSERT0(vlst && uni);
+    m_is_pdom_tree = false;
 
     //Initialize pdom for each bb
     C<Vertex const*> * ct;
@@ -1382,6 +1409,7 @@ bool DGraph::computeIdom2(List<Vertex const*> const& vlst)
     bool change = true;
 
     //Initialize idom-set for each BB.
+    m_is_dom_tree = false;
     m_idom_set.clean();
     UINT nentry = 0;
     while (change) {
@@ -1478,6 +1506,7 @@ bool DGraph::computeIdom2(List<Vertex const*> const& vlst)
 bool DGraph::computeIdom()
 {
     //Initialize idom-set for each BB.
+    m_is_dom_tree = false;
     m_idom_set.clean();
 
     //Access with topological order.
@@ -1538,6 +1567,7 @@ bool DGraph::computeIdom()
 bool DGraph::computeIpdom()
 {
     //Initialize ipdom-set for each BB.
+    m_is_pdom_tree = false;
     m_ipdom_set.clean();
 
     //Processing in reverse-topological order.
@@ -1573,6 +1603,489 @@ bool DGraph::computeIpdom()
 }
 
 
+//Find the vertex that has minimal semi-dominator on the path from 'v'
+//to the root of the tree in forest, and compress the path.
+//All parameters are indexed by DFS number.
+static UINT lt_eval(UINT v,
+                    IN OUT Vector<UINT> & ancestor,
+                    IN OUT Vector<UINT> & label,
+                    Vector<UINT> const& semi,
+                    IN OUT Vector<UINT> & path)
+{
+    if (ancestor.get(v) == 0) { return v; }
+
+    //Collect the path until the vertex whose ancestor is the root.
+    UINT num = 0;
+    for (UINT x = v; ancestor.get(ancestor.get(x)) != 0;
+         x = ancestor.get(x)) {
+        path.set(num, x);
+        num++;
+    }
+
+    //Compress the path from the vertex nearest to the root.
+    while (num > 0) {
+        num--;
+        UINT x = path.get(num);
+        UINT a = ancestor.get(x);
+        if (semi.get(label.get(a)) < semi.get(label.get(x))) {
+            label.set(x, label.get(a));
+        }
+        ancestor.set(x, ancestor.get(a));
+    }
+    return label.get(v);
+}
+
+
+//Compute immediate dominator by Lengauer-Tarjan algorithm with path
+//compression, the complexity is O(E*log(V)).
+//'is_pdom': true to compute immediate post-dominator on reverse graph.
+//'idom': record the immediate dominator of each vertex.
+//NOTE:
+//    1. A virtual root is assumed to be the parent of all entries, or
+//       exits if 'is_pdom' is true, so the immediate dominator of the
+//       vertex is 0 if the vertex is dominated by the virtual root only.
+//    2. Vertex that can not be reached from entries does not have idom.
+void DGraph::computeIdomByLT(bool is_pdom, OUT Vector<INT> & idom)
+{
+    idom.clean();
+
+    //The DFS number starts at 1, and the virtual root is numbered 1.
+    //'dfn' is indexed by vertex id, the others are indexed by DFS number.
+    Vector<UINT> dfn;
+    Vector<UINT> vex; //map DFS number to vertex id.
+    Vector<UINT> parent;
+    Vector<EdgeC*> cursor;
+    Vector<UINT> stk;
+    UINT n = 1;
+    INT c;
+    for (Vertex * r = get_first_vertex(c); r != NULL; r = get_next_vertex(c)) {
+        if ((is_pdom && !is_graph_exit(r)) ||
+            (!is_pdom && !is_graph_entry(r))) {
+            continue;
+        }
+
+        n++;
+        dfn.set(VERTEX_id(r), n);
+        vex.set(n, VERTEX_id(r));
+        parent.set(n, 1);
+        cursor.set(n, is_pdom ? VERTEX_in_list(r) : VERTEX_out_list(r));
+        UINT top = 0;
+        stk.set(top, n);
+        top++;
+        while (top > 0) {
+            UINT x = stk.get(top - 1);
+            EdgeC * ec = cursor.get(x);
+            if (ec == NULL) {
+                top--;
+                continue;
+            }
+            cursor.set(x, EC_next(ec));
+
+            Vertex * s = is_pdom ? EDGE_from(EC_edge(ec)) :
+                                   EDGE_to(EC_edge(ec));
+            if (dfn.get(VERTEX_id(s)) != 0) { continue; }
+
+            n++;
+            dfn.set(VERTEX_id(s), n);
+            vex.set(n, VERTEX_id(s));
+            parent.set(n, x);
+            cursor.set(n, is_pdom ? VERTEX_in_list(s) : VERTEX_out_list(s));
+            stk.set(top, n);
+            top++;
+        }
+    }
+
+    Vector<UINT> semi;
+    Vector<UINT> label;
+    Vector<UINT> ancestor;
+    Vector<UINT> dom;
+    Vector<UINT> bucket; //head of bucket of each vertex.
+    Vector<UINT> bucket_next;
+    semi.grow(n + 1);
+    label.grow(n + 1);
+    ancestor.grow(n + 1);
+    dom.grow(n + 1);
+    bucket.grow(n + 1);
+    bucket_next.grow(n + 1);
+    for (UINT i = 1; i <= n; i++) {
+        semi.set(i, i);
+        label.set(i, i);
+    }
+
+    for (UINT w = n; w >= 2; w--) {
+        //Virtual root is the predecessor of entries.
+        if (parent.get(w) == 1) { semi.set(w, 1); }
+
+        Vertex const* wv = get_vertex(vex.get(w));
+        ASSERT0(wv);
+        for (EdgeC const* ec = is_pdom ? VERTEX_out_list(wv) :
+                                         VERTEX_in_list(wv);
+             ec != NULL; ec = EC_next(ec)) {
+            Vertex const* p = is_pdom ? EDGE_to(EC_edge(ec)) :
+                                        EDGE_from(EC_edge(ec));
+            UINT v = dfn.get(VERTEX_id(p));
+            if (v == 0) {
+                //Predecessor is unreachable.
+                continue;
+            }
+            UINT u = lt_eval(v, ancestor, label, semi, stk);
+            if (semi.get(u) < semi.get(w)) {
+                semi.set(w, semi.get(u));
+            }
+        }
+        bucket_next.set(w, bucket.get(semi.get(w)));
+        bucket.set(semi.get(w), w);
+
+        //Link w to its parent in the forest.
+        UINT p = parent.get(w);
+        ancestor.set(w, p);
+
+        for (UINT v = bucket.get(p); v != 0; v = bucket_next.get(v)) {
+            UINT u = lt_eval(v, ancestor, label, semi, stk);
+            dom.set(v, semi.get(u) < semi.get(v) ? u : p);
+        }
+        bucket.set(p, 0);
+    }
+
+    for (UINT w = 2; w <= n; w++) {
+        if (dom.get(w) != semi.get(w)) {
+            dom.set(w, dom.get(dom.get(w)));
+        }
+        if (dom.get(w) != 1) {
+            idom.set(vex.get(w), (INT)vex.get(dom.get(w)));
+        }
+    }
+}
+
+
+//Number vertices in preorder and postorder of the DFS of tree.
+//'idom': the parent of each vertex in tree, 0 if vertex is root.
+//NOTE: The number starts at 1, and each vertex of graph is numbered.
+void DGraph::computeTreeOrder(Vector<INT> const& idom,
+                              OUT Vector<UINT> & pre,
+                              OUT Vector<UINT> & post)
+{
+    pre.clean();
+    post.clean();
+
+    //Record kids of each vertex in linked list.
+    Vector<UINT> kid;
+    Vector<UINT> sibling;
+    INT c;
+    for (Vertex const* v = get_first_vertex(c);
+         v != NULL; v = get_next_vertex(c)) {
+        UINT p = (UINT)idom.get(VERTEX_id(v));
+        if (p != 0) {
+            sibling.set(VERTEX_id(v), kid.get(p));
+            kid.set(p, VERTEX_id(v));
+        }
+    }
+
+    UINT order = 1;
+    Vector<UINT> stk;
+    for (Vertex const* r = get_first_vertex(c);
+         r != NULL; r = get_next_vertex(c)) {
+        if (idom.get(VERTEX_id(r)) != 0) { continue; }
+
+        UINT top = 0;
+        stk.set(top, VERTEX_id(r));
+        top++;
+        pre.set(VERTEX_id(r), order);
+        order++;
+        while (top > 0) {
+            UINT x = stk.get(top - 1);
+            UINT k = kid.get(x);
+            if (k == 0) {
+                post.set(x, order);
+                order++;
+                top--;
+                continue;
+            }
+
+            //Unlink the kid to visit it only once.
+            kid.set(x, sibling.get(k));
+            pre.set(k, order);
+            order++;
+            stk.set(top, k);
+            top++;
+        }
+    }
+}
+
+
+//Free the buffer of bitset, the bitset itself is kept for reuse.
+void DGraph::releaseSet(Vector<BitSet*> & set_vec)
+{
+    for (INT i = 0; i <= set_vec.get_last_idx(); i++) {
+        BitSet * set = set_vec.get(i);
+        if (set != NULL) {
+            set->destroy();
+        }
+    }
+}
+
+
+//Compute immediate dominator by Lengauer-Tarjan algorithm, and
+//represent dominator by the tree. Dominator set is not computed until
+//someone asks for it via get_dom_set().
+//NOTE: Entry does not have idom.
+bool DGraph::computeDomTree()
+{
+    computeIdomByLT(false, m_idom_set);
+    computeTreeOrder(m_idom_set, m_dom_pre, m_dom_post);
+    releaseSet(m_dom_set);
+    m_dom_built.clean();
+    m_is_dom_tree = true;
+    m_is_dom_order_dirty = false;
+    return true;
+}
+
+
+//Compute immediate post-dominator by Lengauer-Tarjan algorithm, and
+//represent post-dominator by the tree. Post-dominator set is not
+//computed until someone asks for it via get_pdom_set().
+//NOTE: Exit does not have ipdom.
+bool DGraph::computePdomTree()
+{
+    computeIdomByLT(true, m_ipdom_set);
+    computeTreeOrder(m_ipdom_set, m_pdom_pre, m_pdom_post);
+    releaseSet(m_pdom_set);
+    m_pdom_built.clean();
+    m_is_pdom_tree = true;
+    m_is_pdom_order_dirty = false;
+    return true;
+}
+
+
+//Recompute the DFS interval of dominator tree and post-dominator tree
+//if they have been updated incrementally.
+void DGraph::computeDomTreeOrder()
+{
+    if (m_is_dom_tree && m_is_dom_order_dirty) {
+        computeTreeOrder(m_idom_set, m_dom_pre, m_dom_post);
+        m_is_dom_order_dirty = false;
+    }
+    if (m_is_pdom_tree && m_is_pdom_order_dirty) {
+        computeTreeOrder(m_ipdom_set, m_pdom_pre, m_pdom_post);
+        m_is_pdom_order_dirty = false;
+    }
+}
+
+
+//Return the nearest common ancestor of 'v1' and 'v2' in the tree,
+//or 0 if the ancestor is the virtual root.
+//'idom': the parent of each vertex in tree.
+UINT DGraph::findNCA(UINT v1, UINT v2, Vector<INT> const& idom) const
+{
+    BitSet path;
+    for (UINT i = v1; i != 0; i = (UINT)idom.get(i)) {
+        path.bunion(i);
+    }
+    for (UINT i = v2; i != 0; i = (UINT)idom.get(i)) {
+        if (path.is_contain(i)) { return i; }
+    }
+    return 0;
+}
+
+
+//Return true if vertex 'id' is the root of tree, but it is neither
+//entry nor exit. The vertex is unreachable, or it is only dominated by
+//the virtual root which joins multiple entries (exits).
+bool DGraph::is_unreach_root(UINT id, Vector<INT> const& idom, bool is_pdom)
+{
+    if (idom.get(id) != 0) { return false; }
+    Vertex const* v = get_vertex(id);
+    ASSERT0(v);
+    return is_pdom ? !is_graph_exit(v) : !is_graph_entry(v);
+}
+
+
+//Update dominator tree after vertex 'newv' has been inserted before
+//'succ', e.g: split edge or insert preheader of loop.
+//'succ' is the unique successor of 'newv', and the predecessors of
+//'newv' were the predecessors of 'succ'.
+bool DGraph::insertVertexToDomTree(UINT newv, UINT succ)
+{
+    if (!m_is_dom_tree) { return false; }
+    Vertex const* nv = get_vertex(newv);
+    Vertex const* sv = get_vertex(succ);
+    ASSERT0(nv && sv && get_edge(newv, succ) != NULL);
+    if (VERTEX_in_list(nv) == NULL ||
+        is_unreach_root(succ, m_idom_set, false)) {
+        return false;
+    }
+
+    //The nearest common dominator of predecessors dominates 'newv'.
+    UINT idom = 0;
+    for (EdgeC const* ec = VERTEX_in_list(nv); ec != NULL; ec = EC_next(ec)) {
+        UINT p = VERTEX_id(EDGE_from(EC_edge(ec)));
+        if (is_unreach_root(p, m_idom_set, false)) { return false; }
+        idom = ec == VERTEX_in_list(nv) ? p : findNCA(idom, p, m_idom_set);
+    }
+
+    //'newv' dominates 'succ' if the other predecessors of 'succ' are
+    //dominated by 'succ', namely, they are the sources of back edges.
+    bool dom_succ = true;
+    for (EdgeC const* ec = VERTEX_in_list(sv); ec != NULL; ec = EC_next(ec)) {
+        UINT p = VERTEX_id(EDGE_from(EC_edge(ec)));
+        if (p == newv || p == succ) { continue; }
+        if (is_unreach_root(p, m_idom_set, false)) { return false; }
+        if (!is_dom(succ, p)) {
+            dom_succ = false;
+            break;
+        }
+    }
+
+    m_idom_set.set(newv, (INT)idom);
+    if (dom_succ) {
+        m_idom_set.set(succ, (INT)newv);
+    }
+    m_dom_built.clean();
+    m_is_dom_order_dirty = true;
+    return true;
+}
+
+
+//Update post-dominator tree after vertex 'newv' has been inserted
+//before 'succ', see insertVertexToDomTree().
+//The tree is only updated if 'newv' has an unique predecessor whose
+//unique successor is 'newv'. Otherwise, 'newv' may post dominate
+//vertices other than its predecessors, e.g: the vertex that branches
+//to two predecessors of 'newv', or the predecessor that is in a loop
+//which only exits via 'newv', these have to be found by recomputing.
+bool DGraph::insertVertexToPdomTree(UINT newv, UINT succ)
+{
+    if (!m_is_pdom_tree) { return false; }
+    Vertex const* nv = get_vertex(newv);
+    ASSERT0(nv && get_edge(newv, succ) != NULL);
+    if (is_unreach_root(succ, m_ipdom_set, true)) { return false; }
+
+    EdgeC const* ec = VERTEX_in_list(nv);
+    if (ec == NULL || EC_next(ec) != NULL) { return false; }
+    Vertex const* p = EDGE_from(EC_edge(ec));
+    if (EC_next(VERTEX_out_list(p)) != NULL) { return false; }
+    ASSERT0((UINT)m_ipdom_set.get(VERTEX_id(p)) == succ);
+
+    //Vertices post dominated by 'succ' via 'p' are post dominated by
+    //'p' as well, thus only 'p' is post dominated by 'newv'.
+    m_ipdom_set.set(newv, (INT)succ);
+    m_ipdom_set.set(VERTEX_id(p), (INT)newv);
+    m_pdom_built.clean();
+    m_is_pdom_order_dirty = true;
+    return true;
+}
+
+
+//Update dominator tree after vertex 'v' has been removed, where 'succ'
+//is the unique successor of 'v', and the predecessors of 'v' have been
+//connected to 'succ', e.g: remove empty BB.
+bool DGraph::removeVertexFromDomTree(UINT v, UINT succ)
+{
+    if (!m_is_dom_tree) { return false; }
+    ASSERT0(get_vertex(v) == NULL && v != succ);
+
+    //'succ' is the only vertex that might be dominated by 'v'
+    //immediately.
+    if ((UINT)m_idom_set.get(succ) == v) {
+        m_idom_set.set(succ, m_idom_set.get(v));
+    }
+    m_idom_set.set(v, 0);
+    m_dom_built.clean();
+    m_is_dom_order_dirty = true;
+    return true;
+}
+
+
+//Update post-dominator tree after vertex 'v' has been removed, see
+//removeVertexFromDomTree().
+bool DGraph::removeVertexFromPdomTree(UINT v, UINT succ)
+{
+    if (!m_is_pdom_tree) { return false; }
+    ASSERT0(get_vertex(v) == NULL && v != succ);
+    if ((UINT)m_ipdom_set.get(v) != succ) {
+        //'v' does not reach exit.
+        return false;
+    }
+
+    //The kids of 'v' are post dominated by 'succ' immediately.
+    INT c;
+    for (Vertex const* x = get_first_vertex(c);
+         x != NULL; x = get_next_vertex(c)) {
+        if ((UINT)m_ipdom_set.get(VERTEX_id(x)) == v) {
+            m_ipdom_set.set(VERTEX_id(x), (INT)succ);
+        }
+    }
+    m_ipdom_set.set(v, 0);
+    m_pdom_built.clean();
+    m_is_pdom_order_dirty = true;
+    return true;
+}
+
+
+//Verify the dominator tree and post-dominator tree by recomputing them.
+bool DGraph::verifyDomTree(bool verify_dom, bool verify_pdom)
+{
+    Vector<INT> idom;
+    INT c;
+    if (verify_dom && m_is_dom_tree) {
+        computeIdomByLT(false, idom);
+        for (Vertex const* v = get_first_vertex(c);
+             v != NULL; v = get_next_vertex(c)) {
+            UINT id = VERTEX_id(v);
+            UNUSED(id);
+            ASSERT(idom.get(id) == m_idom_set.get(id),
+                   ("idom of V%d should be V%d", id, idom.get(id)));
+        }
+    }
+    if (verify_pdom && m_is_pdom_tree) {
+        computeIdomByLT(true, idom);
+        for (Vertex const* v = get_first_vertex(c);
+             v != NULL; v = get_next_vertex(c)) {
+            UINT id = VERTEX_id(v);
+            UNUSED(id);
+            ASSERT(idom.get(id) == m_ipdom_set.get(id),
+                   ("ipdom of V%d should be V%d", id, idom.get(id)));
+        }
+    }
+    return true;
+}
+
+
+//Build the dominator set of vertex 'id' by walking through the
+//dominator tree, the set does NOT include 'id' itself.
+void DGraph::buildDomSet(UINT id, OUT BitSet * set)
+{
+    ASSERT0(m_is_dom_tree && set);
+    set->clean();
+    for (UINT i = get_idom(id); i != 0; i = get_idom(i)) {
+        set->bunion(i);
+        if (m_dom_built.is_contain(i)) {
+            set->bunion(*m_dom_set.get(i));
+            break;
+        }
+    }
+    m_dom_built.bunion(id);
+}
+
+
+//Build the post-dominator set of vertex 'id' by walking through the
+//post-dominator tree, the set includes 'id' itself.
+void DGraph::buildPdomSet(UINT id, OUT BitSet * set)
+{
+    ASSERT0(m_is_pdom_tree && set);
+    set->clean();
+    set->bunion(id);
+    for (UINT i = get_ipdom(id); i != 0; i = get_ipdom(i)) {
+        if (m_pdom_built.is_contain(i)) {
+            set->bunion(*m_pdom_set.get(i));
+            break;
+        }
+        set->bunion(i);
+    }
+    m_pdom_built.bunion(id);
+}
+
+
 //'dom': output dominator tree.
 void DGraph::get_dom_tree(OUT Graph & dom)
 {
@@ -1616,8 +2129,14 @@ void DGraph::dump_dom(FILE * h, bool dump_dom_tree)
         UINT vid = VERTEX_id(v);
         fprintf(h, "\nVERTEX(%d) dom: ", vid);
 
+        //Dominator set may not be built in tree mode, walk up the
+        //tree instead.
         BitSet * bs;
-        if ((bs = m_dom_set.get(vid)) != NULL) {
+        if (m_is_dom_tree) {
+            for (UINT i = get_idom(vid); i != 0; i = get_idom(i)) {
+                fprintf(h, "%d ", i);
+            }
+        } else if ((bs = m_dom_set.get(vid)) != NULL) {
             for (INT id = bs->get_first();
                  id != -1 ; id = bs->get_next((UINT)id)) {
                 if ((UINT)id != vid) {
@@ -1628,7 +2147,11 @@ void DGraph::dump_dom(FILE * h, bool dump_dom_tree)
 
         fprintf(h, "\n     pdom: ");
 
-        if ((bs = m_pdom_set.get(vid)) != NULL) {
+        if (m_is_pdom_tree) {
+            for (UINT i = get_ipdom(vid); i != 0; i = get_ipdom(i)) {
+                fprintf(h, "%d ", i);
+            }
+        } else if ((bs = m_pdom_set.get(vid)) != NULL) {
             for (INT id = bs->get_first();
                  id != -1; id = bs->get_next((UINT)id)) {
                 if ((UINT)id != vid) {
@@ -141,22 +141,22 @@ public:
 };
 
 
-class EdgeHash : public Hash<Edge*, EdgeHashFunc> {
+class EdgeHash : public FlatHash<Edge*, EdgeHashFunc> {
     Graph * m_g;
 public:
-    EdgeHash(UINT bsize = 64) : Hash<Edge*, EdgeHashFunc>(bsize) {}
+    EdgeHash(UINT bsize = 64) : FlatHash<Edge*, EdgeHashFunc>(bsize) {}
     virtual ~EdgeHash() {}
 
     void init(Graph * g, UINT bsize)
     {
         m_g = g;
-        Hash<Edge*, EdgeHashFunc>::init(bsize);
+        FlatHash<Edge*, EdgeHashFunc>::init(bsize);
     }
 
     void destroy()
     {
         m_g = NULL;
-        Hash<Edge*, EdgeHashFunc>::destroy();
+        FlatHash<Edge*, EdgeHashFunc>::destroy();
     }
 
     virtual Edge * create(OBJTY v);
@@ -185,11 +185,11 @@ public:
 };
 
 
-class VertexHash : public Hash<Vertex*, VertexHashFunc> {
+class VertexHash : public FlatHash<Vertex*, VertexHashFunc> {
 protected:
     SMemPool * m_ec_pool;
 public:
-    VertexHash(UINT bsize = 64) : Hash<Vertex*, VertexHashFunc>(bsize)
+    VertexHash(UINT bsize = 64) : FlatHash<Vertex*, VertexHashFunc>(bsize)
     { m_ec_pool = smpoolCreate(sizeof(Vertex) * 4, MEM_CONST_SIZE); }
     COPY_CONSTRUCTOR(VertexHash);
     virtual ~VertexHash() { smpoolDelete(m_ec_pool); }
@@ -517,8 +517,41 @@ protected:
     Vector<BitSet*> m_pdom_set; //record post-dominator-set of each vertex.
     Vector<INT> m_idom_set; //immediate dominator.
     Vector<INT> m_ipdom_set; //immediate post dominator.
+
+    //Record the preorder and postorder number of vertex in the DFS of
+    //dominator tree and post-dominator tree. 'v1' dominates 'v2' if the
+    //interval [pre, post] of 'v1' covers the interval of 'v2'.
+    Vector<UINT> m_dom_pre;
+    Vector<UINT> m_dom_post;
+    Vector<UINT> m_pdom_pre;
+    Vector<UINT> m_pdom_post;
+
+    //Record the vertices whose dominator (post-dominator) set has been
+    //built from the tree.
+    BitSet m_dom_built;
+    BitSet m_pdom_built;
     BitSetMgr * m_bs_mgr;
+
+    //Set to true if dominator (post-dominator) is represented by the
+    //tree, the set of dominators is built only if someone asks for it.
+    BYTE m_is_dom_tree:1;
+    BYTE m_is_pdom_tree:1;
+
+    //Set to true if the tree has been updated incrementally, and the
+    //DFS interval has to be recomputed by computeDomTreeOrder().
+    BYTE m_is_dom_order_dirty:1;
+    BYTE m_is_pdom_order_dirty:1;
+
     void _removeUnreachNode(UINT id, BitSet & visited);
+    void buildDomSet(UINT id, OUT BitSet * set);
+    void buildPdomSet(UINT id, OUT BitSet * set);
+    void computeIdomByLT(bool is_pdom, OUT Vector<INT> & idom);
+    void computeTreeOrder(Vector<INT> const& idom,
+                          OUT Vector<UINT> & pre,
+                          OUT Vector<UINT> & post);
+    UINT findNCA(UINT v1, UINT v2, Vector<INT> const& idom) const;
+    bool is_unreach_root(UINT id, Vector<INT> const& idom, bool is_pdom);
+    void releaseSet(Vector<BitSet*> & set_vec);
 public:
     DGraph(UINT edge_hash_size = 64, UINT vex_hash_size = 64);
     DGraph(DGraph const& g);
@@ -540,6 +573,9 @@ public:
     bool computeIdom();
     bool computeIdom2(List<Vertex const*> const& vlst);
     bool computeIpdom();
+    bool computeDomTree();
+    bool computePdomTree();
+    void computeDomTreeOrder();
     size_t count_mem() const;
 
     void dump_dom(FILE * h, bool dump_dom_tree = true);
@@ -569,6 +605,9 @@ public:
             set = m_bs_mgr->create();
             m_dom_set.set(id, set);
         }
+        if (m_is_dom_tree && !m_dom_built.is_contain(id)) {
+            buildDomSet(id, set);
+        }
         return set;
     }
 
@@ -592,6 +631,9 @@ public:
             set = m_bs_mgr->create();
             m_pdom_set.set(id, set);
         }
+        if (m_is_pdom_tree && !m_pdom_built.is_contain(id)) {
+            buildPdomSet(id, set);
+        }
         return set;
     }
 
@@ -604,19 +646,59 @@ public:
     }
 
     //Return true if 'v1' dominate 'v2'.
+    //NOTE: If dominator is represented by tree, the query is answered
+    //in O(1) by the DFS interval, and 'v' does NOT dominate itself just
+    //like the set built from tree.
     bool is_dom(UINT v1, UINT v2) const
     {
+        if (m_is_dom_tree && m_is_dom_order_dirty) {
+            //Walk up the tree until the interval is recomputed.
+            for (UINT i = (UINT)m_idom_set.get(v2);
+                 i != 0; i = (UINT)m_idom_set.get(i)) {
+                if (i == v1) { return true; }
+            }
+            return false;
+        }
+        if (m_is_dom_tree) {
+            return v1 != v2 && m_dom_pre.get(v2) != 0 &&
+                   m_dom_pre.get(v1) <= m_dom_pre.get(v2) &&
+                   m_dom_post.get(v2) <= m_dom_post.get(v1);
+        }
         ASSERT0(read_dom_set(v2));
         return read_dom_set(v2)->is_contain(v1);
     }
 
     //Return true if 'v1' post dominate 'v2'.
+    //NOTE: If post-dominator is represented by tree, the query is
+    //answered in O(1) by the DFS interval, and 'v' post dominates itself
+    //just like the set built by computePdom().
     bool is_pdom(UINT v1, UINT v2) const
     {
+        if (m_is_pdom_tree && m_is_pdom_order_dirty) {
+            for (UINT i = v2; i != 0; i = (UINT)m_ipdom_set.get(i)) {
+                if (i == v1) { return true; }
+            }
+            return false;
+        }
+        if (m_is_pdom_tree) {
+            return m_pdom_pre.get(v2) != 0 &&
+                   m_pdom_pre.get(v1) <= m_pdom_pre.get(v2) &&
+                   m_pdom_post.get(v2) <= m_pdom_post.get(v1);
+        }
         ASSERT0(read_pdom_set(v2));
         return read_pdom_set(v2)->is_contain(v1);
     }
 
+    //Update dominator tree incrementally.
+    //The functions return false if the tree can not be updated locally,
+    //and it has to be recomputed.
+    //After the update, the DFS interval is recomputed lazily, and the
+    //query walks up the tree before that.
+    bool insertVertexToDomTree(UINT newv, UINT succ);
+    bool insertVertexToPdomTree(UINT newv, UINT succ);
+    bool removeVertexFromDomTree(UINT v, UINT succ);
+    bool removeVertexFromPdomTree(UINT v, UINT succ);
+
     void sortInBfsOrder(Vector<UINT> & order_buf,
                         Vertex * root,
                         BitSet & visit);
@@ -624,6 +706,7 @@ public:
     void sortDomTreeInPostrder(IN Vertex * root, OUT List<Vertex*> & lst);
     void set_bs_mgr(BitSetMgr * bs_mgr) { m_bs_mgr = bs_mgr; }
     bool removeUnreachNode(UINT entry_id);
+    bool verifyDomTree(bool verify_dom, bool verify_pdom);
 };
 
 } //namespace xcom
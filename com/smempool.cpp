@@ -58,7 +58,7 @@ static MEMPOOL_HASH * g_mem_pool_hash_tab = NULL;
 static SMemPool * g_mem_pool=NULL;
 static UINT g_mem_pool_count = 0;
 #ifdef _DEBUG_
-static UINT g_mem_pool_chunk_count = 0;
+static THREAD_LOCAL UINT g_mem_pool_chunk_count = 0;
 #endif
 
 
@@ -67,7 +67,9 @@ static bool g_is_pool_init = false;
 
 //Build hash table of memory pool
 static bool g_is_pool_hashed = true;
-ULONGLONG g_stat_mem_size = 0;
+
+//Statistic of the memory size allocated by current thread.
+THREAD_LOCAL ULONGLONG g_stat_mem_size = 0;
 
 
 void dumpPool(SMemPool * handler, FILE * h)
@@ -114,6 +116,46 @@ static SMemPool * new_mem_pool(size_t size, MEMPOOLTYPE mpt)
 }
 
 
+//Allocate a chunk of arena, the start address of pool is aligned
+//to 'align'. The arena information is placed behind the header of
+//the first chunk.
+static SMemPool * new_arena_chunk(size_t size,
+                                  MEMPOOLTYPE mpt,
+                                  size_t align,
+                                  bool is_first)
+{
+    size_t size_mp = sizeof(SMemPool);
+    if (is_first) {
+        size_mp += sizeof(SMemArena);
+    }
+
+    //Reserve additional space to align the pool.
+    SMemPool * mp = (SMemPool*)malloc(size_mp + align - 1 +
+                                      size + END_BOUND_BYTE);
+    ASSERT(mp, ("create mem pool failed, no enough memory"));
+    memset(mp, 0, size_mp);
+    size_t start = ((size_t)mp + size_mp + align - 1) & ~(align - 1);
+    memset(((CHAR*)start) + size, BOUNDARY_NUM, END_BOUND_BYTE);
+
+    MEMPOOL_type(mp) = mpt;
+    #ifdef _DEBUG_
+    g_stat_mem_size += size_mp + align - 1 + size;
+    MEMPOOL_chunk_id(mp) = ++g_mem_pool_chunk_count;
+    #endif
+    MEMPOOL_pool_ptr(mp) = (void*)start;
+    MEMPOOL_pool_size(mp) = size;
+    MEMPOOL_start_pos(mp) = 0;
+    MEMPOOL_grow_size(mp) = size;
+    if (is_first) {
+        SMemArena * arena = (SMemArena*)(mp + 1);
+        arena->cur = mp;
+        arena->align = align;
+        MEMPOOL_arena(mp) = arena;
+    }
+    return mp;
+}
+
+
 inline static void remove_smp(SMemPool * t)
 {
     if (t == NULL) return;
@@ -235,6 +277,21 @@ SMemPool * smpoolCreate(size_t size, MEMPOOLTYPE mpt)
 }
 
 
+//Create new mem pool in arena mode, return the pool handle.
+//'align': alignment of the address allocated, must be power of two.
+//    It will be adjusted to pointer size at least, because the freed
+//    memory is linked via its first word.
+//NOTICE: The pool should be manipulated via handler.
+SMemPool * smpoolCreateArena(size_t size, MEMPOOLTYPE mpt, size_t align)
+{
+    if (size == 0 || mpt == MEM_NONE) { return NULL; }
+    ASSERT(align != 0 && (align & (align - 1)) == 0,
+           ("alignment must be power of two"));
+    align = MAX(align, sizeof(void*));
+    return new_arena_chunk(size, mpt, align, true);
+}
+
+
 //Create new mem pool, return the pool idx.
 #define MAX_TRY 1024
 MEMPOOLIDX smpoolCreatePoolIndex(size_t size, MEMPOOLTYPE mpt)
@@ -349,11 +406,198 @@ INT smpoolDeleteViaPoolIndex(MEMPOOLIDX mpt_idx)
 }
 
 
+//Move to the next chunk which has enough space, or allocate a new
+//chunk if there is not.
+//The chunk size grows geometrically, but no more than
+//ARENA_MAX_GROW_SIZE unless the requested size is larger.
+static SMemPool * arena_grow(SMemPool * handler,
+                             size_t size,
+                             size_t grow_size)
+{
+    SMemArena * arena = MEMPOOL_arena(handler);
+    SMemPool * cur = arena->cur;
+
+    //The chunks after current chunk are released by smpoolReleaseTo().
+    SMemPool * next = MEMPOOL_next(cur);
+    if (next != NULL && MEMPOOL_pool_size(next) >= size) {
+        ASSERT0(MEMPOOL_start_pos(next) == 0);
+        arena->cur = next;
+        return next;
+    }
+
+    if (grow_size == 0) {
+        grow_size = MEMPOOL_grow_size(handler);
+        if (grow_size < ARENA_MAX_GROW_SIZE) {
+            grow_size = MIN(grow_size * 2, ARENA_MAX_GROW_SIZE);
+        }
+        MEMPOOL_grow_size(handler) = grow_size;
+    }
+    grow_size = MAX(grow_size, size);
+
+    //Insert new chunk after current chunk.
+    SMemPool * newchunk = new_arena_chunk(grow_size, MEMPOOL_type(handler),
+                                          arena->align, false);
+    MEMPOOL_prev(newchunk) = cur;
+    MEMPOOL_next(newchunk) = next;
+    if (next != NULL) {
+        MEMPOOL_prev(next) = newchunk;
+    }
+    MEMPOOL_next(cur) = newchunk;
+    arena->cur = newchunk;
+    return newchunk;
+}
+
+
+//Allocate memory from arena.
+//The memory is reused from free list of size class at first, otherwise
+//it is allocated by bumping pointer of current chunk.
+static void * arena_malloc(size_t size, SMemPool * handler, size_t grow_size)
+{
+    SMemArena * arena = MEMPOOL_arena(handler);
+    ASSERT0(arena);
+    arena->requested += size;
+
+    size_t const align = arena->align;
+    size = (size + align - 1) & ~(align - 1);
+
+    size_t cls = size / align - 1;
+    if (cls < ARENA_SIZE_CLASS_NUM && arena->free_list[cls] != NULL) {
+        void * addr = arena->free_list[cls];
+        arena->free_list[cls] = *(void**)addr;
+        return addr;
+    }
+
+    SMemPool * cur = arena->cur;
+    if (MEMPOOL_pool_size(cur) - MEMPOOL_start_pos(cur) < size) {
+        cur = arena_grow(handler, size, grow_size);
+    }
+
+    void * addr = ((BYTE*)MEMPOOL_pool_ptr(cur)) + MEMPOOL_start_pos(cur);
+    MEMPOOL_start_pos(cur) += size;
+    ASSERT0(MEMPOOL_pool_size(cur) >= MEMPOOL_start_pos(cur));
+    return addr;
+}
+
+
+//Return memory to the size-class free list of arena.
+//'size': the byte size when the memory allocated.
+//Note the function does nothing if pool is not arena or the size is
+//larger than the maximum size class.
+void smpoolFree(void * p, size_t size, IN SMemPool * handler)
+{
+    ASSERT(p && handler, ("need mempool handler"));
+    SMemArena * arena = MEMPOOL_arena(handler);
+    if (arena == NULL) { return; }
+
+    size_t const align = arena->align;
+    size_t cls = ((size + align - 1) & ~(align - 1)) / align - 1;
+    if (cls >= ARENA_SIZE_CLASS_NUM) { return; }
+
+    ASSERT0(arena->requested >= size);
+    arena->requested -= size;
+    *(void**)p = arena->free_list[cls];
+    arena->free_list[cls] = p;
+}
+
+
+//Record the allocation position of arena.
+SMemPoolMark smpoolMark(SMemPool const* handler)
+{
+    ASSERT(handler && MEMPOOL_arena(handler), ("need arena"));
+    SMemArena const* arena = MEMPOOL_arena(handler);
+    SMemPoolMark mark;
+    mark.chunk = arena->cur;
+    mark.pos = MEMPOOL_start_pos(arena->cur);
+    mark.requested = arena->requested;
+    return mark;
+}
+
+
+//Release the memory allocated after 'mark' in arena, the chunks are
+//kept for subsequent allocation.
+//Note the free lists are cleaned as well, because they might hold
+//memory allocated after 'mark'.
+void smpoolReleaseTo(IN SMemPool * handler, SMemPoolMark const& mark)
+{
+    ASSERT(handler && MEMPOOL_arena(handler), ("need arena"));
+    ASSERT0(mark.chunk);
+    SMemArena * arena = MEMPOOL_arena(handler);
+    for (SMemPool * p = MEMPOOL_next(mark.chunk); p != NULL;
+         p = MEMPOOL_next(p)) {
+        MEMPOOL_start_pos(p) = 0;
+    }
+    ASSERT0(MEMPOOL_start_pos(mark.chunk) >= mark.pos);
+    MEMPOOL_start_pos(mark.chunk) = mark.pos;
+    arena->cur = mark.chunk;
+    arena->requested = mark.requested;
+    memset(arena->free_list, 0, sizeof(arena->free_list));
+}
+
+
+//Compute statistics of pool.
+//The waste of arena is the consumed bytes that are not in use, it
+//includes the padding for alignment, the unused tail of chunks, and
+//the memory in free lists. The waste of other pool is not available.
+void smpoolGetStat(SMemPool const* handler, OUT SMemPoolStat * stat)
+{
+    ASSERT0(stat);
+    memset(stat, 0, sizeof(SMemPoolStat));
+    if (handler == NULL) { return; }
+
+    SMemArena const* arena = MEMPOOL_arena(handler);
+    ULONGLONG consumed = 0;
+    bool after_cur = false;
+    for (SMemPool const* p = handler; p != NULL; p = MEMPOOL_next(p)) {
+        stat->reserved += MEMPOOL_pool_size(p);
+        stat->chunk_num++;
+        if (arena == NULL) {
+            consumed += MEMPOOL_start_pos(p);
+            continue;
+        }
+        if (after_cur) { continue; }
+        if (p == arena->cur) {
+            consumed += MEMPOOL_start_pos(p);
+            after_cur = true;
+        } else {
+            consumed += MEMPOOL_pool_size(p);
+        }
+    }
+
+    if (arena == NULL) {
+        stat->requested = consumed;
+        return;
+    }
+    stat->requested = arena->requested;
+    ASSERT0(consumed >= stat->requested);
+    stat->waste = consumed - stat->requested;
+}
+
+
+void dumpPoolStat(SMemPool const* handler, FILE * h)
+{
+    if (h == NULL) { return; }
+    SMemPoolStat stat;
+    smpoolGetStat(handler, &stat);
+    fprintf(h, "\n= SMP%s, requested:%llu, reserved:%llu, "
+            "chunk:%u, waste:%llu",
+            MEMPOOL_arena(handler) != NULL ? "(arena)" : "",
+            stat.requested, stat.reserved, stat.chunk_num, stat.waste);
+    fflush(h);
+}
+
+
 //Allocate one element from const size pool.
 //User must ensure each elment in const size pool are same size.
 //'elem_size': indicate the byte size of each element.
 void * smpoolMallocConstSize(size_t elem_size, IN SMemPool * handler)
 {
+    ASSERT(handler, ("need mempool handler"));
+    if (MEMPOOL_arena(handler) != NULL) {
+        ASSERT(MEMPOOL_type(handler) == MEM_CONST_SIZE,
+               ("Need const size pool"));
+        return arena_malloc(elem_size, handler, 0);
+    }
+
     ASSERT(elem_size > 0, ("elem size can not be 0"));
     ASSERT(handler, ("need mempool handler"));
     ASSERT(MEMPOOL_type(handler) == MEM_CONST_SIZE, ("Need const size pool"));
@@ -421,6 +665,10 @@ void * smpoolMalloc(size_t size, IN SMemPool * handler, size_t grow_size)
     ASSERT(size > 0, ("query size can not be 0"));
     ASSERT(handler, ("need mempool handler"));
 
+    if (MEMPOOL_arena(handler) != NULL) {
+        return arena_malloc(size, handler, grow_size);
+    }
+
     if (size % WORD_ALIGN) {
         size = (size / WORD_ALIGN + 1) * WORD_ALIGN;
     }
@@ -46,6 +46,18 @@ author: Su Zhenyu
 #define WORD_ALIGN 1
 #define MIN_MARGIN 0
 
+//Default alignment of the address allocated from arena.
+#define ARENA_DEFAULT_ALIGN 16
+
+//The upper bound of the chunk size when arena grows, unless the
+//requested size is larger than it.
+#define ARENA_MAX_GROW_SIZE (1024 * 1024)
+
+//Number of size classes of arena free list, the size of the class
+//'i' is (i + 1) * align. Freed memory larger than the maximum
+//class size is discarded.
+#define ARENA_SIZE_CLASS_NUM 16
+
 typedef size_t MEMPOOLIDX;
 typedef enum {
     MEM_NONE = 0,
@@ -62,10 +74,23 @@ typedef enum {
 #define MEMPOOL_start_pos(p)            ((p)->start_pos)
 #define MEMPOOL_pool_size(p)            ((p)->mem_pool_size)
 #define MEMPOOL_pool_ptr(p)             ((p)->ppool)
+#define MEMPOOL_arena(p)                ((p)->arena)
 #ifdef _DEBUG_
 #define MEMPOOL_chunk_id(p)             ((p)->chunk_id)
 #endif
 
+//Statistics of memory pool.
+typedef struct {
+    ULONGLONG requested; //bytes requested by user.
+    ULONGLONG reserved; //bytes of chunks allocated from system.
+    ULONGLONG waste; //bytes consumed but not in use, e.g: padding and
+                     //unused tail of chunk.
+    UINT chunk_num; //number of chunks.
+} SMemPoolStat;
+
+
+struct _MemArena;
+
 typedef struct _MemPool {
     MEMPOOLTYPE pool_type;
     struct _MemPool * next;
@@ -76,12 +101,36 @@ typedef struct _MemPool {
     size_t grow_size;
     void * ppool; //start address of mem pool
 
+    //Record arena information if pool is created in arena mode.
+    //It is only available in the first chunk of pool.
+    struct _MemArena * arena;
+
     #ifdef _DEBUG_
     ULONG chunk_id;
     #endif
 } SMemPool;
 
 
+//Arena mode of memory pool.
+//Arena allocates memory by bumping pointer of current chunk, and
+//the returned address is aligned in power of two. The chunk size
+//grows geometrically, but no more than ARENA_MAX_GROW_SIZE.
+typedef struct _MemArena {
+    SMemPool * cur; //current chunk.
+    size_t align; //alignment of address, must be power of two.
+    void * free_list[ARENA_SIZE_CLASS_NUM]; //size-class free lists.
+    ULONGLONG requested; //bytes requested by user.
+} SMemArena;
+
+
+//Record the allocation position of arena.
+typedef struct {
+    SMemPool * chunk;
+    size_t pos;
+    ULONGLONG requested;
+} SMemPoolMark;
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -89,6 +138,12 @@ extern "C" {
 MEMPOOLIDX smpoolCreatePoolIndex(size_t size, MEMPOOLTYPE mpt = MEM_COMM);
 SMemPool * smpoolCreate(size_t size, MEMPOOLTYPE mpt = MEM_COMM);
 
+//Create mem pool in arena mode.
+//'align': alignment of the address allocated, must be power of two.
+SMemPool * smpoolCreateArena(size_t size,
+                             MEMPOOLTYPE mpt = MEM_COMM,
+                             size_t align = ARENA_DEFAULT_ALIGN);
+
 //delete mem pool
 INT smpoolDeleteViaPoolIndex(MEMPOOLIDX mpt_idx);
 INT smpoolDelete(SMemPool * handle);
@@ -99,6 +154,20 @@ void * smpoolMallocViaPoolIndex(size_t size, MEMPOOLIDX mpt_idx,
 void * smpoolMalloc(size_t size, SMemPool * handle, size_t grow_size = 0);
 void * smpoolMallocConstSize(size_t elem_size, IN SMemPool * handler);
 
+//Return memory to the size-class free list of arena.
+//The memory will be reused by subsequent allocation of same size class.
+void smpoolFree(void * p, size_t size, IN SMemPool * handler);
+
+//Record the allocation position of arena.
+SMemPoolMark smpoolMark(SMemPool const* handler);
+
+//Release the memory allocated after 'mark' in arena.
+//Note the free lists are cleaned as well.
+void smpoolReleaseTo(IN SMemPool * handler, SMemPoolMark const& mark);
+
+//Compute statistics of pool.
+void smpoolGetStat(SMemPool const* handler, OUT SMemPoolStat * stat);
+
 //Get whole pool size with byte
 size_t smpoolGetPoolSizeViaIndex(MEMPOOLIDX mpt_idx);
 size_t smpoolGetPoolSize(SMemPool const* handle);
@@ -114,9 +183,10 @@ void smpoolInitPool(); //Initializing pool utilities
 void smpoolFiniPool(); //Finializing pool
 
 void dumpPool(SMemPool * handler, FILE * h);
+void dumpPoolStat(SMemPool const* handler, FILE * h);
 #ifdef __cplusplus
 }
 #endif
 
-extern ULONGLONG g_stat_mem_size;
+extern THREAD_LOCAL ULONGLONG g_stat_mem_size;
 #endif
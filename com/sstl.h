@@ -2641,6 +2641,63 @@ public:
 
 
 
+//START KeepBufVector
+//The extented class to Vector.
+//The buffer that is replaced by growing is kept rather than freed, if
+//the vector may be read by other threads without lock while it is
+//appended by the thread that holds the lock.
+//Elements must be appended via set() of this class.
+template <class T, UINT GrowSize = 8>
+class KeepBufVector : public Vector<T, GrowSize> {
+    List<T*> m_old_buf_list;
+    bool m_keep_old_buf;
+
+    void growAndKeepOldBuf(UINT index)
+    {
+        UINT n = getNearestPowerOf2(index) + 2;
+        T * buf = (T*)::malloc(sizeof(T) * n);
+        ASSERT0(buf);
+        ::memset(buf, 0, sizeof(T) * n);
+        if (Vector<T, GrowSize>::m_vec != NULL) {
+            ::memcpy(buf, Vector<T, GrowSize>::m_vec,
+                     sizeof(T) * Vector<T, GrowSize>::m_elem_num);
+            m_old_buf_list.append_tail(Vector<T, GrowSize>::m_vec);
+        }
+        Vector<T, GrowSize>::m_vec = buf;
+        Vector<T, GrowSize>::m_elem_num = n;
+    }
+public:
+    KeepBufVector() { m_keep_old_buf = false; }
+    COPY_CONSTRUCTOR(KeepBufVector);
+    ~KeepBufVector() { set_keep_old_buf(false); }
+
+    //Set to true if the vector may be read by other threads without lock,
+    //the buffer replaced by growing will not be freed until the flag
+    //is set to false.
+    void set_keep_old_buf(bool keep)
+    {
+        m_keep_old_buf = keep;
+        if (keep) { return; }
+        for (T * buf = m_old_buf_list.get_head();
+             buf != NULL; buf = m_old_buf_list.get_next()) {
+            ::free(buf);
+        }
+        m_old_buf_list.clean();
+    }
+
+    void set(UINT index, T elem)
+    {
+        if (m_keep_old_buf &&
+            index >= (UINT)Vector<T, GrowSize>::m_elem_num) {
+            growAndKeepOldBuf(index);
+        }
+        Vector<T, GrowSize>::set(index, elem);
+    }
+};
+//END KeepBufVector
+
+
+
 //The extented class to Vector.
 //This class maintains an index which call Free Index of Vector.
 //User can use the Free Index to get to know which slot of vector
@@ -3212,6 +3269,26 @@ public:
         return HC_val(elemhc);
     }
 
+    //Append 't' into hash table and return the index of the element
+    //in element vector. The index is unchanged until 't' is removed.
+    UINT append_elem_idx(T t)
+    {
+        HC<T> * elemhc = NULL;
+        append(t, &elemhc, NULL);
+        ASSERT(elemhc != NULL, ("Element does not append into hash table."));
+        return HC_vec_idx(elemhc);
+    }
+
+    //Append 'val' into hash table and return the index of the element
+    //in element vector.
+    UINT append_elem_idx(OBJTY val)
+    {
+        HC<T> * elemhc = NULL;
+        append(val, &elemhc, NULL);
+        ASSERT(elemhc != NULL, ("Element does not append into hash table."));
+        return HC_vec_idx(elemhc);
+    }
+
     //Count up the memory which hash table used.
     size_t count_mem() const
     {
@@ -3237,6 +3314,8 @@ public:
     //Get the hash bucket size.
     UINT get_bucket_size() const { return m_bucket_size; }
 
+    bool is_init() const { return m_bucket != NULL; }
+
     //Get the hash bucket.
     HashBucket const* get_bucket() const { return m_bucket; }
 
@@ -3563,232 +3642,728 @@ public:
         }
         return false;
     }
+
+    //Return the index of 't' in element vector, or -1 if 't' is not
+    //in hash table.
+    INT find_elem_idx(T t) const
+    {
+        HC<T> const* hc = NULL;
+        if (find(t, &hc)) { return (INT)HC_vec_idx(hc); }
+        return -1;
+    }
 };
 //END Hash
 
 
 
 //
-//START RBTNode
+//START FlatHash
 //
-typedef enum _RBT_RED {
-    RBT_NON = 0,
-    RBRED = 1,
-    RBBLACK = 2,
-} RBCOL;
+//The number of control bytes that FlatHash probes at a time.
+#define FLATHASH_GROUP 16
 
-template <class T, class Ttgt>
-class RBTNode {
-public:
-    RBTNode * parent;
-    union {
-        RBTNode * lchild;
-        RBTNode * prev;
-    };
+//The range of hash value that FlatHash requests from hash function class.
+//FlatHash scrambles the value, then picks out both the home slot and
+//the tag. It is power of 2 in order to satisfy the hash function classes
+//that require the bucket size must be the power of 2.
+#define FLATHASH_HASH_RANGE 0x80000000u
 
-    union {
-        RBTNode * rchild;
-        RBTNode * next;
-    };
-    T key;
-    Ttgt mapped;
-    RBCOL color;
+//Control byte of an empty slot, the control byte of an occupied slot
+//records the 7 high bits of the hash value, namely the tag.
+#define FLATHASH_EMPTY 0x80
 
-    RBTNode() { clean(); }
+#define FLATHASH_tag(hashv) ((BYTE)((hashv) >> 25))
 
-    void clean()
-    {
-        parent = NULL;
-        lchild = NULL;
-        rchild = NULL;
-        key = T(0);
-        mapped = Ttgt(0);
-        color = RBBLACK;
-    }
+template <class T> struct FlatHashSlot {
+    T val;
+    UINT elem_idx; //the position of 'val' in element vector.
+    UINT hashv; //the scrambled hash value of 'val'.
 };
 
 
-template <class T> class CompareKeyBase {
-public:
-    bool is_less(T t1, T t2) const { return t1 < t2; }
-    bool is_equ(T t1, T t2) const { return t1 == t2; }
-};
+//Return a mask, the bit i is set if ctrl[i] is equal to 'c',
+//where i is less than FLATHASH_GROUP.
+inline UINT flathashMatch(BYTE const* ctrl, BYTE c)
+{
+    #ifdef _SSE2_
+    __m128i g = _mm_loadu_si128((__m128i const*)ctrl);
+    return (UINT)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)c)));
+    #else
+    UINT m = 0;
+    for (UINT i = 0; i < FLATHASH_GROUP; i++) {
+        if (ctrl[i] == c) { m |= 1u << i; }
+    }
+    return m;
+    #endif
+}
 
-template <class T, class Ttgt, class CompareKey = CompareKeyBase<T> >
-class RBT {
+
+//Return the index of the lowest one bit, 'm' can not be 0.
+inline UINT flathashLowBit(UINT m)
+{
+    ASSERT0(m != 0);
+    #ifdef __GNUC__
+    return (UINT)__builtin_ctz(m);
+    #else
+    UINT n = 0;
+    while ((m & 1) == 0) { m >>= 1; n++; }
+    return n;
+    #endif
+}
+
+
+//FlatHash is an open addressing hash table that offers the same interface
+//as Hash, except that the hash container HC is not exposed.
+//
+//Elements are stored in one slot array, and are located by linear probing.
+//Each slot has a control byte that records whether the slot is empty, or
+//the tag of element. A lookup compares FLATHASH_GROUP tags at a time, and
+//compares element only if the tag matched, thus it usually touchs one
+//control group and one slot.
+//Removing element shifts the following elements of the probe sequence
+//backward, no tombstone left. Table grows twice when the load factor
+//exceeds 3/4.
+//
+//Like Hash, elements are also recorded in element vector, so the order
+//of get_first(), get_next(), get_last() and get_prev() is the same as
+//Hash, and it is safe to remove element during the iteration.
+//
+//'T': the element type.
+//'HF': Hash function type. HF::get_hash_value() is given bucket size
+//    FLATHASH_HASH_RANGE.
+//
+//NOTE:
+//    1. Do NOT append T(0) to table.
+//    2. HF::compare() must be consistent with HF::get_hash_value().
+template <class T, class HF = HashFuncBase<T> > class FlatHash {
 protected:
-    typedef RBTNode<T, Ttgt> TN;
-    UINT m_num_of_tn;
-    TN * m_root;
-    SMemPool * m_pool;
-    TN * m_free_list;
-    CompareKey m_ck;
+    HF m_hf;
+    BYTE * m_ctrl; //control bytes, the first group is duplicated at the end.
+    FlatHashSlot<T> * m_slot;
+    UINT m_cap; //the number of slots, it is power of 2.
+    UINT m_elem_count;
+    VectorWithFreeIndex<T, 8> m_elem_vector;
 
-    TN * new_tn()
+    UINT computeHash(T t) const
+    { return hash32bit(m_hf.get_hash_value(t, FLATHASH_HASH_RANGE)); }
+
+    UINT computeHash(OBJTY val) const
+    { return hash32bit(m_hf.get_hash_value(val, FLATHASH_HASH_RANGE)); }
+
+    //Set control byte of slot 'i', and keep the duplicated group in sync.
+    inline void setCtrl(UINT i, BYTE c)
     {
-        TN * p = (TN*)smpoolMallocConstSize(sizeof(TN), m_pool);
-        ASSERT0(p);
-        memset(p, 0, sizeof(TN));
-        return p;
+        m_ctrl[i] = c;
+        if (i < FLATHASH_GROUP) {
+            m_ctrl[m_cap + i] = c;
+        }
     }
 
-    inline TN * new_tn(T t, RBCOL c)
+    //Return the slot index of element that equal to 'k', or -1.
+    //'K': T or OBJTY.
+    template <class K> INT findSlot(K k, UINT hashv) const
     {
-        TN * x = removehead(&m_free_list);
-        if (x == NULL) {
-            x = new_tn();
-        } else {
-            x->lchild = NULL;
-            x->rchild = NULL;
+        UINT const mask = m_cap - 1;
+        BYTE const tag = FLATHASH_tag(hashv);
+        for (UINT pos = hashv & mask;; pos = (pos + FLATHASH_GROUP) & mask) {
+            BYTE const* g = m_ctrl + pos;
+            for (UINT m = flathashMatch(g, tag); m != 0; m &= m - 1) {
+                UINT i = (pos + flathashLowBit(m)) & mask;
+                if (m_slot[i].hashv == hashv && m_hf.compare(m_slot[i].val, k)) {
+                    return (INT)i;
+                }
+            }
+            if (flathashMatch(g, FLATHASH_EMPTY) != 0) {
+                //Element is never placed behind an empty slot.
+                return -1;
+            }
         }
-        x->key = t;
-        x->color = c;
-        return x;
+        return -1;
     }
 
-    void free_rbt(TN * t)
+    //Return the first empty slot start from the home slot of 'hashv'.
+    UINT findEmptySlot(UINT hashv) const
     {
-        if (t == NULL) return;
-        t->prev = t->next = t->parent = NULL;
-        t->key = T(0);
-        t->mapped = Ttgt(0);
-        insertbefore_one(&m_free_list, m_free_list, t);
+        UINT const mask = m_cap - 1;
+        for (UINT pos = hashv & mask;; pos = (pos + FLATHASH_GROUP) & mask) {
+            UINT m = flathashMatch(m_ctrl + pos, FLATHASH_EMPTY);
+            if (m != 0) {
+                return (pos + flathashLowBit(m)) & mask;
+            }
+        }
+        return 0;
     }
 
-    void rleft(TN * x)
+    //Insert 't' that is not in table, return the slot index.
+    UINT insert(T t, UINT hashv)
     {
-        ASSERT0(x->rchild != NULL);
-        TN * y = x->rchild;
-        y->parent = x->parent;
-        x->parent = y;
-        x->rchild = y->lchild;
-        if (y->lchild != NULL) {
-            y->lchild->parent = x;
-        }
-        y->lchild = x;
-        if (y->parent == NULL) {
-            m_root = y;
-        } else if (y->parent->lchild == x) {
-            y->parent->lchild = y;
-        } else if (y->parent->rchild == x) {
-            y->parent->rchild = y;
-        }
+        ASSERT0(t != T(0));
+        if ((m_elem_count + 1) * 4 > m_cap * 3) {
+            rehash(m_cap * 2);
+        }
+        UINT i = findEmptySlot(hashv);
+        m_slot[i].val = t;
+        m_slot[i].hashv = hashv;
+        m_slot[i].elem_idx = m_elem_vector.get_free_idx();
+        m_elem_vector.set(m_slot[i].elem_idx, t);
+        setCtrl(i, FLATHASH_tag(hashv));
+        m_elem_count++;
+        return i;
     }
 
-    void rright(TN * y)
+    //Empty slot 'i' and move back the elements that follow it in
+    //probe sequence, so that there is no element placed behind
+    //an empty slot.
+    void eraseSlot(UINT i)
     {
-        ASSERT0(y->lchild != NULL);
-        TN * x = y->lchild;
-        x->parent = y->parent;
-        y->parent = x;
-        y->lchild = x->rchild;
-        if (x->rchild != NULL) {
-            x->rchild->parent = y;
-        }
-        x->rchild = y;
-        if (x->parent == NULL) {
-            m_root = x;
-        } else if (x->parent->lchild == y) {
-            x->parent->lchild = x;
-        } else if (x->parent->rchild == y) {
-            x->parent->rchild = x;
+        UINT const mask = m_cap - 1;
+        for (UINT j = (i + 1) & mask;
+             m_ctrl[j] != FLATHASH_EMPTY; j = (j + 1) & mask) {
+            UINT home = m_slot[j].hashv & mask;
+
+            //Element 'j' stays if its home slot is cyclically in (i, j].
+            if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) {
+                continue;
+            }
+            m_slot[i] = m_slot[j];
+            setCtrl(i, m_ctrl[j]);
+            i = j;
         }
+        setCtrl(i, FLATHASH_EMPTY);
     }
 
-    bool is_lchild(TN const* z) const
+    //Reallocate slots and reinsert all elements, the position of element
+    //in element vector is unchanged.
+    void rehash(UINT cap)
     {
-        ASSERT0(z && z->parent);
-        return z == z->parent->lchild;
+        ASSERT0(isPowerOf2(cap) && cap >= FLATHASH_GROUP &&
+                m_elem_count * 4 <= cap * 3);
+        BYTE * old_ctrl = m_ctrl;
+        FlatHashSlot<T> * old_slot = m_slot;
+        UINT old_cap = m_cap;
+
+        m_cap = cap;
+        m_ctrl = (BYTE*)::malloc(cap + FLATHASH_GROUP);
+        memset(m_ctrl, FLATHASH_EMPTY, cap + FLATHASH_GROUP);
+        m_slot = (FlatHashSlot<T>*)::malloc(sizeof(FlatHashSlot<T>) * cap);
+        for (UINT i = 0; i < old_cap; i++) {
+            if (old_ctrl[i] == FLATHASH_EMPTY) { continue; }
+            UINT j = findEmptySlot(old_slot[i].hashv);
+            m_slot[j] = old_slot[i];
+            setCtrl(j, old_ctrl[i]);
+        }
+        ::free(old_ctrl);
+        ::free(old_slot);
     }
 
-    bool is_rchild(TN const* z) const
+    virtual T create(OBJTY v)
     {
-        ASSERT0(z && z->parent);
-        return z == z->parent->rchild;
+        ASSERT(0, ("Inherited class need to implement"));
+        UNUSED(v);
+        return T(0);
+    }
+public:
+    FlatHash(UINT bsize = MAX_SHASH_BUCKET)
+    {
+        m_ctrl = NULL;
+        m_slot = NULL;
+        m_cap = 0;
+        m_elem_count = 0;
+        init(bsize);
     }
+    COPY_CONSTRUCTOR(FlatHash);
+    virtual ~FlatHash() { destroy(); }
 
-    void fixup(TN * z)
+    //Append 't' into hash table and record its reference into
+    //Vector in order to walk through the table rapidly.
+    //If 't' already exists, return the element immediately.
+    //'elem_idx': record the position of element in element vector.
+    //'find': set to true if 't' already exist.
+    T append(T t, OUT UINT * elem_idx = NULL, bool * find = NULL)
     {
-        TN * y = NULL;
-        while (z->parent != NULL && z->parent->color == RBRED) {
-            if (is_lchild(z->parent)) {
-                y = z->parent->parent->rchild;
-                if (y != NULL && y->color == RBRED) {
-                    z->parent->color = RBBLACK;
-                    z->parent->parent->color = RBRED;
-                    y->color = RBBLACK;
-                    z = z->parent->parent;
-                } else if (is_rchild(z)) {
-                    z = z->parent;
-                    rleft(z);
-                } else {
-                    ASSERT0(is_lchild(z));
-                    z->parent->color = RBBLACK;
-                    z->parent->parent->color = RBRED;
-                    rright(z->parent->parent);
-                }
-            } else {
-                ASSERT0(is_rchild(z->parent));
-                y =    z->parent->parent->lchild;
-                if (y != NULL && y->color == RBRED) {
-                    z->parent->color = RBBLACK;
-                    z->parent->parent->color = RBRED;
-                    y->color = RBBLACK;
-                    z = z->parent->parent;
-                } else if (is_lchild(z)) {
-                    z = z->parent;
-                    rright(z);
-                } else {
-                    ASSERT0(is_rchild(z));
-                    z->parent->color = RBBLACK;
-                    z->parent->parent->color = RBRED;
-                    rleft(z->parent->parent);
-                }
-            }
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        if (t == T(0)) { return T(0); }
+
+        UINT hashv = computeHash(t);
+        INT i = findSlot(t, hashv);
+        if (find != NULL) { *find = i >= 0; }
+        if (i < 0) {
+            i = (INT)insert(t, hashv);
         }
-        m_root->color = RBBLACK;
+        if (elem_idx != NULL) { *elem_idx = m_slot[i].elem_idx; }
+        return m_slot[i].val;
     }
-public:
-    RBT()
+
+    //Append 'val' into hash table, the element is created by create().
+    //More comment see above function.
+    T append(OBJTY val, OUT UINT * elem_idx = NULL, bool * find = NULL)
     {
-        m_pool = NULL;
-        init();
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        UINT hashv = computeHash(val);
+        INT i = findSlot(val, hashv);
+        if (find != NULL) { *find = i >= 0; }
+        if (i < 0) {
+            i = (INT)insert(create(val), hashv);
+        }
+        if (elem_idx != NULL) { *elem_idx = m_slot[i].elem_idx; }
+        return m_slot[i].val;
     }
-    COPY_CONSTRUCTOR(RBT);
-    ~RBT() { destroy(); }
 
-    void init()
+    //Append 't' into hash table and return the index of the element
+    //in element vector. The index is unchanged until 't' is removed.
+    UINT append_elem_idx(T t)
     {
-        ASSERT0(m_pool == NULL);
-        m_pool = smpoolCreate(sizeof(TN) * 4, MEM_CONST_SIZE);
-        m_root = NULL;
-        m_num_of_tn = 0;
-        m_free_list = NULL;
+        UINT idx = 0;
+        append(t, &idx, NULL);
+        return idx;
     }
 
-    void destroy()
+    //Append 'val' into hash table and return the index of the element
+    //in element vector.
+    UINT append_elem_idx(OBJTY val)
     {
-        if (m_pool == NULL) { return; }
-        smpoolDelete(m_pool);
-        m_pool = NULL;
-        m_num_of_tn = 0;
-        m_root = NULL;
-        m_free_list = NULL;
+        UINT idx = 0;
+        append(val, &idx, NULL);
+        return idx;
     }
 
+    //Count up the memory which hash table used.
     size_t count_mem() const
     {
-        size_t c = sizeof(m_num_of_tn);
-        c += sizeof(m_root);
-        c += sizeof(m_pool);
-        c += sizeof(m_free_list);
-        c += smpoolGetPoolSize(m_pool);
-        return c;
+        size_t count = sizeof(*this);
+        if (m_ctrl != NULL) {
+            count += m_cap + FLATHASH_GROUP;
+            count += sizeof(FlatHashSlot<T>) * m_cap;
+        }
+        count += m_elem_vector.count_mem();
+        return count;
     }
 
+    //Clean the data structure but not destroy.
     void clean()
     {
-        List<TN*> wl;
+        if (m_ctrl == NULL) { return; }
+        memset(m_ctrl, FLATHASH_EMPTY, m_cap + FLATHASH_GROUP);
+        m_elem_count = 0;
+        m_elem_vector.clean();
+    }
+
+    //Get the number of slots.
+    UINT get_bucket_size() const { return m_cap; }
+
+    //Get the number of element in hash table.
+    UINT get_elem_count() const { return m_elem_count; }
+
+    bool is_init() const { return m_ctrl != NULL; }
+
+    //This function return the first element if it exists, and initialize
+    //the iterator, otherwise return T(0).
+    //More comment see Hash::get_first().
+    T get_first(INT & iter) const
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        T t = T(0);
+        iter = -1;
+        if (m_elem_count <= 0) { return T(0); }
+        INT l = m_elem_vector.get_last_idx();
+        for (INT i = 0; i <= l; i++) {
+            if ((t = m_elem_vector.get((UINT)i)) != T(0)) {
+                iter = i;
+                return t;
+            }
+        }
+        return T(0);
+    }
+
+    //This function return the next element of given iterator.
+    //More comment see Hash::get_next().
+    T get_next(INT & iter) const
+    {
+        ASSERT(m_ctrl != NULL && iter >= -1, ("Hash not yet initialized."));
+        T t = T(0);
+        if (m_elem_count <= 0) { return T(0); }
+        INT l = m_elem_vector.get_last_idx();
+        for (INT i = iter + 1; i <= l; i++) {
+            if ((t = m_elem_vector.get((UINT)i)) != T(0)) {
+                iter = i;
+                return t;
+            }
+        }
+        iter = -1;
+        return T(0);
+    }
+
+    //This function return the last element if it exists, and initialize
+    //the iterator, otherwise return T(0).
+    //More comment see Hash::get_last().
+    T get_last(INT & iter) const
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        T t = T(0);
+        iter = -1;
+        if (m_elem_count <= 0) { return T(0); }
+        INT l = m_elem_vector.get_last_idx();
+        for (INT i = l; i >= 0; i--) {
+            if ((t = m_elem_vector.get((UINT)i)) != T(0)) {
+                iter = i;
+                return t;
+            }
+        }
+        return T(0);
+    }
+
+    //This function return the previous element of given iterator.
+    //More comment see Hash::get_prev().
+    T get_prev(INT & iter) const
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        T t = T(0);
+        if (m_elem_count <= 0) { return T(0); }
+        for (INT i = iter - 1; i >= 0; i--) {
+            if ((t = m_elem_vector.get((UINT)i)) != T(0)) {
+                iter = i;
+                return t;
+            }
+        }
+        iter = -1;
+        return T(0);
+    }
+
+    //'bsize': the expected number of elements.
+    void init(UINT bsize = MAX_SHASH_BUCKET)
+    {
+        if (m_ctrl != NULL || bsize == 0) { return; }
+        UINT cap = getNearestPowerOf2(bsize + bsize / 3);
+        m_cap = MAX(cap, FLATHASH_GROUP);
+        m_ctrl = (BYTE*)::malloc(m_cap + FLATHASH_GROUP);
+        memset(m_ctrl, FLATHASH_EMPTY, m_cap + FLATHASH_GROUP);
+        m_slot = (FlatHashSlot<T>*)::malloc(sizeof(FlatHashSlot<T>) * m_cap);
+        m_elem_count = 0;
+        m_elem_vector.init();
+    }
+
+    //Free all memory objects.
+    void destroy()
+    {
+        if (m_ctrl == NULL) { return; }
+        ::free(m_ctrl);
+        ::free(m_slot);
+        m_ctrl = NULL;
+        m_slot = NULL;
+        m_cap = 0;
+        m_elem_count = 0;
+        m_elem_vector.destroy();
+    }
+
+    //Dump the distance between element and its home slot.
+    void dump_intersp(FILE * h) const
+    {
+        if (h == NULL || m_ctrl == NULL) { return; }
+        UINT const mask = m_cap - 1;
+        UINT maxd = 0;
+        ULONGLONG sumd = 0;
+        for (UINT i = 0; i < m_cap; i++) {
+            if (m_ctrl[i] == FLATHASH_EMPTY) { continue; }
+            UINT d = (i - (m_slot[i].hashv & mask)) & mask;
+            maxd = MAX(maxd, d);
+            sumd += d;
+        }
+        fprintf(h, "\n=== FlatHash: cap:%u, elem:%u, max-dist:%u, avg-dist:%.2f",
+                m_cap, m_elem_count, maxd,
+                m_elem_count == 0 ? 0.0 : (double)sumd / m_elem_count);
+        fflush(h);
+    }
+
+    //This function remove one element, and return the removed one.
+    //Note that 't' may be different with the return one accroding to
+    //the behavior of user's defined HF class.
+    //The order of the rest elements in element vector is unchanged.
+    T removed(T t)
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        if (t == T(0)) { return T(0); }
+        INT i = findSlot(t, computeHash(t));
+        if (i < 0) { return T(0); }
+        m_elem_vector.set(m_slot[i].elem_idx, T(0));
+        eraseSlot((UINT)i);
+        m_elem_count--;
+        return t;
+    }
+
+    //Grow hash to 'bsize' slots and rehash all elements in the table.
+    //The default grow size is twice as the current size.
+    //NOTE: the table grows automatically, it is unnecessary to invoke
+    //this function unless you know the final number of elements.
+    void grow(UINT bsize = 0)
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        if (bsize != 0) {
+            ASSERT0(bsize > m_cap);
+            bsize = getNearestPowerOf2(bsize);
+        } else {
+            bsize = m_cap * 2;
+        }
+        rehash(bsize);
+    }
+
+    //Find element accroding to specific 'val'.
+    T find(OBJTY val) const
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        INT i = findSlot(val, computeHash(val));
+        return i < 0 ? T(0) : m_slot[i].val;
+    }
+
+    //Find one element and return the element which record in hash table.
+    //Return true if 't' exist, otherwise return false.
+    //Note t may be different with the return one.
+    //
+    //'ot': output the element if found it.
+    bool find(T t, OUT T * ot = NULL) const
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        if (t == T(0)) { return false; }
+        INT i = findSlot(t, computeHash(t));
+        if (i < 0) { return false; }
+        if (ot != NULL) { *ot = m_slot[i].val; }
+        return true;
+    }
+
+    //Return the index of 't' in element vector, or -1 if 't' is not
+    //in hash table.
+    INT find_elem_idx(T t) const
+    {
+        ASSERT(m_ctrl != NULL, ("Hash not yet initialized."));
+        if (t == T(0)) { return -1; }
+        INT i = findSlot(t, computeHash(t));
+        return i < 0 ? -1 : (INT)m_slot[i].elem_idx;
+    }
+};
+//END FlatHash
+
+
+
+//
+//START RBTNode
+//
+typedef enum _RBT_RED {
+    RBT_NON = 0,
+    RBRED = 1,
+    RBBLACK = 2,
+} RBCOL;
+
+template <class T, class Ttgt>
+class RBTNode {
+public:
+    RBTNode * parent;
+    union {
+        RBTNode * lchild;
+        RBTNode * prev;
+    };
+
+    union {
+        RBTNode * rchild;
+        RBTNode * next;
+    };
+    T key;
+    Ttgt mapped;
+    RBCOL color;
+
+    RBTNode() { clean(); }
+
+    void clean()
+    {
+        parent = NULL;
+        lchild = NULL;
+        rchild = NULL;
+        key = T(0);
+        mapped = Ttgt(0);
+        color = RBBLACK;
+    }
+};
+
+
+template <class T> class CompareKeyBase {
+public:
+    bool is_less(T t1, T t2) const { return t1 < t2; }
+    bool is_equ(T t1, T t2) const { return t1 == t2; }
+};
+
+template <class T, class Ttgt, class CompareKey = CompareKeyBase<T> >
+class RBT {
+protected:
+    typedef RBTNode<T, Ttgt> TN;
+    UINT m_num_of_tn;
+    TN * m_root;
+    SMemPool * m_pool;
+    TN * m_free_list;
+    CompareKey m_ck;
+
+    TN * new_tn()
+    {
+        TN * p = (TN*)smpoolMallocConstSize(sizeof(TN), m_pool);
+        ASSERT0(p);
+        memset(p, 0, sizeof(TN));
+        return p;
+    }
+
+    inline TN * new_tn(T t, RBCOL c)
+    {
+        TN * x = removehead(&m_free_list);
+        if (x == NULL) {
+            x = new_tn();
+        } else {
+            x->lchild = NULL;
+            x->rchild = NULL;
+        }
+        x->key = t;
+        x->color = c;
+        return x;
+    }
+
+    void free_rbt(TN * t)
+    {
+        if (t == NULL) return;
+        t->prev = t->next = t->parent = NULL;
+        t->key = T(0);
+        t->mapped = Ttgt(0);
+        insertbefore_one(&m_free_list, m_free_list, t);
+    }
+
+    void rleft(TN * x)
+    {
+        ASSERT0(x->rchild != NULL);
+        TN * y = x->rchild;
+        y->parent = x->parent;
+        x->parent = y;
+        x->rchild = y->lchild;
+        if (y->lchild != NULL) {
+            y->lchild->parent = x;
+        }
+        y->lchild = x;
+        if (y->parent == NULL) {
+            m_root = y;
+        } else if (y->parent->lchild == x) {
+            y->parent->lchild = y;
+        } else if (y->parent->rchild == x) {
+            y->parent->rchild = y;
+        }
+    }
+
+    void rright(TN * y)
+    {
+        ASSERT0(y->lchild != NULL);
+        TN * x = y->lchild;
+        x->parent = y->parent;
+        y->parent = x;
+        y->lchild = x->rchild;
+        if (x->rchild != NULL) {
+            x->rchild->parent = y;
+        }
+        x->rchild = y;
+        if (x->parent == NULL) {
+            m_root = x;
+        } else if (x->parent->lchild == y) {
+            x->parent->lchild = x;
+        } else if (x->parent->rchild == y) {
+            x->parent->rchild = x;
+        }
+    }
+
+    bool is_lchild(TN const* z) const
+    {
+        ASSERT0(z && z->parent);
+        return z == z->parent->lchild;
+    }
+
+    bool is_rchild(TN const* z) const
+    {
+        ASSERT0(z && z->parent);
+        return z == z->parent->rchild;
+    }
+
+    void fixup(TN * z)
+    {
+        TN * y = NULL;
+        while (z->parent != NULL && z->parent->color == RBRED) {
+            if (is_lchild(z->parent)) {
+                y = z->parent->parent->rchild;
+                if (y != NULL && y->color == RBRED) {
+                    z->parent->color = RBBLACK;
+                    z->parent->parent->color = RBRED;
+                    y->color = RBBLACK;
+                    z = z->parent->parent;
+                } else if (is_rchild(z)) {
+                    z = z->parent;
+                    rleft(z);
+                } else {
+                    ASSERT0(is_lchild(z));
+                    z->parent->color = RBBLACK;
+                    z->parent->parent->color = RBRED;
+                    rright(z->parent->parent);
+                }
+            } else {
+                ASSERT0(is_rchild(z->parent));
+                y =    z->parent->parent->lchild;
+                if (y != NULL && y->color == RBRED) {
+                    z->parent->color = RBBLACK;
+                    z->parent->parent->color = RBRED;
+                    y->color = RBBLACK;
+                    z = z->parent->parent;
+                } else if (is_lchild(z)) {
+                    z = z->parent;
+                    rright(z);
+                } else {
+                    ASSERT0(is_rchild(z));
+                    z->parent->color = RBBLACK;
+                    z->parent->parent->color = RBRED;
+                    rleft(z->parent->parent);
+                }
+            }
+        }
+        m_root->color = RBBLACK;
+    }
+public:
+    RBT()
+    {
+        m_pool = NULL;
+        init();
+    }
+    COPY_CONSTRUCTOR(RBT);
+    ~RBT() { destroy(); }
+
+    void init()
+    {
+        ASSERT0(m_pool == NULL);
+        m_pool = smpoolCreate(sizeof(TN) * 4, MEM_CONST_SIZE);
+        m_root = NULL;
+        m_num_of_tn = 0;
+        m_free_list = NULL;
+    }
+
+    void destroy()
+    {
+        if (m_pool == NULL) { return; }
+        smpoolDelete(m_pool);
+        m_pool = NULL;
+        m_num_of_tn = 0;
+        m_root = NULL;
+        m_free_list = NULL;
+    }
+
+    size_t count_mem() const
+    {
+        size_t c = sizeof(m_num_of_tn);
+        c += sizeof(m_root);
+        c += sizeof(m_pool);
+        c += sizeof(m_free_list);
+        c += smpoolGetPoolSize(m_pool);
+        return c;
+    }
+
+    void clean()
+    {
+        List<TN*> wl;
         if (m_root != NULL) {
             wl.append_tail(m_root);
             m_root = NULL;
@@ -4098,13 +4673,44 @@ public:
 
 
 
+//The number of bytes of the key array of node in BTMap.
+#define BTMAP_KEY_BYTE 64
+
+//The number of keys that a node of BTMap holds, the key array fits in
+//one cache line if the key is not larger than 16 bytes.
+#define BTMAP_KEY_NUM(T) \
+    (BTMAP_KEY_BYTE / sizeof(T) >= 4 ? BTMAP_KEY_BYTE / sizeof(T) : 4)
+
+//Leaf node of BTMap.
+template <class Tsrc, class Ttgt> struct BTLeaf {
+    UINT num; //the number of keys.
+    BTLeaf * prev; //the previous leaf in key order.
+    BTLeaf * next; //the next leaf in key order.
+    Tsrc key[BTMAP_KEY_NUM(Tsrc)];
+    Ttgt mapped[BTMAP_KEY_NUM(Tsrc)];
+};
+
+
+//Inner node of BTMap.
+//Keys in kid[i] are less than key[i], and are not less than key[i-1].
+template <class Tsrc> struct BTInner {
+    UINT num; //the number of keys, and the node has num+1 kids.
+    Tsrc key[BTMAP_KEY_NUM(Tsrc)];
+    void * kid[BTMAP_KEY_NUM(Tsrc) + 1];
+};
+
+
 //TMap Iterator based on Double Linked List.
-//This class is used to iterate elements in TMap.
+//This class is used to iterate elements in TMap and BTMap.
 //You should call clean() to initialize the iterator.
 template <class Tsrc, class Ttgt>
 class TMapIter : public List<RBTNode<Tsrc, Ttgt>*> {
 public:
-    TMapIter() {}
+    //The leaf and the position in leaf that BTMap is walking through.
+    BTLeaf<Tsrc, Ttgt> * bt_leaf;
+    UINT bt_pos;
+
+    TMapIter() { bt_leaf = NULL; bt_pos = 0; }
     COPY_CONSTRUCTOR(TMapIter);
 };
 
@@ -4223,10 +4829,10 @@ public:
 //        };
 
 //TTab Iterator.
-//This class is used to iterate elements in TTab.
+//This class is used to iterate elements in TTab and BTTab.
 //You should call clean() to initialize the iterator.
 template <class T>
-class TabIter : public List<RBTNode<T, T>*> {
+class TabIter : public TMapIter<T, T> {
 public:
     TabIter() {}
     COPY_CONSTRUCTOR(TabIter);
@@ -4289,10 +4895,542 @@ public:
 //END TTab
 
 
+//
+//START BTMap
+//
+//BTMap
+//
+//Make an ordered map between Tsrc and Ttgt, it is implemented as B+ tree.
+//BTMap has the same interface as TMap, and is iterated by TMapIter, so
+//TMap can be replaced with BTMap without modifying its users.
+//
+//Keys and mapped values are stored in the arrays of leaf, thus a map
+//that has no more than BTMAP_KEY_NUM(Tsrc) elements is a sorted vector,
+//and it grows into a tree when the leaf splits. Both lookup and insertion
+//do a binary search in one node of each level, and the keys of a node
+//fit in one cache line. get_first() and get_next() walk through the
+//linked leaves in ascending order of key.
+//
+//Nodes are allocated from a const size pool and recycled by a free list.
+//A node is freed once it becomes empty, but nodes are not merged when
+//element is removed, because maps in compiler seldom shrink.
+//
+//Usage: Make a mapping from SRC* to TGT*.
+//    class SRC2TGT_MAP : public BTMap<SRC*, TGT*> {
+//    public:
+//    };
+//
+//NOTICE:
+//    1. Tsrc(0) is defined as default NULL in BTMap, do NOT use T(0)
+//       as element.
+//    2. Keep the key *UNIQUE* .
+//    3. Overload operator == and operator < if Tsrc is neither basic type
+//       nor pointer type.
+//    4. Do NOT modify the map while walking through it.
+template <class Tsrc, class Ttgt, class CompareKey = CompareKeyBase<Tsrc> >
+class BTMap {
+protected:
+    typedef BTLeaf<Tsrc, Ttgt> LEAF;
+    typedef BTInner<Tsrc> INNER;
+    enum { KEY_NUM = BTMAP_KEY_NUM(Tsrc) };
+
+    CompareKey m_ck;
+    void * m_root; //it is leaf if m_height is 0.
+    UINT m_height; //the number of levels of inner node.
+    UINT m_elem_count;
+    SMemPool * m_pool;
+    void * m_free_list; //freed nodes, linked via the first word.
+
+    static size_t node_size()
+    { return MAX(sizeof(LEAF), sizeof(INNER)); }
+
+    void * new_node()
+    {
+        void * p = m_free_list;
+        if (p != NULL) {
+            m_free_list = *(void**)p;
+            return p;
+        }
+        p = smpoolMallocConstSize(node_size(), m_pool);
+        ASSERT0(p);
+        return p;
+    }
+
+    LEAF * new_leaf()
+    {
+        LEAF * l = (LEAF*)new_node();
+        l->num = 0;
+        l->prev = NULL;
+        l->next = NULL;
+        return l;
+    }
+
+    INNER * new_inner()
+    {
+        INNER * in = (INNER*)new_node();
+        in->num = 0;
+        return in;
+    }
+
+    void free_node(void * p)
+    {
+        *(void**)p = m_free_list;
+        m_free_list = p;
+    }
+
+    //Free all nodes of the subtree 'x' of height 'h'.
+    void free_tree(void * x, UINT h)
+    {
+        if (h > 0) {
+            INNER * in = (INNER*)x;
+            for (UINT i = 0; i <= in->num; i++) {
+                free_tree(in->kid[i], h - 1);
+            }
+        }
+        free_node(x);
+    }
+
+    //Return the first position in 'key' that is not less than 't'.
+    UINT lower_bound(Tsrc const* key, UINT num, Tsrc t) const
+    {
+        UINT lo = 0;
+        UINT hi = num;
+        while (lo < hi) {
+            UINT mid = (lo + hi) >> 1;
+            if (m_ck.is_less(key[mid], t)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    //Return the first position in 'key' that is greater than 't'.
+    UINT upper_bound(Tsrc const* key, UINT num, Tsrc t) const
+    {
+        UINT lo = 0;
+        UINT hi = num;
+        while (lo < hi) {
+            UINT mid = (lo + hi) >> 1;
+            if (m_ck.is_less(t, key[mid])) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo;
+    }
+
+    //Return the leaf that 't' should be placed in.
+    LEAF * find_leaf(Tsrc t) const
+    {
+        void * x = m_root;
+        for (UINT h = m_height; h > 0; h--) {
+            INNER const* in = (INNER const*)x;
+            x = in->kid[upper_bound(in->key, in->num, t)];
+        }
+        return (LEAF*)x;
+    }
+
+    //Return the address of mapped value of 't', or NULL if 't' is not
+    //in map.
+    Ttgt * find_mapped(Tsrc t) const
+    {
+        if (m_root == NULL) { return NULL; }
+        LEAF * l = find_leaf(t);
+        UINT i = lower_bound(l->key, l->num, t);
+        if (i < l->num && m_ck.is_equ(l->key[i], t)) {
+            return &l->mapped[i];
+        }
+        return NULL;
+    }
+
+    //Insert 't' into leaf 'l'.
+    //Return the new right sibling if 'l' is split, and 'sep' records the
+    //least key of the sibling.
+    LEAF * insert_leaf(LEAF * l, Tsrc t, OUT Ttgt ** mapped, OUT bool & find,
+                       OUT Tsrc & sep)
+    {
+        UINT i = lower_bound(l->key, l->num, t);
+        if (i < l->num && m_ck.is_equ(l->key[i], t)) {
+            find = true;
+            *mapped = &l->mapped[i];
+            return NULL;
+        }
+
+        find = false;
+        LEAF * tgt = l;
+        LEAF * right = NULL;
+        if (l->num == KEY_NUM) {
+            //Move the upper half to new leaf.
+            UINT mid = (KEY_NUM + 1) / 2;
+            right = new_leaf();
+            right->num = KEY_NUM - mid;
+            for (UINT j = 0; j < right->num; j++) {
+                right->key[j] = l->key[mid + j];
+                right->mapped[j] = l->mapped[mid + j];
+            }
+            l->num = mid;
+            right->prev = l;
+            right->next = l->next;
+            if (l->next != NULL) {
+                l->next->prev = right;
+            }
+            l->next = right;
+            if (i > mid) {
+                tgt = right;
+                i -= mid;
+            }
+        }
+
+        for (UINT j = tgt->num; j > i; j--) {
+            tgt->key[j] = tgt->key[j - 1];
+            tgt->mapped[j] = tgt->mapped[j - 1];
+        }
+        tgt->key[i] = t;
+        tgt->mapped[i] = Ttgt(0);
+        tgt->num++;
+        *mapped = &tgt->mapped[i];
+        m_elem_count++;
+
+        if (right != NULL) {
+            sep = right->key[0];
+        }
+        return right;
+    }
+
+    //Insert 't' into the subtree 'x' of height 'h'.
+    //Return the new right sibling if 'x' is split, and 'sep' records the
+    //key that separates 'x' and the sibling.
+    //'mapped': record the address of mapped value of 't'.
+    //'find': set to true if 't' already exist.
+    void * insert_rec(void * x, UINT h, Tsrc t, OUT Ttgt ** mapped,
+                      OUT bool & find, OUT Tsrc & sep)
+    {
+        if (h == 0) {
+            return insert_leaf((LEAF*)x, t, mapped, find, sep);
+        }
+
+        INNER * in = (INNER*)x;
+        UINT i = upper_bound(in->key, in->num, t);
+        Tsrc kidsep = Tsrc(0);
+        void * r = insert_rec(in->kid[i], h - 1, t, mapped, find, kidsep);
+        if (r == NULL) { return NULL; }
+
+        INNER * tgt = in;
+        INNER * right = NULL;
+        if (in->num == KEY_NUM) {
+            //Move the keys after 'mid' to new node, the key at 'mid'
+            //goes up to parent.
+            UINT mid = KEY_NUM / 2;
+            right = new_inner();
+            right->num = KEY_NUM - mid - 1;
+            for (UINT j = 0; j < right->num; j++) {
+                right->key[j] = in->key[mid + 1 + j];
+            }
+            for (UINT j = 0; j <= right->num; j++) {
+                right->kid[j] = in->kid[mid + 1 + j];
+            }
+            sep = in->key[mid];
+            in->num = mid;
+            if (i > mid) {
+                tgt = right;
+                i -= mid + 1;
+            }
+        }
+
+        //Place 'kidsep' at i, and 'r' follows the kid that split.
+        for (UINT j = tgt->num; j > i; j--) {
+            tgt->key[j] = tgt->key[j - 1];
+            tgt->kid[j + 1] = tgt->kid[j];
+        }
+        tgt->key[i] = kidsep;
+        tgt->kid[i + 1] = r;
+        tgt->num++;
+        return right;
+    }
+
+    //Insert 't' into map, return the address of its mapped value.
+    //'find': set to true if 't' already exist.
+    Ttgt * insert(Tsrc t, OUT bool * find)
+    {
+        ASSERT(m_pool != NULL, ("not yet initialize."));
+        if (m_root == NULL) {
+            m_root = new_leaf();
+            m_height = 0;
+        }
+
+        Ttgt * mapped = NULL;
+        bool f = false;
+        Tsrc sep = Tsrc(0);
+        void * r = insert_rec(m_root, m_height, t, &mapped, f, sep);
+        if (r != NULL) {
+            //Root is split, the tree grows up.
+            INNER * root = new_inner();
+            root->num = 1;
+            root->key[0] = sep;
+            root->kid[0] = m_root;
+            root->kid[1] = r;
+            m_root = root;
+            m_height++;
+        }
+        if (find != NULL) { *find = f; }
+        ASSERT0(mapped);
+        return mapped;
+    }
+
+    //Remove 't' from the subtree 'x' of height 'h'.
+    //Return true if 'x' becomes empty and has been freed.
+    bool remove_rec(void * x, UINT h, Tsrc t)
+    {
+        if (h == 0) {
+            LEAF * l = (LEAF*)x;
+            UINT i = lower_bound(l->key, l->num, t);
+            if (i >= l->num || !m_ck.is_equ(l->key[i], t)) { return false; }
+            for (UINT j = i + 1; j < l->num; j++) {
+                l->key[j - 1] = l->key[j];
+                l->mapped[j - 1] = l->mapped[j];
+            }
+            l->num--;
+            m_elem_count--;
+            if (l->num != 0) { return false; }
+
+            if (l->prev != NULL) {
+                l->prev->next = l->next;
+            }
+            if (l->next != NULL) {
+                l->next->prev = l->prev;
+            }
+            free_node(l);
+            return true;
+        }
+
+        INNER * in = (INNER*)x;
+        UINT i = upper_bound(in->key, in->num, t);
+        if (!remove_rec(in->kid[i], h - 1, t)) { return false; }
+
+        if (in->num == 0) {
+            //The only kid has gone.
+            free_node(in);
+            return true;
+        }
+
+        //Remove kid i and the separator on one side of it.
+        for (UINT j = i == 0 ? 1 : i; j < in->num; j++) {
+            in->key[j - 1] = in->key[j];
+        }
+        for (UINT j = i + 1; j <= in->num; j++) {
+            in->kid[j - 1] = in->kid[j];
+        }
+        in->num--;
+        return false;
+    }
+public:
+    BTMap()
+    {
+        m_pool = NULL;
+        init();
+    }
+    COPY_CONSTRUCTOR(BTMap);
+    ~BTMap() { destroy(); }
+
+    //This function should be invoked if BTMap is initialized manually.
+    void init()
+    {
+        ASSERT0(m_pool == NULL);
+        m_pool = smpoolCreate(node_size() * 2, MEM_CONST_SIZE);
+        m_root = NULL;
+        m_height = 0;
+        m_elem_count = 0;
+        m_free_list = NULL;
+    }
+
+    //This function should be invoked if BTMap is destroied manually.
+    void destroy()
+    {
+        if (m_pool == NULL) { return; }
+        smpoolDelete(m_pool);
+        m_pool = NULL;
+        m_root = NULL;
+        m_height = 0;
+        m_elem_count = 0;
+        m_free_list = NULL;
+    }
+
+    //Remove all elements, and the nodes are kept for reuse.
+    void clean()
+    {
+        if (m_root != NULL) {
+            free_tree(m_root, m_height);
+        }
+        m_root = NULL;
+        m_height = 0;
+        m_elem_count = 0;
+    }
+
+    size_t count_mem() const
+    {
+        size_t c = sizeof(*this);
+        c += smpoolGetPoolSize(m_pool);
+        return c;
+    }
+
+    UINT get_elem_count() const { return m_elem_count; }
+
+    //Alway set new mapping even if it has done.
+    //This function will enforce mapping between t and mapped.
+    void setAlways(Tsrc t, Ttgt mapped) { *insert(t, NULL) = mapped; }
+
+    //Establishing mapping in between 't' and 'mapped'.
+    void set(Tsrc t, Ttgt mapped)
+    {
+        bool find = false;
+        Ttgt * z = insert(t, &find);
+        ASSERT(!find, ("already mapped"));
+        *z = mapped;
+    }
+
+    //Get mapped element of 't'. Set find to true if t is already be mapped.
+    //Note this function is readonly.
+    Ttgt get(Tsrc t, bool * f = NULL) const
+    {
+        Ttgt const* z = find_mapped(t);
+        if (f != NULL) {
+            *f = z != NULL;
+        }
+        return z == NULL ? Ttgt(0) : *z;
+    }
+
+    bool find(Tsrc t) const { return find_mapped(t) != NULL; }
+
+    //iter need not to be cleaned by caller.
+    Tsrc get_first(TMapIter<Tsrc, Ttgt> & iter, Ttgt * mapped = NULL) const
+    {
+        iter.bt_leaf = NULL;
+        iter.bt_pos = 0;
+        if (m_root == NULL) {
+            if (mapped != NULL) { *mapped = Ttgt(0); }
+            return Tsrc(0);
+        }
+        void * x = m_root;
+        for (UINT h = m_height; h > 0; h--) {
+            x = ((INNER*)x)->kid[0];
+        }
+        LEAF * l = (LEAF*)x;
+        ASSERT0(l->num > 0);
+        iter.bt_leaf = l;
+        if (mapped != NULL) { *mapped = l->mapped[0]; }
+        return l->key[0];
+    }
+
+    Tsrc get_next(TMapIter<Tsrc, Ttgt> & iter, Ttgt * mapped = NULL) const
+    {
+        LEAF * l = iter.bt_leaf;
+        if (l != NULL) {
+            iter.bt_pos++;
+            if (iter.bt_pos >= l->num) {
+                l = l->next;
+                iter.bt_leaf = l;
+                iter.bt_pos = 0;
+            }
+        }
+        if (l == NULL) {
+            if (mapped != NULL) { *mapped = Ttgt(0); }
+            return Tsrc(0);
+        }
+        if (mapped != NULL) { *mapped = l->mapped[iter.bt_pos]; }
+        return l->key[iter.bt_pos];
+    }
+
+    void remove(Tsrc t)
+    {
+        if (m_root == NULL) { return; }
+        if (remove_rec(m_root, m_height, t)) {
+            m_root = NULL;
+            m_height = 0;
+            return;
+        }
+
+        //Shrink the tree while root has only one kid.
+        while (m_height > 0 && ((INNER*)m_root)->num == 0) {
+            void * kid = ((INNER*)m_root)->kid[0];
+            free_node(m_root);
+            m_root = kid;
+            m_height--;
+        }
+    }
+};
+//END BTMap
+
+
+//BTTab
+//
+//A table that has the same interface as TTab, and it is implemented
+//as BTMap.
+//
+//NOTICE:
+//    1. T(0) is defined as default NULL in BTTab, do not use T(0) as element.
+//    2. Keep the key *UNIQUE*.
+template <class T, class CompareKey = CompareKeyBase<T> >
+class BTTab : public BTMap<T, T, CompareKey> {
+public:
+    BTTab() {}
+    COPY_CONSTRUCTOR(BTTab);
+
+    typedef BTMap<T, T, CompareKey> BaseBTMap;
+
+    //Add element into table.
+    //Note: the element in the table must be unqiue.
+    void append(T t)
+    {
+        ASSERT0(t != T(0));
+        #ifdef _DEBUG_
+        bool find = false;
+        T mapped = BaseBTMap::get(t, &find);
+        if (find) {
+            ASSERT0(mapped == t);
+        }
+        #endif
+        BaseBTMap::setAlways(t, t);
+    }
+
+    //Add element into table, if it is exist, return the exist one.
+    T append_and_retrieve(T t)
+    {
+        ASSERT0(t != T(0));
+        bool find = false;
+        T * mapped = BaseBTMap::insert(t, &find);
+        if (find) {
+            return *mapped;
+        }
+        *mapped = t;
+        return t;
+    }
+
+    void remove(T t)
+    {
+        ASSERT0(t != T(0));
+        BaseBTMap::remove(t);
+    }
+
+    bool find(T t) const { return BaseBTMap::find(t); }
+
+    T get_first(TabIter<T> & iter) const
+    { return BaseBTMap::get_first(iter, NULL); }
+
+    T get_next(TabIter<T> & iter) const
+    { return BaseBTMap::get_next(iter, NULL); }
+};
+//END BTTab
+
+
 //Unidirectional Hashed Map
 //
 //Tsrc: the type of keys maintained by this map.
 //Ttgt: the type of mapped values.
+//HashImpl: the hash table that holds the keys, it is either Hash or
+//    FlatHash.
 //
 //Usage: Make a mapping from OPND to OPER.
 //    typedef HMap<OPND*, OPER*, HashFuncBase<OPND*> > OPND2OPER_MAP;
@@ -4305,35 +5443,13 @@ public:
 //    3. Must use 'new'/'delete' operator to allocate/free the
 //       memory of dynamic object of MAP, because the
 //       virtual-function-pointers-table is needed.
-template <class Tsrc, class Ttgt, class HF = HashFuncBase<Tsrc> >
-class HMap : public Hash<Tsrc, HF> {
+template <class Tsrc, class Ttgt, class HF = HashFuncBase<Tsrc>,
+          class HashImpl = Hash<Tsrc, HF> >
+class HMap : public HashImpl {
 protected:
     Vector<Ttgt> m_mapped_elem_table;
-
-    //Find hash container
-    HC<Tsrc> * findhc(Tsrc t) const
-    {
-        if (t == Tsrc(0)) { return NULL; }
-        UINT hashv = Hash<Tsrc, HF>::m_hf.get_hash_value(t,
-                                Hash<Tsrc, HF>::m_bucket_size);
-        ASSERT((hashv < Hash<Tsrc, HF>::m_bucket_size),
-                ("hash value must less than bucket size"));
-        HC<Tsrc> * elemhc =
-            (HC<Tsrc>*)HB_member((Hash<Tsrc, HF>::m_bucket[hashv]));
-        if (elemhc != NULL) {
-            while (elemhc != NULL) {
-                ASSERT(HC_val(elemhc) != Tsrc(0),
-                        ("Hash element has so far as to be overrided!"));
-                if (Hash<Tsrc, HF>::m_hf.compare(HC_val(elemhc), t)) {
-                    return elemhc;
-                }
-                elemhc = HC_next(elemhc);
-            } //end while
-        }
-        return NULL;
-    }
 public:
-    HMap(UINT bsize = MAX_SHASH_BUCKET) : Hash<Tsrc, HF>(bsize)
+    HMap(UINT bsize = MAX_SHASH_BUCKET) : HashImpl(bsize)
     { m_mapped_elem_table.init(); }
     COPY_CONSTRUCTOR(HMap);
     virtual ~HMap() { destroy(); }
@@ -4341,24 +5457,21 @@ public:
     //Alway set new mapping even if it has done.
     void setAlways(Tsrc t, Ttgt mapped)
     {
-        ASSERT((Hash<Tsrc, HF>::m_bucket != NULL), ("not yet initialize."));
+        ASSERT(HashImpl::is_init(), ("not yet initialize."));
         if (t == Tsrc(0)) { return; }
-        HC<Tsrc> * elemhc = NULL;
-        Hash<Tsrc, HF>::append(t, &elemhc, NULL);
-        ASSERT(elemhc != NULL, ("Element does not append into hash table."));
-        m_mapped_elem_table.set(HC_vec_idx(elemhc), mapped);
+        m_mapped_elem_table.set(HashImpl::append_elem_idx(t), mapped);
     }
 
-    SMemPool * get_pool() { return Hash<Tsrc, HF>::get_free_list_pool(); }
+    SMemPool * get_pool() { return HashImpl::get_free_list_pool(); }
 
     //Get mapped pointer of 't'
     Ttgt get(Tsrc t, bool * find = NULL)
     {
-        ASSERT((Hash<Tsrc, HF>::m_bucket != NULL), ("not yet initialize."));
-        HC<Tsrc> * elemhc = findhc(t);
-        if (elemhc != NULL) {
+        ASSERT(HashImpl::is_init(), ("not yet initialize."));
+        INT idx = HashImpl::find_elem_idx(t);
+        if (idx >= 0) {
             if (find != NULL) { *find = true; }
-            return m_mapped_elem_table.get(HC_vec_idx(elemhc));
+            return m_mapped_elem_table.get((UINT)idx);
         }
         if (find != NULL) { *find = false; }
         return Ttgt(0);
@@ -4368,28 +5481,28 @@ public:
 
     void clean()
     {
-        ASSERT((Hash<Tsrc, HF>::m_bucket != NULL), ("not yet initialize."));
-        Hash<Tsrc, HF>::clean();
+        ASSERT(HashImpl::is_init(), ("not yet initialize."));
+        HashImpl::clean();
         m_mapped_elem_table.clean();
     }
 
     UINT count_mem() const
     {
         UINT count = m_mapped_elem_table.count_mem();
-        count += ((Hash<Tsrc, HF>*)this)->count_mem();
+        count += (UINT)HashImpl::count_mem();
         return count;
     }
 
     void init(UINT bsize = MAX_SHASH_BUCKET)
     {
-        //Only do initialization while m_bucket is NULL.
-        Hash<Tsrc, HF>::init(bsize);
+        //Only do initialization while hash table is not initialized.
+        HashImpl::init(bsize);
         m_mapped_elem_table.init();
     }
 
     void destroy()
     {
-        Hash<Tsrc, HF>::destroy();
+        HashImpl::destroy();
         m_mapped_elem_table.destroy();
     }
 
@@ -4430,37 +5543,41 @@ public:
     //Establishing mapping in between 't' and 'mapped'.
     void set(Tsrc t, Ttgt mapped)
     {
-        ASSERT((Hash<Tsrc, HF>::m_bucket != NULL), ("not yet initialize."));
+        ASSERT(HashImpl::is_init(), ("not yet initialize."));
         if (t == Tsrc(0)) { return; }
 
-        HC<Tsrc> * elemhc = NULL;
-        Hash<Tsrc, HF>::append(t, &elemhc, NULL);
-
-        ASSERT(elemhc != NULL,
-               ("Element does not append into hash table yet."));
-        ASSERT(Ttgt(0) == m_mapped_elem_table.get(HC_vec_idx(elemhc)),
-               ("Already be mapped"));
-        m_mapped_elem_table.set(HC_vec_idx(elemhc), mapped);
+        UINT idx = HashImpl::append_elem_idx(t);
+        ASSERT(Ttgt(0) == m_mapped_elem_table.get(idx), ("Already be mapped"));
+        m_mapped_elem_table.set(idx, mapped);
     }
 
     void setv(OBJTY v, Ttgt mapped)
     {
-        ASSERT((Hash<Tsrc, HF>::m_bucket != NULL), ("not yet initialize."));
+        ASSERT(HashImpl::is_init(), ("not yet initialize."));
         if (v == 0) { return; }
 
-        HC<Tsrc> * elemhc = NULL;
-        Hash<Tsrc, HF>::append(v, &elemhc, NULL);
-        ASSERT(elemhc != NULL,
-               ("Element does not append into hash table yet."));
-        ASSERT(Ttgt(0) == m_mapped_elem_table.get(HC_vec_idx(elemhc)),
-               ("Already be mapped"));
-        m_mapped_elem_table.set(HC_vec_idx(elemhc), mapped);
+        UINT idx = HashImpl::append_elem_idx(v);
+        ASSERT(Ttgt(0) == m_mapped_elem_table.get(idx), ("Already be mapped"));
+        m_mapped_elem_table.set(idx, mapped);
     }
 };
 //END MAP
 
 
 
+//Unidirectional Hashed Map that holds keys in open addressing table.
+//The usage is the same as HMap.
+template <class Tsrc, class Ttgt, class HF = HashFuncBase<Tsrc> >
+class FlatHMap : public HMap<Tsrc, Ttgt, HF, FlatHash<Tsrc, HF> > {
+public:
+    FlatHMap(UINT bsize = MAX_SHASH_BUCKET) :
+        HMap<Tsrc, Ttgt, HF, FlatHash<Tsrc, HF> >(bsize) {}
+    COPY_CONSTRUCTOR(FlatHMap);
+};
+//END FlatHMap
+
+
+
 //Dual directional Map
 //
 //MAP_Tsrc2Ttgt: class derive from HMap<Tsrc, Ttgt>
@@ -0,0 +1,226 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#include "ltype.h"
+#include "comf.h"
+#include "sthread.h"
+#ifndef _WINDOWS_
+#include "pthread.h"
+#endif
+
+namespace xcom {
+
+#ifndef _WINDOWS_
+//Task queue of each thread, tasks in [lo, hi) are waiting to be performed.
+typedef struct {
+    pthread_mutex_t lock;
+    UINT lo;
+    UINT hi;
+} TaskQueue;
+
+
+typedef struct {
+    TaskQueue * queues;
+    UINT thread_num;
+    UINT tid;
+    ThreadTaskFunc func;
+    void * data;
+} WorkerCtx;
+
+
+//Pop task from the head of queue.
+static bool popTask(TaskQueue * q, OUT UINT & task)
+{
+    bool find = false;
+    pthread_mutex_lock(&q->lock);
+    if (q->lo < q->hi) {
+        task = q->lo++;
+        find = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return find;
+}
+
+
+//Steal task from the tail of queue.
+static bool stealTask(TaskQueue * q, OUT UINT & task)
+{
+    bool find = false;
+    pthread_mutex_lock(&q->lock);
+    if (q->lo < q->hi) {
+        task = --q->hi;
+        find = true;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return find;
+}
+
+
+static void * runWorker(void * arg)
+{
+    WorkerCtx * ctx = (WorkerCtx*)arg;
+    UINT task;
+    for (;;) {
+        if (popTask(&ctx->queues[ctx->tid], task)) {
+            ctx->func(ctx->data, task, ctx->tid);
+            continue;
+        }
+
+        //Own queue is empty, steal from others.
+        bool stolen = false;
+        for (UINT i = 1; i < ctx->thread_num; i++) {
+            UINT victim = (ctx->tid + i) % ctx->thread_num;
+            if (stealTask(&ctx->queues[victim], task)) {
+                stolen = true;
+                break;
+            }
+        }
+        if (!stolen) { break; }
+
+        ctx->func(ctx->data, task, ctx->tid);
+    }
+    return NULL;
+}
+#endif
+
+
+void ThreadPool::run(UINT task_num, ThreadTaskFunc func, void * data)
+{
+    ASSERT0(func);
+    UINT thread_num = MIN(m_thread_num, task_num);
+
+    #ifdef _WINDOWS_
+    //Thread is not supported yet, perform tasks one by one.
+    thread_num = 1;
+    #endif
+
+    if (thread_num <= 1) {
+        for (UINT i = 0; i < task_num; i++) {
+            func(data, i, 0);
+        }
+        return;
+    }
+
+    #ifndef _WINDOWS_
+    TaskQueue * queues = (TaskQueue*)::malloc(sizeof(TaskQueue) * thread_num);
+    WorkerCtx * ctxs = (WorkerCtx*)::malloc(sizeof(WorkerCtx) * thread_num);
+    pthread_t * threads = (pthread_t*)::malloc(sizeof(pthread_t) * thread_num);
+    ASSERT0(queues && ctxs && threads);
+
+    //Distribute tasks evenly.
+    UINT const avg = task_num / thread_num;
+    UINT const rem = task_num % thread_num;
+    UINT lo = 0;
+    for (UINT i = 0; i < thread_num; i++) {
+        pthread_mutex_init(&queues[i].lock, NULL);
+        queues[i].lo = lo;
+        lo += avg + (i < rem ? 1 : 0);
+        queues[i].hi = lo;
+
+        ctxs[i].queues = queues;
+        ctxs[i].thread_num = thread_num;
+        ctxs[i].tid = i;
+        ctxs[i].func = func;
+        ctxs[i].data = data;
+    }
+    ASSERT0(lo == task_num);
+
+    //Calling thread serves as thread 0.
+    UINT created = 1;
+    for (UINT i = 1; i < thread_num; i++, created++) {
+        if (pthread_create(&threads[i], NULL, runWorker, &ctxs[i]) != 0) {
+            //The tasks in queue will be stolen by other threads.
+            break;
+        }
+    }
+    runWorker(&ctxs[0]);
+
+    //Thread 0 may finished early while other threads are still
+    //performing the stolen tasks.
+    for (UINT i = 1; i < created; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    if (created < thread_num) {
+        //Some threads failed to create, perform the rest tasks.
+        runWorker(&ctxs[0]);
+    }
+
+    for (UINT i = 0; i < thread_num; i++) {
+        pthread_mutex_destroy(&queues[i].lock);
+    }
+    ::free(threads);
+    ::free(ctxs);
+    ::free(queues);
+    #endif
+}
+
+
+//
+//START Mutex
+//
+Mutex::Mutex()
+{
+    m_impl = NULL;
+    #ifndef _WINDOWS_
+    pthread_mutex_t * m = (pthread_mutex_t*)::malloc(sizeof(pthread_mutex_t));
+    ASSERT0(m);
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(m, &attr);
+    pthread_mutexattr_destroy(&attr);
+    m_impl = m;
+    #endif
+}
+
+
+Mutex::~Mutex()
+{
+    #ifndef _WINDOWS_
+    pthread_mutex_destroy((pthread_mutex_t*)m_impl);
+    ::free(m_impl);
+    #endif
+}
+
+
+void Mutex::lock()
+{
+    #ifndef _WINDOWS_
+    pthread_mutex_lock((pthread_mutex_t*)m_impl);
+    #endif
+}
+
+
+void Mutex::unlock()
+{
+    #ifndef _WINDOWS_
+    pthread_mutex_unlock((pthread_mutex_t*)m_impl);
+    #endif
+}
+//END Mutex
+
+} //namespace xcom
@@ -0,0 +1,96 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+#ifndef _STHREAD_H_
+#define _STHREAD_H_
+
+namespace xcom {
+
+//Function to perform one task.
+//'data': user defined data.
+//'task': index of task.
+//'tid': index of thread which is performing the task, the calling thread
+//    of ThreadPool::run() is always thread 0.
+typedef void (*ThreadTaskFunc)(void * data, UINT task, UINT tid);
+
+//This class performs a group of independent tasks on several threads.
+//The tasks are distributed evenly to the queue of each thread at first.
+//A thread pops task from the head of its own queue, and steals task
+//from the tail of other queues once its own queue is empty.
+//e.g: Perform 100 tasks by 4 threads.
+//    ThreadPool tp(4);
+//    tp.run(100, func, data);
+class ThreadPool {
+    COPY_CONSTRUCTOR(ThreadPool);
+    UINT m_thread_num;
+public:
+    explicit ThreadPool(UINT thread_num)
+    { m_thread_num = thread_num == 0 ? 1 : thread_num; }
+
+    UINT get_thread_num() const { return m_thread_num; }
+
+    //Perform tasks in range of [0, task_num), and return until all tasks
+    //have been finished.
+    void run(UINT task_num, ThreadTaskFunc func, void * data);
+};
+
+
+//Recursive mutex, the thread that holds the lock may lock it again.
+//NOTE: ThreadPool performs tasks serially on Windows, thus the mutex
+//does nothing on Windows.
+class Mutex {
+    COPY_CONSTRUCTOR(Mutex);
+    void * m_impl;
+public:
+    Mutex();
+    ~Mutex();
+
+    void lock();
+    void unlock();
+};
+
+
+//Lock the mutex in constructor and unlock it in destructor.
+//'m' may be NULL, then nothing to do.
+//e.g: void foo() { MutexHolder h(m_lock); ...access shared data... }
+class MutexHolder {
+    COPY_CONSTRUCTOR(MutexHolder);
+    Mutex * m_mutex;
+public:
+    explicit MutexHolder(Mutex * m)
+    {
+        m_mutex = m;
+        if (m_mutex != NULL) { m_mutex->lock(); }
+    }
+    ~MutexHolder()
+    {
+        if (m_mutex != NULL) { m_mutex->unlock(); }
+    }
+};
+
+} //namespace xcom
+#endif
@@ -56,14 +56,62 @@ UINT g_builtin_num = sizeof(g_builtin_info) / sizeof(g_builtin_info[0]);
 
 
 //Perform Dex register allocation.
-bool g_do_dex_ra = false;
+THREAD_LOCAL bool g_do_dex_ra = false;
+
+//Allocate global lifetimes by linear scan if the number of them is
+//greater than the value, 0 means always use coloring.
+THREAD_LOCAL UINT g_ra_linear_scan_threshold = 2000;
 
 //Set true to collect debug info.
-bool g_collect_debuginfo = false;
-bool g_dump_ir2dex = false;
-bool g_dump_dex2ir = false;
-bool g_dump_classdefs = false;
-bool g_dump_lirs = false;
-bool g_is_pretty_print_method_name = true;
-bool g_dump_dex_file_path = false;
+THREAD_LOCAL bool g_collect_debuginfo = false;
+THREAD_LOCAL bool g_dump_ir2dex = false;
+THREAD_LOCAL bool g_dump_dex2ir = false;
+THREAD_LOCAL bool g_dump_classdefs = false;
+THREAD_LOCAL bool g_dump_lirs = false;
+THREAD_LOCAL bool g_is_pretty_print_method_name = true;
+THREAD_LOCAL bool g_dump_dex_file_path = false;
 bool g_record_region_for_classs = false;
+
+//Number of threads to compile methods, methods will be compiled
+//in parallel if it is greater than 1. In IPA mode, methods are
+//optimized in bottom-up order of call graph with these threads.
+UINT g_thread_num = 1;
+
+//Set true to reuse RegionMgr to compile each method in non-IPA mode,
+//rather than creating a new one for every method.
+//opt/bench/bench_recycle.cpp checks that both ways produce the same IR.
+bool g_recycle_region_mgr = true;
+
+
+//
+//START DexOptionSnapshot
+//
+void DexOptionSnapshot::save()
+{
+    OptionSnapshot::save();
+    do_dex_ra = g_do_dex_ra;
+    ra_linear_scan_threshold = g_ra_linear_scan_threshold;
+    collect_debuginfo = g_collect_debuginfo;
+    dump_ir2dex = g_dump_ir2dex;
+    dump_dex2ir = g_dump_dex2ir;
+    dump_classdefs = g_dump_classdefs;
+    dump_lirs = g_dump_lirs;
+    is_pretty_print_method_name = g_is_pretty_print_method_name;
+    dump_dex_file_path = g_dump_dex_file_path;
+}
+
+
+void DexOptionSnapshot::restore() const
+{
+    OptionSnapshot::restore();
+    g_do_dex_ra = do_dex_ra;
+    g_ra_linear_scan_threshold = ra_linear_scan_threshold;
+    g_collect_debuginfo = collect_debuginfo;
+    g_dump_ir2dex = dump_ir2dex;
+    g_dump_dex2ir = dump_dex2ir;
+    g_dump_classdefs = dump_classdefs;
+    g_dump_lirs = dump_lirs;
+    g_is_pretty_print_method_name = is_pretty_print_method_name;
+    g_dump_dex_file_path = dump_dex_file_path;
+}
+//END DexOptionSnapshot
@@ -314,15 +314,48 @@ public:
 };
 
 //Perform Dex register allocation.
-extern bool g_do_dex_ra;
+extern THREAD_LOCAL bool g_do_dex_ra;
+
+//Allocate global lifetimes by linear scan if the number of them is
+//greater than the value, 0 means always use coloring.
+extern THREAD_LOCAL UINT g_ra_linear_scan_threshold;
 
 //Set true to collect debug info.
-extern bool g_collect_debuginfo;
-extern bool g_dump_ir2dex;
-extern bool g_dump_dex2ir;
-extern bool g_dump_classdefs;
-extern bool g_dump_lirs;
-extern bool g_is_pretty_print_method_name;
-extern bool g_dump_dex_file_path;
+extern THREAD_LOCAL bool g_collect_debuginfo;
+extern THREAD_LOCAL bool g_dump_ir2dex;
+extern THREAD_LOCAL bool g_dump_dex2ir;
+extern THREAD_LOCAL bool g_dump_classdefs;
+extern THREAD_LOCAL bool g_dump_lirs;
+extern THREAD_LOCAL bool g_is_pretty_print_method_name;
+extern THREAD_LOCAL bool g_dump_dex_file_path;
 extern bool g_record_region_for_classs;
+
+//Number of threads to compile methods, or to optimize methods in
+//bottom-up order of call graph in IPA mode.
+extern UINT g_thread_num;
+
+//Set true to reuse RegionMgr for each method in non-IPA mode.
+extern bool g_recycle_region_mgr;
+
+//This class records the value of thread local options of optimizer
+//and DEX, it is used to propagate the options of main thread to
+//compilation thread.
+class DexOptionSnapshot : public OptionSnapshot {
+public:
+    bool do_dex_ra;
+    UINT ra_linear_scan_threshold;
+    bool collect_debuginfo;
+    bool dump_ir2dex;
+    bool dump_dex2ir;
+    bool dump_classdefs;
+    bool dump_lirs;
+    bool is_pretty_print_method_name;
+    bool dump_dex_file_path;
+
+public:
+    DexOptionSnapshot() { save(); }
+
+    void save();
+    void restore() const;
+};
 #endif
@@ -59,6 +59,10 @@ static void usage()
             "\n  -o <file>       refer to output dex file path"
             "\n  -dump <file>    refer to dump file path"
             "\n  -silence        if it is set, dexpro will not display any auxiliary informations to screen"
+            "\n  -j <num>        compile methods with <num> threads, in IPA mode methods are optimized in bottom-up order of call graph with <num> threads"
+            "\n  -norecycle      create a new region manager for each method rather than reusing one"
+            "\n  -ipa            compile methods in IPA mode"
+            "\n  -ra_lscan <num> allocate register by linear scan for methods with more than <num> global lifetimes, 0 means never"
             "\n", g_version);
 }
 
@@ -134,6 +138,37 @@ static bool process_o(UINT argc, CHAR const* argv[], IN OUT UINT & i)
 }
 
 
+//Return true if command line is valid, otherwise return false.
+static bool process_j(UINT argc, CHAR const* argv[], IN OUT UINT & i)
+{
+    CHAR const* num = NULL;
+    if (i + 1 < argc && argv[i + 1] != NULL) {
+        num = argv[i + 1];
+    }
+    i += 2;
+    if (num == NULL || !xcom::xisdigit(num[0])) { return false; }
+
+    g_thread_num = (UINT)xcom::xatoll(num, false);
+    if (g_thread_num == 0) { return false; }
+    return true;
+}
+
+
+//Return true if command line is valid, otherwise return false.
+static bool process_ra_lscan(UINT argc, CHAR const* argv[], IN OUT UINT & i)
+{
+    CHAR const* num = NULL;
+    if (i + 1 < argc && argv[i + 1] != NULL) {
+        num = argv[i + 1];
+    }
+    i += 2;
+    if (num == NULL || !xcom::xisdigit(num[0])) { return false; }
+
+    g_ra_linear_scan_threshold = (UINT)xcom::xatoll(num, false);
+    return true;
+}
+
+
 bool processCommandLine(UINT argc, CHAR const* argv[])
 {
     if (argc <= 1) { usage(); return false; }
@@ -149,6 +184,22 @@ bool processCommandLine(UINT argc, CHAR const* argv[])
                     usage();
                     return false;
                 }
+            } else if (strcmp(cmdstr, "j") == 0) {
+                if (!process_j(argc, argv, i)) {
+                    usage();
+                    return false;
+                }
+            } else if (strcmp(cmdstr, "norecycle") == 0) {
+                g_recycle_region_mgr = false;
+                i++;
+            } else if (strcmp(cmdstr, "ipa") == 0) {
+                g_do_ipa = true;
+                i++;
+            } else if (strcmp(cmdstr, "ra_lscan") == 0) {
+                if (!process_ra_lscan(argc, argv, i)) {
+                    usage();
+                    return false;
+                }
             } else if (strcmp(cmdstr, "silence") == 0) {
                 if (!process_silence(argc, argv, i)) {
                     usage();
@@ -55,7 +55,10 @@ author: GongKai, JinYue, Su Zhenyu
 #include "gra.h"
 #include "dex_hook.h"
 #include "dex_util.h"
+#include "dex_driver.h"
 #include "drcode.h"
+#include "drAlloc.h"
+#include "sthread.h"
 
 UInt32 gdb_compute_dataSize(D2Dpool* pool)
 {
@@ -145,13 +148,63 @@ static void copyFields(D2Dpool* pool, const DexClassData* pClassData)
     }
 }
 
+//Record the compiled result of method in parallel mode or IPA mode.
+typedef struct {
+    DexMethod method;
+    const DexClassDef* classDef;
+    CBSHandle cbsCode;
+    DexCode nCode;
+    DexFuncInfo* funcInfo; //method converted to IR in IPA mode.
+} CompiledMethod;
+
+
+//Record all methods which are compiled in parallel or in IPA mode, in
+//the order of emission.
+typedef struct {
+    DexFile* pDexFile;
+    D2Dpool* pool;
+    DexOptionSnapshot const* options;
+    CompiledMethod* methods;
+    UInt32 methodNum;
+    UInt32 cur; //next method to emit.
+    RegionMgr** rumgrs; //recycled RegionMgr of each thread.
+} CompiledMethodList;
+
+
+//Transform method to DEX code and write to pool.
+//If method has been compiled in parallel, emit it directly.
+static void transformMethod(
+        D2Dpool* pool,
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        const DexClassDef* pClassDef,
+        RegionMgr* rumgr,
+        List<DexRegion const*> * rulist,
+        CompiledMethodList* cml)
+{
+    if (cml == NULL) {
+        d2rMethod(pool, pDexFile, pDexMethod, pClassDef, rumgr, rulist);
+        return;
+    }
+
+    ASSERT0(cml->cur < cml->methodNum);
+    CompiledMethod* cm = &cml->methods[cml->cur];
+    ASSERT0(cm->method.methodIdx == pDexMethod->methodIdx &&
+            cm->classDef == pClassDef);
+    d2rEmitMethod(pool, cm->cbsCode, &cm->nCode);
+    cm->cbsCode = NULL; //Code buffer has been destroied by emitter.
+    cml->cur++;
+}
+
+
 static void copyAndTransformMethod(
          D2Dpool* pool,
          DexFile* pDexFile,
          const DexMethod* pDexMethod,
          const DexClassData* pClassData,
          const DexClassDef* pClassDef,
-         RegionMgr* rumgr)
+         RegionMgr* rumgr,
+         CompiledMethodList* cml)
 {
     UInt32 methodIdx;
     List<DexRegion const*> rulist;
@@ -159,8 +212,9 @@ static void copyAndTransformMethod(
         pDexMethod = pClassData->directMethods + i;
 
         if (pDexMethod->codeOff != 0) {
-            d2rMethod(pool, pDexFile, pDexMethod, pClassDef, rumgr,
-                      g_record_region_for_classs ? &rulist : NULL);
+            transformMethod(pool, pDexFile, pDexMethod, pClassDef, rumgr,
+                            g_record_region_for_classs ? &rulist : NULL,
+                            cml);
         } else {
             pool->codeOff = 0;
         }
@@ -185,8 +239,9 @@ static void copyAndTransformMethod(
         pDexMethod = pClassData->virtualMethods + i;
 
         if (pDexMethod->codeOff != 0) {
-            d2rMethod(pool, pDexFile, pDexMethod, pClassDef, rumgr,
-                      g_record_region_for_classs ? &rulist : NULL);
+            transformMethod(pool, pDexFile, pDexMethod, pClassDef, rumgr,
+                            g_record_region_for_classs ? &rulist : NULL,
+                            cml);
         } else {
             pool->codeOff = 0;
         }
@@ -210,7 +265,8 @@ static void convertClassData(
         DexFile* pDexFile,
         D2Dpool* pool,
         const DexClassDef* pDexClassDef,
-        RegionMgr* rumgr)
+        RegionMgr* rumgr,
+        CompiledMethodList* cml)
 {
     const BYTE* pEncodedData = NULL;
     const DexClassData* pClassData = NULL;
@@ -244,7 +300,8 @@ static void convertClassData(
         pDexMethod,
         pClassData,
         pDexClassDef,
-        rumgr);
+        rumgr,
+        cml);
 }
 
 static D2Dpool* poolInfoInit()
@@ -805,6 +862,184 @@ static void copyClassData(D2Dpool* pool)
     return;
 }
 
+//Compile a method on a thread of ThreadPool.
+static void compileMethodTask(void * data, UINT task, UINT tid)
+{
+    CompiledMethodList* cml = (CompiledMethodList*)data;
+    ASSERT0(task < cml->methodNum);
+    CompiledMethod* cm = &cml->methods[task];
+
+    //Options of optimizer are thread local, propagate the value of
+    //main thread to current thread. Note compileFunc() might
+    //modify options, so restore them for each method.
+    cml->options->restore();
+
+    //Dump file is only accessed by main thread.
+    if (tid != 0) { g_tfile = NULL; }
+
+    RegionMgr* rumgr = NULL;
+    if (cml->rumgrs != NULL) {
+        if (cml->rumgrs[tid] == NULL) {
+            cml->rumgrs[tid] = createRecycledRegionMgr();
+        }
+        rumgr = cml->rumgrs[tid];
+    }
+
+    cm->cbsCode = d2rCompileMethod(cml->pool, cml->pDexFile, &cm->method,
+                                   cm->classDef, rumgr, NULL, &cm->nCode);
+}
+
+
+//Collect methods in the order of emission.
+//Return the number of methods which have code.
+static UInt32 collectMethod(DexFile* pDexFile, CompiledMethod* methods)
+{
+    UInt32 num = 0;
+    UInt32 clsNumber = pDexFile->pHeader->classDefsSize;
+    for (UInt32 i = 0; i < clsNumber; i++) {
+        const DexClassDef* pDexClassDef = dexGetClassDef(pDexFile, i);
+        if (pDexClassDef->classDataOff == 0) { continue; }
+
+        const BYTE* pEncodedData = dexGetClassData(pDexFile, pDexClassDef);
+        DexClassData* pClassData = dexReadAndVerifyClassData(
+            &pEncodedData, NULL);
+        ASSERT0(pClassData);
+
+        UInt32 n = pClassData->header.directMethodsSize +
+                   pClassData->header.virtualMethodsSize;
+        for (UInt32 j = 0; j < n; j++) {
+            DexMethod const* m =
+                j < pClassData->header.directMethodsSize ?
+                pClassData->directMethods + j :
+                pClassData->virtualMethods +
+                    (j - pClassData->header.directMethodsSize);
+            if (m->codeOff == 0) { continue; }
+            if (methods != NULL) {
+                CompiledMethod* cm = &methods[num];
+                cm->method = *m;
+                cm->classDef = pDexClassDef;
+                cm->cbsCode = NULL;
+                cm->funcInfo = NULL;
+            }
+            num++;
+        }
+        free(pClassData);
+    }
+    return num;
+}
+
+
+//Compile all methods with 'g_thread_num' threads.
+//The compiled code will be emitted in original order of methods,
+//thus the output is identical to serial compilation.
+static void compileMethodInParallel(
+        DexFile* pDexFile,
+        D2Dpool* pool,
+        DexOptionSnapshot const* options,
+        OUT CompiledMethodList* cml)
+{
+    memset(cml, 0, sizeof(CompiledMethodList));
+    cml->pDexFile = pDexFile;
+    cml->pool = pool;
+    cml->options = options;
+    cml->methodNum = collectMethod(pDexFile, NULL);
+    if (cml->methodNum == 0) { return; }
+
+    cml->methods = (CompiledMethod*)malloc(
+        sizeof(CompiledMethod) * cml->methodNum);
+    ASSERT0(cml->methods);
+    UInt32 n = collectMethod(pDexFile, cml->methods);
+    ASSERT0(n == cml->methodNum);
+    UNUSED(n);
+
+    if (g_recycle_region_mgr) {
+        cml->rumgrs = (RegionMgr**)malloc(sizeof(RegionMgr*) * g_thread_num);
+        ASSERT0(cml->rumgrs);
+        memset(cml->rumgrs, 0, sizeof(RegionMgr*) * g_thread_num);
+    }
+
+    START_TIMER_FMT_AFTER();
+    ThreadPool tp(g_thread_num);
+    tp.run(cml->methodNum, compileMethodTask, cml);
+    END_TIMER_FMT_AFTER(("Compile %u Methods With %u Threads",
+                         cml->methodNum, g_thread_num));
+}
+
+
+//Compile all methods in IPA mode. Methods are converted to IR in the
+//order of emission, then optimized in bottom-up order of call graph
+//with 'g_thread_num' threads, and transformed to DEX code at last.
+//The output does not depend on the number of threads.
+static void compileMethodInIPAMode(
+        DexFile* pDexFile,
+        D2Dpool* pool,
+        DexRegionMgr* rumgr,
+        Region* topru,
+        OUT CompiledMethodList* cml)
+{
+    memset(cml, 0, sizeof(CompiledMethodList));
+    cml->pDexFile = pDexFile;
+    cml->pool = pool;
+    cml->methodNum = collectMethod(pDexFile, NULL);
+    if (cml->methodNum != 0) {
+        cml->methods = (CompiledMethod*)malloc(
+            sizeof(CompiledMethod) * cml->methodNum);
+        ASSERT0(cml->methods);
+        UInt32 n = collectMethod(pDexFile, cml->methods);
+        ASSERT0(n == cml->methodNum);
+        UNUSED(n);
+    }
+
+    for (UInt32 i = 0; i < cml->methodNum; i++) {
+        CompiledMethod* cm = &cml->methods[i];
+        cm->funcInfo = d2rConvertMethod(pDexFile, &cm->method,
+                                        cm->classDef, rumgr);
+    }
+
+    START_TIMER_FMT_AFTER();
+    bool s = rumgr->processProgramRegion(topru);
+    ASSERT0(s);
+    UNUSED(s);
+    END_TIMER_FMT_AFTER(("Optimize %u Methods With %u Threads",
+                         cml->methodNum, g_thread_num));
+
+    for (UInt32 i = 0; i < cml->methodNum; i++) {
+        CompiledMethod* cm = &cml->methods[i];
+        cm->cbsCode = d2rFinishMethod(pDexFile, &cm->method,
+                                      cm->funcInfo, &cm->nCode);
+        cm->funcInfo = NULL;
+    }
+
+    if (cml->methodNum != 0) {
+        //LIR of all methods are allocated by linear pool.
+        drLinearFree();
+    }
+}
+
+
+static void destroyCompiledMethodList(CompiledMethodList* cml)
+{
+    ASSERT0(cml->cur == cml->methodNum);
+    for (UInt32 i = 0; i < cml->methodNum; i++) {
+        if (cml->methods[i].cbsCode != NULL) {
+            cbsDestroy(cml->methods[i].cbsCode);
+        }
+    }
+    if (cml->methods != NULL) {
+        free(cml->methods);
+    }
+    if (cml->rumgrs != NULL) {
+        for (UInt32 i = 0; i < g_thread_num; i++) {
+            if (cml->rumgrs[i] != NULL) {
+                delete cml->rumgrs[i];
+            }
+        }
+        free(cml->rumgrs);
+    }
+    memset(cml, 0, sizeof(CompiledMethodList));
+}
+
+
 static void processClass(DexFile* pDexFile, D2Dpool* pool)
 {
     const DexClassDef* pDexClassDef;
@@ -834,6 +1069,25 @@ static void processClass(DexFile* pDexFile, D2Dpool* pool)
                            VAR_GLOBAL|VAR_FAKE));
     }
 
+    CompiledMethodList compiledMethods;
+    CompiledMethodList* cml = NULL;
+    if (g_do_ipa) {
+        //Optimize methods in bottom-up order of call graph, then emit
+        //the code in original order.
+        compileMethodInIPAMode(pDexFile, pool, rumgr, topru,
+                               &compiledMethods);
+        cml = &compiledMethods;
+    } else if (g_thread_num > 1 && !g_record_region_for_classs) {
+        //Methods are independent if there is no IPA, compile them in
+        //parallel, then emit the code in original order.
+        DexOptionSnapshot options;
+        compileMethodInParallel(pDexFile, pool, &options, &compiledMethods);
+        cml = &compiledMethods;
+    } else if (g_recycle_region_mgr) {
+        //Reuse RegionMgr for each method.
+        rumgr = (DexRegionMgr*)createRecycledRegionMgr();
+    }
+
     for (UInt32 i = 0; i < clsNumber; i++) {
         pDexClassDef = dexGetClassDef(pDexFile, i);
 
@@ -845,13 +1099,15 @@ static void processClass(DexFile* pDexFile, D2Dpool* pool)
 
         //printf("%s\n", dexGetClassDescriptor(pDexFile, pDexClassDef));
 
-        convertClassData(pDexFile, pool, pDexClassDef, rumgr);
+        convertClassData(pDexFile, pool, pDexClassDef, rumgr, cml);
         size++;
     }
 
-    if (g_do_ipa) {
-        bool s = rumgr->processProgramRegion(topru);
-        ASSERT0(s);
+    if (cml != NULL) {
+        destroyCompiledMethodList(cml);
+    }
+
+    if (rumgr != NULL) {
         delete rumgr;
     }
 
@@ -2214,14 +2214,25 @@ void lir2dexCode_orig(D2Dpool* pool, const DexCode* pCode, LIRCode* code)
     return;
 }
 
+//Transform LIR to DEX code without writing it to pool.
+//The header of code item is recorded in 'nCode'.
+CBSHandle lir2dexCodeBuf(const DexCode* dexCode, LIRCode* lircode,
+                         DexCode* nCode)
+{
+    memset(nCode, 0, sizeof(DexCode));
+    CBSHandle cbsCode = transformCode(lircode, nCode);
+    nCode->outsSize = dexCode->outsSize;
+    nCode->debugInfoOff = dexCode->debugInfoOff;
+    return cbsCode;
+}
+
 void lir2dexCode(D2Dpool* pool, const DexCode* dexCode, LIRCode* lircode)
 {
     DexCode x;
-    memset(&x, 0, sizeof(DexCode));
-    CBSHandle cbsCode = transformCode(lircode, &x);
+    CBSHandle cbsCode = lir2dexCodeBuf(dexCode, lircode, &x);
     writeCodeItem(pool, cbsCode, x.registersSize, x.insSize,
-                  dexCode->outsSize, x.triesSize,
-                  dexCode->debugInfoOff, x.insnsSize);
+                  x.outsSize, x.triesSize,
+                  x.debugInfoOff, x.insnsSize);
     return;
 }
 
@@ -143,6 +143,8 @@ extern "C" {
    void writeSignedLeb128ToCbs(CBSHandle handle, Int32 data);
    Int32 writeUnSignedLeb128ToCbs(CBSHandle handle, UInt32 data);
    void lir2dexCode(D2Dpool* pool, const DexCode* dexCode, LIRCode* lircode);
+   CBSHandle lir2dexCodeBuf(const DexCode* dexCode, LIRCode* lircode,
+                            DexCode* nCode);
    void lir2dexCode_orig(D2Dpool* pool, const DexCode* pCode, LIRCode* code);
    UInt32 gdb_compute_dataSize(D2Dpool* pool);
    void alignLbs(CBSHandle lbs);
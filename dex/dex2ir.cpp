@@ -2010,7 +2010,7 @@ void Dex2IR::dump_lir2lab()
 }
 
 
-extern bool g_dd;
+extern THREAD_LOCAL bool g_dd;
 //'succ': return true if convertion is successful.
 IR * Dex2IR::convert(bool * succ)
 {
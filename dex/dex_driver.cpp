@@ -235,7 +235,8 @@ static void updateTryInfo(LIRCode * lircode, Dex2IR & d2ir, IR2Dex & ir2d)
 }
 
 
-static void do_opt(IR * ir_list, DexRegion * func_ru)
+//Record the IR converted from DEX code in region.
+static void addIRList(IR * ir_list, DexRegion * func_ru)
 {
     if (ir_list == NULL) { return; }
 
@@ -253,15 +254,21 @@ static void do_opt(IR * ir_list, DexRegion * func_ru)
     verify_irs(ir_list, NULL, func_ru);
 
     func_ru->addToIRList(ir_list);
+}
+
+
+static void do_opt(DexRegion * func_ru)
+{
+    if (func_ru->get_ir_list() == NULL) { return; }
 
     #if 1
-    bool succ = func_ru->process();
+    OptCtx oc;
+    bool succ = func_ru->get_region_mgr()->processFuncRegion(func_ru, &oc);
     ASSERT0(succ);
     #else
     func_ru->processSimply();
-    #endif
-
     func_ru->addToIRList(func_ru->constructIRlist(true));
+    #endif
 }
 
 
@@ -460,30 +467,65 @@ static void parseDebugInfo(
 }
 
 
-static void handleRegion(
-        IN DexRegion * func_ru,
-        IN DexFile * df,
-        IN OUT LIRCode * lircode,
-        D2Dpool * fupool,
+//Record the objects that DexRegion refers to, from the conversion of
+//DEX code to IR until the region is converted back to LIR.
+class DexFuncInfo {
+    COPY_CONSTRUCTOR(DexFuncInfo);
+public:
+    DexRegion * func_ru;
+    DexFile * df;
+    LIRCode * lircode;
+    SMemPool * dbxpool; //record the all DexDbx data.
+    DbxVec dbxvec;
+    TypeIndexRep tr;
+    Dex2IR * d2ir;
+    Prno2Vreg * prno2v; //Map that records the Prno to Vreg mapping.
+    bool succ; //true if DEX code has been converted to IR.
+
+public:
+    DexFuncInfo(DexRegion * ru, DexFile * f, LIRCode * lc) :
+        dbxvec(LIRC_num_of_op(lc))
+    {
+        func_ru = ru;
+        df = f;
+        lircode = lc;
+        dbxpool = NULL;
+        memset(&tr, 0, sizeof(TypeIndexRep));
+        d2ir = NULL;
+        prno2v = NULL;
+        succ = false;
+    }
+    ~DexFuncInfo()
+    {
+        if (dbxpool != NULL && !g_do_ipa) {
+            smpoolDelete(dbxpool); //delete the pool local used.
+        }
+        if (prno2v != NULL) { delete prno2v; }
+        if (d2ir != NULL) { delete d2ir; }
+    }
+};
+
+
+//Convert DEX code to IR, and record the IR in region.
+static void convertDex2IR(
+        IN OUT DexFuncInfo & fi,
         DexMethod const* dexm,
         DexCode const* dexcode,
         OffsetVec const& offsetvec)
 {
-    DbxVec dbxvec(LIRC_num_of_op(lircode));
-
-    SMemPool * dbxpool = NULL; //record the all DexDbx data.
+    DexRegion * func_ru = fi.func_ru;
     if (g_collect_debuginfo) {
         if (g_do_ipa) {
-            dbxpool = ((DexRegionMgr*)func_ru->get_region_mgr())->get_pool();
+            fi.dbxpool = ((DexRegionMgr*)func_ru->get_region_mgr())->get_pool();
         } else {
-            dbxpool = smpoolCreate(sizeof(DexDbx), MEM_COMM);
+            fi.dbxpool = smpoolCreate(sizeof(DexDbx), MEM_COMM);
         }
 
-        parseDebugInfo(func_ru, df, dexcode, dexm, lircode,
-                       offsetvec, dbxpool, dbxvec);
+        parseDebugInfo(func_ru, fi.df, dexcode, dexm, fi.lircode,
+                       offsetvec, fi.dbxpool, fi.dbxvec);
     }
 
-    TypeIndexRep tr;
+    TypeIndexRep & tr = fi.tr;
     TypeMgr * dm = func_ru->get_type_mgr();
     tr.i8 = dm->getSimplexType(D_I8);
     tr.u8 = dm->getSimplexType(D_U8);
@@ -500,45 +542,55 @@ static void handleRegion(
     tr.array = dm->getPointerType(ARRAY_MC_SIZE);
     func_ru->setTypeIndexRep(&tr);
 
-    Dex2IR d2ir(func_ru, df, lircode, dbxvec);
-    bool succ;
-    IR * ir_list = d2ir.convert(&succ);
+    fi.d2ir = new Dex2IR(func_ru, fi.df, fi.lircode, fi.dbxvec);
+    IR * ir_list = fi.d2ir->convert(&fi.succ);
 
-    //Map that records the Prno to Vreg mapping.
-    Prno2Vreg prno2v(getNearestPowerOf2(
-            d2ir.getPR2Vreg()->get_elem_count() + 1));
+    fi.prno2v = new Prno2Vreg(getNearestPowerOf2(
+            fi.d2ir->getPR2Vreg()->get_elem_count() + 1));
 
-    if (!succ) {
-        goto FIN;
-    }
+    if (!fi.succ) { return; }
 
-    func_ru->setDex2IR(&d2ir);
+    func_ru->setDex2IR(fi.d2ir);
 
-    if (d2ir.hasCatch()) {
+    if (fi.d2ir->hasCatch()) {
         //goto FIN;
     }
 
-    //dump_irs(ir_list, func_ru->get_type_mgr());
-    func_ru->setPrno2Vreg(&prno2v);
+    func_ru->setPrno2Vreg(fi.prno2v);
+    addIRList(ir_list, func_ru);
+}
 
-    #if 1
-    do_opt(ir_list, func_ru);
-    #else
-    LOG("\t\tdo pass test: '%s'", func_ru->get_ru_name());
-    func_ru->addToIRList(ir_list);
-    func_ru->getPrno2Vreg()->clean();
-    func_ru->getPrno2Vreg()->copy(*func_ru->getDex2IR()->getPR2Vreg());
-    #endif
+
+//Convert the optimized region back to LIR.
+static void convertRegion2LIR(DexFuncInfo & fi)
+{
+    if (!fi.succ) { return; }
 
     if (!g_retain_pass_mgr_for_region) {
         //TODO: support convert LIR from IRBB list.
-        convertIR2LIR(func_ru, df, lircode);
+        convertIR2LIR(fi.func_ru, fi.df, fi.lircode);
     }
-FIN:
-    if (dbxpool != NULL && !g_do_ipa) {
-        smpoolDelete(dbxpool); //delete the pool local used.
-    }
-    return;
+}
+
+
+static void handleRegion(
+        IN OUT DexFuncInfo & fi,
+        DexMethod const* dexm,
+        DexCode const* dexcode,
+        OffsetVec const& offsetvec)
+{
+    convertDex2IR(fi, dexm, dexcode, offsetvec);
+    if (!fi.succ) { return; }
+
+    #if 1
+    do_opt(fi.func_ru);
+    #else
+    LOG("\t\tdo pass test: '%s'", fi.func_ru->get_ru_name());
+    fi.func_ru->getPrno2Vreg()->clean();
+    fi.func_ru->getPrno2Vreg()->copy(*fi.func_ru->getDex2IR()->getPR2Vreg());
+    #endif
+
+    convertRegion2LIR(fi);
 }
 
 
@@ -548,7 +600,7 @@ int debug2()
 }
 
 
-static int pcount = 0;
+static THREAD_LOCAL int pcount = 0;
 int xdebug()
 {
     pcount++;
@@ -579,7 +631,7 @@ void logd_fu_param(CHAR const* runame, LIRCode * fu)
 }
 
 
-bool g_dd = false;
+THREAD_LOCAL bool g_dd = false;
 bool is_compile(CHAR const* runame, LIRCode * fu)
 {
     xdebug();
@@ -597,36 +649,28 @@ static void dump_all_method_name(CHAR const* runame)
 }
 
 
-//Optimizer for LIR.
-//Return true if compilation is successful.
-bool compileFunc(
-        IN OUT RegionMgr * rumgr,
-        OUT D2Dpool * fupool,
-        IN LIRCode * lircode,
-        IN DexFile * df,
-        DexMethod const* dexm,
-        DexCode const* dexcode,
-        DexClassDef const* dexclassdef,
-        OffsetVec const& offsetvec,
-        List<DexRegion const*> * rulist)
+//Create a RegionMgr which can be reused to compile each method
+//in non-IPA mode. SymTab, TypeMgr and builtin VARs are kept
+//between methods, whereas VARs, MDs and regions of each method are
+//dropped after compilation.
+//Note caller is responsible for deleting the returned RegionMgr.
+RegionMgr * createRecycledRegionMgr()
 {
-    CHAR tmp[256];
-    CHAR * runame = NULL;
-    CHAR const* classname = get_class_name(df, dexm);
-    CHAR const* funcname = get_func_name(df, dexm);
-    CHAR const* functype = get_func_type(df, dexm);
-    UINT len = strlen(classname) + strlen(funcname) + strlen(functype) + 10;
-
-    if (len < 256) { runame = tmp; }
-    else {
-        runame = (CHAR*)ALLOCA(len);
-        ASSERT0(runame);
-    }
-
-    //Function string is consist of these.
-    assemblyUniqueName(runame, classname, functype, funcname);
+    ASSERT0(!g_do_ipa);
+    DexRegionMgr * rm = new DexRegionMgr();
+    rm->initVarMgr();
+    rm->init();
+    rm->setResetPoint();
+    return rm;
+}
 
 
+//Set options of optimizer and dump for method.
+static void initFuncOption(
+        IN LIRCode * lircode,
+        IN DexFile * df,
+        DexMethod const* dexm)
+{
     g_dump_ir2dex = false;
     g_dump_dex2ir = false;
     g_dump_classdefs = false;
@@ -643,25 +687,39 @@ bool compileFunc(
     if (g_dump_lirs) {
         dump_all_lir(lircode, df, dexm);
     }
+}
 
-    DexRegionMgr * rm = NULL;
-    if (g_do_ipa) {
-        ASSERT0(rumgr);
-        rm = (DexRegionMgr*)rumgr;
-    } else {
-        ASSERT0(rumgr == NULL);
-        rm = new DexRegionMgr();
-        rm->initVarMgr();
-        rm->init();
+
+//Create function region for method 'dexm'.
+static DexRegion * newFuncRegion(
+        IN DexRegionMgr * rm,
+        IN LIRCode * lircode,
+        IN DexFile * df,
+        DexMethod const* dexm,
+        DexClassDef const* dexclassdef)
+{
+    CHAR tmp[256];
+    CHAR * runame = NULL;
+    CHAR const* classname = get_class_name(df, dexm);
+    CHAR const* funcname = get_func_name(df, dexm);
+    CHAR const* functype = get_func_type(df, dexm);
+    UINT len = strlen(classname) + strlen(funcname) + strlen(functype) + 10;
+
+    if (len < 256) { runame = tmp; }
+    else {
+        runame = (CHAR*)ALLOCA(len);
+        ASSERT0(runame);
     }
 
+    //Function string is consist of these.
+    assemblyUniqueName(runame, classname, functype, funcname);
+
     //Generate Program region.
     DexRegion * func_ru = (DexRegion*)rm->newRegion(RU_FUNC);
 
     if (g_do_ipa) {
-        ASSERT0(rumgr);
         //Allocate string buffer for region name used in ipa.
-        CHAR * globalbuf = (CHAR*)((DexRegionMgr*)rumgr)->xmalloc(len);
+        CHAR * globalbuf = (CHAR*)rm->xmalloc(len);
         strcpy(globalbuf, runame);
         runame = globalbuf;
     }
@@ -678,20 +736,69 @@ bool compileFunc(
     DR_funcname(func_ru) = funcname;
     DR_classname(func_ru) = classname;
     DR_functype(func_ru) = functype;
-    handleRegion(func_ru, df, lircode, fupool, dexm, dexcode, offsetvec);
+    return func_ru;
+}
+
+
+//Record function region in the RegionMgr of whole program in IPA mode.
+static void addFuncRegion(IN DexRegionMgr * rm, IN DexRegion * func_ru)
+{
+    ASSERT0(g_do_ipa);
+    Region * program = rm->getProgramRegion();
+    ASSERT0(program);
+    REGION_parent(func_ru) = program;
+    //program->addToIRList(program->buildRegion(func_ru));
+    rm->addToRegionTab(func_ru);
+}
+
+
+//Optimizer for LIR.
+//Return true if compilation is successful.
+//'rumgr': RegionMgr of whole program in IPA mode. In non-IPA mode, it
+//    is either NULL or created by createRecycledRegionMgr().
+bool compileFunc(
+        IN OUT RegionMgr * rumgr,
+        OUT D2Dpool * fupool,
+        IN LIRCode * lircode,
+        IN DexFile * df,
+        DexMethod const* dexm,
+        DexCode const* dexcode,
+        DexClassDef const* dexclassdef,
+        OffsetVec const& offsetvec,
+        List<DexRegion const*> * rulist)
+{
+    initFuncOption(lircode, df, dexm);
 
+    DexRegionMgr * rm = NULL;
     if (g_do_ipa) {
-        Region * program = ((DexRegionMgr*)rumgr)->getProgramRegion();
-        ASSERT0(program);
-        REGION_parent(func_ru) = program;
-        //program->addToIRList(program->buildRegion(func_ru));
-        rm->addToRegionTab(func_ru);
+        ASSERT0(rumgr);
+        rm = (DexRegionMgr*)rumgr;
+    } else if (rumgr != NULL) {
+        //Reuse RegionMgr created by createRecycledRegionMgr().
+        rm = (DexRegionMgr*)rumgr;
+    } else {
+        rm = new DexRegionMgr();
+        rm->initVarMgr();
+        rm->init();
+    }
+
+    DexRegion * func_ru = newFuncRegion(rm, lircode, df, dexm, dexclassdef);
+    DexFuncInfo fi(func_ru, df, lircode);
+    handleRegion(fi, dexm, dexcode, offsetvec);
+
+    if (g_do_ipa) {
+        addFuncRegion(rm, func_ru);
         if (rulist != NULL) {
             //Caller must make sure func_ru will not be destroied before IPA.
             rulist->append_tail(func_ru);
         }
+    } else if (rumgr != NULL) {
+        //Drop VARs, MDs and regions of current method, the RegionMgr
+        //will be reused by next method.
+        //reset() destroys regions recorded after the reset point.
+        rm->addToRegionTab(func_ru);
+        rm->reset();
     } else {
-        ASSERT0(rumgr == NULL);
         rm->deleteRegion(func_ru);
         delete rm;
     }
@@ -701,3 +808,46 @@ bool compileFunc(
     //dump_all_lir(lircode, df, dexm);
     return true;
 }
+
+
+//Convert method to IR in IPA mode. The region is optimized along with
+//other methods in bottom-up order of call graph by
+//DexRegionMgr::processProgramRegion(), then converted back to LIR by
+//finishFunc().
+DexFuncInfo * convertFunc(
+        IN OUT RegionMgr * rumgr,
+        IN LIRCode * lircode,
+        IN DexFile * df,
+        DexMethod const* dexm,
+        DexCode const* dexcode,
+        DexClassDef const* dexclassdef,
+        OffsetVec const& offsetvec)
+{
+    ASSERT0(g_do_ipa && rumgr);
+    initFuncOption(lircode, df, dexm);
+
+    DexRegionMgr * rm = (DexRegionMgr*)rumgr;
+    DexRegion * func_ru = newFuncRegion(rm, lircode, df, dexm, dexclassdef);
+    DexFuncInfo * fi = new DexFuncInfo(func_ru, df, lircode);
+    convertDex2IR(*fi, dexm, dexcode, offsetvec);
+    addFuncRegion(rm, func_ru);
+    return fi;
+}
+
+
+//Convert the region recorded in 'fi' back to LIR, then destroy 'fi'.
+//Return the LIR code of method.
+LIRCode * finishFunc(IN DexFuncInfo * fi)
+{
+    ASSERT0(fi);
+    convertRegion2LIR(*fi);
+    LIRCode * lircode = fi->lircode;
+
+    //Region is destroyed along with RegionMgr, clear the objects
+    //freed here.
+    fi->func_ru->setDex2IR(NULL);
+    fi->func_ru->setPrno2Vreg(NULL);
+    fi->func_ru->setTypeIndexRep(NULL);
+    delete fi;
+    return lircode;
+}
@@ -34,11 +34,14 @@ author: Su Zhenyu
 #ifndef _DEX_DRIVER_H_
 #define _DEX_DRIVER_H_
 
+class DexFuncInfo;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 //Export Functions.
+RegionMgr * createRecycledRegionMgr();
 bool compileFunc(
         RegionMgr * rumgr,
         D2Dpool * pool,
@@ -49,6 +52,15 @@ bool compileFunc(
         DexClassDef const* dexclassdef,
         OffsetVec const& offsetvec,
         List<DexRegion const*> * rulist);
+DexFuncInfo * convertFunc(
+        RegionMgr * rumgr,
+        LIRCode * fu,
+        DexFile * df,
+        DexMethod const* dm,
+        DexCode const* dexcode,
+        DexClassDef const* dexclassdef,
+        OffsetVec const& offsetvec);
+LIRCode * finishFunc(DexFuncInfo * fi);
 
 #ifdef __cplusplus
 }
@@ -204,11 +204,11 @@ void DexRegion::processSimply()
 static void addCatchTypeName(DexRegion * ru)
 {
     Dex2IR * d2ir = ru->getDex2IR();
-    SymTab * symtab = ru->get_region_mgr()->get_sym_tab();
+    RegionMgr * rm = ru->get_region_mgr();
     for (TryInfo * ti = d2ir->getTryInfo(); ti != NULL; ti = ti->next) {
         for (CatchInfo * ci = ti->catch_list; ci != NULL; ci = ci->next) {
             ASSERT0(ci->kindname);
-            symtab->add(ci->kindname);
+            rm->addToSymbolTab(ci->kindname);
         }
     }
 }
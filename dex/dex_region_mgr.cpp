@@ -65,10 +65,29 @@ void DexRegionMgr::initBuiltin()
 }
 
 
+//Optimize function region that has been converted to IR.
+bool DexRegionMgr::processFuncRegion(Region * func, OptCtx *)
+{
+    ASSERT0(func->is_function());
+    DexRegion * ru = (DexRegion*)func;
+    if (ru->get_ir_list() == NULL) { return true; }
+
+    g_indent = 0;
+    bool succ = ru->process();
+    ru->addToIRList(ru->constructIRlist(true));
+    tfree();
+    return succ;
+}
+
+
 bool DexRegionMgr::processProgramRegion(Region * program)
 {
     ASSERT0(program && program->is_program());
 
+    //Optimize function regions in bottom-up order of call graph, the
+    //output is identical for any number of threads.
+    if (!processFuncRegionBottomUp(g_thread_num)) { return false; }
+
     //Function region has been handled. And call list should be available.
     OptCtx oc;
     buildCallGraph(oc, false, false);
@@ -81,6 +81,7 @@ public:
         return p;
     }
 
+    virtual bool processFuncRegion(IN Region * func, OptCtx * oc);
     virtual bool processProgramRegion(Region * program);
 };
 
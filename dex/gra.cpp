@@ -1511,6 +1511,75 @@ void GIG::set_interf_with(UINT gltid, List<UINT> & lst)
 
 
 void GIG::build()
+{
+    Vector<GLT*> * pr2glt = m_gltm->get_pr2glt_map();
+    INT n = pr2glt->get_last_idx();
+    if (n < 0) { return; }
+
+    //Distribute GLT into the BBs that it lives through.
+    Vector<Vector<UINT>*> bb2glt;
+    for (INT i = 0; i <= n; i++) {
+        GLT * g = pr2glt->get(i);
+        if (g == NULL || GLT_bbs(g) == NULL) { continue; }
+        DefDBitSetCore * bbs = GLT_bbs(g);
+        SEGIter * sc = NULL;
+        for (INT b = bbs->get_first(&sc); b >= 0; b = bbs->get_next(b, &sc)) {
+            Vector<UINT> * gv = bb2glt.get(b);
+            if (gv == NULL) {
+                gv = new Vector<UINT>();
+                bb2glt.set(b, gv);
+            }
+            gv->set(gv->get_last_idx() + 1, i);
+        }
+    }
+
+    //GLTs interfere if they live through same BB, or if the
+    //local lifetimes of them in that BB are overlapped.
+    InterfBuilder ib(n + 1);
+    for (INT b = 0; b <= bb2glt.get_last_idx(); b++) {
+        Vector<UINT> * gv = bb2glt.get(b);
+        if (gv == NULL) { continue; }
+        INT gn = gv->get_last_idx();
+        if (!m_is_consider_local_interf) {
+            for (INT i = 0; i <= gn; i++) {
+                for (INT j = i + 1; j <= gn; j++) {
+                    ib.addPair(gv->get(i), gv->get(j));
+                }
+            }
+            delete gv;
+            continue;
+        }
+
+        IRBB * bb = m_cfg->get_bb(b);
+        ASSERT0(bb != NULL);
+        LTMgr * ltmgr = m_gltm->map_bb2ltm(bb);
+        for (INT i = 0; i <= gn; i++) {
+            UINT idx = gv->get(i);
+            LT * lt = ltmgr->map_pr2lt(GLT_prno(pr2glt->get(idx)));
+            ASSERT0(lt != NULL);
+            if (LT_range(lt) != NULL) {
+                ib.addRange(idx, LT_range(lt));
+            }
+        }
+        ib.sweep();
+        delete gv;
+    }
+
+    //Add vertex and edge in the same order as buildByPairwise().
+    Vector<UINT> adj;
+    for (INT i = 0; i <= n; i++) {
+        GLT * g = pr2glt->get(i);
+        if (g == NULL) { continue; }
+        addVertex(GLT_id(g));
+        UINT an = ib.get_adj(i, adj);
+        for (UINT j = 0; j < an; j++) {
+            addEdge(GLT_id(g), GLT_id(pr2glt->get(adj.get(j))));
+        }
+    }
+}
+
+
+void GIG::buildByPairwise()
 {
     //Check interference
     Vector<GLT*> * pr2glt = m_gltm->get_pr2glt_map();
@@ -1531,6 +1600,150 @@ void GIG::build()
 //END GIG
 
 
+//
+//START InterfBuilder
+//
+static int compareLiveSeg(void const* p1, void const* p2)
+{
+    LiveSeg const* s1 = (LiveSeg const*)p1;
+    LiveSeg const* s2 = (LiveSeg const*)p2;
+    if (s1->start != s2->start) {
+        return s1->start < s2->start ? -1 : 1;
+    }
+    if (s1->idx != s2->idx) {
+        return s1->idx < s2->idx ? -1 : 1;
+    }
+    return 0;
+}
+
+
+static int compareUINT(void const* p1, void const* p2)
+{
+    UINT u1 = *(UINT const*)p1;
+    UINT u2 = *(UINT const*)p2;
+    return u1 < u2 ? -1 : (u1 > u2 ? 1 : 0);
+}
+
+
+InterfBuilder::InterfBuilder(UINT num)
+{
+    m_num = num;
+    m_mat = NULL;
+    if (num <= INTF_MATRIX_LIMIT) {
+        m_mat = new BitSet((num * num + BITS_PER_BYTE - 1) / BITS_PER_BYTE);
+    }
+}
+
+
+InterfBuilder::~InterfBuilder()
+{
+    if (m_mat != NULL) {
+        delete m_mat;
+    }
+    for (INT i = 0; i <= m_adj.get_last_idx(); i++) {
+        Vector<UINT> * a = m_adj.get(i);
+        if (a != NULL) {
+            delete a;
+        }
+    }
+}
+
+
+void InterfBuilder::addPair(UINT i, UINT j)
+{
+    ASSERT0(i < m_num && j < m_num && i != j);
+    if (i > j) {
+        UINT t = i;
+        i = j;
+        j = t;
+    }
+    if (m_mat != NULL) {
+        m_mat->bunion(i * m_num + j);
+        return;
+    }
+    Vector<UINT> * a = m_adj.get(i);
+    if (a == NULL) {
+        a = new Vector<UINT>();
+        m_adj.set(i, a);
+    }
+    //Duplicated index will be removed in get_adj().
+    a->set(a->get_last_idx() + 1, j);
+}
+
+
+void InterfBuilder::addRange(UINT idx, BitSet const* range)
+{
+    ASSERT0(range && idx < m_num);
+    INT start = range->get_first();
+    INT last = start;
+    if (start < 0) { return; }
+    for (INT pos = range->get_next(start);
+         pos >= 0; pos = range->get_next(pos)) {
+        if (pos == last + 1) {
+            last = pos;
+            continue;
+        }
+        m_segs.append(start, last, idx);
+        start = last = pos;
+    }
+    m_segs.append(start, last, idx);
+}
+
+
+void InterfBuilder::sweep()
+{
+    if (m_segs.get_elem_count() == 0) { return; }
+    m_segs.sort(compareLiveSeg);
+
+    //'m_active' holds the segments that start before current one, and
+    //drops the segment once it ends before current one starts.
+    INT an = -1;
+    for (UINT i = 0; i < m_segs.get_elem_count(); i++) {
+        LiveSeg const* cur = &m_segs.get(i);
+        INT k = 0;
+        for (INT j = 0; j <= an; j++) {
+            LiveSeg const* s = &m_segs.get(m_active.get(j));
+            if (s->end < cur->start) { continue; }
+            if (s->idx != cur->idx) {
+                addPair(s->idx, cur->idx);
+            }
+            m_active.set(k++, m_active.get(j));
+        }
+        m_active.set(k, i);
+        an = k;
+    }
+    m_segs.clean();
+}
+
+
+UINT InterfBuilder::get_adj(UINT idx, OUT Vector<UINT> & adj)
+{
+    ASSERT0(idx < m_num);
+    UINT n = 0;
+    if (m_mat != NULL) {
+        //Do not use get_next(), it may scan through the empty rows.
+        UINT row = idx * m_num;
+        for (UINT j = idx + 1; j < m_num; j++) {
+            if (m_mat->is_contain(row + j)) {
+                adj.set(n++, j);
+            }
+        }
+        return n;
+    }
+
+    Vector<UINT> * a = m_adj.get(idx);
+    if (a == NULL) { return 0; }
+    UINT an = a->get_last_idx() + 1;
+    ::qsort(a->get_vec(), an, sizeof(UINT), compareUINT);
+    for (UINT i = 0; i < an; i++) {
+        if (n > 0 && adj.get(n - 1) == a->get(i)) { continue; }
+        adj.set(n++, a->get(i));
+    }
+    return n;
+}
+//END InterfBuilder
+
+
 //
 //START IG
 //
@@ -1548,6 +1761,35 @@ bool IG::is_interf(LT const* lt1, LT const* lt2) const
 
 
 void IG::build()
+{
+    ASSERT0(m_ltm);
+    Vector<LT*> * vec = m_ltm->get_lt_vec();
+    INT n = vec->get_last_idx();
+    if (n < 1) { return; }
+
+    InterfBuilder ib(n + 1);
+    for (INT i = 1; i <= n; i++) {
+        LT const* lt = vec->get(i);
+        if (lt == NULL || LT_range(lt) == NULL) { continue; }
+        ib.addRange(i, LT_range(lt));
+    }
+    ib.sweep();
+
+    //Add vertex and edge in the same order as buildByPairwise().
+    Vector<UINT> adj;
+    for (INT i = 1; i <= n; i++) {
+        LT const* lt = vec->get(i);
+        if (lt == NULL) { continue; }
+        addVertex(LT_uid(lt));
+        UINT an = ib.get_adj(i, adj);
+        for (UINT j = 0; j < an; j++) {
+            addEdge(LT_uid(lt), LT_uid(vec->get(adj.get(j))));
+        }
+    }
+}
+
+
+void IG::buildByPairwise()
 {
     ASSERT0(m_ltm);
     Vector<LT*> * vec = m_ltm->get_lt_vec();
@@ -1706,6 +1948,7 @@ NOTICE:
     2. position in LT should be updated. */
 IR * LTMgr::genSpill(LT * lt, INT pos)
 {
+    m_ra->m_num_spill++;
     IR * spill_loc = m_ru->buildPR(m_tm->getSimplexType(D_I32));
     IR * ltpr = m_ru->buildPR(m_tm->getSimplexType(D_I32));
     PR_no(ltpr) = LT_prno(lt);
@@ -1780,6 +2023,7 @@ e.g: pr1 = pr2 + 3
 IR * LTMgr::genSpill(UINT prno, Type const* type, IR * marker, IR * spill_loc)
 {
     ASSERT0(prno > 0 && type && marker && marker->is_stmt());
+    m_ra->m_num_spill++;
     if (spill_loc == NULL) {
         spill_loc = m_ru->buildPR(type);
     }
@@ -1808,6 +2052,7 @@ NOTICE:
     Each reloads are executed unconditionally. */
 IR * LTMgr::genReload(LT * lt, INT pos, IR * spill_loc)
 {
+    m_ra->m_num_reload++;
     IR * ltpr = m_ru->buildPR(IR_dt(spill_loc));
     if (LT_is_global(lt)) {
         //Keep original PR unchanged.
@@ -1854,6 +2099,7 @@ IR * LTMgr::genReload(IR * newpr, IR * marker, IR * spill_loc)
 {
     ASSERT0(newpr && newpr->is_pr() &&
              marker && spill_loc && spill_loc->is_pr());
+    m_ra->m_num_reload++;
     IR * reload = m_ru->buildStorePR(PR_no(newpr), IR_dt(newpr),
                                        m_ru->dupIR(spill_loc));
     m_ra->m_rsc.comp_ir_fmt(reload);
@@ -4154,7 +4400,252 @@ bool BBRA::perform(List<LT*> & prios)
 //END BBRA
 
 
-static int gcount = 0;
+//
+//START LSRA
+//
+//Sort fixed intervals by register, then by start position.
+static int compareFixedSeg(void const* p1, void const* p2)
+{
+    LiveSeg const* s1 = (LiveSeg const*)p1;
+    LiveSeg const* s2 = (LiveSeg const*)p2;
+    if (s1->idx != s2->idx) {
+        return s1->idx < s2->idx ? -1 : 1;
+    }
+    if (s1->start != s2->start) {
+        return s1->start < s2->start ? -1 : 1;
+    }
+    return 0;
+}
+
+
+LSRA::LSRA(RA * ra)
+{
+    ASSERT0(ra);
+    m_ra = ra;
+    m_gltm = &ra->m_gltm;
+    m_ru = ra->m_ru;
+}
+
+
+//Lay out positions of BB in the order of BB list.
+void LSRA::computeLinearOrder()
+{
+    UINT base = 0;
+    BBList * bbl = m_ru->get_bb_list();
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        m_bb2base.set(BB_id(bb), base);
+        LTMgr * ltm = m_gltm->get_ltm(BB_id(bb));
+        if (ltm == NULL) { continue; }
+        base += ltm->get_last_pos() + 1;
+    }
+}
+
+
+//Compute the interval that covers all local parts of 'g'.
+//Return false if 'g' does not live in any position.
+bool LSRA::computeInterval(GLT const* g, OUT UINT & start, OUT UINT & end)
+{
+    DefDBitSetCore * bbs = GLT_bbs(g);
+    if (bbs == NULL) { return false; }
+
+    bool find = false;
+    SEGIter * sc = NULL;
+    for (INT j = bbs->get_first(&sc); j >= 0; j = bbs->get_next(j, &sc)) {
+        LTMgr * ltm = m_gltm->get_ltm(j);
+        if (ltm == NULL) { continue; }
+        LT * gl = ltm->map_pr2lt(GLT_prno(g));
+        ASSERT0(gl); //glt miss local part.
+        if (LT_range(gl) == NULL) { continue; }
+        INT first = LT_range(gl)->get_first();
+        if (first < 0) { continue; }
+
+        UINT base = m_bb2base.get(j);
+        UINT s = base + first;
+        UINT e = base + LT_range(gl)->get_last();
+        if (!find) {
+            start = s;
+            end = e;
+            find = true;
+            continue;
+        }
+        start = MIN(start, s);
+        end = MAX(end, e);
+    }
+    return find;
+}
+
+
+void LSRA::addFixed(UINT start, UINT end, RG * rg, UINT phy, UINT rgsz)
+{
+    if (rg != NULL) {
+        ASSERT0(rg->get(0) == phy);
+        for (UINT i = 0; i < rg->rnum; i++) {
+            ASSERT0(rg->get(i) != REG_UNDEF);
+            m_fixed.append(start, end, rg->get(i));
+        }
+        return;
+    }
+    m_fixed.append(start, end, phy);
+    if (rgsz != 1) {
+        ASSERT0(rgsz == RG_PAIR_SZ);
+        m_fixed.append(start, end, phy + 1);
+    }
+}
+
+
+//Collect the registers that assigned before scanning, include
+//GLT and local lifetime, e.g: parameter and register group.
+void LSRA::collectFixed()
+{
+    Vector<GLT*> * gltv = m_gltm->get_gltvec();
+    for (INT i = 1; i <= gltv->get_last_idx(); i++) {
+        GLT * g = gltv->get(i);
+        if (g == NULL || !g->has_allocated()) { continue; }
+        UINT start, end;
+        if (!computeInterval(g, start, end)) { continue; }
+        addFixed(start, end, GLT_rg(g), GLT_phy(g), GLT_rg_sz(g));
+    }
+
+    for (INT i = 0; i <= m_gltm->m_bb2ltmgr.get_last_idx(); i++) {
+        LTMgr * ltm = m_gltm->m_bb2ltmgr.get(i);
+        if (ltm == NULL) { continue; }
+        UINT base = m_bb2base.get(i);
+        Vector<LT*> * ltv = ltm->get_lt_vec();
+        for (INT j = 1; j <= ltv->get_last_idx(); j++) {
+            LT * l = ltv->get(j);
+            if (l == NULL || LT_is_global(l) || !l->has_allocated() ||
+                LT_range(l) == NULL) {
+                continue;
+            }
+            INT first = LT_range(l)->get_first();
+            if (first < 0) { continue; }
+            addFixed(base + first, base + LT_range(l)->get_last(),
+                     LT_rg(l), LT_phy(l), LT_rg_sz(l));
+        }
+    }
+
+    m_fixed.sort(compareFixedSeg);
+    for (UINT i = m_fixed.get_elem_count(); i > 0; i--) {
+        m_fixed_cur.set(m_fixed.get(i - 1).idx, i);
+    }
+}
+
+
+//Return true if 'phy' is occupied by fixed interval during
+//'start' to 'end'.
+//Note 'start' should be monotonic increasing between calls.
+bool LSRA::is_overlap_fixed(UINT phy, UINT start, UINT end)
+{
+    UINT c = m_fixed_cur.get(phy);
+    if (c == 0) { return false; }
+
+    //Skip the fixed intervals that ended before 'start'.
+    UINT n = m_fixed.get_elem_count();
+    for (c--; c < n && m_fixed.get(c).idx == phy &&
+         m_fixed.get(c).end < start; c++) {}
+    m_fixed_cur.set(phy, c + 1);
+
+    for (; c < n && m_fixed.get(c).idx == phy; c++) {
+        LiveSeg const& s = m_fixed.get(c);
+        if (s.start > end) { break; }
+        if (s.end >= start) { return true; }
+    }
+    return false;
+}
+
+
+//Return true if registers from 'phy' to 'phy + rgsz - 1' are free
+//during 'start' to 'end'.
+bool LSRA::is_free(UINT phy, UINT rgsz, UINT start, UINT end)
+{
+    if (rgsz != 1) {
+        ASSERT(rgsz == RG_PAIR_SZ, ("to support more size"));
+        if (m_ra->is_cross_param(phy, rgsz)) { return false; }
+    }
+    for (UINT i = 0; i < rgsz; i++) {
+        if (m_busy.get(phy + i) > start ||
+            is_overlap_fixed(phy + i, start, end)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//Return true if allocation was successful, otherwise return false.
+bool LSRA::assignRegister(GLT * g, UINT start, UINT end)
+{
+    BitSet const* usable = GLT_usable(g);
+    if (usable == NULL) { return false; }
+
+    UINT rgsz = GLT_rg_sz(g);
+    UINT phy = REG_UNDEF;
+    UINT pref_reg = GLT_prefer_reg(g);
+    if (pref_reg != REG_UNDEF &&
+        usable->is_contain(pref_reg) &&
+        is_free(pref_reg, rgsz, start, end)) {
+        phy = pref_reg;
+    } else {
+        //Only the registers in usable set can be assigned.
+        for (INT i = usable->get_first();
+             i >= 0; i = usable->get_next((UINT)i)) {
+            if (i < FIRST_PHY_REG) { continue; }
+            if (is_free(i, rgsz, start, end)) {
+                phy = i;
+                break;
+            }
+        }
+    }
+    if (phy == REG_UNDEF) { return false; }
+
+    ASSERT0(usable->is_contain(phy));
+    GLT_phy(g) = (USHORT)phy;
+    for (UINT i = 0; i < rgsz; i++) {
+        m_busy.set(phy + i, end + 1);
+    }
+    return true;
+}
+
+
+void LSRA::perform(OUT List<GLT*> & unalloc)
+{
+    computeLinearOrder();
+    collectFixed();
+
+    //Sort GLT in the order of interval start.
+    LiveSegVec cands;
+    Vector<GLT*> * gltv = m_gltm->get_gltvec();
+    for (INT i = 1; i <= gltv->get_last_idx(); i++) {
+        GLT * g = gltv->get(i);
+        if (g == NULL || GLT_is_param(g) || g->has_allocated()) {
+            //Allocate parameter elsewhere.
+            continue;
+        }
+        UINT start, end;
+        if (!computeInterval(g, start, end)) {
+            //g does not interfere with anyone.
+            start = end = 0;
+        }
+        cands.append(start, end, GLT_id(g));
+    }
+    cands.sort(compareLiveSeg);
+
+    for (UINT i = 0; i < cands.get_elem_count(); i++) {
+        LiveSeg const& s = cands.get(i);
+        GLT * g = m_gltm->get_glt(s.idx);
+        ASSERT0(g);
+        if (!assignRegister(g, s.start, s.end)) {
+            unalloc.append_tail(g);
+            continue;
+        }
+        ASSERT0(g->has_allocated());
+        m_ra->updateGltMaxReg(g);
+    }
+}
+//END LSRA
+
+
+static THREAD_LOCAL int gcount = 0;
 static bool gdebug()
 {
     return 1;
@@ -5796,6 +6287,32 @@ bool RA::verify_lt_occ()
 }
 
 
+//Verify GIG and IG are identical to the graphs built pairwise.
+bool RA::verify_ig()
+{
+    {
+        GIG gig(m_ru, &m_gltm);
+        gig.set_consider_local_interf(m_ig.m_is_consider_local_interf);
+        START_TIMER_AFTER();
+        gig.buildByPairwise();
+        END_TIMER_AFTER("Build GIG by Pairwise");
+        ASSERT(gig.is_equal(m_ig), ("GIG is not identical"));
+    }
+
+    START_TIMER_AFTER();
+    for (INT i = 0; i <= m_gltm.m_bb2ltmgr.get_last_idx(); i++) {
+        LTMgr * ltm = m_gltm.m_bb2ltmgr.get(i);
+        if (ltm == NULL) { continue; }
+        IG ig;
+        ig.set_ltm(ltm);
+        ig.buildByPairwise();
+        ASSERT(ig.is_equal(*ltm->get_ig()), ("IG is not identical"));
+    }
+    END_TIMER_AFTER("Build IG by Pairwise");
+    return true;
+}
+
+
 //Verify global and local lt has been assigned conflict phy.
 bool RA::verify_interf()
 {
@@ -5937,6 +6454,23 @@ void RA::allocGlobal(List<UINT> & nis, List<UINT> & nis2)
 }
 
 
+//Allocate GLT by linear scan rather than coloring on GIG, the GLT that
+//could not be assigned is split the same as allocGlobal().
+void RA::allocGlobalByLinearScan(List<UINT> & nis)
+{
+    List<GLT*> unalloc; //Record unassigned life times.
+    for (;;) {
+        unalloc.clean();
+        LSRA lsra(this);
+        lsra.perform(unalloc);
+        if (unalloc.get_elem_count() == 0) {
+            return;
+        }
+        solveConflict(unalloc, nis);
+    }
+}
+
+
 bool RA::perform(OptCtx & oc)
 {
     bool omit_constrain = true;
@@ -5993,8 +6527,13 @@ bool RA::perform(OptCtx & oc)
     ASSERT0(verify_usable());
 
     m_ig.set_consider_local_interf(true);
-    m_ig.build();
-    buildLocalIG();
+    {
+        START_TIMER_AFTER();
+        m_ig.build();
+        buildLocalIG();
+        END_TIMER_AFTER("Build Interference Graph");
+    }
+    ASSERT0(g_verify_level < VERIFY_LEVEL_3 || verify_ig());
 
     allocParameter();
     allocGroup();
@@ -6005,7 +6544,22 @@ bool RA::perform(OptCtx & oc)
     if (!omit_constrain) {
         allocLocalSpec(nis);
     }
-    allocGlobal(nis, nis2);
+
+    //Coloring is superlinear in the number of GLT, use linear scan
+    //for huge method to speed up compilation.
+    UINT glt_num = m_gltm.get_num_of_glt();
+    bool is_linear_scan = g_ra_linear_scan_threshold != 0 &&
+                          glt_num > g_ra_linear_scan_threshold;
+    {
+        START_TIMER_AFTER();
+        if (is_linear_scan) {
+            allocGlobalByLinearScan(nis);
+        } else {
+            allocGlobal(nis, nis2);
+        }
+        END_TIMER_AFTER(is_linear_scan ? "Global Linear Scan" :
+                                         "Global Coloring");
+    }
     updateLocal(); //TODO: remove it.
     ASSERT0(verify_reg(!omit_constrain, false));
     ASSERT0(verify_glt(true));
@@ -6039,6 +6593,11 @@ bool RA::perform(OptCtx & oc)
     m_gltm.freeGLTBitset();
 
     END_TIMER();
+    if (g_show_comp_time) {
+        prt2C("\n==-- GRA %s: GLT:%u, spill:%u, reload:%u",
+              is_linear_scan ? "linear scan" : "coloring",
+              glt_num, m_num_spill, m_num_reload);
+    }
     return true;
 }
 //END RA
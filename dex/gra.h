@@ -173,6 +173,8 @@ public:
 };
 
 
+//Dense PR numbers are looked up faster in chained HMap than in
+//FlatHMap, see com/bench/bench_hash.cpp.
 class PR2LT : public HMap<UINT, LT*> {
 public:
     PR2LT(UINT bsize = 0) : HMap<UINT, LT*>(bsize) {}
@@ -294,6 +296,97 @@ public:
 };
 
 
+//The segment of live range, [start, end] is the positions that
+//range is live continuously.
+typedef struct {
+    UINT start;
+    UINT end;
+    UINT idx; //index of range.
+} LiveSeg;
+
+
+//Growable array of LiveSeg.
+class LiveSegVec {
+    LiveSeg * m_vec;
+    UINT m_num;
+    UINT m_cap;
+public:
+    LiveSegVec() { m_vec = NULL; m_num = 0; m_cap = 0; }
+    COPY_CONSTRUCTOR(LiveSegVec);
+    ~LiveSegVec()
+    {
+        if (m_vec != NULL) {
+            ::free(m_vec);
+        }
+    }
+
+    void append(UINT start, UINT end, UINT idx)
+    {
+        if (m_num >= m_cap) {
+            m_cap = m_cap == 0 ? 64 : m_cap * 2;
+            m_vec = (LiveSeg*)::realloc(m_vec, sizeof(LiveSeg) * m_cap);
+            ASSERT0(m_vec);
+        }
+        LiveSeg * s = &m_vec[m_num++];
+        s->start = start;
+        s->end = end;
+        s->idx = idx;
+    }
+
+    void clean() { m_num = 0; }
+
+    LiveSeg const& get(UINT i) const
+    {
+        ASSERT0(i < m_num);
+        return m_vec[i];
+    }
+    UINT get_elem_count() const { return m_num; }
+
+    //Sort segments with 'cmp', the comparator of qsort.
+    void sort(int (*cmp)(void const*, void const*))
+    {
+        if (m_num > 1) {
+            ::qsort(m_vec, m_num, sizeof(LiveSeg), cmp);
+        }
+    }
+};
+
+
+//Interference Builder.
+//It sweeps the segments of live ranges in the order of position, and
+//records each pair of ranges that are live at the same position. The pairs
+//are kept in a bit-matrix for small graph, and in adjacency vectors for
+//large graph. They are replayed in the ascending order of index, thus the
+//graph is identical to the one built by testing every pair of ranges.
+#define INTF_MATRIX_LIMIT 2048
+class InterfBuilder {
+    UINT m_num; //the number of index.
+    BitSet * m_mat; //bit-matrix, used if m_num is small.
+    Vector<Vector<UINT>*> m_adj; //adjacency vectors, used if m_num is large.
+    LiveSegVec m_segs;
+    Vector<UINT> m_active; //segments that are still live during sweeping.
+public:
+    explicit InterfBuilder(UINT num);
+    COPY_CONSTRUCTOR(InterfBuilder);
+    ~InterfBuilder();
+
+    //Record 'i' and 'j' interfere with each other.
+    void addPair(UINT i, UINT j);
+
+    //Append the segments of 'range' which indexed by 'idx'.
+    void addRange(UINT idx, BitSet const* range);
+
+    //Collect index which greater than 'idx' and interfered with 'idx'
+    //into 'adj' in ascending order.
+    //Return the number of index.
+    UINT get_adj(UINT idx, OUT Vector<UINT> & adj);
+
+    //Sweep the segments appended, record each pair of them which are
+    //overlapped, then drop all segments.
+    void sweep();
+};
+
+
 class IG : public Graph {
     LTMgr * m_ltm;
 public:
@@ -301,6 +394,10 @@ public:
     void set_ltm(LTMgr * ltm) { ASSERT0(ltm); m_ltm = ltm; }
     bool is_interf(LT const* lt1, LT const* lt2) const;
     void build();
+
+    //Build graph by testing every pair of lifetimes.
+    //It is only used to verify build().
+    void buildByPairwise();
     void dump_vcg(CHAR const* name = NULL);
     void get_neighbor(OUT List<LT*> & nis, LT * lt) const;
 };
@@ -520,6 +617,7 @@ class GltMgr {
     friend class LTMgr;
     friend class RA;
     friend class GIG;
+    friend class LSRA;
 protected:
     Vector<BitSet*> m_glt2usable_regs; //Map GLT to its usable registers.
     Vector<LTMgr*> m_bb2ltmgr; //Map from BB id to LTMgr.
@@ -660,6 +758,10 @@ public:
         build();
     }
     void build();
+
+    //Build graph by testing every pair of lifetimes.
+    //It is only used to verify build().
+    void buildByPairwise();
 };
 
 
@@ -802,12 +904,50 @@ public:
 };
 
 
+//LSRA
+//Linear Scan Register Allocator.
+//It is the fast alternative of the priority-based coloring for GLT.
+//BBs are laid out in the order of BB list, and each GLT is approximated
+//by the interval that covers the positions of all its local parts.
+//GLTs are assigned in the order of interval start, and the register
+//becomes free once the interval occupied it ended. The registers assigned
+//before scanning, e.g: parameter and register group, are kept as fixed
+//intervals.
+class LSRA {
+protected:
+    RA * m_ra;
+    GltMgr * m_gltm;
+    Region * m_ru;
+    Vector<UINT> m_bb2base; //Map BB id to its first position.
+    Vector<UINT> m_busy; //register is busy before the position.
+    LiveSegVec m_fixed; //fixed intervals, sorted by register and start.
+    Vector<UINT> m_fixed_cur; //Map register to index+1 of its fixed interval.
+
+    void addFixed(UINT start, UINT end, RG * rg, UINT phy, UINT rgsz);
+    bool assignRegister(GLT * g, UINT start, UINT end);
+    void collectFixed();
+    bool computeInterval(GLT const* g, OUT UINT & start, OUT UINT & end);
+    void computeLinearOrder();
+    bool is_free(UINT phy, UINT rgsz, UINT start, UINT end);
+    bool is_overlap_fixed(UINT phy, UINT start, UINT end);
+public:
+    LSRA(RA * ra);
+    COPY_CONSTRUCTOR(LSRA);
+    ~LSRA() {}
+
+    //Assign register to each unallocated GLT, and record the GLT that
+    //could not be assigned in 'unalloc'.
+    void perform(OUT List<GLT*> & unalloc);
+};
+
+
 //RA
 class RA {
 protected:
     friend class BBRA;
     friend class LTMgr;
     friend class GltMgr;
+    friend class LSRA;
 
     PRDF m_prdf;
     GltMgr m_gltm;
@@ -824,6 +964,8 @@ protected:
     UINT m_param_reg_start;
     UINT m_vregnum; //record the number of original vreg.
     UINT m_maxreg; //record the max vreg used. note it is not the number of vreg.
+    UINT m_num_spill; //record the number of spill generated.
+    UINT m_num_reload; //record the number of reload generated.
     IRIter m_ii; //for tmp used.
     ConstIRIter m_cii; //for tmp used.
 
@@ -835,6 +977,7 @@ protected:
     void allocPrioList(OUT List<GLT*> & prios, OUT List<GLT*> & unalloc,
                           List<UINT> & nis, List<UINT> & nis2);
     void allocGlobal(List<UINT> & nis, List<UINT> & nis2);
+    void allocGlobalByLinearScan(List<UINT> & nis);
     void allocLocal(List<UINT> & nis, bool omit_constrain);
     void allocLocalSpec(List<UINT> & nis);
 
@@ -915,6 +1058,8 @@ public:
         m_param_num = param_num;
         m_vregnum = vregnum;
         m_maxreg = 0;
+        m_num_spill = 0;
+        m_num_reload = 0;
         m_v2pr = v2pr;
         m_pr2v = pr2v;
         m_var2pr = var2pr;
@@ -957,6 +1102,7 @@ public:
     }
 
     bool verify_interf();
+    bool verify_ig();
     bool verify_lt_occ();
     bool verify_usable();
     bool verify_rsc();
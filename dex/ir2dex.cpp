@@ -1504,7 +1504,7 @@ void IR2Dex::dump_output(List<LIR*> & newlirs, Prno2Vreg const& prno2v)
 }
 
 
-extern bool g_dd;
+extern THREAD_LOCAL bool g_dd;
 void IR2Dex::convert(IR * ir_list, List<LIR*> & newlirs)
 {
     bool dump = g_dump_ir2dex && g_tfile != NULL;
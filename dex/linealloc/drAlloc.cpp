@@ -37,7 +37,7 @@ author: GongKai, JinYue
 #define PIG_SIZE (4096)
 #define DEFAULT_ALLOC_SIZE (PIG_SIZE*32)
 
-static SMemPool * g_d2d_used_pool = NULL;
+static THREAD_LOCAL SMemPool * g_d2d_used_pool = NULL;
 
 bool drLinearInit(void){
     if (g_d2d_used_pool == NULL) {
@@ -724,13 +724,13 @@ bool checkMethodName(DexFile const* df, DexMethod const* dexm)
     return false;
 }
 
-void d2rMethod(
-        D2Dpool* pool,
+//Decode DEX code of method to LIR, and record the DEX offset of each
+//LIR in 'offvec'.
+//Note LIR is allocated in the linear pool of current thread.
+static LIRCode* genLIRCode(
         DexFile* pDexFile,
         const DexMethod* pDexMethod,
-        const DexClassDef* classdef,
-        RegionMgr* rumgr,
-        List<DexRegion const*> * rulist)
+        OUT OffsetVec & offvec)
 {
     const DexCode* dexCode = dexGetCode(pDexFile, pDexMethod);
     UInt16* codeStart = (UInt16*)dexCode->insns;
@@ -743,8 +743,6 @@ void d2rMethod(
     CHAR const* namestr = debugAssemblyName(pDexFile, pDexMethod);
     #endif
 
-    drLinearInit();
-
     LIRCode* lircode = (LIRCode*)LIRMALLOC(sizeof(LIRCode));
     LIRBaseOp** lirList;
 
@@ -759,7 +757,6 @@ void d2rMethod(
     UInt32 dexOffset = 0;
     UInt32 lastValidDexOffset = 0;
     bool lastInstrIsPseudo = false;
-    OffsetVec offvec;
     while (codePtr < codeEnd) {
         if (!contentIsInsn(codePtr)) {
             break;
@@ -856,10 +853,32 @@ void d2rMethod(
     if ((ACC_STATIC & pDexMethod->accessFlags)) {
         lircode->flags |= LIR_FLAGS_ISSTATIC;
     }
+    return lircode;
+}
+
+
+//Compile method and transform the result into DEX code buffer.
+//The buffer is not written to pool, and the header of code item is
+//recorded in 'nCode'. Call d2rEmitMethod() to append it to pool.
+//Note this function only reads pool, it can be invoked by multiple
+//threads simultaneously if there is no IPA.
+CBSHandle d2rCompileMethod(
+        D2Dpool* pool,
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        const DexClassDef* classdef,
+        RegionMgr* rumgr,
+        List<DexRegion const*> * rulist,
+        OUT DexCode* nCode)
+{
+    const DexCode* dexCode = dexGetCode(pDexFile, pDexMethod);
+    drLinearInit();
 
+    OffsetVec offvec;
+    LIRCode* lircode = genLIRCode(pDexFile, pDexMethod, offvec);
     compileFunc(rumgr, pool, lircode, pDexFile,
                 pDexMethod, dexCode, classdef, offvec, rulist);
-    lir2dexCode(pool, dexCode, lircode);
+    CBSHandle cbsCode = lir2dexCodeBuf(dexCode, lircode, nCode);
 
     //Leave it to verify.
     //lir2dexCode_orig(pool, dexCode, code);
@@ -867,4 +886,66 @@ void d2rMethod(
     //Obsolete code.
     //l2dWithAot(pool, dexCode, code);
     drLinearFree();
+    return cbsCode;
+}
+
+
+//Convert method to IR in IPA mode, the IR is recorded in region of
+//'rumgr' and optimized later. Call d2rFinishMethod() to transform the
+//optimized region into DEX code buffer.
+//Note LIR is kept in the linear pool of current thread until all
+//methods have been finished, the caller is responsible for invoking
+//drLinearFree() at last.
+DexFuncInfo* d2rConvertMethod(
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        const DexClassDef* classdef,
+        RegionMgr* rumgr)
+{
+    const DexCode* dexCode = dexGetCode(pDexFile, pDexMethod);
+    drLinearInit();
+
+    OffsetVec offvec;
+    LIRCode* lircode = genLIRCode(pDexFile, pDexMethod, offvec);
+    return convertFunc(rumgr, lircode, pDexFile, pDexMethod, dexCode,
+                       classdef, offvec);
+}
+
+
+//Transform the method converted by d2rConvertMethod() into DEX code
+//buffer, the header of code item is recorded in 'nCode'.
+CBSHandle d2rFinishMethod(
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        DexFuncInfo* funcInfo,
+        OUT DexCode* nCode)
+{
+    LIRCode* lircode = finishFunc(funcInfo);
+    return lir2dexCodeBuf(dexGetCode(pDexFile, pDexMethod), lircode, nCode);
+}
+
+
+//Append code item generated by d2rCompileMethod() to pool.
+//pool->codeOff will be set to the offset of the code item.
+void d2rEmitMethod(D2Dpool* pool, CBSHandle cbsCode, DexCode const* nCode)
+{
+    ASSERT0(cbsCode && nCode);
+    writeCodeItem(pool, cbsCode, nCode->registersSize, nCode->insSize,
+                  nCode->outsSize, nCode->triesSize,
+                  nCode->debugInfoOff, nCode->insnsSize);
+}
+
+
+void d2rMethod(
+        D2Dpool* pool,
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        const DexClassDef* classdef,
+        RegionMgr* rumgr,
+        List<DexRegion const*> * rulist)
+{
+    DexCode nCode;
+    CBSHandle cbsCode = d2rCompileMethod(pool, pDexFile, pDexMethod,
+                                         classdef, rumgr, rulist, &nCode);
+    d2rEmitMethod(pool, cbsCode, &nCode);
 }
@@ -34,6 +34,27 @@ author: GongKai, JinYue
 #ifndef __DRCODE_H__
 #define __DRCODE_H__
 
+class DexFuncInfo;
+
+CBSHandle d2rCompileMethod(
+        D2Dpool* pool,
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        const DexClassDef* classdef,
+        RegionMgr* rumgr,
+        List<DexRegion const*> * rulist,
+        OUT DexCode* nCode);
+DexFuncInfo* d2rConvertMethod(
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        const DexClassDef* classdef,
+        RegionMgr* rumgr);
+CBSHandle d2rFinishMethod(
+        DexFile* pDexFile,
+        const DexMethod* pDexMethod,
+        DexFuncInfo* funcInfo,
+        OUT DexCode* nCode);
+void d2rEmitMethod(D2Dpool* pool, CBSHandle cbsCode, DexCode const* nCode);
 void d2rMethod(
         D2Dpool* pool,
         DexFile* pDexFile,
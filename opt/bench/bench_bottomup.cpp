@@ -0,0 +1,209 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Process a set of synthetic functions that call each other in bottom-up
+//order of call graph with one thread and with [thread_num] threads,
+//check that both ways produce the same IR and ids, and measure the time.
+//Usage: bench_bottomup.elf [func_num] [thread_num]
+#include "cominc.h"
+#include "comopt.h"
+#include <sys/time.h>
+
+using namespace xoc;
+
+//Return the elapsed time in micro-second, the processing time is
+//accumulated by all threads if CPU time is used.
+static ULONGLONG getElapsedUsec()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return ((ULONGLONG)tv.tv_sec) * 1000000ULL + tv.tv_usec;
+}
+
+//Build function 'idx':
+//    $a = 0; $i = 0;
+//    while ($i < bound) {
+//        if ($i > k) { x = $i; } else { x = $a; }
+//        $a = $a + x;
+//        g = $a;
+//        $i = $i + 1;
+//    }
+//    $a = call f(2*idx+1)($a);
+//    $a = call f(2*idx+2)($a);
+//    return $a;
+//where 'g' is a global VAR, and 'x' is a local VAR of the function.
+//Besides, f(idx) and f(idx+1) call each other if idx % 8 is 6.
+static Region * buildFunc(
+        RegionMgr * rm,
+        Region * program,
+        Vector<VAR*> const& funcs,
+        VAR * g,
+        UINT idx)
+{
+    TypeMgr * tm = rm->get_type_mgr();
+    Type const* i32 = tm->getI32();
+    UINT n = funcs.get_last_idx() + 1;
+
+    Region * ru = rm->newRegion(RU_FUNC);
+    ru->set_ru_var(funcs.get(idx));
+    REGION_parent(ru) = program;
+    rm->addToRegionTab(ru);
+
+    VAR * x = rm->get_var_mgr()->registerVar("x", i32, 4, VAR_LOCAL);
+    ru->addToVarTab(x);
+
+    HOST_INT k = idx % 7 + 2;
+    HOST_INT bound = idx * 13 % 50 + 10;
+    UINT a = ru->buildPrno(i32);
+    UINT i = ru->buildPrno(i32);
+    ru->addToIRList(ru->buildStorePR(a, i32, ru->buildImmInt(0, i32)));
+    ru->addToIRList(ru->buildStorePR(i, i32, ru->buildImmInt(0, i32)));
+
+    IR * body = ru->buildIf(
+        ru->buildCmp(IR_GT, ru->buildPRdedicated(i, i32),
+                     ru->buildImmInt(k, i32)),
+        ru->buildStore(x, ru->buildPRdedicated(i, i32)),
+        ru->buildStore(x, ru->buildPRdedicated(a, i32)));
+    xcom::add_next(&body, ru->buildStorePR(a, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(a, i32), ru->buildLoad(x))));
+    xcom::add_next(&body, ru->buildStore(g, ru->buildPRdedicated(a, i32)));
+    xcom::add_next(&body, ru->buildStorePR(i, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(i, i32), ru->buildImmInt(1, i32))));
+    ru->addToIRList(ru->buildWhileDo(ru->buildCmp(IR_LT,
+        ru->buildPRdedicated(i, i32), ru->buildImmInt(bound, i32)), body));
+
+    UINT callees[3] = { idx * 2 + 1, idx * 2 + 2, n };
+    if (idx % 8 == 6) { callees[2] = idx + 1; }
+    if (idx % 8 == 7) { callees[2] = idx - 1; }
+    for (UINT j = 0; j < 3; j++) {
+        if (callees[j] >= n) { continue; }
+        ru->addToIRList(ru->buildCall(funcs.get(callees[j]),
+            ru->buildPRdedicated(a, i32), a, i32));
+    }
+    ru->addToIRList(ru->buildReturn(ru->buildPRdedicated(a, i32)));
+    return ru;
+}
+
+
+//Build 'n' functions, and process them with 'thread_num' threads.
+//The result is dumped to 'dump'.
+//Return the elapsed time in micro-second.
+static ULONGLONG processFunc(UINT n, UINT thread_num, FILE * dump)
+{
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    VarMgr * vm = rm->get_var_mgr();
+    TypeMgr * tm = rm->get_type_mgr();
+
+    Region * program = rm->newRegion(RU_PROGRAM);
+    program->set_ru_var(vm->registerVar(".program", tm->getMCType(0), 0,
+                                        VAR_GLOBAL|VAR_FAKE));
+    rm->addToRegionTab(program);
+    VAR * g = vm->registerVar("g", tm->getI32(), 4, VAR_GLOBAL);
+
+    Vector<VAR*> funcs;
+    for (UINT i = 0; i < n; i++) {
+        CHAR name[64];
+        sprintf(name, "func%u", i);
+        funcs.set(i, vm->registerVar(name, tm->getMCType(0), 0,
+                                     VAR_GLOBAL|VAR_FAKE));
+    }
+    for (UINT i = 0; i < n; i++) {
+        buildFunc(rm, program, funcs, g, i);
+    }
+
+    ULONGLONG t = getElapsedUsec();
+    bool succ = rm->processFuncRegionBottomUp(thread_num);
+    t = getElapsedUsec() - t;
+    ASSERT0(succ);
+    UNUSED(succ);
+
+    FILE * org = g_tfile;
+    g_tfile = dump;
+    for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
+        Region * ru = rm->get_region(i);
+        if (ru == NULL || !ru->is_function()) { continue; }
+        fprintf(dump, "\n==-- %s --==", ru->get_ru_name());
+        IR * irs = ru->constructIRlist(true);
+        dump_irs(irs, tm);
+
+        //Dump the ids of MD referenced by IR.
+        fprintf(dump, "\nMD:");
+        ConstIRIter it;
+        for (IR const* x = iterInitC(irs, it); x != NULL; x = iterNextC(it)) {
+            if (!x->is_memory_ref() || x->getRefMD() == NULL) { continue; }
+            fprintf(dump, " %u", MD_id(x->getRefMD()));
+        }
+    }
+    fprintf(dump, "\nVAR %d, MD %u", vm->get_var_vec()->get_last_idx(),
+            rm->get_md_sys()->get_num_of_md());
+    g_tfile = org;
+    delete rm;
+    return t;
+}
+
+
+//Return true if the content of 'f1' and 'f2' are identical.
+static bool is_same_file(FILE * f1, FILE * f2)
+{
+    rewind(f1);
+    rewind(f2);
+    INT c1, c2;
+    do {
+        c1 = fgetc(f1);
+        c2 = fgetc(f2);
+    } while (c1 == c2 && c1 != EOF);
+    return c1 == c2;
+}
+
+
+int main(int argc, char * argv[])
+{
+    UINT n = argc > 1 ? (UINT)atoi(argv[1]) : 256;
+    UINT thread_num = argc > 2 ? (UINT)atoi(argv[2]) : 4;
+    if (thread_num == 0) { thread_num = 1; }
+
+    //Lowered IR refers to PR MD which is not exact.
+    g_is_support_dynamic_type = true;
+    g_opt_level = OPT_LEVEL3;
+    g_tfile = NULL;
+
+    FILE * dump1 = tmpfile();
+    FILE * dump2 = tmpfile();
+    ASSERT0(dump1 && dump2);
+    ULONGLONG t1 = processFunc(n, 1, dump1);
+    ULONGLONG t2 = processFunc(n, thread_num, dump2);
+    bool same = is_same_file(dump1, dump2);
+    fclose(dump1);
+    fclose(dump2);
+
+    printf("\n%u functions", n);
+    printf("\n  1 thread: %lluus", t1);
+    printf("\n  %u threads: %lluus", thread_num, t2);
+    printf("\n%s\n", same ? "PASSED" : "FAILED: IR differs");
+    return same ? 0 : 1;
+}
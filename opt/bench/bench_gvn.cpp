@@ -0,0 +1,210 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Compute the value numbers of a synthetic function in SSA form by
+//IR_GVN and by IR_SGVN, check that the expressions congruent by IR_GVN
+//are congruent by IR_SGVN as well, and measure the compile time and
+//the equivalences found by each way.
+//Usage: bench_gvn.elf [loop_num]
+#include "cominc.h"
+#include "comopt.h"
+#include <sys/time.h>
+
+using namespace xoc;
+
+static ULONGLONG getElapsedUsec()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return ((ULONGLONG)tv.tv_sec) * 1000000ULL + tv.tv_usec;
+}
+
+
+//Build loop 'idx':
+//    $i = 0; $j = 0;
+//    while ($i < bound) {
+//        $a = $i * 3 + g;
+//        $b = $j * 3 + g;
+//        $s = $s + $a;
+//        $s = $s + $b;
+//        $i = $i + 1;
+//        $j = $j + 1;
+//    }
+//where 'g' is a global VAR. $a and $b are congruent only if $i and $j
+//are assumed to be congruent at the loop head optimistically.
+static void buildLoop(Region * ru, VAR * g, UINT s, UINT idx)
+{
+    Type const* i32 = ru->get_type_mgr()->getI32();
+    UINT i = ru->buildPrno(i32);
+    UINT j = ru->buildPrno(i32);
+    UINT a = ru->buildPrno(i32);
+    UINT b = ru->buildPrno(i32);
+    ru->addToIRList(ru->buildStorePR(i, i32, ru->buildImmInt(0, i32)));
+    ru->addToIRList(ru->buildStorePR(j, i32, ru->buildImmInt(0, i32)));
+
+    IR * body = ru->buildStorePR(a, i32, ru->buildBinaryOp(IR_ADD, i32,
+        ru->buildBinaryOp(IR_MUL, i32, ru->buildPRdedicated(i, i32),
+                          ru->buildImmInt(3, i32)),
+        ru->buildLoad(g)));
+    xcom::add_next(&body, ru->buildStorePR(b, i32, ru->buildBinaryOp(
+        IR_ADD, i32,
+        ru->buildBinaryOp(IR_MUL, i32, ru->buildPRdedicated(j, i32),
+                          ru->buildImmInt(3, i32)),
+        ru->buildLoad(g))));
+    xcom::add_next(&body, ru->buildStorePR(s, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(s, i32),
+        ru->buildPRdedicated(a, i32))));
+    xcom::add_next(&body, ru->buildStorePR(s, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(s, i32),
+        ru->buildPRdedicated(b, i32))));
+    xcom::add_next(&body, ru->buildStorePR(i, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(i, i32), ru->buildImmInt(1, i32))));
+    xcom::add_next(&body, ru->buildStorePR(j, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(j, i32), ru->buildImmInt(1, i32))));
+    HOST_INT bound = idx * 7 % 50 + 10;
+    ru->addToIRList(ru->buildWhileDo(ru->buildCmp(IR_LT,
+        ru->buildPRdedicated(i, i32), ru->buildImmInt(bound, i32)), body));
+}
+
+
+//Return the number of expressions that congruent to a former one.
+//PR and CONST are not counted, since their VNs are trivial.
+//'first': record the first expression of each VN.
+static UINT countEquiv(
+        IR_GVN & gvn,
+        Region * ru,
+        OUT Vector<IR const*> & first)
+{
+    ConstIRPreIter it;
+    UINT n = 0;
+    BBList * bbl = ru->get_bb_list();
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            for (IR const* x = it.initRhs(ir); x != NULL; x = it.next()) {
+                if (x->is_pr() || x->is_const()) { continue; }
+                VN * vn = gvn.mapIR2VN(x);
+                if (vn == NULL) { continue; }
+                if (first.get(VN_id(vn)) != NULL) {
+                    n++;
+                } else {
+                    first.set(VN_id(vn), x);
+                }
+            }
+        }
+    }
+    return n;
+}
+
+
+//Return true if expressions that have same VN in 'gvn' have same VN
+//in 'sgvn' as well.
+static bool isRefinedBy(IR_GVN & gvn, IR_GVN & sgvn, Region * ru,
+                        Vector<IR const*> const& first)
+{
+    ConstIRPreIter it;
+    BBList * bbl = ru->get_bb_list();
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            for (IR const* x = it.initRhs(ir); x != NULL; x = it.next()) {
+                if (x->is_pr() || x->is_const()) { continue; }
+                VN * vn = gvn.mapIR2VN(x);
+                if (vn == NULL) { continue; }
+                IR const* y = first.get(VN_id(vn));
+                ASSERT0(y);
+                if (y != x && (sgvn.mapIR2VN(x) == NULL ||
+                               sgvn.mapIR2VN(x) != sgvn.mapIR2VN(y))) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+int main(int argc, char * argv[])
+{
+    UINT n = argc > 1 ? (UINT)atoi(argv[1]) : 100;
+
+    g_is_support_dynamic_type = true;
+    g_opt_level = OPT_LEVEL0;
+    g_do_ssa = true;
+    g_do_md_ssa = true;
+    g_tfile = NULL;
+
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    TypeMgr * tm = rm->get_type_mgr();
+    Region * ru = rm->newRegion(RU_FUNC);
+    ru->set_ru_var(rm->get_var_mgr()->registerVar("func",
+        tm->getMCType(0), 0, VAR_GLOBAL|VAR_FAKE));
+    rm->addToRegionTab(ru);
+    VAR * g = rm->get_var_mgr()->registerVar("g", tm->getI32(), 4,
+                                             VAR_GLOBAL);
+
+    UINT s = ru->buildPrno(tm->getI32());
+    ru->addToIRList(ru->buildStorePR(s, tm->getI32(),
+                                     ru->buildImmInt(0, tm->getI32())));
+    for (UINT i = 0; i < n; i++) {
+        buildLoop(ru, g, s, i);
+    }
+    ru->addToIRList(ru->buildReturn(ru->buildPRdedicated(s, tm->getI32())));
+
+    //Construct BB list, PR SSA, MD SSA and DU chain.
+    ru->initPassMgr();
+    OptCtx oc;
+    ru->HighProcess(oc);
+
+    IR_GVN gvn(ru);
+    ULONGLONG t1 = getElapsedUsec();
+    gvn.perform(oc);
+    t1 = getElapsedUsec() - t1;
+
+    IR_SGVN sgvn(ru);
+    ULONGLONG t2 = getElapsedUsec();
+    sgvn.perform(oc);
+    t2 = getElapsedUsec() - t2;
+
+    Vector<IR const*> first1;
+    Vector<IR const*> first2;
+    UINT n1 = countEquiv(gvn, ru, first1);
+    UINT n2 = countEquiv(sgvn, ru, first2);
+    bool refined = isRefinedBy(gvn, sgvn, ru, first1);
+    UINT num_iter = sgvn.get_num_iter();
+    delete rm;
+
+    printf("\n%u loops", n);
+    printf("\n  IR_GVN: %lluus, %u equivalences", t1, n1);
+    printf("\n  IR_SGVN: %lluus, %u equivalences, %u iterations",
+           t2, n2, num_iter);
+    if (!refined) {
+        printf("\nFAILED: IR_SGVN misses equivalence of IR_GVN\n");
+        return 1;
+    }
+    printf("\nPASSED\n");
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Walk a set of synthetic stmts with iterInitC/iterNextC and with
+//ConstIRPreIter, check that both access the same IR, and report the
+//number of IR accessed per second of each way.
+//Usage: bench_ir_iter.elf [stmt_num] [round_num]
+#include "cominc.h"
+#include "comopt.h"
+
+using namespace xoc;
+
+//Build an expression tree of 'depth' level, the leaves are PR and
+//constant alternately.
+static IR * buildTree(Region * ru, UINT depth, UINT pr, UINT idx)
+{
+    Type const* i32 = ru->get_type_mgr()->getI32();
+    if (depth == 0) {
+        if (idx % 2 == 0) { return ru->buildPRdedicated(pr, i32); }
+        return ru->buildImmInt(idx, i32);
+    }
+    return ru->buildBinaryOp(depth % 2 == 0 ? IR_ADD : IR_MUL, i32,
+                             buildTree(ru, depth - 1, pr, idx * 2),
+                             buildTree(ru, depth - 1, pr, idx * 2 + 1));
+}
+
+
+//Build stmt 'idx'. Every fourth stmt is an IF with two stmts in its
+//true body, the others are stpr of trees of different depth.
+static IR * buildStmt(Region * ru, UINT pr, UINT idx)
+{
+    Type const* i32 = ru->get_type_mgr()->getI32();
+    if (idx % 4 != 0) {
+        return ru->buildStorePR(pr, i32, buildTree(ru, idx % 6 + 1, pr, 0));
+    }
+    IR * body = ru->buildStorePR(pr, i32, buildTree(ru, 2, pr, 0));
+    xcom::add_next(&body, ru->buildStorePR(pr, i32, buildTree(ru, 3, pr, 1)));
+    return ru->buildIf(ru->buildCmp(IR_GT, ru->buildPRdedicated(pr, i32),
+                                    ru->buildImmInt(idx, i32)),
+                       body, NULL);
+}
+
+
+int main(int argc, char * argv[])
+{
+    UINT n = argc > 1 ? (UINT)atoi(argv[1]) : 1000;
+    UINT nround = argc > 2 ? (UINT)atoi(argv[2]) : 100;
+
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    Region * ru = rm->newRegion(RU_FUNC);
+    ru->set_ru_var(rm->get_var_mgr()->registerVar("func",
+        rm->get_type_mgr()->getMCType(0), 0, VAR_GLOBAL|VAR_FAKE));
+    rm->addToRegionTab(ru);
+
+    UINT pr = ru->buildPrno(rm->get_type_mgr()->getI32());
+    Vector<IR*> stmts;
+    for (UINT i = 0; i < n; i++) {
+        stmts.set(i, buildStmt(ru, pr, i));
+    }
+
+    //Sum of IR id is used to check both ways access the same IR,
+    //since the order of accessing may be different.
+    UINT n1 = 0;
+    UINT sum1 = 0;
+    LONG t = getclockstart();
+    ConstIRIter it1;
+    for (UINT r = 0; r < nround; r++) {
+        for (UINT i = 0; i < n; i++) {
+            it1.clean();
+            for (IR const* x = iterInitC(stmts.get(i), it1);
+                 x != NULL; x = iterNextC(it1)) {
+                n1++;
+                sum1 += IR_id(x);
+            }
+        }
+    }
+    float t1 = getclockend(t);
+
+    UINT n2 = 0;
+    UINT sum2 = 0;
+    t = getclockstart();
+    ConstIRPreIter it2;
+    for (UINT r = 0; r < nround; r++) {
+        for (UINT i = 0; i < n; i++) {
+            for (IR const* x = it2.init(stmts.get(i));
+                 x != NULL; x = it2.next()) {
+                n2++;
+                sum2 += IR_id(x);
+            }
+        }
+    }
+    float t2 = getclockend(t);
+    delete rm;
+
+    printf("\n%u IR x %u rounds", n1 / MAX(nround, 1), nround);
+    printf("\n  ConstIRIter: %fsec %.0f IR/sec",
+           t1, t1 > 0 ? n1 / t1 : 0.0f);
+    printf("\n  ConstIRPreIter: %fsec %.0f IR/sec",
+           t2, t2 > 0 ? n2 / t2 : 0.0f);
+    if (n1 != n2 || sum1 != sum2) {
+        printf("\nFAILED: iterators access different IR\n");
+        return 1;
+    }
+    printf("\nPASSED\n");
+    return 0;
+}
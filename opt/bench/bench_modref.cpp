@@ -0,0 +1,293 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Compute the DU chain of a set of synthetic functions that call each
+//other without and with IPA Mod/Ref summary, check that the summary
+//does not drop the DU chain of memory that callee modifies via
+//restrict parameter, and measure the DU information reduced.
+//Usage: bench_modref.elf [func_num] [global_num]
+#include "cominc.h"
+#include "comopt.h"
+#include "callg.h"
+#include "ipa.h"
+#include <sys/time.h>
+
+using namespace xoc;
+
+//Statistics of DU information that affected by Mod/Ref summary.
+class ModRefStat {
+public:
+    UINT num_summary; //the number of functions that have summary.
+    UINT num_call; //the number of calls.
+    UINT num_call_md; //the sum of MayDef MDs of calls.
+    UINT num_du; //the sum of elements of DU set.
+    UINT num_clobbered_use; //the number of uses that defined by call.
+    bool is_param_pointee_def; //true if call defines the restrict pointee.
+    ULONGLONG time; //elapsed time of IPA in micro-second.
+
+    ModRefStat() { ::memset(this, 0, sizeof(ModRefStat)); }
+};
+
+
+static ULONGLONG getElapsedUsec()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return ((ULONGLONG)tv.tv_sec) * 1000000ULL + tv.tv_usec;
+}
+
+
+//Build function 'setp':
+//    *p = 1;
+//    return;
+//where 'p' is a restrict parameter.
+static void buildSetp(RegionMgr * rm, Region * program, VAR * setp)
+{
+    TypeMgr * tm = rm->get_type_mgr();
+    Type const* i32 = tm->getI32();
+    Region * ru = rm->newRegion(RU_FUNC);
+    ru->set_ru_var(setp);
+    REGION_parent(ru) = program;
+    rm->addToRegionTab(ru);
+
+    VAR * p = rm->get_var_mgr()->registerVar("p", tm->getPointerType(4), 4,
+        VAR_LOCAL|VAR_IS_FORMAL_PARAM|VAR_IS_RESTRICT);
+    ru->addToVarTab(p);
+    ru->addToIRList(ru->buildIstore(ru->buildLoad(p),
+                                    ru->buildImmInt(1, i32), i32));
+    ru->addToIRList(ru->buildReturn(NULL));
+}
+
+
+//Build function 'idx':
+//    g[idx] = g[idx] + 1;
+//    call f(2*idx+1)();
+//    call f(2*idx+2)();
+//    $a = g[idx+1];
+//    return $a;
+//where 'g' are global VARs, the index of them is modulo the number
+//of them. Function other than 0 that does not have callee only
+//accesses local 'x':
+//    x = idx;
+//    $a = x + 1;
+//    return $a;
+//Besides, function 0 calls setp with the address of local 'l':
+//    l = 0;
+//    call setp(&l);
+//    g[0] = l;
+static void buildFunc(
+        RegionMgr * rm,
+        Region * program,
+        Vector<VAR*> const& funcs,
+        Vector<VAR*> const& gs,
+        VAR * setp,
+        UINT idx)
+{
+    TypeMgr * tm = rm->get_type_mgr();
+    Type const* i32 = tm->getI32();
+    UINT n = funcs.get_last_idx() + 1;
+    UINT m = gs.get_last_idx() + 1;
+
+    Region * ru = rm->newRegion(RU_FUNC);
+    ru->set_ru_var(funcs.get(idx));
+    REGION_parent(ru) = program;
+    rm->addToRegionTab(ru);
+
+    UINT a = ru->buildPrno(i32);
+    if (idx != 0 && idx * 2 + 1 >= n) {
+        VAR * x = rm->get_var_mgr()->registerVar("x", i32, 4, VAR_LOCAL);
+        ru->addToVarTab(x);
+        ru->addToIRList(ru->buildStore(x, ru->buildImmInt(idx, i32)));
+        ru->addToIRList(ru->buildStorePR(a, i32, ru->buildBinaryOp(IR_ADD,
+            i32, ru->buildLoad(x), ru->buildImmInt(1, i32))));
+        ru->addToIRList(ru->buildReturn(ru->buildPRdedicated(a, i32)));
+        return;
+    }
+
+    VAR * g = gs.get(idx % m);
+    ru->addToIRList(ru->buildStore(g, ru->buildBinaryOp(IR_ADD, i32,
+        ru->buildLoad(g), ru->buildImmInt(1, i32))));
+    for (UINT j = idx * 2 + 1; j <= idx * 2 + 2 && j < n; j++) {
+        ru->addToIRList(ru->buildCall(funcs.get(j), NULL));
+    }
+    if (idx == 0) {
+        VAR * l = rm->get_var_mgr()->registerVar("l", i32, 4,
+                                                 VAR_LOCAL|VAR_ADDR_TAKEN);
+        ru->addToVarTab(l);
+        ru->addToIRList(ru->buildStore(l, ru->buildImmInt(0, i32)));
+        ru->addToIRList(ru->buildCall(setp, ru->buildLda(l)));
+        ru->addToIRList(ru->buildStore(gs.get(0), ru->buildLoad(l)));
+    }
+    ru->addToIRList(ru->buildStorePR(a, i32,
+                                     ru->buildLoad(gs.get((idx + 1) % m))));
+    ru->addToIRList(ru->buildReturn(ru->buildPRdedicated(a, i32)));
+}
+
+
+//Count the size of DU information of region.
+static void collectModRefStat(Region * ru, OUT ModRefStat & st)
+{
+    BBList * bbl = ru->get_bb_list();
+    ConstIRIter it;
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            if (ir->is_calls_stmt()) {
+                st.num_call++;
+                if (ir->getRefMDSet() != NULL) {
+                    st.num_call_md += ir->getRefMDSet()->get_elem_count();
+                }
+            }
+
+            it.clean();
+            for (IR const* x = iterInitC(ir, it);
+                 x != NULL; x = iterNextC(it)) {
+                DUSet const* du = x->readDUSet();
+                if (du == NULL) { continue; }
+                st.num_du += du->get_elem_count();
+                if (x->is_stmt() || x->is_pr()) { continue; }
+
+                DUIter di = NULL;
+                for (INT i = du->get_first(&di);
+                     i >= 0; i = du->get_next(i, &di)) {
+                    IR const* d = ru->get_ir((UINT)i);
+                    if (!d->is_calls_stmt()) { continue; }
+                    st.num_clobbered_use++;
+                    if (x->is_ld() &&
+                        !strcmp(SYM_name(LD_idinfo(x)->get_name()), "l")) {
+                        st.is_param_pointee_def = true;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+//Build 'n' functions that access 'm' global VARs, and compute DU chain
+//of them via IPA with or without Mod/Ref summary.
+static void processFunc(UINT n, UINT m, bool modref, OUT ModRefStat & st)
+{
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    VarMgr * vm = rm->get_var_mgr();
+    TypeMgr * tm = rm->get_type_mgr();
+
+    Region * program = rm->newRegion(RU_PROGRAM);
+    program->set_ru_var(vm->registerVar(".program", tm->getMCType(0), 0,
+                                        VAR_GLOBAL|VAR_FAKE));
+    rm->addToRegionTab(program);
+
+    Vector<VAR*> gs;
+    for (UINT i = 0; i < m; i++) {
+        CHAR name[64];
+        sprintf(name, "g%u", i);
+        gs.set(i, vm->registerVar(name, tm->getI32(), 4, VAR_GLOBAL));
+    }
+    Vector<VAR*> funcs;
+    for (UINT i = 0; i < n; i++) {
+        CHAR name[64];
+        sprintf(name, "func%u", i);
+        funcs.set(i, vm->registerVar(name, tm->getMCType(0), 0,
+                                     VAR_GLOBAL|VAR_FAKE));
+    }
+    VAR * setp = vm->registerVar("setp", tm->getMCType(0), 0,
+                                 VAR_GLOBAL|VAR_FAKE);
+    buildSetp(rm, program, setp);
+    for (UINT i = 0; i < n; i++) {
+        buildFunc(rm, program, funcs, gs, setp, i);
+    }
+
+    for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
+        Region * ru = rm->get_region(i);
+        if (ru == NULL || !ru->is_function()) { continue; }
+        OptCtx oc;
+        rm->processFuncRegion(ru, &oc);
+    }
+
+    OptCtx oc;
+    rm->buildCallGraph(oc, true, true);
+    ASSERT0(OC_is_callg_valid(oc));
+    ULONGLONG t = getElapsedUsec();
+    IPA ipa(program);
+    ipa.setComputeModRef(modref);
+    ipa.perform(oc);
+    st.time = getElapsedUsec() - t;
+
+    for (UINT i = 0; i < rm->getNumOfRegion(); i++) {
+        Region * ru = rm->get_region(i);
+        if (ru == NULL || !ru->is_function()) { continue; }
+        if (ru->get_mod_summary() != NULL) {
+            st.num_summary++;
+        }
+        if (ru->get_pass_mgr() == NULL) {
+            ru->initPassMgr();
+        }
+        OptCtx loc;
+        ru->checkValidAndRecompute(&loc, PASS_DU_REF, PASS_CFG,
+                                   PASS_DU_CHAIN, PASS_UNDEF);
+        collectModRefStat(ru, st);
+    }
+    delete rm;
+}
+
+
+int main(int argc, char * argv[])
+{
+    UINT n = argc > 1 ? (UINT)atoi(argv[1]) : 256;
+    UINT m = argc > 2 ? (UINT)atoi(argv[2]) : 16;
+    if (n == 0) { n = 1; }
+    if (m == 0) { m = 1; }
+
+    //Lowered IR refers to PR MD which is not exact.
+    g_is_support_dynamic_type = true;
+    g_opt_level = OPT_LEVEL0;
+    g_tfile = NULL;
+
+    ModRefStat worst;
+    ModRefStat summ;
+    processFunc(n, m, false, worst);
+    processFunc(n, m, true, summ);
+
+    printf("\n%u functions, %u have summary, computed in %lluus",
+           n + 1, summ.num_summary, summ.time);
+    printf("\n%u calls: MayDef MDs %u -> %u",
+           summ.num_call, worst.num_call_md, summ.num_call_md);
+    printf("\nDU set elements: %u -> %u", worst.num_du, summ.num_du);
+    printf("\nUses defined by call: %u -> %u",
+           worst.num_clobbered_use, summ.num_clobbered_use);
+    if (!summ.is_param_pointee_def) {
+        printf("\nFAILED: call does not define the restrict pointee\n");
+        return 1;
+    }
+    if (summ.num_clobbered_use > worst.num_clobbered_use) {
+        printf("\nFAILED: summary adds uses defined by call\n");
+        return 1;
+    }
+    printf("\nPASSED\n");
+    return 0;
+}
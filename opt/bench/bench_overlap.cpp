@@ -0,0 +1,113 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Query the overlapped MDs of each MD in a MDTab by walking through the
+//OffsetTab and by the interval index of OffsetTab, check that both
+//find the same MDs, and measure the time of each way.
+//The MDs are the fields of different size of a synthetic array.
+//Usage: bench_overlap.elf [md_num] [round_num]
+#include "cominc.h"
+#include "comopt.h"
+
+using namespace xoc;
+
+int main(int argc, char * argv[])
+{
+    UINT n = argc > 1 ? (UINT)atoi(argv[1]) : 256;
+    UINT nround = argc > 2 ? (UINT)atoi(argv[2]) : 100;
+    if (n < OFST_TAB_INDEX_THRESHOLD) { n = OFST_TAB_INDEX_THRESHOLD; }
+
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    MDSystem * mdsys = rm->get_md_sys();
+    VAR * v = rm->get_var_mgr()->registerVar("arr",
+        rm->get_type_mgr()->getMCType(n * 4 + 16), 4, VAR_GLOBAL);
+
+    //Field 'i' starts at i*4, the size is 4, 8 or 16 bytes, thus it
+    //overlaps with the next zero, one or three fields.
+    for (UINT i = 0; i < n; i++) {
+        MD md;
+        MD_base(&md) = v;
+        MD_ofst(&md) = i * 4;
+        MD_size(&md) = 4 << (i % 3);
+        MD_ty(&md) = MD_EXACT;
+        mdsys->registerMD(md);
+    }
+    OffsetTab * ofstab = mdsys->get_md_tab(v)->get_ofst_tab();
+    ASSERT0(ofstab->get_elem_count() == n);
+
+    //Sum of MD id is used to check both ways find the same MDs,
+    //since the order of finding may be different.
+    UINT n1 = 0;
+    UINT sum1 = 0;
+    LONG t = getclockstart();
+    for (UINT r = 0; r < nround; r++) {
+        ConstMDIter it1;
+        for (MD const* md = ofstab->get_first(it1, NULL);
+             md != NULL; md = ofstab->get_next(it1, NULL)) {
+            ConstMDIter it2;
+            for (MD const* x = ofstab->get_first(it2, NULL);
+                 x != NULL; x = ofstab->get_next(it2, NULL)) {
+                if (x != md && md->is_overlap(x)) {
+                    n1++;
+                    sum1 += MD_id(x);
+                }
+            }
+        }
+    }
+    float t1 = getclockend(t);
+
+    UINT n2 = 0;
+    UINT sum2 = 0;
+    Vector<MD const*> buf;
+    t = getclockstart();
+    for (UINT r = 0; r < nround; r++) {
+        ConstMDIter it1;
+        ConstMDIter it2;
+        for (MD const* md = ofstab->get_first(it1, NULL);
+             md != NULL; md = ofstab->get_next(it1, NULL)) {
+            UINT num = ofstab->collectOverlap(md, it2, buf);
+            n2 += num;
+            for (UINT i = 0; i < num; i++) {
+                sum2 += MD_id(buf.get(i));
+            }
+        }
+    }
+    float t2 = getclockend(t);
+    delete rm;
+
+    printf("\n%u MD x %u rounds, %u overlapped",
+           n, nround, n1 / MAX(nround, 1));
+    printf("\n  walk: %fsec", t1);
+    printf("\n  interval index: %fsec", t2);
+    if (n1 != n2 || sum1 != sum2) {
+        printf("\nFAILED: interval index finds different MDs\n");
+        return 1;
+    }
+    printf("\nPASSED\n");
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*@
+Copyright (c) 2013-2014, Su Zhenyu steven.known@gmail.com
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+@*/
+//Compile a set of synthetic functions with a new RegionMgr for each
+//function and with one RegionMgr which is reset after each function,
+//check that both ways produce the same IR, and measure the time.
+//Usage: bench_recycle.elf [func_num]
+#include "cominc.h"
+#include "comopt.h"
+
+using namespace xoc;
+
+static FILE * g_dump_new = NULL;
+static FILE * g_dump_recycled = NULL;
+
+//Build function 'idx':
+//    $a = 0; $i = 0;
+//    while ($i < bound) {
+//        $t = $i * k;
+//        if ($t > bound) { x = $t; } else { x = $a; }
+//        $a = $a + x;
+//        g = $a;
+//        $i = $i + 1;
+//    }
+//    return $a;
+//where 'g' is a global VAR kept by RegionMgr and 'x' is a local VAR
+//of the function.
+static Region * buildFunc(RegionMgr * rm, VAR * g, UINT idx)
+{
+    TypeMgr * tm = rm->get_type_mgr();
+    VarMgr * vm = rm->get_var_mgr();
+    Type const* i32 = tm->getI32();
+    CHAR name[64];
+    sprintf(name, "func%u", idx);
+
+    Region * ru = rm->newRegion(RU_FUNC);
+    ru->set_ru_var(vm->registerVar(name, tm->getMCType(0), 0,
+                                   VAR_GLOBAL|VAR_FAKE));
+    rm->addToRegionTab(ru);
+
+    VAR * x = vm->registerVar("x", i32, 4, VAR_LOCAL);
+    ru->addToVarTab(x);
+
+    HOST_INT k = idx % 7 + 2;
+    HOST_INT bound = idx * 13 % 200 + 10;
+    UINT a = ru->buildPrno(i32);
+    UINT i = ru->buildPrno(i32);
+    UINT t = ru->buildPrno(i32);
+    ru->addToIRList(ru->buildStorePR(a, i32, ru->buildImmInt(0, i32)));
+    ru->addToIRList(ru->buildStorePR(i, i32, ru->buildImmInt(0, i32)));
+
+    IR * body = ru->buildStorePR(t, i32, ru->buildBinaryOp(IR_MUL, i32,
+        ru->buildPRdedicated(i, i32), ru->buildImmInt(k, i32)));
+    xcom::add_next(&body, ru->buildIf(
+        ru->buildCmp(IR_GT, ru->buildPRdedicated(t, i32),
+                     ru->buildImmInt(bound, i32)),
+        ru->buildStore(x, ru->buildPRdedicated(t, i32)),
+        ru->buildStore(x, ru->buildPRdedicated(a, i32))));
+    xcom::add_next(&body, ru->buildStorePR(a, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(a, i32), ru->buildLoad(x))));
+    xcom::add_next(&body, ru->buildStore(g, ru->buildPRdedicated(a, i32)));
+    xcom::add_next(&body, ru->buildStorePR(i, i32, ru->buildBinaryOp(
+        IR_ADD, i32, ru->buildPRdedicated(i, i32), ru->buildImmInt(1, i32))));
+    ru->addToIRList(ru->buildWhileDo(ru->buildCmp(IR_LT,
+        ru->buildPRdedicated(i, i32), ru->buildImmInt(bound, i32)), body));
+    ru->addToIRList(ru->buildReturn(ru->buildPRdedicated(a, i32)));
+    return ru;
+}
+
+
+//Create RegionMgr and the global VAR 'g' shared by all functions.
+static RegionMgr * createRegionMgr(OUT VAR ** g)
+{
+    RegionMgr * rm = new RegionMgr();
+    rm->initVarMgr();
+    *g = rm->get_var_mgr()->registerVar("g", rm->get_type_mgr()->getI32(),
+                                        4, VAR_GLOBAL);
+    return rm;
+}
+
+
+//Compile function 'idx' and dump the result to 'dump'.
+static void compileFunc(RegionMgr * rm, VAR * g, UINT idx, FILE * dump)
+{
+    Region * ru = buildFunc(rm, g, idx);
+    OptCtx oc;
+    bool succ = rm->processFuncRegion(ru, &oc);
+    ASSERT0(succ);
+    UNUSED(succ);
+
+    FILE * org = g_tfile;
+    g_tfile = dump;
+    fprintf(dump, "\n==-- %s: VAR %d, MD %u --==",
+            ru->get_ru_name(),
+            rm->get_var_mgr()->get_var_vec()->get_last_idx(),
+            rm->get_md_sys()->get_num_of_md());
+    dump_irs(ru->constructIRlist(true), rm->get_type_mgr());
+    g_tfile = org;
+}
+
+
+//Return true if the content of 'f1' and 'f2' are identical.
+static bool is_same_file(FILE * f1, FILE * f2)
+{
+    rewind(f1);
+    rewind(f2);
+    INT c1, c2;
+    do {
+        c1 = fgetc(f1);
+        c2 = fgetc(f2);
+    } while (c1 == c2 && c1 != EOF);
+    return c1 == c2;
+}
+
+
+int main(int argc, char * argv[])
+{
+    UINT n = argc > 1 ? (UINT)atoi(argv[1]) : 1000;
+
+    //Lowered IR refers to PR MD which is not exact.
+    g_is_support_dynamic_type = true;
+    g_opt_level = OPT_LEVEL3;
+    g_tfile = NULL;
+
+    g_dump_new = tmpfile();
+    g_dump_recycled = tmpfile();
+    ASSERT0(g_dump_new && g_dump_recycled);
+
+    LONG start = getclockstart();
+    for (UINT i = 0; i < n; i++) {
+        VAR * g;
+        RegionMgr * rm = createRegionMgr(&g);
+        compileFunc(rm, g, i, g_dump_new);
+        delete rm;
+    }
+    float newRM = getclockend(start);
+
+    start = getclockstart();
+    VAR * g;
+    RegionMgr * recycled = createRegionMgr(&g);
+    recycled->setResetPoint();
+    for (UINT i = 0; i < n; i++) {
+        compileFunc(recycled, g, i, g_dump_recycled);
+        recycled->reset();
+    }
+    delete recycled;
+    float recycledRM = getclockend(start);
+
+    bool same = is_same_file(g_dump_new, g_dump_recycled);
+    fclose(g_dump_new);
+    fclose(g_dump_recycled);
+
+    printf("\n%u functions", n);
+    printf("\n  new RegionMgr per function: %fus",
+           newRM * 1e6 / n);
+    printf("\n  recycled RegionMgr: %fus",
+           recycledRM * 1e6 / n);
+    printf("\n%s\n", same ? "PASSED" : "FAILED: IR differs");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,2 @@
+g++ $1 ../../libxoc.a -DFOR_DEX -D_DEBUG_ -O0 -g2 -I.. -I../../com \
+    -I../../dex -I../.. -lpthread -o ${1%.cpp}.elf
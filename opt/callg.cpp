@@ -320,6 +320,101 @@ bool CallGraph::build(RegionMgr * rumgr)
 
     return true;
 }
+
+
+//Compute the level of SCC that members recorded in 'members'.
+static UINT computeSCCLevel(
+        Graph const* g,
+        UINT scc,
+        List<UINT> & members,
+        Vector<UINT> const& cn2scc,
+        Vector<UINT> const& scc2level)
+{
+    UINT level = 0;
+    for (UINT id = members.get_head(); id != 0; id = members.get_next()) {
+        Vertex * v = g->get_vertex(id);
+        for (EdgeC * el = VERTEX_out_list(v); el != NULL; el = EC_next(el)) {
+            UINT to = cn2scc.get(VERTEX_id(EDGE_to(EC_edge(el))));
+            ASSERT0(to != 0 && to <= scc);
+            if (to == scc) { continue; }
+            level = MAX(level, scc2level.get(to) + 1);
+        }
+    }
+    return level;
+}
+
+
+//Compute strongly connected components via Tarjan's algorithm.
+//The depth first search is performed without recursion since
+//the call chain may be very deep.
+UINT CallGraph::computeBottomUpSCC(
+        OUT Vector<UINT> & cn2scc,
+        OUT Vector<UINT> & scc2level)
+{
+    cn2scc.clean();
+    scc2level.clean();
+    Vector<UINT> dfn;
+    Vector<UINT> low;
+    Vector<EdgeC*> cur; //the next out edge to be visited.
+    Stack<UINT> wl;
+    Stack<UINT> sccstk;
+    List<UINT> members;
+    UINT dfn_count = 1;
+    UINT scc_count = 0;
+
+    //Visit vertices in the order of id to make SCC id stable.
+    for (INT i = 1; i <= m_cnid2cn.get_last_idx(); i++) {
+        Vertex * root = get_vertex((UINT)i);
+        if (root == NULL || dfn.get((UINT)i) != 0) { continue; }
+
+        dfn.set((UINT)i, dfn_count);
+        low.set((UINT)i, dfn_count);
+        dfn_count++;
+        cur.set((UINT)i, VERTEX_out_list(root));
+        wl.push((UINT)i);
+        sccstk.push((UINT)i);
+        while (wl.get_elem_count() != 0) {
+            UINT t = wl.get_top();
+            EdgeC * el = cur.get(t);
+            if (el != NULL) {
+                cur.set(t, EC_next(el));
+                UINT s = VERTEX_id(EDGE_to(EC_edge(el)));
+                if (dfn.get(s) == 0) {
+                    dfn.set(s, dfn_count);
+                    low.set(s, dfn_count);
+                    dfn_count++;
+                    cur.set(s, VERTEX_out_list(get_vertex(s)));
+                    wl.push(s);
+                    sccstk.push(s);
+                } else if (cn2scc.get(s) == 0) {
+                    //s is still in sccstk.
+                    low.set(t, MIN(low.get(t), dfn.get(s)));
+                }
+                continue;
+            }
+
+            //All successors of t have been visited.
+            wl.pop();
+            if (low.get(t) == dfn.get(t)) {
+                scc_count++;
+                members.clean();
+                UINT m;
+                do {
+                    m = sccstk.pop();
+                    cn2scc.set(m, scc_count);
+                    members.append_tail(m);
+                } while (m != t);
+                scc2level.set(scc_count, computeSCCLevel(this, scc_count,
+                              members, cn2scc, scc2level));
+            }
+            if (wl.get_elem_count() != 0) {
+                UINT p = wl.get_top();
+                low.set(p, MIN(low.get(p), low.get(t)));
+            }
+        }
+    }
+    return scc_count;
+}
 //END CallGraph
 
 } //namespace xoc
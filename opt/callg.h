@@ -146,6 +146,17 @@ public:
     void computeEntryList(List<CallNode*> & elst);
     void computeExitList(List<CallNode*> & elst);
 
+    //Compute strongly connected components of call graph.
+    //'cn2scc': map CallNode id to SCC id, SCC id starts from 1.
+    //'scc2level': map SCC id to level, the level of SCC that does not
+    //    call others is 0, otherwise it is 1 plus the maximum level of
+    //    the SCCs called.
+    //SCC ids are numbered in bottom-up order, namely, callees are
+    //numbered before callers. SCCs in same level do not call each other.
+    //Return the number of SCC.
+    UINT computeBottomUpSCC(OUT Vector<UINT> & cn2scc,
+                            OUT Vector<UINT> & scc2level);
+
     //name: file name if you want to dump VCG to specified file.
     //flag: default is 0xFFFFffff(-1) means doing dumping
     //        with completely information.
@@ -127,6 +127,40 @@ void CDG::rebuild(IN OUT OptCtx & oc, DGraph & cfg)
 }
 
 
+//Sort vertices of 'tree' in postorder, the kid is placed before its
+//parent. 'tree' may have multiple roots.
+static void sortTreeInPostorder(Graph & tree, OUT Vector<UINT> & order)
+{
+    order.clean();
+    Vector<EdgeC*> cursor;
+    Stack<Vertex*> stk;
+    UINT pos = 0;
+    INT c;
+    for (Vertex * r = tree.get_first_vertex(c);
+         r != NULL; r = tree.get_next_vertex(c)) {
+        if (VERTEX_in_list(r) != NULL) { continue; }
+
+        cursor.set(VERTEX_id(r), VERTEX_out_list(r));
+        stk.push(r);
+        Vertex * x;
+        while ((x = stk.get_top()) != NULL) {
+            EdgeC * ec = cursor.get(VERTEX_id(x));
+            if (ec == NULL) {
+                order.set(pos, VERTEX_id(x));
+                pos++;
+                stk.pop();
+                continue;
+            }
+            cursor.set(VERTEX_id(x), EC_next(ec));
+            Vertex * kid = EDGE_to(EC_edge(ec));
+            cursor.set(VERTEX_id(kid), VERTEX_out_list(kid));
+            stk.push(kid);
+        }
+    }
+    ASSERT0(pos == tree.get_vertex_num());
+}
+
+
 void CDG::build(IN OUT OptCtx & oc, DGraph & cfg)
 {
     if (cfg.get_vertex_num() == 0) { return; }
@@ -139,8 +173,10 @@ void CDG::build(IN OUT OptCtx & oc, DGraph & cfg)
     cfg.get_pdom_tree(pdom_tree);
     if (pdom_tree.get_vertex_num() == 0) { return; }
 
+    //Each vertex should be processed after the vertices it
+    //post-dominates, namely the kids in post-dominator tree.
     Vector<UINT> top_order;
-    pdom_tree.sortInToplogOrder(top_order, false);
+    sortTreeInPostorder(pdom_tree, top_order);
     //dumpIntVector(top_order);
 
     BitSetMgr bs_mgr;
@@ -168,22 +204,25 @@ void CDG::build(IN OUT OptCtx & oc, DGraph & cfg)
             }
             in = EC_next(in);
         }
-        INT c;
-        for (Vertex * z = cfg.get_first_vertex(c);
-             z != NULL; z = cfg.get_next_vertex(c)) {
-            if (((DGraph&)cfg).get_ipdom(VERTEX_id(z)) == VERTEX_id(v)) {
-                BitSet * cd = cd_set.get(VERTEX_id(z));
-                if (cd == NULL) {
-                    cd = bs_mgr.create();
-                    cd_set.set(VERTEX_id(z), cd);
-                }
-                for (INT i = cd->get_first(); i != -1; i = cd->get_next(i)) {
-                    if (VERTEX_id(v) != ((DGraph&)cfg).get_ipdom(i)) {
-                        cd_of_v->bunion(i);
-                        //if (i != (INT)VERTEX_id(v))
-                        {
-                            addEdge(i, VERTEX_id(v));
-                        }
+        //Access each vertex z whose ipdom is v, namely the kid of v in
+        //post-dominator tree.
+        Vertex const* tv = pdom_tree.get_vertex(VERTEX_id(v));
+        ASSERT0(tv);
+        for (EdgeC const* out = VERTEX_out_list(tv);
+             out != NULL; out = EC_next(out)) {
+            UINT z = VERTEX_id(EDGE_to(EC_edge(out)));
+            ASSERT0(((DGraph&)cfg).get_ipdom(z) == VERTEX_id(v));
+            BitSet * cd = cd_set.get(z);
+            if (cd == NULL) {
+                cd = bs_mgr.create();
+                cd_set.set(z, cd);
+            }
+            for (INT i = cd->get_first(); i != -1; i = cd->get_next(i)) {
+                if (VERTEX_id(v) != ((DGraph&)cfg).get_ipdom(i)) {
+                    cd_of_v->bunion(i);
+                    //if (i != (INT)VERTEX_id(v))
+                    {
+                        addEdge(i, VERTEX_id(v));
                     }
                 }
             }
@@ -398,6 +398,14 @@ public:
     bool removeUnreachBB();
     bool removeRedundantBranch();
 
+    //Update dominator and post-dominator locally after CFG changed.
+    //The information that can not be updated is set to be invalid
+    //in 'oc'.
+    void updateDomForInsertedBB(BB const* newbb,
+                                BB const* succ,
+                                OptCtx & oc);
+    void updateDomForRemovedBB(BB const* bb, BB const* succ, OptCtx & oc);
+
     //Insert unconditional branch to revise fall through bb.
     //e.g: Given bblist is bb1-bb2-bb3-bb4, bb4 is exit-BB,
     //and flow edges are: bb1->bb2->bb3->bb4, bb1->bb3,
@@ -670,6 +678,8 @@ bool CFG<BB, XR>::removeEmptyBB(OptCtx & oc)
                     bb->removeSuccessorPhiOpnd(this);
                     //resetMapBetweenLabelAndBB(bb); BB does not have Labels.
                     remove_bb(ct);
+                    OC_is_dom_valid(oc) = false;
+                    OC_is_pdom_valid(oc) = false;
                     doit = true;
                 }
                 continue;
@@ -770,6 +780,12 @@ bool CFG<BB, XR>::removeEmptyBB(OptCtx & oc)
             //The map between bb and its Labels has changed.
             //resetMapBetweenLabelAndBB(bb);
             remove_bb(bb);
+            if (succs.get_elem_count() == 1 && succs.get_head() == next_bb) {
+                updateDomForRemovedBB(bb, next_bb, oc);
+            } else {
+                OC_is_dom_valid(oc) = false;
+                OC_is_pdom_valid(oc) = false;
+            }
             doit = true;
         } //end if
     } //end for each bb
@@ -778,6 +794,54 @@ bool CFG<BB, XR>::removeEmptyBB(OptCtx & oc)
 }
 
 
+//Update dominator after 'newbb' has been inserted before 'succ',
+//where 'succ' is the unique successor of 'newbb'.
+template <class BB, class XR>
+void CFG<BB, XR>::updateDomForInsertedBB(
+        BB const* newbb,
+        BB const* succ,
+        OptCtx & oc)
+{
+    if (OC_is_dom_valid(oc) && !insertVertexToDomTree(newbb->id, succ->id)) {
+        OC_is_dom_valid(oc) = false;
+    }
+    if (OC_is_pdom_valid(oc) &&
+        !insertVertexToPdomTree(newbb->id, succ->id)) {
+        OC_is_pdom_valid(oc) = false;
+    }
+    if (g_verify_level >= VERIFY_LEVEL_2) {
+        ASSERT0(verifyDomTree(OC_is_dom_valid(oc), OC_is_pdom_valid(oc)));
+    }
+
+    //CDG and RPO are not updated.
+    OC_is_cdg_valid(oc) = false;
+    OC_is_rpo_valid(oc) = false;
+}
+
+
+//Update dominator after 'bb' has been removed, where 'succ' was the
+//unique successor of 'bb'.
+template <class BB, class XR>
+void CFG<BB, XR>::updateDomForRemovedBB(
+        BB const* bb,
+        BB const* succ,
+        OptCtx & oc)
+{
+    if (OC_is_dom_valid(oc) && !removeVertexFromDomTree(bb->id, succ->id)) {
+        OC_is_dom_valid(oc) = false;
+    }
+    if (OC_is_pdom_valid(oc) &&
+        !removeVertexFromPdomTree(bb->id, succ->id)) {
+        OC_is_pdom_valid(oc) = false;
+    }
+    if (g_verify_level >= VERIFY_LEVEL_2) {
+        ASSERT0(verifyDomTree(OC_is_dom_valid(oc), OC_is_pdom_valid(oc)));
+    }
+    OC_is_cdg_valid(oc) = false;
+    OC_is_rpo_valid(oc) = false;
+}
+
+
 //Remove redundant branch edge.
 template <class BB, class XR>
 bool CFG<BB, XR>::removeRedundantBranchCase1(
@@ -1433,9 +1497,7 @@ bool CFG<BB, XR>::find_loop()
             BB * succ = get_bb(VERTEX_id(EDGE_to(EC_edge(el))));
             ASSERT0(succ);
 
-            BitSet * dom = m_dom_set.get(bb->id);
-            ASSERT(dom, ("should compute dominator first"));
-            if (!dom->is_contain(succ->id)) { continue; }
+            if (!is_dom(succ->id, bb->id)) { continue; }
 
             //If the SUCC is one of the DOMINATOR of bb, then it
             //indicates a back-edge.
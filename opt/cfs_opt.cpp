@@ -208,7 +208,9 @@ bool IR_CFS_OPT::transformIf1(IR ** head, IR * ir)
                             LAB_lab(IR_next(second_goto)))) {
 
                 //Start transforming.
-                m_ru->invertCondition(&IF_det(ir));
+                IR * det = IF_det(ir);
+                m_ru->invertCondition(&det);
+                IF_det(ir) = det;
                 IR * new_list1 = NULL;
                 IR * new_list2 = NULL;
 
@@ -290,7 +292,9 @@ bool IR_CFS_OPT::transformIf2(IR ** head, IR * ir)
             m_ru->freeIRTree(ir);
             return true;
         }
-        m_ru->invertCondition(&IF_det(ir));
+        IR * det = IF_det(ir);
+        m_ru->invertCondition(&det);
+        IF_det(ir) = det;
         IF_truebody(ir) = IF_falsebody(ir);
         IF_falsebody(ir) = NULL;
         return true;
@@ -511,12 +515,12 @@ bool IR_CFS_OPT::perform_cfs_optimization(IN OUT IR ** ir_list,
                 ir = *ir_list;
                 continue;
             }
-            if (perform_cfs_optimization(&IF_truebody(ir), sc)) {
+            if (perform_cfs_optimization_kid(&IF_truebody(ir), sc)) {
                 change = true;
                 ir = *ir_list;
                 continue;
             }
-            if (perform_cfs_optimization(&IF_falsebody(ir), sc)) {
+            if (perform_cfs_optimization_kid(&IF_falsebody(ir), sc)) {
                 change = true;
                 ir = *ir_list;
                 continue;
@@ -530,14 +534,14 @@ bool IR_CFS_OPT::perform_cfs_optimization(IN OUT IR ** ir_list,
                 ir = *ir_list;
                 continue;
             }
-            if (perform_cfs_optimization(&LOOP_body(ir), sc)) {
+            if (perform_cfs_optimization_kid(&LOOP_body(ir), sc)) {
                 change = true;
                 ir = *ir_list;
                 continue;
             }
             break;
         case IR_SWITCH:
-            if (perform_cfs_optimization(&SWITCH_body(ir), sc)) {
+            if (perform_cfs_optimization_kid(&SWITCH_body(ir), sc)) {
                 change = true;
                 ir = *ir_list;
                 continue;
@@ -48,6 +48,15 @@ protected:
     bool transformIf5(IR ** head, IR * ir);
     bool hoistLoop(IR ** head, IR * ir);
     bool hoistIf(IR ** head, IR * ir);
+
+    //Perform optimization on the stmt list that held by kid of IR.
+    bool perform_cfs_optimization_kid(IN OUT IRLink * kid, SimpCtx const& sc)
+    {
+        IR * ir_list = *kid;
+        bool change = perform_cfs_optimization(&ir_list, sc);
+        *kid = ir_list;
+        return change;
+    }
 public:
     IR_CFS_OPT(Region * ru) { m_ru = ru; m_tm = ru->get_type_mgr(); }
     ~IR_CFS_OPT() {}
@@ -46,7 +46,9 @@ author: Su Zhenyu
 #include "pass.h"
 #include "ai.h"
 #include "du.h"
+#include "ir_slab.h"
 #include "ir.h"
+#include "ir_iter.h"
 #include "ir_bb.h"
 #include "ir_refine.h"
 #include "ir_simp.h"
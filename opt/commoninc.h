@@ -55,6 +55,7 @@ author: Su Zhenyu
 #include "rational.h"
 #include "flty.h"
 #include "xmat.h"
+#include "sthread.h"
 
 using namespace xcom;
 
@@ -35,21 +35,22 @@ author: Su Zhenyu
 #include "prssainfo.h"
 #include "prdf.h"
 #include "ir_ssa.h"
-//#include "ir_mdssa.h"
+#include "ir_mdssa.h"
 #include "cfs_mgr.h"
 #include "cfs_opt.h"
 #include "goto_opt.h"
 #include "if_opt.h"
 #include "ir_gvn.h"
+#include "ir_sgvn.h"
 #include "ir_lcse.h"
 #include "ir_gcse.h"
 #include "ir_dce.h"
 #include "ir_rce.h"
-//#include "ir_dse.h"
+#include "ir_dse.h"
 //#include "ir_vrp.h"
 #include "ir_cp.h"
-//#include "ir_ccp.h"
-//#include "ir_pre.h"
+#include "ir_ccp.h"
+#include "ir_pre.h"
 #include "ir_rp.h"
 //#include "ir_poly.h"
 #include "ir_licm.h"
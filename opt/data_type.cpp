@@ -195,6 +195,7 @@ DATA_TYPE TypeMgr::hoistBSdtype(UINT bit_size, bool is_signed) const
 //Return ty-idx in m_type_tab.
 TypeContainer const* TypeMgr::registerPointer(Type const* type)
 {
+    MutexHolder h(m_lock);
     ASSERT0(type && type->is_pointer());
     //Insertion Sort by ptr-base-size in incrmental order.
     //e.g: Given PTR, base_size=32,
@@ -227,6 +228,7 @@ TypeContainer const* TypeMgr::registerPointer(Type const* type)
 //e.g: vector<I8,I8,I8,I8> type, which mc_size is 32 byte, vec-type is D_I8.
 TypeContainer const* TypeMgr::registerVector(Type const* type)
 {
+    MutexHolder h(m_lock);
     ASSERT0(type->is_vector() && TY_vec_ety(type) != D_UNDEF);
     ASSERT0(TY_vec_size(type) >= get_dtype_bytesize(TY_vec_ety(type)) &&
              TY_vec_size(type) % get_dtype_bytesize(TY_vec_ety(type)) == 0);
@@ -266,6 +268,7 @@ FIN:
 
 TypeContainer const* TypeMgr::registerMC(Type const* type)
 {
+    MutexHolder h(m_lock);
     ASSERT0(type);
     //Insertion Sort by mc-size in incrmental order.
     //e.g:Given MC, mc_size=32
@@ -295,6 +298,7 @@ TypeContainer const* TypeMgr::registerMC(Type const* type)
 //Register simplex type, e.g:INT, UINT, FP, BOOL.
 TypeContainer const* TypeMgr::registerSimplex(Type const* type)
 {
+    MutexHolder h(m_lock);
     ASSERT0(type);
     TypeContainer ** head = &m_simplex_type[TY_dtype(type)];
     if (*head == NULL) {
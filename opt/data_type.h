@@ -288,7 +288,7 @@ public:
 };
 
 
-class MCTab : public TMap<Type const*, TypeContainer const*, ComareTypeMC> {
+class MCTab : public BTMap<Type const*, TypeContainer const*, ComareTypeMC> {
 public:
 };
 
@@ -304,7 +304,7 @@ public:
 
 
 class PointerTab : public
-    TMap<Type const*, TypeContainer const*, ComareTypePointer> {
+    BTMap<Type const*, TypeContainer const*, ComareTypePointer> {
 public:
 };
 
@@ -320,7 +320,7 @@ public:
 
 
 class ElemTypeTab : public
-    TMap<Type const*, TypeContainer const*, ComareTypeVectoElemType> {
+    BTMap<Type const*, TypeContainer const*, ComareTypeVectoElemType> {
 };
 
 typedef TMapIter<Type const*, ElemTypeTab*> ElemTypeTabIter;
@@ -337,14 +337,17 @@ public:
 
 
 //MD hashed by MD_ofst.
-class VectorTab : public TMap<Type const*, ElemTypeTab*, ComareTypeVector> {
+class VectorTab : public BTMap<Type const*, ElemTypeTab*, ComareTypeVector> {
 public:
 };
 
 
 extern TypeDesc const g_type_desc[];
 class TypeMgr {
-    Vector<Type*> m_type_tab;
+    Mutex * m_lock;
+    //The table is read without lock, the buffer is kept while growing
+    //if lock is set.
+    KeepBufVector<Type*> m_type_tab;
     SMemPool * m_pool;
     PointerTab m_pointer_type_tab;
     MCTab m_memorychunk_type_tab;
@@ -399,6 +402,7 @@ class TypeMgr {
 public:
     TypeMgr()
     {
+        m_lock = NULL;
         m_type_tab.clean();
         m_pool = smpoolCreate(sizeof(Type) * 8, MEM_COMM);
         m_type_count = 1;
@@ -451,6 +455,15 @@ public:
     TypeContainer const* registerSimplex(Type const* ty);
     Type * registerType(Type const* dtd);
 
+    //Set the lock to protect TypeMgr from being accessed by multiple
+    //threads simultaneously. 'lock' may be NULL if there is only one
+    //thread.
+    void set_lock(Mutex * lock)
+    {
+        m_lock = lock;
+        m_type_tab.set_keep_old_buf(lock != NULL);
+    }
+
     CHAR const* dump_type(Type const* dtd, OUT StrBuf & buf);
     void dump_type(Type const* dtd);
     void dump_type(UINT tyid);
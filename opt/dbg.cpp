@@ -35,7 +35,7 @@ author: Su Zhenyu
 
 namespace xoc {
 
-DbxMgr * g_dbx_mgr = NULL;
+THREAD_LOCAL DbxMgr * g_dbx_mgr = NULL;
 
 void set_lineno(IR * ir, UINT lineno, Region * ru)
 {
@@ -65,7 +65,8 @@ public:
 
 
 //User need to initialize DbxMgr before compilation.
-extern DbxMgr * g_dbx_mgr;
+//It is thread local, each compilation thread has to initialize it.
+extern THREAD_LOCAL DbxMgr * g_dbx_mgr;
 
 //Copy Dbx from src.
 void copyDbx(IR * tgt, IR const* src, Region * ru);
@@ -68,6 +68,313 @@ Region * IPA::findRegion(IR * call, Region * callru)
 }
 
 
+//Collect MDs that referenced by function region, they are used to
+//compute the Mod/Ref summary.
+//Only global MDs are recorded since local MDs are invisible to caller.
+//The MD that restrict parameter pointed to is not recorded, caller
+//maps it to the MDs that actual parameter pointed to.
+//MD_ALL_MEM and MD_GLOBAL_MEM indicate that IR accesses unknown
+//memory, e.g: memory reachable from non-restrict parameter, and heap
+//object is invisible to caller, then the summary of function is not
+//available.
+//Note the MD set of IR that has exact MD is the overlapping MD set
+//of the exact one, which always contains MD_GLOBAL_MEM if the exact
+//one is global, thus only the exact MD is recorded. And so is the
+//MD set of call that has Mod/Ref summary of callee.
+class ModRefCollector : public IRVisitor<ModRefCollector> {
+    COPY_CONSTRUCTOR(ModRefCollector);
+    Region * m_ru;
+    MDSystem * m_md_sys;
+    IR_AA * m_aa;
+    MDSet & m_mod;
+    MDSet & m_ref;
+    DefMiscBitSetMgr & m_sbs_mgr;
+
+    bool isUnknown(MD const* md) const
+    { return MD_id(md) == MD_ALL_MEM || MD_id(md) == MD_GLOBAL_MEM; }
+public:
+    bool is_unknown;
+
+    ModRefCollector(Region * ru, MDSet & mod, MDSet & ref,
+                    DefMiscBitSetMgr & sbs_mgr) :
+        m_ru(ru), m_md_sys(ru->get_md_sys()), m_aa(ru->get_aa()),
+        m_mod(mod), m_ref(ref), m_sbs_mgr(sbs_mgr)
+    {
+        ASSERT0(m_aa);
+        is_unknown = false;
+    }
+
+    void add(MD const* md, MDSet & output)
+    {
+        if (md == NULL || md->is_pr()) { return; }
+        if (isUnknown(md)) {
+            is_unknown = true;
+            return;
+        }
+        VAR const* v = md->get_base();
+        if (!VAR_is_global(v) || m_aa->isParamPointee(v)) { return; }
+        if (m_aa->isHeapObj(v)) {
+            is_unknown = true;
+            return;
+        }
+        output.bunion(md, m_sbs_mgr);
+    }
+
+    void add(MDSet const* mds, MDSet & output)
+    {
+        if (mds == NULL) { return; }
+        SEGIter * iter;
+        for (INT i = mds->get_first(&iter);
+             i >= 0 && !is_unknown; i = mds->get_next(i, &iter)) {
+            add(m_md_sys->get_md((UINT)i), output);
+        }
+    }
+
+    //Record the MDs that 'ir' referenced.
+    void add(IR const* ir, MDSet & output)
+    {
+        MD const* md = ir->getRefMD();
+        if (md != NULL && !isUnknown(md)) {
+            add(md, output);
+            return;
+        }
+        add(ir->getRefMDSet(), output);
+    }
+
+    //Record the MDs that call referenced via the Mod/Ref summary of
+    //callee and the MDs that actual parameters pointed to.
+    //Return false if callee does not have summary.
+    bool addCallBySummary(IR const* ir)
+    {
+        CallGraph * callg = m_ru->get_region_mgr()->get_call_graph();
+        if (callg == NULL || !ir->is_call()) { return false; }
+        Region * callee = callg->mapCall2Region(ir, m_ru);
+        if (callee == NULL || callee->get_mod_summary() == NULL) {
+            return false;
+        }
+        add(callee->get_mod_summary(), m_mod);
+        add(callee->get_ref_summary(), m_ref);
+
+        MDSet pts;
+        DefMiscBitSetMgr * sbs = m_ru->getMiscBitSetMgr();
+        for (IR * p = CALL_param_list(ir); p != NULL; p = p->get_next()) {
+            if (!p->is_ptr()) { continue; }
+            m_aa->computeMayPointTo(p, pts);
+        }
+        add(&pts, m_mod);
+        add(&pts, m_ref);
+        pts.clean(*sbs);
+        return true;
+    }
+
+    bool visitStmt(IR const* ir)
+    {
+        if (ir->is_calls_stmt()) {
+            if (!addCallBySummary(ir)) {
+                //MayDef MDSet of call has taken the parameters into
+                //account. Regard it as MayUse.
+                add(ir->getRefMDSet(), m_mod);
+                add(ir->getRefMDSet(), m_ref);
+            }
+        } else if (ir->is_region()) {
+            Region * ru = REGION_ru(ir);
+            if (ru->get_may_def() == NULL || ru->get_may_use() == NULL) {
+                is_unknown = true;
+            } else {
+                add(ru->get_may_def(), m_mod);
+                add(ru->get_may_use(), m_ref);
+            }
+        } else if (ir->is_memory_ref()) {
+            add(ir, m_mod);
+        }
+        return !is_unknown;
+    }
+
+    bool visitMemOpnd(IR const* x)
+    {
+        ASSERT0(x->get_parent());
+        if ((x->is_id() || x->is_ld()) && x->get_parent()->is_lda()) {
+            //Address is taken, memory is not read.
+            return true;
+        }
+        add(x, m_ref);
+        return !is_unknown;
+    }
+};
+
+
+//Recompute MD reference of region, the reference of call will make
+//use of the Mod/Ref summary of callee.
+void IPA::recomputeDURef(Region * ru)
+{
+    if (ru->get_pass_mgr() == NULL) {
+        ru->initPassMgr();
+    }
+    OptCtx oc;
+    ru->checkValidAndRecompute(&oc, PASS_DU_REF, PASS_CFG, PASS_UNDEF);
+}
+
+
+//Compute the MDs that function region may modify and read.
+//Return false if region accesses unknown memory, then the summary is
+//not available.
+bool IPA::collectModRef(Region * ru, OUT MDSet & mod, OUT MDSet & ref)
+{
+    mod.clean(m_sbs_mgr);
+    ref.clean(m_sbs_mgr);
+    BBList * bbl = ru->get_bb_list();
+    if (bbl == NULL || bbl->get_elem_count() == 0) {
+        //The body of region is unavailable, e.g: native or abstract
+        //method, or IR has been freed. Callee may access any memory.
+        return false;
+    }
+
+    recomputeDURef(ru);
+
+    ModRefCollector c(ru, mod, ref, m_sbs_mgr);
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            //Stmt is accessed one by one, siblings are not visited.
+            c.visitStmt(ir);
+            if (c.is_unknown || !c.visitRhs(ir)) { return false; }
+        }
+    }
+    return !c.is_unknown;
+}
+
+
+void IPA::invalidModRefSummary(Region * ru)
+{
+    RefInfo * ri = REGION_refinfo(ru);
+    if (ri == NULL) { return; }
+    REF_INFO_is_modref_valid(ri) = false;
+    REF_INFO_mod(ri).clean(*ru->getMiscBitSetMgr());
+    REF_INFO_ref(ri).clean(*ru->getMiscBitSetMgr());
+}
+
+
+//Return true if regions in 'rus' call each other, or the only region
+//calls itself.
+bool IPA::isRecursive(List<Region*> & rus)
+{
+    if (rus.get_elem_count() > 1) { return true; }
+    CallGraph * cg = m_rumgr->get_call_graph();
+    CallNode * cn = cg->mapRegion2CallNode(rus.get_head());
+    ASSERT0(cn);
+    return cg->get_edge(CN_id(cn), CN_id(cn)) != NULL;
+}
+
+
+//Compute the Mod/Ref summary for function regions in same SCC of
+//call graph.
+//The summary of recursive functions is computed optimistically, that
+//is, the functions are assumed to access nothing at first, then the
+//summaries are recomputed until they do not change.
+void IPA::computeModRefSummary(List<Region*> & rus, bool is_recursive)
+{
+    for (Region * ru = rus.get_head(); ru != NULL; ru = rus.get_next()) {
+        ru->initRefInfo();
+        invalidModRefSummary(ru);
+        REF_INFO_is_modref_valid(REGION_refinfo(ru)) = is_recursive;
+    }
+
+    MDSet mod;
+    MDSet ref;
+    UINT count = 0;
+    bool change = true;
+    while (change) {
+        change = false;
+        for (Region * ru = rus.get_head(); ru != NULL; ru = rus.get_next()) {
+            RefInfo * ri = REGION_refinfo(ru);
+            DefMiscBitSetMgr * sbs = ru->getMiscBitSetMgr();
+            if (!collectModRef(ru, mod, ref)) {
+                if (REF_INFO_is_modref_valid(ri)) {
+                    invalidModRefSummary(ru);
+                    change = true;
+                }
+                continue;
+            }
+            if (!REF_INFO_is_modref_valid(ri)) {
+                if (count != 0) {
+                    //Summary will not be available once it became
+                    //unavailable.
+                    continue;
+                }
+                REF_INFO_is_modref_valid(ri) = true;
+            }
+            if (!REF_INFO_mod(ri).is_equal(mod)) {
+                REF_INFO_mod(ri).copy(mod, *sbs);
+                change = true;
+            }
+            if (!REF_INFO_ref(ri).is_equal(ref)) {
+                REF_INFO_ref(ri).copy(ref, *sbs);
+                change = true;
+            }
+        }
+
+        if (!is_recursive) { break; }
+
+        count++;
+        if (change && count >= IPA_MODREF_ITER_LIMIT) {
+            //Give up, and the MD reference that computed with
+            //intermediate summary has to be recomputed.
+            for (Region * ru = rus.get_head(); ru != NULL;
+                 ru = rus.get_next()) {
+                invalidModRefSummary(ru);
+            }
+            for (Region * ru = rus.get_head(); ru != NULL;
+                 ru = rus.get_next()) {
+                recomputeDURef(ru);
+            }
+            break;
+        }
+    }
+    mod.clean(m_sbs_mgr);
+    ref.clean(m_sbs_mgr);
+}
+
+
+//Compute the Mod/Ref summary for each function region in bottom-up
+//order of call graph. The MD reference of caller is recomputed after
+//the summaries of callees are available, thus the call only modifies
+//and reads the MDs that callee referenced instead of the worst case.
+void IPA::computeModRefSummary(OptCtx & oc)
+{
+    ASSERT0(OC_is_callg_valid(oc));
+    UNUSED(oc);
+    CallGraph * cg = m_rumgr->get_call_graph();
+    ASSERT0(cg);
+    Vector<UINT> cn2scc;
+    Vector<UINT> scc2level;
+    UINT sccnum = cg->computeBottomUpSCC(cn2scc, scc2level);
+
+    //Map SCC to its function regions.
+    Vector<List<Region*>*> scc2rus;
+    for (UINT i = 0; i < m_rumgr->getNumOfRegion(); i++) {
+        Region * ru = m_rumgr->get_region(i);
+        if (ru == NULL || !ru->is_function()) { continue; }
+        CallNode * cn = cg->mapRegion2CallNode(ru);
+        ASSERT0(cn);
+        UINT scc = cn2scc.get(CN_id(cn));
+        ASSERT0(scc != 0);
+        List<Region*> * rus = scc2rus.get(scc);
+        if (rus == NULL) {
+            rus = new List<Region*>();
+            scc2rus.set(scc, rus);
+        }
+        rus->append_tail(ru);
+    }
+
+    //Callees are numbered before callers.
+    for (UINT scc = 1; scc <= sccnum; scc++) {
+        List<Region*> * rus = scc2rus.get(scc);
+        if (rus == NULL) { continue; }
+        computeModRefSummary(*rus, isRecursive(*rus));
+        delete rus;
+    }
+}
+
+
 //call: call stmt.
 //callru: the region that call stmt resident in.
 void IPA::createCallDummyuse(IR * call, Region * callru)
@@ -199,6 +506,9 @@ bool IPA::perform(OptCtx & oc)
     START_TIMER_AFTER();
     ASSERT0(OC_is_callg_valid(oc));
     ASSERT0(m_program && m_program->is_program());
+    if (m_is_compute_modref) {
+        computeModRefSummary(oc);
+    }
     createCallDummyuse(oc);
     END_TIMER_AFTER(get_pass_name());
     return true;
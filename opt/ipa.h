@@ -36,15 +36,21 @@ author: Su Zhenyu
 
 namespace xoc {
 
+//The maximum number of iterations to compute the Mod/Ref summaries
+//of recursive functions.
+#define IPA_MODREF_ITER_LIMIT 8
+
 class IPA : public Pass {
 protected:
     RegionMgr * m_rumgr;
     Region * m_program;
     SMemPool * m_pool;
     MDSystem * m_mdsys;
+    DefMiscBitSetMgr m_sbs_mgr;
     bool m_is_keep_dumgr; //true to keep AA and DU mgr if computed.
     bool m_is_keep_reachdef; //true to keep Reachdef.
     bool m_is_recompute_du_ref; //true to recompute DU reference.
+    bool m_is_compute_modref; //true to compute Mod/Ref summary.
 
 protected:
     void * xmalloc(UINT size)
@@ -60,8 +66,15 @@ protected:
     void createCallDummyuse(OptCtx & oc);
 
     void recomputeDUChain(Region * ru, OptCtx & oc);
+    void recomputeDURef(Region * ru);
+
+    bool collectModRef(Region * ru, OUT MDSet & mod, OUT MDSet & ref);
+    void computeModRefSummary(List<Region*> & rus, bool is_recursive);
+    void computeModRefSummary(OptCtx & oc);
 
     Region * findRegion(IR * call, Region * callru);
+    void invalidModRefSummary(Region * ru);
+    bool isRecursive(List<Region*> & rus);
 public:
     IPA(Region * program)
     {
@@ -74,12 +87,14 @@ public:
         m_is_keep_dumgr = false;
         m_is_keep_reachdef = false;
         m_is_recompute_du_ref = true;
+        m_is_compute_modref = true;
     }
     virtual ~IPA() { smpoolDelete(m_pool); }
 
     void setKeepDUMgr(bool keep) { m_is_keep_dumgr = keep; }
     void setKeepReachdef(bool keep) { m_is_keep_reachdef = keep; }
     void setRecomputeDURef(bool doit) { m_is_recompute_du_ref = doit; }
+    void setComputeModRef(bool doit) { m_is_compute_modref = doit; }
     virtual CHAR const* get_pass_name() const { return "IPA"; }
     virtual PASS_TYPE get_pass_type() const { return PASS_IPA; }
     virtual bool perform(OptCtx & oc);
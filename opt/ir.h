@@ -152,6 +152,69 @@ typedef enum {
 #define IRT_IS_LEAF             0x200
 #define IRT_HAS_RESULT          0x400
 
+//Description of each IR type, it is the initializing value of g_ir_desc.
+//Each entry is X(code, name, kid_map, kid_num, attr, size).
+//NOTE: the order of entries must be the same as IR_TYPE.
+#define IR_DESC_TABLE(X) \
+    X(IR_UNDEF,     "undef",       0x0, 0, 0, 0) \
+    X(IR_CONST,     "const",       0x0, 0, IRT_IS_LEAF, sizeof(CConst)) \
+    X(IR_ID,        "id",          0x0, 0, IRT_IS_LEAF, sizeof(CId)) \
+    X(IR_LD,        "ld",          0x0, 0, IRT_IS_MEM_REF|IRT_IS_MEM_OPND|IRT_IS_LEAF, sizeof(CLd)) \
+    X(IR_ILD,       "ild",         0x1, 1, IRT_IS_UNA|IRT_IS_MEM_REF|IRT_IS_MEM_OPND, sizeof(CIld)) \
+    X(IR_PR,        "pr",          0x0, 0, IRT_IS_MEM_REF|IRT_IS_MEM_OPND|IRT_IS_LEAF, sizeof(CPr)) \
+    X(IR_ARRAY,     "array",       0x3, 2, IRT_IS_MEM_REF|IRT_IS_MEM_OPND, sizeof(CArray)) \
+    X(IR_ST,        "st",          0x1, 1, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CSt)) \
+    X(IR_STPR,      "stpr",        0x1, 1, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CStpr)) \
+    X(IR_STARRAY,   "starray",     0x7, 3, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CStArray)) \
+    X(IR_IST,       "ist",         0x3, 2, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CIst)) \
+    X(IR_SETELEM,   "setepr",      0x3, 2, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CSetElem)) \
+    X(IR_GETELEM,   "getepr",      0x3, 2, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CGetElem)) \
+    X(IR_CALL,      "call",        0x3, 2, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CCall)) \
+    X(IR_ICALL,     "icall",       0x7, 3, IRT_IS_STMT|IRT_IS_MEM_REF|IRT_HAS_RESULT, sizeof(CICall)) \
+    X(IR_LDA,       "lda",         0x0, 0, IRT_IS_UNA|IRT_IS_LEAF, sizeof(CLda)) \
+    X(IR_ADD,       "add",         0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE|IRT_IS_COMMUTATIVE, sizeof(CBin)) \
+    X(IR_SUB,       "sub",         0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE, sizeof(CBin)) \
+    X(IR_MUL,       "mul",         0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE|IRT_IS_COMMUTATIVE, sizeof(CBin)) \
+    X(IR_DIV,       "div",         0x3, 2, IRT_IS_BIN, sizeof(CBin)) \
+    X(IR_REM,       "rem",         0x3, 2, IRT_IS_BIN, sizeof(CBin)) \
+    X(IR_MOD,       "mod",         0x3, 2, IRT_IS_BIN, sizeof(CBin)) \
+    X(IR_LAND,      "land",        0x3, 2, IRT_IS_BIN|IRT_IS_LOGICAL, sizeof(CBin)) \
+    X(IR_LOR,       "lor",         0x3, 2, IRT_IS_BIN|IRT_IS_LOGICAL, sizeof(CBin)) \
+    X(IR_BAND,      "band",        0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE|IRT_IS_COMMUTATIVE, sizeof(CBin)) \
+    X(IR_BOR,       "bor",         0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE, sizeof(CBin)) \
+    X(IR_XOR,       "xor",         0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE|IRT_IS_COMMUTATIVE, sizeof(CBin)) \
+    X(IR_ASR,       "asr",         0x3, 2, IRT_IS_BIN, sizeof(CBin)) \
+    X(IR_LSR,       "lsr",         0x3, 2, IRT_IS_BIN, sizeof(CBin)) \
+    X(IR_LSL,       "lsl",         0x3, 2, IRT_IS_BIN, sizeof(CBin)) \
+    X(IR_LT,        "lt",          0x3, 2, IRT_IS_BIN|IRT_IS_RELATION, sizeof(CBin)) \
+    X(IR_LE,        "le",          0x3, 2, IRT_IS_BIN|IRT_IS_RELATION, sizeof(CBin)) \
+    X(IR_GT,        "gt",          0x3, 2, IRT_IS_BIN|IRT_IS_RELATION, sizeof(CBin)) \
+    X(IR_GE,        "ge",          0x3, 2, IRT_IS_BIN|IRT_IS_RELATION, sizeof(CBin)) \
+    X(IR_EQ,        "eq",          0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE|IRT_IS_COMMUTATIVE|IRT_IS_RELATION, sizeof(CBin)) \
+    X(IR_NE,        "ne",          0x3, 2, IRT_IS_BIN|IRT_IS_ASSOCIATIVE|IRT_IS_COMMUTATIVE|IRT_IS_RELATION, sizeof(CBin)) \
+    X(IR_BNOT,      "bnot",        0x1, 1, IRT_IS_UNA, sizeof(CUna)) \
+    X(IR_LNOT,      "lnot",        0x1, 1, IRT_IS_UNA|IRT_IS_LOGICAL, sizeof(CUna)) \
+    X(IR_NEG,       "neg",         0x1, 1, IRT_IS_UNA, sizeof(CUna)) \
+    X(IR_CVT,       "cvt",         0x1, 1, IRT_IS_UNA, sizeof(CCvt)) \
+    X(IR_GOTO,      "goto",        0x0, 0, IRT_IS_STMT, sizeof(CGoto)) \
+    X(IR_IGOTO,     "igoto",       0x3, 2, IRT_IS_STMT, sizeof(CIGoto)) \
+    X(IR_DO_WHILE,  "do_while",    0x3, 2, IRT_IS_STMT, sizeof(CDoWhile)) \
+    X(IR_WHILE_DO,  "while_do",    0x3, 2, IRT_IS_STMT, sizeof(CWhileDo)) \
+    X(IR_DO_LOOP,   "do_loop",     0xF, 4, IRT_IS_STMT, sizeof(CDoLoop)) \
+    X(IR_IF,        "if",          0x7, 3, IRT_IS_STMT, sizeof(CIf)) \
+    X(IR_LABEL,     "label",       0x0, 0, IRT_IS_STMT, sizeof(CLab)) \
+    X(IR_SWITCH,    "switch",      0x7, 3, IRT_IS_STMT, sizeof(CSwitch)) \
+    X(IR_CASE,      "case",        0x1, 1, 0, sizeof(CCase)) \
+    X(IR_TRUEBR,    "truebr",      0x1, 1, IRT_IS_STMT, sizeof(CTruebr)) \
+    X(IR_FALSEBR,   "falsebr",     0x1, 1, IRT_IS_STMT, sizeof(CFalsebr)) \
+    X(IR_RETURN,    "return",      0x1, 1, IRT_IS_STMT, sizeof(CRet)) \
+    X(IR_SELECT,    "select",      0x7, 3, 0, sizeof(CSelect)) \
+    X(IR_BREAK,     "break",       0x0, 0, IRT_IS_STMT, sizeof(CBreak)) \
+    X(IR_CONTINUE,  "continue",    0x0, 0, IRT_IS_STMT, sizeof(CContinue)) \
+    X(IR_PHI,       "phi",         0x1, 1, IRT_IS_STMT|IRT_HAS_RESULT|IRT_IS_MEM_REF, sizeof(CPhi)) \
+    X(IR_REGION,    "region",      0x0, 0, IRT_IS_STMT, sizeof(CRegion)) \
+    X(IR_TYPE_NUM,  "LAST IR Type", 0x0, 0, 0, 0)
+
 #define IRDES_type(m)           ((m).code)
 #define IRDES_name(m)           ((m).name)
 #define IRDES_kid_map(m)        ((m).kid_map)
@@ -324,10 +387,8 @@ class IR {
 public:
     UINT id; //Each IR has unique id.
 
-    //The type of IR can be void, and depend on
-    //the dynamic behavior of program.
-    Type const* result_data_type;
-
+    //NOTE: the bit fields follow 'id' to avoid the padding before
+    //the pointer members.
     #ifdef _DEBUG_
     IR_TYPE code;
     #else
@@ -358,17 +419,22 @@ public:
     UINT irt_size:6;
     #endif
 
+    //The type of IR can be void, and depend on
+    //the dynamic behavior of program.
+    Type const* result_data_type;
+
     //Both of 'next' and 'prev' used by the process of
     //complicated tree level IR construction.
-    IR * next;
-    IR * prev;
+    //NOTE: IRLink is 32-bit index of IR in compact mode, see ir_slab.h.
+    IRLink next;
+    IRLink prev;
 
     //Used in all processs at all level IR.
     //This field should be NULL if IR is the top level of stmt.
-    IR * parent;
+    IRLink parent;
 
     //IR may have an unique attach info container.
-    AIContainer * attach_info_container;
+    IRAILink attach_info_container;
 
 public:
     bool calcArrayOffset(TMWORD * ofst, TypeMgr * tm) const;
@@ -1082,11 +1148,11 @@ public:
 //    2. res = ild (p + ILD_ofst) if ILD_ofst is not 0.
 #define ILD_ofst(ir)        (((CIld*)CK_IRT(ir, IR_ILD))->field_offset)
 #define ILD_du(ir)          (((CIld*)CK_IRT(ir, IR_ILD))->du)
-#define ILD_base(ir)        (((CIld*)ir)->opnd[CKID_TY(ir, IR_ILD, 0)])
-#define ILD_kid(ir, idx)    (((CIld*)ir)->opnd[CKID_TY(ir, IR_ILD, idx)])
+#define ILD_base(ir)        (((CIld*)(IR*)(ir))->opnd[CKID_TY(ir, IR_ILD, 0)])
+#define ILD_kid(ir, idx)    (((CIld*)(IR*)(ir))->opnd[CKID_TY(ir, IR_ILD, idx)])
 class CIld : public DuProp, public OffsetProp {
 public:
-    IR * opnd[1];
+    IRLink opnd[1];
 };
 
 
@@ -1109,11 +1175,11 @@ public:
 #define ST_idinfo(ir)        (((CSt*)CK_IRT(ir, IR_ST))->id_info)
 #define ST_ofst(ir)          (((CSt*)CK_IRT(ir, IR_ST))->field_offset)
 #define ST_du(ir)            (((CSt*)CK_IRT(ir, IR_ST))->du)
-#define ST_rhs(ir)           (((CSt*)ir)->opnd[CKID_TY(ir, IR_ST, 0)])
-#define ST_kid(ir, idx)      (((CSt*)ir)->opnd[CKID_TY(ir, IR_ST, idx)])
+#define ST_rhs(ir)           (((CSt*)(IR*)(ir))->opnd[CKID_TY(ir, IR_ST, 0)])
+#define ST_kid(ir, idx)      (((CSt*)(IR*)(ir))->opnd[CKID_TY(ir, IR_ST, idx)])
 class CSt: public CLd, public StmtProp {
 public:
-    IR * opnd[1];
+    IRLink opnd[1];
 };
 
 
@@ -1124,13 +1190,13 @@ public:
 #define STPR_no(ir)         (((CStpr*)CK_IRT(ir, IR_STPR))->prno)
 #define STPR_ssainfo(ir)    (((CStpr*)CK_IRT(ir, IR_STPR))->ssainfo)
 #define STPR_du(ir)         (((CStpr*)CK_IRT(ir, IR_STPR))->du)
-#define STPR_rhs(ir)        (((CStpr*)ir)->opnd[CKID_TY(ir, IR_STPR, 0)])
-#define STPR_kid(ir, idx)   (((CStpr*)ir)->opnd[CKID_TY(ir, IR_STPR, idx)])
+#define STPR_rhs(ir)        (((CStpr*)(IR*)(ir))->opnd[CKID_TY(ir, IR_STPR, 0)])
+#define STPR_kid(ir, idx)   (((CStpr*)(IR*)(ir))->opnd[CKID_TY(ir, IR_STPR, idx)])
 class CStpr: public DuProp, public StmtProp {
 public:
     UINT prno; //PR number.
     SSAInfo * ssainfo; //Present ssa def and use set.
-    IR * opnd[1];
+    IRLink opnd[1];
 };
 
 
@@ -1152,14 +1218,14 @@ public:
 #define SETELEM_prno(ir)    (((CSetElem*)CK_IRT(ir, IR_SETELEM))->prno)
 #define SETELEM_ssainfo(ir) (((CSetElem*)CK_IRT(ir, IR_SETELEM))->ssainfo)
 #define SETELEM_du(ir)      (((CSetElem*)CK_IRT(ir, IR_SETELEM))->du)
-#define SETELEM_rhs(ir)     (((CSetElem*)ir)->opnd[CKID_TY(ir, IR_SETELEM, 0)])
-#define SETELEM_ofst(ir)    (((CSetElem*)ir)->opnd[CKID_TY(ir, IR_SETELEM, 1)])
-#define SETELEM_kid(ir, idx)(((CSetElem*)ir)->opnd[CKID_TY(ir, IR_SETELEM, idx)])
+#define SETELEM_rhs(ir)     (((CSetElem*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SETELEM, 0)])
+#define SETELEM_ofst(ir)    (((CSetElem*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SETELEM, 1)])
+#define SETELEM_kid(ir, idx)(((CSetElem*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SETELEM, idx)])
 class CSetElem: public DuProp, public StmtProp {
 public:
     UINT prno; //PR number.
     SSAInfo * ssainfo; //Present ssa def and use set.
-    IR * opnd[2];
+    IRLink opnd[2];
 };
 
 
@@ -1176,9 +1242,9 @@ public:
 #define GETELEM_prno(ir)    (((CGetElem*)CK_IRT(ir, IR_GETELEM))->prno)
 #define GETELEM_ssainfo(ir) (((CGetElem*)CK_IRT(ir, IR_GETELEM))->ssainfo)
 #define GETELEM_du(ir)      (((CGetElem*)CK_IRT(ir, IR_GETELEM))->du)
-#define GETELEM_base(ir)    (((CGetElem*)ir)->opnd[CKID_TY(ir, IR_GETELEM, 0)])
-#define GETELEM_ofst(ir)    (((CGetElem*)ir)->opnd[CKID_TY(ir, IR_GETELEM, 1)])
-#define GETELEM_kid(ir, idx)(((CGetElem*)ir)->opnd[CKID_TY(ir, IR_GETELEM, idx)])
+#define GETELEM_base(ir)    (((CGetElem*)(IR*)(ir))->opnd[CKID_TY(ir, IR_GETELEM, 0)])
+#define GETELEM_ofst(ir)    (((CGetElem*)(IR*)(ir))->opnd[CKID_TY(ir, IR_GETELEM, 1)])
+#define GETELEM_kid(ir, idx)(((CGetElem*)(IR*)(ir))->opnd[CKID_TY(ir, IR_GETELEM, idx)])
 class CGetElem : public DuProp, public StmtProp {
 public:
     UINT prno; //PR number.
@@ -1187,7 +1253,7 @@ public:
     //Note this field only avaiable if SSA information is maintained.
     SSAInfo * ssainfo;
 
-    IR * opnd[2];
+    IRLink opnd[2];
 };
 
 
@@ -1203,12 +1269,12 @@ public:
 #define IST_bb(ir)          (((CIst*)CK_IRT(ir, IR_IST))->bb)
 #define IST_ofst(ir)        (((CIst*)CK_IRT(ir, IR_IST))->field_offset)
 #define IST_du(ir)          (((CIst*)CK_IRT(ir, IR_IST))->du)
-#define IST_base(ir)        (((CIst*)ir)->opnd[CKID_TY(ir, IR_IST, 0)])
-#define IST_rhs(ir)         (((CIst*)ir)->opnd[CKID_TY(ir, IR_IST, 1)])
-#define IST_kid(ir, idx)    (((CIst*)ir)->opnd[CKID_TY(ir, IR_IST, idx)])
+#define IST_base(ir)        (((CIst*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IST, 0)])
+#define IST_rhs(ir)         (((CIst*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IST, 1)])
+#define IST_kid(ir, idx)    (((CIst*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IST, idx)])
 class CIst : public DuProp, public OffsetProp, public StmtProp {
 public:
-    IR * opnd[2];
+    IRLink opnd[2];
 };
 
 
@@ -1257,10 +1323,10 @@ public:
 #define CALL_du(ir)              (((CCall*)CK_IRT_CALL(ir))->du)
 
 //Parameter list of call.
-#define CALL_param_list(ir)      (((CCall*)ir)->opnd[CKID_CALL(ir, 0)])
+#define CALL_param_list(ir)      (((CCall*)(IR*)(ir))->opnd[CKID_CALL(ir, 0)])
 //Record dummy referenced IR.
-#define CALL_dummyuse(ir)        (((CCall*)ir)->opnd[CKID_CALL(ir, 1)])
-#define CALL_kid(ir, idx)        (((CCall*)ir)->opnd[CKID_CALL(ir, idx)])
+#define CALL_dummyuse(ir)        (((CCall*)(IR*)(ir))->opnd[CKID_CALL(ir, 1)])
+#define CALL_kid(ir, idx)        (((CCall*)(IR*)(ir))->opnd[CKID_CALL(ir, idx)])
 class CCall : public DuProp, public VarProp, public StmtProp {
 public:
     //True if current call is intrinsic call.
@@ -1284,7 +1350,7 @@ public:
     SSAInfo * ssainfo; //indicates ssa def and use set.
 
     //NOTE: 'opnd' must be the last member.
-    IR * opnd[2];
+    IRLink opnd[2];
 
 public:
     VAR const* get_callee_var() const { return CALL_idinfo(this); }
@@ -1318,15 +1384,15 @@ public:
 //NOTE: 'opnd_pad' must be the first member.
 
 //Indicate the callee function pointer.
-#define ICALL_callee(ir)      (((CICall*)ir)->opnd[CKID_TY(ir, IR_ICALL, 2)])
+#define ICALL_callee(ir)      (((CICall*)(IR*)(ir))->opnd[CKID_TY(ir, IR_ICALL, 2)])
 
 //True if current call is readonly.
 #define ICALL_is_readonly(ir) (((CICall*)CK_IRT_ONLY_ICALL(ir))->is_readonly)
-#define ICALL_kid(ir, idx)    (((CICall*)ir)->opnd[CKID_TY(ir, IR_ICALL, idx)])
+#define ICALL_kid(ir, idx)    (((CICall*)(IR*)(ir))->opnd[CKID_TY(ir, IR_ICALL, idx)])
 class CICall : public CCall {
 public:
     //NOTE: 'opnd_pad' must be the first member.
-    IR * opnd_pad[1];
+    IRLink opnd_pad[1];
 
     //True if current call is readonly.
     BYTE is_readonly:1;
@@ -1338,21 +1404,21 @@ public:
 
 //Binary Operations, include add, sub, mul, div, rem, mod,
 //land, lor, band, bor, xor, lt, le, gt, ge, eq, ne, asr, lsr, lsl.
-#define BIN_opnd0(ir)        (((CBin*)ir)->opnd[CKID_BIN(ir, 0)])
-#define BIN_opnd1(ir)        (((CBin*)ir)->opnd[CKID_BIN(ir, 1)])
-#define BIN_kid(ir, idx)     (((CBin*)ir)->opnd[CKID_BIN(ir, idx)])
+#define BIN_opnd0(ir)        (((CBin*)(IR*)(ir))->opnd[CKID_BIN(ir, 0)])
+#define BIN_opnd1(ir)        (((CBin*)(IR*)(ir))->opnd[CKID_BIN(ir, 1)])
+#define BIN_kid(ir, idx)     (((CBin*)(IR*)(ir))->opnd[CKID_BIN(ir, idx)])
 class CBin : public IR {
 public:
-    IR * opnd[2];
+    IRLink opnd[2];
 };
 
 
 //Unary Operations, include neg, bnot, lnot.
-#define UNA_opnd0(ir)       (((CUna*)ir)->opnd[CKID_UNA(ir, 0)])
-#define UNA_kid(ir, idx)    (((CUna*)ir)->opnd[CKID_UNA(ir, idx)])
+#define UNA_opnd0(ir)       (((CUna*)(IR*)(ir))->opnd[CKID_UNA(ir, 0)])
+#define UNA_kid(ir, idx)    (((CUna*)(IR*)(ir))->opnd[CKID_UNA(ir, idx)])
 class CUna : public IR {
 public:
-    IR * opnd[1];
+    IRLink opnd[1];
 };
 
 
@@ -1372,15 +1438,15 @@ public:
 #define IGOTO_bb(ir)        (((CIGoto*)CK_IRT(ir, IR_IGOTO))->bb)
 
 //Value expression.
-#define IGOTO_vexp(ir)      (((CIGoto*)ir)->opnd[CKID_TY(ir, IR_IGOTO, 0)])
+#define IGOTO_vexp(ir)      (((CIGoto*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IGOTO, 0)])
 
 //Record a list pairs of <case-value, jump label>.
-#define IGOTO_case_list(ir) (((CIGoto*)ir)->opnd[CKID_TY(ir, IR_IGOTO, 1)])
+#define IGOTO_case_list(ir) (((CIGoto*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IGOTO, 1)])
 
-#define IGOTO_kid(ir, idx)  (((CIGoto*)ir)->opnd[CKID_TY(ir, IR_IGOTO, idx)])
+#define IGOTO_kid(ir, idx)  (((CIGoto*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IGOTO, idx)])
 class CIGoto : public IR, public StmtProp {
 public:
-    IR * opnd[2];
+    IRLink opnd[2];
 };
 
 
@@ -1393,15 +1459,15 @@ public:
 //    * The member layout should be same as do_while.
 //    * 'opnd' must be the last member of CWhileDo.
 //Determinate expression.
-#define LOOP_det(ir)        (((CWhileDo*)ir)->opnd[CKID_LOOP(ir, 0)])
+#define LOOP_det(ir)        (((CWhileDo*)(IR*)(ir))->opnd[CKID_LOOP(ir, 0)])
 
 //Loop body.
-#define LOOP_body(ir)       (((CWhileDo*)ir)->opnd[CKID_LOOP(ir, 1)])
-#define LOOP_kid(ir, idx)   (((CWhileDo*)ir)->opnd[CKID_LOOP(ir, idx)])
+#define LOOP_body(ir)       (((CWhileDo*)(IR*)(ir))->opnd[CKID_LOOP(ir, 1)])
+#define LOOP_kid(ir, idx)   (((CWhileDo*)(IR*)(ir))->opnd[CKID_LOOP(ir, idx)])
 class CWhileDo : public IR {
 public:
     //NOTE: 'opnd' must be the last member of CWhileDo.
-    IR * opnd[2];
+    IRLink opnd[2];
 };
 
 
@@ -1432,15 +1498,15 @@ public:
 //NOTE: 'opnd_pad' must be the first member of CDoLoop.
 
 //Record the stmt that init iv.
-#define LOOP_init(ir)        (((CDoLoop*)ir)->opnd[CKID_TY(ir, IR_DO_LOOP, 2)])
+#define LOOP_init(ir)        (((CDoLoop*)(IR*)(ir))->opnd[CKID_TY(ir, IR_DO_LOOP, 2)])
 
 //Record the stmt that update iv.
-#define LOOP_step(ir)        (((CDoLoop*)ir)->opnd[CKID_TY(ir, IR_DO_LOOP, 3)])
-#define DOLOOP_kid(ir, idx)  (((CDoLoop*)ir)->opnd[CKID_TY(ir, IR_DO_LOOP, idx)])
+#define LOOP_step(ir)        (((CDoLoop*)(IR*)(ir))->opnd[CKID_TY(ir, IR_DO_LOOP, 3)])
+#define DOLOOP_kid(ir, idx)  (((CDoLoop*)(IR*)(ir))->opnd[CKID_TY(ir, IR_DO_LOOP, idx)])
 class CDoLoop : public CWhileDo {
 public:
     //NOTE: 'opnd_pad' must be the first member of CDoLoop.
-    IR * opnd_pad[2];
+    IRLink opnd_pad[2];
 };
 
 
@@ -1450,13 +1516,13 @@ public:
 //      truebody
 //      falsebody
 //    endif
-#define IF_det(ir)          (((CIf*)ir)->opnd[CKID_TY(ir, IR_IF, 0)])
-#define IF_truebody(ir)     (((CIf*)ir)->opnd[CKID_TY(ir, IR_IF, 1)])
-#define IF_falsebody(ir)    (((CIf*)ir)->opnd[CKID_TY(ir, IR_IF, 2)])
-#define IF_kid(ir, idx)     (((CIf*)ir)->opnd[CKID_TY(ir, IR_IF, idx)])
+#define IF_det(ir)          (((CIf*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IF, 0)])
+#define IF_truebody(ir)     (((CIf*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IF, 1)])
+#define IF_falsebody(ir)    (((CIf*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IF, 2)])
+#define IF_kid(ir, idx)     (((CIf*)(IR*)(ir))->opnd[CKID_TY(ir, IR_IF, idx)])
 class CIf : public IR {
 public:
-    IR * opnd[3];
+    IRLink opnd[3];
 };
 
 
@@ -1484,18 +1550,18 @@ public:
 #define SWITCH_deflab(ir)    (((CSwitch*)CK_IRT(ir, IR_SWITCH))->default_label)
 
 //Value expression.
-#define SWITCH_vexp(ir)      (((CSwitch*)ir)->opnd[CKID_TY(ir, IR_SWITCH, 0)])
+#define SWITCH_vexp(ir)      (((CSwitch*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SWITCH, 0)])
 
 //Switch body.
-#define SWITCH_body(ir)      (((CSwitch*)ir)->opnd[CKID_TY(ir, IR_SWITCH, 1)])
+#define SWITCH_body(ir)      (((CSwitch*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SWITCH, 1)])
 
 //Record a list pair of <case-value, jump label>.
-#define SWITCH_case_list(ir) (((CSwitch*)ir)->opnd[CKID_TY(ir, IR_SWITCH, 2)])
+#define SWITCH_case_list(ir) (((CSwitch*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SWITCH, 2)])
 
-#define SWITCH_kid(ir, idx)  (((CSwitch*)ir)->opnd[CKID_TY(ir, IR_SWITCH, idx)])
+#define SWITCH_kid(ir, idx)  (((CSwitch*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SWITCH, idx)])
 class CSwitch : public IR, public StmtProp {
 public:
-    IR * opnd[3];
+    IRLink opnd[3];
     LabelInfo const* default_label;
 };
 
@@ -1505,12 +1571,12 @@ public:
 #define CASE_lab(ir)         (((CCase*)CK_IRT(ir, IR_CASE))->jump_target_label)
 
 //Value expression.
-#define CASE_vexp(ir)        (((CCase*)ir)->opnd[CKID_TY(ir, IR_CASE, 0)])
+#define CASE_vexp(ir)        (((CCase*)(IR*)(ir))->opnd[CKID_TY(ir, IR_CASE, 0)])
 
-#define CASE_kid(ir, idx)    (((CCase*)ir)->opnd[CKID_TY(ir, IR_CASE, idx)])
+#define CASE_kid(ir, idx)    (((CCase*)(IR*)(ir))->opnd[CKID_TY(ir, IR_CASE, idx)])
 class CCase : public IR {
 public:
-    IR * opnd[1]; //case-value
+    IRLink opnd[1]; //case-value
     LabelInfo const* jump_target_label; //jump lable for case.
 };
 
@@ -1552,11 +1618,11 @@ public:
 #define ARR_elem_num_buf(ir)  (((CArray*)CK_IRT_ARR(ir))->elem_num)
 
 //Array base.
-#define ARR_base(ir)          (((CArray*)ir)->opnd[CKID_ARR(ir, 0)])
+#define ARR_base(ir)          (((CArray*)(IR*)(ir))->opnd[CKID_ARR(ir, 0)])
 
 //Array subscript expression.
-#define ARR_sub_list(ir)      (((CArray*)ir)->opnd[CKID_ARR(ir, 1)])
-#define ARR_kid(ir, idx)      (((CArray*)ir)->opnd[CKID_ARR(ir, idx)])
+#define ARR_sub_list(ir)      (((CArray*)(IR*)(ir))->opnd[CKID_ARR(ir, 1)])
+#define ARR_kid(ir, idx)      (((CArray*)(IR*)(ir))->opnd[CKID_ARR(ir, idx)])
 class CArray : public DuProp, public OffsetProp {
 public:
     //Note that if ARR_ofst is not zero, the IR_dt may not equal to ARR_elemtype.
@@ -1577,7 +1643,7 @@ public:
     TMWORD const* elem_num;
 
     //NOTE: 'opnd' must be the last member of CArray.
-    IR * opnd[2];
+    IRLink opnd[2];
 public:
 
     //Return the number of dimensions.
@@ -1635,11 +1701,11 @@ public:
 //
 //If 'elem_tyid' is vector, ARR_ofst refers the referrenced element byte offset.
 #define STARR_bb(ir)        (((CStArray*)CK_IRT(ir, IR_STARRAY))->bb)
-#define STARR_rhs(ir)       (((CStArray*)ir)->opnd[CKID_TY(ir, IR_STARRAY, 0)])
+#define STARR_rhs(ir)       (((CStArray*)(IR*)(ir))->opnd[CKID_TY(ir, IR_STARRAY, 0)])
 class CStArray: public CArray {
 public:
     //NOTE: 'opnd' must be the first member of CStArray.
-    IR * opnd[1];
+    IRLink opnd[1];
 
     IRBB * bb;
 };
@@ -1647,11 +1713,11 @@ public:
 
 //This class represent data-type convertion.
 //Record the expression to be converted.
-#define CVT_exp(ir)         (((CCvt*)ir)->opnd[CKID_TY(ir, IR_CVT, 0)])
-#define CVT_kid(ir, idx)    (((CCvt*)ir)->opnd[CKID_TY(ir, IR_CVT, idx)])
+#define CVT_exp(ir)         (((CCvt*)(IR*)(ir))->opnd[CKID_TY(ir, IR_CVT, 0)])
+#define CVT_kid(ir, idx)    (((CCvt*)(IR*)(ir))->opnd[CKID_TY(ir, IR_CVT, idx)])
 class CCvt : public IR {
 public:
-    IR * opnd[1]; //expression to be converted.
+    IRLink opnd[1]; //expression to be converted.
 
     //Get the leaf expression.
     //e.g: cvt:i32(cvt:u8(x)), this function will return x;
@@ -1693,11 +1759,11 @@ public:
 #define BR_lab(ir)           (((CTruebr*)CK_IRT_BR(ir))->jump_target_lab)
 
 //Determinant expression.
-#define BR_det(ir)           (((CTruebr*)ir)->opnd[CKID_BR(ir, 0)])
-#define BR_kid(ir, idx)      (((CTruebr*)ir)->opnd[CKID_BR(ir, idx)])
+#define BR_det(ir)           (((CTruebr*)(IR*)(ir))->opnd[CKID_BR(ir, 0)])
+#define BR_kid(ir, idx)      (((CTruebr*)(IR*)(ir))->opnd[CKID_BR(ir, idx)])
 class CTruebr : public IR, public StmtProp {
 public:
-    IR * opnd[1];
+    IRLink opnd[1];
     LabelInfo const* jump_target_lab; //jump target label.
 };
 
@@ -1715,11 +1781,11 @@ public:
 //Return value expressions list.
 //usage: return a, b, c;  a, b, c are return value expressions.
 #define RET_bb(ir)           (((CRet*)CK_IRT(ir, IR_RETURN))->bb)
-#define RET_exp(ir)          (((CRet*)ir)->opnd[CKID_TY(ir, IR_RETURN, 0)])
-#define RET_kid(ir, idx)     (((CRet*)ir)->opnd[CKID_TY(ir, IR_RETURN, idx)])
+#define RET_exp(ir)          (((CRet*)(IR*)(ir))->opnd[CKID_TY(ir, IR_RETURN, 0)])
+#define RET_kid(ir, idx)     (((CRet*)(IR*)(ir))->opnd[CKID_TY(ir, IR_RETURN, idx)])
 class CRet : public IR, public StmtProp {
 public:
-    IR * opnd[1];
+    IRLink opnd[1];
 };
 
 
@@ -1734,15 +1800,15 @@ public:
 //SELECT_trueexp, otherwise return SELECT_falseexp.
 
 //Predicator expression.
-#define SELECT_pred(ir)       (((CSelect*)ir)->opnd[CKID_TY(ir, IR_SELECT, 0)])
+#define SELECT_pred(ir)       (((CSelect*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SELECT, 0)])
 
 //True part
-#define SELECT_trueexp(ir)   (((CSelect*)ir)->opnd[CKID_TY(ir, IR_SELECT, 1)])
-#define SELECT_falseexp(ir)  (((CSelect*)ir)->opnd[CKID_TY(ir, IR_SELECT, 2)])
-#define SELECT_kid(ir, idx)  (((CSelect*)ir)->opnd[CKID_TY(ir, IR_SELECT, idx)])
+#define SELECT_trueexp(ir)   (((CSelect*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SELECT, 1)])
+#define SELECT_falseexp(ir)  (((CSelect*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SELECT, 2)])
+#define SELECT_kid(ir, idx)  (((CSelect*)(IR*)(ir))->opnd[CKID_TY(ir, IR_SELECT, idx)])
 class CSelect : public IR {
 public:
-    IR * opnd[3];
+    IRLink opnd[3];
 };
 
 
@@ -1764,13 +1830,13 @@ class CContinue : public IR {};
 #define PHI_bb(ir)           (((CPhi*)CK_IRT(ir, IR_PHI))->bb)
 #define PHI_prno(ir)         (((CPhi*)CK_IRT(ir, IR_PHI))->prno)
 #define PHI_ssainfo(ir)      (((CPhi*)CK_IRT(ir, IR_PHI))->ssainfo)
-#define PHI_opnd_list(ir)    (((CPhi*)ir)->opnd[CKID_TY(ir, IR_PHI, 0)])
-#define PHI_kid(ir, idx)     (((CPhi*)ir)->opnd[CKID_TY(ir, IR_PHI, idx)])
+#define PHI_opnd_list(ir)    (((CPhi*)(IR*)(ir))->opnd[CKID_TY(ir, IR_PHI, 0)])
+#define PHI_kid(ir, idx)     (((CPhi*)(IR*)(ir))->opnd[CKID_TY(ir, IR_PHI, idx)])
 class CPhi : public DuProp, public StmtProp {
 public:
     UINT prno; //PR number.
     SSAInfo * ssainfo; //Present ssa def and use set.
-    IR * opnd[1];
+    IRLink opnd[1];
 
 public:
     IR const* get_opnd_list() const { return PHI_opnd_list(this); }
@@ -32,6 +32,7 @@ IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 author: Su Zhenyu
 @*/
 #include "cominc.h"
+#include "callg.h"
 #include "prdf.h"
 #include "prssainfo.h"
 #include "ir_ssa.h"
@@ -67,8 +68,8 @@ size_t PPSetMgr::count_mem()
 size_t PtPairMgr::count_mem() const
 {
     size_t count = 0;
-    TMapIter<UINT, TMap<UINT, PtPair*>*> ti;
-    TMap<UINT, PtPair*> * v = NULL;
+    TMapIter<UINT, BTMap<UINT, PtPair*>*> ti;
+    BTMap<UINT, PtPair*> * v = NULL;
     count += m_from_tmap.count_mem();
     for (m_from_tmap.get_first(ti, &v);
          v != NULL; m_from_tmap.get_next(ti, &v)) {
@@ -86,7 +87,7 @@ size_t PtPairMgr::count_mem() const
 //Add POINT-TO pair: from -> to.
 PtPair * PtPairMgr::add(UINT from, UINT to)
 {
-    TMap<UINT, PtPair*> * to_tmap = m_from_tmap.get(from);
+    BTMap<UINT, PtPair*> * to_tmap = m_from_tmap.get(from);
     if (to_tmap == NULL) {
         to_tmap = xmalloc_tmap();
         to_tmap->init();
@@ -1763,7 +1764,7 @@ void IR_AA::processPhi(IN IR * ir, IN MD2MDSet * mx)
     if (comp_pt) {
         MDSet const* pts = getPointTo(MD_id(phi_md), *mx);
         if (pts != NULL) {
-            if (pts == m_maypts) {
+            if (m_mds_hash->isEqual(pts, m_maypts)) {
                 phi_pts_is_maypts = true;
             } else {
                 phi_pts.copy(*pts, *m_misc_bs_mgr);
@@ -2218,6 +2219,7 @@ void IR_AA::processRegionSideeffect(IN OUT MD2MDSet & mx)
 {
     //Set all mds which are global pointers or parameters which taken
     //address point to maypts.
+    MutexHolder h(m_md_sys->get_lock());
     MDId2MD const* id2md = m_md_sys->get_id2md_map();
     for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
         MD * t = id2md->get((UINT)j);
@@ -2253,6 +2255,7 @@ void IR_AA::processCallSideeffect(IN OUT MD2MDSet & mx, MDSet const& by_addr_mds
 {
     //Set all mds which are global pointers or parameters which taken
     //address point to maypts.
+    MutexHolder h(m_md_sys->get_lock());
     MDId2MD const* id2md = m_md_sys->get_id2md_map();
     for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
         MD const* t = id2md->get((UINT)j);
@@ -2271,6 +2274,15 @@ void IR_AA::processCallSideeffect(IN OUT MD2MDSet & mx, MDSet const& by_addr_mds
         }
     }
 
+    processCallSideeffectByAddr(mx, by_addr_mds);
+}
+
+
+//Set the pointers that passed to callee by address to point to maypts.
+void IR_AA::processCallSideeffectByAddr(
+        IN OUT MD2MDSet & mx,
+        MDSet const& by_addr_mds)
+{
     if (by_addr_mds.is_empty()) { return; }
 
     SEGIter * iter;
@@ -2293,6 +2305,60 @@ void IR_AA::processCallSideeffect(IN OUT MD2MDSet & mx, MDSet const& by_addr_mds
 }
 
 
+//Compute the point-to set modification of call according to the
+//Mod summary of callee. The summary does not record the memory that
+//reachable from parameters, thus the pointers passed by address have
+//to be updated as well as the global pointers callee may modify.
+void IR_AA::processCallSideeffectBySummary(
+        IN OUT MD2MDSet & mx,
+        MDSet const& by_addr_mds,
+        MDSet const& modsum)
+{
+    MDSet mods;
+    ConstMDIter mditer;
+    m_md_sys->computeOverlap(modsum, mods, mditer, *m_misc_bs_mgr, false);
+    mods.bunion(modsum, *m_misc_bs_mgr);
+
+    SEGIter * iter;
+    for (INT j = mods.get_first(&iter);
+         j >= 0; j = mods.get_next((UINT)j, &iter)) {
+        MD const* t = m_md_sys->get_md((UINT)j);
+        ASSERT0(t != NULL);
+        VAR const* v = t->get_base();
+        if (v->is_pointer() ||
+            v->is_void() /* v may be pointer if its type is VOID */) {
+            setPointTo((UINT)j, mx, m_maypts);
+        }
+    }
+    mods.clean(*m_misc_bs_mgr);
+    processCallSideeffectByAddr(mx, by_addr_mds);
+}
+
+
+bool IR_AA::isHeapObj(VAR const* v)
+{
+    TMapIter<IR const*, MD const*> iter;
+    MD const* heap_obj;
+    for (IR const* ir = m_ir2heapobj.get_first(iter, &heap_obj);
+         ir != NULL; ir = m_ir2heapobj.get_next(iter, &heap_obj)) {
+        if (heap_obj->get_base() == v) { return true; }
+    }
+    return false;
+}
+
+
+bool IR_AA::isParamPointee(VAR const* v)
+{
+    TMapIter<VAR*, MD const*> iter;
+    MD const* dmd;
+    for (VAR * param = m_var2md.get_first(iter, &dmd);
+         param != NULL; param = m_var2md.get_next(iter, &dmd)) {
+        if (dmd->get_base() == v) { return true; }
+    }
+    return false;
+}
+
+
 MD const* IR_AA::allocHeapobj(IR * ir)
 {
     MD const* heap_obj = m_ir2heapobj.get(ir);
@@ -2422,7 +2488,16 @@ void IR_AA::processCall(IN IR * ir, IN MD2MDSet * mx)
         return;
     }
 
-    processCallSideeffect(*mx, by_addr_mds);
+    //Make use of the Mod summary of callee if IPA computed it.
+    CallGraph * callg = m_ru->get_region_mgr()->get_call_graph();
+    Region * callee = callg != NULL && ir->is_call() ?
+                      callg->mapCall2Region(ir, m_ru) : NULL;
+    if (callee != NULL && callee->get_mod_summary() != NULL) {
+        processCallSideeffectBySummary(*mx, by_addr_mds,
+                                       *callee->get_mod_summary());
+    } else {
+        processCallSideeffect(*mx, by_addr_mds);
+    }
     tmp.clean(*m_misc_bs_mgr);
     by_addr_mds.clean(*m_misc_bs_mgr);
 }
@@ -2601,6 +2676,7 @@ void IR_AA::ElemUnionPointTo(
         ASSERT0(m_md_sys->get_md((UINT)i));
         if (is_all_mem((UINT)i)) {
             set_all = true;
+            MutexHolder h(m_md_sys->get_lock());
             MDId2MD const* id2md = m_md_sys->get_id2md_map();
             for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
                 ASSERT0(id2md->get((UINT)j));
@@ -2634,6 +2710,7 @@ void IR_AA::ElemUnionPointTo(
         ASSERT0(m_md_sys->get_md((UINT)i));
         if (is_all_mem((UINT)i)) {
             set_all = true;
+            MutexHolder h(m_md_sys->get_lock());
             MDId2MD const* id2md = m_md_sys->get_id2md_map();
             for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
                 ASSERT0(id2md->get((UINT)j));
@@ -2670,6 +2747,7 @@ void IR_AA::ElemCopyAndUnionPointTo(
         if (is_all_mem((UINT)i)) {
             set_all = true;
 
+            MutexHolder h(m_md_sys->get_lock());
             MDId2MD const* id2md = m_md_sys->get_id2md_map();
             for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
                 MD * t = id2md->get((UINT)j);
@@ -2722,6 +2800,7 @@ void IR_AA::ElemCopyPointTo(
         ASSERT0(m_md_sys->get_md((UINT)i));
         if (is_all_mem((UINT)i)) {
             set_all = true;
+            MutexHolder h(m_md_sys->get_lock());
             MDId2MD const* id2md = m_md_sys->get_id2md_map();
             for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
                 ASSERT0(id2md->get((UINT)j));
@@ -2753,6 +2832,7 @@ void IR_AA::ElemCopyPointToAndMayPointTo(MDSet const& mds, IN MD2MDSet * mx)
         ASSERT0(m_md_sys->get_md((UINT)i));
         if (is_all_mem((UINT)i)) {
             set_all = true;
+            MutexHolder h(m_md_sys->get_lock());
             MDId2MD const* id2md = m_md_sys->get_id2md_map();
             for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
                 ASSERT0(id2md->get((UINT)j));
@@ -2784,6 +2864,7 @@ void IR_AA::ElemCleanExactPointTo(MDSet const& mds, IN MD2MDSet * mx)
         ASSERT0(m_md_sys->get_md((UINT)i));
         if (is_all_mem((UINT)i)) {
             set_all = true;
+            MutexHolder h(m_md_sys->get_lock());
             MDId2MD const* id2md = m_md_sys->get_id2md_map();
             for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
                 ASSERT0(id2md->get((UINT)j));
@@ -2814,6 +2895,7 @@ void IR_AA::ElemCleanPointTo(MDSet const& mds, IN MD2MDSet * mx)
         ASSERT0(m_md_sys->get_md((UINT)i));
         if (is_all_mem((UINT)i)) {
             set_all = true;
+            MutexHolder h(m_md_sys->get_lock());
             MDId2MD const* id2md = m_md_sys->get_id2md_map();
             for (INT j = MD_FIRST; j <= id2md->get_last_idx(); j++) {
                 ASSERT0(id2md->get((UINT)j));
@@ -3241,6 +3323,7 @@ void IR_AA::dumpMD2MDSet(IN MD2MDSet * mx, bool dump_ptg)
 {
     if (g_tfile == NULL || mx == NULL) return;
     Graph g;
+    MutexHolder h(m_md_sys->get_lock());
     MDId2MD const* id2md = m_md_sys->get_id2md_map();
     for (INT i = MD_FIRST; i <= id2md->get_last_idx(); i++) {
         if (id2md->get((UINT)i) == NULL) { continue; }
@@ -3649,6 +3732,7 @@ void IR_AA::initGlobalAndParameterVarPtset(
         }
     }
 
+    MutexHolder h(m_md_sys->get_lock());
     MDTab * mdt = m_md_sys->get_md_tab(param);
     if (mdt != NULL) {
         MD const* x = mdt->get_effect_md();
@@ -3806,6 +3890,7 @@ void IR_AA::initMayPointToSet()
             }
 
             //General md.
+            MutexHolder h(m_md_sys->get_lock());
             ASSERT0(m_md_sys->get_md_tab(v));
             MD const* x = m_md_sys->get_md_tab(v)->get_effect_md();
             if (x != NULL) {
@@ -112,10 +112,10 @@ public:
 
 //PtPairMgr
 class PtPairMgr {
-    TMap<UINT, TMap<UINT, PtPair*>*> m_from_tmap;
+    BTMap<UINT, BTMap<UINT, PtPair*>*> m_from_tmap;
     Vector<PtPair*> m_id2pt_pair;
     SMemPool * m_pool_pt_pair; //pool of PtPair
-    SMemPool * m_pool_tmap; //pool of TMap<UINT, PtPair*>
+    SMemPool * m_pool_tmap; //pool of BTMap<UINT, PtPair*>
     UINT m_pp_count;
 
     inline PtPair * xmalloc_pt_pair()
@@ -127,14 +127,14 @@ class PtPairMgr {
         return p;
     }
 
-    inline TMap<UINT, PtPair*> * xmalloc_tmap()
+    inline BTMap<UINT, PtPair*> * xmalloc_tmap()
     {
-        TMap<UINT, PtPair*> * p =
-            (TMap<UINT, PtPair*>*)smpoolMallocConstSize(
-                                    sizeof(TMap<UINT, PtPair*>),
+        BTMap<UINT, PtPair*> * p =
+            (BTMap<UINT, PtPair*>*)smpoolMallocConstSize(
+                                    sizeof(BTMap<UINT, PtPair*>),
                                     m_pool_tmap);
         ASSERT0(p);
-        memset(p, 0, sizeof(TMap<UINT, PtPair*>));
+        memset(p, 0, sizeof(BTMap<UINT, PtPair*>));
         return p;
     }
 public:
@@ -152,7 +152,7 @@ public:
         if (m_pool_pt_pair != NULL) { return; }
         m_pp_count = 1;
         m_pool_pt_pair = smpoolCreate(sizeof(PtPair), MEM_CONST_SIZE);
-        m_pool_tmap = smpoolCreate(sizeof(TMap<UINT, PtPair*>),
+        m_pool_tmap = smpoolCreate(sizeof(BTMap<UINT, PtPair*>),
                                    MEM_CONST_SIZE);
     }
 
@@ -160,8 +160,8 @@ public:
     {
         if (m_pool_pt_pair == NULL) { return; }
 
-        TMapIter<UINT, TMap<UINT, PtPair*>*> ti;
-        TMap<UINT, PtPair*> * v = NULL;
+        TMapIter<UINT, BTMap<UINT, PtPair*>*> ti;
+        BTMap<UINT, PtPair*> * v = NULL;
         for (m_from_tmap.get_first(ti, &v);
              v != NULL; m_from_tmap.get_next(ti, &v)) {
             v->destroy();
@@ -437,6 +437,13 @@ protected:
     void processStoreArray(IN IR * ir, IN MD2MDSet * mx);
     void processPhi(IN IR * ir, IN MD2MDSet * mx);
     void processCallSideeffect(IN OUT MD2MDSet & mx, MDSet const& by_addr_mds);
+    void processCallSideeffectByAddr(
+            IN OUT MD2MDSet & mx,
+            MDSet const& by_addr_mds);
+    void processCallSideeffectBySummary(
+            IN OUT MD2MDSet & mx,
+            MDSet const& by_addr_mds,
+            MDSet const& modsum);
     void processCall(IN IR * ir, IN OUT MD2MDSet * mx);
     void processReturn(IN IR * ir, IN MD2MDSet * mx);
     void processRegionSideeffect(IN OUT MD2MDSet & mx);
@@ -551,6 +558,13 @@ public:
       return false;
     }
 
+    //Return true if 'v' is the heap object allocated by allocHeapobj().
+    bool isHeapObj(VAR const* v);
+
+    //Return true if 'v' is the dedicated variable that restrict
+    //parameter pointed to.
+    bool isParamPointee(VAR const* v);
+
     //Return true if the MD of each PR corresponded is unique.
     void initMayPointToSet();
 
@@ -608,21 +622,8 @@ public:
             MD2MDSet & ctx,
             MD const* newmd)
     {
-        MDSet tmp;
         MDSet const* pts = getPointTo(pointer_mdid, ctx);
-        if (pts != NULL) {
-            if (pts->is_contain(newmd)) {
-                ASSERT0(m_mds_hash->find(*pts));
-                setPointTo(pointer_mdid, ctx, pts);
-                return;
-            }
-            tmp.bunion(*pts, *m_misc_bs_mgr);
-        }
-
-        tmp.bunion(newmd, *m_misc_bs_mgr);
-        MDSet const* hashed = m_mds_hash->append(tmp);
-        setPointTo(pointer_mdid, ctx, hashed);
-        tmp.clean(*m_misc_bs_mgr);
+        setPointTo(pointer_mdid, ctx, m_mds_hash->unionMD(pts, newmd));
     }
 
     //Set pointer points to MD set by appending a MDSet.
@@ -646,13 +647,9 @@ public:
             return;
         }
 
-        MDSet tmp;
-        tmp.copy(*pts, *m_misc_bs_mgr);
-        tmp.bunion(set, *m_misc_bs_mgr);
-
-        MDSet const* hashed = m_mds_hash->append(tmp);
-        setPointTo(pointer_mdid, ctx, hashed);
-        tmp.clean(*m_misc_bs_mgr);
+        //The union of hashed sets is memoized by MDSetHash.
+        setPointTo(pointer_mdid, ctx,
+                   m_mds_hash->unionSet(pts, m_mds_hash->append(set)));
     }
 
     //Set 'md' points to whole memory.
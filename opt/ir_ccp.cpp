@@ -0,0 +1,698 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "prdf.h"
+#include "prssainfo.h"
+#include "ir_ssa.h"
+#include "ir_ccp.h"
+
+namespace xoc {
+
+//Zero extend 'v' to the size of integer type 'ty'.
+static ULONGLONG toUnsigned(HOST_INT v, Type const* ty, TypeMgr const* tm)
+{
+    UINT bits = tm->get_bytesize(ty) * HOST_BIT_PER_BYTE;
+    if (bits == 0 || bits >= sizeof(ULONGLONG) * HOST_BIT_PER_BYTE) {
+        return (ULONGLONG)v;
+    }
+    return (ULONGLONG)v & ((((ULONGLONG)1) << bits) - 1);
+}
+
+
+//
+//START IR_CCP
+//
+void IR_CCP::clean()
+{
+    m_lat.clean();
+    m_val.clean();
+    m_exec_bb.clean();
+    m_exec_edge.clean();
+    m_edge_wl.clean();
+    m_stmt_wl.clean();
+    m_num_const_opnd = 0;
+    m_num_const_stmt = 0;
+    m_num_dead_branch = 0;
+    m_num_unreach_bb = 0;
+}
+
+
+void IR_CCP::dump()
+{
+    if (g_tfile == NULL) { return; }
+    fprintf(g_tfile, "\n==---- DUMP CCP -- ru:'%s' ----==",
+            m_ru->get_ru_name());
+    fprintf(g_tfile, "\nconstant operand:%d, folded stmt:%d, "
+            "folded branch:%d, unexecutable BB:%d",
+            m_num_const_opnd, m_num_const_stmt,
+            m_num_dead_branch, m_num_unreach_bb);
+    for (INT i = 0; i <= m_lat.get_last_idx(); i++) {
+        if (m_lat.get(i) != CCP_CONST) { continue; }
+        fprintf(g_tfile, "\n\tssa%d = %lld", i, (LONGLONG)m_val.get(i));
+    }
+    fflush(g_tfile);
+}
+
+
+//Truncate 'v' to the size of integer type 'ty', and extend the
+//result according to the signedness of 'ty'.
+HOST_INT IR_CCP::castToType(HOST_INT v, Type const* ty) const
+{
+    ASSERT0(ty->is_int());
+    if (ty->is_bool()) { return v != 0 ? 1 : 0; }
+
+    UINT bits = m_tm->get_bytesize(ty) * HOST_BIT_PER_BYTE;
+    if (bits == 0 || bits >= sizeof(HOST_INT) * HOST_BIT_PER_BYTE) {
+        return v;
+    }
+
+    ULONGLONG mask = (((ULONGLONG)1) << bits) - 1;
+    ULONGLONG u = (ULONGLONG)v & mask;
+    if (ty->is_sint() && ((u >> (bits - 1)) & 1) != 0) {
+        u |= ~mask;
+    }
+    return (HOST_INT)u;
+}
+
+
+//Lattice meet: TOP ^ x = x, BOTTOM ^ x = BOTTOM,
+//c ^ c = c, c1 ^ c2 = BOTTOM.
+void IR_CCP::meet(IN OUT CCPVal & v, CCPVal const& v2) const
+{
+    if (v2.lat == CCP_TOP || v.lat == CCP_BOTTOM) { return; }
+    if (v.lat == CCP_TOP || v2.lat == CCP_BOTTOM) {
+        v = v2;
+        return;
+    }
+    ASSERT0(v.lat == CCP_CONST && v2.lat == CCP_CONST);
+    if (v.val != v2.val) {
+        v.lat = CCP_BOTTOM;
+    }
+}
+
+
+CCPVal IR_CCP::evalBinary(IR const* ir)
+{
+    CCPVal res;
+    res.lat = CCP_BOTTOM;
+    res.val = 0;
+
+    IR const* op0 = BIN_opnd0(ir);
+    IR const* op1 = BIN_opnd1(ir);
+    if (!op0->is_int() || !op1->is_int()) { return res; }
+
+    CCPVal v0 = evalExp(op0);
+    CCPVal v1 = evalExp(op1);
+    if (v0.lat == CCP_BOTTOM || v1.lat == CCP_BOTTOM) { return res; }
+    if (v0.lat == CCP_TOP || v1.lat == CCP_TOP) {
+        res.lat = CCP_TOP;
+        return res;
+    }
+
+    //Arithmetic is performed in unsigned to avoid the overflow of
+    //signed integer on host.
+    bool is_unsigned = op0->is_uint();
+    ULONGLONG u0 = toUnsigned(v0.val, op0->get_type(), m_tm);
+    ULONGLONG u1 = toUnsigned(v1.val, op1->get_type(), m_tm);
+    HOST_INT val = 0;
+    switch (ir->get_code()) {
+    case IR_ADD:
+        val = (HOST_INT)((ULONGLONG)v0.val + (ULONGLONG)v1.val);
+        break;
+    case IR_SUB:
+        val = (HOST_INT)((ULONGLONG)v0.val - (ULONGLONG)v1.val);
+        break;
+    case IR_MUL:
+        val = (HOST_INT)((ULONGLONG)v0.val * (ULONGLONG)v1.val);
+        break;
+    case IR_DIV:
+    case IR_REM:
+    case IR_MOD:
+        //Division by zero is kept to runtime.
+        if (v1.val == 0) { return res; }
+        if (is_unsigned) {
+            val = (HOST_INT)(ir->is_div() ? u0 / u1 : u0 % u1);
+        } else if (v1.val == -1) {
+            val = ir->is_div() ? (HOST_INT)(0 - (ULONGLONG)v0.val) : 0;
+        } else {
+            val = m_ru->calcIntVal(ir->get_code(), v0.val, v1.val);
+        }
+        break;
+    case IR_LT:
+    case IR_LE:
+    case IR_GT:
+    case IR_GE:
+        if (!is_unsigned) {
+            val = m_ru->calcIntVal(ir->get_code(), v0.val, v1.val);
+            break;
+        }
+        switch (ir->get_code()) {
+        case IR_LT: val = u0 < u1; break;
+        case IR_LE: val = u0 <= u1; break;
+        case IR_GT: val = u0 > u1; break;
+        case IR_GE: val = u0 >= u1; break;
+        default: UNREACH();
+        }
+        break;
+    case IR_ASR:
+    case IR_LSR:
+    case IR_LSL:
+        if (v1.val < 0 ||
+            v1.val >= (HOST_INT)(m_tm->get_bytesize(op0->get_type()) *
+                                 HOST_BIT_PER_BYTE)) {
+            //The result depends on target machine.
+            return res;
+        }
+        if (ir->get_code() == IR_LSR) {
+            val = (HOST_INT)(u0 >> v1.val);
+        } else if (ir->get_code() == IR_LSL) {
+            val = (HOST_INT)((ULONGLONG)v0.val << v1.val);
+        } else {
+            val = m_ru->calcIntVal(IR_ASR, v0.val, v1.val);
+        }
+        break;
+    case IR_BAND:
+    case IR_BOR:
+    case IR_XOR:
+    case IR_LAND:
+    case IR_LOR:
+    case IR_EQ:
+    case IR_NE:
+        val = m_ru->calcIntVal(ir->get_code(), v0.val, v1.val);
+        break;
+    default: return res;
+    }
+
+    res.lat = CCP_CONST;
+    res.val = castToType(val, ir->get_type());
+    return res;
+}
+
+
+CCPVal IR_CCP::evalUnary(IR const* ir)
+{
+    CCPVal res;
+    res.lat = CCP_BOTTOM;
+    res.val = 0;
+
+    IR const* op = UNA_opnd0(ir);
+    if (!op->is_int()) { return res; }
+
+    CCPVal v = evalExp(op);
+    if (v.lat != CCP_CONST) { return v; }
+
+    HOST_INT val = 0;
+    switch (ir->get_code()) {
+    case IR_NEG: val = (HOST_INT)(0 - (ULONGLONG)v.val); break;
+    case IR_BNOT: val = ~v.val; break;
+    case IR_LNOT: val = v.val == 0 ? 1 : 0; break;
+    default: return res;
+    }
+
+    res.lat = CCP_CONST;
+    res.val = castToType(val, ir->get_type());
+    return res;
+}
+
+
+//Evaluate the lattice of expression 'ir' according to the lattices
+//of PR operands.
+CCPVal IR_CCP::evalExp(IR const* ir)
+{
+    CCPVal res;
+    res.lat = CCP_BOTTOM;
+    res.val = 0;
+    if (!ir->is_int()) { return res; }
+
+    switch (ir->get_code()) {
+    case IR_CONST:
+        res.lat = CCP_CONST;
+        res.val = castToType(CONST_int_val(ir), ir->get_type());
+        return res;
+    case IR_PR: {
+        SSAInfo const* info = PR_ssainfo(ir);
+        if (info == NULL || SSA_def(info) == NULL) {
+            //Value comes from outside of region.
+            return res;
+        }
+        return getSSAVal(info);
+    }
+    case IR_CVT:
+        res = evalExp(CVT_exp(ir));
+        if (res.lat == CCP_CONST) {
+            res.val = castToType(res.val, ir->get_type());
+        }
+        return res;
+    case IR_SELECT: {
+        CCPVal pred = evalExp(SELECT_pred(ir));
+        if (pred.lat == CCP_TOP) { return pred; }
+        if (pred.lat == CCP_CONST) {
+            return evalExp(pred.val != 0 ?
+                           SELECT_trueexp(ir) : SELECT_falseexp(ir));
+        }
+        res = evalExp(SELECT_trueexp(ir));
+        meet(res, evalExp(SELECT_falseexp(ir)));
+        return res;
+    }
+    default:
+        if (ir->is_binary_op()) { return evalBinary(ir); }
+        if (ir->is_unary_op()) { return evalUnary(ir); }
+    }
+    return res;
+}
+
+
+//Lower the lattice of SSA value 'info' by 'v', and add the stmts that
+//use the value into worklist if the lattice changed.
+void IR_CCP::setSSAVal(SSAInfo * info, CCPVal const& v)
+{
+    UINT id = SSA_id(info);
+    CCP_LAT old = (CCP_LAT)m_lat.get(id);
+    if (old == CCP_BOTTOM || v.lat == CCP_TOP) { return; }
+
+    if (old == CCP_CONST) {
+        if (v.lat == CCP_CONST && v.val == m_val.get(id)) { return; }
+        //Lattice can only be lowered.
+        m_lat.set(id, CCP_BOTTOM);
+    } else {
+        m_lat.set(id, v.lat);
+        m_val.set(id, v.val);
+    }
+
+    SEGIter * sc;
+    for (INT u = SSA_uses(info).get_first(&sc);
+         u >= 0; u = SSA_uses(info).get_next(u, &sc)) {
+        IR * use = m_ru->get_ir(u);
+        ASSERT0(use && use->is_exp());
+        m_stmt_wl.append_tail(use->get_stmt());
+    }
+}
+
+
+void IR_CCP::markEdge(Edge const* e)
+{
+    if (m_exec_edge.find(e)) { return; }
+    m_exec_edge.append(e);
+    m_edge_wl.append_tail(e);
+}
+
+
+//Mark the out edges of 'bb' that may be executed.
+void IR_CCP::visitSucc(IRBB * bb)
+{
+    IRBB * taken = NULL;
+    IR * last = BB_last_ir(bb);
+    if (last != NULL && last->is_cond_br()) {
+        CCPVal det = evalExp(BR_det(last));
+        if (det.lat == CCP_TOP) { return; }
+        if (det.lat == CCP_CONST) {
+            bool is_taken = last->is_truebr() ? det.val != 0 : det.val == 0;
+            taken = is_taken ? m_cfg->findBBbyLabel(BR_lab(last)) :
+                               m_cfg->get_fallthrough_bb(bb);
+            ASSERT0(taken);
+        }
+    }
+
+    Vertex * v = m_cfg->get_vertex(BB_id(bb));
+    ASSERT0(v);
+    for (EdgeC * ec = VERTEX_out_list(v); ec != NULL; ec = EC_next(ec)) {
+        Edge const* e = EC_edge(ec);
+        CFGEdgeInfo * ei = (CFGEdgeInfo*)EDGE_info(e);
+        if (taken != NULL &&
+            VERTEX_id(EDGE_to(e)) != BB_id(taken) &&
+            (ei == NULL || !CFGEI_is_eh(ei))) {
+            continue;
+        }
+        markEdge(e);
+    }
+}
+
+
+void IR_CCP::visitBranch(IR const* br)
+{
+    ASSERT0(br->is_cond_br());
+    visitSucc(br->get_bb());
+}
+
+
+//Merge the operands that come from executable edges.
+void IR_CCP::visitPhi(IR * phi)
+{
+    IRBB * bb = phi->get_bb();
+    Vertex * v = m_cfg->get_vertex(BB_id(bb));
+    ASSERT0(v);
+
+    CCPVal res;
+    res.lat = CCP_TOP;
+    res.val = 0;
+
+    //The i-th operand corresponds to the i-th predecessor.
+    EdgeC * ec = VERTEX_in_list(v);
+    for (IR * opnd = PHI_opnd_list(phi);
+         opnd != NULL; opnd = opnd->get_next(), ec = EC_next(ec)) {
+        ASSERT0(ec);
+        if (!m_exec_edge.find(EC_edge(ec))) { continue; }
+        meet(res, evalExp(opnd));
+        if (res.lat == CCP_BOTTOM) { break; }
+    }
+    setSSAVal(PHI_ssainfo(phi), res);
+}
+
+
+void IR_CCP::visitStmt(IR * ir)
+{
+    switch (ir->get_code()) {
+    case IR_PHI:
+        visitPhi(ir);
+        return;
+    case IR_STPR: {
+        SSAInfo * info = STPR_ssainfo(ir);
+        if (info == NULL) { return; }
+        CCPVal v;
+        v.lat = CCP_BOTTOM;
+        v.val = 0;
+        if (ir->is_int()) {
+            v = evalExp(STPR_rhs(ir));
+            if (v.lat == CCP_CONST) {
+                v.val = castToType(v.val, ir->get_type());
+            }
+        }
+        setSSAVal(info, v);
+        return;
+    }
+    case IR_TRUEBR:
+    case IR_FALSEBR:
+        visitBranch(ir);
+        return;
+    default:;
+    }
+
+    //The value of PR defined by the other stmts, e.g: call, is unknown.
+    SSAInfo * info = ir->get_ssainfo();
+    if (info != NULL) {
+        CCPVal v;
+        v.lat = CCP_BOTTOM;
+        v.val = 0;
+        setSSAVal(info, v);
+    }
+}
+
+
+//BB is visited once it becomes executable.
+void IR_CCP::visitBB(IRBB * bb)
+{
+    ASSERT0(!is_exec_bb(bb));
+    m_exec_bb.bunion(BB_id(bb));
+
+    C<IR*> * ct;
+    for (IR * ir = BB_irlist(bb).get_head(&ct);
+         ir != NULL; ir = BB_irlist(bb).get_next(&ct)) {
+        visitStmt(ir);
+    }
+
+    IR * last = BB_last_ir(bb);
+    if (last == NULL || !last->is_cond_br()) {
+        visitSucc(bb);
+    }
+}
+
+
+void IR_CCP::analyze()
+{
+    IRBB * entry = m_cfg->get_entry();
+    ASSERT0(entry);
+    visitBB(entry);
+
+    for (;;) {
+        while (m_edge_wl.get_elem_count() != 0 ||
+               m_stmt_wl.get_elem_count() != 0) {
+            while (m_edge_wl.get_elem_count() != 0) {
+                Edge const* e = m_edge_wl.remove_head();
+                IRBB * to = m_cfg->get_bb(VERTEX_id(EDGE_to(e)));
+                ASSERT0(to);
+                if (!is_exec_bb(to)) {
+                    visitBB(to);
+                    continue;
+                }
+
+                //Only PHIs are affected by the new executable edge.
+                C<IR*> * ct;
+                for (IR * ir = BB_irlist(to).get_head(&ct);
+                     ir != NULL && ir->is_phi();
+                     ir = BB_irlist(to).get_next(&ct)) {
+                    visitPhi(ir);
+                }
+            }
+
+            while (m_stmt_wl.get_elem_count() != 0) {
+                IR * ir = m_stmt_wl.remove_head();
+                if (!is_exec_bb(ir->get_bb())) { continue; }
+                visitStmt(ir);
+            }
+        }
+
+        //Determinate of branch may still be TOP if it reads undefined
+        //value, regard all successors as executable to be conservative.
+        bool change = false;
+        BBList * bbl = m_ru->get_bb_list();
+        C<IRBB*> * ct_bb;
+        for (IRBB * bb = bbl->get_head(&ct_bb);
+             bb != NULL; bb = bbl->get_next(&ct_bb)) {
+            if (!is_exec_bb(bb)) { continue; }
+            IR * last = BB_last_ir(bb);
+            if (last == NULL ||
+                !last->is_cond_br() ||
+                evalExp(BR_det(last)).lat != CCP_TOP) {
+                continue;
+            }
+
+            Vertex * v = m_cfg->get_vertex(BB_id(bb));
+            for (EdgeC * ec = VERTEX_out_list(v);
+                 ec != NULL; ec = EC_next(ec)) {
+                if (m_exec_edge.find(EC_edge(ec))) { continue; }
+                markEdge(EC_edge(ec));
+                change = true;
+            }
+        }
+        if (!change) { break; }
+    }
+
+    m_num_unreach_bb = m_ru->get_bb_list()->get_elem_count() -
+                       m_exec_bb.get_elem_count();
+}
+
+
+//Replace PR operands of 'stmt' that are constant with immediate.
+//'opnds': for tmp use.
+bool IR_CCP::replaceOpnd(IR * stmt, Vector<IR*> & opnds)
+{
+    UINT n = 0;
+    IRIter ii;
+    for (IR * k = iterRhsInit(stmt, ii); k != NULL; k = iterRhsNext(ii)) {
+        if (!k->is_pr() || !k->is_int() || PR_ssainfo(k) == NULL) {
+            continue;
+        }
+        if (getSSAVal(PR_ssainfo(k)).lat != CCP_CONST) { continue; }
+        opnds.set(n, k);
+        n++;
+    }
+
+    for (UINT i = 0; i < n; i++) {
+        IR * k = opnds.get(i);
+        IR * imm = m_ru->buildImmInt(m_val.get(SSA_id(PR_ssainfo(k))),
+                                     k->get_type());
+        copyDbx(imm, k, m_ru);
+
+        IR * parent = k->get_parent();
+        ASSERT0(parent);
+        k->removeSSAUse();
+        bool doit = parent->replaceKid(k, imm, false);
+        ASSERT0(doit);
+        UNUSED(doit);
+        m_ru->freeIRTree(k);
+    }
+    m_num_const_opnd += n;
+    return n != 0;
+}
+
+
+//Remove conditional branch 'br' whose determinate is constant.
+//Return GOTO if the branch is always taken, or NULL.
+IR * IR_CCP::foldBranch(IR * br, bool is_taken, IN OUT bool & cfg_mod)
+{
+    IRBB * from = br->get_bb();
+    IRBB * target = m_cfg->findBBbyLabel(BR_lab(br));
+    IRBB * fallthrough = m_cfg->get_fallthrough_bb(from);
+    ASSERT0(from && target && fallthrough);
+
+    IR * newbr = NULL;
+    if (is_taken && target != fallthrough) {
+        newbr = m_ru->buildGoto(BR_lab(br));
+        copyDbx(newbr, br, m_ru);
+    }
+
+    br->removeSSAUse();
+
+    if (target != fallthrough) {
+        IRBB * dead = is_taken ? fallthrough : target;
+
+        //Revise the PHI operand to the successor that is not executed.
+        from->removeSuccessorDesignatePhiOpnd(m_cfg, dead);
+        m_cfg->removeEdge(from, dead);
+        cfg_mod = true;
+    }
+
+    m_ru->freeIRTree(br);
+    m_num_dead_branch++;
+    return newbr;
+}
+
+
+bool IR_CCP::rewrite(IN OUT bool & cfg_mod)
+{
+    bool change = false;
+    IR_DU_MGR * du = m_ru->get_du_mgr();
+    Vector<IR*> opnds;
+    BBList * bbl = m_ru->get_bb_list();
+    C<IRBB*> * ct_bb;
+    for (IRBB * bb = bbl->get_head(&ct_bb);
+         bb != NULL; bb = bbl->get_next(&ct_bb)) {
+        //BB that is not executable will be removed as unreachable BB.
+        if (!is_exec_bb(bb)) { continue; }
+
+        BBIRList * ir_list = &BB_irlist(bb);
+        C<IR*> * ct, * next_ct;
+        for (ir_list->get_head(&next_ct), ct = next_ct;
+             ct != NULL; ct = next_ct) {
+            IR * ir = ct->val();
+            ir_list->get_next(&next_ct);
+
+            if (ir->is_cond_br()) {
+                CCPVal det = evalExp(BR_det(ir));
+                if (det.lat == CCP_CONST) {
+                    bool is_taken = ir->is_truebr() ?
+                                    det.val != 0 : det.val == 0;
+                    IR * newbr = foldBranch(ir, is_taken, cfg_mod);
+                    ir_list->remove(ct);
+                    if (newbr != NULL) {
+                        if (next_ct != NULL) {
+                            ir_list->insert_before(newbr, next_ct);
+                        } else {
+                            ir_list->append_tail(newbr);
+                        }
+                    }
+                    change = true;
+                    continue;
+                }
+            } else if (ir->is_stpr() &&
+                       ir->is_int() &&
+                       STPR_ssainfo(ir) != NULL &&
+                       !STPR_rhs(ir)->is_const() &&
+                       getSSAVal(STPR_ssainfo(ir)).lat == CCP_CONST) {
+                IR * rhs = STPR_rhs(ir);
+                IR * imm = m_ru->buildImmInt(
+                               m_val.get(SSA_id(STPR_ssainfo(ir))),
+                               ir->get_type());
+                copyDbx(imm, rhs, m_ru);
+
+                //rhs may contain memory operand that is not chosen
+                //by SELECT.
+                if (du != NULL) {
+                    du->removeUseOutFromDefset(rhs);
+                } else {
+                    rhs->removeSSAUse();
+                }
+                STPR_rhs(ir) = imm;
+                ir->setParent(imm);
+                m_ru->freeIRTree(rhs);
+                m_num_const_stmt++;
+                change = true;
+                continue;
+            }
+
+            change |= replaceOpnd(ir, opnds);
+        }
+    }
+    return change;
+}
+
+
+bool IR_CCP::perform(OptCtx & oc)
+{
+    START_TIMER_AFTER();
+    m_ru->checkValidAndRecompute(&oc, PASS_CFG, PASS_UNDEF);
+    if (!m_ssamgr->is_ssa_constructed()) {
+        END_TIMER_AFTER(get_pass_name());
+        return false;
+    }
+
+    clean();
+    analyze();
+
+    bool cfg_mod = false;
+    bool change = rewrite(cfg_mod);
+    if (cfg_mod) {
+        bool lchange;
+        do {
+            lchange = false;
+            lchange |= m_cfg->removeUnreachBB();
+            lchange |= m_cfg->removeEmptyBB(oc);
+            lchange |= m_cfg->removeRedundantBranch();
+            lchange |= m_cfg->removeTrampolinEdge();
+        } while (lchange);
+
+        m_cfg->computeExitList();
+
+        oc.set_flag_if_cfg_changed();
+        OC_is_du_chain_valid(oc) = false;
+        OC_is_du_chain_dirty(oc) = false;
+        OC_is_ref_valid(oc) = false;
+        OC_is_aa_valid(oc) = false;
+        OC_is_md_ssa_valid(oc) = false;
+        OC_is_reach_def_valid(oc) = false;
+        OC_is_avail_reach_def_valid(oc) = false;
+        OC_is_cfg_valid(oc) = true; //CFG has been maintained.
+    }
+
+    if (change) {
+        OC_is_expr_tab_valid(oc) = false;
+        ASSERT0(verifySSAInfo(m_ru));
+    }
+
+    END_TIMER_AFTER(get_pass_name());
+    return change;
+}
+//END IR_CCP
+
+} //namespace xoc
@@ -0,0 +1,153 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_CCP_H_
+#define _IR_CCP_H_
+
+namespace xoc {
+
+//Lattice of SSA value.
+typedef enum {
+    CCP_TOP = 0, //value is undetermined yet.
+    CCP_CONST, //value is integer constant.
+    CCP_BOTTOM, //value is not constant.
+} CCP_LAT;
+
+class CCPVal {
+public:
+    CCP_LAT lat;
+    HOST_INT val; //available if lat is CCP_CONST.
+};
+
+
+//Perform Sparse Conditional Constant Propagation.
+//The pass follows Wegman and Zadeck. Each SSA value of PR has a
+//lattice, and the lattice is lowered monotonically from TOP to BOTTOM.
+//Stmt is evaluated only if it is in executable BB, and PHI only merges
+//the operands that come from executable edges. Two worklists are
+//maintained: CFG edges that become executable, and stmts that use
+//the SSA values that are lowered.
+//After the lattices reach fixed point, PR that is constant is
+//replaced with immediate, the conditional branch that is determined
+//is folded, and BBs that are not executable become unreachable and
+//are removed from CFG.
+//NOTE: The pass requires PR SSA, only integer constant is propagated.
+class IR_CCP : public Pass {
+protected:
+    Region * m_ru;
+    IR_CFG * m_cfg;
+    TypeMgr * m_tm;
+    IR_SSA_MGR * m_ssamgr;
+
+    //Map SSA id to lattice and constant value.
+    Vector<UINT> m_lat;
+    Vector<HOST_INT> m_val;
+
+    BitSet m_exec_bb;
+    TTab<Edge const*> m_exec_edge;
+    List<Edge const*> m_edge_wl;
+    List<IR*> m_stmt_wl;
+
+    //Statistics of last run.
+    UINT m_num_const_opnd; //the number of PR replaced with immediate.
+    UINT m_num_const_stmt; //the number of stmts whose rhs is folded.
+    UINT m_num_dead_branch; //the number of conditional branches folded.
+    UINT m_num_unreach_bb; //the number of BBs that are not executable.
+
+    void analyze();
+
+    HOST_INT castToType(HOST_INT v, Type const* ty) const;
+    void clean();
+
+    CCPVal evalExp(IR const* ir);
+    CCPVal evalBinary(IR const* ir);
+    CCPVal evalUnary(IR const* ir);
+    IR * foldBranch(IR * br, bool is_taken, IN OUT bool & cfg_mod);
+
+    CCPVal getSSAVal(SSAInfo const* info) const
+    {
+        CCPVal v;
+        v.lat = (CCP_LAT)m_lat.get(SSA_id(info));
+        v.val = m_val.get(SSA_id(info));
+        return v;
+    }
+
+    bool is_exec_bb(IRBB const* bb) const
+    { return m_exec_bb.is_contain(BB_id(bb)); }
+
+    void markEdge(Edge const* e);
+    void meet(IN OUT CCPVal & v, CCPVal const& v2) const;
+
+    bool replaceOpnd(IR * stmt, Vector<IR*> & opnds);
+    bool rewrite(IN OUT bool & cfg_mod);
+
+    void setSSAVal(SSAInfo * info, CCPVal const& v);
+
+    void visitBB(IRBB * bb);
+    void visitBranch(IR const* br);
+    void visitPhi(IR * phi);
+    void visitStmt(IR * ir);
+    void visitSucc(IRBB * bb);
+public:
+    IR_CCP(Region * ru, IR_SSA_MGR * ssamgr)
+    {
+        ASSERT0(ru && ssamgr);
+        m_ru = ru;
+        m_ssamgr = ssamgr;
+        m_cfg = ru->get_cfg();
+        m_tm = ru->get_type_mgr();
+        ASSERT0(m_cfg && m_tm);
+        m_num_const_opnd = 0;
+        m_num_const_stmt = 0;
+        m_num_dead_branch = 0;
+        m_num_unreach_bb = 0;
+    }
+    COPY_CONSTRUCTOR(IR_CCP);
+    virtual ~IR_CCP() {}
+
+    void dump();
+
+    virtual CHAR const* get_pass_name() const
+    { return "Sparse Conditional Constant Propagation"; }
+    PASS_TYPE get_pass_type() const { return PASS_CCP; }
+
+    virtual UINT get_consumed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+    virtual UINT get_changed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+
+    virtual bool perform(OptCtx & oc);
+};
+
+} //namespace xoc
+#endif
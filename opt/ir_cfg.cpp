@@ -1150,6 +1150,8 @@ void IR_CFG::computeDomAndIdom(IN OUT OptCtx & oc, BitSet const* uni)
     ASSERT0(OC_is_cfg_valid(oc));
     ASSERT(m_entry, ("ONLY support SESE or SEME"));
 
+    //Passes rely on RPO being available after dominator computed,
+    //even if the dominator is represented by tree.
     m_ru->checkValidAndRecompute(&oc, PASS_RPO, PASS_UNDEF);
     List<IRBB*> * bblst = get_bblist_in_rpo();
     ASSERT0(bblst->get_elem_count() == m_ru->get_bb_list()->get_elem_count());
@@ -1160,10 +1162,44 @@ void IR_CFG::computeDomAndIdom(IN OUT OptCtx & oc, BitSet const* uni)
         vlst.append_tail(get_vertex(BB_id(bb)));
     }
 
+    bool f;
+    if (g_is_dom_tree) {
+        //Lengauer-Tarjan regards each vertex without predecessor as
+        //entry, check the result with iterative algorithm in debug mode.
+        ASSERT0(is_graph_entry(get_vertex(BB_id(m_entry))));
+        #ifdef _DEBUG_
+        Vector<INT> idom;
+        if (g_verify_level >= VERIFY_LEVEL_2) {
+            f = DGraph::computeIdom2(vlst);
+            ASSERT0(f);
+            idom.copy(m_idom_set);
+        }
+        #endif
+
+        //Dominator set will be built on demand.
+        f = DGraph::computeDomTree();
+        UNUSED(f);
+        ASSERT0(f);
+
+        #ifdef _DEBUG_
+        if (g_verify_level >= VERIFY_LEVEL_2) {
+            for (IRBB * bb = bblst->get_head();
+                 bb != NULL; bb = bblst->get_next()) {
+                ASSERT(idom.get(BB_id(bb)) == m_idom_set.get(BB_id(bb)),
+                       ("idom of BB%d should be BB%d",
+                        BB_id(bb), idom.get(BB_id(bb))));
+            }
+        }
+        #endif
+        OC_is_dom_valid(oc) = true;
+        END_TIMER_AFTER("Compute Dom, IDom");
+        return;
+    }
+
     //DGraph::computeDom(&vlst, uni);
     //DGraph::computeIdom();
 
-    bool f = DGraph::computeIdom2(vlst);
+    f = DGraph::computeIdom2(vlst);
     UNUSED(f);
     ASSERT0(f);
 
@@ -1194,6 +1230,38 @@ void IR_CFG::computePdomAndIpdom(IN OUT OptCtx & oc, BitSet const* uni)
     }
 
     bool f = false;
+    if (g_is_dom_tree) {
+        //Lengauer-Tarjan regards each vertex without successor as exit,
+        //check the result with iterative algorithm in debug mode.
+        #ifdef _DEBUG_
+        Vector<INT> ipdom;
+        if (g_verify_level >= VERIFY_LEVEL_2) {
+            f = DGraph::computePdom(&vlst) && DGraph::computeIpdom();
+            ASSERT0(f);
+            ipdom.copy(m_ipdom_set);
+        }
+        #endif
+
+        //Post-dominator set will be built on demand.
+        f = DGraph::computePdomTree();
+        UNUSED(f);
+        ASSERT0(f);
+
+        #ifdef _DEBUG_
+        if (g_verify_level >= VERIFY_LEVEL_2) {
+            for (IRBB * bb = bblst->get_head();
+                 bb != NULL; bb = bblst->get_next()) {
+                ASSERT(ipdom.get(BB_id(bb)) == m_ipdom_set.get(BB_id(bb)),
+                       ("ipdom of BB%d should be BB%d",
+                        BB_id(bb), ipdom.get(BB_id(bb))));
+            }
+        }
+        #endif
+        OC_is_pdom_valid(oc) = true;
+        END_TIMER();
+        return;
+    }
+
     if (uni != NULL) {
         f = DGraph::computePdom(&vlst, uni);
     } else {
@@ -1238,26 +1306,33 @@ bool IR_CFG::performMiscOpt(OptCtx & oc)
     do {
         lchange = false;
 
+        //Record the changes that dominator is not maintained.
+        bool dom_change = false;
         if (g_do_cfg_remove_unreach_bb) {
-            lchange |= removeUnreachBB();
+            dom_change |= removeUnreachBB();
         }
 
         if (g_do_cfg_remove_empty_bb) {
+            //Dominator is updated by removeEmptyBB() itself.
             lchange |= removeEmptyBB(oc);
         }
 
         if (g_do_cfg_remove_redundant_branch) {
-            lchange |= removeRedundantBranch();
+            dom_change |= removeRedundantBranch();
         }
 
         if (g_do_cfg_remove_trampolin_bb) {
-            lchange |= removeTrampolinEdge();
+            dom_change |= removeTrampolinEdge();
         }
 
-        if (lchange) {
-            OC_is_cdg_valid(oc) = false;
+        lchange |= dom_change;
+        if (dom_change) {
             OC_is_dom_valid(oc) = false;
             OC_is_pdom_valid(oc) = false;
+        }
+
+        if (lchange) {
+            OC_is_cdg_valid(oc) = false;
             OC_is_loopinfo_valid(oc) = false;
             OC_is_rpo_valid(oc) = false;
             ck_cfg = true;
@@ -347,6 +347,10 @@ bool IR_CP::doProp(IN IRBB * bb, Vector<IR*> & usevec)
                    !def_stmt->is_void()) {
             //Allowing copy propagate exact or VOID value.
             continue;
+        } else if (m_is_du_on_demand) {
+            //USE set of stmt is incomplete, memory operand is
+            //processed by doPropOnDemand().
+            continue;
         } else if ((useset = def_stmt->readDUSet()) != NULL &&
                    useset->get_elem_count() != 0) {
             //Record use_stmt in another vector to facilitate this function
@@ -457,6 +461,98 @@ bool IR_CP::doProp(IN IRBB * bb, Vector<IR*> & usevec)
 }
 
 
+//Propagate the value of copy to memory operand which has unique DEF.
+//Compare to doProp(), this function looks for DEF from USE, and
+//the DEF of USE is computed on demand.
+//'usevec': for local used.
+bool IR_CP::doPropOnDemand(IN IRBB * bb, Vector<IR*> & usevec, OptCtx & oc)
+{
+    bool change = false;
+    C<IR*> * cur_iter, * next_iter;
+    IRIter ii;
+    for (BB_irlist(bb).get_head(&cur_iter),
+         next_iter = cur_iter; cur_iter != NULL; cur_iter = next_iter) {
+        IR * use_stmt = cur_iter->val();
+        BB_irlist(bb).get_next(&next_iter);
+
+        //Record USE in another vector since use_stmt may be changed
+        //after copy-propagation.
+        UINT num_of_use = 0;
+        ii.clean();
+        for (IR * x = iterRhsInit(use_stmt, ii);
+             x != NULL; x = iterRhsNext(ii)) {
+            if (!x->is_memory_opnd() || x->get_ssainfo() != NULL ||
+                x->get_exact_ref() == NULL) {
+                continue;
+            }
+            usevec.set(num_of_use, x);
+            num_of_use++;
+        }
+
+        for (UINT i = 0; i < num_of_use; i++) {
+            IR * use = usevec.get(i);
+            DUSet const* defset = m_du->getDUSetOnDemand(use, oc);
+            if (defset == NULL || defset->get_elem_count() != 1) {
+                continue;
+            }
+
+            DUIter di = NULL;
+            IR * def_stmt = m_ru->get_ir(defset->get_first(&di));
+            ASSERT0(def_stmt->is_stmt());
+            if (!is_copy(def_stmt) ||
+                (def_stmt->get_exact_ref() == NULL && !def_stmt->is_void())) {
+                continue;
+            }
+
+            IRBB * def_bb = def_stmt->get_bb();
+            if (!(def_bb == bb && bb->is_dom(def_stmt, use_stmt, true)) &&
+                !m_cfg->is_dom(BB_id(def_bb), BB_id(bb))) {
+                //'def_stmt' must dominate 'use_stmt'.
+                continue;
+            }
+
+            IR const* prop_value = get_propagated_value(def_stmt);
+            if (!is_available(def_stmt, prop_value, use_stmt) ||
+                !m_du->isExactAndUniqueDef(def_stmt, use) ||
+                !canBeCandidate(prop_value)) {
+                continue;
+            }
+
+            CPCtx lchange;
+            IR * old_use_stmt = use_stmt;
+
+            replaceExp(use, prop_value, lchange, false);
+
+            if (!CPC_change(lchange)) { continue; }
+            change = true;
+
+            RefineCtx rf;
+            use_stmt = m_ru->refineIR(use_stmt, change, rf);
+            if (use_stmt != old_use_stmt) {
+                //use_stmt has been removed or new stmt generated.
+                if (!RC_stmt_removed(rf)) {
+                    BB_irlist(bb).remove(cur_iter);
+                }
+                if (use_stmt != NULL) {
+                    if (next_iter != NULL) {
+                        BB_irlist(bb).insert_before(use_stmt, next_iter);
+                    } else {
+                        BB_irlist(bb).append_tail(use_stmt);
+                    }
+                }
+
+                //The DEF memoized by DU manager has been changed.
+                m_du->cleanLazyDUChain();
+            }
+
+            //The rest of USEs may have been freed.
+            break;
+        } //end for each USE
+    } //end for IR
+    return change;
+}
+
+
 void IR_CP::doFinalRefine()
 {
     RefineCtx rf;
@@ -470,7 +566,18 @@ bool IR_CP::perform(OptCtx & oc)
     START_TIMER_AFTER();
     ASSERT0(OC_is_cfg_valid(oc));
 
-    if (m_prop_kind == CP_PROP_CONST) {
+    //Compute DU chain on demand if it is not available.
+    m_is_du_on_demand = g_lazy_du_chain && !OC_is_du_chain_valid(oc);
+    if (m_is_du_on_demand) {
+        if (m_prop_kind == CP_PROP_CONST) {
+            m_ru->checkValidAndRecompute(&oc, PASS_DOM, PASS_DU_REF,
+                                         PASS_UNDEF);
+        } else {
+            m_ru->checkValidAndRecompute(&oc, PASS_DOM, PASS_DU_REF,
+                                         PASS_LIVE_EXPR, PASS_UNDEF);
+        }
+        m_du->cleanLazyDUChain();
+    } else if (m_prop_kind == CP_PROP_CONST) {
 
         m_ru->checkValidAndRecompute(&oc, PASS_DOM, PASS_DU_REF,
                                     PASS_DU_CHAIN, PASS_UNDEF);
@@ -479,7 +586,8 @@ bool IR_CP::perform(OptCtx & oc)
                                     PASS_LIVE_EXPR, PASS_DU_CHAIN, PASS_UNDEF);
     }
 
-    if (!OC_is_du_chain_valid(oc)) {
+    if (m_is_du_on_demand ? !OC_is_ref_valid(oc) :
+                            !OC_is_du_chain_valid(oc)) {
         END_TIMER_AFTER(get_pass_name());
         return false;
     }
@@ -498,15 +606,26 @@ bool IR_CP::perform(OptCtx & oc)
         IRBB * bb = m_cfg->get_bb(VERTEX_id(v));
         ASSERT0(bb);
         change |= doProp(bb, usevec);
+        if (m_is_du_on_demand) {
+            change |= doPropOnDemand(bb, usevec, oc);
+        }
+    }
+
+    if (m_is_du_on_demand) {
+        //Memoized reach-definitions are not available after the pass.
+        m_du->cleanLazyDUChain();
     }
 
     if (change) {
         doFinalRefine();
         OC_is_expr_tab_valid(oc) = false;
         OC_is_aa_valid(oc) = false;
-        OC_is_du_chain_valid(oc) = true; //already update.
+        //DU chain is already updated unless it is computed on demand.
+        OC_is_du_chain_valid(oc) = !m_is_du_on_demand;
         OC_is_ref_valid(oc) = true; //already update.
-        ASSERT0(m_ru->verifyMDRef() && m_du->verifyMDDUChain());
+        OC_is_md_ssa_valid(oc) = false;
+        ASSERT0(m_ru->verifyMDRef());
+        ASSERT0(m_is_du_on_demand || m_du->verifyMDDUChain());
         ASSERT0(verifySSAInfo(m_ru));
     }
 
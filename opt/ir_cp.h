@@ -80,10 +80,14 @@ protected:
     TypeMgr * m_tm;
     UINT m_prop_kind;
 
+    //True if DU chain of memory is computed on demand.
+    bool m_is_du_on_demand;
+
     inline bool checkTypeConsistency(
             IR const* ir,
             IR const* cand_expr) const;
     bool doProp(IN IRBB * bb, Vector<IR*> & usevec);
+    bool doPropOnDemand(IN IRBB * bb, Vector<IR*> & usevec, OptCtx & oc);
     void doFinalRefine();
 
     bool is_simp_cvt(IR const* ir) const;
@@ -114,6 +118,7 @@ public:
         m_tm = ru->get_type_mgr();
         ASSERT0(m_cfg && m_du && m_md_sys && m_tm && m_md_set_mgr);
         m_prop_kind = CP_PROP_UNARY_AND_SIMPLEX;
+        m_is_du_on_demand = false;
     }
     virtual ~IR_CP() {}
 
@@ -154,6 +159,9 @@ public:
 
     virtual CHAR const* get_pass_name() const { return "Copy Propagation"; }
     virtual PASS_TYPE get_pass_type() const { return PASS_CP; }
+    virtual UINT get_consumed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+    virtual UINT get_changed_fact() const { return FACT_EXP; }
 
     void set_prop_kind(UINT kind) { m_prop_kind = kind; }
 
@@ -36,6 +36,7 @@ author: Su Zhenyu
 #include "prdf.h"
 #include "prssainfo.h"
 #include "ir_ssa.h"
+#include "ir_mdssa.h"
 
 namespace xoc {
 
@@ -364,6 +365,7 @@ void IR_DCE::iter_collect(IN OUT EFFECT_STMT & is_stmt_effect,
     List<IR const*> * pwlst2 = &work_list2;
     bool change = true;
     List<IRBB*> succs;
+    IRSet defs(m_ru->getMiscBitSetMgr()->getSegMgr());
     while (change) {
         change = false;
         for (IR const* ir = pwlst1->get_head();
@@ -379,6 +381,22 @@ void IR_DCE::iter_collect(IN OUT EFFECT_STMT & is_stmt_effect,
                         ASSERT0(d->is_stmt());
                         ASSERT0(d->is_write_pr() || d->isCallHasRetVal());
 
+                        if (!is_stmt_effect.is_contain(IR_id(d))) {
+                            change = true;
+                            pwlst2->append_tail(d);
+                            is_stmt_effect.bunion(IR_id(d));
+                            ASSERT0(d->get_bb() != NULL);
+                            is_bb_effect.bunion(BB_id(d->get_bb()));
+                        }
+                    }
+                } else if (m_mdssamgr != NULL && !x->is_read_pr()) {
+                    defs.clean();
+                    m_mdssamgr->collectDefs(x, defs);
+                    SEGIter * sc = NULL;
+                    for (INT i = defs.get_first(&sc);
+                         i >= 0; i = defs.get_next(i, &sc)) {
+                        IR const* d = m_ru->get_ir(i);
+                        ASSERT0(d->is_stmt());
                         if (!is_stmt_effect.is_contain(IR_id(d))) {
                             change = true;
                             pwlst2->append_tail(d);
@@ -573,17 +591,42 @@ void IR_DCE::revise_successor(IRBB * bb, C<IRBB*> * bbct, BBList * bbl)
 bool IR_DCE::perform(OptCtx & oc)
 {
     START_TIMER_AFTER();
-    if (m_is_elim_cfs) {
+    //DU chain of memory is not necessary if both PR and MD are
+    //in SSA form.
+    IR_SSA_MGR * ssamgr =
+        (IR_SSA_MGR*)m_ru->get_pass_mgr()->queryPass(PASS_SSA_MGR);
+    bool use_md_ssa = g_do_md_ssa && ssamgr != NULL &&
+                      ssamgr->is_ssa_constructed();
+    m_mdssamgr = NULL;
+    if (use_md_ssa) {
+        if (m_is_elim_cfs) {
+            m_ru->checkValidAndRecompute(&oc, PASS_DU_REF, PASS_CDG,
+                                         PASS_PDOM, PASS_MD_SSA_MGR,
+                                         PASS_UNDEF);
+        } else {
+            m_ru->checkValidAndRecompute(&oc, PASS_DU_REF, PASS_PDOM,
+                                         PASS_MD_SSA_MGR, PASS_UNDEF);
+        }
+        if (OC_is_md_ssa_valid(oc)) {
+            m_mdssamgr = (MDSSAMgr*)m_ru->get_pass_mgr()->
+                queryPass(PASS_MD_SSA_MGR);
+            ASSERT0(m_mdssamgr && m_mdssamgr->is_ssa_constructed());
+        }
+    } else if (m_is_elim_cfs) {
         m_ru->checkValidAndRecompute(&oc, PASS_DU_REF, PASS_CDG,PASS_PDOM,
                                      PASS_DU_CHAIN, PASS_CDG, PASS_UNDEF);
-        m_cdg = (CDG*)m_ru->get_pass_mgr()->registerPass(PASS_CDG);
     } else {
         m_ru->checkValidAndRecompute(&oc, PASS_DU_REF, PASS_PDOM,
                                      PASS_DU_CHAIN, PASS_UNDEF);
+    }
+
+    if (m_is_elim_cfs) {
+        m_cdg = (CDG*)m_ru->get_pass_mgr()->registerPass(PASS_CDG);
+    } else {
         m_cdg = NULL;
     }
 
-    if (!OC_is_du_chain_valid(oc)) {
+    if (m_mdssamgr == NULL && !OC_is_du_chain_valid(oc)) {
         END_TIMER_AFTER(get_pass_name());
         return false;
     }
@@ -635,6 +678,9 @@ bool IR_DCE::perform(OptCtx & oc)
                 if (stmt->is_cond_br() || stmt->is_uncond_br() ||
                     stmt->is_multicond_br()) {
                     revise_successor(bb, ctbb, bbl);
+
+                    //Phi operands of MD SSA correspond to predecessors.
+                    OC_is_md_ssa_valid(oc) = false;
                 }
 
                 BB_irlist(bb).remove(ctir);
@@ -671,7 +717,10 @@ bool IR_DCE::perform(OptCtx & oc)
         m_cfg->performMiscOpt(oc);
 
         //AA, DU chain and du reference are maintained.
-        ASSERT0(m_ru->verifyMDRef() && m_du->verifyMDDUChain());
+        ASSERT0(m_ru->verifyMDRef());
+        ASSERT0(!OC_is_du_chain_valid(oc) || m_du->verifyMDDUChain());
+        ASSERT0(!OC_is_md_ssa_valid(oc) || m_mdssamgr == NULL ||
+                m_mdssamgr->verify());
         OC_is_expr_tab_valid(oc) = false;
         OC_is_live_expr_valid(oc) = false;
         OC_is_reach_def_valid(oc) = false;
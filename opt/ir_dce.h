@@ -53,6 +53,7 @@ protected:
     IR_CFG * m_cfg;
     CDG * m_cdg;
     IR_DU_MGR * m_du;
+    MDSSAMgr * m_mdssamgr; //not NULL if MD SSA is used instead of DU chain.
     ConstIRIter m_citer;
     bool m_is_elim_cfs; //Eliminate control flow structure if necessary.
 
@@ -110,6 +111,7 @@ public:
         m_is_elim_cfs = false;
         m_is_use_md_du = true;
         m_cdg = NULL;
+        m_mdssamgr = NULL;
     }
     virtual ~IR_DCE() {}
 
@@ -120,6 +122,14 @@ public:
     virtual CHAR const* get_pass_name() const
     { return "Dead Code Eliminiation"; }
     virtual PASS_TYPE get_pass_type() const { return PASS_DCE; }
+    virtual UINT get_consumed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+    virtual UINT get_changed_fact() const
+    { return m_is_elim_cfs ? FACT_STMT | FACT_CFG | FACT_LOOP : FACT_STMT; }
+
+    //MD SSA is revised when stmt removed, and is invalidated if
+    //branch removed.
+    virtual bool is_md_ssa_maintained() const { return true; }
 
     void set_elim_cfs(bool doit) { m_is_elim_cfs = doit; }
     void set_use_md_du(bool use_md_du) { m_is_use_md_du = use_md_du; }
@@ -0,0 +1,453 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "prdf.h"
+#include "prssainfo.h"
+#include "ir_ssa.h"
+#include "ir_dse.h"
+
+namespace xoc {
+
+//Return true if 'exp' and its siblings read PR 'prno'.
+static bool isReadPR(IR const* exp, UINT prno)
+{
+    ConstIRPreIter it;
+    for (IR const* x = it.init(exp); x != NULL; x = it.next()) {
+        if (x->is_read_pr() && x->get_prno() == prno) { return true; }
+    }
+    return false;
+}
+
+
+//Return true if 'use' overlaps 'md'.
+static bool isOverlap(MD const* use, MD const* md)
+{
+    if (use == md) { return true; }
+    if (MD_id(use) == MD_GLOBAL_MEM && md->is_global()) { return true; }
+    return use->is_overlap(md);
+}
+
+
+//
+//START IR_DSE
+//
+IR_DSE::IR_DSE(Region * ru)
+{
+    ASSERT0(ru);
+    m_ru = ru;
+    m_cfg = ru->get_cfg();
+    m_du = ru->get_du_mgr();
+    m_md_sys = ru->get_md_sys();
+    ASSERT0(m_cfg && m_du && m_md_sys);
+    m_num_cand = 0;
+    m_num_removed = 0;
+}
+
+
+//Free the resources of last run, the statistics are kept for dump.
+void IR_DSE::clean()
+{
+    m_universe.clean();
+    m_local.clean();
+    m_gen.clean();
+    m_keep.clean();
+    m_deadin.clean();
+    m_deadout.clean();
+    m_bs_mgr.clean();
+    m_dead_stores.clean();
+}
+
+
+void IR_DSE::dump()
+{
+    if (g_tfile == NULL) { return; }
+    fprintf(g_tfile, "\n==---- DUMP DSE -- ru:'%s' ----==",
+            m_ru->get_ru_name());
+    fprintf(g_tfile, "\ncandidate store:%d, removed:%d",
+            m_num_cand, m_num_removed);
+    fflush(g_tfile);
+}
+
+
+BitSet * IR_DSE::allocBitSet(Vector<BitSet*> & vec, UINT bbid)
+{
+    BitSet * bs = vec.get(bbid);
+    if (bs == NULL) {
+        bs = m_bs_mgr.create();
+        vec.set(bbid, bs);
+    }
+    return bs;
+}
+
+
+//Return true if 'md' can not be accessed by other functions, thus the
+//value is useless after region exit.
+//NOTE: a local VAR of function may be accessed by the code following
+//a sub-region, thus only the VAR declared in current function region
+//is dead at exit.
+bool IR_DSE::is_local(MD const* md) const
+{
+    if (!m_ru->is_function()) { return false; }
+    VAR const* v = md->get_base();
+    return VAR_is_local(v) && !VAR_is_static(v) &&
+           !VAR_is_addr_taken(v) && !VAR_is_volatile(v) &&
+           m_ru->get_var_tab()->find(const_cast<VAR*>(v));
+}
+
+
+//Return the MustDef if 'stmt' is candidate store, otherwise NULL.
+MD const* IR_DSE::getCandMD(IR const* stmt) const
+{
+    switch (stmt->get_code()) {
+    case IR_ST:
+    case IR_IST:
+    case IR_STARRAY:
+        break;
+    default: return NULL;
+    }
+    if (IR_has_sideeffect(stmt) || IR_no_move(stmt)) { return NULL; }
+
+    //Only exact MustDef overrides the whole value.
+    MD const* md = stmt->getRefMD();
+    if (md == NULL || !md->is_exact() || md->is_volatile()) { return NULL; }
+
+    //The value is used if there is DU chain.
+    DUSet const* du = stmt->readDUSet();
+    if (du != NULL && !du->is_empty()) { return NULL; }
+
+    ConstIRPreIter it;
+    for (IR const* x = it.initRhs(stmt); x != NULL; x = it.next()) {
+        if (IR_has_sideeffect(x)) { return NULL; }
+        if (!x->is_memory_ref() || x->is_pr()) { continue; }
+        MD const* use = x->getRefMD();
+        if (use != NULL && use->is_volatile()) { return NULL; }
+    }
+    return md;
+}
+
+
+//Collect the MustDef of candidate stores.
+void IR_DSE::collectCand()
+{
+    BBList * bbl = m_ru->get_bb_list();
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            MD const* md = getCandMD(ir);
+            if (md == NULL) { continue; }
+            m_num_cand++;
+            m_universe.bunion(MD_id(md));
+            if (is_local(md)) {
+                m_local.bunion(MD_id(md));
+            }
+        }
+    }
+}
+
+
+//Remove the MDs that read by the operands of 'stmt' from 'dead'.
+void IR_DSE::killUse(IR const* stmt, IN OUT BitSet & dead) const
+{
+    ConstIRPreIter it;
+    for (IR const* x = it.initRhs(stmt);
+         x != NULL && !dead.is_empty(); x = it.next()) {
+        if (!x->is_memory_ref() || x->is_pr()) { continue; }
+
+        MD const* use = x->getRefMD();
+        MDSet const* uses = x->getRefMDSet();
+        if (use == NULL && (uses == NULL || uses->is_empty())) {
+            //The memory that referenced is unknown.
+            dead.clean();
+            return;
+        }
+
+        for (INT i = dead.get_first(); i >= 0; i = dead.get_next(i)) {
+            MD const* md = m_md_sys->get_md(i);
+            ASSERT0(md);
+            if ((use != NULL && isOverlap(use, md)) ||
+                (uses != NULL && uses->is_overlap_ex(md, m_md_sys))) {
+                dead.diff(i);
+            }
+        }
+    }
+}
+
+
+//Compute the MDs that are dead before 'stmt' according to the MDs
+//that are dead after 'stmt'.
+void IR_DSE::transferStmt(IR const* stmt, IN OUT BitSet & dead) const
+{
+    if (stmt->is_region()) {
+        dead.clean();
+        return;
+    }
+
+    //Stmt defines the value after its operands are evaluated.
+    MD const* md = stmt->getRefMD();
+    if (md != NULL && md->is_exact() && m_universe.is_contain(MD_id(md))) {
+        dead.bunion(MD_id(md));
+    }
+
+    if (stmt->is_calls_stmt() || stmt->is_may_throw()) {
+        //Callee, or the caller that catches the exception, may read
+        //the memory except local variables.
+        dead.intersect(m_local);
+        if (stmt->is_may_throw() && m_cfg->has_eh_edge()) {
+            //Handler in region may read local variables as well.
+            dead.clean();
+        }
+    }
+    killUse(stmt, dead);
+}
+
+
+//Return true if 'st1' and 'st2' store to the same address.
+bool IR_DSE::is_same_addr(IR const* st1, IR const* st2) const
+{
+    if (!st1->isIREqual(st2, false)) { return false; }
+    switch (st1->get_code()) {
+    case IR_ST:
+        return true;
+    case IR_IST:
+        return IST_base(st1)->isIREqual(IST_base(st2));
+    case IR_STARRAY:
+        return ARR_base(st1)->isIREqual(ARR_base(st2)) &&
+               ARR_sub_list(st1)->isIRListEqual(ARR_sub_list(st2));
+    default: UNREACH();
+    }
+    return false;
+}
+
+
+//Return true if store that may throw can be removed.
+//The store should be overwritten by a store to the same address in
+//'bb', then the latter one throws exception in the same condition.
+//'ct': holder of the store.
+//'md': MustDef of the store.
+bool IR_DSE::is_throw_removable(IRBB * bb, C<IR*> * ct, MD const* md) const
+{
+    IR const* st = ct->val();
+    BBIRList & irlst = BB_irlist(bb);
+    BitSet dead;
+    for (ct = irlst.get_next(ct); ct != irlst.end(); ct = irlst.get_next(ct)) {
+        IR const* ir = ct->val();
+        dead.bunion(MD_id(md));
+        killUse(ir, dead);
+        if (dead.is_empty()) { return false; }
+
+        if (ir->getRefMD() == md && is_same_addr(st, ir)) { return true; }
+
+        //Handler may observe the PR that assigned before exception.
+        if (m_cfg->has_eh_edge()) { return false; }
+        if (!ir->is_stpr() || ir->is_may_throw() || IR_has_sideeffect(ir)) {
+            return false;
+        }
+
+        //Address of store should not be changed.
+        switch (st->get_code()) {
+        case IR_IST:
+            if (isReadPR(IST_base(st), STPR_no(ir))) { return false; }
+            break;
+        case IR_STARRAY:
+            if (isReadPR(ARR_base(st), STPR_no(ir)) ||
+                isReadPR(ARR_sub_list(st), STPR_no(ir))) {
+                return false;
+            }
+            break;
+        default: break;
+        }
+    }
+    return false;
+}
+
+
+//Compute the local effect of 'bb'.
+//Transfer function of BB is in the form of (X & KEEP) | GEN, then
+//GEN is the result of empty set, and KEEP | GEN is the result of
+//universe.
+void IR_DSE::computeLocal(IRBB * bb)
+{
+    BitSet * gen = allocBitSet(m_gen, BB_id(bb));
+    BitSet * keep = allocBitSet(m_keep, BB_id(bb));
+    gen->clean();
+    keep->copy(m_universe);
+    BBIRList & irlst = BB_irlist(bb);
+    C<IR*> * ct;
+    for (irlst.get_tail(&ct); ct != irlst.end(); ct = irlst.get_prev(ct)) {
+        transferStmt(ct->val(), *gen);
+        transferStmt(ct->val(), *keep);
+    }
+}
+
+
+//Compute DEADOUT in backward direction.
+//DEADOUT(i) = Intersection of DEADIN(s), s is successor of i.
+//DEADIN(i) = (DEADOUT(i) & KEEP(i)) | GEN(i)
+//Local variables are dead at region exit.
+void IR_DSE::computeDeadOut(List<IRBB*> & rpo)
+{
+    for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+        computeLocal(bb);
+        allocBitSet(m_deadin, BB_id(bb))->copy(m_universe);
+        allocBitSet(m_deadout, BB_id(bb));
+    }
+
+    BitSet in;
+    bool change = true;
+    UINT count = 0;
+    while (change && count < 100) {
+        change = false;
+        for (IRBB * bb = rpo.get_tail(); bb != NULL; bb = rpo.get_prev()) {
+            Vertex * v = m_cfg->get_vertex(BB_id(bb));
+            ASSERT0(v);
+            BitSet * deadout = m_deadout.get(BB_id(bb));
+            if (VERTEX_out_list(v) == NULL) {
+                deadout->copy(m_local);
+            } else {
+                deadout->copy(m_universe);
+                for (EdgeC * ec = VERTEX_out_list(v);
+                     ec != NULL; ec = EC_next(ec)) {
+                    CFGEdgeInfo * ei = (CFGEdgeInfo*)EDGE_info(EC_edge(ec));
+                    if (ei != NULL && CFGEI_is_eh(ei)) {
+                        deadout->clean();
+                        break;
+                    }
+                    BitSet * sin = m_deadin.get(
+                        VERTEX_id(EDGE_to(EC_edge(ec))));
+                    if (sin != NULL) {
+                        deadout->intersect(*sin);
+                    }
+                }
+            }
+
+            in.copy(*deadout);
+            in.intersect(*m_keep.get(BB_id(bb)));
+            in.bunion(*m_gen.get(BB_id(bb)));
+            BitSet * deadin = m_deadin.get(BB_id(bb));
+            if (!deadin->is_equal(in)) {
+                deadin->copy(in);
+                change = true;
+            }
+        }
+        count++;
+    }
+    ASSERT0(!change);
+}
+
+
+//Collect dead stores in 'bb'.
+void IR_DSE::collectDeadStore(IRBB * bb)
+{
+    BitSet dead;
+    dead.copy(*m_deadout.get(BB_id(bb)));
+    BBIRList & irlst = BB_irlist(bb);
+    C<IR*> * ct;
+    for (irlst.get_tail(&ct); ct != irlst.end(); ct = irlst.get_prev(ct)) {
+        IR * ir = ct->val();
+        MD const* md = getCandMD(ir);
+        if (md != NULL) {
+            //Removing store that may throw changes the exception
+            //behavior unless it is overwritten in the same manner.
+            if (ir->is_may_throw() ?
+                is_throw_removable(bb, ct, md) :
+                dead.is_contain(MD_id(md))) {
+                m_dead_stores.append_tail(ir);
+            }
+        }
+        transferStmt(ir, dead);
+    }
+}
+
+
+bool IR_DSE::perform(OptCtx & oc)
+{
+    START_TIMER_AFTER();
+    m_ru->checkValidAndRecompute(&oc, PASS_DU_REF, PASS_DU_CHAIN,
+                                 PASS_RPO, PASS_UNDEF);
+    m_num_cand = 0;
+    m_num_removed = 0;
+    if (!OC_is_du_chain_valid(oc)) {
+        END_TIMER_AFTER(get_pass_name());
+        return false;
+    }
+
+    clean();
+    collectCand();
+    if (m_universe.is_empty()) {
+        END_TIMER_AFTER(get_pass_name());
+        return false;
+    }
+
+    List<IRBB*> * rpo = m_cfg->get_bblist_in_rpo();
+    computeDeadOut(*rpo);
+    for (IRBB * bb = rpo->get_head(); bb != NULL; bb = rpo->get_next()) {
+        collectDeadStore(bb);
+    }
+
+    for (IR * st = m_dead_stores.get_head();
+         st != NULL; st = m_dead_stores.get_next()) {
+        IRBB * bb = st->get_bb();
+        ASSERT0(bb);
+        C<IR*> * ct = NULL;
+        bool f = BB_irlist(bb).find(st, &ct);
+        CK_USE(f);
+
+        //Revise SSA info if PR is in SSA form.
+        st->removeSSAUse();
+
+        //Revise DU chain and MD SSA.
+        m_du->removeIROutFromDUMgr(st);
+
+        BB_irlist(bb).remove(ct);
+        m_ru->freeIRTree(st);
+        m_num_removed++;
+    }
+
+    bool change = m_num_removed != 0;
+    clean();
+    if (change) {
+        //AA, DU chain and du reference are maintained.
+        ASSERT0(m_ru->verifyMDRef());
+        ASSERT0(m_du->verifyMDDUChain());
+        ASSERT0(verifySSAInfo(m_ru));
+        OC_is_expr_tab_valid(oc) = false;
+        OC_is_live_expr_valid(oc) = false;
+        OC_is_reach_def_valid(oc) = false;
+        OC_is_avail_reach_def_valid(oc) = false;
+    }
+    END_TIMER_AFTER(get_pass_name());
+    return change;
+}
+//END IR_DSE
+
+} //namespace xoc
@@ -0,0 +1,123 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_DSE_H_
+#define _IR_DSE_H_
+
+namespace xoc {
+
+//Perform Dead Store Elimination.
+//A store to memory is dead if the value is overwritten on all paths
+//before it is read, or the memory is a local variable that can not be
+//observed after region exit.
+//The pass computes the MDs that are dead at the entry and exit of each
+//BB in backward direction. A stmt whose MustDef is exact makes the MD
+//dead, and an expression whose MustUse or MayUse overlaps the MD
+//makes it live. Calls and exceptions make all memory visible to other
+//functions live. The intersection at successors covers the case that
+//the store is overwritten in all successors, i.e: the killing stores
+//post-dominate it.
+//Candidates are IR_ST, IR_IST and IR_STARRAY with exact MustDef and
+//without DU chain, thus MD reference and DU chain must be available.
+//A store that may throw is removed only if it is overwritten by a
+//store to the same address in the same BB, with no intervening stmt
+//that could observe the difference.
+class IR_DSE : public Pass {
+protected:
+    Region * m_ru;
+    IR_CFG * m_cfg;
+    IR_DU_MGR * m_du;
+    MDSystem * m_md_sys;
+    BitSetMgr m_bs_mgr;
+
+    //Record the MustDef of candidate stores.
+    BitSet m_universe;
+
+    //Record the MDs in universe that are not visible to other functions.
+    BitSet m_local;
+
+    //Map BB id to the local effect of BB, the MDs dead at the entry
+    //of BB are (DEADOUT & KEEP) | GEN.
+    Vector<BitSet*> m_gen;
+    Vector<BitSet*> m_keep;
+
+    //Map BB id to the MDs dead at the entry and exit of BB.
+    Vector<BitSet*> m_deadin;
+    Vector<BitSet*> m_deadout;
+
+    //Record the stores to be removed.
+    List<IR*> m_dead_stores;
+
+    //Statistics of last run.
+    UINT m_num_cand; //the number of candidate stores.
+    UINT m_num_removed; //the number of stores removed.
+
+    BitSet * allocBitSet(Vector<BitSet*> & vec, UINT bbid);
+
+    void clean();
+    void collectCand();
+    void collectDeadStore(IRBB * bb);
+    void computeDeadOut(List<IRBB*> & rpo);
+    void computeLocal(IRBB * bb);
+
+    MD const* getCandMD(IR const* stmt) const;
+
+    bool is_local(MD const* md) const;
+    bool is_same_addr(IR const* st1, IR const* st2) const;
+    bool is_throw_removable(IRBB * bb, C<IR*> * ct, MD const* md) const;
+
+    void killUse(IR const* stmt, IN OUT BitSet & dead) const;
+    void transferStmt(IR const* stmt, IN OUT BitSet & dead) const;
+public:
+    explicit IR_DSE(Region * ru);
+    COPY_CONSTRUCTOR(IR_DSE);
+    virtual ~IR_DSE() { clean(); }
+
+    void dump();
+
+    virtual CHAR const* get_pass_name() const
+    { return "Dead Store Elimination"; }
+    PASS_TYPE get_pass_type() const { return PASS_DSE; }
+
+    virtual UINT get_consumed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+    virtual UINT get_changed_fact() const { return FACT_STMT; }
+
+    //MD SSA is revised when stmt removed.
+    virtual bool is_md_ssa_maintained() const { return true; }
+
+    virtual bool perform(OptCtx & oc);
+};
+
+} //namespace xoc
+#endif
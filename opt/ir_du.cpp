@@ -36,6 +36,7 @@ author: Su Zhenyu
 #include "prdf.h"
 #include "prssainfo.h"
 #include "ir_ssa.h"
+#include "ir_mdssa.h"
 
 namespace xoc {
 
@@ -44,9 +45,6 @@ namespace xoc {
 //and no-sparse set may speed up compilation.
 #define SOL_SET_IS_SPARSE    (true)
 
-//Iterative methodology.
-//#define WORK_LIST_DRIVE
-
 #define CK_UNKNOWN        0 //Can not determine if memory is overlap.
 #define CK_OVERLAP        1 //Can be confirmed memory is overlap.
 #define CK_NOT_OVERLAP    2 //Can be confirmed memory is not overlap.
@@ -94,7 +92,7 @@ void MDId2IRlist::clean()
     m_are_stmts_defed_ineffect_md = false;
 
     //Do not clean DefSBitSet* here, it will incur memory leak.
-    //TMap<UINT, DefSBitSetCore*>::clean();
+    //BTMap<UINT, DefSBitSetCore*>::clean();
 }
 
 
@@ -104,10 +102,10 @@ void MDId2IRlist::set(UINT mdid, IR * ir)
     ASSERT(mdid != MD_GLOBAL_MEM && mdid != MD_ALL_MEM,
             ("there is not any md could kill Fake-May-MD."));
     ASSERT0(ir);
-    DefSBitSetCore * irtab = TMap<UINT, DefSBitSetCore*>::get(mdid);
+    DefSBitSetCore * irtab = BTMap<UINT, DefSBitSetCore*>::get(mdid);
     if (irtab == NULL) {
         irtab = new DefSBitSetCore();
-        TMap<UINT, DefSBitSetCore*>::set(mdid, irtab);
+        BTMap<UINT, DefSBitSetCore*>::set(mdid, irtab);
     } else {
         irtab->clean(*m_misc_bs_mgr);
     }
@@ -118,10 +116,10 @@ void MDId2IRlist::set(UINT mdid, IR * ir)
 //'md' corresponds to multiple 'ir'.
 void MDId2IRlist::append(UINT mdid, UINT irid)
 {
-    DefSBitSetCore * irtab = TMap<UINT, DefSBitSetCore*>::get(mdid);
+    DefSBitSetCore * irtab = BTMap<UINT, DefSBitSetCore*>::get(mdid);
     if (irtab == NULL) {
         irtab = new DefSBitSetCore();
-        TMap<UINT, DefSBitSetCore*>::set(mdid, irtab);
+        BTMap<UINT, DefSBitSetCore*>::set(mdid, irtab);
     }
     irtab->bunion(irid, *m_misc_bs_mgr);
 }
@@ -182,6 +180,8 @@ IR_DU_MGR::IR_DU_MGR(Region * ru)
     m_is_init = NULL;
     m_md2irs = NULL;
     m_is_compute_pr_du_chain = true;
+    m_solve_bb_visit = 0;
+    m_solve_set_op = 0;
 
     //NOTE: call clean() for each object which
     //inheirted from SBitSet or SBitSetCore while destructing the object.
@@ -200,6 +200,7 @@ IR_DU_MGR::~IR_DU_MGR()
 
     ASSERT0(m_is_init == NULL);
     ASSERT0(m_md2irs == NULL);
+    cleanLazyDUChain();
     resetGlobalSet(false);
     smpoolDelete(m_pool);
 
@@ -567,7 +568,8 @@ bool IR_DU_MGR::is_stpr_may_def(IR const* def, IR const* use, bool is_recur)
 static bool is_call_may_def_core(
             IR const* call,
             IR const* use,
-            MDSet const* call_maydef)
+            MDSet const* call_maydef,
+            MDSetHash * mds_hash)
 {
     //MD of use may be exact or inexact.
     MD const* use_md = use->get_effect_ref();
@@ -581,8 +583,7 @@ static bool is_call_may_def_core(
             return true;
         }
 
-        if (use_mds != NULL &&
-            (use_mds == call_maydef || call_maydef->is_intersect(*use_mds))) {
+        if (use_mds != NULL && mds_hash->isIntersect(call_maydef, use_mds)) {
             return true;
         }
     }
@@ -603,7 +604,7 @@ bool IR_DU_MGR::is_call_may_def(IR const* call, IR const* use, bool is_recur)
              x != NULL; x = iterNextC(m_citer)) {
             if (!x->is_memory_opnd()) { continue; }
 
-            if (is_call_may_def_core(call, x, call_maydef)) {
+            if (is_call_may_def_core(call, x, call_maydef, m_mds_hash)) {
                 return true;
             }
         }
@@ -611,7 +612,7 @@ bool IR_DU_MGR::is_call_may_def(IR const* call, IR const* use, bool is_recur)
     }
 
     ASSERT0(use->is_memory_opnd());
-    return is_call_may_def_core(call, use, call_maydef);
+    return is_call_may_def_core(call, use, call_maydef, m_mds_hash);
 }
 
 
@@ -649,8 +650,7 @@ bool IR_DU_MGR::is_may_def(IR const* def, IR const* use, bool is_recur)
             MDSet const* mayuse = get_may_use(x);
             if (mayuse != NULL) {
                 if ((mustdef != NULL && mayuse->is_contain(mustdef)) ||
-                    (maydef != NULL &&
-                     (maydef == mayuse || mayuse->is_intersect(*maydef)))) {
+                    m_mds_hash->isIntersect(maydef, mayuse)) {
                     return true;
                 }
             }
@@ -669,7 +669,7 @@ bool IR_DU_MGR::is_may_def(IR const* def, IR const* use, bool is_recur)
     MDSet const* mayuse = get_may_use(use);
     if (mayuse != NULL) {
         if ((mustdef != NULL && mayuse->is_contain(mustdef)) ||
-            (maydef != NULL && mayuse->is_intersect(*maydef))) {
+            m_mds_hash->isIntersect(maydef, mayuse)) {
             return true;
         }
     }
@@ -696,7 +696,8 @@ bool IR_DU_MGR::is_may_kill(IR const* def1, IR const* def2)
         if (md2 != NULL && md1 == md2) {
             return true;
         }
-        if (mds2 != NULL && (mds1 == mds2 || mds2->is_contain(md1))) {
+        if (mds2 != NULL &&
+            (m_mds_hash->isEqual(mds1, mds2) || mds2->is_contain(md1))) {
             return true;
         }
         return false;
@@ -706,7 +707,7 @@ bool IR_DU_MGR::is_may_kill(IR const* def1, IR const* def2)
         if (md2 != NULL && mds1->is_contain(md2)) {
             return true;
         }
-        if (mds2 != NULL && (mds2 == mds1 || mds1->is_intersect(*mds2))) {
+        if (m_mds_hash->isIntersect(mds1, mds2)) {
             return true;
         }
     }
@@ -1019,6 +1020,13 @@ void IR_DU_MGR::dumpMemUsageForMDRef()
     BBList * bbs = m_ru->get_bb_list();
     UINT count = 0;
     CHAR const* str = NULL;
+
+    //Record the MDSets referenced to compute the memory saved by
+    //sharing hashed set.
+    TTab<MDSet const*> refmds;
+    UINT num_ref = 0;
+    size_t ref_bytes = 0;
+    size_t shared_bytes = 0;
     g_indent = 0;
     for (IRBB * bb = bbs->get_head(); bb != NULL; bb = bbs->get_next()) {
         fprintf(g_tfile, "\n--- BB%d ---", BB_id(bb));
@@ -1042,6 +1050,12 @@ void IR_DU_MGR::dumpMemUsageForMDRef()
                     MDSet const* mds = get_may_def(x);
                     if (mds != NULL) {
                         size_t n = mds->count_mem();
+                        num_ref++;
+                        ref_bytes += n;
+                        if (!refmds.find(mds)) {
+                            refmds.append(mds);
+                            shared_bytes += n;
+                        }
                         if (n < 1024) { str = "B"; }
                         else if (n < 1024 * 1024) { n /= 1024; str = "KB"; }
                         else  { n /= 1024*1024; str = "MB"; }
@@ -1065,6 +1079,12 @@ void IR_DU_MGR::dumpMemUsageForMDRef()
                     MDSet const* mds = get_may_use(x);
                     if (mds != NULL) {
                         size_t n = mds->count_mem();
+                        num_ref++;
+                        ref_bytes += n;
+                        if (!refmds.find(mds)) {
+                            refmds.append(mds);
+                            shared_bytes += n;
+                        }
                         if (n < 1024) { str = "B"; }
                         else if (n < 1024 * 1024) { n /= 1024; str = "KB"; }
                         else { n /= 1024*1024; str = "MB"; }
@@ -1085,6 +1105,13 @@ void IR_DU_MGR::dumpMemUsageForMDRef()
     else if (count < 1024 * 1024) { count /= 1024; str = "KB"; }
     else  { count /= 1024*1024; str = "MB"; }
     fprintf(g_tfile, "\nTotal %d%s", count, str);
+
+    fprintf(g_tfile, "\nMDSet referenced: %u, distinct: %u, "
+            "%lu bytes if not shared, %lu bytes shared, saved %lu bytes",
+            num_ref, refmds.get_elem_count(), (ULONG)ref_bytes,
+            (ULONG)shared_bytes, (ULONG)(ref_bytes - shared_bytes));
+    m_mds_hash->dumpStat(g_tfile);
+    m_md_sys->dumpOverlapStat();
     fflush(g_tfile);
 }
 
@@ -1929,10 +1956,7 @@ bool IR_DU_MGR::is_overlap_def_use(
         IR const* use)
 {
     if (maydef != NULL) {
-        MDSet const* mayuse = get_may_use(use);
-        if (mayuse != NULL &&
-            (mayuse == maydef ||
-             mayuse->is_intersect(*maydef))) {
+        if (m_mds_hash->isIntersect(get_may_use(use), maydef)) {
             return true;
         }
 
@@ -2111,6 +2135,11 @@ bool IR_DU_MGR::removeExpiredDU(IR * stmt)
 //this functin cut off du-chain between d1, d2 and their use.
 void IR_DU_MGR::removeUseOutFromDefset(IR * ir)
 {
+    MDSSAMgr * mdssamgr = getMDSSAMgr();
+    if (mdssamgr != NULL) {
+        mdssamgr->removeUse(ir);
+    }
+
     m_citer.clean();
     IR const* k;
     if (ir->is_stmt()) {
@@ -2194,6 +2223,11 @@ void IR_DU_MGR::removeIROutFromDUMgr(IR * ir)
     ASSERT0(ir->is_stmt());
     removeUseOutFromDefset(ir);
 
+    MDSSAMgr * mdssamgr = getMDSSAMgr();
+    if (mdssamgr != NULL) {
+        mdssamgr->removeDef(ir);
+    }
+
     //If stmt has SSA info, it should be maintained by SSA related api.
     if (ir->get_ssainfo() == NULL) {
         removeDefOutFromUseset(ir);
@@ -2201,6 +2235,35 @@ void IR_DU_MGR::removeIROutFromDUMgr(IR * ir)
 }
 
 
+//If PRs have already been in SSA form, then computing DU chain for them
+//doesn't make any sense.
+void IR_DU_MGR::setComputePRDUBySSA()
+{
+    if (m_ru->get_pass_mgr() == NULL) {
+        setComputePRDU(true);
+        return;
+    }
+    IR_SSA_MGR * ssamgr =
+        (IR_SSA_MGR*)m_ru->get_pass_mgr()->queryPass(PASS_SSA_MGR);
+    setComputePRDU(ssamgr == NULL || !ssamgr->is_ssa_constructed());
+}
+
+
+//Return MD SSA manager if MD SSA form is constructed.
+//Note the form is destroyed by Region::checkValidAndRecompute() once
+//it is invalidated, thus the stale form will not be maintained.
+MDSSAMgr * IR_DU_MGR::getMDSSAMgr() const
+{
+    if (m_ru->get_pass_mgr() == NULL) { return NULL; }
+    MDSSAMgr * mdssamgr =
+        (MDSSAMgr*)m_ru->get_pass_mgr()->queryPass(PASS_MD_SSA_MGR);
+    if (mdssamgr == NULL || !mdssamgr->is_ssa_constructed()) {
+        return NULL;
+    }
+    return mdssamgr;
+}
+
+
 //Count up the memory has been allocated.
 size_t IR_DU_MGR::count_mem()
 {
@@ -2461,6 +2524,20 @@ void IR_DU_MGR::inferCall(IR * ir, IN MD2MDSet * mx)
         computeExpression(ICALL_callee(ir), NULL, COMP_EXP_RECOMPUTE);
     }
 
+    //Mod/Ref summary of callee if IPA computed it.
+    //Callee that has summary only accesses the global MDs recorded in
+    //summary and the memory that parameters pointed to.
+    MDSet const* modsum = NULL;
+    MDSet const* refsum = NULL;
+    CallGraph * callg = m_ru->get_region_mgr()->get_call_graph();
+    if (callg != NULL && ir->is_call()) {
+        Region * callee = callg->mapCall2Region(ir, m_ru);
+        if (callee != NULL) {
+            modsum = callee->get_mod_summary();
+            refsum = callee->get_ref_summary();
+        }
+    }
+
     MDSet maydefuse;
 
     //Set MD which parameters pointed to.
@@ -2479,12 +2556,18 @@ void IR_DU_MGR::inferCall(IR * ir, IN MD2MDSet * mx)
          computeExpression(p, NULL, COMP_EXP_RECOMPUTE);
     }
 
+    if (modsum != NULL) {
+        ASSERT0(refsum);
+        maydefuse.bunion(*modsum, *m_misc_bs_mgr);
+        maydefuse.bunion(*refsum, *m_misc_bs_mgr);
+    }
+
     MDSet tmpmds;
     m_md_sys->computeOverlap(maydefuse, 
         tmpmds, m_tab_iter, *m_misc_bs_mgr, true);
     maydefuse.bunion_pure(tmpmds, *m_misc_bs_mgr);
 
-    if (!ir->is_readonly_call()) {
+    if (!ir->is_readonly_call() && modsum == NULL) {
         //For conservative purpose.
         //Set to mod/ref global memory for conservative purpose.
         maydefuse.bunion(m_md_sys->get_md(MD_GLOBAL_MEM), *m_misc_bs_mgr);
@@ -2495,43 +2578,58 @@ void IR_DU_MGR::inferCall(IR * ir, IN MD2MDSet * mx)
 }
 
 
-//Collect MD which ir may use, include overlapped MD.
-void IR_DU_MGR::collectMayUse(IR const* ir, MDSet & may_use, bool computePR)
-{
-    m_citer.clean();
-    IR const* x = NULL;
-    bool const is_stmt = ir->is_stmt();
-    if (is_stmt) {
-        x = iterRhsInitC(ir, m_citer);
-    } else {
-        x = iterExpInitC(ir, m_citer);
-    }
-
-    for (; x != NULL; x = iterRhsNextC(m_citer)) {
-        if (!x->is_memory_opnd()) { continue; }
-
+//Collect the MDs that memory operands of IR tree may use.
+class MayUseCollector : public IRVisitor<MayUseCollector> {
+    COPY_CONSTRUCTOR(MayUseCollector);
+    IR_DU_MGR * m_du;
+    MDSet & m_may_use;
+    DefMiscBitSetMgr & m_bsmgr;
+    bool m_compute_pr;
+public:
+    MayUseCollector(IR_DU_MGR * du, MDSet & may_use,
+                    DefMiscBitSetMgr & bsmgr, bool computePR) :
+        m_du(du), m_may_use(may_use), m_bsmgr(bsmgr),
+        m_compute_pr(computePR) {}
+
+    bool visitMemOpnd(IR const* x)
+    {
         ASSERT0(x->get_parent());
 
         if ((x->is_id() || x->is_ld()) && x->get_parent()->is_lda()) {
-            continue;
+            return true;
         }
 
-        if (x->is_pr() && computePR) {
-            ASSERT0(get_must_use(x));
-            may_use.bunion_pure(MD_id(get_must_use(x)), *m_misc_bs_mgr);
-            continue;
+        if (x->is_pr() && m_compute_pr) {
+            ASSERT0(m_du->get_must_use(x));
+            m_may_use.bunion_pure(MD_id(m_du->get_must_use(x)), m_bsmgr);
+            return true;
         }
 
-        MD const* mustref = get_must_use(x);
-        MDSet const* mayref = get_may_use(x);
+        MD const* mustref = m_du->get_must_use(x);
+        MDSet const* mayref = m_du->get_may_use(x);
 
         if (mustref != NULL) {
-            may_use.bunion(mustref, *m_misc_bs_mgr);
+            m_may_use.bunion(mustref, m_bsmgr);
         }
 
         if (mayref != NULL) {
-            may_use.bunion(*mayref, *m_misc_bs_mgr);
+            m_may_use.bunion(*mayref, m_bsmgr);
         }
+        return true;
+    }
+};
+
+
+//Collect MD which ir may use, include overlapped MD.
+void IR_DU_MGR::collectMayUse(IR const* ir, MDSet & may_use, bool computePR)
+{
+    bool const is_stmt = ir->is_stmt();
+    MayUseCollector c(this, may_use, *m_misc_bs_mgr, computePR);
+    if (is_stmt) {
+        c.visitRhs(ir);
+    } else {
+        ASSERT0(ir->is_exp());
+        c.visit(ir);
     }
 
     if (is_stmt) {
@@ -2933,6 +3031,9 @@ void IR_DU_MGR::computeMustExactDefMayDefMayUse(
 //MayDefined md-set for each IR.
 void IR_DU_MGR::computeMDRef()
 {
+    //Reach-definitions memoized by demand-driven DU chain depend on
+    //MD reference.
+    cleanLazyDUChain();
     m_cached_overlap_mdset.clean();
     m_is_cached_mdset.clean(*m_misc_bs_mgr);
 
@@ -3444,26 +3545,20 @@ void IR_DU_MGR::computeAuxSetForExpression(
 //This equation needs May Kill Def and Must Gen Def.
 bool IR_DU_MGR::ForAvailReachDef(
         UINT bbid,
-        List<IRBB*> & preds,
-        List<IRBB*> * lst,
+        UINT const* preds,
+        UINT pred_num,
         DefMiscBitSetMgr & bsmgr)
 {
-    UNUSED(lst);
     bool change = false;
     DefDBitSetCore news(SOL_SET_IS_SPARSE);
     DefDBitSetCore * in = getAvailInReachDef(bbid, m_misc_bs_mgr);
-    bool first = true;
-    C<IRBB*> * ct;
-    for (preds.get_head(&ct); ct != preds.end(); ct = preds.get_next(ct)) {
-        IRBB * p = ct->val();
+    for (UINT i = 0; i < pred_num; i++) {
         //Intersect
-        if (first) {
-            first = false;
-            in->copy(*getAvailOutReachDef(BB_id(p), &bsmgr), *m_misc_bs_mgr);
+        if (i == 0) {
+            in->copy(*getAvailOutReachDef(preds[i], &bsmgr), *m_misc_bs_mgr);
         } else {
-            in->intersect(*getAvailOutReachDef(BB_id(p), &bsmgr),
+            in->intersect(*getAvailOutReachDef(preds[i], &bsmgr),
                 *m_misc_bs_mgr);
-            //in->bunion(*getAvailOutReachDef(BB_id(p)), *m_misc_bs_mgr);
         }
     }
 
@@ -3471,6 +3566,7 @@ bool IR_DU_MGR::ForAvailReachDef(
     DefDBitSetCore const* killset = getMayKilledDef(bbid);
     if (killset != NULL) {
         news.diff(*killset, bsmgr);
+        m_solve_set_op++;
     }
     news.bunion(*getMustGenDef(bbid, &bsmgr), bsmgr);
 
@@ -3478,50 +3574,34 @@ bool IR_DU_MGR::ForAvailReachDef(
     if (!out->is_equal(news)) {
         out->copy(news, bsmgr);
         change = true;
-
-        #ifdef WORK_LIST_DRIVE
-        ASSERT0(lst);
-        Vertex * bbv = m_cfg->get_vertex(bbid);
-        EdgeC const* ecs = VERTEX_out_list(bbv);
-        while (ecs != NULL) {
-            INT succ = VERTEX_id(EDGE_to(EC_edge(ecs)));
-            ASSERT0(succ >= 0 && m_cfg->get_bb(succ));
-            lst->append_tail(m_cfg->get_bb(succ));
-            ecs = EC_next(ecs);
-        }
-        #endif
+        m_solve_set_op++;
     }
     news.clean(bsmgr);
+    m_solve_set_op += pred_num + 3;
     return change;
 }
 
 
 bool IR_DU_MGR::ForReachDef(
         UINT bbid,
-        List<IRBB*> & preds,
-        List<IRBB*> * lst,
+        UINT const* preds,
+        UINT pred_num,
         DefMiscBitSetMgr & bsmgr)
 {
-    UNUSED(lst);
     bool change = false;
     DefDBitSetCore * in_reach_def = getInReachDef(bbid, m_misc_bs_mgr);
     DefDBitSetCore news(SOL_SET_IS_SPARSE);
-
-    bool first = true;
-    C<IRBB*> * ct;
-    for (preds.get_head(&ct); ct != preds.end(); ct = preds.get_next(ct)) {
-        IRBB const* p = ct->val();
-        if (first) {
-            in_reach_def->copy(*getOutReachDef(BB_id(p), &bsmgr),
+    for (UINT i = 0; i < pred_num; i++) {
+        if (i == 0) {
+            in_reach_def->copy(*getOutReachDef(preds[i], &bsmgr),
                 *m_misc_bs_mgr);
-            first = false;
         } else {
-            in_reach_def->bunion(*getOutReachDef(BB_id(p), &bsmgr),
+            in_reach_def->bunion(*getOutReachDef(preds[i], &bsmgr),
                 *m_misc_bs_mgr);
         }
     }
 
-    if (first) {
+    if (pred_num == 0) {
         //bb does not have predecessor.
         ASSERT0(in_reach_def->is_empty());
     }
@@ -3530,6 +3610,7 @@ bool IR_DU_MGR::ForReachDef(
     DefDBitSetCore const* killset = getMustKilledDef(bbid);
     if (killset != NULL) {
         news.diff(*killset, bsmgr);
+        m_solve_set_op++;
     }
     news.bunion(*getMayGenDef(bbid, &bsmgr), bsmgr);
 
@@ -3537,43 +3618,27 @@ bool IR_DU_MGR::ForReachDef(
     if (!out_reach_def->is_equal(news)) {
         out_reach_def->copy(news, bsmgr);
         change = true;
-
-        #ifdef WORK_LIST_DRIVE
-        ASSERT0(lst);
-        Vertex * bbv = m_cfg->get_vertex(bbid);
-        EdgeC const* ecs = VERTEX_out_list(bbv);
-        while (ecs != NULL) {
-            INT succ = VERTEX_id(EDGE_to(EC_edge(ecs)));
-            ASSERT0(succ >= 0 && m_cfg->get_bb(succ));
-            lst->append_tail(m_cfg->get_bb(succ));
-            ecs = EC_next(ecs);
-        }
-        #endif
+        m_solve_set_op++;
     }
 
     news.clean(bsmgr);
+    m_solve_set_op += pred_num + 3;
     return change;
 }
 
 
 bool IR_DU_MGR::ForAvailExpression(
             UINT bbid,
-            List<IRBB*> & preds,
-            List<IRBB*> * lst,
+            UINT const* preds,
+            UINT pred_num,
             DefMiscBitSetMgr & bsmgr)
 {
-    UNUSED(lst);
     bool change = false;
     DefDBitSetCore news(SOL_SET_IS_SPARSE);
-
-    bool first = true;
     DefDBitSetCore * in = getAvailInExpr(bbid, m_misc_bs_mgr);
-    C<IRBB*> * ct;
-    for (preds.get_head(&ct); ct != preds.end(); ct = preds.get_next(ct)) {
-        IRBB * p = ct->val();
-        DefDBitSetCore * liveout = getAvailOutExpr(BB_id(p), &bsmgr);
-        if (first) {
-            first = false;
+    for (UINT i = 0; i < pred_num; i++) {
+        DefDBitSetCore * liveout = getAvailOutExpr(preds[i], &bsmgr);
+        if (i == 0) {
             in->copy(*liveout, *m_misc_bs_mgr);
         } else {
             in->intersect(*liveout, *m_misc_bs_mgr);
@@ -3584,30 +3649,127 @@ bool IR_DU_MGR::ForAvailExpression(
     DefDBitSetCore const* set = getKilledIRExpr(bbid);
     if (set != NULL) {
         news.diff(*set, bsmgr);
+        m_solve_set_op++;
     }
     news.bunion(*getGenIRExpr(bbid, &bsmgr), bsmgr);
     DefDBitSetCore * out = getAvailOutExpr(bbid, &bsmgr);
     if (!out->is_equal(news)) {
         out->copy(news, bsmgr);
         change = true;
-
-        #ifdef WORK_LIST_DRIVE
-        ASSERT0(lst);
-        Vertex * bbv = m_cfg->get_vertex(bbid);
-        EdgeC const* ecs = VERTEX_out_list(bbv);
-        while (ecs != NULL) {
-            INT succ = VERTEX_id(EDGE_to(EC_edge(ecs)));
-            ASSERT0(succ >= 0 && m_cfg->get_bb(succ));
-            lst->append_tail(m_cfg->get_bb(succ));
-            ecs = EC_next(ecs);
-        }
-        #endif
+        m_solve_set_op++;
     }
     news.clean(bsmgr);
+    m_solve_set_op += pred_num + 3;
     return change;
 }
 
 
+//
+//START DUSolveCFG
+//
+//Record BB in RPO, and cache the predecessors and successors of each BB.
+void DUSolveCFG::build(IR_CFG * cfg)
+{
+    List<IRBB*> * rpobbl = cfg->get_bblist_in_rpo();
+    UINT const bbnum = rpobbl->get_elem_count();
+
+    //Map from BB id to RPO position.
+    Vector<UINT> bb2pos(bbnum);
+    UINT pos = 0;
+    C<IRBB*> * ct;
+    for (rpobbl->get_head(&ct); ct != rpobbl->end();
+         ct = rpobbl->get_next(ct), pos++) {
+        UINT id = BB_id(ct->val());
+        bbid.set(pos, id);
+        bb2pos.set(id, pos);
+    }
+
+    UINT npred = 0;
+    UINT nsucc = 0;
+    for (pos = 0; pos < bbnum; pos++) {
+        Vertex const* v = cfg->get_vertex(bbid.get(pos));
+        ASSERT0(v);
+        pred_start.set(pos, npred);
+        for (EdgeC const* el = VERTEX_in_list(v);
+             el != NULL; el = EC_next(el)) {
+            UINT p = VERTEX_id(EDGE_from(EC_edge(el)));
+            ASSERT0(cfg->get_bb(p));
+            pred.set(npred++, p);
+        }
+
+        succ_start.set(pos, nsucc);
+        for (EdgeC const* el = VERTEX_out_list(v);
+             el != NULL; el = EC_next(el)) {
+            UINT s = VERTEX_id(EDGE_to(EC_edge(el)));
+            ASSERT0(cfg->get_bb(s));
+            succ.set(nsucc++, bb2pos.get(s));
+        }
+    }
+    pred_start.set(bbnum, npred);
+    succ_start.set(bbnum, nsucc);
+}
+//END DUSolveCFG
+
+
+//Solve the dataflow equation 'sol' by worklist.
+//The worklist is a priority queue ordered by RPO position, a BB is
+//queued at most once at any time, and only the successors of BB whose
+//OUT set changed will be evaluated again.
+void IR_DU_MGR::solveByWorkList(
+        UINT const sol,
+        DUSolveCFG & scfg,
+        DefMiscBitSetMgr & bsmgr)
+{
+    UINT const bbnum = scfg.get_bb_num();
+    if (bbnum == 0) { return; }
+
+    //Record the RPO positions of BB that to be evaluated.
+    BitSet queued(bbnum / BITS_PER_BYTE + 1);
+    for (UINT i = 0; i < bbnum; i++) {
+        queued.bunion(i);
+    }
+
+    //All positions lower than 'lowest' are not in worklist.
+    UINT lowest = 0;
+    UINT count = 0;
+    for (;;) {
+        INT p = lowest == 0 ? queued.get_first() :
+                              queued.get_next(lowest - 1);
+        if (p < 0) { break; }
+        UINT pos = (UINT)p;
+        queued.diff(pos);
+        lowest = pos;
+
+        UINT bbid = scfg.bbid.get(pos);
+        UINT const* preds = scfg.get_preds(pos);
+        UINT pred_num = scfg.get_pred_num(pos);
+        bool change = false;
+        switch (sol) {
+        case SOL_AVAIL_REACH_DEF:
+            change = ForAvailReachDef(bbid, preds, pred_num, bsmgr);
+            break;
+        case SOL_REACH_DEF:
+            change = ForReachDef(bbid, preds, pred_num, bsmgr);
+            break;
+        case SOL_AVAIL_EXPR:
+            change = ForAvailExpression(bbid, preds, pred_num, bsmgr);
+            break;
+        default: UNREACH();
+        }
+        count++;
+
+        if (!change) { continue; }
+        for (UINT i = scfg.succ_start.get(pos);
+             i < scfg.succ_start.get(pos + 1); i++) {
+            UINT s = scfg.succ.get(i);
+            queued.bunion(s);
+            lowest = MIN(lowest, s);
+        }
+    }
+    m_solve_bb_visit += count;
+}
+
+
 //Solve reaching definitions problem for IR STMT and
 //computing LIVE IN and LIVE OUT IR expressions.
 //'expr_univers': the Universal SET for ExpRep.
@@ -3647,63 +3809,29 @@ void IR_DU_MGR::solve(
     }
 
     //Rpo already checked to be available. Here double check again.
-    List<IRBB*> * tbbl = m_cfg->get_bblist_in_rpo();
-    ASSERT0(tbbl->get_elem_count() == bbl->get_elem_count());
-    List<IRBB*> preds;
-    List<IRBB*> lst;
-#ifdef WORK_LIST_DRIVE
-    C<IRBB*> * ct;
-    for (tbbl->get_head(&ct); ct != tbbl->end(); ct = tbbl->get_next(ct)) {
-        IRBB * p = ct->val();
-        lst.append_tail(p);
+    ASSERT0(m_cfg->get_bblist_in_rpo()->get_elem_count() ==
+            bbl->get_elem_count());
+
+    m_solve_bb_visit = 0;
+    m_solve_set_op = 0;
+    DUSolveCFG scfg;
+    scfg.build(m_cfg);
+
+    //The equations are independent, solve them one by one.
+    if (HAVE_FLAG(flag, SOL_AVAIL_REACH_DEF)) {
+        solveByWorkList(SOL_AVAIL_REACH_DEF, scfg, bsmgr);
+    }
+    if (HAVE_FLAG(flag, SOL_REACH_DEF)) {
+        solveByWorkList(SOL_REACH_DEF, scfg, bsmgr);
+    }
+    if (HAVE_FLAG(flag, SOL_AVAIL_EXPR)) {
+        solveByWorkList(SOL_AVAIL_EXPR, scfg, bsmgr);
     }
 
-    UINT count = tbbl->get_elem_count() * 20;
-    UINT i = 0; //time of bb accessed.
-    do {
-        IRBB * bb = lst.remove_head();
-        UINT bbid = BB_id(bb);
-        preds.clean();
-        m_cfg->get_preds(preds, bb);
-        if (HAVE_FLAG(flag, SOL_AVAIL_REACH_DEF)) {
-            ForAvailReachDef(bbid, preds, &lst, bsmgr);
-        }
-        if (HAVE_FLAG(flag, SOL_REACH_DEF)) {
-            ForReachDef(bbid, preds, &lst, bsmgr);
-        }
-        if (HAVE_FLAG(flag, SOL_AVAIL_EXPR)) {
-            ForAvailExpression(bbid, preds, &lst, bsmgr);
-        }
-        i++;
-    } while (lst.get_elem_count() != 0);
-    ASSERT0(i < count);
-    UNUSED(count);
-#else
-    bool change;
-    UINT count = 0;
-    do {
-        change = false;
-        C<IRBB*> * ct;
-        for (tbbl->get_head(&ct); ct != tbbl->end(); ct = tbbl->get_next(ct)) {
-            IRBB * bb = ct->val();
-            UINT bbid = BB_id(bb);
-            preds.clean();
-            m_cfg->get_preds(preds, bb);
-            if (HAVE_FLAG(flag, SOL_AVAIL_REACH_DEF)) {
-                change |= ForAvailReachDef(bbid, preds, NULL, bsmgr);
-            }
-            if (HAVE_FLAG(flag, SOL_REACH_DEF)) {
-                change |= ForReachDef(bbid, preds, NULL, bsmgr);
-            }
-            if (HAVE_FLAG(flag, SOL_AVAIL_EXPR)) {
-                change |= ForAvailExpression(bbid, preds, NULL, bsmgr);
-            }
-        }
-        count++;
-    } while (change && count < 20);
-    //UINT i = count * tbbl->get_elem_count(); //time of bb accessed.
-    ASSERT0(!change);
-#endif
+    if (g_show_comp_time) {
+        prt2C("\n==-- DU Solver: %u BBs, %u BB evaluated, %u set operations",
+              bbl->get_elem_count(), m_solve_bb_visit, m_solve_set_op);
+    }
 }
 
 
@@ -4124,105 +4252,101 @@ UINT IR_DU_MGR::checkIsNonLocalKillingDef(IR const* stmt, IR const* exp)
 }
 
 
-void IR_DU_MGR::checkDefSetToBuildDUChain(
+//Return true if 'def' may define the value that 'exp' read.
+//'def' is the stmt that recorded in reach-def of MD of 'exp'.
+//'curbb': the BB of 'exp'.
+bool IR_DU_MGR::isReachDefOfExp(
+        IR const* def,
         IR const* exp,
         MD const* expmd,
         MDSet const* expmds,
-        DUSet * expdu,
-        DefSBitSetCore const* defset,
         IRBB * curbb)
 {
-    SEGIter * sc = NULL;
+    ASSERT0(def->is_stmt());
     if (exp->is_read_pr()) {
         //Check DU for PR.
         ASSERT0(expmd);
-        UINT const expid = IR_id(exp);
-        for (INT d = defset->get_first(&sc);
-             d >= 0; d = defset->get_next(d, &sc)) {
-            IR * def = m_ru->get_ir(d);
-            ASSERT0(def->is_stmt());
-
-            MD const* mustdef = get_must_def(def);
-            if (expmd != mustdef) { continue; }
-
-            //Build DU chain.
-            expdu->add(d, *m_misc_bs_mgr);
-            DUSet * def_useset = getAndAllocDUSet(def);
-            if (!m_is_init->is_contain(d)) {
-                m_is_init->bunion(d);
-                def_useset->clean(*m_misc_bs_mgr);
-            }
-            def_useset->add(expid, *m_misc_bs_mgr);
-        }
-        return;
+        return get_must_def(def) == expmd;
     }
 
     //Check DU for other kind memory reference.
-    for (INT d = defset->get_first(&sc);
-         d >= 0; d = defset->get_next(d, &sc)) {
-        IR * def = m_ru->get_ir(d);
-        ASSERT0(def->is_stmt());
-
-        bool build_du = false;
-        MD const* mustdef = get_must_def(def);
-        bool consider_maydef = false;
-        if (expmd != NULL && mustdef != NULL) {
-            //If def has MustDef (exact|effect) MD, then we do
-            //not consider MayDef MDSet if the def is neither CALL|ICALL
-            //nor REGION.
-            ASSERT(!MD_is_may(mustdef), ("MayMD can not be mustdef."));
-            if (expmd == mustdef || expmd->is_overlap(mustdef)) {
-                if (mustdef->is_exact()) {
-                    build_du = true;
-                } else if (def->get_bb() == curbb) {
-                    //If stmt is at same bb with exp, then
-                    //we can not determine whether they are independent,
-                    //because if they are, the situation should be processed
-                    //in buildLocalDUChain().
-                    //Build du chain for conservative purpose.
+    bool build_du = false;
+    MD const* mustdef = get_must_def(def);
+    bool consider_maydef = false;
+    if (expmd != NULL && mustdef != NULL) {
+        //If def has MustDef (exact|effect) MD, then we do
+        //not consider MayDef MDSet if the def is neither CALL|ICALL
+        //nor REGION.
+        ASSERT(!MD_is_may(mustdef), ("MayMD can not be mustdef."));
+        if (expmd == mustdef || expmd->is_overlap(mustdef)) {
+            if (mustdef->is_exact()) {
+                build_du = true;
+            } else if (def->get_bb() == curbb) {
+                //If stmt is at same bb with exp, then
+                //we can not determine whether they are independent,
+                //because if they are, the situation should be processed
+                //in buildLocalDUChain().
+                //Build du chain for conservative purpose.
+                //Nonkilling Def.
+                build_du = true;
+            } else {
+                UINT result = checkIsNonLocalKillingDef(def, exp);
+                if (result == CK_OVERLAP || result == CK_UNKNOWN) {
                     //Nonkilling Def.
                     build_du = true;
-                } else {
-                    UINT result = checkIsNonLocalKillingDef(def, exp);
-                    if (result == CK_OVERLAP || result == CK_UNKNOWN) {
-                        //Nonkilling Def.
-                        build_du = true;
-                    }
                 }
-            } else if (def->is_calls_stmt() || def->is_region()) {
-                //If def is CALL, ICALL, REGION which has sideeffect,
-                //then we should consider MayDef MDSet as well.
-                consider_maydef = true;
             }
-        } else {
+        } else if (def->is_calls_stmt() || def->is_region()) {
+            //If def is CALL, ICALL, REGION which has sideeffect,
+            //then we should consider MayDef MDSet as well.
             consider_maydef = true;
         }
+    } else {
+        consider_maydef = true;
+    }
 
-        if (consider_maydef) {
-            MDSet const* maydef = get_may_def(def);
-            if (maydef != NULL &&
-                ((maydef == expmds ||
-                  (expmds != NULL && maydef->is_intersect(*expmds))) ||
-                 (expmd != NULL && maydef->is_overlap(expmd)))) {
-                //Nonkilling Def.
-                build_du = true;
-            } else if (mustdef != NULL &&
-                       expmds != NULL &&
-                       expmds->is_overlap(mustdef)) {
-                //Killing Def if mustdef is exact, or else is nonkilling def.
-                build_du = true;
-            }
+    if (consider_maydef) {
+        MDSet const* maydef = get_may_def(def);
+        if (maydef != NULL &&
+            ((maydef == expmds ||
+              (expmds != NULL && maydef->is_intersect(*expmds))) ||
+             (expmd != NULL && maydef->is_overlap(expmd)))) {
+            //Nonkilling Def.
+            build_du = true;
+        } else if (mustdef != NULL &&
+                   expmds != NULL &&
+                   expmds->is_overlap(mustdef)) {
+            //Killing Def if mustdef is exact, or else is nonkilling def.
+            build_du = true;
         }
+    }
+    return build_du;
+}
 
-        if (build_du) {
-            expdu->add(d, *m_misc_bs_mgr);
-            DUSet * def_useset = getAndAllocDUSet(def);
-            if (!m_is_init->is_contain(d)) {
-                m_is_init->bunion(d);
-                def_useset->clean(*m_misc_bs_mgr);
-            }
-            def_useset->add(IR_id(exp), *m_misc_bs_mgr);
+
+void IR_DU_MGR::checkDefSetToBuildDUChain(
+        IR const* exp,
+        MD const* expmd,
+        MDSet const* expmds,
+        DUSet * expdu,
+        DefSBitSetCore const* defset,
+        IRBB * curbb)
+{
+    SEGIter * sc = NULL;
+    UINT const expid = IR_id(exp);
+    for (INT d = defset->get_first(&sc);
+         d >= 0; d = defset->get_next(d, &sc)) {
+        IR * def = m_ru->get_ir(d);
+        if (!isReachDefOfExp(def, exp, expmd, expmds, curbb)) { continue; }
+
+        //Build DU chain.
+        expdu->add(d, *m_misc_bs_mgr);
+        DUSet * def_useset = getAndAllocDUSet(def);
+        if (!m_is_init->is_contain(d)) {
+            m_is_init->bunion(d);
+            def_useset->clean(*m_misc_bs_mgr);
         }
+        def_useset->add(expid, *m_misc_bs_mgr);
     }
 }
 
@@ -5108,19 +5232,14 @@ void IR_DU_MGR::computeMDDUChain(IN OUT OptCtx & oc, bool retain_reach_def)
 
     START_TIMER("Build DU-CHAIN");
 
-    //If PRs have already been in SSA form, then computing DU chain for them
-    //doesn't make any sense.
-    if (m_ru->get_pass_mgr() != NULL) {
-        IR_SSA_MGR * ssamgr =
-            (IR_SSA_MGR*)m_ru->get_pass_mgr()->queryPass(PASS_SSA_MGR);
-        if (ssamgr != NULL) {
-            setComputePRDU(!ssamgr->is_ssa_constructed());
-        } else {
-            setComputePRDU(true);
-        }
-    } else {
-        setComputePRDU(true);
-    }
+    //DU chain will be entirely recomputed.
+    cleanLazyDUChain();
+    m_dirty_stmt.clean();
+    m_dirty_def.clean();
+    m_dirty_exp.clean();
+    OC_is_du_chain_dirty(oc) = false;
+
+    setComputePRDUBySSA();
 
     ASSERT0(OC_is_ref_valid(oc) && OC_is_reach_def_valid(oc));
 
@@ -5142,6 +5261,13 @@ void IR_DU_MGR::computeMDDUChain(IN OUT OptCtx & oc, bool retain_reach_def)
     m_is_init = new BitSet(MAX(1, (m_ru->get_ir_vec()->
                            get_last_idx()/BITS_PER_BYTE)));
 
+    #ifdef _DEBUG_
+    if (g_sbs_trace_file != NULL) {
+        ASSERT0(g_sbs_trace == NULL);
+        g_sbs_trace = fopen(g_sbs_trace_file, "a+");
+    }
+    #endif
+
     //Compute the DU chain linearly.
     C<IRBB*> * ct;
     MDIter mditer;
@@ -5151,6 +5277,13 @@ void IR_DU_MGR::computeMDDUChain(IN OUT OptCtx & oc, bool retain_reach_def)
         computeMDDUforBB(bb);
     }
 
+    #ifdef _DEBUG_
+    if (g_sbs_trace != NULL) {
+        fclose(g_sbs_trace);
+        g_sbs_trace = NULL;
+    }
+    #endif
+
     delete m_md2irs;
     m_md2irs = NULL;
 
@@ -5170,8 +5303,588 @@ void IR_DU_MGR::computeMDDUChain(IN OUT OptCtx & oc, bool retain_reach_def)
     //dumpDUChainDetail();
     //dumpDUChain();
     ASSERT0(verifyMDDUChain());
+    if (g_verify_level >= VERIFY_LEVEL_3) {
+        ASSERT0(verifyLazyDUChain());
+    }
     END_TIMER();
 }
+
+
+//Free the memoized reach-definitions, and the DUSets that have been
+//computed on demand will be recomputed at next query.
+void IR_DU_MGR::cleanLazyDUChain()
+{
+    for (INT i = 0; i <= m_lazy_reach_out.get_last_idx(); i++) {
+        Vector<DefSBitSetCore*> * bb2out = m_lazy_reach_out.get(i);
+        if (bb2out == NULL) { continue; }
+        for (INT j = 0; j <= bb2out->get_last_idx(); j++) {
+            m_misc_bs_mgr->freeSBitSetCore(bb2out->get(j));
+        }
+        delete bb2out;
+    }
+    m_lazy_reach_out.clean();
+
+    for (INT i = 0; i <= m_lazy_exact_def.get_last_idx(); i++) {
+        m_misc_bs_mgr->freeSBitSetCore(m_lazy_exact_def.get(i));
+    }
+    m_lazy_exact_def.clean();
+    m_lazy_is_init.clean();
+}
+
+
+//Return true if 'stmt' is recorded as the DEF of 'mdid', the same as
+//the MDId2IRlist built by computeMDDUforBB().
+bool IR_DU_MGR::isLazyDefOf(IR const* stmt, UINT mdid)
+{
+    switch (stmt->get_code()) {
+    case IR_REGION:
+        {
+            MDSet const* maydef = REGION_ru(stmt)->get_may_def();
+            return maydef != NULL && maydef->is_contain_pure(mdid);
+        }
+    case IR_STPR:
+    case IR_PHI:
+        if (!isComputePRDU()) { return false; }
+        break;
+    default: if (!stmt->has_result()) { return false; }
+    }
+
+    if (!isComputePRDU() && stmt->is_calls_stmt()) {
+        //Return value of call is in SSA form, only consider MayDef.
+        MDSet const* maydef = get_may_def(stmt);
+        return maydef != NULL && maydef->is_contain_pure(mdid);
+    }
+
+    MD const* mustdef = get_must_def(stmt);
+    if (mustdef != NULL && MD_id(mustdef) == mdid) { return true; }
+
+    MDSet const* maydef = get_may_def(stmt);
+    return maydef != NULL && maydef->is_contain_pure(mdid);
+}
+
+
+//Return the exact MDs defined in 'bb'. A reach-def which exactly
+//defined one of them is killed by 'bb'.
+DefSBitSetCore const* IR_DU_MGR::getLazyExactDef(IRBB * bb)
+{
+    DefSBitSetCore * set = m_lazy_exact_def.get(BB_id(bb));
+    if (set != NULL) { return set; }
+
+    set = m_misc_bs_mgr->allocSBitSetCore();
+    m_lazy_exact_def.set(BB_id(bb), set);
+    for (IR const* ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+        if (!ir->has_result()) { continue; }
+        if ((ir->is_stpr() || ir->is_phi()) && !isComputePRDU()) {
+            continue;
+        }
+        MD const* x = ir->get_exact_ref();
+        if (x != NULL) {
+            set->bunion(MD_id(x), *m_misc_bs_mgr);
+        }
+    }
+    return set;
+}
+
+
+//Update reach-def of 'mdid' after 'stmt' executed.
+//The defs killed by 'stmt' are removed, the same as the may-gen-def
+//computed by computeMayDef().
+void IR_DU_MGR::genLazyReachDef(
+        IR const* stmt,
+        UINT mdid,
+        IN OUT DefSBitSetCore & reach)
+{
+    if (stmt->get_exact_ref() != NULL || stmt->is_stpr()) {
+        SEGIter * st = NULL;
+        INT ni;
+        for (INT i = reach.get_first(&st); i >= 0; i = ni) {
+            ni = reach.get_next(i, &st);
+            if (is_must_kill(stmt, m_ru->get_ir(i))) {
+                reach.diff(i, *m_misc_bs_mgr);
+            }
+        }
+    }
+
+    if (isLazyDefOf(stmt, mdid)) {
+        reach.bunion(IR_id(stmt), *m_misc_bs_mgr);
+    }
+}
+
+
+//Compute reach-def-out of 'mdid' for 'bb' and the BBs that reach 'bb'.
+//The BBs whose reach-def-out has been computed are regarded as
+//boundary, the others are solved iteratively:
+//    out(bb) = gen(bb) + (in(bb) - kill(bb))
+void IR_DU_MGR::computeLazyReachOut(IRBB * bb, UINT mdid)
+{
+    Vector<DefSBitSetCore*> * bb2out = m_lazy_reach_out.get(mdid);
+    if (bb2out == NULL) {
+        bb2out = new Vector<DefSBitSetCore*>();
+        m_lazy_reach_out.set(mdid, bb2out);
+    }
+    if (bb2out->get(BB_id(bb)) != NULL) { return; }
+
+    //Collect BBs which have not been solved.
+    List<IRBB*> bbs;
+    List<IRBB*> wl;
+    List<IRBB*> preds;
+    wl.append_tail(bb);
+    bb2out->set(BB_id(bb), m_misc_bs_mgr->allocSBitSetCore());
+    while (wl.get_elem_count() != 0) {
+        IRBB * t = wl.remove_head();
+        bbs.append_head(t);
+        preds.clean();
+        m_cfg->get_preds(preds, t);
+        for (IRBB * p = preds.get_head(); p != NULL; p = preds.get_next()) {
+            if (bb2out->get(BB_id(p)) != NULL) { continue; }
+            bb2out->set(BB_id(p), m_misc_bs_mgr->allocSBitSetCore());
+            wl.append_tail(p);
+        }
+    }
+
+    //Compute gen-set of each BB.
+    Vector<DefSBitSetCore*> bb2gen;
+    for (IRBB * t = bbs.get_head(); t != NULL; t = bbs.get_next()) {
+        DefSBitSetCore * gen = m_misc_bs_mgr->allocSBitSetCore();
+        bb2gen.set(BB_id(t), gen);
+        for (IR const* ir = BB_first_ir(t); ir != NULL; ir = BB_next_ir(t)) {
+            genLazyReachDef(ir, mdid, *gen);
+        }
+    }
+
+    DefSBitSetCore news;
+    bool change = true;
+    while (change) {
+        change = false;
+        for (IRBB * t = bbs.get_head(); t != NULL; t = bbs.get_next()) {
+            news.clean(*m_misc_bs_mgr);
+            preds.clean();
+            m_cfg->get_preds(preds, t);
+            for (IRBB * p = preds.get_head();
+                 p != NULL; p = preds.get_next()) {
+                DefSBitSetCore const* pout = bb2out->get(BB_id(p));
+                ASSERT0(pout);
+                news.bunion(*pout, *m_misc_bs_mgr);
+            }
+
+            DefSBitSetCore const* kill = getLazyExactDef(t);
+            SEGIter * st = NULL;
+            INT ni;
+            for (INT i = news.get_first(&st); i >= 0; i = ni) {
+                ni = news.get_next(i, &st);
+                MD const* x = m_ru->get_ir(i)->get_exact_ref();
+                if (x != NULL && kill->is_contain(MD_id(x))) {
+                    news.diff(i, *m_misc_bs_mgr);
+                }
+            }
+            news.bunion(*bb2gen.get(BB_id(t)), *m_misc_bs_mgr);
+
+            DefSBitSetCore * out = bb2out->get(BB_id(t));
+            if (!out->is_equal(news)) {
+                out->copy(news, *m_misc_bs_mgr);
+                change = true;
+            }
+        }
+    }
+    news.clean(*m_misc_bs_mgr);
+
+    for (INT i = 0; i <= bb2gen.get_last_idx(); i++) {
+        m_misc_bs_mgr->freeSBitSetCore(bb2gen.get(i));
+    }
+}
+
+
+//Compute the defs of 'mdid' that reach the stmt indicated by 'ct'.
+void IR_DU_MGR::computeLazyReachDef(
+        IRBB * bb,
+        C<IR*> * ct,
+        UINT mdid,
+        OUT DefSBitSetCore & reach)
+{
+    reach.clean(*m_misc_bs_mgr);
+    List<IRBB*> preds;
+    m_cfg->get_preds(preds, bb);
+    for (IRBB * p = preds.get_head(); p != NULL; p = preds.get_next()) {
+        computeLazyReachOut(p, mdid);
+        reach.bunion(*m_lazy_reach_out.get(mdid)->get(BB_id(p)),
+                     *m_misc_bs_mgr);
+    }
+
+    C<IR*> * irct;
+    for (BB_irlist(bb).get_head(&irct);
+         irct != ct; irct = BB_irlist(bb).get_next(irct)) {
+        ASSERT0(irct != BB_irlist(bb).end());
+        genLazyReachDef(irct->val(), mdid, reach);
+    }
+}
+
+
+//Collect the DEF stmts of 'exp' by demand-driven reach-definition.
+//The result is the same as computeMDDUChain(), or a conservative
+//superset of it.
+void IR_DU_MGR::collectLazyDefSet(IR const* exp, OUT DefSBitSetCore & defs)
+{
+    ASSERT0(exp->is_memory_opnd());
+    IR * stmt = exp->get_stmt();
+    ASSERT0(stmt && stmt->get_bb());
+    IRBB * bb = stmt->get_bb();
+    C<IR*> * ct = NULL;
+    BB_irlist(bb).find(stmt, &ct);
+    ASSERT0(ct);
+
+    MD const* expmd = get_must_use(exp);
+    if ((expmd != NULL && expmd->is_exact()) || exp->is_read_pr()) {
+        IR const* nearest_def = findKillingLocalDef(bb, ct, exp, expmd);
+        if (nearest_def != NULL) {
+            defs.bunion(IR_id(nearest_def), *m_misc_bs_mgr);
+            return;
+        }
+    }
+
+    DefSBitSetCore reach;
+    SEGIter * st = NULL;
+    if (expmd != NULL) {
+        computeLazyReachDef(bb, ct, MD_id(expmd), reach);
+        for (INT d = reach.get_first(&st); d >= 0; d = reach.get_next(d, &st)) {
+            if (isReachDefOfExp(m_ru->get_ir(d), exp, expmd, NULL, bb)) {
+                defs.bunion(d, *m_misc_bs_mgr);
+            }
+        }
+    }
+
+    MDSet const* expmds = get_may_use(exp);
+    if (expmds != NULL) {
+        SEGIter * iter;
+        for (INT u = expmds->get_first(&iter);
+             u >= 0; u = expmds->get_next(u, &iter)) {
+            computeLazyReachDef(bb, ct, (UINT)u, reach);
+            for (INT d = reach.get_first(&st);
+                 d >= 0; d = reach.get_next(d, &st)) {
+                if (defs.is_contain(d)) { continue; }
+                if (isReachDefOfExp(m_ru->get_ir(d), exp, expmd, expmds, bb)) {
+                    defs.bunion(d, *m_misc_bs_mgr);
+                }
+            }
+        }
+    }
+    reach.clean(*m_misc_bs_mgr);
+}
+
+
+DUSet const* IR_DU_MGR::getDUSetOnDemand(IR * exp, OptCtx & oc)
+{
+    ASSERT0(exp && exp->is_memory_opnd());
+    if (OC_is_du_chain_valid(oc) || m_lazy_is_init.is_contain(IR_id(exp))) {
+        return exp->readDUSet();
+    }
+
+    ASSERT0(OC_is_ref_valid(oc) && OC_is_cfg_valid(oc));
+    setComputePRDUBySSA();
+
+    if (exp->is_read_pr() && !isComputePRDU()) {
+        //PR is in SSA form.
+        return NULL;
+    }
+
+    m_oc = &oc;
+    DefSBitSetCore defs;
+    collectLazyDefSet(exp, defs);
+
+    //Build DU chain.
+    DUSet * expdu = getAndAllocDUSet(exp);
+    expdu->clean(*m_misc_bs_mgr);
+    m_lazy_is_init.bunion(IR_id(exp));
+    SEGIter * st = NULL;
+    for (INT d = defs.get_first(&st); d >= 0; d = defs.get_next(d, &st)) {
+        expdu->add(d, *m_misc_bs_mgr);
+        DUSet * def_useset = getAndAllocDUSet(m_ru->get_ir(d));
+        if (!m_lazy_is_init.is_contain(d)) {
+            m_lazy_is_init.bunion(d);
+            def_useset->clean(*m_misc_bs_mgr);
+        }
+        def_useset->add(IR_id(exp), *m_misc_bs_mgr);
+    }
+    defs.clean(*m_misc_bs_mgr);
+    return expdu;
+}
+
+
+//Verify demand-driven DU chain by comparing with the DU chain that
+//computed by computeMDDUChain(). Each DEF of eager DU chain must be
+//found on demand as well.
+bool IR_DU_MGR::verifyLazyDUChain()
+{
+    ASSERT0(m_oc && OC_is_du_chain_valid(*m_oc));
+    cleanLazyDUChain();
+    UINT extra = 0;
+    DefSBitSetCore defs;
+    BBList * bbl = m_ru->get_bb_list();
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            if (ir->is_region() || (ir->is_phi() && !isComputePRDU())) {
+                continue;
+            }
+
+            m_citer.clean();
+            for (IR const* x = iterRhsInitC(ir, m_citer);
+                 x != NULL; x = iterRhsNextC(m_citer)) {
+                if (!x->is_ld() && !x->is_ild() && !x->is_array() &&
+                    !(x->is_pr() && isComputePRDU())) {
+                    continue;
+                }
+
+                defs.clean(*m_misc_bs_mgr);
+                collectLazyDefSet(x, defs);
+
+                DUSet const* defset = x->readDUSet();
+                UINT num = 0;
+                if (defset != NULL) {
+                    DUIter di = NULL;
+                    for (INT d = defset->get_first(&di);
+                         d >= 0; d = defset->get_next(d, &di), num++) {
+                        ASSERT(defs.is_contain(d),
+                               ("IR%d miss DEF IR%d on demand", IR_id(x), d));
+                    }
+                }
+                extra += defs.get_elem_count() - num;
+            }
+        }
+    }
+    defs.clean(*m_misc_bs_mgr);
+    cleanLazyDUChain();
+
+    if (g_tfile != NULL && extra != 0) {
+        fprintf(g_tfile, "\n==---- DUMP LAZY DU CHAIN VERIFY '%s' ----==",
+                m_ru->get_ru_name());
+        fprintf(g_tfile, "\n%u conservative DEFs found on demand", extra);
+        fflush(g_tfile);
+    }
+    return true;
+}
+
+
+//Return true if stmt 'ir' is still placed in BB.
+//The recorded IR may have been removed or freed after it was recorded.
+bool IR_DU_MGR::is_stmt_in_bb(IR * ir) const
+{
+    if (ir == NULL || ir->get_code() == IR_UNDEF || !ir->is_stmt()) {
+        return false;
+    }
+    IRBB * bb = ir->get_bb();
+    if (bb == NULL) { return false; }
+    C<IR*> * ct = NULL;
+    BB_irlist(bb).find(ir, &ct);
+    return ct != NULL;
+}
+
+
+void IR_DU_MGR::markDirtyStmt(IR * stmt, bool is_inserted)
+{
+    ASSERT0(stmt && stmt->is_stmt());
+    m_dirty_stmt.bunion(IR_id(stmt));
+    if (is_inserted) {
+        m_dirty_def.bunion(IR_id(stmt));
+    }
+}
+
+
+void IR_DU_MGR::markRemovedStmt(IR * stmt)
+{
+    ASSERT0(stmt && stmt->is_stmt());
+    DUSet const* useset = stmt->readDUSet();
+    if (useset != NULL && stmt->get_ssainfo() == NULL) {
+        DUIter di = NULL;
+        for (INT i = useset->get_first(&di);
+             i >= 0; i = useset->get_next(i, &di)) {
+            m_dirty_exp.bunion(i);
+        }
+    }
+    removeIROutFromDUMgr(stmt);
+    m_dirty_stmt.diff(IR_id(stmt));
+    m_dirty_def.diff(IR_id(stmt));
+}
+
+
+void IR_DU_MGR::markReplacedExp(IR * oldexp, IR * newexp)
+{
+    ASSERT0(oldexp && oldexp->is_exp() && newexp && newexp->is_exp());
+    ASSERT0(newexp->get_stmt());
+    removeUseOutFromDefset(oldexp);
+    m_dirty_stmt.bunion(IR_id(newexp->get_stmt()));
+}
+
+
+//Collect the USEs in 'bb' that 'stmt' may reach. Walk from the IR next
+//to 'ct', or the first IR of 'bb' if 'ct' is NULL.
+//Return true if 'stmt' is killed in 'bb'.
+bool IR_DU_MGR::collectAffectedUseInBB(
+        IR const* stmt,
+        IRBB * bb,
+        C<IR*> * ct,
+        OUT BitSet & uses)
+{
+    MD const* mustdef = get_must_def(stmt);
+    MDSet const* maydef = get_may_def(stmt);
+    BBIRList & irlst = BB_irlist(bb);
+    if (ct == NULL) {
+        irlst.get_head(&ct);
+    } else {
+        ct = irlst.get_next(ct);
+    }
+
+    ConstIRIter it;
+    for (; ct != irlst.end(); ct = irlst.get_next(ct)) {
+        IR const* ir = ct->val();
+        if (ir == stmt) {
+            //Walk around the loop.
+            return true;
+        }
+
+        it.clean();
+        for (IR const* x = iterRhsInitC(ir, it);
+             x != NULL; x = iterRhsNextC(it)) {
+            if (is_du_opnd(x) && is_overlap_def_use(mustdef, maydef, x)) {
+                uses.bunion(IR_id(x));
+            }
+        }
+
+        if (ir->has_result() && is_must_kill(ir, stmt)) { return true; }
+    }
+    return false;
+}
+
+
+//Collect the USEs that new inserted 'stmt' may reach, their DEF sets
+//may be changed by 'stmt'.
+void IR_DU_MGR::collectAffectedUse(IR * stmt, OUT BitSet & uses)
+{
+    MDSet const* maydef = get_may_def(stmt);
+    if (get_must_def(stmt) == NULL && (maydef == NULL || maydef->is_empty())) {
+        return;
+    }
+
+    IRBB * bb = stmt->get_bb();
+    C<IR*> * ct = NULL;
+    BB_irlist(bb).find(stmt, &ct);
+    ASSERT0(ct);
+
+    List<IRBB*> wl;
+    List<IRBB*> succs;
+    BitSet visited;
+    if (!collectAffectedUseInBB(stmt, bb, ct, uses)) {
+        wl.append_tail(bb);
+    }
+    while (wl.get_elem_count() != 0) {
+        IRBB * t = wl.remove_head();
+        succs.clean();
+        m_cfg->get_succs(succs, t);
+        for (IRBB * s = succs.get_head(); s != NULL; s = succs.get_next()) {
+            if (visited.is_contain(BB_id(s))) { continue; }
+            visited.bunion(BB_id(s));
+            if (!collectAffectedUseInBB(stmt, s, NULL, uses)) {
+                wl.append_tail(s);
+            }
+        }
+    }
+}
+
+
+//Update DU chain of the stmts and expressions that recorded by
+//markDirtyStmt(), markRemovedStmt() and markReplacedExp().
+//The DEF set of each affected expression is recomputed by walking
+//backward from the expression, rather than solving the reach-definition
+//of whole region.
+void IR_DU_MGR::updateDirtyDUChain(IN OUT OptCtx & oc)
+{
+    START_TIMER("Update Dirty DU-CHAIN");
+    ASSERT0(OC_is_ref_valid(oc) && OC_is_cfg_valid(oc));
+    m_oc = &oc;
+    setComputePRDUBySSA();
+
+    //Stmts have been changed since reach-definitions memoized.
+    cleanLazyDUChain();
+
+    //The USE set of inserted stmt will be rebuilt.
+    for (INT i = m_dirty_def.get_first(); i >= 0;
+         i = m_dirty_def.get_next(i)) {
+        IR * stmt = m_ru->get_ir(i);
+        if (!is_stmt_in_bb(stmt) || stmt->get_ssainfo() != NULL) {
+            m_dirty_def.diff(i);
+            continue;
+        }
+        removeDefOutFromUseset(stmt);
+    }
+
+    //Collect expressions whose DEF set have to be recomputed.
+    BitSet exps;
+    ConstIRIter it;
+    for (INT i = m_dirty_stmt.get_first(); i >= 0;
+         i = m_dirty_stmt.get_next(i)) {
+        IR * stmt = m_ru->get_ir(i);
+        if (!is_stmt_in_bb(stmt) || stmt->is_region() ||
+            (stmt->is_phi() && !isComputePRDU())) {
+            continue;
+        }
+        it.clean();
+        for (IR const* x = iterRhsInitC(stmt, it);
+             x != NULL; x = iterRhsNextC(it)) {
+            if (is_du_opnd(x)) {
+                exps.bunion(IR_id(x));
+            }
+        }
+    }
+    for (INT i = m_dirty_def.get_first(); i >= 0;
+         i = m_dirty_def.get_next(i)) {
+        collectAffectedUse(m_ru->get_ir(i), exps);
+    }
+    for (INT i = m_dirty_exp.get_first(); i >= 0;
+         i = m_dirty_exp.get_next(i)) {
+        IR const* exp = m_ru->get_ir(i);
+        if (exp->get_code() == IR_UNDEF || !exp->is_exp() ||
+            !is_du_opnd(exp) || !is_stmt_in_bb(exp->get_stmt())) {
+            continue;
+        }
+        exps.bunion(i);
+    }
+
+    //Recompute DEF set.
+    DefSBitSetCore defs;
+    for (INT i = exps.get_first(); i >= 0; i = exps.get_next(i)) {
+        IR * exp = m_ru->get_ir(i);
+        DUSet * defset = exp->getDUSet();
+        if (defset != NULL) {
+            DUIter di = NULL;
+            for (INT d = defset->get_first(&di);
+                 d >= 0; d = defset->get_next(d, &di)) {
+                DUSet * useset = m_ru->get_ir(d)->getDUSet();
+                if (useset != NULL) {
+                    useset->remove_use(exp, *m_misc_bs_mgr);
+                }
+            }
+            defset->clean(*m_misc_bs_mgr);
+        }
+
+        defs.clean(*m_misc_bs_mgr);
+        collectLazyDefSet(exp, defs);
+        SEGIter * st = NULL;
+        for (INT d = defs.get_first(&st); d >= 0; d = defs.get_next(d, &st)) {
+            buildDUChain(m_ru->get_ir(d), exp);
+        }
+    }
+    defs.clean(*m_misc_bs_mgr);
+
+    cleanLazyDUChain();
+    m_dirty_stmt.clean();
+    m_dirty_def.clean();
+    m_dirty_exp.clean();
+    OC_is_du_chain_valid(oc) = true;
+    OC_is_du_chain_dirty(oc) = false;
+    END_TIMER();
+
+    if (g_verify_level >= VERIFY_LEVEL_3) {
+        ASSERT0(verifyMDDUChain());
+    }
+}
 //END IR_DU_MGR
 
 } //namespace xoc
@@ -83,16 +83,24 @@ namespace xoc {
 //    removeUseOutFromDefset
 //    removeDefOutFromUseset
 //    removeIROutFromDUMgr
+//
+//* These functions update the DU chain incrementally.
+//
+//    markDirtyStmt
+//    markRemovedStmt
+//    markReplacedExp
+//    updateDirtyDUChain
 
 //Mapping from IR to index.
 typedef HMap<IR const*, UINT, HashFuncBase2<IR const*> > IR2UINT;
 
 
 class IR_DU_MGR;
+class MDSSAMgr;
 
 //Mapping from MD to IR list, and to be responsible for
 //allocating and destroy List<IR*> objects.
-class MDId2IRlist : public TMap<UINT, DefSBitSetCore*> {
+class MDId2IRlist : public BTMap<UINT, DefSBitSetCore*> {
     Region * m_ru;
     MDSystem * m_md_sys;
     TypeMgr * m_tm;
@@ -240,6 +248,39 @@ typedef HMap<IR*, DUSet*> IR2DU;
 #define SOL_AVAIL_EXPR                 4  //must be available expression.
 #define SOL_RU_REF                     8  //region's def/use mds.
 #define SOL_REF                        16 //referrenced mds.
+
+//This class caches the CFG information that used by dataflow solver.
+//BB is indexed by its position in RPO, and the predecessors and
+//successors of all BBs are recorded in compact arrays.
+class DUSolveCFG {
+    COPY_CONSTRUCTOR(DUSolveCFG);
+public:
+    //Record BB id for each position in RPO.
+    Vector<UINT> bbid;
+
+    //The predecessors of BB at position i are recorded in
+    //pred[pred_start[i]] to pred[pred_start[i+1]-1], in BB id.
+    Vector<UINT> pred_start;
+    Vector<UINT> pred;
+
+    //The successors of BB at position i are recorded in
+    //succ[succ_start[i]] to succ[succ_start[i+1]-1], in RPO position.
+    Vector<UINT> succ_start;
+    Vector<UINT> succ;
+
+public:
+    DUSolveCFG() {}
+
+    void build(IR_CFG * cfg);
+
+    UINT get_bb_num() const { return (UINT)(bbid.get_last_idx() + 1); }
+    UINT get_pred_num(UINT pos) const
+    { return pred_start.get(pos + 1) - pred_start.get(pos); }
+    UINT const* get_preds(UINT pos)
+    { return pred.get_vec() + pred_start.get(pos); }
+};
+
+
 class IR_DU_MGR : public Pass {
     friend class MDId2IRlist;
     friend class DUSet;
@@ -272,12 +313,38 @@ protected:
     //Indicate whether MDSet is cached for specified MD.
     DefSBitSetCore m_is_cached_mdset;
 
+    //Statistics of dataflow solver.
+    UINT m_solve_bb_visit; //the number of BB evaluated.
+    UINT m_solve_set_op; //the number of set operations performed.
+
     //Used by DU chain.
     BitSet * m_is_init;
     MDId2IRlist * m_md2irs;
 
     OptCtx * m_oc;
 
+    //Used by demand-driven DU chain.
+    //Map MD id to the reach-def-out of each BB, the reach-def only
+    //contains the stmts that define the MD.
+    Vector<Vector<DefSBitSetCore*>*> m_lazy_reach_out;
+
+    //Map BB id to the exact MDs defined in BB.
+    Vector<DefSBitSetCore*> m_lazy_exact_def;
+
+    //Record IR whose DUSet has been initialized on demand.
+    BitSet m_lazy_is_init;
+
+    //Used by incremental DU chain.
+    //Record the stmts whose operands changed.
+    BitSet m_dirty_stmt;
+
+    //Record the stmts that inserted.
+    BitSet m_dirty_def;
+
+    //Record the expressions whose DEF may be changed because of the
+    //removal of stmt.
+    BitSet m_dirty_exp;
+
     /* Available reach-def computes the definitions
     which must be the last definition of result variable,
     but it may not reachable meanwhile.
@@ -353,6 +420,13 @@ protected:
             MD const* expmd,
             DUSet * expdu);
     bool checkIsTruelyDep(IR const* def, IR const* use);
+    void collectLazyDefSet(IR const* exp, OUT DefSBitSetCore & defs);
+    void collectAffectedUse(IR * stmt, OUT BitSet & uses);
+    bool collectAffectedUseInBB(
+            IR const* stmt,
+            IRBB * bb,
+            C<IR*> * ct,
+            OUT BitSet & uses);
     UINT checkIsLocalKillingDef(IR const* stmt, IR const* exp, C<IR*> * expct);
     UINT checkIsNonLocalKillingDef(IR const* stmt, IR const* exp);
     inline bool canBeLiveExprCand(IR const* ir) const;
@@ -378,6 +452,12 @@ protected:
             OUT MDSet * mayuse,
             UINT flag,
             DefMiscBitSetMgr & bsmgr);
+    void computeLazyReachDef(
+            IRBB * bb,
+            C<IR*> * ct,
+            UINT mdid,
+            OUT DefSBitSetCore & reach);
+    void computeLazyReachOut(IRBB * bb, UINT mdid);
 
     DefDBitSetCore * getMayGenDef(UINT bbid, DefMiscBitSetMgr * mgr);
     DefDBitSetCore * getMustGenDef(UINT bbid, DefMiscBitSetMgr * mgr);
@@ -391,18 +471,18 @@ protected:
 
     bool ForAvailReachDef(
             UINT bbid,
-            List<IRBB*> & preds,
-            List<IRBB*> * lst,
+            UINT const* preds,
+            UINT pred_num,
             DefMiscBitSetMgr & bsmgr);
     bool ForReachDef(
             UINT bbid,
-            List<IRBB*> & preds,
-            List<IRBB*> * lst,
+            UINT const* preds,
+            UINT pred_num,
             DefMiscBitSetMgr & bsmgr);
     bool ForAvailExpression(
             UINT bbid,
-            List<IRBB*> & preds,
-            List<IRBB*> * lst,
+            UINT const* preds,
+            UINT pred_num,
             DefMiscBitSetMgr & bsmgr);
     inline void * xmalloc(size_t size)
     {
@@ -414,11 +494,34 @@ protected:
 
     bool hasSingleDefToMD(DUSet const& defset, MD const* md) const;
 
+    //Return true if 'x' is the operand that DU chain recorded.
+    bool is_du_opnd(IR const* x) const
+    {
+        return x->is_ld() || x->is_ild() || x->is_array() ||
+               (x->is_pr() && isComputePRDU());
+    }
+
+    //Return true if stmt 'ir' is still placed in BB.
+    bool is_stmt_in_bb(IR * ir) const;
+
+    DefSBitSetCore const* getLazyExactDef(IRBB * bb);
+    void genLazyReachDef(
+            IR const* stmt,
+            UINT mdid,
+            IN OUT DefSBitSetCore & reach);
+
     bool is_overlap_def_use(
             MD const* mustdef,
             MDSet const* maydef,
             IR const* use);
     void initMD2IRList(IRBB * bb);
+    bool isLazyDefOf(IR const* stmt, UINT mdid);
+    bool isReachDefOfExp(
+            IR const* def,
+            IR const* exp,
+            MD const* expmd,
+            MDSet const* expmds,
+            IRBB * curbb);
     void inferRegion(IR * ir, bool ruinfo_avail, IN MDSet * tmp);
     void inferIstore(IR * ir);
     void inferStore(IR * ir);
@@ -430,6 +533,10 @@ protected:
     void solve(DefDBitSetCore const& expr_universe,
                UINT const flag,
                DefMiscBitSetMgr & bsmgr);
+    void solveByWorkList(
+            UINT const sol,
+            DUSolveCFG & scfg,
+            DefMiscBitSetMgr & bsmgr);
     void resetLocalAuxSet(DefMiscBitSetMgr & bsmgr);
     void resetAvailReachDefInSet(bool cleanMember);
     void resetAvailExpInSet(bool cleanMember);
@@ -479,6 +586,46 @@ public:
             Vector<MDSet*> const* maydefmds,
             DefMiscBitSetMgr & bsmgr);
     void computeMDDUChain(IN OUT OptCtx & oc, bool retain_reach_def = false);
+
+    //Demand-driven DU chain.
+    //Compute the DEF stmt set of 'exp' on demand if the DU chain is not
+    //available. Reach-definitions are computed by walking backward over
+    //CFG only for the MDs that 'exp' referenced, and memoized for each
+    //pair of BB and MD. The USE set of stmt only records the expressions
+    //that have been queried.
+    //Return the DUSet of 'exp', or NULL if 'exp' is PR in SSA form.
+    //NOTE: MD reference must be available, and the memoized
+    //reach-definitions have to be cleaned by cleanLazyDUChain() if stmt
+    //or CFG changed.
+    DUSet const* getDUSetOnDemand(IR * exp, OptCtx & oc);
+
+    //Free the memoized reach-definitions of demand-driven DU chain.
+    void cleanLazyDUChain();
+
+    //Incremental DU chain.
+    //Pass that changed a few stmts records them by the following
+    //functions and sets OC_is_du_chain_dirty, rather than invalidating
+    //DU chain of whole region. DU chain of the recorded IR is updated
+    //locally by updateDirtyDUChain() when DU chain is required next
+    //time, where the DEF set of expression is recomputed by the
+    //demand-driven reach-definition.
+    //NOTE: MD reference of new IR must be available.
+
+    //Record that the operands of 'stmt' changed. If 'is_inserted' is
+    //true, 'stmt' is new inserted, and the USEs that 'stmt' may reach
+    //will be updated as well.
+    void markDirtyStmt(IR * stmt, bool is_inserted);
+
+    //Remove 'stmt' from DU chain, the USEs of 'stmt' will be updated
+    //with the DEFs that killed by 'stmt' before.
+    void markRemovedStmt(IR * stmt);
+
+    //Remove 'oldexp' from DU chain, where 'newexp' has been placed
+    //into the stmt of 'oldexp'.
+    void markReplacedExp(IR * oldexp, IR * newexp);
+
+    //Update DU chain of the IR recorded.
+    void updateDirtyDUChain(IN OUT OptCtx & oc);
     void computeRegionMDDU(
             Vector<MDSet*> const* mustdefmds,
             Vector<MDSet*> const* maydefmds,
@@ -895,7 +1042,14 @@ public:
     void removeDefOutFromUseset(IR * def);
     void removeIROutFromDUMgr(IR * ir);
 
+    //Return MD SSA manager if MD SSA form is constructed.
+    //The form is updated when IR is removed from DU manager.
+    MDSSAMgr * getMDSSAMgr() const;
+
+    void setComputePRDUBySSA();
+
     bool verifyMDDUChain();
+    bool verifyLazyDUChain();
     bool verifyMDDUChainForIR(IR const* ir);
     bool verifyLiveinExp();
 
@@ -160,9 +160,7 @@ UINT IR_EXPR_TAB::compute_hash_key(IR const* ir)
 UINT IR_EXPR_TAB::compute_hash_key_for_tree(IR * ir)
 {
     UINT hval = 0;
-    m_iter.clean();
-    for (IR const* x = iterInitC(ir, m_iter);
-         x != NULL; x = iterNextC(m_iter)) {
+    for (IR const* x = m_iter.init(ir); x != NULL; x = m_iter.next()) {
         hval += compute_hash_key(x);
     }
     return hval;
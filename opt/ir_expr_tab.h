@@ -73,7 +73,7 @@ class IR_EXPR_TAB : public Pass {
     //Record allocated object. used by destructor.
     SList<ExpRep*> m_ir_expr_lst;
 
-    ConstIRIter m_iter; //for tmp use.
+    ConstIRPreIter m_iter; //for tmp use.
     SMemPool * m_pool;
     SMemPool * m_sc_pool;
     ExpRep ** m_level1_hash_tab[IR_EXPR_TAB_LEVEL1_HASH_BUCKET];
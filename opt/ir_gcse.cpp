@@ -42,8 +42,8 @@ namespace xoc {
 
 //#define DEBUG_GCSE
 #ifdef DEBUG_GCSE
-static INT g_num_of_elim = 0;
-List<IR_TYPE> g_elim_irt;
+//Regions may be processed by multiple threads.
+static THREAD_LOCAL INT g_num_of_elim = 0;
 #endif
 
 //
@@ -67,7 +67,6 @@ void IR_GCSE::elimCseAtStore(IR * use, IR * use_stmt, IR * gen)
     ASSERT0(use_stmt->is_st() || use_stmt->is_stpr() || use_stmt->is_ist());
     #ifdef DEBUG_GCSE
     ASSERT0(++g_num_of_elim);
-    ASSERT0(g_elim_irt.append_tail(IR_code(use)));
     #endif
     ASSERT0(use->is_exp() && gen->is_exp());
     ASSERT0(use_stmt->get_rhs() == use);
@@ -116,7 +115,6 @@ void IR_GCSE::elimCseAtBranch(IR * use, IR * use_stmt, IN IR * gen)
 {
     #ifdef DEBUG_GCSE
     ASSERT0(++g_num_of_elim);
-    ASSERT0(g_elim_irt.append_tail(IR_code(use)));
     #endif
     ASSERT0(use->is_exp() && gen->is_exp());
 
@@ -174,7 +172,6 @@ void IR_GCSE::elimCseAtCall(IR * use, IR * use_stmt, IR * gen)
 {
     #ifdef DEBUG_GCSE
     ASSERT0(++g_num_of_elim);
-    ASSERT0(g_elim_irt.append_tail(IR_code(use)));
     #endif
     ASSERT0(use->is_exp() && gen->is_exp() && use_stmt->is_stmt());
 
@@ -411,7 +408,7 @@ bool IR_GCSE::prcessCse(IN IR * exp, IN List<IR*> & livexp)
         ASSERT0(gen_stmt->get_bb());
         UINT iid = BB_id(expstmt->get_bb());
         UINT xid = BB_id(gen_stmt->get_bb());
-        if (!m_cfg->get_dom_set(iid)->is_contain(xid)) {
+        if (!m_cfg->is_dom(xid, iid)) {
             continue;
         }
         return elim(exp, expstmt, gen, gen_stmt);
@@ -734,7 +731,6 @@ bool IR_GCSE::perform(OptCtx & oc)
 
     #ifdef DEBUG_GCSE
     g_num_of_elim = 0;
-    g_elim_irt.clean();
     #endif
 
     if (m_gvn != NULL) {
@@ -761,19 +757,14 @@ bool IR_GCSE::perform(OptCtx & oc)
         #ifdef DEBUG_GCSE
         FILE * h = fopen("gcse.effect.log", "a+");
         fprintf(h, "\n\"%s\",", m_ru->get_ru_name());
-        /*
         fprintf(h, " elim_num:%d, ", g_num_of_elim);
-        for (UINT i = (UINT)g_elim_irt.get_head();
-             i != 0; i = (UINT)g_elim_irt.get_next()) {
-            fprintf(h, "%s,", IRTNAME(i));
-        }
-        */
         fclose(h);
         #endif
         //no new expr generated, only new pr.
 
         OC_is_expr_tab_valid(oc) = false;
         OC_is_aa_valid(oc) = false;
+        OC_is_md_ssa_valid(oc) = false;
 
         //DU reference and du chain has maintained.
         ASSERT0(m_ru->verifyMDRef());
@@ -129,6 +129,9 @@ public:
     { return "Global Command Subscript Elimination"; }
 
     PASS_TYPE get_pass_type() const { return PASS_GCSE; }
+    virtual UINT get_consumed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+    virtual UINT get_changed_fact() const { return FACT_STMT | FACT_EXP; }
 
     bool perform(OptCtx & oc);
 };
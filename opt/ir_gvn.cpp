@@ -1283,6 +1283,13 @@ void IR_GVN::dump_bb(UINT bbid)
                 dump_h1(k, x);
             }
             break;
+        case IR_PHI:
+            for (IR const* k = PHI_opnd_list(ir);
+                 k != NULL; k = k->get_next()) {
+                VN * x = m_ir2vn.get(IR_id(k));
+                dump_h1(k, x);
+            }
+            break;
         case IR_GOTO: break;
         case IR_REGION:
             UNREACH(); //TODO
@@ -1357,13 +1364,11 @@ bool IR_GVN::calcCondMustVal(IR const* ir, bool & must_true, bool & must_false)
     case IR_LAND:
     case IR_LOR:
         if (VN_type(v1) == VN_INT && VN_type(v2) == VN_INT) {
-            if (VN_int_val(v1) && VN_int_val(v2)) {
-                must_true = true;
-                must_false = false;
-            } else {
-                must_true = false;
-                must_false = true;
-            }
+            bool res = ir->is_land() ?
+                (VN_int_val(v1) != 0 && VN_int_val(v2) != 0) :
+                (VN_int_val(v1) != 0 || VN_int_val(v2) != 0);
+            must_true = res;
+            must_false = !res;
             return true;
         }
         break;
@@ -1428,24 +1433,19 @@ bool IR_GVN::calcCondMustVal(IR const* ir, bool & must_true, bool & must_false)
         }
         break;
     case IR_NE:
-        if (v1 != v2) {
-            must_true = true;
-            must_false = false;
-            return true;
-        } else {
-            must_true = false;
-            must_false = true;
-            return true;
-        }
-        break;
     case IR_EQ:
+        //Different VNs do not mean different values unless
+        //both of them are constant.
         if (v1 == v2) {
-            must_true = true;
-            must_false = false;
+            must_true = ir->is_eq();
+            must_false = !must_true;
             return true;
-        } else {
-            must_true = false;
-            must_false = true;
+        }
+
+        if (VN_type(v1) == VN_INT && VN_type(v2) == VN_INT) {
+            bool equ = VN_int_val(v1) == VN_int_val(v2);
+            must_true = ir->is_eq() ? equ : !equ;
+            must_false = !must_true;
             return true;
         }
         break;
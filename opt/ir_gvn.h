@@ -219,13 +219,13 @@ public:
 };
 
 
-class SCVNE2VN : public HMap<VNE_SC*, VN*, VNE_SC_HF> {
+class SCVNE2VN : public FlatHMap<VNE_SC*, VN*, VNE_SC_HF> {
 protected:
     SMemPool * m_pool;
     List<VNE_SC*> m_free_lst;
 public:
     SCVNE2VN(SMemPool * pool, UINT bsize) :
-        HMap<VNE_SC*, VN*, VNE_SC_HF>(bsize)
+        FlatHMap<VNE_SC*, VN*, VNE_SC_HF>(bsize)
     {
         ASSERT0(pool);
         m_pool = pool;
@@ -249,7 +249,7 @@ public:
             ve->clean();
             m_free_lst.append_head(ve);
         }
-        HMap<VNE_SC*, VN*, VNE_SC_HF>::clean();
+        FlatHMap<VNE_SC*, VN*, VNE_SC_HF>::clean();
     }
 };
 
@@ -274,13 +274,13 @@ public:
 };
 
 
-class ILD_VNE2VN : public HMap<VNE_ILD*, VN*, VNE_ILD_HF> {
+class ILD_VNE2VN : public FlatHMap<VNE_ILD*, VN*, VNE_ILD_HF> {
 protected:
     SMemPool * m_pool;
     List<VNE_ILD*> m_free_lst;
 public:
     ILD_VNE2VN(SMemPool * pool, UINT bsize) :
-        HMap<VNE_ILD*, VN*, VNE_ILD_HF>(bsize)
+        FlatHMap<VNE_ILD*, VN*, VNE_ILD_HF>(bsize)
     {
         ASSERT0(pool);
         m_pool = pool;
@@ -304,7 +304,7 @@ public:
             ve->clean();
             m_free_lst.append_head(ve);
         }
-        HMap<VNE_ILD*, VN*, VNE_ILD_HF>::clean();
+        FlatHMap<VNE_ILD*, VN*, VNE_ILD_HF>::clean();
     }
 };
 
@@ -376,13 +376,13 @@ public:
 };
 
 
-class ARR_VNE2VN : public HMap<VNE_ARR*, VN*, VNE_ARR_HF> {
+class ARR_VNE2VN : public FlatHMap<VNE_ARR*, VN*, VNE_ARR_HF> {
 protected:
     SMemPool * m_pool;
     List<VNE_ARR*> m_free_lst;
 public:
     ARR_VNE2VN(SMemPool * pool, UINT bsize) :
-        HMap<VNE_ARR*, VN*, VNE_ARR_HF>(bsize)
+        FlatHMap<VNE_ARR*, VN*, VNE_ARR_HF>(bsize)
     {
         ASSERT0(pool);
         m_pool = pool;
@@ -406,7 +406,7 @@ public:
             ve->clean();
             m_free_lst.append_head(ve);
         }
-        HMap<VNE_ARR*, VN*, VNE_ARR_HF>::clean();
+        FlatHMap<VNE_ARR*, VN*, VNE_ARR_HF>::clean();
     }
 };
 
@@ -487,7 +487,9 @@ protected:
 protected:
     VN * allocLiveinVN(IR const* exp, MD const* emd, bool & change);
 
-    void clean();
+    //Derived class that allocates VN by itself should recycle its VNs
+    //as well, since reperform() cleans through the interface.
+    virtual void clean();
     VN * computeScalarByAnonDomDef(
             IR const* ild,
             IR const* domdef,
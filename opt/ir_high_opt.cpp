@@ -74,7 +74,16 @@ void Region::HighProcessImpl(OptCtx & oc)
         IR_DU_MGR * dumgr =
             (IR_DU_MGR*)get_pass_mgr()->registerPass(PASS_DU_MGR);
         ASSERT0(dumgr);
-        UINT f = SOL_REACH_DEF|SOL_REF;
+        //At high optimization level, MD SSA and PR SSA supersede the
+        //reach-def and DU chain of MD, the passes that still need the
+        //DU chain compute it on demand.
+        bool const use_ssa_du = g_do_md_ssa && g_do_ssa &&
+                                g_opt_level == OPT_LEVEL3;
+        UINT f = SOL_REF;
+        if (!use_ssa_du) {
+            f |= SOL_REACH_DEF;
+        }
+
         if (g_compute_available_exp) {
             f |= SOL_AVAIL_EXPR;
         }
@@ -83,12 +92,15 @@ void Region::HighProcessImpl(OptCtx & oc)
             f |= SOL_RU_REF;
         }
 
-        if (g_compute_du_chain) {
+        if (g_compute_du_chain && !use_ssa_du) {
             f |= SOL_REACH_DEF;
         }
 
         if (dumgr->perform(oc, f) && OC_is_ref_valid(oc)) {
-            if (g_compute_du_chain) {
+            if (g_do_md_ssa) {
+                checkValidAndRecompute(&oc, PASS_MD_SSA_MGR, PASS_UNDEF);
+            }
+            if (g_compute_du_chain && !use_ssa_du) {
                 dumgr->computeMDDUChain(oc);
             }
         }
@@ -0,0 +1,370 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef __IR_ITER_H__
+#define __IR_ITER_H__
+
+namespace xoc {
+
+class Region;
+
+//Number of elements that held in iterator object itself.
+//Walking a tree that deeper than the number will allocate memory.
+#define IR_ITER_INLINE_SIZE 32
+
+//Compile time description of each IR type, it is generated from
+//IR_DESC_TABLE, and is the same as the entry of g_ir_desc.
+template <IR_TYPE irt> class IRDescTrait {};
+
+#define IR_DESC_TRAIT(code, name, kid_map, kid_num, attr, size) \
+    template <> class IRDescTrait<code> { \
+    public: \
+        enum { KID_NUM = kid_num, ATTR = attr }; \
+    };
+IR_DESC_TABLE(IR_DESC_TRAIT)
+#undef IR_DESC_TRAIT
+
+
+//Stack of IR iterator.
+//The first IR_ITER_INLINE_SIZE elements are held in the object itself,
+//thus walking through common IR tree does not allocate memory.
+//NOTE: T must be plain old data.
+template <class T> class IRIterStack {
+    COPY_CONSTRUCTOR(IRIterStack);
+    T m_inline[IR_ITER_INLINE_SIZE];
+    T * m_vec;
+    UINT m_top;
+    UINT m_cap;
+
+    void grow()
+    {
+        UINT cap = m_cap * 2;
+        T * v = (T*)::malloc(sizeof(T) * cap);
+        ASSERT0(v);
+        ::memcpy(v, m_vec, sizeof(T) * m_top);
+        if (m_vec != m_inline) {
+            ::free(m_vec);
+        }
+        m_vec = v;
+        m_cap = cap;
+    }
+public:
+    IRIterStack()
+    {
+        m_vec = m_inline;
+        m_top = 0;
+        m_cap = IR_ITER_INLINE_SIZE;
+    }
+    ~IRIterStack()
+    {
+        if (m_vec != m_inline) {
+            ::free(m_vec);
+        }
+    }
+
+    void clean() { m_top = 0; }
+
+    bool is_empty() const { return m_top == 0; }
+
+    T pop()
+    {
+        ASSERT0(m_top > 0);
+        return m_vec[--m_top];
+    }
+
+    void push(T const& t)
+    {
+        if (m_top == m_cap) { grow(); }
+        m_vec[m_top++] = t;
+    }
+
+    T & top()
+    {
+        ASSERT0(m_top > 0);
+        return m_vec[m_top - 1];
+    }
+};
+
+
+//Preorder iterator of IR tree.
+//It accesses IR, then the kids of IR from the first to the last,
+//then the sibling of IR.
+//Compared to iterInit/iterNext, the iterator does not allocate memory
+//for common IR tree, and the iterator is depth first.
+//Usage:
+//    ConstIRPreIter it;
+//    for (IR const* x = it.init(ir); x != NULL; x = it.next()) { ... }
+template <class IRTy> class IRPreIterT {
+    COPY_CONSTRUCTOR(IRPreIterT);
+    IRIterStack<IRTy> m_stack;
+public:
+    IRPreIterT() {}
+
+    void clean() { m_stack.clean(); }
+
+    //Initialize the iterator and return 'ir'.
+    //The tree of 'ir' and the siblings of 'ir' will be accessed,
+    //the same as iterInit.
+    IRTy init(IRTy ir)
+    {
+        m_stack.clean();
+        if (ir == NULL) { return NULL; }
+        m_stack.push(ir);
+        return next();
+    }
+
+    //Initialize the iterator with the kids of stmt 'ir', and return
+    //the first kid, the same as iterRhsInit.
+    IRTy initRhs(IRTy ir)
+    {
+        m_stack.clean();
+        if (ir == NULL) { return NULL; }
+        ASSERT0(ir->is_stmt());
+        for (INT i = IR_MAX_KID_NUM(ir) - 1; i >= 0; i--) {
+            IRTy kid = ir->get_kid(i);
+            if (kid == NULL) { continue; }
+            m_stack.push(kid);
+        }
+        return next();
+    }
+
+    //Return the next IR, or NULL if all IR have been accessed.
+    IRTy next()
+    {
+        if (m_stack.is_empty()) { return NULL; }
+        IRTy ir = m_stack.pop();
+        if (ir->get_next() != NULL) {
+            m_stack.push(ir->get_next());
+        }
+        for (INT i = IR_MAX_KID_NUM(ir) - 1; i >= 0; i--) {
+            IRTy kid = ir->get_kid(i);
+            if (kid == NULL) { continue; }
+            m_stack.push(kid);
+        }
+        return ir;
+    }
+};
+
+typedef IRPreIterT<IR const*> ConstIRPreIter;
+typedef IRPreIterT<IR*> IRPreIter;
+
+
+template <class IRTy> class IRPostFrame {
+public:
+    IRTy ir;
+    UINT kid; //the kid to be accessed next.
+};
+
+
+//Postorder iterator of IR tree.
+//It accesses the kids of IR from the first to the last, then IR,
+//then the sibling of IR. Kids are always accessed before parent,
+//thus the iterator is suitable for bottom up evaluation.
+//Usage:
+//    ConstIRPostIter it;
+//    for (IR const* x = it.init(ir); x != NULL; x = it.next()) { ... }
+template <class IRTy> class IRPostIterT {
+    COPY_CONSTRUCTOR(IRPostIterT);
+    IRIterStack<IRPostFrame<IRTy> > m_stack;
+
+    void push(IRTy ir)
+    {
+        IRPostFrame<IRTy> f;
+        f.ir = ir;
+        f.kid = 0;
+        m_stack.push(f);
+    }
+public:
+    IRPostIterT() {}
+
+    void clean() { m_stack.clean(); }
+
+    //Initialize the iterator and return the first leaf of 'ir'.
+    //The tree of 'ir' and the siblings of 'ir' will be accessed.
+    IRTy init(IRTy ir)
+    {
+        m_stack.clean();
+        if (ir == NULL) { return NULL; }
+        push(ir);
+        return next();
+    }
+
+    //Initialize the iterator with the kids of stmt 'ir'.
+    //Stmt 'ir' itself will not be accessed.
+    IRTy initRhs(IRTy ir)
+    {
+        m_stack.clean();
+        if (ir == NULL) { return NULL; }
+        ASSERT0(ir->is_stmt());
+        for (INT i = IR_MAX_KID_NUM(ir) - 1; i >= 0; i--) {
+            IRTy kid = ir->get_kid(i);
+            if (kid == NULL) { continue; }
+            push(kid);
+        }
+        return next();
+    }
+
+    //Return the next IR, or NULL if all IR have been accessed.
+    IRTy next()
+    {
+        while (!m_stack.is_empty()) {
+            IRPostFrame<IRTy> & f = m_stack.top();
+            IRTy ir = f.ir;
+            IRTy kid = NULL;
+            while (f.kid < IR_MAX_KID_NUM(ir) && kid == NULL) {
+                kid = ir->get_kid(f.kid);
+                f.kid++;
+            }
+            if (kid != NULL) {
+                //'f' may be invalid after push.
+                push(kid);
+                continue;
+            }
+            m_stack.pop();
+            if (ir->get_next() != NULL) {
+                push(ir->get_next());
+            }
+            return ir;
+        }
+        return NULL;
+    }
+};
+
+typedef IRPostIterT<IR const*> ConstIRPostIter;
+typedef IRPostIterT<IR*> IRPostIter;
+
+
+//Visitor of IR tree.
+//The handler of each IR is chosen by the IR type at compile time,
+//according to the attribute of IRDescTrait:
+//    visitStmt: stmt.
+//    visitMemOpnd: expression that references memory, e.g: LD, ILD,
+//        PR, ARRAY. It invokes visitExp by default.
+//    visitExp: the other expressions.
+//Derived class overrides the handlers it concerns, the dispatching
+//does not go through virtual function.
+//Each handler returns false to terminate the walking.
+//IR is visited in preorder, the kids of IR are visited after the
+//handler returned, thus the handler may modify the kids.
+//e.g: count the memory operands of tree.
+//    class MemOpndCounter : public IRVisitor<MemOpndCounter> {
+//    public:
+//        UINT count;
+//        bool visitMemOpnd(IR const* ir) { count++; return true; }
+//    };
+template <class Derived, class IRTy = IR const*> class IRVisitor {
+    COPY_CONSTRUCTOR(IRVisitor);
+protected:
+    IRIterStack<IRTy> m_stack;
+
+    Derived * derived() { return static_cast<Derived*>(this); }
+
+    template <IR_TYPE irt> bool dispatch(IRTy ir)
+    {
+        bool cont;
+        if ((IRDescTrait<irt>::ATTR & IRT_IS_STMT) != 0) {
+            cont = derived()->visitStmt(ir);
+        } else if ((IRDescTrait<irt>::ATTR & IRT_IS_MEM_OPND) != 0) {
+            cont = derived()->visitMemOpnd(ir);
+        } else {
+            cont = derived()->visitExp(ir);
+        }
+        if (!cont) { return false; }
+
+        //The number of kid is constant of each IR type.
+        for (INT i = IRDescTrait<irt>::KID_NUM - 1; i >= 0; i--) {
+            IRTy kid = ir->get_kid(i);
+            if (kid == NULL) { continue; }
+            m_stack.push(kid);
+        }
+        return true;
+    }
+
+    bool walk()
+    {
+        while (!m_stack.is_empty()) {
+            IRTy ir = m_stack.pop();
+            if (ir->get_next() != NULL) {
+                m_stack.push(ir->get_next());
+            }
+
+            bool cont = false;
+            switch (IR_code(ir)) {
+            #define IR_VISIT_CASE(code, name, kid_map, kid_num, attr, size) \
+            case code: cont = dispatch<code>(ir); break;
+            IR_DESC_TABLE(IR_VISIT_CASE)
+            #undef IR_VISIT_CASE
+            default: UNREACH();
+            }
+            if (!cont) {
+                m_stack.clean();
+                return false;
+            }
+        }
+        return true;
+    }
+public:
+    IRVisitor() {}
+
+    //Visit the tree of 'ir' and the siblings of 'ir'.
+    //Return false if the walking is terminated by handler.
+    bool visit(IRTy ir)
+    {
+        m_stack.clean();
+        if (ir == NULL) { return true; }
+        m_stack.push(ir);
+        return walk();
+    }
+
+    //Visit the kids of stmt 'ir', stmt itself is not visited.
+    //Return false if the walking is terminated by handler.
+    bool visitRhs(IRTy ir)
+    {
+        m_stack.clean();
+        if (ir == NULL) { return true; }
+        ASSERT0(ir->is_stmt());
+        for (INT i = IR_MAX_KID_NUM(ir) - 1; i >= 0; i--) {
+            IRTy kid = ir->get_kid(i);
+            if (kid == NULL) { continue; }
+            m_stack.push(kid);
+        }
+        return walk();
+    }
+
+    bool visitStmt(IRTy) { return true; }
+    bool visitMemOpnd(IRTy ir) { return derived()->visitExp(ir); }
+    bool visitExp(IRTy) { return true; }
+};
+
+} //namespace xoc
+#endif
@@ -186,6 +186,9 @@ public:
 
     PASS_TYPE get_pass_type() const { return PASS_IVR; }
 
+    //IVR is an analysis, it does not change IR.
+    virtual UINT get_changed_fact() const { return FACT_UNDEF; }
+
     bool is_loop_invariant(LI<IRBB> const* li, IR const* ir);
 
     void setOnlyHandleExactMD(bool doit) { m_is_only_handle_exact_md = doit; }
@@ -52,6 +52,23 @@ IR_LCSE::IR_LCSE(Region * ru)
 }
 
 
+IR * IR_LCSE::insertCSEDef(IRBB * bb, IR * pr, IR * rhs, C<IR*> * pos)
+{
+    ASSERT0(pr->is_pr());
+    m_ru->allocRefForPR(pr);
+    IR * new_st = m_ru->buildStorePR(PR_no(pr), pr->get_type(), rhs);
+    m_ru->allocRefForPR(new_st);
+
+    //Insert into IR list of BB.
+    BB_irlist(bb).insert_before(new_st, pos);
+
+    //'pr' is new, all USEs of it are in the stmts that marked dirty,
+    //thus the DEF need not to walk forward for the affected USEs.
+    m_du->markDirtyStmt(new_st, false);
+    return new_st;
+}
+
+
 //Hoist CSE's computation, and replace its occurrence with the result pr.
 IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
 {
@@ -70,10 +87,7 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
                 //e.g: a = 10, expression of store_val is NULL.
                 IR * x = ST_rhs(ir_pos);
                 ret = m_ru->buildPR(IR_dt(x));
-                IR * new_st = m_ru->buildStorePR(PR_no(ret), ret->get_type(), x);
-
-                //Insert into IR list of BB.
-                BB_irlist(bb).insert_before(new_st, pos_holder);
+                insertCSEDef(bb, ret, x, pos_holder);
                 ST_rhs(ir_pos) = ret;
                 ir_pos->setParentPointer(false);
             } //end if
@@ -82,16 +96,14 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
                 //Move MEM ADDR to Temp PR.
                 tie = m_expr_tab->map_ir2ir_expr(IST_base(ir_pos));
                 if (tie != NULL && tie == ie) {
+                    IR * x = IST_base(ir_pos);
                     if (ret == NULL) {
-                        IR * x = IST_base(ir_pos);
+                        //Base will be replaced, move it to the new stmt.
                         ret = m_ru->buildPR(IR_dt(x));
-                        IR * new_st = m_ru->buildStorePR(PR_no(ret),
-                                            ret->get_type(), m_ru->dupIRTree(x));
-
-                        //Insert into IR list of BB.
-                        BB_irlist(bb).insert_before(new_st, pos_holder);
+                        insertCSEDef(bb, ret, x, pos_holder);
                     } else {
-                        ret = m_ru->dupIRTree(ret);
+                        m_du->removeUseOutFromDefset(x);
+                        ret = dupCSEPR(ret);
                     }
 
                     //Replace orignial referenced IR with the new PR.
@@ -99,6 +111,9 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
                     ir_pos->setParentPointer(false);
                 }
             }
+            if (ret != NULL) {
+                m_du->markDirtyStmt(ir_pos, false);
+            }
             return ret;
         }
         break;
@@ -118,21 +133,22 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
                         replace(&CALL_param_list(ir_pos), p, ret);
                         insert_st = true;
                     } else {
-                        replace(&CALL_param_list(ir_pos), p,
-                                m_ru->dupIRTree(ret));
+                        m_du->removeUseOutFromDefset(p);
+                        replace(&CALL_param_list(ir_pos), p, dupCSEPR(ret));
                         insert_st = false;
                     }
                     ASSERT0(IR_prev(p) == NULL && p->get_next() == NULL);
 
                     if (insert_st) {
-                        IR * new_st = m_ru->buildStorePR(
-                                        PR_no(ret), ret->get_type(), p);
-                        BB_irlist(bb).insert_before(new_st, pos_holder);
+                        insertCSEDef(bb, ret, p, pos_holder);
                     }
                 }
                 p = next_parm;
             } //end while
             ir_pos->setParentPointer(false);
+            if (ret != NULL) {
+                m_du->markDirtyStmt(ir_pos, false);
+            }
             return ret;
         }
         break;
@@ -153,10 +169,10 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
             if (tie != NULL && tie == ie) {
                 IR * x = BR_det(ir_pos);
                 IR * ret = m_ru->buildPR(IR_dt(x));
-                IR * new_st = m_ru->buildStorePR(PR_no(ret), ret->get_type(), x);
-                BB_irlist(bb).insert_before(new_st, pos_holder);
+                insertCSEDef(bb, ret, x, pos_holder);
                 BR_det(ir_pos) = ret;
                 ir_pos->setParentPointer(false);
+                m_du->markDirtyStmt(ir_pos, false);
                 return ret;
             }
         }
@@ -167,10 +183,10 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
             if (tie != NULL && tie == ie) {
                 IR * x = IGOTO_vexp(ir_pos);
                 IR * ret = m_ru->buildPR(IR_dt(x));
-                IR * new_st = m_ru->buildStorePR(PR_no(ret), ret->get_type(), x);
-                BB_irlist(bb).insert_before(new_st, pos_holder);
+                insertCSEDef(bb, ret, x, pos_holder);
                 IGOTO_vexp(ir_pos) = ret;
                 ir_pos->setParentPointer(false);
+                m_du->markDirtyStmt(ir_pos, false);
                 return ret;
             }
         }
@@ -181,10 +197,10 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
             if (tie != NULL && tie == ie) {
                 IR * x = SWITCH_vexp(ir_pos);
                 IR * ret = m_ru->buildPR(IR_dt(x));
-                IR * new_st = m_ru->buildStorePR(PR_no(ret), ret->get_type(), x);
-                BB_irlist(bb).insert_before(new_st, pos_holder);
+                insertCSEDef(bb, ret, x, pos_holder);
                 SWITCH_vexp(ir_pos) = ret;
                 ir_pos->setParentPointer(false);
+                m_du->markDirtyStmt(ir_pos, false);
                 return ret;
             }
         }
@@ -195,10 +211,10 @@ IR * IR_LCSE::hoist_cse(IN IRBB * bb, IN IR * ir_pos, IN ExpRep * ie)
             if (tie != NULL && tie == ie) {
                 IR * x = RET_exp(ir_pos);
                 IR * ret = m_ru->buildPR(IR_dt(x));
-                IR * new_st = m_ru->buildStorePR(PR_no(ret), ret->get_type(), x);
-                BB_irlist(bb).insert_before(new_st, pos_holder);
+                insertCSEDef(bb, ret, x, pos_holder);
                 RET_exp(ir_pos) = ret;
                 ir_pos->setParentPointer(false);
+                m_du->markDirtyStmt(ir_pos, false);
                 return ret;
             }
             ir_pos->setParentPointer(false);
@@ -242,8 +258,10 @@ bool IR_LCSE::processBranch(
                 map_expr2avail_pr.set(EXPR_id(ie), pr);
                 change = true;
             }
-            BR_det(ir) = m_ru->buildJudge(m_ru->dupIRTree(pr));
+            m_du->removeUseOutFromDefset(BR_det(ir));
+            BR_det(ir) = m_ru->buildJudge(dupCSEPR(pr));
             ir->setParentPointer(false);
+            m_du->markDirtyStmt(ir, false);
             change = true;
         } else {
             map_expr2avail_pos.set(EXPR_id(ie), ir);
@@ -361,8 +379,10 @@ bool IR_LCSE::processRhsOfStore(
                 map_expr2avail_pr.set(EXPR_id(ie), pr);
                 change = true;
             }
-            ST_rhs(ir) = m_ru->dupIRTree(pr);
+            m_du->removeUseOutFromDefset(ST_rhs(ir));
+            ST_rhs(ir) = dupCSEPR(pr);
             ir->setParentPointer(false);
+            m_du->markDirtyStmt(ir, false);
             change = true;
         } else {
             //Record position of IR stmt.
@@ -392,8 +412,10 @@ bool IR_LCSE::processRhsOfStore(
                     map_expr2avail_pr.set(EXPR_id(ie), pr);
                     change = true;
                 }
-                IST_base(ir) = m_ru->dupIRTree(pr);
+                m_du->removeUseOutFromDefset(IST_base(ir));
+                IST_base(ir) = dupCSEPR(pr);
                 ir->setParentPointer(false);
+                m_du->markDirtyStmt(ir, false);
                 change = true;
             } else {
                 map_expr2avail_pos.set(EXPR_id(ie), ir);
@@ -475,13 +497,15 @@ bool IR_LCSE::processUse(IN IRBB * bb, IN IR * ir,
                                       map_expr2avail_pos,
                                       map_expr2avail_pr);
             if (cse_val != NULL) {
+                m_du->removeUseOutFromDefset(BR_det(ir));
                 if (!cse_val->is_judge()) {
-                    cse_val = m_ru->buildJudge(m_ru->dupIRTree(cse_val));
+                    cse_val = m_ru->buildJudge(dupCSEPR(cse_val));
                     BR_det(ir) = cse_val;
                 } else {
-                    BR_det(ir) = m_ru->dupIRTree(cse_val);
+                    BR_det(ir) = dupCSEPR(cse_val);
                 }
                 ir->setParentPointer();
+                m_du->markDirtyStmt(ir, false);
                 change = true;
             }
         }
@@ -496,13 +520,15 @@ bool IR_LCSE::processUse(IN IRBB * bb, IN IR * ir,
                                       map_expr2avail_pos,
                                       map_expr2avail_pr);
             if (IGOTO_vexp(ir) != cse_val) {
+                m_du->removeUseOutFromDefset(IGOTO_vexp(ir));
                 if (!cse_val->is_judge()) {
-                    cse_val = m_ru->buildJudge(m_ru->dupIRTree(cse_val));
+                    cse_val = m_ru->buildJudge(dupCSEPR(cse_val));
                     IGOTO_vexp(ir) = cse_val;
                 } else {
-                    IGOTO_vexp(ir) = m_ru->dupIRTree(cse_val);
+                    IGOTO_vexp(ir) = dupCSEPR(cse_val);
                 }
                 ir->setParentPointer();
+                m_du->markDirtyStmt(ir, false);
                 change = true;
             }
         }
@@ -517,13 +543,15 @@ bool IR_LCSE::processUse(IN IRBB * bb, IN IR * ir,
                                        map_expr2avail_pos,
                                        map_expr2avail_pr);
             if (SWITCH_vexp(ir) != cse_val) {
+                m_du->removeUseOutFromDefset(SWITCH_vexp(ir));
                 if (!cse_val->is_judge()) {
-                    cse_val = m_ru->buildJudge(m_ru->dupIRTree(cse_val));
+                    cse_val = m_ru->buildJudge(dupCSEPR(cse_val));
                     SWITCH_vexp(ir) = cse_val;
                 } else {
-                    SWITCH_vexp(ir) = m_ru->dupIRTree(cse_val);
+                    SWITCH_vexp(ir) = dupCSEPR(cse_val);
                 }
                 ir->setParentPointer();
+                m_du->markDirtyStmt(ir, false);
                 change = true;
             }
         }
@@ -538,8 +566,10 @@ bool IR_LCSE::processUse(IN IRBB * bb, IN IR * ir,
                                        map_expr2avail_pos,
                                        map_expr2avail_pr);
             if (RET_exp(ir) != cse_val) {
-                SWITCH_vexp(ir) = m_ru->dupIRTree(cse_val);
+                m_du->removeUseOutFromDefset(RET_exp(ir));
+                RET_exp(ir) = dupCSEPR(cse_val);
                 ir->setParentPointer();
+                m_du->markDirtyStmt(ir, false);
                 change = true;
             }
         }
@@ -652,6 +682,10 @@ bool IR_LCSE::perform(OptCtx & oc)
     for (bbl->get_head(&ctbb); ctbb != bbl->end(); ctbb = bbl->get_next(ctbb)) {
         IRBB * bb = ctbb->val();
         ASSERT0(bb);
+        if (m_changed_bbs != NULL && !m_changed_bbs->is_contain(BB_id(bb))) {
+            //Nothing changed in BB since last run.
+            continue;
+        }
         map_expr2avail_pos.clean();
         map_expr2avail_pr.clean();
         avail_ir_expr.clean();
@@ -675,10 +709,18 @@ bool IR_LCSE::perform(OptCtx & oc)
     ASSERT0(verifyIRandBB(bbl, m_ru));
     if (change) {
         //Found CSE and processed them.
+        //MD reference of new PRs have been allocated, and the
+        //changed stmts have been recorded by DU manager, thus DU chain
+        //can be updated locally on demand.
+        ASSERT0(m_ru->verifyMDRef());
         OC_is_expr_tab_valid(oc) = false;
         OC_is_aa_valid(oc) = false;
         OC_is_du_chain_valid(oc) = false;
-        OC_is_ref_valid(oc) = false;
+        OC_is_du_chain_dirty(oc) = true;
+        OC_is_reach_def_valid(oc) = false;
+        OC_is_avail_reach_def_valid(oc) = false;
+        OC_is_live_expr_valid(oc) = false;
+        OC_is_md_ssa_valid(oc) = false;
     }
     END_TIMER_AFTER(get_pass_name());
     return change;
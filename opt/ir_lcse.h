@@ -48,6 +48,19 @@ protected:
     BSVec<ExpRep*> * m_expr_vec;
     DefMiscBitSetMgr m_misc_bs_mgr;
 
+    //Duplicate the PR that hold the CSE value, MD reference of PR is
+    //copied as well.
+    IR * dupCSEPR(IR const* pr)
+    {
+        IR * x = m_ru->dupIRTree(pr);
+        x->copyRefForTree(pr, m_ru);
+        return x;
+    }
+
+    //Build stmt that stores 'rhs' to 'pr' and insert it before 'pos'.
+    //DU chain of the new stmt will be updated lazily.
+    IR * insertCSEDef(IRBB * bb, IR * pr, IR * rhs, C<IR*> * pos);
+
     IR * hoist_cse(IRBB * bb,  IR * ir_pos, ExpRep * ie);
     bool processUse(IN IRBB * bb, IN IR * ir,
                     IN OUT BitSet & avail_ir_expr,
@@ -87,6 +100,9 @@ public:
     { return "Local Command Subscript Elimination"; }
 
     PASS_TYPE get_pass_type() const { return PASS_LCSE; }
+    virtual UINT get_consumed_fact() const { return FACT_STMT | FACT_EXP; }
+    virtual UINT get_changed_fact() const { return FACT_STMT | FACT_EXP; }
+    virtual bool is_bb_local() const { return true; }
 
     void set_enable_filter(bool is_enable) { m_enable_filter = is_enable; }
     bool perform(OptCtx & oc);
@@ -247,6 +247,7 @@ bool IR_LICM::isUniqueDef(MD const* md)
 
     if (*n > 1) { return false; }
 
+    MutexHolder h(m_md_sys->get_lock());
     MDTab * mdt = m_md_sys->get_md_tab(MD_base(md));
     if (mdt == NULL) { return true; }
 
@@ -759,13 +760,14 @@ bool IR_LICM::doLoopTree(
         OUT bool & du_set_info_changed,
         OUT bool & insert_bb,
         TTab<IR*> & invariant_stmt,
-        TTab<IR*> & invariant_exp)
+        TTab<IR*> & invariant_exp,
+        OptCtx & oc)
 {
     if (li == NULL) { return false; }
     bool doit = false;
     for (LI<IRBB> * tli = li; tli != NULL; tli = LI_next(tli)) {
         doit |= doLoopTree(LI_inner_list(tli), du_set_info_changed,
-                   insert_bb, invariant_stmt, invariant_exp);
+                   insert_bb, invariant_stmt, invariant_exp, oc);
         analysis(tli, invariant_stmt, invariant_exp);
         //dumpInvariantExpStmt(invariant_stmt, invariant_exp);
 
@@ -775,7 +777,8 @@ bool IR_LICM::doLoopTree(
 
         doit = true;
         bool flag;
-        IRBB * prehead = ::findAndInsertPreheader(tli, m_ru, flag, false);
+        IRBB * prehead = ::findAndInsertPreheader(tli, m_ru, flag,
+                                                  false, &oc);
         ASSERT0(prehead);
         insert_bb |= flag;
         if (flag && LI_outer(tli) != NULL) {
@@ -817,7 +820,8 @@ bool IR_LICM::perform(OptCtx & oc)
                              du_set_info_changed,
                              insert_bb,
                              invariant_stmt,
-                             invariant_exp);
+                             invariant_exp,
+                             oc);
     if (change) {
         m_cfg->performMiscOpt(oc);
 
@@ -834,10 +838,8 @@ bool IR_LICM::perform(OptCtx & oc)
         }
 
         if (insert_bb) {
-            //Loop info is maintained, but dom pdom and cdg is changed.
+            //Loop info, dom and pdom are maintained, but cdg is changed.
             OC_is_rpo_valid(oc) = false;
-            OC_is_dom_valid(oc) = false;
-            OC_is_pdom_valid(oc) = false;
             OC_is_cdg_valid(oc) = false;
         }
     }
@@ -59,7 +59,8 @@ protected:
                     OUT bool & du_set_info_changed,
                     OUT bool & insert_bb,
                     TTab<IR*> & invariant_stmt,
-                    TTab<IR*> & invariant_exp);
+                    TTab<IR*> & invariant_exp,
+                    OptCtx & oc);
 
     bool checkDefStmt(
             IR * def,
@@ -86,6 +86,7 @@ public:
 
     virtual CHAR const* get_pass_name() const { return "Loop Convertion"; }
     PASS_TYPE get_pass_type() const { return PASS_LOOP_CVT; }
+    virtual UINT get_consumed_fact() const { return FACT_CFG | FACT_LOOP; }
 
     virtual bool perform(OptCtx & oc);
 };
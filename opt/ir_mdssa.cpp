@@ -0,0 +1,951 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "comopt.h"
+
+namespace xoc {
+
+//Return true if 'x' is the memory operand that MD SSA concerns.
+static inline bool is_md_opnd(IR const* x)
+{
+    if (!x->is_memory_opnd() || x->is_read_pr()) { return false; }
+    if ((x->is_id() || x->is_ld()) &&
+        x->get_parent() != NULL && x->get_parent()->is_lda()) {
+        //The address is taken, memory is not read.
+        return false;
+    }
+    return true;
+}
+
+
+//
+//START MDSSAMgr
+//
+MDSSAMgr::MDSSAMgr(Region * ru)
+{
+    ASSERT0(ru);
+    m_ru = ru;
+    m_md_sys = ru->get_md_sys();
+    m_cfg = ru->get_cfg();
+    ASSERT(m_cfg, ("cfg is not available."));
+    m_is_ssa_constructed = false;
+    m_stamp = 0;
+}
+
+
+void MDSSAMgr::cleanVMD(VMD * v)
+{
+    VMD_uses(v).clean(m_sbs_mgr);
+    VMD_succs(v).clean(m_sbs_mgr);
+}
+
+
+void MDSSAMgr::destroy()
+{
+    for (INT i = 0; i <= m_vmd_vec.get_last_idx(); i++) {
+        VMD * v = m_vmd_vec.get(i);
+        if (v == NULL) { continue; }
+        cleanVMD(v);
+        delete v;
+    }
+    for (INT i = 0; i <= m_def_vec.get_last_idx(); i++) {
+        MDDef * d = m_def_vec.get(i);
+        if (d == NULL) { continue; }
+        if (MDDEF_opnds(d) != NULL) {
+            delete MDDEF_opnds(d);
+        }
+        delete d;
+    }
+    for (INT i = 0; i <= m_ir2vmds.get_last_idx(); i++) {
+        DefSBitSetCore * s = m_ir2vmds.get(i);
+        if (s == NULL) { continue; }
+        s->clean(m_sbs_mgr);
+        delete s;
+    }
+    for (INT i = 0; i <= m_bb2phis.get_last_idx(); i++) {
+        List<MDDef*> * l = m_bb2phis.get(i);
+        if (l != NULL) { delete l; }
+    }
+    m_effect_mds.clean(m_sbs_mgr);
+    m_vmd_vec.clean();
+    m_def_vec.clean();
+    m_ir2vmds.clean();
+    m_bb2phis.clean();
+    m_max_version.clean();
+    m_def_stamp.clean();
+    m_stamp = 0;
+    m_is_ssa_constructed = false;
+}
+
+
+//Allocate a new version of MD.
+//'def': the definition of version, NULL means version 0.
+VMD * MDSSAMgr::allocVMD(UINT mdid, MDDef * def)
+{
+    VMD * v = new VMD();
+    VMD_id(v) = m_vmd_vec.get_last_idx() < 0 ?
+                1 : m_vmd_vec.get_last_idx() + 1;
+    VMD_mdid(v) = mdid;
+    if (def == NULL) {
+        VMD_ver(v) = 0;
+    } else {
+        VMD_ver(v) = m_max_version.get(mdid) + 1;
+        m_max_version.set(mdid, VMD_ver(v));
+    }
+    VMD_def(v) = def;
+    m_vmd_vec.set(VMD_id(v), v);
+    return v;
+}
+
+
+//Allocate MDDef for stmt 'occ', and record it as the successor of
+//version 'prev'.
+MDDef * MDSSAMgr::allocMDDef(IRBB * bb, IR * occ, VMD * prev)
+{
+    ASSERT0(occ && prev);
+    MDDef * d = new MDDef();
+    MDDEF_id(d) = m_def_vec.get_last_idx() < 0 ?
+                  1 : m_def_vec.get_last_idx() + 1;
+    MDDEF_bb(d) = bb;
+    MDDEF_occ(d) = occ;
+    MDDEF_prev(d) = prev;
+    MDDEF_opnds(d) = NULL;
+    MDDEF_result(d) = allocVMD(VMD_mdid(prev), d);
+    m_def_vec.set(MDDEF_id(d), d);
+    VMD_succs(prev).bunion(MDDEF_id(d), m_sbs_mgr);
+    return d;
+}
+
+
+//Allocate phi of MD for BB. The operands are filled during renaming.
+MDDef * MDSSAMgr::allocPhi(UINT mdid, IRBB * bb)
+{
+    MDDef * d = new MDDef();
+    MDDEF_id(d) = m_def_vec.get_last_idx() < 0 ?
+                  1 : m_def_vec.get_last_idx() + 1;
+    MDDEF_bb(d) = bb;
+    MDDEF_occ(d) = NULL;
+    MDDEF_prev(d) = NULL;
+    UINT n = m_cfg->get_in_degree(m_cfg->get_vertex(BB_id(bb)));
+    MDDEF_opnds(d) = new Vector<VMD*>(MAX(n, 1));
+    MDDEF_result(d) = allocVMD(mdid, d);
+    m_def_vec.set(MDDEF_id(d), d);
+
+    List<MDDef*> * phis = m_bb2phis.get(BB_id(bb));
+    if (phis == NULL) {
+        phis = new List<MDDef*>();
+        m_bb2phis.set(BB_id(bb), phis);
+    }
+    phis->append_tail(d);
+    return d;
+}
+
+
+DefSBitSetCore * MDSSAMgr::genIRInfo(IR const* ir)
+{
+    DefSBitSetCore * s = m_ir2vmds.get(IR_id(ir));
+    if (s == NULL) {
+        s = new DefSBitSetCore();
+        m_ir2vmds.set(IR_id(ir), s);
+    }
+    return s;
+}
+
+
+//Collect the effect MDs that stmt defined.
+//MD_ALL_MEM and MD_GLOBAL_MEM are expanded to the effect MDs they
+//covered, PR is excluded because it is handled by PR SSA.
+void MDSSAMgr::collectDefMD(IR const* stmt, OUT DefSBitSetCore & mds)
+{
+    ASSERT0(stmt->is_stmt());
+    MD const* must = stmt->getRefMD();
+    MDSet const* may = stmt->is_region() ?
+        REGION_ru(stmt)->get_may_def() : stmt->getRefMDSet();
+    if ((must != NULL && MD_id(must) == MD_ALL_MEM) ||
+        (may != NULL && may->is_contain_pure(MD_ALL_MEM))) {
+        mds.bunion(m_effect_mds, m_sbs_mgr);
+        return;
+    }
+
+    if (must != NULL && !must->is_pr() &&
+        m_effect_mds.is_contain(MD_id(must))) {
+        mds.bunion(MD_id(must), m_sbs_mgr);
+    }
+    if (may == NULL) { return; }
+
+    SEGIter * iter;
+    for (INT i = may->get_first(&iter); i >= 0; i = may->get_next(i, &iter)) {
+        MD const* md = m_md_sys->get_md(i);
+        ASSERT0(md);
+        if (!md->is_pr() && m_effect_mds.is_contain(i)) {
+            mds.bunion(i, m_sbs_mgr);
+        }
+    }
+    if (may->is_contain_pure(MD_GLOBAL_MEM)) {
+        for (INT i = m_effect_mds.get_first(&iter);
+             i >= 0; i = m_effect_mds.get_next(i, &iter)) {
+            if (m_md_sys->get_md(i)->is_global()) {
+                mds.bunion(i, m_sbs_mgr);
+            }
+        }
+    }
+}
+
+
+//Collect the effect MDs that expression read.
+void MDSSAMgr::collectUseMD(IR const* exp, OUT DefSBitSetCore & mds)
+{
+    ASSERT0(is_md_opnd(exp));
+    MD const* must = exp->get_effect_ref();
+    MDSet const* may = exp->getRefMDSet();
+    if ((must != NULL && MD_id(must) == MD_ALL_MEM) ||
+        (may != NULL && may->is_contain_pure(MD_ALL_MEM))) {
+        mds.bunion(m_effect_mds, m_sbs_mgr);
+        return;
+    }
+
+    if (must != NULL && !must->is_pr()) {
+        ASSERT0(m_effect_mds.is_contain(MD_id(must)));
+        mds.bunion(MD_id(must), m_sbs_mgr);
+    }
+    if (may == NULL) { return; }
+
+    SEGIter * iter;
+    for (INT i = may->get_first(&iter); i >= 0; i = may->get_next(i, &iter)) {
+        if (!m_md_sys->get_md(i)->is_pr()) {
+            mds.bunion(i, m_sbs_mgr);
+        }
+    }
+    if (may->is_contain_pure(MD_GLOBAL_MEM)) {
+        for (INT i = m_effect_mds.get_first(&iter);
+             i >= 0; i = m_effect_mds.get_next(i, &iter)) {
+            if (m_md_sys->get_md(i)->is_global()) {
+                mds.bunion(i, m_sbs_mgr);
+            }
+        }
+    }
+}
+
+
+//Collect the MDs that read by expressions. MD that is only defined
+//but never read does not need version.
+void MDSSAMgr::collectEffectMD()
+{
+    m_effect_mds.clean(m_sbs_mgr);
+    DefSBitSetCore defmds;
+    BBList * bbl = m_ru->get_bb_list();
+    ConstIRPreIter it;
+    C<IRBB*> * ctbb;
+    for (IRBB * bb = bbl->get_head(&ctbb);
+         bb != NULL; bb = bbl->get_next(&ctbb)) {
+        C<IR*> * ct;
+        for (IR * stmt = BB_irlist(bb).get_head(&ct);
+             stmt != NULL; stmt = BB_irlist(bb).get_next(&ct)) {
+            for (IR const* x = it.initRhs(stmt); x != NULL; x = it.next()) {
+                if (!is_md_opnd(x)) { continue; }
+                MD const* must = x->get_effect_ref();
+                if (must != NULL && !must->is_pr()) {
+                    m_effect_mds.bunion(MD_id(must), m_sbs_mgr);
+                }
+                MDSet const* may = x->getRefMDSet();
+                if (may != NULL) {
+                    m_effect_mds.bunion(*may, m_sbs_mgr);
+                }
+            }
+
+            MD const* must = stmt->getRefMD();
+            if (must != NULL) {
+                defmds.bunion(MD_id(must), m_sbs_mgr);
+            }
+            MDSet const* may = stmt->is_region() ?
+                REGION_ru(stmt)->get_may_def() : stmt->getRefMDSet();
+            if (may != NULL) {
+                defmds.bunion(*may, m_sbs_mgr);
+            }
+        }
+    }
+
+    //Expression that reads all memory reads every defined MD.
+    bool all = m_effect_mds.is_contain(MD_ALL_MEM);
+    bool global = m_effect_mds.is_contain(MD_GLOBAL_MEM);
+    SEGIter * iter;
+    for (INT i = defmds.get_first(&iter);
+         i >= 0; i = defmds.get_next(i, &iter)) {
+        MD const* md = m_md_sys->get_md(i);
+        if (all || (global && md->is_global())) {
+            m_effect_mds.bunion(i, m_sbs_mgr);
+        }
+    }
+
+    //Remove PR, it is handled by PR SSA.
+    defmds.clean(m_sbs_mgr);
+    for (INT i = m_effect_mds.get_first(&iter);
+         i >= 0; i = m_effect_mds.get_next(i, &iter)) {
+        if (m_md_sys->get_md(i)->is_pr()) {
+            defmds.bunion(i, m_sbs_mgr);
+        }
+    }
+    m_effect_mds.diff(defmds, m_sbs_mgr);
+    defmds.clean(m_sbs_mgr);
+}
+
+
+//Insert phi for MD.
+//'defbbs': record BBs which defined the MD identified by 'mdid'.
+void MDSSAMgr::placePhiForMD(UINT mdid,
+                             DefSBitSetCore const& defbbs,
+                             DfMgr & dfm,
+                             BitSet & visited,
+                             List<IRBB*> & wl)
+{
+    wl.clean();
+    SEGIter * iter;
+    for (INT i = defbbs.get_first(&iter);
+         i >= 0; i = defbbs.get_next(i, &iter)) {
+        wl.append_tail(m_cfg->get_bb(i));
+    }
+
+    //Phi is placed at the iterated dominance frontier, and BB that
+    //has phi becomes a definition of MD as well.
+    //'visited' records the BBs that have phi of MD.
+    visited.clean();
+    while (wl.get_elem_count() != 0) {
+        IRBB * bb = wl.remove_head();
+        BitSet const* dfcs = dfm.read_df_ctrlset(BB_id(bb));
+        if (dfcs == NULL) { continue; }
+
+        for (INT i = dfcs->get_first(); i >= 0; i = dfcs->get_next(i)) {
+            if (visited.is_contain(i)) { continue; }
+            visited.bunion(i);
+
+            IRBB * ibb = m_cfg->get_bb(i);
+            ASSERT0(ibb);
+            allocPhi(mdid, ibb);
+            wl.append_tail(ibb);
+        }
+    }
+}
+
+
+void MDSSAMgr::placePhi(DfMgr & dfm, Vector<DefSBitSetCore*> & md2defbb)
+{
+    List<IRBB*> wl;
+    BitSet visited;
+    SEGIter * iter;
+    for (INT i = m_effect_mds.get_first(&iter);
+         i >= 0; i = m_effect_mds.get_next(i, &iter)) {
+        DefSBitSetCore * defbbs = md2defbb.get(i);
+        if (defbbs == NULL) { continue; }
+        placePhiForMD(i, *defbbs, dfm, visited, wl);
+    }
+}
+
+
+//Attach the top versions to expressions in rhs of 'stmt'.
+void MDSSAMgr::renameUse(IR * stmt, Vector<Stack<VMD*>*> & md2stack)
+{
+    DefSBitSetCore mds;
+    ConstIRPreIter it;
+    for (IR const* x = it.initRhs(stmt); x != NULL; x = it.next()) {
+        if (!is_md_opnd(x)) { continue; }
+        collectUseMD(x, mds);
+        if (mds.is_empty()) { continue; }
+
+        DefSBitSetCore * info = genIRInfo(x);
+        SEGIter * iter;
+        for (INT i = mds.get_first(&iter); i >= 0; i = mds.get_next(i, &iter)) {
+            VMD * top = md2stack.get(i)->get_top();
+            ASSERT0(top);
+            info->bunion(VMD_id(top), m_sbs_mgr);
+            VMD_uses(top).bunion(IR_id(x), m_sbs_mgr);
+        }
+        mds.clean(m_sbs_mgr);
+    }
+}
+
+
+void MDSSAMgr::renameBB(IRBB * bb, Vector<Stack<VMD*>*> & md2stack)
+{
+    List<MDDef*> * phis = m_bb2phis.get(BB_id(bb));
+    if (phis != NULL) {
+        for (MDDef * d = phis->get_head(); d != NULL; d = phis->get_next()) {
+            md2stack.get(VMD_mdid(MDDEF_result(d)))->push(MDDEF_result(d));
+        }
+    }
+
+    DefSBitSetCore mds;
+    C<IR*> * ct;
+    for (IR * stmt = BB_irlist(bb).get_head(&ct);
+         stmt != NULL; stmt = BB_irlist(bb).get_next(&ct)) {
+        renameUse(stmt, md2stack);
+
+        collectDefMD(stmt, mds);
+        if (mds.is_empty()) { continue; }
+
+        DefSBitSetCore * info = genIRInfo(stmt);
+        SEGIter * iter;
+        for (INT i = mds.get_first(&iter); i >= 0; i = mds.get_next(i, &iter)) {
+            Stack<VMD*> * stk = md2stack.get(i);
+            MDDef * d = allocMDDef(bb, stmt, stk->get_top());
+            info->bunion(VMD_id(MDDEF_result(d)), m_sbs_mgr);
+            stk->push(MDDEF_result(d));
+        }
+        mds.clean(m_sbs_mgr);
+    }
+    renameSuccPhi(bb, md2stack);
+}
+
+
+//Fill the operand of phi in successors of 'bb' with the top versions.
+void MDSSAMgr::renameSuccPhi(IRBB * bb, Vector<Stack<VMD*>*> & md2stack)
+{
+    Vertex * v = m_cfg->get_vertex(BB_id(bb));
+    ASSERT0(v);
+    for (EdgeC * out = VERTEX_out_list(v); out != NULL; out = EC_next(out)) {
+        UINT succid = VERTEX_id(EDGE_to(EC_edge(out)));
+        List<MDDef*> * phis = m_bb2phis.get(succid);
+        if (phis == NULL) { continue; }
+
+        UINT idx = m_cfg->WhichPred(bb, m_cfg->get_bb(succid));
+        for (MDDef * d = phis->get_head(); d != NULL; d = phis->get_next()) {
+            VMD * top = md2stack.get(VMD_mdid(MDDEF_result(d)))->get_top();
+            ASSERT0(top);
+            MDDEF_opnds(d)->set(idx, top);
+            VMD_succs(top).bunion(MDDEF_id(d), m_sbs_mgr);
+        }
+    }
+}
+
+
+//Pop the versions that defined in 'bb'.
+void MDSSAMgr::popVersion(IRBB * bb, Vector<Stack<VMD*>*> & md2stack)
+{
+    C<IR*> * ct;
+    for (IR * stmt = BB_irlist(bb).get_head(&ct);
+         stmt != NULL; stmt = BB_irlist(bb).get_next(&ct)) {
+        DefSBitSetCore const* info = m_ir2vmds.get(IR_id(stmt));
+        if (info == NULL) { continue; }
+        SEGIter * iter;
+        for (INT i = info->get_first(&iter);
+             i >= 0; i = info->get_next(i, &iter)) {
+            VMD * v = m_vmd_vec.get(i);
+            VMD * top = md2stack.get(VMD_mdid(v))->pop();
+            ASSERT0(top && VMD_mdid(top) == VMD_mdid(v));
+            UNUSED(top);
+        }
+    }
+
+    List<MDDef*> * phis = m_bb2phis.get(BB_id(bb));
+    if (phis == NULL) { return; }
+    for (MDDef * d = phis->get_head(); d != NULL; d = phis->get_next()) {
+        VMD * top = md2stack.get(VMD_mdid(MDDEF_result(d)))->pop();
+        ASSERT0(top && VMD_mdid(top) == VMD_mdid(MDDEF_result(d)));
+        UNUSED(top);
+    }
+}
+
+
+//Rename versions in the preorder of dominator tree.
+void MDSSAMgr::rename(Graph & domtree)
+{
+    //Version 0 is the bottom of each stack.
+    Vector<Stack<VMD*>*> md2stack;
+    SEGIter * iter;
+    for (INT i = m_effect_mds.get_first(&iter);
+         i >= 0; i = m_effect_mds.get_next(i, &iter)) {
+        Stack<VMD*> * stk = new Stack<VMD*>();
+        stk->push(allocVMD(i, NULL));
+        md2stack.set(i, stk);
+    }
+
+    IRBB * root = m_cfg->get_entry();
+    ASSERT0(root);
+    BitSet visited;
+    Stack<IRBB*> stk;
+    stk.push(root);
+    IRBB * bb;
+    while ((bb = stk.get_top()) != NULL) {
+        if (!visited.is_contain(BB_id(bb))) {
+            visited.bunion(BB_id(bb));
+            renameBB(bb, md2stack);
+        }
+
+        Vertex const* bbv = domtree.get_vertex(BB_id(bb));
+        ASSERT0(bbv);
+        bool all_visited = true;
+        for (EdgeC const* c = VERTEX_out_list(bbv);
+             c != NULL; c = EC_next(c)) {
+            Vertex * dom_succ = EDGE_to(EC_edge(c));
+            if (!visited.is_contain(VERTEX_id(dom_succ))) {
+                ASSERT0(m_cfg->get_bb(VERTEX_id(dom_succ)));
+                all_visited = false;
+                stk.push(m_cfg->get_bb(VERTEX_id(dom_succ)));
+                break;
+            }
+        }
+
+        if (all_visited) {
+            stk.pop();
+            popVersion(bb, md2stack);
+        }
+    }
+
+    for (INT i = 0; i <= md2stack.get_last_idx(); i++) {
+        Stack<VMD*> * s = md2stack.get(i);
+        if (s == NULL) { continue; }
+        ASSERT0(s->get_elem_count() == 1);
+        delete s;
+    }
+}
+
+
+void MDSSAMgr::construction(OptCtx & oc)
+{
+    START_TIMER_AFTER();
+    destroy();
+    ASSERT(OC_is_ref_valid(oc), ("MD reference is not available"));
+    m_ru->checkValidAndRecompute(&oc, PASS_DOM, PASS_UNDEF);
+    if (m_ru->get_bb_list()->get_elem_count() == 0) {
+        m_is_ssa_constructed = true;
+        OC_is_md_ssa_valid(oc) = true;
+        END_TIMER_AFTER(get_pass_name());
+        return;
+    }
+
+    collectEffectMD();
+
+    //Record the BBs that define each MD.
+    Vector<DefSBitSetCore*> md2defbb;
+    DefSBitSetCore mds;
+    BBList * bbl = m_ru->get_bb_list();
+    C<IRBB*> * ctbb;
+    for (IRBB * bb = bbl->get_head(&ctbb);
+         bb != NULL; bb = bbl->get_next(&ctbb)) {
+        C<IR*> * ct;
+        for (IR * stmt = BB_irlist(bb).get_head(&ct);
+             stmt != NULL; stmt = BB_irlist(bb).get_next(&ct)) {
+            collectDefMD(stmt, mds);
+            SEGIter * iter;
+            for (INT i = mds.get_first(&iter);
+                 i >= 0; i = mds.get_next(i, &iter)) {
+                DefSBitSetCore * defbbs = md2defbb.get(i);
+                if (defbbs == NULL) {
+                    defbbs = new DefSBitSetCore();
+                    md2defbb.set(i, defbbs);
+                }
+                defbbs->bunion(BB_id(bb), m_sbs_mgr);
+            }
+            mds.clean(m_sbs_mgr);
+        }
+    }
+
+    DfMgr dfm(NULL);
+    dfm.build((DGraph&)*m_cfg);
+    placePhi(dfm, md2defbb);
+    for (INT i = 0; i <= md2defbb.get_last_idx(); i++) {
+        DefSBitSetCore * s = md2defbb.get(i);
+        if (s == NULL) { continue; }
+        s->clean(m_sbs_mgr);
+        delete s;
+    }
+
+    DomTree domtree;
+    m_cfg->get_dom_tree(domtree);
+    rename(domtree);
+
+    m_is_ssa_constructed = true;
+    OC_is_md_ssa_valid(oc) = true;
+    ASSERT0(verify());
+    END_TIMER_AFTER(get_pass_name());
+}
+
+
+//Return true if 'stmt' exactly overrides the whole MD.
+bool MDSSAMgr::is_kill(IR const* stmt, UINT mdid) const
+{
+    MD const* must = stmt->getRefMD();
+    if (must == NULL || !must->is_exact()) { return false; }
+    if (MD_id(must) == mdid) { return true; }
+    MD const* md = m_md_sys->read_md(mdid);
+    ASSERT0(md);
+    return must->is_cover(md);
+}
+
+
+void MDSSAMgr::collectDefs(IR const* exp, OUT IRSet & defs)
+{
+    ASSERT0(exp->is_exp() && m_is_ssa_constructed);
+    DefSBitSetCore const* info = m_ir2vmds.get(IR_id(exp));
+    if (info == NULL) { return; }
+
+    UINT stamp = nextStamp();
+    Vector<VMD*> wl;
+    INT top = -1;
+    SEGIter * iter;
+    for (INT i = info->get_first(&iter); i >= 0; i = info->get_next(i, &iter)) {
+        wl.set(++top, m_vmd_vec.get(i));
+    }
+
+    while (top >= 0) {
+        VMD * v = wl.get(top--);
+        ASSERT0(v);
+        MDDef * d = VMD_def(v);
+        if (d == NULL || m_def_stamp.get(MDDEF_id(d)) == stamp) {
+            //Version 0 or visited.
+            continue;
+        }
+        m_def_stamp.set(MDDEF_id(d), stamp);
+
+        if (d->is_phi()) {
+            Vector<VMD*> * opnds = MDDEF_opnds(d);
+            for (INT i = 0; i <= opnds->get_last_idx(); i++) {
+                if (opnds->get(i) != NULL) {
+                    wl.set(++top, opnds->get(i));
+                }
+            }
+            continue;
+        }
+
+        defs.append(MDDEF_occ(d));
+        if (!is_kill(MDDEF_occ(d), VMD_mdid(v))) {
+            //MayDef, the value of previous version may also be read.
+            wl.set(++top, MDDEF_prev(d));
+        }
+    }
+}
+
+
+void MDSSAMgr::collectUses(IR const* def, OUT IRSet & uses)
+{
+    ASSERT0(def->is_stmt() && m_is_ssa_constructed);
+    DefSBitSetCore const* info = m_ir2vmds.get(IR_id(def));
+    if (info == NULL) { return; }
+
+    UINT stamp = nextStamp();
+    Vector<VMD*> wl;
+    INT top = -1;
+    SEGIter * iter;
+    for (INT i = info->get_first(&iter); i >= 0; i = info->get_next(i, &iter)) {
+        wl.set(++top, m_vmd_vec.get(i));
+    }
+
+    while (top >= 0) {
+        VMD * v = wl.get(top--);
+        ASSERT0(v);
+        for (INT i = VMD_uses(v).get_first(&iter);
+             i >= 0; i = VMD_uses(v).get_next(i, &iter)) {
+            uses.bunion(i);
+        }
+
+        for (INT i = VMD_succs(v).get_first(&iter);
+             i >= 0; i = VMD_succs(v).get_next(i, &iter)) {
+            MDDef * d = m_def_vec.get(i);
+            ASSERT0(d);
+            if (m_def_stamp.get(i) == stamp) { continue; }
+            m_def_stamp.set(i, stamp);
+
+            //The value passes through phi and MayDef.
+            if (d->is_phi() || !is_kill(MDDEF_occ(d), VMD_mdid(v))) {
+                wl.set(++top, MDDEF_result(d));
+            }
+        }
+    }
+}
+
+
+//Redirect the uses and successors of version 'from' to 'to'.
+void MDSSAMgr::replaceVersion(VMD * from, VMD * to)
+{
+    ASSERT0(VMD_mdid(from) == VMD_mdid(to));
+    SEGIter * iter;
+    for (INT i = VMD_uses(from).get_first(&iter);
+         i >= 0; i = VMD_uses(from).get_next(i, &iter)) {
+        DefSBitSetCore * info = m_ir2vmds.get(i);
+        ASSERT0(info);
+        info->diff(VMD_id(from), m_sbs_mgr);
+        info->bunion(VMD_id(to), m_sbs_mgr);
+    }
+    VMD_uses(to).bunion(VMD_uses(from), m_sbs_mgr);
+
+    for (INT i = VMD_succs(from).get_first(&iter);
+         i >= 0; i = VMD_succs(from).get_next(i, &iter)) {
+        MDDef * d = m_def_vec.get(i);
+        ASSERT0(d);
+        if (d->is_phi()) {
+            Vector<VMD*> * opnds = MDDEF_opnds(d);
+            for (INT j = 0; j <= opnds->get_last_idx(); j++) {
+                if (opnds->get(j) == from) {
+                    opnds->set(j, to);
+                }
+            }
+        } else {
+            ASSERT0(MDDEF_prev(d) == from);
+            MDDEF_prev(d) = to;
+        }
+    }
+    VMD_succs(to).bunion(VMD_succs(from), m_sbs_mgr);
+}
+
+
+//Remove version 'v' that defined by stmt.
+void MDSSAMgr::removeVersion(VMD * v)
+{
+    MDDef * d = VMD_def(v);
+    ASSERT0(d && !d->is_phi());
+    VMD * prev = MDDEF_prev(d);
+    ASSERT0(prev);
+    VMD_succs(prev).diff(MDDEF_id(d), m_sbs_mgr);
+    replaceVersion(v, prev);
+
+    m_def_vec.set(MDDEF_id(d), NULL);
+    delete d;
+    m_vmd_vec.set(VMD_id(v), NULL);
+    cleanVMD(v);
+    delete v;
+}
+
+
+void MDSSAMgr::removeDef(IR const* ir)
+{
+    ASSERT0(ir->is_stmt());
+    if (!m_is_ssa_constructed) { return; }
+    DefSBitSetCore * info = m_ir2vmds.get(IR_id(ir));
+    if (info == NULL) { return; }
+
+    SEGIter * iter;
+    for (INT i = info->get_first(&iter); i >= 0; i = info->get_next(i, &iter)) {
+        VMD * v = m_vmd_vec.get(i);
+        ASSERT0(v && VMD_def(v) && MDDEF_occ(VMD_def(v)) == ir);
+        removeVersion(v);
+    }
+    info->clean(m_sbs_mgr);
+    delete info;
+    m_ir2vmds.set(IR_id(ir), NULL);
+}
+
+
+void MDSSAMgr::removeUse(IR const* ir)
+{
+    if (!m_is_ssa_constructed) { return; }
+    IR const* x;
+    m_citer.clean();
+    if (ir->is_stmt()) {
+        x = iterRhsInitC(ir, m_citer);
+    } else {
+        x = iterExpInitC(ir, m_citer);
+    }
+    for (; x != NULL; x = iterRhsNextC(m_citer)) {
+        DefSBitSetCore * info = m_ir2vmds.get(IR_id(x));
+        if (info == NULL) { continue; }
+        ASSERT0(x->is_exp());
+
+        SEGIter * iter;
+        for (INT i = info->get_first(&iter);
+             i >= 0; i = info->get_next(i, &iter)) {
+            VMD * v = m_vmd_vec.get(i);
+            ASSERT0(v);
+            VMD_uses(v).diff(IR_id(x), m_sbs_mgr);
+        }
+        info->clean(m_sbs_mgr);
+        delete info;
+        m_ir2vmds.set(IR_id(x), NULL);
+    }
+}
+
+
+size_t MDSSAMgr::count_mem()
+{
+    size_t count = sizeof(MDSSAMgr);
+    count += m_vmd_vec.count_mem();
+    count += m_def_vec.count_mem();
+    count += m_ir2vmds.count_mem();
+    count += m_bb2phis.count_mem();
+    count += m_max_version.count_mem();
+    count += m_def_stamp.count_mem();
+    count += m_effect_mds.count_mem();
+    for (INT i = 0; i <= m_vmd_vec.get_last_idx(); i++) {
+        VMD * v = m_vmd_vec.get(i);
+        if (v == NULL) { continue; }
+        count += sizeof(VMD) - sizeof(DefSBitSetCore) * 2;
+        count += VMD_uses(v).count_mem() + VMD_succs(v).count_mem();
+    }
+    for (INT i = 0; i <= m_def_vec.get_last_idx(); i++) {
+        MDDef * d = m_def_vec.get(i);
+        if (d == NULL) { continue; }
+        count += sizeof(MDDef);
+        if (MDDEF_opnds(d) != NULL) {
+            count += MDDEF_opnds(d)->count_mem();
+        }
+    }
+    for (INT i = 0; i <= m_ir2vmds.get_last_idx(); i++) {
+        DefSBitSetCore const* s = m_ir2vmds.get(i);
+        if (s != NULL) {
+            count += s->count_mem();
+        }
+    }
+    for (INT i = 0; i <= m_bb2phis.get_last_idx(); i++) {
+        List<MDDef*> * l = m_bb2phis.get(i);
+        if (l != NULL) {
+            count += l->count_mem();
+        }
+    }
+    return count;
+}
+
+
+static void dump_vmd(VMD const* v)
+{
+    if (v == NULL) {
+        fprintf(g_tfile, "--");
+        return;
+    }
+    fprintf(g_tfile, "MD%dV%d", VMD_mdid(v), VMD_ver(v));
+}
+
+
+void MDSSAMgr::dump()
+{
+    if (g_tfile == NULL) { return; }
+    fprintf(g_tfile, "\n==---- DUMP %s '%s' ----==",
+            get_pass_name(), m_ru->get_ru_name());
+    BBList * bbl = m_ru->get_bb_list();
+    TypeMgr * tm = m_ru->get_type_mgr();
+    ConstIRPreIter it;
+    C<IRBB*> * ctbb;
+    for (IRBB * bb = bbl->get_head(&ctbb);
+         bb != NULL; bb = bbl->get_next(&ctbb)) {
+        fprintf(g_tfile, "\n--- BB%d ---", BB_id(bb));
+        List<MDDef*> * phis = m_bb2phis.get(BB_id(bb));
+        if (phis != NULL) {
+            for (MDDef * d = phis->get_head(); d != NULL; d = phis->get_next()) {
+                fprintf(g_tfile, "\nMDPhi ");
+                dump_vmd(MDDEF_result(d));
+                fprintf(g_tfile, " <- (");
+                Vector<VMD*> * opnds = MDDEF_opnds(d);
+                for (INT i = 0; i <= opnds->get_last_idx(); i++) {
+                    if (i != 0) { fprintf(g_tfile, ", "); }
+                    dump_vmd(opnds->get(i));
+                }
+                fprintf(g_tfile, ")");
+            }
+        }
+
+        C<IR*> * ct;
+        for (IR * stmt = BB_irlist(bb).get_head(&ct);
+             stmt != NULL; stmt = BB_irlist(bb).get_next(&ct)) {
+            dump_ir(stmt, tm, NULL, false);
+            SEGIter * iter;
+            DefSBitSetCore const* info = m_ir2vmds.get(IR_id(stmt));
+            if (info != NULL) {
+                fprintf(g_tfile, "\n    DEF:");
+                for (INT i = info->get_first(&iter);
+                     i >= 0; i = info->get_next(i, &iter)) {
+                    VMD const* v = m_vmd_vec.get(i);
+                    fprintf(g_tfile, " ");
+                    dump_vmd(v);
+                    fprintf(g_tfile, "(prev:");
+                    dump_vmd(MDDEF_prev(VMD_def(v)));
+                    fprintf(g_tfile, ")");
+                }
+            }
+            for (IR const* x = it.initRhs(stmt); x != NULL; x = it.next()) {
+                info = m_ir2vmds.get(IR_id(x));
+                if (info == NULL) { continue; }
+                fprintf(g_tfile, "\n    USE %s(id:%d):",
+                        IRNAME(x), IR_id(x));
+                for (INT i = info->get_first(&iter);
+                     i >= 0; i = info->get_next(i, &iter)) {
+                    fprintf(g_tfile, " ");
+                    dump_vmd(m_vmd_vec.get(i));
+                }
+            }
+        }
+    }
+    fflush(g_tfile);
+}
+
+
+bool MDSSAMgr::verify()
+{
+    for (INT i = 0; i <= m_vmd_vec.get_last_idx(); i++) {
+        VMD * v = m_vmd_vec.get(i);
+        if (v == NULL) { continue; }
+        ASSERT0(VMD_id(v) == (UINT)i);
+        MDDef * d = VMD_def(v);
+        ASSERT0(d == NULL || MDDEF_result(d) == v);
+        ASSERT0(d == NULL || VMD_ver(v) != 0);
+
+        SEGIter * iter;
+        for (INT j = VMD_uses(v).get_first(&iter);
+             j >= 0; j = VMD_uses(v).get_next(j, &iter)) {
+            IR const* use = m_ru->get_ir(j);
+            ASSERT0(use && use->is_exp());
+            ASSERT0(m_ir2vmds.get(j) && m_ir2vmds.get(j)->is_contain(i));
+            UNUSED(use);
+        }
+        for (INT j = VMD_succs(v).get_first(&iter);
+             j >= 0; j = VMD_succs(v).get_next(j, &iter)) {
+            MDDef * succ = m_def_vec.get(j);
+            ASSERT0(succ);
+            ASSERT0(succ->is_phi() || MDDEF_prev(succ) == v);
+            UNUSED(succ);
+        }
+    }
+
+    for (INT i = 0; i <= m_def_vec.get_last_idx(); i++) {
+        MDDef * d = m_def_vec.get(i);
+        if (d == NULL) { continue; }
+        if (!d->is_phi()) {
+            ASSERT0(MDDEF_prev(d) &&
+                    VMD_succs(MDDEF_prev(d)).is_contain(MDDEF_id(d)));
+            ASSERT0(m_ir2vmds.get(IR_id(MDDEF_occ(d)))->is_contain(
+                    VMD_id(MDDEF_result(d))));
+            continue;
+        }
+        Vector<VMD*> * opnds = MDDEF_opnds(d);
+        ASSERT0(opnds->get_last_idx() + 1 <= (INT)m_cfg->get_in_degree(
+                m_cfg->get_vertex(BB_id(MDDEF_bb(d)))));
+        for (INT j = 0; j <= opnds->get_last_idx(); j++) {
+            VMD * o = opnds->get(j);
+            ASSERT0(o == NULL ||
+                    (VMD_mdid(o) == VMD_mdid(MDDEF_result(d)) &&
+                     VMD_succs(o).is_contain(MDDEF_id(d))));
+            UNUSED(o);
+        }
+    }
+    return true;
+}
+//END MDSSAMgr
+
+} //namespace xoc
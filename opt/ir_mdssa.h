@@ -0,0 +1,226 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef __IR_MDSSA_H__
+#define __IR_MDSSA_H__
+
+namespace xoc {
+
+class MDDef;
+
+//Versioned MD.
+//Each definition of MD generates a new version, and version 0
+//indicates the value of MD before entering region.
+//For each version of each MD, VMD is unique.
+#define VMD_id(v)               ((v)->id)
+#define VMD_mdid(v)             ((v)->mdid)
+#define VMD_ver(v)              ((v)->version)
+#define VMD_def(v)              ((v)->def)
+#define VMD_uses(v)             ((v)->uses)
+#define VMD_succs(v)            ((v)->succs)
+class VMD {
+public:
+    UINT id;
+    UINT mdid;
+    UINT version;
+    MDDef * def; //NULL if it is version 0.
+
+    //Record the id of IR expressions that read the version.
+    DefSBitSetCore uses;
+
+    //Record the id of MDDefs that follow the version, they are
+    //the phis whose operand is the version, and the defs which
+    //override the version.
+    DefSBitSetCore succs;
+};
+
+
+//Definition of versioned MD.
+//It is either a stmt, or a phi at the join point of control flow.
+//A stmt that defines N MDs has N MDDefs, one for each MD.
+//Note stmt may define MD inexactly, e.g: a MayDef, and the uses of
+//the result may also read the value of 'prev', see collectDefs().
+#define MDDEF_id(d)             ((d)->id)
+#define MDDEF_result(d)         ((d)->result)
+#define MDDEF_prev(d)           ((d)->prev)
+#define MDDEF_bb(d)             ((d)->bb)
+#define MDDEF_occ(d)            ((d)->occ)
+#define MDDEF_opnds(d)          ((d)->opnds)
+class MDDef {
+public:
+    UINT id;
+    VMD * result;
+    VMD * prev; //the version that overrode by stmt, NULL for phi.
+    IRBB * bb;
+    IR * occ; //the stmt, NULL for phi.
+
+    //Operands of phi, the i-th operand corresponds to the i-th
+    //predecessor of BB.
+    Vector<VMD*> * opnds;
+
+    bool is_phi() const { return occ == NULL; }
+};
+
+
+//Memory SSA.
+//The class builds SSA form for MDs of memory references other than PR,
+//and records MemoryDef (MDDef of stmt), MemoryUse (expression with
+//versions) and MemoryPhi (MDDef of phi). The SSA form is attached to
+//IR by id, IR itself is not modified.
+//The versions are built on the MDs referenced by DU manager, thus the
+//MD reference must be available before construction. Phi is placed
+//at the iterated dominance frontier computed by DfMgr.
+//Passes that remove IR keep the form up to date through
+//IR_DU_MGR::removeIROutFromDUMgr() and removeUseOutFromDefset().
+//The form has to be reconstructed if CFG or MD reference changed,
+//and it is recorded by OC_is_md_ssa_valid.
+class MDSSAMgr : public Pass {
+protected:
+    Region * m_ru;
+    IR_CFG * m_cfg;
+    MDSystem * m_md_sys;
+    DefMiscBitSetMgr m_sbs_mgr;
+    bool m_is_ssa_constructed;
+    ConstIRIter m_citer; //for tmp use.
+
+    //Map id to VMD.
+    Vector<VMD*> m_vmd_vec;
+
+    //Map id to MDDef.
+    Vector<MDDef*> m_def_vec;
+
+    //Map IR id to the id of versions. Expression records the versions
+    //it reads, stmt records the versions it defines.
+    Vector<DefSBitSetCore*> m_ir2vmds;
+
+    //Record phis for each BB.
+    Vector<List<MDDef*>*> m_bb2phis;
+
+    //Record the version counter for each MD.
+    Vector<UINT> m_max_version;
+
+    //Record the MDs that referenced by expressions.
+    DefSBitSetCore m_effect_mds;
+
+    //Record the stamp of MDDef when it is visited by query.
+    Vector<UINT> m_def_stamp;
+    UINT m_stamp;
+
+    VMD * allocVMD(UINT mdid, MDDef * def);
+    MDDef * allocMDDef(IRBB * bb, IR * occ, VMD * prev);
+    MDDef * allocPhi(UINT mdid, IRBB * bb);
+
+    void cleanVMD(VMD * v);
+    void collectDefMD(IR const* stmt, OUT DefSBitSetCore & mds);
+    void collectUseMD(IR const* exp, OUT DefSBitSetCore & mds);
+    void collectEffectMD();
+
+    DefSBitSetCore * genIRInfo(IR const* ir);
+    bool is_kill(IR const* stmt, UINT mdid) const;
+
+    void placePhi(DfMgr & dfm, Vector<DefSBitSetCore*> & md2defbb);
+    void placePhiForMD(UINT mdid,
+                       DefSBitSetCore const& defbbs,
+                       DfMgr & dfm,
+                       BitSet & visited,
+                       List<IRBB*> & wl);
+    void removeVersion(VMD * v);
+    void rename(Graph & domtree);
+    void renameBB(IRBB * bb, Vector<Stack<VMD*>*> & md2stack);
+    void renameSuccPhi(IRBB * bb, Vector<Stack<VMD*>*> & md2stack);
+    void renameUse(IR * stmt, Vector<Stack<VMD*>*> & md2stack);
+    void popVersion(IRBB * bb, Vector<Stack<VMD*>*> & md2stack);
+    void replaceVersion(VMD * from, VMD * to);
+
+    UINT nextStamp()
+    {
+        m_stamp++;
+        if (m_stamp == 0) {
+            //Stamp overflowed.
+            m_def_stamp.clean();
+            m_stamp = 1;
+        }
+        return m_stamp;
+    }
+public:
+    explicit MDSSAMgr(Region * ru);
+    COPY_CONSTRUCTOR(MDSSAMgr);
+    virtual ~MDSSAMgr() { destroy(); }
+
+    //Collect the stmts that define the value read by expression 'exp'.
+    //The MDDefs are walked from the versions of 'exp' until reaching
+    //the stmt that exactly kills the MD, or the entry of region.
+    void collectDefs(IR const* exp, OUT IRSet & defs);
+
+    //Collect the expressions that read the value defined by stmt 'def'.
+    void collectUses(IR const* def, OUT IRSet & uses);
+
+    void construction(OptCtx & oc);
+    size_t count_mem();
+
+    void destroy();
+    void dump();
+
+    virtual CHAR const* get_pass_name() const
+    { return "MD SSA Manager"; }
+    PASS_TYPE get_pass_type() const { return PASS_MD_SSA_MGR; }
+
+    //Return the versions that 'ir' reads or defines.
+    DefSBitSetCore const* get_vmds(IR const* ir) const
+    { return m_ir2vmds.get(IR_id(ir)); }
+
+    VMD * get_vmd(UINT id) const { return m_vmd_vec.get(id); }
+
+    //Return true if the SSA form is available.
+    bool is_ssa_constructed() const { return m_is_ssa_constructed; }
+
+    //Remove the versions defined by stmt 'ir'. The uses of these
+    //versions will read the versions that overrode by 'ir'.
+    void removeDef(IR const* ir);
+
+    //Remove the expressions in 'ir' from the uses of versions.
+    //If 'ir' is stmt, the expressions of rhs are removed.
+    void removeUse(IR const* ir);
+
+    //Remove stmt 'ir' from SSA form.
+    void removeStmt(IR const* ir)
+    {
+        removeUse(ir);
+        removeDef(ir);
+    }
+
+    bool verify();
+};
+
+} //namespace xoc
+#endif
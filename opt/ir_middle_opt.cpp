@@ -67,6 +67,8 @@ void Region::lowerIRTreeToLowestHeight(OptCtx & oc)
     if (SIMP_changed(&simp)) {
         OC_is_aa_valid(oc) = false;
         OC_is_du_chain_valid(oc) = false;
+        OC_is_du_chain_dirty(oc) = false;
+        OC_is_md_ssa_valid(oc) = false;
         OC_is_reach_def_valid(oc) = false;
         OC_is_avail_reach_def_valid(oc) = false;
     }
@@ -88,6 +90,10 @@ bool Region::performSimplify(OptCtx & oc)
     }
         
     simplifyBBlist(get_bb_list(), &simp);
+    if (SIMP_changed(&simp)) {
+        //Simplification generates new memory operations.
+        OC_is_md_ssa_valid(oc) = false;
+    }
 
     if (g_do_cfg &&
         g_cst_bb_list &&
@@ -0,0 +1,1191 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "prdf.h"
+#include "prssainfo.h"
+#include "ir_ssa.h"
+#include "ir_pre.h"
+
+namespace xoc {
+
+//Return true if 'e' is exception edge.
+static bool isEHEdge(Edge const* e)
+{
+    CFGEdgeInfo * ei = (CFGEdgeInfo*)EDGE_info(e);
+    return ei != NULL && CFGEI_is_eh(ei);
+}
+
+
+//Return true if 'stmt' prevents the expression that may trap from
+//being moved across it. The order of trap and side effect must be kept.
+static bool isTrapBarrier(IR const* stmt)
+{
+    if (stmt->is_may_throw() || stmt->is_calls_stmt()) { return true; }
+    switch (stmt->get_code()) {
+    case IR_STPR:
+    case IR_PHI:
+    case IR_GOTO:
+    case IR_TRUEBR:
+    case IR_FALSEBR:
+    case IR_SWITCH:
+        return false;
+    default: break;
+    }
+    return true;
+}
+
+
+//Return false if 'x' can not be evaluated at other place.
+//'may_trap': set to true if 'x' may trap.
+static bool isMovableNode(IR const* x, IN OUT bool & may_trap)
+{
+    if (IR_has_sideeffect(x)) { return false; }
+    switch (x->get_code()) {
+    case IR_ID:
+        return !x->is_volatile();
+    case IR_LD:
+        if (VAR_is_volatile(LD_idinfo(x))) { return false; }
+        break;
+    case IR_ILD:
+    case IR_ARRAY:
+        may_trap = true;
+        break;
+    case IR_DIV:
+    case IR_REM:
+    case IR_MOD:
+        may_trap = true;
+        return true;
+    default:
+        return true;
+    }
+
+    //Memory operand must have MD reference, otherwise the stmts that
+    //modify the memory can not be determined.
+    MD const* md = x->getRefMD();
+    MDSet const* mds = x->getRefMDSet();
+    if (md == NULL && (mds == NULL || mds->is_empty())) { return false; }
+    return md == NULL || !md->is_volatile();
+}
+
+
+//
+//START IR_PRE
+//
+IR_PRE::IR_PRE(Region * ru)
+{
+    ASSERT0(ru);
+    m_ru = ru;
+    m_cfg = ru->get_cfg();
+    m_du = ru->get_du_mgr();
+    m_md_sys = ru->get_md_sys();
+    ASSERT0(m_cfg && m_du && m_md_sys);
+    m_expr_tab = NULL;
+    m_ssamgr = NULL;
+    m_ver_memo_prno = 0;
+    m_num_cand = 0;
+    m_num_insert = 0;
+    m_num_delete = 0;
+    m_num_save = 0;
+    m_num_split = 0;
+}
+
+
+//Free the resources of last run, the statistics are kept for dump.
+void IR_PRE::clean()
+{
+    for (INT i = 0; i <= m_expr_use.get_last_idx(); i++) {
+        MDSet * mds = m_expr_use.get(i);
+        if (mds == NULL) { continue; }
+        mds->clean(m_misc_bs_mgr);
+        delete mds;
+    }
+    m_expr_use.clean();
+
+    for (INT i = 0; i <= m_expr2tmpl.get_last_idx(); i++) {
+        IR * tmpl = m_expr2tmpl.get(i);
+        if (tmpl != NULL) {
+            m_ru->freeIRTree(tmpl);
+        }
+    }
+    m_expr2tmpl.clean();
+
+    for (INT i = 0; i <= m_expr2defs.get_last_idx(); i++) {
+        delete m_expr2defs.get(i);
+    }
+    m_expr2defs.clean();
+
+    for (INT i = 0; i <= m_expr2uses.get_last_idx(); i++) {
+        delete m_expr2uses.get(i);
+    }
+    m_expr2uses.clean();
+
+    m_universe.clean();
+    m_may_trap.clean();
+    m_bad.clean();
+    m_handled.clean();
+    m_ir2expr.clean();
+    m_expr2occ.clean();
+    m_expr2prno.clean();
+
+    //BitSets of BB and edge are allocated by m_bs_mgr.
+    m_antloc.clean();
+    m_comp.clean();
+    m_transp.clean();
+    m_avout.clean();
+    m_antin.clean();
+    m_antout.clean();
+    m_laterin.clean();
+    m_later.clean();
+    m_bs_mgr.clean();
+
+    m_comp_occ.clean();
+    m_tail_edges.clean();
+    m_fall_edges.clean();
+    m_jump_edges.clean();
+    m_ins_stmts.clean();
+    m_ver_memo.clean();
+    m_ver_memo_bb.clean();
+    m_ver_memo_prno = 0;
+}
+
+
+void IR_PRE::dump()
+{
+    if (g_tfile == NULL) { return; }
+    fprintf(g_tfile, "\n==---- DUMP PRE -- ru:'%s' ----==",
+            m_ru->get_ru_name());
+    fprintf(g_tfile, "\ncandidate expression:%d, eliminated:%d, "
+            "inserted:%d, saved:%d, split edge:%d",
+            m_num_cand, m_num_delete, m_num_insert,
+            m_num_save, m_num_split);
+    fflush(g_tfile);
+}
+
+
+BitSet * IR_PRE::allocBitSet(Vector<BitSet*> & vec, UINT bbid)
+{
+    BitSet * bs = vec.get(bbid);
+    if (bs == NULL) {
+        bs = m_bs_mgr.create();
+        vec.set(bbid, bs);
+    }
+    return bs;
+}
+
+
+//Return the LATER set of edge 'e', it is universe initially.
+BitSet * IR_PRE::getLater(Edge const* e)
+{
+    BitSet * later = m_later.get(e);
+    if (later == NULL) {
+        later = m_bs_mgr.create();
+        later->copy(m_universe);
+        m_later.set(e, later);
+    }
+    return later;
+}
+
+
+//Return the expression that 'occ' corresponds to.
+ExpRep * IR_PRE::getExpr(IR * occ)
+{
+    //The mapping of expression table is keyed by IR id, it may be
+    //stale if stmt has been changed after the table built.
+    ExpRep * ie = m_expr_tab->map_ir2ir_expr(occ);
+    if (ie != NULL && occ->isIREqual(EXPR_ir(ie))) { return ie; }
+    return m_expr_tab->append_expr(occ);
+}
+
+
+//Return the temporary PR that holds the value of expression.
+UINT IR_PRE::getTmpPrno(UINT eid)
+{
+    UINT prno = m_expr2prno.get(eid);
+    if (prno == 0) {
+        ASSERT0(m_expr2tmpl.get(eid));
+        prno = m_ru->buildPrno(m_expr2tmpl.get(eid)->get_type());
+        m_expr2prno.set(eid, prno);
+    }
+    return prno;
+}
+
+
+//Build a reference to the temporary PR of expression.
+IR * IR_PRE::buildTmpPR(UINT eid)
+{
+    IR * pr = m_ru->buildPRdedicated(getTmpPrno(eid),
+                                     m_expr2tmpl.get(eid)->get_type());
+    m_ru->allocRefForPR(pr);
+    m_expr2uses.get(eid)->append_tail(pr);
+    return pr;
+}
+
+
+//Build stmt that saves 'rhs' to the temporary PR of expression.
+IR * IR_PRE::buildTmpStore(UINT eid, IR * rhs)
+{
+    IR * stpr = m_ru->buildStorePR(getTmpPrno(eid),
+                                   m_expr2tmpl.get(eid)->get_type(), rhs);
+    m_ru->allocRefForPR(stpr);
+    IR_may_throw(stpr) = m_may_trap.is_contain(eid);
+    m_expr2defs.get(eid)->append_tail(stpr);
+    return stpr;
+}
+
+
+//Return true if 'ir' is the kind of expression that PRE handles.
+bool IR_PRE::canBeCandidate(IR const* ir) const
+{
+    if (ir->is_mc() || ir->is_void() || IR_has_sideeffect(ir)) {
+        return false;
+    }
+    switch (ir->get_code()) {
+    case IR_LD:
+    case IR_ILD:
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_DIV:
+    case IR_REM:
+    case IR_MOD:
+    case IR_LAND:
+    case IR_LOR:
+    case IR_BAND:
+    case IR_BOR:
+    case IR_XOR:
+    case IR_BNOT:
+    case IR_LNOT:
+    case IR_NEG:
+    case IR_LT:
+    case IR_LE:
+    case IR_GT:
+    case IR_GE:
+    case IR_EQ:
+    case IR_NE:
+    case IR_ASR:
+    case IR_LSR:
+    case IR_LSL:
+    case IR_CVT:
+        return true;
+    default: break;
+    }
+    return false;
+}
+
+
+//Return true if expression 'occ' can be evaluated at other place.
+//'may_trap': set to true if 'occ' may trap.
+bool IR_PRE::is_movable(IR const* occ, OUT bool & may_trap) const
+{
+    may_trap = false;
+    if (!isMovableNode(occ, may_trap)) { return false; }
+
+    //The siblings of 'occ' are not part of the expression, thus walk
+    //through the kids only.
+    ConstIRPreIter it;
+    for (UINT i = 0; i < IR_MAX_KID_NUM(occ); i++) {
+        for (IR const* x = it.init(occ->get_kid(i));
+             x != NULL; x = it.next()) {
+            if (!isMovableNode(x, may_trap)) { return false; }
+        }
+    }
+    return true;
+}
+
+
+//Collect the top level operands of 'stmt' that may be candidates.
+void IR_PRE::collectOcc(IR * stmt, OUT List<IR*> & occs) const
+{
+    switch (stmt->get_code()) {
+    case IR_ST:
+    case IR_STPR:
+        occs.append_tail(stmt->get_rhs());
+        return;
+    case IR_IST:
+        occs.append_tail(IST_base(stmt));
+        occs.append_tail(stmt->get_rhs());
+        return;
+    case IR_CALL:
+    case IR_ICALL:
+        for (IR * p = CALL_param_list(stmt); p != NULL; p = p->get_next()) {
+            occs.append_tail(p);
+        }
+        return;
+    case IR_TRUEBR:
+    case IR_FALSEBR:
+        occs.append_tail(BR_det(stmt));
+        return;
+    case IR_SWITCH:
+        occs.append_tail(SWITCH_vexp(stmt));
+        return;
+    case IR_RETURN:
+        if (RET_exp(stmt) != NULL) {
+            occs.append_tail(RET_exp(stmt));
+        }
+        return;
+    default: return;
+    }
+}
+
+
+//Number the candidate occurrences and compute the MDs that each
+//expression used.
+void IR_PRE::collectExpr()
+{
+    List<IR*> occs;
+    BBList * bbl = m_ru->get_bb_list();
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            occs.clean();
+            collectOcc(ir, occs);
+            for (IR * occ = occs.get_head();
+                 occ != NULL; occ = occs.get_next()) {
+                if (!canBeCandidate(occ)) { continue; }
+
+                ExpRep * ie = getExpr(occ);
+                ASSERT0(ie);
+                UINT eid = EXPR_id(ie);
+                m_ir2expr.set(IR_id(occ), eid);
+                if (!m_universe.is_contain(eid)) {
+                    m_universe.bunion(eid);
+                    m_expr2occ.set(eid, occ);
+                    m_expr_use.set(eid, new MDSet());
+                }
+
+                bool may_trap;
+                if (!is_movable(occ, may_trap)) {
+                    m_bad.bunion(eid);
+                }
+                if (may_trap) {
+                    m_may_trap.bunion(eid);
+                }
+
+                //MD reference of occurrences may be different, union
+                //them to be conservative.
+                m_du->collectMayUseRecursive(occ, *m_expr_use.get(eid),
+                                             true, m_misc_bs_mgr);
+            }
+        }
+    }
+
+    if (m_cfg->has_eh_edge()) {
+        //Expression that may trap could be moved out of try region.
+        m_bad.bunion(m_may_trap);
+    }
+}
+
+
+//Return true if 'stmt' modifies the value of expression 'eid'.
+bool IR_PRE::is_kill(IR const* stmt, UINT eid) const
+{
+    if (stmt->is_region()) { return true; }
+    if (m_may_trap.is_contain(eid) && isTrapBarrier(stmt)) { return true; }
+
+    MDSet const* use = m_expr_use.get(eid);
+    ASSERT0(use);
+    if (use->is_empty()) { return false; }
+
+    MD const* must = stmt->getRefMD();
+    if (must != NULL) {
+        if (must->is_pr()) {
+            if (use->is_contain(must)) { return true; }
+        } else if (use->is_overlap_ex(must, m_md_sys)) {
+            return true;
+        }
+    }
+
+    MDSet const* may = stmt->getRefMDSet();
+    return may != NULL && !may->is_empty() && may->is_intersect(*use);
+}
+
+
+//Compute ANTLOC, COMP and TRANSP of 'bb'.
+//'lastocc': for tmp use, map expression to its last occurrence.
+void IR_PRE::computeLocal(IRBB * bb, Vector<IR*> & lastocc)
+{
+    BitSet * antloc = allocBitSet(m_antloc, BB_id(bb));
+    BitSet * comp = allocBitSet(m_comp, BB_id(bb));
+    BitSet * transp = allocBitSet(m_transp, BB_id(bb));
+    BitSet killed;
+    List<IR*> occs;
+    for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+        occs.clean();
+        collectOcc(ir, occs);
+        for (IR * occ = occs.get_head(); occ != NULL; occ = occs.get_next()) {
+            UINT eid = m_ir2expr.get(IR_id(occ));
+            if (eid == 0) { continue; }
+            if (!killed.is_contain(eid)) {
+                antloc->bunion(eid);
+            }
+            comp->bunion(eid);
+            lastocc.set(eid, occ);
+        }
+
+        //Operands are evaluated before stmt modifies memory.
+        for (INT eid = m_universe.get_first();
+             eid >= 0; eid = m_universe.get_next(eid)) {
+            if (killed.is_contain(eid) && !comp->is_contain(eid)) {
+                continue;
+            }
+            if (is_kill(ir, eid)) {
+                killed.bunion(eid);
+                comp->diff(eid);
+            }
+        }
+    }
+
+    for (INT eid = comp->get_first(); eid >= 0; eid = comp->get_next(eid)) {
+        ASSERT0(lastocc.get(eid));
+        m_comp_occ.bunion(IR_id(lastocc.get(eid)));
+    }
+    transp->copy(m_universe);
+    transp->diff(killed);
+}
+
+
+//Compute AVOUT in forward direction.
+//AVIN(i) = Intersection of AVOUT(p), p is predecessor of i.
+//AVOUT(i) = COMP(i) | (AVIN(i) & TRANSP(i))
+void IR_PRE::computeAvail(List<IRBB*> & rpo)
+{
+    for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+        allocBitSet(m_avout, BB_id(bb))->copy(m_universe);
+    }
+
+    BitSet avin;
+    bool change = true;
+    UINT count = 0;
+    while (change && count < 100) {
+        change = false;
+        for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+            Vertex * v = m_cfg->get_vertex(BB_id(bb));
+            ASSERT0(v);
+            if (BB_is_entry(bb) || VERTEX_in_list(v) == NULL) {
+                avin.clean();
+            } else {
+                avin.copy(m_universe);
+                for (EdgeC * ec = VERTEX_in_list(v);
+                     ec != NULL; ec = EC_next(ec)) {
+                    if (isEHEdge(EC_edge(ec))) {
+                        //Exception may be raised before the computation.
+                        avin.clean();
+                        break;
+                    }
+                    BitSet * pout = m_avout.get(
+                        VERTEX_id(EDGE_from(EC_edge(ec))));
+                    if (pout != NULL) {
+                        avin.intersect(*pout);
+                    }
+                }
+            }
+
+            avin.intersect(*m_transp.get(BB_id(bb)));
+            avin.bunion(*m_comp.get(BB_id(bb)));
+            BitSet * avout = m_avout.get(BB_id(bb));
+            if (!avout->is_equal(avin)) {
+                avout->copy(avin);
+                change = true;
+            }
+        }
+        count++;
+    }
+    ASSERT0(!change);
+}
+
+
+//Compute ANTIN and ANTOUT in backward direction.
+//ANTOUT(i) = Intersection of ANTIN(s), s is successor of i.
+//ANTIN(i) = ANTLOC(i) | (ANTOUT(i) & TRANSP(i))
+void IR_PRE::computeAnt(List<IRBB*> & rpo)
+{
+    for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+        allocBitSet(m_antin, BB_id(bb))->copy(m_universe);
+        allocBitSet(m_antout, BB_id(bb));
+    }
+
+    BitSet antin;
+    bool change = true;
+    UINT count = 0;
+    while (change && count < 100) {
+        change = false;
+        for (IRBB * bb = rpo.get_tail(); bb != NULL; bb = rpo.get_prev()) {
+            Vertex * v = m_cfg->get_vertex(BB_id(bb));
+            ASSERT0(v);
+            BitSet * antout = m_antout.get(BB_id(bb));
+            if (VERTEX_out_list(v) == NULL) {
+                antout->clean();
+            } else {
+                antout->copy(m_universe);
+                for (EdgeC * ec = VERTEX_out_list(v);
+                     ec != NULL; ec = EC_next(ec)) {
+                    if (isEHEdge(EC_edge(ec))) {
+                        //Expression is not evaluated if exception raised.
+                        antout->clean();
+                        break;
+                    }
+                    BitSet * sin = m_antin.get(
+                        VERTEX_id(EDGE_to(EC_edge(ec))));
+                    if (sin != NULL) {
+                        antout->intersect(*sin);
+                    }
+                }
+            }
+
+            antin.copy(*antout);
+            antin.intersect(*m_transp.get(BB_id(bb)));
+            antin.bunion(*m_antloc.get(BB_id(bb)));
+            BitSet * bbantin = m_antin.get(BB_id(bb));
+            if (!bbantin->is_equal(antin)) {
+                bbantin->copy(antin);
+                change = true;
+            }
+        }
+        count++;
+    }
+    ASSERT0(!change);
+}
+
+
+//EARLIEST(i,j) = ANTIN(j) - AVOUT(i) - (TRANSP(i) & ANTOUT(i))
+void IR_PRE::computeEarliest(Edge const* e, OUT BitSet & earliest)
+{
+    UINT from = VERTEX_id(EDGE_from(e));
+    earliest.copy(*m_antin.get(VERTEX_id(EDGE_to(e))));
+    if (!isEHEdge(e)) {
+        earliest.diff(*m_avout.get(from));
+    }
+
+    BitSet tmp;
+    tmp.copy(*m_transp.get(from));
+    tmp.intersect(*m_antout.get(from));
+    earliest.diff(tmp);
+}
+
+
+//Compute LATERIN of BB and LATER of edge in forward direction.
+//LATERIN(j) = Intersection of LATER(i,j), i is predecessor of j.
+//LATER(i,j) = EARLIEST(i,j) | (LATERIN(i) - ANTLOC(i))
+//Region entry has a virtual in-edge whose LATER is ANTIN of entry.
+void IR_PRE::computeLater(List<IRBB*> & rpo)
+{
+    for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+        allocBitSet(m_laterin, BB_id(bb))->copy(m_universe);
+    }
+
+    BitSet in;
+    BitSet earliest;
+    bool change = true;
+    UINT count = 0;
+    while (change && count < 100) {
+        change = false;
+        for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+            Vertex * v = m_cfg->get_vertex(BB_id(bb));
+            ASSERT0(v);
+            if (BB_is_entry(bb) || VERTEX_in_list(v) == NULL) {
+                in.copy(*m_antin.get(BB_id(bb)));
+            } else {
+                in.copy(m_universe);
+            }
+            for (EdgeC * ec = VERTEX_in_list(v);
+                 ec != NULL; ec = EC_next(ec)) {
+                if (m_antin.get(VERTEX_id(EDGE_from(EC_edge(ec)))) == NULL) {
+                    //Predecessor is unreachable.
+                    continue;
+                }
+                in.intersect(*getLater(EC_edge(ec)));
+            }
+
+            BitSet * laterin = m_laterin.get(BB_id(bb));
+            if (!laterin->is_equal(in)) {
+                laterin->copy(in);
+                change = true;
+            }
+
+            in.diff(*m_antloc.get(BB_id(bb)));
+            for (EdgeC * ec = VERTEX_out_list(v);
+                 ec != NULL; ec = EC_next(ec)) {
+                Edge const* e = EC_edge(ec);
+                computeEarliest(e, earliest);
+                earliest.bunion(in);
+                BitSet * later = getLater(e);
+                if (!later->is_equal(earliest)) {
+                    later->copy(earliest);
+                    change = true;
+                }
+            }
+        }
+        count++;
+    }
+    ASSERT0(!change);
+}
+
+
+//Return true if the down boundary stmts at the end of 'bb' modify
+//any expression in 'ins'.
+bool IR_PRE::is_tail_kill(IRBB * bb, BitSet const& ins) const
+{
+    BBIRList & irlst = BB_irlist(bb);
+    C<IR*> * ct;
+    for (irlst.get_tail(&ct); ct != irlst.end(); ct = irlst.get_prev(ct)) {
+        IR * ir = ct->val();
+        if (!bb->is_bb_down_boundary(ir)) { break; }
+        for (INT eid = ins.get_first(); eid >= 0; eid = ins.get_next(eid)) {
+            if (is_kill(ir, eid)) { return true; }
+        }
+    }
+    return false;
+}
+
+
+//Return true if a new BB can be inserted on edge 'e'.
+//'is_fallthrough': set to true if 'e' is fallthrough edge.
+bool IR_PRE::is_splittable(Edge const* e, OUT bool & is_fallthrough)
+{
+    if (isEHEdge(e)) { return false; }
+    IRBB * from = m_cfg->get_bb(VERTEX_id(EDGE_from(e)));
+    IRBB * to = m_cfg->get_bb(VERTEX_id(EDGE_to(e)));
+    ASSERT0(from && to);
+
+    IR * last = BB_last_ir(from);
+    bool is_jump = last != NULL &&
+                   (last->is_goto() || last->is_cond_br()) &&
+                   m_cfg->findBBbyLabel(last->get_label()) == to;
+    is_fallthrough = BB_is_fallthrough(from) &&
+                     m_cfg->get_fallthrough_bb(from) == to;
+
+    //Edge of switch and indirect branch can not be redirected, and
+    //'from' may both jump and fall through to 'to'.
+    return is_jump != is_fallthrough;
+}
+
+
+//Determine the expressions to be transformed and the place that
+//computations are inserted at.
+//Return true if there are expressions to be transformed.
+bool IR_PRE::selectExpr(List<IRBB*> & rpo)
+{
+    //Only the expressions that have redundant occurrence are handled.
+    //DELETE(i) = ANTLOC(i) - LATERIN(i)
+    BitSet del;
+    for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+        del.copy(*m_antloc.get(BB_id(bb)));
+        del.diff(*m_laterin.get(BB_id(bb)));
+        m_handled.bunion(del);
+    }
+    m_handled.diff(m_bad);
+    if (m_handled.is_empty()) { return false; }
+
+    //INSERT(i,j) = LATER(i,j) - LATERIN(j)
+    for (IRBB * bb = rpo.get_head(); bb != NULL; bb = rpo.get_next()) {
+        Vertex * v = m_cfg->get_vertex(BB_id(bb));
+        for (EdgeC * ec = VERTEX_out_list(v); ec != NULL; ec = EC_next(ec)) {
+            Edge const* e = EC_edge(ec);
+            BitSet * ins = getLater(e);
+            ins->diff(*m_laterin.get(VERTEX_id(EDGE_to(e))));
+            ins->intersect(m_handled);
+            if (ins->is_empty()) { continue; }
+
+            if (EC_next(VERTEX_out_list(v)) == NULL && !isEHEdge(e) &&
+                !is_tail_kill(bb, *ins)) {
+                m_tail_edges.append_tail(e);
+                continue;
+            }
+
+            bool is_fallthrough;
+            if (is_splittable(e, is_fallthrough)) {
+                if (is_fallthrough) {
+                    m_fall_edges.append_tail(e);
+                } else {
+                    m_jump_edges.append_tail(e);
+                }
+                continue;
+            }
+
+            //Computation can not be inserted on the edge.
+            m_bad.bunion(*ins);
+        }
+    }
+    m_handled.diff(m_bad);
+    return !m_handled.is_empty();
+}
+
+
+//Replace occurrence 'occ' of 'stmt' with 'pr'.
+void IR_PRE::replaceOcc(IR * stmt, IR * occ, IR * pr)
+{
+    if (stmt->is_cond_br() && BR_det(stmt) == occ) {
+        //Determinate expression of branch must be judgement.
+        IR * det = m_ru->buildJudge(pr);
+        BR_det(stmt) = det;
+        IR_parent(det) = stmt;
+        return;
+    }
+    bool f = stmt->replaceKid(occ, pr, false);
+    CK_USE(f);
+}
+
+
+//Replace redundant occurrences in 'bb' with temporary PR, and save the
+//value of downward exposed occurrences to temporary PR.
+void IR_PRE::rewriteBB(IRBB * bb)
+{
+    //Temporary PR holds the value of expression at the entry of BB if
+    //the upward exposed occurrence is deleted.
+    BitSet valid;
+    valid.copy(*m_antloc.get(BB_id(bb)));
+    valid.diff(*m_laterin.get(BB_id(bb)));
+    valid.intersect(m_handled);
+
+    List<IR*> occs;
+    BBIRList & irlst = BB_irlist(bb);
+    C<IR*> * ct;
+    for (irlst.get_head(&ct); ct != irlst.end(); ct = irlst.get_next(ct)) {
+        IR * ir = ct->val();
+        occs.clean();
+        collectOcc(ir, occs);
+        for (IR * occ = occs.get_head(); occ != NULL; occ = occs.get_next()) {
+            UINT eid = m_ir2expr.get(IR_id(occ));
+            if (eid == 0 || !m_handled.is_contain(eid)) { continue; }
+
+            if (valid.is_contain(eid)) {
+                //The occurrence is redundant.
+                m_du->removeUseOutFromDefset(occ);
+                occ->removeSSAUse();
+                replaceOcc(ir, occ, buildTmpPR(eid));
+                m_ru->freeIRTree(occ);
+                m_num_delete++;
+                continue;
+            }
+
+            if (!m_comp_occ.is_contain(IR_id(occ))) { continue; }
+
+            //The value may be used by the occurrences that after 'bb'.
+            replaceOcc(ir, occ, buildTmpPR(eid));
+            IR * stpr = buildTmpStore(eid, occ);
+            copyDbx(stpr, ir, m_ru);
+            irlst.insert_before(stpr, ct);
+            valid.bunion(eid);
+            m_num_save++;
+        }
+
+        for (INT eid = valid.get_first(); eid >= 0; eid = valid.get_next(eid)) {
+            if (is_kill(ir, eid)) {
+                valid.diff(eid);
+            }
+        }
+    }
+}
+
+
+//Append computations of 'ins' to the end of 'bb'.
+void IR_PRE::insertComp(IRBB * bb, BitSet const& ins)
+{
+    for (INT eid = ins.get_first(); eid >= 0; eid = ins.get_next(eid)) {
+        if (!m_handled.is_contain(eid)) { continue; }
+        IR * tmpl = m_expr2tmpl.get(eid);
+        ASSERT0(tmpl);
+        IR * rhs = m_ru->dupIRTree(tmpl);
+        rhs->copyRefForTree(tmpl, m_ru);
+        IR * stpr = buildTmpStore(eid, rhs);
+        BB_irlist(bb).append_tail_ex(stpr);
+        m_ins_stmts.append_tail(stpr);
+        m_num_insert++;
+    }
+}
+
+
+//Insert new BB on edge 'e', and insert computations into it.
+void IR_PRE::splitEdge(Edge const* e)
+{
+    //Edge 'e' is removed after the insertion.
+    BitSet * ins = getLater(e);
+    IRBB * from = m_cfg->get_bb(VERTEX_id(EDGE_from(e)));
+    IRBB * to = m_cfg->get_bb(VERTEX_id(EDGE_to(e)));
+    BBList * bbl = m_ru->get_bb_list();
+    C<IRBB*> * from_ct = NULL;
+    C<IRBB*> * to_ct = NULL;
+    bbl->find(from, &from_ct);
+    bbl->find(to, &to_ct);
+    ASSERT0(from_ct && to_ct);
+
+    IRBB * newbb = m_ru->allocBB();
+    m_cfg->add_bb(newbb);
+    m_cfg->insertBBbetween(from, from_ct, to, to_ct, newbb);
+    insertComp(newbb, *ins);
+    m_num_split++;
+}
+
+
+//Find the version of PR 'prno' that reaches the stmt of 'ct' in 'bb'.
+//If 'ct' is NULL, find the version at the exit of 'bb'.
+SSAInfo * IR_PRE::findReachVer(UINT prno, IRBB * bb, C<IR*> * ct)
+{
+    if (m_ver_memo_prno != prno) {
+        m_ver_memo_bb.clean();
+        m_ver_memo_prno = prno;
+    }
+
+    BBIRList & irlst = BB_irlist(bb);
+    if (ct != NULL) {
+        for (ct = irlst.get_prev(ct); ct != irlst.end();
+             ct = irlst.get_prev(ct)) {
+            IR * def = ct->val()->getResultPR(prno);
+            if (def != NULL) {
+                ASSERT0(def->get_ssainfo());
+                return def->get_ssainfo();
+            }
+        }
+        IRBB * idom = m_cfg->get_idom(bb);
+        if (idom == NULL || idom == bb) {
+            return m_ssamgr->allocVP(prno, 0);
+        }
+        bb = idom;
+    }
+
+    //Climb up dominator tree until the definition found.
+    List<IRBB*> path;
+    SSAInfo * res = NULL;
+    while (bb != NULL) {
+        if (m_ver_memo_bb.is_contain(BB_id(bb))) {
+            res = m_ver_memo.get(BB_id(bb));
+            break;
+        }
+        path.append_tail(bb);
+
+        BBIRList & lst = BB_irlist(bb);
+        C<IR*> * it;
+        for (lst.get_tail(&it); it != lst.end(); it = lst.get_prev(it)) {
+            IR * def = it->val()->getResultPR(prno);
+            if (def != NULL) {
+                res = def->get_ssainfo();
+                ASSERT0(res);
+                break;
+            }
+        }
+        if (res != NULL) { break; }
+
+        IRBB * idom = m_cfg->get_idom(bb);
+        bb = idom == bb ? NULL : idom;
+    }
+
+    if (res == NULL) {
+        //PR is not defined in region.
+        res = m_ssamgr->allocVP(prno, 0);
+    }
+    for (IRBB * p = path.get_head(); p != NULL; p = path.get_next()) {
+        m_ver_memo_bb.bunion(BB_id(p));
+        m_ver_memo.set(BB_id(p), res);
+    }
+    return res;
+}
+
+
+//Set the versions of PR operands of 'stmt'.
+void IR_PRE::setOpndVer(IR * stmt)
+{
+    IRBB * bb = stmt->get_bb();
+    ASSERT0(bb);
+    C<IR*> * ct = NULL;
+    bool f = BB_irlist(bb).find(stmt, &ct);
+    CK_USE(f);
+
+    IRPreIter it;
+    for (IR * x = it.initRhs(stmt); x != NULL; x = it.next()) {
+        if (!x->is_pr()) { continue; }
+        SSAInfo * ssainfo = findReachVer(PR_no(x), bb, ct);
+        x->set_ssainfo(ssainfo);
+        SSA_uses(ssainfo).append(x);
+    }
+}
+
+
+//Insert PHI of temporary PR at the iterated dominance frontier of
+//the definitions, where the PR is live.
+void IR_PRE::placePhi(UINT eid, DfMgr & dfm, BitSet const& livein,
+                      BitSet & defbbs)
+{
+    UINT prno = getTmpPrno(eid);
+    Type const* type = m_expr2tmpl.get(eid)->get_type();
+    List<IR*> * defs = m_expr2defs.get(eid);
+    List<IRBB*> wl;
+    for (INT i = defbbs.get_first(); i >= 0; i = defbbs.get_next(i)) {
+        wl.append_tail(m_cfg->get_bb(i));
+    }
+
+    BitSet hasphi;
+    while (wl.get_elem_count() != 0) {
+        IRBB * bb = wl.remove_head();
+        BitSet const* df = dfm.read_df_ctrlset(BB_id(bb));
+        if (df == NULL) { continue; }
+        for (INT i = df->get_first(); i >= 0; i = df->get_next(i)) {
+            if (hasphi.is_contain(i) || !livein.is_contain(i)) { continue; }
+            hasphi.bunion(i);
+
+            IRBB * dfbb = m_cfg->get_bb(i);
+            ASSERT0(dfbb);
+            IR * phi = m_ru->buildPhi(prno, type,
+                m_cfg->get_in_degree(m_cfg->get_vertex(i)));
+            m_ru->allocRefForPR(phi);
+            for (IR * opnd = PHI_opnd_list(phi);
+                 opnd != NULL; opnd = opnd->get_next()) {
+                opnd->copyRef(phi, m_ru);
+            }
+            BB_irlist(dfbb).append_head(phi);
+            defs->append_tail(phi);
+
+            if (!defbbs.is_contain(i)) {
+                defbbs.bunion(i);
+                wl.append_tail(dfbb);
+            }
+        }
+    }
+}
+
+
+//Build SSA form for the temporary PR of expression 'eid'.
+void IR_PRE::renameTmpPR(UINT eid, DfMgr & dfm)
+{
+    List<IR*> * defs = m_expr2defs.get(eid);
+    List<IR*> * uses = m_expr2uses.get(eid);
+    ASSERT0(defs && uses);
+    if (uses->get_elem_count() == 0) { return; }
+    UINT prno = getTmpPrno(eid);
+
+    BitSet defbbs;
+    for (IR * d = defs->get_head(); d != NULL; d = defs->get_next()) {
+        defbbs.bunion(BB_id(d->get_bb()));
+    }
+
+    //Compute the BBs where the temporary PR is live at entry.
+    BitSet usestmts;
+    for (IR * u = uses->get_head(); u != NULL; u = uses->get_next()) {
+        usestmts.bunion(IR_id(u->get_stmt()));
+    }
+
+    BitSet livein;
+    BitSet visited;
+    List<IRBB*> wl;
+    for (IR * u = uses->get_head(); u != NULL; u = uses->get_next()) {
+        IRBB * bb = u->get_stmt()->get_bb();
+        if (visited.is_contain(BB_id(bb))) { continue; }
+        visited.bunion(BB_id(bb));
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            if (usestmts.is_contain(IR_id(ir))) {
+                //Use is upward exposed.
+                livein.bunion(BB_id(bb));
+                wl.append_tail(bb);
+                break;
+            }
+            if (ir->is_stpr() && STPR_no(ir) == prno) { break; }
+        }
+    }
+
+    while (wl.get_elem_count() != 0) {
+        IRBB * bb = wl.remove_head();
+        for (EdgeC * ec = VERTEX_in_list(m_cfg->get_vertex(BB_id(bb)));
+             ec != NULL; ec = EC_next(ec)) {
+            UINT pred = VERTEX_id(EDGE_from(EC_edge(ec)));
+            if (livein.is_contain(pred) || defbbs.is_contain(pred)) {
+                continue;
+            }
+            livein.bunion(pred);
+            wl.append_tail(m_cfg->get_bb(pred));
+        }
+    }
+
+    placePhi(eid, dfm, livein, defbbs);
+
+    //Each definition generates a new version.
+    UINT ver = 1;
+    for (IR * d = defs->get_head(); d != NULL; d = defs->get_next()) {
+        VP * vp = m_ssamgr->allocVP(prno, ver++);
+        SSA_def(vp) = d;
+        d->set_ssainfo(vp);
+    }
+
+    //Uses read the version that reaches them.
+    for (IR * u = uses->get_head(); u != NULL; u = uses->get_next()) {
+        IR * stmt = u->get_stmt();
+        C<IR*> * ct = NULL;
+        bool f = BB_irlist(stmt->get_bb()).find(stmt, &ct);
+        CK_USE(f);
+        SSAInfo * ssainfo = findReachVer(prno, stmt->get_bb(), ct);
+        u->set_ssainfo(ssainfo);
+        SSA_uses(ssainfo).append(u);
+    }
+
+    //The i-th operand of PHI corresponds to the i-th predecessor.
+    for (IR * d = defs->get_head(); d != NULL; d = defs->get_next()) {
+        if (!d->is_phi()) { continue; }
+        IR * opnd = PHI_opnd_list(d);
+        for (EdgeC * ec = VERTEX_in_list(m_cfg->get_vertex(BB_id(d->get_bb())));
+             ec != NULL; ec = EC_next(ec), opnd = opnd->get_next()) {
+            ASSERT0(opnd);
+            IRBB * pred = m_cfg->get_bb(VERTEX_id(EDGE_from(EC_edge(ec))));
+            SSAInfo * ssainfo = findReachVer(prno, pred, NULL);
+            opnd->set_ssainfo(ssainfo);
+            SSA_uses(ssainfo).append(opnd);
+        }
+    }
+}
+
+
+//Maintain SSA form after temporary PRs and computations generated.
+void IR_PRE::updateSSA(OptCtx & oc)
+{
+    ASSERT0(m_ssamgr);
+
+    //Dominator is changed if critical edge split.
+    m_ru->checkValidAndRecompute(&oc, PASS_DOM, PASS_UNDEF);
+    DfMgr dfm(m_ssamgr);
+    dfm.build((DGraph&)*m_cfg);
+
+    for (INT eid = m_handled.get_first();
+         eid >= 0; eid = m_handled.get_next(eid)) {
+        renameTmpPR(eid, dfm);
+    }
+
+    //Operands of inserted computation read the versions that reach
+    //the insertion point.
+    for (IR * ir = m_ins_stmts.get_head();
+         ir != NULL; ir = m_ins_stmts.get_next()) {
+        setOpndVer(ir);
+    }
+}
+
+
+bool IR_PRE::perform(OptCtx & oc)
+{
+    START_TIMER_AFTER();
+    m_ru->checkValidAndRecompute(&oc, PASS_CFG, PASS_DU_REF,
+                                 PASS_EXPR_TAB, PASS_RPO, PASS_UNDEF);
+    m_num_cand = 0;
+    m_num_insert = 0;
+    m_num_delete = 0;
+    m_num_save = 0;
+    m_num_split = 0;
+    if (m_ru->get_bb_list()->get_elem_count() == 0) {
+        END_TIMER_AFTER(get_pass_name());
+        return false;
+    }
+
+    m_expr_tab = (IR_EXPR_TAB*)m_ru->get_pass_mgr()->
+                 registerPass(PASS_EXPR_TAB);
+    m_ssamgr = (IR_SSA_MGR*)m_ru->get_pass_mgr()->queryPass(PASS_SSA_MGR);
+    if (m_ssamgr != NULL && !m_ssamgr->is_ssa_constructed()) {
+        m_ssamgr = NULL;
+    }
+
+    clean();
+    collectExpr();
+    m_num_cand = m_universe.get_elem_count();
+
+    List<IRBB*> * rpo = m_cfg->get_bblist_in_rpo();
+    Vector<IR*> lastocc;
+    for (IRBB * bb = rpo->get_head(); bb != NULL; bb = rpo->get_next()) {
+        computeLocal(bb, lastocc);
+    }
+    computeAvail(*rpo);
+    computeAnt(*rpo);
+    computeLater(*rpo);
+
+    if (!selectExpr(*rpo)) {
+        clean();
+        END_TIMER_AFTER(get_pass_name());
+        return false;
+    }
+
+    //Record the expression before occurrences are replaced.
+    for (INT eid = m_handled.get_first();
+         eid >= 0; eid = m_handled.get_next(eid)) {
+        IR * occ = m_expr2occ.get(eid);
+        ASSERT0(occ);
+        IR * tmpl = m_ru->dupIRTree(occ);
+        tmpl->copyRefForTree(occ, m_ru);
+        m_expr2tmpl.set(eid, tmpl);
+        m_expr2defs.set(eid, new List<IR*>());
+        m_expr2uses.set(eid, new List<IR*>());
+    }
+
+    for (IRBB * bb = rpo->get_head(); bb != NULL; bb = rpo->get_next()) {
+        rewriteBB(bb);
+    }
+
+    //Insert computations at the end of predecessors first, the edges
+    //will be changed when BB inserted. Fallthrough edges are split
+    //prior to jump edges, thus the trampoline BB that generated by
+    //splitting jump edge does not take place of the fallthrough edge.
+    for (Edge const* e = m_tail_edges.get_head();
+         e != NULL; e = m_tail_edges.get_next()) {
+        insertComp(m_cfg->get_bb(VERTEX_id(EDGE_from(e))), *getLater(e));
+    }
+    for (Edge const* e = m_fall_edges.get_head();
+         e != NULL; e = m_fall_edges.get_next()) {
+        if (!getLater(e)->is_intersect(m_handled)) { continue; }
+        splitEdge(e);
+    }
+    for (Edge const* e = m_jump_edges.get_head();
+         e != NULL; e = m_jump_edges.get_next()) {
+        if (!getLater(e)->is_intersect(m_handled)) { continue; }
+        splitEdge(e);
+    }
+
+    if (m_num_split != 0) {
+        oc.set_flag_if_cfg_changed();
+        OC_is_cfg_valid(oc) = true; //CFG has been maintained.
+    }
+
+    if (m_ssamgr != NULL) {
+        updateSSA(oc);
+    }
+
+    OC_is_du_chain_valid(oc) = false;
+    OC_is_du_chain_dirty(oc) = false;
+    OC_is_expr_tab_valid(oc) = false;
+    OC_is_live_expr_valid(oc) = false;
+    OC_is_aa_valid(oc) = false;
+    OC_is_md_ssa_valid(oc) = false;
+    OC_is_reach_def_valid(oc) = false;
+    OC_is_avail_reach_def_valid(oc) = false;
+
+    ASSERT0(m_ru->verifyMDRef());
+    ASSERT0(verifyIRandBB(m_ru->get_bb_list(), m_ru));
+    ASSERT0(m_ssamgr == NULL || verifySSAInfo(m_ru));
+    clean();
+    END_TIMER_AFTER(get_pass_name());
+    return true;
+}
+//END IR_PRE
+
+} //namespace xoc
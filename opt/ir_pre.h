@@ -0,0 +1,194 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_PRE_H_
+#define _IR_PRE_H_
+
+namespace xoc {
+
+//Perform Partial Redundancy Elimination by Lazy Code Motion.
+//The pass follows Knoop, Ruthing and Steffen, in the edge based
+//formulation of Drechsler and Stadel. Expressions are numbered by
+//IR_EXPR_TAB. The candidates are the top level operands of stmt,
+//include arithmetic expression, conversion, and load via LD and ILD.
+//An expression is killed by stmt if the MustDef or MayDef of stmt
+//overlaps the MDs that expression used, thus loads are moved only if
+//alias analysis proved that no store in between may modify the memory.
+//Expressions that may trap, e.g: ILD and division, are not moved
+//across stmts that have side effects.
+//
+//The value of expression is held in a temporary PR. The computation
+//is inserted on the CFG edge determined by LCM, critical edge is split
+//if necessary, then the redundant occurrences are replaced with the PR,
+//and the occurrences that reach them save the value to the PR.
+//If PR is in SSA form, PHIs of the temporary PR are placed at the
+//iterated dominance frontier where the PR is live, and SSA info of the
+//new IRs is maintained.
+//NOTE: The pass subsumes GCSE and loop invariant code motion for the
+//expressions it covers, local redundancy is left to LCSE.
+class IR_PRE : public Pass {
+protected:
+    Region * m_ru;
+    IR_CFG * m_cfg;
+    IR_DU_MGR * m_du;
+    MDSystem * m_md_sys;
+    IR_EXPR_TAB * m_expr_tab;
+    IR_SSA_MGR * m_ssamgr; //NULL if PR is not in SSA form.
+    DefMiscBitSetMgr m_misc_bs_mgr;
+    BitSetMgr m_bs_mgr;
+
+    //Candidate expressions that occurred in region.
+    BitSet m_universe;
+
+    //Expressions that may trap.
+    BitSet m_may_trap;
+
+    //Expressions that can not be moved.
+    BitSet m_bad;
+
+    //Expressions that will be transformed.
+    BitSet m_handled;
+
+    //Map IR id of occurrence to expression id.
+    Vector<UINT> m_ir2expr;
+
+    //Map expression id to the MDs that expression used.
+    Vector<MDSet*> m_expr_use;
+
+    //Map expression id to its first occurrence, and to the copy of
+    //the occurrence that used to generate new computation.
+    Vector<IR*> m_expr2occ;
+    Vector<IR*> m_expr2tmpl;
+
+    //Map expression id to temporary PR.
+    Vector<UINT> m_expr2prno;
+
+    //Record the stmts that define temporary PR, and the temporary PRs
+    //that replaced occurrences, for each expression.
+    Vector<List<IR*>*> m_expr2defs;
+    Vector<List<IR*>*> m_expr2uses;
+
+    //Local properties of BB.
+    Vector<BitSet*> m_antloc; //upward exposed expressions.
+    Vector<BitSet*> m_comp; //downward exposed expressions.
+    Vector<BitSet*> m_transp; //expressions that are not killed.
+
+    //Global properties of BB.
+    Vector<BitSet*> m_avout;
+    Vector<BitSet*> m_antin;
+    Vector<BitSet*> m_antout;
+    Vector<BitSet*> m_laterin;
+
+    //Map CFG edge to LATER set, and then to INSERT set.
+    TMap<Edge const*, BitSet*> m_later;
+
+    //Record IR id of the downward exposed occurrences.
+    BitSet m_comp_occ;
+
+    //Edges that computations inserted at.
+    List<Edge const*> m_tail_edges; //inserted at the end of predecessor.
+    List<Edge const*> m_fall_edges; //fallthrough edge to be split.
+    List<Edge const*> m_jump_edges; //jump edge to be split.
+
+    //Stmts that generated by edge insertion.
+    List<IR*> m_ins_stmts;
+
+    //Memoize the version of PR at the exit of BB.
+    Vector<SSAInfo*> m_ver_memo;
+    BitSet m_ver_memo_bb;
+    UINT m_ver_memo_prno;
+
+    //Statistics of last run.
+    UINT m_num_cand; //the number of candidate expressions.
+    UINT m_num_insert; //the number of computations inserted.
+    UINT m_num_delete; //the number of computations eliminated.
+    UINT m_num_save; //the number of computations saved to PR.
+    UINT m_num_split; //the number of critical edges split.
+
+    BitSet * allocBitSet(Vector<BitSet*> & vec, UINT bbid);
+
+    IR * buildTmpPR(UINT eid);
+    IR * buildTmpStore(UINT eid, IR * rhs);
+
+    bool canBeCandidate(IR const* ir) const;
+    void clean();
+    void collectExpr();
+    void collectOcc(IR * stmt, OUT List<IR*> & occs) const;
+    void computeAnt(List<IRBB*> & rpo);
+    void computeAvail(List<IRBB*> & rpo);
+    void computeEarliest(Edge const* e, OUT BitSet & earliest);
+    void computeLater(List<IRBB*> & rpo);
+    void computeLocal(IRBB * bb, Vector<IR*> & lastocc);
+
+    SSAInfo * findReachVer(UINT prno, IRBB * bb, C<IR*> * ct);
+
+    ExpRep * getExpr(IR * occ);
+    BitSet * getLater(Edge const* e);
+    UINT getTmpPrno(UINT eid);
+
+    void insertComp(IRBB * bb, BitSet const& ins);
+    bool is_kill(IR const* stmt, UINT eid) const;
+    bool is_movable(IR const* occ, OUT bool & may_trap) const;
+    bool is_splittable(Edge const* e, OUT bool & is_fallthrough);
+    bool is_tail_kill(IRBB * bb, BitSet const& ins) const;
+
+    void placePhi(UINT eid, DfMgr & dfm, BitSet const& livein,
+                  IN OUT BitSet & defbbs);
+    void renameTmpPR(UINT eid, DfMgr & dfm);
+    void replaceOcc(IR * stmt, IR * occ, IR * pr);
+    void rewriteBB(IRBB * bb);
+    bool selectExpr(List<IRBB*> & rpo);
+    void setOpndVer(IR * stmt);
+    void splitEdge(Edge const* e);
+    void updateSSA(OptCtx & oc);
+public:
+    explicit IR_PRE(Region * ru);
+    COPY_CONSTRUCTOR(IR_PRE);
+    virtual ~IR_PRE() { clean(); }
+
+    void dump();
+
+    virtual CHAR const* get_pass_name() const
+    { return "Partial Redundancy Elimination"; }
+    PASS_TYPE get_pass_type() const { return PASS_PRE; }
+
+    virtual UINT get_consumed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+    virtual UINT get_changed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
+
+    virtual bool perform(OptCtx & oc);
+};
+
+} //namespace xoc
+#endif
@@ -293,10 +293,16 @@ bool IR_RCE::performSimplyRCE(IN OUT bool & cfg_mod)
 bool IR_RCE::perform(OptCtx & oc)
 {
     START_TIMER_AFTER();
-    m_ru->checkValidAndRecompute(&oc, PASS_CFG, PASS_DU_REF, PASS_DU_CHAIN,
-                                 PASS_UNDEF);
+    //RCE itself does not query DU chain, it is only required by GVN.
+    bool need_du_chain = is_use_gvn() || !g_lazy_du_chain;
+    if (need_du_chain) {
+        m_ru->checkValidAndRecompute(&oc, PASS_CFG, PASS_DU_REF,
+                                     PASS_DU_CHAIN, PASS_UNDEF);
+    } else {
+        m_ru->checkValidAndRecompute(&oc, PASS_CFG, PASS_DU_REF, PASS_UNDEF);
+    }
 
-    if (!OC_is_du_chain_valid(oc)) {
+    if (need_du_chain ? !OC_is_du_chain_valid(oc) : !OC_is_ref_valid(oc)) {
         END_TIMER_AFTER(get_pass_name());
         return false;
     }
@@ -326,8 +332,10 @@ bool IR_RCE::perform(OptCtx & oc)
 
         OC_is_expr_tab_valid(oc) = false;
         OC_is_du_chain_valid(oc) = false;
+        OC_is_du_chain_dirty(oc) = false;
         OC_is_ref_valid(oc) = false;
         OC_is_aa_valid(oc) = false;
+        OC_is_md_ssa_valid(oc) = false;
         OC_is_expr_tab_valid(oc) = false;
         OC_is_reach_def_valid(oc) = false;
         OC_is_avail_reach_def_valid(oc) = false;
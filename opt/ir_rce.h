@@ -72,6 +72,8 @@ public:
     { return "Redundant Code Elimination"; }
 
     PASS_TYPE get_pass_type() const { return PASS_RCE; }
+    virtual UINT get_consumed_fact() const
+    { return FACT_STMT | FACT_EXP | FACT_CFG; }
 
     bool is_use_gvn() const { return m_use_gvn; }
 
@@ -2062,7 +2062,8 @@ bool IR_RP::tryPromote(
         TabIter<IR*> & ti,
         TMap<MD const*, IR*> & exact_access,
         TTab<IR*> & inexact_access,
-        List<IR*> & exact_occ_list)
+        List<IR*> & exact_occ_list,
+        OptCtx & oc)
 {
     ASSERT0(li && exit_bb);
     exact_access.clean();
@@ -2093,12 +2094,13 @@ bool IR_RP::tryPromote(
     IRBB * preheader = NULL;
     if (exact_access.get_elem_count() != 0 ||
         inexact_access.get_elem_count() != 0) {
-        preheader = ::findAndInsertPreheader(li, m_ru, m_is_insert_bb, false);
+        preheader = ::findAndInsertPreheader(li, m_ru, m_is_insert_bb,
+                                             false, &oc);
         ASSERT0(preheader);
         IR const* last = BB_last_ir(preheader);
         if (last != NULL && last->is_calls_stmt()) {
             preheader = ::findAndInsertPreheader(li, m_ru,
-                                                m_is_insert_bb, true);
+                                                m_is_insert_bb, true, &oc);
             ASSERT0(preheader);
             ASSERT0(BB_last_ir(preheader) == NULL);
         }
@@ -2129,7 +2131,9 @@ bool IR_RP::tryPromote(
 }
 
 
-bool IR_RP::EvaluableScalarReplacement(List<LI<IRBB> const*> & worklst)
+bool IR_RP::EvaluableScalarReplacement(
+        List<LI<IRBB> const*> & worklst,
+        OptCtx & oc)
 {
     //Record the map between MD and ARRAY access expression.
     TMap<MD const*, IR*> access;
@@ -2146,7 +2150,7 @@ bool IR_RP::EvaluableScalarReplacement(List<LI<IRBB> const*> & worklst)
         if (exit_bb != NULL) {
             //If we did not find a single exit bb, this loop is nontrivial.
             change |= tryPromote(x, exit_bb, ii, ti, exact_access,
-                                 inexact_access, exact_occ_list);
+                                 inexact_access, exact_occ_list, oc);
         }
 
         x = LI_inner_list(x);
@@ -2203,7 +2207,7 @@ bool IR_RP::perform(OptCtx & oc)
         m_gvn->reperform(oc);
     }
 
-    change = EvaluableScalarReplacement(worklst);
+    change = EvaluableScalarReplacement(worklst, oc);
     if (change) {
         //DU reference and du chain has maintained.
         ASSERT0(m_ru->verifyMDRef());
@@ -2219,10 +2223,9 @@ bool IR_RP::perform(OptCtx & oc)
 
     if (m_is_insert_bb) {
         OC_is_cdg_valid(oc) = false;
-        OC_is_dom_valid(oc) = false;
-        OC_is_pdom_valid(oc) = false;
         OC_is_rpo_valid(oc) = false;
-        //Loop info is unchanged.
+        //Loop info is unchanged, dom and pdom are maintained by
+        //findAndInsertPreheader().
     }
 
 FIN:
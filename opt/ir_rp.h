@@ -263,7 +263,8 @@ protected:
     void removeRedundantDUChain(List<IR*> & fixup_list);
     void replaceUseForTree(IR * oldir, IR * newir);
 
-    bool EvaluableScalarReplacement(List<LI<IRBB> const*> & worklst);
+    bool EvaluableScalarReplacement(List<LI<IRBB> const*> & worklst,
+                                    OptCtx & oc);
 
     bool tryPromote(LI<IRBB> const* li,
                     IRBB * exit_bb,
@@ -271,7 +272,8 @@ protected:
                     TabIter<IR*> & ti,
                     TMap<MD const*, IR*> & exact_access,
                     TTab<IR*> & inexact_access,
-                    List<IR*> & exact_occ_list);
+                    List<IR*> & exact_occ_list,
+                    OptCtx & oc);
 
     void * xmalloc(UINT size)
     {
@@ -367,6 +369,7 @@ public:
 
     virtual CHAR const* get_pass_name() const { return "Register Promotion"; }
     PASS_TYPE get_pass_type() const { return PASS_RP; }
+    virtual UINT get_changed_fact() const { return FACT_STMT | FACT_EXP; }
 
     virtual bool perform(OptCtx & oc);
 };
@@ -0,0 +1,536 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+#include "prdf.h"
+#include "prssainfo.h"
+#include "ir_ssa.h"
+#include "ir_mdssa.h"
+#include "ir_gvn.h"
+#include "ir_sgvn.h"
+
+namespace xoc {
+
+//The maximum number of iterations, sparse GVN usually converges
+//in the loop nesting depth plus two iterations.
+#define SGVN_MAX_ITER 100
+
+//
+//START IR_SGVN
+//
+IR_SGVN::IR_SGVN(Region * ru) : IR_GVN(ru)
+{
+    m_ssamgr = NULL;
+    m_mdssamgr = NULL;
+    m_num_iter = 0;
+    m_change = false;
+}
+
+
+void IR_SGVN::clean()
+{
+    //Leaders that are not the VN of any IR are not recycled by
+    //IR_GVN::clean(), return them to free list here.
+    BitSet inlst;
+    for (INT i = 0; i <= m_ir2vn.get_last_idx(); i++) {
+        VN * x = m_ir2vn.get(i);
+        if (x != NULL) {
+            inlst.bunion(VN_id(x));
+        }
+    }
+    for (INT i = 0; i <= m_leader.get_last_idx(); i++) {
+        VN * x = m_leader.get(i);
+        if (x != NULL && !inlst.is_contain(VN_id(x))) {
+            m_free_lst.append_tail(x);
+        }
+    }
+    IR_GVN::clean();
+    m_leader.clean();
+    m_vne2vn.clean();
+    m_num_iter = 0;
+}
+
+
+//Return the VN that 'ir' represents if its value is not congruent
+//to any other IR. The VN is allocated at the first time.
+VN * IR_SGVN::getLeader(IR const* ir, VN_TYPE ty)
+{
+    VN * vn = m_leader.get(IR_id(ir));
+    if (vn == NULL) {
+        vn = newVN();
+        VN_type(vn) = ty;
+        if (ty == VN_OP) {
+            VN_op(vn) = ir->get_code();
+        }
+        m_leader.set(IR_id(ir), vn);
+    }
+    return vn;
+}
+
+
+//Look up value expression in table, the operands of expression
+//are the first 'num' elements of m_opnd_buf.
+//Return the VN of expression, 'ir' becomes the leader of the
+//expression if it is not in table.
+VN * IR_SGVN::hashExp(IR const* ir, IR_TYPE op, UINT attr, UINT num)
+{
+    SVNE ve;
+    ve.op = op;
+    ve.type = ir->get_type();
+    ve.attr = attr;
+    ve.num = num;
+    ve.opnd = num == 0 ? NULL : m_opnd_buf.get_vec();
+    VN * vn = m_vne2vn.get(&ve);
+    if (vn != NULL) { return vn; }
+
+    vn = getLeader(ir, VN_OP);
+    m_vne2vn.setv((OBJTY)&ve, vn);
+    return vn;
+}
+
+
+//PR reads the VN of its SSA definition. The VN is NULL if the
+//definition has not been visited, that means the PR may be congruent
+//to any value.
+VN * IR_SGVN::computePR(IR const* exp)
+{
+    ASSERT0(exp->is_pr());
+    SSAInfo const* info = PR_ssainfo(exp);
+    VN * vn = NULL;
+    if (info == NULL) {
+        vn = getLeader(exp, VN_VAR);
+    } else if (SSA_def(info) == NULL) {
+        //PR is region live-in.
+        MD const* md = exp->getRefMD();
+        ASSERT0(md);
+        vn = registerVNviaMD(md);
+    } else {
+        vn = m_ir2vn.get(IR_id(SSA_def(info)));
+    }
+    setVN(exp, vn);
+    return vn;
+}
+
+
+//Return the VN of value that stored to the memory that 'exp' loads,
+//or NULL if the value is unknown.
+//The value is available if the only version that 'exp' reads is
+//defined by a store which exactly writes the MD of 'exp'.
+VN * IR_SGVN::findStoredVN(IR const* exp)
+{
+    MD const* md = exp->get_exact_ref();
+    if (md == NULL) { return NULL; }
+
+    DefSBitSetCore const* vmds = m_mdssamgr->get_vmds(exp);
+    if (vmds == NULL || vmds->get_elem_count() != 1) { return NULL; }
+
+    SEGIter * iter;
+    VMD * v = m_mdssamgr->get_vmd((UINT)vmds->get_first(&iter));
+    ASSERT0(v);
+    if (VMD_mdid(v) != MD_id(md) ||
+        VMD_def(v) == NULL ||
+        VMD_def(v)->is_phi()) {
+        return NULL;
+    }
+
+    IR const* st = MDDEF_occ(VMD_def(v));
+    ASSERT0(st);
+    switch (IR_code(st)) {
+    case IR_ST:
+    case IR_IST:
+    case IR_STARRAY:
+        break;
+    default: return NULL;
+    }
+
+    if (st->getRefMD() != md || st->get_type() != exp->get_type()) {
+        return NULL;
+    }
+    return m_ir2vn.get(IR_id(st->get_rhs()));
+}
+
+
+//Compute VN for LD, ILD and ARRAY.
+//The load is numbered by its address and the versions it reads.
+VN * IR_SGVN::computeLoad(IR const* exp)
+{
+    //Address expressions are always numbered.
+    switch (IR_code(exp)) {
+    case IR_LD: break;
+    case IR_ILD:
+        computeExp(ILD_base(exp));
+        break;
+    case IR_ARRAY:
+        computeExp(ARR_base(exp));
+        for (IR const* s = ARR_sub_list(exp); s != NULL; s = s->get_next()) {
+            computeExp(s);
+        }
+        break;
+    default: UNREACH();
+    }
+
+    VN * vn = NULL;
+    DefSBitSetCore const* vmds = NULL;
+    if (m_mdssamgr == NULL) {
+        //Memory versions are unknown.
+        vn = getLeader(exp, VN_OP);
+        goto FIN;
+    }
+
+    vn = findStoredVN(exp);
+    if (vn != NULL) { goto FIN; }
+
+    vmds = m_mdssamgr->get_vmds(exp);
+    if (vmds == NULL || vmds->is_empty()) {
+        vn = getLeader(exp, VN_OP);
+        goto FIN;
+    }
+
+    {
+        UINT n = 0;
+        switch (IR_code(exp)) {
+        case IR_LD:
+            m_opnd_buf.set(n++, VAR_id(LD_idinfo(exp)));
+            break;
+        case IR_ILD:
+            {
+                VN const* base = m_ir2vn.get(IR_id(ILD_base(exp)));
+                if (base == NULL) {
+                    vn = getLeader(exp, VN_OP);
+                    goto FIN;
+                }
+                m_opnd_buf.set(n++, VN_id(base));
+            }
+            break;
+        case IR_ARRAY:
+            {
+                VN const* base = m_ir2vn.get(IR_id(ARR_base(exp)));
+                if (base == NULL) {
+                    vn = getLeader(exp, VN_OP);
+                    goto FIN;
+                }
+                m_opnd_buf.set(n++, VN_id(base));
+                m_opnd_buf.set(n++, m_tm->get_bytesize(ARR_elemtype(exp)));
+                for (IR const* s = ARR_sub_list(exp);
+                     s != NULL; s = s->get_next()) {
+                    VN const* sv = m_ir2vn.get(IR_id(s));
+                    if (sv == NULL) {
+                        vn = getLeader(exp, VN_OP);
+                        goto FIN;
+                    }
+                    m_opnd_buf.set(n++, VN_id(sv));
+                }
+            }
+            break;
+        default: UNREACH();
+        }
+
+        SEGIter * iter;
+        for (INT i = vmds->get_first(&iter);
+             i >= 0; i = vmds->get_next((UINT)i, &iter)) {
+            m_opnd_buf.set(n++, (UINT)i);
+        }
+        vn = hashExp(exp, exp->get_code(), exp->get_offset(), n);
+    }
+FIN:
+    setVN(exp, vn);
+    return vn;
+}
+
+
+//Compute VN for expression and its kids.
+//Return NULL if the VN of 'exp' may be congruent to any value.
+VN * IR_SGVN::computeExp(IR const* exp)
+{
+    ASSERT0(exp && !exp->is_stmt());
+    VN * vn = NULL;
+    switch (IR_code(exp)) {
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_DIV:
+    case IR_REM:
+    case IR_MOD:
+    case IR_LAND: //logical and &&
+    case IR_LOR: //logical or ||
+    case IR_BAND: //inclusive and &
+    case IR_BOR: //inclusive or |
+    case IR_XOR: //exclusive or
+    case IR_LT:
+    case IR_LE:
+    case IR_GT:
+    case IR_GE:
+    case IR_EQ: //==
+    case IR_NE: //!=
+    case IR_ASR:
+    case IR_LSR:
+    case IR_LSL:
+        {
+            VN const* v0 = computeExp(BIN_opnd0(exp));
+            VN const* v1 = computeExp(BIN_opnd1(exp));
+            if (v0 == NULL || v1 == NULL) {
+                vn = getLeader(exp, VN_OP);
+                break;
+            }
+
+            //Canonicalize the operands, thus a+b and b+a, a>b and b<a
+            //have the same value expression.
+            IR_TYPE irt = exp->get_code();
+            if (irt == IR_GT) {
+                irt = IR_LT;
+                VN const* t = v0; v0 = v1; v1 = t;
+            } else if (irt == IR_GE) {
+                irt = IR_LE;
+                VN const* t = v0; v0 = v1; v1 = t;
+            } else if (is_commutative(irt) && VN_id(v0) > VN_id(v1)) {
+                VN const* t = v0; v0 = v1; v1 = t;
+            }
+            m_opnd_buf.set(0, VN_id(v0));
+            m_opnd_buf.set(1, VN_id(v1));
+            vn = hashExp(exp, irt, 0, 2);
+        }
+        break;
+    case IR_BNOT: //bitwise not
+    case IR_LNOT: //logical not
+    case IR_NEG: //negative
+    case IR_CVT: //type convertion
+        {
+            VN const* v0 = computeExp(exp->get_kid(0));
+            if (v0 == NULL) {
+                vn = getLeader(exp, VN_OP);
+                break;
+            }
+            m_opnd_buf.set(0, VN_id(v0));
+            vn = hashExp(exp, exp->get_code(), 0, 1);
+        }
+        break;
+    case IR_SELECT:
+        {
+            VN const* v0 = computeExp(SELECT_pred(exp));
+            VN const* v1 = computeExp(SELECT_trueexp(exp));
+            VN const* v2 = computeExp(SELECT_falseexp(exp));
+            if (v0 == NULL || v1 == NULL || v2 == NULL) {
+                vn = getLeader(exp, VN_OP);
+                break;
+            }
+            m_opnd_buf.set(0, VN_id(v0));
+            m_opnd_buf.set(1, VN_id(v1));
+            m_opnd_buf.set(2, VN_id(v2));
+            vn = hashExp(exp, IR_SELECT, 0, 3);
+        }
+        break;
+    case IR_LDA:
+        {
+            VAR * v = LDA_idinfo(exp);
+            if (v->is_string() && !m_is_comp_lda_string) {
+                vn = getLeader(exp, VN_OP);
+                break;
+            }
+            MD const* emd = m_ru->genMDforVAR(v);
+            ASSERT(emd && emd->is_effect(), ("VAR should have effect MD"));
+            m_opnd_buf.set(0, VN_id(registerVNviaMD(emd)));
+            vn = hashExp(exp, IR_LDA, LDA_ofst(exp), 1);
+        }
+        break;
+    case IR_CONST:
+        if (exp->is_int()) {
+            vn = registerVNviaINT(CONST_int_val(exp));
+        } else if (exp->is_mc()) {
+            vn = registerVNviaMC(CONST_int_val(exp));
+        } else if (exp->is_fp()) {
+            vn = m_is_vn_fp ? registerVNviaFP(CONST_fp_val(exp)) :
+                              getLeader(exp, VN_VAR);
+        } else if (exp->is_str()) {
+            vn = registerVNviaSTR(CONST_str_val(exp));
+        } else {
+            ASSERT(0, ("unsupport const type"));
+        }
+        break;
+    case IR_PR:
+        return computePR(exp);
+    case IR_LD:
+    case IR_ILD:
+    case IR_ARRAY:
+        return computeLoad(exp);
+    default:
+        //The value of expression is unknown, number the kids only.
+        for (UINT i = 0; i < IR_MAX_KID_NUM(exp); i++) {
+            for (IR const* k = exp->get_kid(i);
+                 k != NULL; k = k->get_next()) {
+                computeExp(k);
+            }
+        }
+        vn = getLeader(exp, VN_VAR);
+        break;
+    }
+    ASSERT0(vn);
+    setVN(exp, vn);
+    return vn;
+}
+
+
+//The operand that has not been visited is ignored, thus PHI
+//is congruent to its operand if the visited operands are congruent.
+void IR_SGVN::computePhi(IR const* phi)
+{
+    ASSERT0(phi->is_phi());
+    for (IR const* opnd = PHI_opnd_list(phi);
+         opnd != NULL; opnd = opnd->get_next()) {
+        computeExp(opnd);
+    }
+
+    VN * same = NULL;
+    bool is_same = true;
+    bool has_top = false;
+    UINT n = 0;
+    for (IR const* opnd = PHI_opnd_list(phi);
+         opnd != NULL; opnd = opnd->get_next()) {
+        VN * v = m_ir2vn.get(IR_id(opnd));
+        if (v == NULL) {
+            has_top = true;
+            continue;
+        }
+        if (same == NULL) {
+            same = v;
+        } else if (same != v) {
+            is_same = false;
+        }
+        m_opnd_buf.set(n++, VN_id(v));
+    }
+
+    VN * vn = NULL;
+    if (same == NULL || (!is_same && has_top)) {
+        vn = getLeader(phi, VN_VAR);
+    } else if (is_same) {
+        vn = same;
+    } else {
+        //PHIs in same BB with congruent operands are congruent.
+        vn = hashExp(phi, IR_PHI, BB_id(phi->get_bb()), n);
+    }
+    setVN(phi, vn);
+}
+
+
+void IR_SGVN::computeStmt(IR const* stmt)
+{
+    ASSERT0(stmt->is_stmt());
+    if (stmt->is_phi()) {
+        computePhi(stmt);
+        return;
+    }
+
+    for (UINT i = 0; i < IR_MAX_KID_NUM(stmt); i++) {
+        for (IR const* k = stmt->get_kid(i); k != NULL; k = k->get_next()) {
+            computeExp(k);
+        }
+    }
+
+    switch (IR_code(stmt)) {
+    case IR_ST:
+    case IR_STPR:
+    case IR_IST:
+    case IR_STARRAY:
+        {
+            //Stmt has the VN of the value it stores.
+            VN * vn = m_ir2vn.get(IR_id(stmt->get_rhs()));
+            setVN(stmt, vn != NULL ? vn : getLeader(stmt, VN_VAR));
+        }
+        break;
+    default:
+        if (stmt->is_write_pr() || stmt->is_calls_stmt()) {
+            setVN(stmt, getLeader(stmt, VN_VAR));
+        }
+        break;
+    }
+}
+
+
+//Perform sparse GVN.
+//Return true if VN is computed.
+bool IR_SGVN::perform(OptCtx & oc)
+{
+    BBList * bbl = m_ru->get_bb_list();
+    if (bbl->get_elem_count() == 0) { return false; }
+
+    m_ssamgr = (IR_SSA_MGR*)m_ru->get_pass_mgr()->queryPass(PASS_SSA_MGR);
+    if (m_ssamgr == NULL || !m_ssamgr->is_ssa_constructed()) {
+        //The value of PR can not be found through SSA def.
+        m_ssamgr = NULL;
+        return IR_GVN::perform(oc);
+    }
+
+    START_TIMER_AFTER();
+    m_ru->checkValidAndRecompute(&oc, PASS_DU_REF, PASS_RPO, PASS_UNDEF);
+
+    m_mdssamgr = NULL;
+    if (OC_is_md_ssa_valid(oc)) {
+        m_mdssamgr = (MDSSAMgr*)m_ru->get_pass_mgr()->
+            queryPass(PASS_MD_SSA_MGR);
+        if (m_mdssamgr != NULL && !m_mdssamgr->is_ssa_constructed()) {
+            m_mdssamgr = NULL;
+        }
+    }
+
+    clean();
+    List<IRBB*> * rpo = m_cfg->get_bblist_in_rpo();
+    ASSERT0(rpo->get_elem_count() == bbl->get_elem_count());
+    m_change = true;
+    while (m_change && m_num_iter < SGVN_MAX_ITER) {
+        m_change = false;
+
+        //The table only holds the value expressions of current
+        //iteration, stale expressions must not be matched.
+        m_vne2vn.clean();
+        for (IRBB * bb = rpo->get_head(); bb != NULL; bb = rpo->get_next()) {
+            for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+                computeStmt(ir);
+            }
+        }
+        m_num_iter++;
+    }
+
+    if (m_change) {
+        //The optimistic assumption has not been verified.
+        ASSERT(0, ("sparse GVN does not converge"));
+        clean();
+        END_TIMER_AFTER(get_pass_name());
+        return false;
+    }
+
+    END_TIMER_AFTER(get_pass_name());
+    m_is_valid = true;
+    return true;
+}
+//END IR_SGVN
+
+} //namespace xoc
@@ -0,0 +1,188 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef _IR_SGVN_H_
+#define _IR_SGVN_H_
+
+namespace xoc {
+
+//Value expression of sparse GVN.
+//'opnd' records the id of operand VNs, or the id of memory versions
+//that load reads.
+class SVNE {
+public:
+    IR_TYPE op;
+    Type const* type;
+    UINT attr; //offset of memory access, or BB id of PHI.
+    UINT num; //the number of elements in 'opnd'.
+    UINT const* opnd;
+
+    bool is_equ(SVNE const& ve) const
+    {
+        if (op != ve.op || type != ve.type || attr != ve.attr ||
+            num != ve.num) {
+            return false;
+        }
+        for (UINT i = 0; i < num; i++) {
+            if (opnd[i] != ve.opnd[i]) { return false; }
+        }
+        return true;
+    }
+};
+
+
+class SVNE_HF {
+public:
+    UINT get_hash_value(SVNE * x, UINT bucket_size) const
+    {
+        UNUSED(bucket_size);
+        UINT n = ((UINT)x->op << 24) ^ (UINT)(size_t)x->type ^
+                 (x->attr << 8) ^ x->num;
+        for (UINT i = 0; i < x->num; i++) {
+            n = n * 31 + x->opnd[i];
+        }
+        return n;
+    }
+
+    UINT get_hash_value(OBJTY v, UINT bucket_size) const
+    { return get_hash_value((SVNE*)v, bucket_size); }
+
+    bool compare(SVNE * x1, OBJTY x2) const
+    { return x1->is_equ(*(SVNE*)x2); }
+
+    bool compare(SVNE * x1, SVNE * x2) const
+    { return x1->is_equ(*x2); }
+};
+
+
+//Map value expression to VN. The table is cleaned at each iteration,
+//thus the keys are allocated in a pool that is recreated by clean().
+class SVNE2VN : public FlatHMap<SVNE*, VN*, SVNE_HF> {
+protected:
+    SMemPool * m_pool;
+public:
+    SVNE2VN() : FlatHMap<SVNE*, VN*, SVNE_HF>(16)
+    { m_pool = smpoolCreate(sizeof(SVNE) * 16, MEM_COMM); }
+    COPY_CONSTRUCTOR(SVNE2VN);
+    virtual ~SVNE2VN() { smpoolDelete(m_pool); }
+
+    virtual SVNE * create(OBJTY v)
+    {
+        SVNE const* src = (SVNE const*)v;
+        SVNE * ve = (SVNE*)smpoolMalloc(sizeof(SVNE), m_pool);
+        *ve = *src;
+        if (src->num != 0) {
+            UINT * opnd = (UINT*)smpoolMalloc(sizeof(UINT) * src->num,
+                                             m_pool);
+            ::memcpy(opnd, src->opnd, sizeof(UINT) * src->num);
+            ve->opnd = opnd;
+        }
+        return ve;
+    }
+
+    void clean()
+    {
+        FlatHMap<SVNE*, VN*, SVNE_HF>::clean();
+        smpoolDelete(m_pool);
+        m_pool = smpoolCreate(sizeof(SVNE) * 16, MEM_COMM);
+    }
+};
+
+
+//Perform sparse Global Value Numbering on SSA form.
+//The pass follows the RPO algorithm of Simpson, which is the
+//optimistic congruence partitioning of Alpern, Wegman and Zadeck
+//computed by iteration. Each iteration visits BBs in RPO, and looks
+//up the value expression of each IR in a hash table that is cleaned
+//at the beginning of iteration. A PHI whose operands are congruent
+//ignoring the ones not yet visited is congruent to the operand, thus
+//values that are equal through loop can be found. The iteration stops
+//when no VN changed.
+//PR operand reads the VN of its SSA definition. Load reads the VN of
+//the stored value if the only version it reads is defined by a store
+//to the same exact MD, otherwise load is numbered by its address and
+//the versions of MD SSA. Load is not numbered if MD SSA unavailable.
+//The VNs are recorded by IR id, thus passes consume them through the
+//interface of IR_GVN. If PR is not in SSA form, IR_GVN::perform is
+//used instead.
+class IR_SGVN : public IR_GVN {
+protected:
+    IR_SSA_MGR * m_ssamgr;
+    MDSSAMgr * m_mdssamgr; //NULL if MD SSA is unavailable.
+    SVNE2VN m_vne2vn;
+
+    //Map IR id to the VN that IR represents if its value expression
+    //has not been found in table.
+    Vector<VN*> m_leader;
+
+    Vector<UINT> m_opnd_buf; //for tmp use.
+    UINT m_num_iter; //the number of iterations of last run.
+    bool m_change;
+
+    virtual void clean();
+
+    VN * computeExp(IR const* exp);
+    VN * computeLoad(IR const* exp);
+    void computePhi(IR const* phi);
+    VN * computePR(IR const* exp);
+    void computeStmt(IR const* stmt);
+
+    VN * findStoredVN(IR const* exp);
+
+    VN * getLeader(IR const* ir, VN_TYPE ty);
+
+    VN * hashExp(IR const* ir, IR_TYPE op, UINT attr, UINT num);
+
+    void setVN(IR const* ir, VN * vn)
+    {
+        if (m_ir2vn.get(IR_id(ir)) != vn) {
+            m_ir2vn.set(IR_id(ir), vn);
+            m_change = true;
+        }
+    }
+public:
+    explicit IR_SGVN(Region * ru);
+    COPY_CONSTRUCTOR(IR_SGVN);
+    virtual ~IR_SGVN() {}
+
+    virtual CHAR const* get_pass_name() const
+    { return "Sparse Global Value Numbering"; }
+
+    UINT get_num_iter() const { return m_num_iter; }
+
+    virtual bool perform(OptCtx & oc);
+};
+
+
+} //namespace xoc
+#endif
@@ -0,0 +1,261 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#include "cominc.h"
+
+namespace xoc {
+
+#ifdef _COMPACT_IR_
+BYTE * g_ir_slab_tab[IR_SLAB_MAX_NUM];
+
+//Protect the allocation of slab number, regions may be processed
+//concurrently.
+static Mutex g_ir_slab_lock;
+
+//Record the slab numbers that have been freed.
+static List<UINT> g_ir_slab_free_no;
+static UINT g_ir_slab_num = 0;
+
+
+//
+//START IRAILink
+//
+IRAILink & IRAILink::operator = (AIContainer * ai)
+{
+    if (idx == 0 && ai == NULL) { return *this; }
+    IRSlabHeader * h = getIRSlab(this);
+    if (idx == 0) {
+        if (h->ai_tab == NULL) {
+            h->ai_tab = new Vector<AIContainer*>();
+        }
+        idx = (UINT)MAX(h->ai_tab->get_last_idx() + 1, 1);
+    }
+    ASSERT0(h->ai_tab);
+    h->ai_tab->set(idx, ai);
+    return *this;
+}
+//END IRAILink
+
+
+//
+//START IRSlabMgr
+//
+IRSlabMgr::IRSlabMgr()
+{
+    m_cur = NULL;
+    m_cur_ofst = IR_SLAB_SIZE;
+}
+
+
+BYTE * IRSlabMgr::allocSlab()
+{
+    void * p = NULL;
+    #ifdef _WINDOWS_
+    p = _aligned_malloc(IR_SLAB_SIZE, IR_SLAB_SIZE);
+    #else
+    if (posix_memalign(&p, IR_SLAB_SIZE, IR_SLAB_SIZE) != 0) {
+        p = NULL;
+    }
+    #endif
+    ASSERT(p != NULL, ("malloc failed"));
+
+    BYTE * slab = (BYTE*)p;
+    IRSlabHeader * h = (IRSlabHeader*)slab;
+    h->ai_tab = NULL;
+    {
+        MutexHolder lock(&g_ir_slab_lock);
+        if (g_ir_slab_free_no.get_elem_count() != 0) {
+            h->slab_no = g_ir_slab_free_no.remove_head();
+        } else {
+            ASSERT(g_ir_slab_num < IR_SLAB_MAX_NUM, ("too many slabs"));
+            h->slab_no = g_ir_slab_num++;
+        }
+        ASSERT0(g_ir_slab_tab[h->slab_no] == NULL);
+        g_ir_slab_tab[h->slab_no] = slab;
+    }
+    m_slab_list.append_tail(slab);
+    return slab;
+}
+
+
+void IRSlabMgr::freeSlab(BYTE * slab)
+{
+    IRSlabHeader * h = (IRSlabHeader*)slab;
+    if (h->ai_tab != NULL) {
+        delete h->ai_tab;
+    }
+    {
+        MutexHolder lock(&g_ir_slab_lock);
+        ASSERT0(g_ir_slab_tab[h->slab_no] == slab);
+        g_ir_slab_tab[h->slab_no] = NULL;
+        g_ir_slab_free_no.append_tail(h->slab_no);
+    }
+
+    #ifdef _WINDOWS_
+    _aligned_free(slab);
+    #else
+    ::free(slab);
+    #endif
+}
+
+
+IR * IRSlabMgr::alloc(UINT size)
+{
+    size = (size + (1 << IR_SLAB_UNIT_BITS) - 1) &
+           ~((1 << IR_SLAB_UNIT_BITS) - 1);
+    ASSERT0(size <= IR_SLAB_SIZE - sizeof(IRSlabHeader));
+    if (m_cur_ofst + size > IR_SLAB_SIZE) {
+        m_cur = allocSlab();
+
+        //The header is never regarded as IR, thus index 0 is NULL.
+        m_cur_ofst = (sizeof(IRSlabHeader) + (1 << IR_SLAB_UNIT_BITS) - 1) &
+                     ~((1 << IR_SLAB_UNIT_BITS) - 1);
+    }
+    BYTE * p = m_cur + m_cur_ofst;
+    m_cur_ofst += size;
+    ::memset(p, 0, size);
+    return (IR*)p;
+}
+
+
+size_t IRSlabMgr::count_mem() const
+{
+    size_t count = sizeof(IRSlabMgr) + m_slab_list.count_mem();
+    C<BYTE*> * ct;
+    for (BYTE * slab = m_slab_list.get_head(&ct);
+         slab != NULL; slab = m_slab_list.get_next(&ct)) {
+        count += IR_SLAB_SIZE;
+        IRSlabHeader * h = (IRSlabHeader*)slab;
+        if (h->ai_tab != NULL) {
+            count += h->ai_tab->count_mem();
+        }
+    }
+    return count;
+}
+
+
+void IRSlabMgr::destroy()
+{
+    for (BYTE * slab = m_slab_list.remove_head();
+         slab != NULL; slab = m_slab_list.remove_head()) {
+        freeSlab(slab);
+    }
+    m_cur = NULL;
+    m_cur_ofst = IR_SLAB_SIZE;
+}
+//END IRSlabMgr
+#endif
+
+} //namespace xoc
+
+
+#ifdef _COMPACT_IR_
+namespace xcom {
+
+using xoc::IR;
+using xoc::IRLink;
+
+UINT cnt_list(IR const* t)
+{
+    return cnt_list<IR>(t);
+}
+
+
+bool in_list(IR const* head, IR const* p)
+{
+    return in_list<IR>(head, p);
+}
+
+
+IR * get_last(IR * t)
+{
+    return get_last<IR>(t);
+}
+
+
+void add_next(IR ** pheader, IR * t)
+{
+    add_next<IR>(pheader, t);
+}
+
+
+void add_next(IRLink * pheader, IR * t)
+{
+    IR * head = *pheader;
+    add_next<IR>(&head, t);
+    *pheader = head;
+}
+
+
+void add_next(IRLink * pheader, IR ** last, IR * t)
+{
+    IR * head = *pheader;
+    add_next<IR>(&head, last, t);
+    *pheader = head;
+}
+
+
+void remove(IRLink * pheader, IR * t)
+{
+    IR * head = *pheader;
+    remove<IR>(&head, t);
+    *pheader = head;
+}
+
+
+void replace(IRLink * pheader, IR * olds, IR * news)
+{
+    IR * head = *pheader;
+    replace<IR>(&head, olds, news);
+    *pheader = head;
+}
+
+
+IR * removehead(IRLink * pheader)
+{
+    IR * head = *pheader;
+    IR * t = removehead<IR>(&head);
+    *pheader = head;
+    return t;
+}
+
+
+void insertbefore(IRLink * head, IR * marker, IR * t)
+{
+    IR * h = *head;
+    insertbefore<IR>(&h, marker, t);
+    *head = h;
+}
+
+} //namespace xcom
+#endif
@@ -0,0 +1,190 @@
+/*@
+XOC Release License
+
+Copyright (c) 2013-2014, Alibaba Group, All rights reserved.
+
+    compiler@aliexpress.com
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the Su Zhenyu nor the names of its contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT
+OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+author: Su Zhenyu
+@*/
+#ifndef __IR_SLAB_H__
+#define __IR_SLAB_H__
+
+namespace xoc {
+
+class IR;
+class AIContainer;
+
+#ifdef _COMPACT_IR_
+//Compact IR layout.
+//IR of region is allocated in slabs that are aligned to IR_SLAB_SIZE.
+//The links of IR, namely next, prev, parent and kids, are 32-bit
+//indices rather than pointers:
+//    index = slab_no << IR_SLAB_OFST_BITS | offset >> IR_SLAB_UNIT_BITS
+//Slab is registered in global table by its number, thus the index
+//can be decoded without knowing the region that IR belongs to.
+//Index 0 indicates NULL since the header occupies the beginning of
+//each slab.
+//The attached info container is rarely used, it is recorded in the
+//side table of slab, and IR only keeps the index of table entry.
+#define IR_SLAB_UNIT_BITS   3 //IR is aligned in 8 bytes.
+#define IR_SLAB_OFST_BITS   11
+#define IR_SLAB_SIZE        (1 << (IR_SLAB_OFST_BITS + IR_SLAB_UNIT_BITS))
+#define IR_SLAB_MAX_NUM     (1 << (32 - IR_SLAB_OFST_BITS))
+
+class IRSlabHeader {
+public:
+    UINT slab_no;
+
+    //Side table of attached info container. Entry 0 is not used.
+    Vector<AIContainer*> * ai_tab;
+};
+
+//Map slab number to slab.
+extern BYTE * g_ir_slab_tab[IR_SLAB_MAX_NUM];
+
+//Return the header of slab that 'p' located in.
+inline IRSlabHeader * getIRSlab(void const* p)
+{ return (IRSlabHeader*)((size_t)p & ~(size_t)(IR_SLAB_SIZE - 1)); }
+
+inline IR * decodeIRLink(UINT idx)
+{
+    if (idx == 0) { return NULL; }
+    BYTE * slab = g_ir_slab_tab[idx >> IR_SLAB_OFST_BITS];
+    ASSERT0(slab);
+    return (IR*)(slab + ((idx & ((1 << IR_SLAB_OFST_BITS) - 1)) <<
+                         IR_SLAB_UNIT_BITS));
+}
+
+inline UINT encodeIRLink(IR const* ir)
+{
+    if (ir == NULL) { return 0; }
+    IRSlabHeader const* h = getIRSlab(ir);
+    ASSERT(g_ir_slab_tab[h->slab_no] == (BYTE*)h,
+           ("IR is not allocated in slab"));
+    return (h->slab_no << IR_SLAB_OFST_BITS) |
+           ((UINT)((BYTE const*)ir - (BYTE const*)h) >> IR_SLAB_UNIT_BITS);
+}
+
+
+//32-bit link to IR.
+//It behaves as IR pointer, e.g: IR_next(ir) = x; IR_next(ir)->...
+//NOTE: the class must not have constructor since IR is allocated
+//and copied by memory operation.
+class IRLink {
+public:
+    UINT idx;
+
+    operator IR*() const { return decodeIRLink(idx); }
+    IR * operator->() const { return decodeIRLink(idx); }
+    IRLink & operator = (IR * ir)
+    {
+        idx = encodeIRLink(ir);
+        return *this;
+    }
+};
+
+
+//Index of attached info container in the side table of slab.
+//It behaves as AIContainer pointer, e.g: IR_ai(ir) = ai; IR_ai(ir)->...
+//NOTE: the object is only meaningful as a field of IR, because the
+//side table is located by the address of the object.
+class IRAILink {
+public:
+    UINT idx; //0 if there is no container.
+
+    AIContainer * get() const
+    {
+        if (idx == 0) { return NULL; }
+        IRSlabHeader const* h = getIRSlab(this);
+        ASSERT0(h->ai_tab);
+        return h->ai_tab->get(idx);
+    }
+
+    operator AIContainer*() const { return get(); }
+    AIContainer * operator->() const { return get(); }
+    IRAILink & operator = (AIContainer * ai);
+    IRAILink & operator = (IRAILink const& src) { return *this = src.get(); }
+};
+
+typedef UINT IRAISlot;
+
+//Raw value of the field of attached info container. It is used to
+//preserve the field while IR is copied or cleaned by memory operation.
+#define IR_ai_slot(ir)      ((ir)->attach_info_container.idx)
+
+
+//Allocate IR in slabs.
+//Each region has its own slab manager, the slabs are freed when
+//the region is destroyed.
+class IRSlabMgr {
+    COPY_CONSTRUCTOR(IRSlabMgr);
+    List<BYTE*> m_slab_list;
+    BYTE * m_cur;
+    UINT m_cur_ofst; //offset of free space in current slab.
+
+    BYTE * allocSlab();
+    void freeSlab(BYTE * slab);
+public:
+    IRSlabMgr();
+    ~IRSlabMgr() { destroy(); }
+
+    //Allocate zero-initialized memory for IR.
+    IR * alloc(UINT size);
+
+    size_t count_mem() const;
+    void destroy();
+};
+#else
+typedef IR * IRLink;
+typedef AIContainer * IRAILink;
+typedef AIContainer * IRAISlot;
+#define IR_ai_slot(ir)      ((ir)->attach_info_container)
+#endif
+
+} //namespace xoc
+
+#ifdef _COMPACT_IR_
+namespace xcom {
+
+//List operations on IR list that held by IRLink.
+//The list templates can not deduce the element type from IRLink,
+//these functions decode the head and then apply the templates.
+UINT cnt_list(xoc::IR const* t);
+bool in_list(xoc::IR const* head, xoc::IR const* p);
+xoc::IR * get_last(xoc::IR * t);
+void add_next(xoc::IR ** pheader, xoc::IR * t);
+void add_next(xoc::IRLink * pheader, xoc::IR * t);
+void add_next(xoc::IRLink * pheader, xoc::IR ** last, xoc::IR * t);
+void remove(xoc::IRLink * pheader, xoc::IR * t);
+void replace(xoc::IRLink * pheader, xoc::IR * olds, xoc::IR * news);
+xoc::IR * removehead(xoc::IRLink * pheader);
+void insertbefore(xoc::IRLink * head, xoc::IR * marker, xoc::IR * t);
+
+} //namespace xcom
+#endif
+#endif
@@ -92,33 +92,27 @@ void DfMgr::dump(DGraph & g)
 
 
 //This function compute dominance frontier to graph g.
+//The frontier is computed by walking up the dominator tree from each
+//predecessor of vertex until reaching the idom of vertex, thus only
+//idom is required rather than the dominator set.
 void DfMgr::build(DGraph & g)
 {
     INT c;
     for (Vertex const* v = g.get_first_vertex(c);
          v != NULL; v = g.get_next_vertex(c)) {
-        BitSet const* v_dom = g.get_dom_set(v);
-        ASSERT0(v_dom != NULL);
         UINT vid = VERTEX_id(v);
+        UINT idom = g.get_idom(vid);
 
         //Access each preds
         EdgeC const* ec = VERTEX_in_list(v);
         while (ec != NULL) {
             Vertex const* pred = EDGE_from(EC_edge(ec));
-            BitSet * pred_df = get_df_ctrlset(pred);
-            if (pred == v || g.get_idom(vid) != VERTEX_id(pred)) {
-                pred_df->bunion(vid);
-            }
-
-            BitSet const* pred_dom = g.get_dom_set(pred);
-            ASSERT0(pred_dom != NULL);
-            for (INT i = pred_dom->get_first();
-                 i >= 0; i = pred_dom->get_next(i)) {
-                if (!v_dom->is_contain(i)) {
-                    Vertex const* pred_dom_v = g.get_vertex(i);
-                    ASSERT0(pred_dom_v != NULL);
-                    get_df_ctrlset(pred_dom_v)->bunion(vid);
-                }
+            for (UINT runner = VERTEX_id(pred);
+                 runner != 0 && runner != idom;
+                 runner = g.get_idom(runner)) {
+                Vertex const* runner_v = g.get_vertex(runner);
+                ASSERT0(runner_v != NULL);
+                get_df_ctrlset(runner_v)->bunion(vid);
             }
             ec = EC_next(ec);
         }
@@ -1769,6 +1763,7 @@ void IR_SSA_MGR::construction(OptCtx & oc)
     construction(domtree);
 
     OC_is_du_chain_valid(oc) = false; //DU chain of PR is voilated.
+    OC_is_du_chain_dirty(oc) = false;
     m_is_ssa_constructed = true;
 }
 
@@ -104,6 +104,10 @@ IRBB * findSingleBackedgeStartBB(LI<IRBB> const* li, IR_CFG * cfg)
 //'force': force to insert preheader BB whatever it has exist.
 //    Return the new BB if insertion is successful.
 //
+//'oc': if it is not NULL, dominator and post-dominator are updated
+//    locally after the new BB inserted, otherwise caller has to
+//    invalidate them.
+//
 //Note if we find the preheader, the last IR of it may be call.
 //So if you are going to insert IR at the tail of preheader, the best is
 //force to insert a new bb.
@@ -111,7 +115,8 @@ IRBB * findAndInsertPreheader(
         LI<IRBB> const* li,
         Region * ru,
         OUT bool & insert_bb,
-        bool force)
+        bool force,
+        OptCtx * oc)
 {
     ASSERT0(li && ru);
     insert_bb = false;
@@ -160,6 +165,15 @@ IRBB * findAndInsertPreheader(
         BB_is_fallthrough(newbb) = true;
     }
 
+    if (oc != NULL) {
+        if (cfg->get_vertex(BB_id(newbb)) != NULL) {
+            cfg->updateDomForInsertedBB(newbb, head, *oc);
+        } else {
+            OC_is_dom_valid(*oc) = false;
+            OC_is_pdom_valid(*oc) = false;
+        }
+    }
+
     //Move LabelInfo from head to prehead except the LabelInfo which are the
     //target of IR which belongs to loop body.
     List<LabelInfo const*> & lablst = head->getLabelList();
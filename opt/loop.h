@@ -77,7 +77,8 @@ class IR_CFG;
 
 IRBB * findAndInsertPreheader(
             LI<IRBB> const* li, Region * ru,
-            OUT bool & insert_bb, bool force);
+            OUT bool & insert_bb, bool force,
+            OptCtx * oc = NULL);
 IRBB * findSingleBackedgeStartBB(LI<IRBB> const* li, IR_CFG * cfg);
 bool findTwoSuccessorBBOfLoopHeader(
             LI<IRBB> const* li, IR_CFG * cfg,
@@ -131,6 +131,110 @@ void MD::dump(TypeMgr * dm) const
 //END MD
 
 
+//
+//START OffsetTab
+//
+static inline ULONGLONG get_md_end(MD const* md)
+{
+    return (ULONGLONG)MD_ofst(md) + (ULONGLONG)MD_size(md);
+}
+
+
+//Compute the max end of MDs in [l, r) of m_sorted, and record the
+//max end of each subtree at its root.
+ULONGLONG OffsetTab::buildMaxEnd(UINT l, UINT r)
+{
+    if (l >= r) { return 0; }
+    UINT mid = (l + r) >> 1;
+    ULONGLONG end = get_md_end(m_sorted.get(mid));
+    end = MAX(end, buildMaxEnd(l, mid));
+    end = MAX(end, buildMaxEnd(mid + 1, r));
+    m_max_end.set(mid, end);
+    return end;
+}
+
+
+void OffsetTab::buildIndex()
+{
+    m_sorted.clean();
+    m_max_end.clean();
+    UINT n = 0;
+    ConstMDIter iter;
+    for (MD const* md = get_first(iter, NULL);
+         md != NULL; md = get_next(iter, NULL)) {
+        //The table is ordered by MD_ofst at first.
+        ASSERT0(n == 0 || MD_ofst(m_sorted.get(n - 1)) <= MD_ofst(md));
+        m_sorted.set(n, md);
+        n++;
+    }
+    buildMaxEnd(0, n);
+    m_is_index_valid = true;
+    m_num_build++;
+}
+
+
+//Walk through the subtree that consists of [l, r) of m_sorted, and
+//record the MDs that overlapped with 'md' into 'res'.
+void OffsetTab::queryIndex(UINT l, UINT r, MD const* md,
+                           OUT Vector<MD const*> & res, IN OUT UINT & num)
+{
+    ULONGLONG start = MD_ofst(md);
+    ULONGLONG end = get_md_end(md);
+    while (l < r) {
+        UINT mid = (l + r) >> 1;
+        if (m_max_end.get(mid) <= start) {
+            //None of MDs in subtree reaches the range of 'md'.
+            return;
+        }
+        queryIndex(l, mid, md, res, num);
+
+        MD const* t = m_sorted.get(mid);
+        m_num_visit++;
+        if ((ULONGLONG)MD_ofst(t) >= end) {
+            //MDs in right subtree start after the range of 'md'.
+            return;
+        }
+        if (t != md && md->is_overlap(t)) {
+            res.set(num, t);
+            num++;
+        }
+        l = mid + 1;
+    }
+}
+
+
+UINT OffsetTab::collectOverlap(MD const* md, ConstMDIter & iter,
+                               OUT Vector<MD const*> & res)
+{
+    ASSERT0(md);
+    m_num_query++;
+    UINT num = 0;
+    if (md->is_unbound() ||
+        get_elem_count() < OFST_TAB_INDEX_THRESHOLD) {
+        iter.clean();
+        for (MD const* t = get_first(iter, NULL);
+             t != NULL; t = get_next(iter, NULL)) {
+            ASSERT0(MD_base(md) == MD_base(t));
+            m_num_visit++;
+            if (t != md && md->is_overlap(t)) {
+                res.set(num, t);
+                num++;
+            }
+        }
+        m_num_hit += num;
+        return num;
+    }
+
+    if (!m_is_index_valid) {
+        buildIndex();
+    }
+    queryIndex(0, m_sorted.get_last_idx() + 1, md, res, num);
+    m_num_hit += num;
+    return num;
+}
+//END OffsetTab
+
+
 //
 //START MDSet
 //
@@ -439,6 +543,242 @@ void MDSetMgr::dump()
 //END MDSetMgr
 
 
+//
+//START MDSetHash
+//
+MDSetHash::MDSetHash(MDSetHashAllocator * allocator) :
+    SBitSetCoreHash<MDSetHashAllocator>(allocator)
+{
+    m_op_cache = NULL;
+    m_stamp = 0;
+    m_use_op_cache = false;
+    m_num_append = 0;
+    m_num_append_hit = 0;
+    m_num_op = 0;
+    m_num_op_trivial = 0;
+    m_num_op_hit = 0;
+}
+
+
+MDSetHash::~MDSetHash()
+{
+    if (m_op_cache != NULL) {
+        ::free(m_op_cache);
+        m_op_cache = NULL;
+    }
+}
+
+
+MDSet const* MDSetHash::append(SBitSetCore<> const& set)
+{
+    UINT num_alloc = get_allocator()->get_num_alloc();
+    MDSet const* hashed = (MDSet const*)
+        SBitSetCoreHash<MDSetHashAllocator>::append(set);
+    if (hashed != NULL) {
+        m_num_append++;
+        if (num_alloc == get_allocator()->get_num_alloc()) {
+            m_num_append_hit++;
+        } else {
+            m_hashed_tab.append(hashed);
+        }
+    }
+    return hashed;
+}
+
+
+void MDSetHash::cleanOpCache()
+{
+    if (m_op_cache == NULL) { return; }
+    ::memset(m_op_cache, 0, sizeof(MDSetOpEntry) *
+             MDS_OP_CACHE_SET_NUM * MDS_OP_CACHE_WAY_NUM);
+    m_stamp = 0;
+}
+
+
+size_t MDSetHash::count_mem() const
+{
+    size_t count = SBitSetCoreHash<MDSetHashAllocator>::count_mem();
+    if (m_op_cache != NULL) {
+        count += sizeof(MDSetOpEntry) *
+                 MDS_OP_CACHE_SET_NUM * MDS_OP_CACHE_WAY_NUM;
+    }
+    return count;
+}
+
+
+static UINT mds_op_hash(MDS_OP op, void const* a, void const* b)
+{
+    size_t v = (((size_t)a >> 3) * 31 + ((size_t)b >> 3)) * 8 + op;
+    v ^= v >> 11;
+    return (UINT)(v & (MDS_OP_CACHE_SET_NUM - 1));
+}
+
+
+//Return the entry if operation is in cache, or else return NULL.
+MDSetOpEntry * MDSetHash::lookupOp(MDS_OP op, void const* a, void const* b)
+{
+    if (m_op_cache == NULL) { return NULL; }
+    MDSetOpEntry * set = m_op_cache +
+        mds_op_hash(op, a, b) * MDS_OP_CACHE_WAY_NUM;
+    for (UINT i = 0; i < MDS_OP_CACHE_WAY_NUM; i++) {
+        MDSetOpEntry * e = set + i;
+        if (e->stamp != 0 && e->op == (BYTE)op &&
+            e->opnd0 == a && e->opnd1 == b) {
+            e->stamp = ++m_stamp;
+            m_num_op_hit++;
+            return e;
+        }
+    }
+    return NULL;
+}
+
+
+//Record the result of operation into cache.
+//The entry that accessed least recently is replaced if the set is full.
+void MDSetHash::recordOp(
+        MDS_OP op,
+        void const* a,
+        void const* b,
+        MDSet const* res,
+        bool is_true)
+{
+    if (!m_use_op_cache) { return; }
+    if (m_op_cache == NULL) {
+        UINT sz = sizeof(MDSetOpEntry) *
+                  MDS_OP_CACHE_SET_NUM * MDS_OP_CACHE_WAY_NUM;
+        m_op_cache = (MDSetOpEntry*)::malloc(sz);
+        ASSERT0(m_op_cache);
+        ::memset(m_op_cache, 0, sz);
+    }
+
+    m_stamp++;
+    if (m_stamp == 0) {
+        //Stamp overflowed.
+        cleanOpCache();
+        m_stamp = 1;
+    }
+
+    MDSetOpEntry * set = m_op_cache +
+        mds_op_hash(op, a, b) * MDS_OP_CACHE_WAY_NUM;
+    MDSetOpEntry * victim = set;
+    for (UINT i = 1; i < MDS_OP_CACHE_WAY_NUM; i++) {
+        if (set[i].stamp < victim->stamp) {
+            victim = set + i;
+        }
+    }
+    victim->opnd0 = a;
+    victim->opnd1 = b;
+    victim->res = res;
+    victim->stamp = m_stamp;
+    victim->op = (BYTE)op;
+    victim->is_true = (BYTE)is_true;
+}
+
+
+MDSet const* MDSetHash::unionSet(MDSet const* a, MDSet const* b)
+{
+    ASSERT0(is_hashed(a) && is_hashed(b));
+    m_num_op++;
+    if (a == b || b == NULL) { m_num_op_trivial++; return a; }
+    if (a == NULL) { m_num_op_trivial++; return b; }
+
+    //Union is commutative.
+    if (a > b) { MDSet const* t = a; a = b; b = t; }
+
+    MDSetOpEntry * e = lookupOp(MDS_OP_UNION, a, b);
+    if (e != NULL) { return e->res; }
+
+    DefMiscBitSetMgr & mgr = *get_allocator()->getBsMgr();
+    MDSet tmp;
+    tmp.copy(*a, mgr);
+    tmp.bunion(*b, mgr);
+    MDSet const* res = append(tmp);
+    tmp.clean(mgr);
+    recordOp(MDS_OP_UNION, a, b, res, false);
+    return res;
+}
+
+
+MDSet const* MDSetHash::unionMD(MDSet const* a, MD const* md)
+{
+    ASSERT0(md && is_hashed(a));
+    m_num_op++;
+    if (a != NULL && a->is_contain(md)) { m_num_op_trivial++; return a; }
+
+    //Key the entry by MD id, because the union only concerns the id.
+    void const* b = (void const*)(size_t)MD_id(md);
+    MDSetOpEntry * e = lookupOp(MDS_OP_UNION_MD, a, b);
+    if (e != NULL) { return e->res; }
+
+    DefMiscBitSetMgr & mgr = *get_allocator()->getBsMgr();
+    MDSet tmp;
+    if (a != NULL) {
+        tmp.copy(*a, mgr);
+    }
+    tmp.bunion(md, mgr);
+    MDSet const* res = append(tmp);
+    tmp.clean(mgr);
+    recordOp(MDS_OP_UNION_MD, a, b, res, false);
+    return res;
+}
+
+
+bool MDSetHash::isEqual(MDSet const* a, MDSet const* b)
+{
+    m_num_op++;
+    if (a == b) { m_num_op_trivial++; return true; }
+    if (a == NULL || b == NULL) {
+        m_num_op_trivial++;
+        return a == NULL ? b->is_empty() : a->is_empty();
+    }
+    if (m_use_op_cache && is_hashed(a) && is_hashed(b)) {
+        //Equal hashed sets are the same object.
+        m_num_op_trivial++;
+        return false;
+    }
+    return a->is_equal(*b);
+}
+
+
+bool MDSetHash::isIntersect(MDSet const* a, MDSet const* b)
+{
+    m_num_op++;
+    if (a == NULL || b == NULL) { m_num_op_trivial++; return false; }
+    if (a == b) { m_num_op_trivial++; return true; }
+    if (!m_use_op_cache || !is_hashed(a) || !is_hashed(b)) {
+        return a->is_intersect(*b);
+    }
+
+    if (a > b) { MDSet const* t = a; a = b; b = t; }
+
+    MDSetOpEntry * e = lookupOp(MDS_OP_IS_INTERSECT, a, b);
+    if (e != NULL) { return e->is_true != 0; }
+
+    bool is_true = a->is_intersect(*b);
+    recordOp(MDS_OP_IS_INTERSECT, a, b, NULL, is_true);
+    return is_true;
+}
+
+
+void MDSetHash::dumpStat(FILE * h) const
+{
+    if (h == NULL) { return; }
+    fprintf(h, "\nMDSetHash: %u sets, %lu bytes",
+            get_allocator()->get_num_alloc(), (ULONG)count_mem());
+    fprintf(h, "\n  append: %u, hit: %u (%.1f%%)",
+            m_num_append, m_num_append_hit,
+            m_num_append == 0 ? 0.0 :
+            (double)m_num_append_hit * 100 / m_num_append);
+    UINT computed = m_num_op - m_num_op_trivial;
+    fprintf(h, "\n  operation: %u, trivial: %u, cache hit: %u (%.1f%% of "
+            "nontrivial)",
+            m_num_op, m_num_op_trivial, m_num_op_hit,
+            computed == 0 ? 0.0 : (double)m_num_op_hit * 100 / computed);
+    fflush(h);
+}
+//END MDSetHash
+
+
 //
 //START MD2MD_SET_MAP
 //
@@ -485,6 +825,7 @@ void MD2MDSet::dump(Region * ru)
     VarVec * var_tab = ru->get_var_mgr()->get_var_vec();
     Vector<MD const*> mdv;
     ConstMDIter iter;
+    MutexHolder h(ms->get_lock());
     for (INT i = 0; i <= var_tab->get_last_idx(); i++) {
         VAR * v = var_tab->get(i);
         if (v == NULL) { continue; }
@@ -529,6 +870,7 @@ void MD2MDSet::dump(Region * ru)
 MD const* MDSystem::registerMD(MD const& m)
 {
     ASSERT0(MD_base(&m));
+    MutexHolder h(m_lock);
     if (MD_id(&m) > 0) {
         //Find the entry in MDTab accroding to m.
         MDTab * mdtab = get_md_tab(MD_base(&m));
@@ -568,7 +910,10 @@ MD const* MDSystem::registerMD(MD const& m)
 
     //Generate a new MD and record it in md-table accroding to its id.
     MD * entry = allocMD();
-    if (MD_id(entry) == 0) {
+    UINT rid = g_task_id_range != NULL ? g_task_id_range->md.alloc() : 0;
+    if (rid != 0) {
+        MD_id(entry) = rid;
+    } else if (MD_id(entry) == 0 || m_lock != NULL) {
         MD_id(entry) = m_md_count++;
     }
     entry->copy(&m);
@@ -650,6 +995,7 @@ void MDSystem::init(VarMgr * vm)
     m_sc_mdptr_pool = smpoolCreate(sizeof(SC<MD*>) * 10, MEM_CONST_SIZE);
     m_free_md_list.set_pool(m_sc_mdptr_pool);
     m_md_count = 1;
+    m_reset_md_count = 0;
     m_tm = vm->get_type_mgr();
     ASSERT0(m_tm);
     initAllMemMD(vm);
@@ -697,6 +1043,7 @@ void MDSystem::computeOverlap(
         output.bunion(MD_GLOBAL_MEM, mbsmgr);
     }
 
+    MutexHolder h(m_lock);
     MDTab * mdt = get_md_tab(MD_base(md));
     ASSERT0(mdt != NULL);
 
@@ -709,14 +1056,9 @@ void MDSystem::computeOverlap(
     OffsetTab * ofsttab = mdt->get_ofst_tab();
     ASSERT0(ofsttab);
     if (ofsttab->get_elem_count() > 0) {
-        tabiter.clean();
-        for (MD const* tmd = ofsttab->get_first(tabiter, NULL);
-             tmd != NULL; tmd = ofsttab->get_next(tabiter, NULL)) {
-            ASSERT0(MD_base(md) == MD_base(tmd));
-            if (tmd == md) { continue; }
-            if (md->is_overlap(tmd)) {
-                output.bunion(tmd, mbsmgr);
-            }
+        UINT num = ofsttab->collectOverlap(md, tabiter, m_overlap_buf);
+        for (UINT i = 0; i < num; i++) {
+            output.bunion(m_overlap_buf.get(i), mbsmgr);
         }
     }
 }
@@ -731,19 +1073,18 @@ void MDSystem::computeOverlapExactMD(
         DefMiscBitSetMgr & mbsmgr)
 {
     ASSERT0(md && md->is_exact());
+    MutexHolder h(m_lock);
     MDTab * mdt = get_md_tab(MD_base(md));
     ASSERT0(mdt);
 
     OffsetTab * ofstab = mdt->get_ofst_tab();
     ASSERT0(ofstab);
     if (ofstab->get_elem_count() > 0) {
-        tabiter.clean();
-        for (MD const* t = ofstab->get_first(tabiter, NULL);
-             t != NULL; t = ofstab->get_next(tabiter, NULL)) {
-            if (t == md || !t->is_exact()) { continue; }
-            if (t->is_overlap(md)) {
-                output->bunion(t, mbsmgr);
-            }
+        UINT num = ofstab->collectOverlap(md, tabiter, m_overlap_buf);
+        for (UINT i = 0; i < num; i++) {
+            MD const* t = m_overlap_buf.get(i);
+            if (!t->is_exact()) { continue; }
+            output->bunion(t, mbsmgr);
         }
     }
 }
@@ -770,6 +1111,7 @@ void MDSystem::computeOverlap(
     tmpvec.clean();
     bool set_global = false;
     SEGIter * iter;
+    MutexHolder h(m_lock);
     for (INT i = mds.get_first(&iter);
          i >= 0; i = mds.get_next(i, &iter)) {
         MD * md = get_md(i);
@@ -787,17 +1129,15 @@ void MDSystem::computeOverlap(
 
         OffsetTab * ofsttab = mdt->get_ofst_tab();
         ASSERT0(ofsttab);
-        tabiter.clean();
-        for (MD const* tmd = ofsttab->get_first(tabiter, NULL);
-             tmd != NULL; tmd = ofsttab->get_next(tabiter, NULL)) {
+        if (ofsttab->get_elem_count() == 0) { continue; }
+        UINT num = ofsttab->collectOverlap(md, tabiter, m_overlap_buf);
+        for (UINT j = 0; j < num; j++) {
+            MD const* tmd = m_overlap_buf.get(j);
             if (((DefSBitSetCore&)mds).is_contain(MD_id(tmd))) {
                 continue;
             }
-            ASSERT0(MD_base(md) == MD_base(tmd));
-            if (md->is_overlap(tmd)) {
-                tmpvec.set(count, tmd);
-                count++;
-            }
+            tmpvec.set(count, tmd);
+            count++;
         }
     }
 
@@ -834,6 +1174,7 @@ void MDSystem::computeOverlap(
 
     bool set_global = false;
     SEGIter * iter;
+    MutexHolder h(m_lock);
     for (INT i = mds.get_first(&iter); i >= 0; i = mds.get_next(i, &iter)) {
         MD * md = get_md(i);
         ASSERT0(md);
@@ -847,18 +1188,16 @@ void MDSystem::computeOverlap(
             output.bunion_pure(MD_id(effect_md), mbsmgr);
         }
 
-        OffsetTab const* ofsttab = mdt->get_ofst_tab();
+        OffsetTab * ofsttab = mdt->get_ofst_tab();
         ASSERT0(ofsttab);
-        tabiter.clean();
-        for (MD const* tmd = ofsttab->get_first(tabiter, NULL);
-             tmd != NULL; tmd = ofsttab->get_next(tabiter, NULL)) {
+        if (ofsttab->get_elem_count() == 0) { continue; }
+        UINT num = ofsttab->collectOverlap(md, tabiter, m_overlap_buf);
+        for (UINT j = 0; j < num; j++) {
+            MD const* tmd = m_overlap_buf.get(j);
             if (mds.is_contain_pure(MD_id(tmd))) {
                 continue;
             }
-            ASSERT0(MD_base(md) == MD_base(tmd));
-            if (md->is_overlap(tmd)) {
-                output.bunion_pure(MD_id(tmd), mbsmgr);
-            }
+            output.bunion_pure(MD_id(tmd), mbsmgr);
         }
     }
 
@@ -899,10 +1238,81 @@ void MDSystem::dumpAllMD()
 }
 
 
+void MDSystem::dumpOverlapStat()
+{
+    if (g_tfile == NULL) return;
+    UINT ntab = 0;
+    UINT nindexed = 0;
+    UINT nquery = 0;
+    UINT nvisit = 0;
+    UINT nhit = 0;
+    UINT nbuild = 0;
+    UINT max_elem = 0;
+    TMapIter<VAR const*, MDTab*> iter;
+    MDTab * mdtab;
+    MutexHolder h(m_lock);
+    for (VAR const* var = m_var2mdtab.get_first(iter, &mdtab);
+         var != NULL; var = m_var2mdtab.get_next(iter, &mdtab)) {
+        OffsetTab const* ofstab = mdtab->get_ofst_tab();
+        UINT n = ofstab->get_elem_count();
+        ntab++;
+        max_elem = MAX(max_elem, n);
+        if (n >= OFST_TAB_INDEX_THRESHOLD) { nindexed++; }
+        nquery += ofstab->get_num_query();
+        nvisit += ofstab->get_num_visit();
+        nhit += ofstab->get_num_hit();
+        nbuild += ofstab->get_num_build();
+    }
+    fprintf(g_tfile, "\n==---- MD overlap query ----==");
+    fprintf(g_tfile, "\nMDTab: %u, indexed: %u, max MDs in one tab: %u",
+            ntab, nindexed, max_elem);
+    fprintf(g_tfile, "\nquery: %u, MD visited: %u (%.1f per query), "
+            "overlapped: %u, index built: %u",
+            nquery, nvisit, nquery == 0 ? 0.0 : (double)nvisit / nquery,
+            nhit, nbuild);
+    fflush(g_tfile);
+}
+
+
+//Free MDs registered after reset point, and the id of subsequent
+//registered MD will be assigned from reset point.
+void MDSystem::reset()
+{
+    ASSERT(m_reset_md_count >= MD_FIRST_ALLOCABLE,
+           ("invoke setResetPoint() at first"));
+    MutexHolder h(m_lock);
+    for (INT i = m_reset_md_count; i <= m_id2md_map.get_last_idx(); i++) {
+        MD * md = m_id2md_map.get(i);
+        if (md == NULL) { continue; }
+
+        VAR const* base = MD_base(md);
+        MDTab * mdtab = get_md_tab(base);
+        ASSERT0(mdtab);
+        mdtab->remove(md);
+        if (mdtab->get_elem_count() == 0) {
+            delete mdtab;
+            m_var2mdtab.remove(base);
+        }
+        freeMD(md);
+    }
+
+    //The MD in free list will be reassigned id by registerMD().
+    for (SC<MD*> * sc = m_free_md_list.get_head();
+         sc != m_free_md_list.end(); sc = m_free_md_list.get_next(sc)) {
+        MD * md = sc->val();
+        if (MD_id(md) >= m_reset_md_count) {
+            MD_id(md) = 0;
+        }
+    }
+    m_md_count = m_reset_md_count;
+}
+
+
 //Remove all MDs related to specific variable 'v'.
 void MDSystem::removeMDforVAR(VAR const* v, ConstMDIter & iter)
 {
     ASSERT0(v);
+    MutexHolder h(m_lock);
     MDTab * mdtab = get_md_tab(v);
     if (mdtab != NULL) {
         MD const* x = mdtab->get_effect_md();
@@ -264,15 +264,90 @@ public:
 };
 
 
+//The number of MDs in OffsetTab that begins to use interval index.
+//Walking through small table is faster than building the index.
+#define OFST_TAB_INDEX_THRESHOLD 16
+
 //MD hashed by MD_ofst.
-class OffsetTab : public TMap<MD const*, MD const*, CompareOffset> {
+//The table keeps an interval index on [MD_ofst, MD_ofst + MD_size)
+//to enumerate the overlapped MDs without walking through the table.
+//The index is a sorted array of MDs, and the array is viewed as an
+//implicit balanced binary tree, each element records the max end of
+//the subtree rooted at it. Subtree is skipped if its max end is not
+//greater than the start of query range, and the right subtree is
+//skipped if the root starts after the end of query range, thus the
+//query costs O(logN + K), K is the number of overlapped MDs.
+//The index is rebuilt lazily when the table is queried after changed.
+class OffsetTab : public BTMap<MD const*, MD const*, CompareOffset> {
+    typedef BTMap<MD const*, MD const*, CompareOffset> BaseType;
+    COPY_CONSTRUCTOR(OffsetTab);
+protected:
+    //MDs sorted in ascending order of MD_ofst.
+    Vector<MD const*> m_sorted;
+
+    //The max end of MDs in the subtree rooted at each element of
+    //m_sorted.
+    Vector<ULONGLONG> m_max_end;
+    bool m_is_index_valid;
+
+    //Statistics of overlap queries.
+    UINT m_num_query;
+    UINT m_num_visit; //the number of MDs that checked by queries.
+    UINT m_num_hit; //the number of overlapped MDs found by queries.
+    UINT m_num_build;
+
+    void buildIndex();
+    ULONGLONG buildMaxEnd(UINT l, UINT r);
+    void queryIndex(UINT l, UINT r, MD const* md,
+                    OUT Vector<MD const*> & res, IN OUT UINT & num);
 public:
+    OffsetTab()
+    {
+        m_is_index_valid = false;
+        m_num_query = 0;
+        m_num_visit = 0;
+        m_num_hit = 0;
+        m_num_build = 0;
+    }
+
+    void clean()
+    {
+        BaseType::clean();
+        m_sorted.clean();
+        m_max_end.clean();
+        m_is_index_valid = false;
+    }
+
+    //Collect MDs in table that overlapped with 'md', 'md' itself is
+    //excluded. Return the number of MDs recorded in 'res'.
+    //'iter': for local use.
+    UINT collectOverlap(MD const* md, ConstMDIter & iter,
+                        OUT Vector<MD const*> & res);
+    size_t count_mem() const
+    {
+        return BaseType::count_mem() + m_sorted.count_mem() +
+               m_max_end.count_mem();
+    }
+
     //Return the entry.
-    MD const* find(MD const* md)
-    { return TMap<MD const*, MD const*, CompareOffset>::get(md, NULL); }
+    MD const* find(MD const* md) { return BaseType::get(md, NULL); }
+
+    UINT get_num_query() const { return m_num_query; }
+    UINT get_num_visit() const { return m_num_visit; }
+    UINT get_num_hit() const { return m_num_hit; }
+    UINT get_num_build() const { return m_num_build; }
 
     void append(MD const* md)
-    { TMap<MD const*, MD const*, CompareOffset>::set(md, md); }
+    {
+        BaseType::set(md, md);
+        m_is_index_valid = false;
+    }
+
+    void remove(MD const* md)
+    {
+        BaseType::remove(md);
+        m_is_index_valid = false;
+    }
 };
 
 
@@ -312,6 +387,16 @@ public:
         m_invalid_ofst_md = md;
     }
 
+    void remove(MD const* md)
+    {
+        if (md->is_exact()) {
+            m_ofst_tab.remove(md);
+            return;
+        }
+        ASSERT0(m_invalid_ofst_md == md);
+        m_invalid_ofst_md = NULL;
+    }
+
     UINT get_elem_count()
     {
         UINT elems = 0;
@@ -498,23 +583,26 @@ public:
 };
 
 
-class MDId2MD : public Vector<MD*> {
+//The map may be read by other threads without lock, see
+//set_keep_old_buf().
+class MDId2MD : public KeepBufVector<MD*> {
     UINT m_count;
 public:
     MDId2MD() { m_count = 0; }
+    COPY_CONSTRUCTOR(MDId2MD);
 
     void remove(UINT mdid)
     {
         ASSERT0(mdid != 0); //0 is illegal mdid.
         ASSERT0(get(mdid) != NULL);
-        Vector<MD*>::set(mdid, NULL);
+        KeepBufVector<MD*>::set(mdid, NULL);
         m_count--;
     }
 
     void set(UINT mdid, MD * md)
     {
         ASSERT(Vector<MD*>::get(mdid) == NULL, ("already mapped"));
-        Vector<MD*>::set(mdid, md);
+        KeepBufVector<MD*>::set(mdid, md);
         m_count++;
     }
 
@@ -525,24 +613,115 @@ public:
 
 class MDSetHashAllocator {
     MiscBitSetMgr<> * m_sbs_mgr;
+    UINT m_num_alloc; //record the number of set allocated.
 public:
     MDSetHashAllocator(MiscBitSetMgr<> * sbsmgr)
-    { ASSERT0(sbsmgr); m_sbs_mgr = sbsmgr; }
+    { ASSERT0(sbsmgr); m_sbs_mgr = sbsmgr; m_num_alloc = 0; }
 
-    SBitSetCore<> * alloc() { return m_sbs_mgr->allocSBitSetCore(); }
+    SBitSetCore<> * alloc()
+    {
+        m_num_alloc++;
+        return m_sbs_mgr->allocSBitSetCore();
+    }
     void free(SBitSetCore<> * set) { m_sbs_mgr->freeSBitSetCore(set); }
     MiscBitSetMgr<> * getBsMgr() const { return m_sbs_mgr; }
+    UINT get_num_alloc() const { return m_num_alloc; }
+};
+
+
+//Number of sets of the operation cache of MDSetHash.
+//The number must be power of 2.
+#define MDS_OP_CACHE_SET_NUM 256
+
+//Number of entries in each set of the operation cache.
+#define MDS_OP_CACHE_WAY_NUM 4
+
+//Operations that memoized by MDSetHash.
+typedef enum {
+    MDS_OP_UNDEF = 0,
+    MDS_OP_UNION, //union of two sets.
+    MDS_OP_UNION_MD, //union of set and MD.
+    MDS_OP_IS_INTERSECT, //query whether two sets are intersected.
+} MDS_OP;
+
+//Entry of the operation cache.
+//'opnd1' is the MD id if operation is MDS_OP_UNION_MD.
+class MDSetOpEntry {
+public:
+    void const* opnd0;
+    void const* opnd1;
+    MDSet const* res;
+    UINT stamp; //the time of the last access, 0 if entry is empty.
+    BYTE op;
+    BYTE is_true; //the result of query.
 };
 
 
+//Hash table of MDSet.
+//The set appended is canonical, namely, equal sets are represented
+//by the same object. Thus two hashed sets are equal if and only if
+//they are the same pointer, see isEqual().
+//The union of hashed sets returns hashed set. The results are memoized
+//in a set-associative operation cache keyed by the pointers of
+//operands, and the least recently used entry of the set is replaced
+//when the set is full.
+//The cache is valid since hashed set is never freed until the hash
+//destroyed. Query whose operand is not hashed is computed directly
+//without the cache, because the operand may be modified or freed, and
+//its address may be reused by another set.
 class MDSetHash : public SBitSetCoreHash<MDSetHashAllocator> {
+    COPY_CONSTRUCTOR(MDSetHash);
+protected:
+    MDSetOpEntry * m_op_cache; //allocated when it is used at first.
+    TTab<MDSet const*> m_hashed_tab; //record the sets appended.
+    UINT m_stamp;
+    bool m_use_op_cache;
+
+    //Statistics.
+    UINT m_num_append;
+    UINT m_num_append_hit; //set has been in hash.
+    UINT m_num_op;
+    UINT m_num_op_trivial; //operation that resolved without computing.
+    UINT m_num_op_hit; //operation that resolved by cache.
+
+    MDSetOpEntry * lookupOp(MDS_OP op, void const* a, void const* b);
+    void recordOp(MDS_OP op, void const* a, void const* b,
+                  MDSet const* res, bool is_true);
+
+    //Return true if 'mds' is NULL or hashed.
+    bool is_hashed(MDSet const* mds) const
+    { return mds == NULL || m_hashed_tab.find(mds); }
 public:
-    MDSetHash(MDSetHashAllocator * allocator) :
-        SBitSetCoreHash<MDSetHashAllocator>(allocator) {}
-    virtual ~MDSetHash() {}
+    MDSetHash(MDSetHashAllocator * allocator);
+    virtual ~MDSetHash();
+
+    MDSet const* append(SBitSetCore<> const& set);
+
+    void cleanOpCache();
+    size_t count_mem() const;
+
+    //Dump the hit rates of hash and operation cache.
+    void dumpStat(FILE * h) const;
+
+    //Return true if sets are equal, hashed sets are compared by pointer
+    //if operation cache is used.
+    //'a', 'b': set or NULL that indicates empty set.
+    bool isEqual(MDSet const* a, MDSet const* b);
+
+    //Return true if sets intersect, see MDSet::is_intersect().
+    //'a', 'b': set or NULL that indicates empty set.
+    bool isIntersect(MDSet const* a, MDSet const* b);
 
-    MDSet const* append(SBitSetCore<> const& set)
-    { return (MDSet const*)SBitSetCoreHash<MDSetHashAllocator>::append(set); }
+    //Set to true to memoize the result of operations.
+    void set_op_cache(bool use) { m_use_op_cache = use; }
+
+    //Return the hashed set of union of a and b.
+    //'a', 'b': hashed set or NULL that indicates empty set.
+    MDSet const* unionSet(MDSet const* a, MDSet const* b);
+
+    //Return the hashed set of union of a and {md}.
+    //'a': hashed set or NULL that indicates empty set.
+    MDSet const* unionMD(MDSet const* a, MD const* md);
 };
 
 
@@ -552,7 +731,11 @@ public:
 //Manage the memory allocation and free of MDTab, and
 //the mapping between VAR and MDTab.
 //NOTE: each region manager has a single MDSystem.
+//If regions are processed concurrently, MDs are registered and looked
+//up under the lock of MDSystem, see set_lock(). get_md() and read_md()
+//do not lock since MDId2MD keeps the buffer that replaced by growing.
 class MDSystem {
+    Mutex * m_lock;
     SMemPool * m_pool;
     SMemPool * m_sc_mdptr_pool;
     TypeMgr * m_tm;
@@ -561,7 +744,9 @@ class MDSystem {
     MDId2MD m_id2md_map; //Map MD id to MD.
     SList<MD*> m_free_md_list; //MD allocated in pool.
     UINT m_md_count; //generate MD index, used by registerMD().
+    UINT m_reset_md_count; //record m_md_count at reset point.
     TMap<VAR const*, MDTab*, CompareConstVar> m_var2mdtab; //map VAR to MDTab.
+    Vector<MD const*> m_overlap_buf; //for tmp use, protected by m_lock.
 
     inline MD * allocMD()
     {
@@ -578,7 +763,7 @@ class MDSystem {
     void initGlobalMemMD(VarMgr * vm);
     void initAllMemMD(VarMgr * vm);
 public:
-    MDSystem(VarMgr * vm) { init(vm); }
+    MDSystem(VarMgr * vm) { m_lock = NULL; init(vm); }
     COPY_CONSTRUCTOR(MDSystem);
     ~MDSystem() { destroy(); }
 
@@ -610,6 +795,10 @@ public:
 
     //Dump all registered MDs.
     void dumpAllMD();
+
+    //Dump the statistics of overlap queries on MDTabs.
+    void dumpOverlapStat();
+
     void destroy();
 
     TypeMgr * get_type_mgr() const { return m_tm; }
@@ -633,18 +822,25 @@ public:
     }
 
     //Get MD TAB that described mds which under same base VAR.
+    //NOTE: caller must hold get_lock() from the query until the end of
+    //accessing the returned MDTab if regions are processed concurrently.
     MDTab * get_md_tab(VAR const* v)
     {
         ASSERT0(v);
         return m_var2mdtab.get(v);
     }
 
+    //Return the lock that protects MDSystem, or NULL if MDSystem is
+    //only accessed by one thread.
+    Mutex * get_lock() const { return m_lock; }
+
     UINT get_num_of_md() const { return m_id2md_map.get_elem_count(); }
     MDId2MD const* get_id2md_map() const { return &m_id2md_map; }
 
     inline void freeMD(MD * md)
     {
         if (md == NULL) { return; }
+        MutexHolder h(m_lock);
         m_id2md_map.remove(MD_id(md));
         UINT mdid = MD_id(md);
         memset(md, 0, sizeof(MD));
@@ -660,6 +856,33 @@ public:
 
     //Remove all MDs related to specific variable 'v'.
     void removeMDforVAR(VAR const* v, IN ConstMDIter & iter);
+
+    //Set the lock to protect MDSystem from being accessed by multiple
+    //threads simultaneously. 'lock' may be NULL if there is only one
+    //thread. The id of freed MD is not reused while the lock is set,
+    //so that MDs registered by one thread are numbered in the same
+    //order regardless of the other threads.
+    void set_lock(Mutex * lock)
+    {
+        m_lock = lock;
+        m_id2md_map.set_keep_old_buf(lock != NULL);
+    }
+
+    //Reserve 'num' consecutive MD ids, return the first one.
+    UINT reserveId(UINT num)
+    {
+        MutexHolder h(m_lock);
+        UINT start = m_md_count;
+        m_md_count += num;
+        return start;
+    }
+
+    //Free MDs registered after reset point.
+    void reset();
+
+    //Regard MDs registered so far as persistent, they will be kept
+    //by reset().
+    void setResetPoint() { m_reset_md_count = m_md_count; }
 };
 
 
@@ -682,7 +905,7 @@ typedef TMapIter<UINT, MDSet const*> MD2MDSetIter;
 //MD2MD_SET_MAP
 //Record MD->MDS relations.
 //Note MD may mapped to NULL, means the MD does not point to anything.
-class MD2MDSet : public TMap<UINT, MDSet const*> {
+class MD2MDSet : public BTMap<UINT, MDSet const*> {
 public:
     ~MD2MDSet()
     {
@@ -691,7 +914,7 @@ public:
     }
 
     //Clean each MD->MDSet, but do not free MDSet.
-    void clean() { TMap<UINT, MDSet const*>::clean(); }
+    void clean() { BTMap<UINT, MDSet const*>::clean(); }
 
     void dump(Region * ru);
 };
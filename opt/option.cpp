@@ -36,46 +36,46 @@ author: Su Zhenyu
 namespace xoc {
 
 //Optimize float operation.
-bool g_is_opt_float = true;
+THREAD_LOCAL bool g_is_opt_float = true;
 
 //Lower IR tree to PR mode.
-bool g_is_lower_to_pr_mode = false;
+THREAD_LOCAL bool g_is_lower_to_pr_mode = false;
 
 //Enable XOC support dynamic type.
 //That means the type of IR_ST may be VOID.
-bool g_is_support_dynamic_type = false;
+THREAD_LOCAL bool g_is_support_dynamic_type = false;
 
 //If true to hoist short type to integer type.
-bool g_is_hoist_type = false;
+THREAD_LOCAL bool g_is_hoist_type = false;
 
-CHAR * g_func_or_bb_option = NULL;
+THREAD_LOCAL CHAR * g_func_or_bb_option = NULL;
 
 //Represent optimization level.
-INT g_opt_level = OPT_LEVEL0;
+THREAD_LOCAL INT g_opt_level = OPT_LEVEL0;
 
 //Construct bb list.
-bool g_cst_bb_list = true;
+THREAD_LOCAL bool g_cst_bb_list = true;
 
 //Build control flow structure.
-bool g_do_cfg = true;
+THREAD_LOCAL bool g_do_cfg = true;
 
 //Compute reverse-post-order.
-bool g_do_rpo = true;
+THREAD_LOCAL bool g_do_rpo = true;
 
 //Perform peephole optimizations.
-bool g_do_refine = true;
+THREAD_LOCAL bool g_do_refine = true;
 
 //If true to insert IR_CVT by ir refinement.
-bool g_do_refine_auto_insert_cvt = false;
+THREAD_LOCAL bool g_do_refine_auto_insert_cvt = false;
 
 //Perform loop analysis.
-bool g_do_loop_ana = true;
+THREAD_LOCAL bool g_do_loop_ana = true;
 
 //Perform cfg optimization: remove empty bb.
-bool g_do_cfg_remove_empty_bb = true;
+THREAD_LOCAL bool g_do_cfg_remove_empty_bb = true;
 
 //Perform cfg optimization: remove unreachable bb from entry.
-bool g_do_cfg_remove_unreach_bb = true;
+THREAD_LOCAL bool g_do_cfg_remove_unreach_bb = true;
 
 //Perform cfg optimization: remove redundant trampoline bb.
 //e.g:
@@ -83,7 +83,7 @@ bool g_do_cfg_remove_unreach_bb = true;
 //    BB2, L1: goto L2
 //should be optimized and generate:
 //    BB1: goto L2
-bool g_do_cfg_remove_trampolin_bb = true;
+THREAD_LOCAL bool g_do_cfg_remove_trampolin_bb = true;
 
 //Perform cfg optimization: remove redundant branch.
 //e.g:
@@ -95,128 +95,169 @@ bool g_do_cfg_remove_trampolin_bb = true;
 //    ... //S3
 //
 //S1 is redundant branch.
-bool g_do_cfg_remove_redundant_branch = true;
+THREAD_LOCAL bool g_do_cfg_remove_redundant_branch = true;
 
 //Build dominator tree.
-bool g_do_cfg_dom = true;
+THREAD_LOCAL bool g_do_cfg_dom = true;
 
 //Build post dominator tree.
-bool g_do_cfg_pdom = true;
+THREAD_LOCAL bool g_do_cfg_pdom = true;
 
 //Perform control flow structure optimizations.
-bool g_do_cfs_opt = true;
+THREAD_LOCAL bool g_do_cfs_opt = true;
 
 //Build control dependence graph.
-bool g_do_cdg = true;
+THREAD_LOCAL bool g_do_cdg = true;
 
 //Build manager to reconstruct high level control flow structure IR.
 //This option is always useful if you want to perform optimization on
 //high level IR, such as IF, DO_LOOP, etc.
 //Note that if the CFS auxiliary information established, the
 //optimizations performed should not violate that.
-bool g_build_cfs = false;
+THREAD_LOCAL bool g_build_cfs = false;
 
 //Perform default alias analysis.
-bool g_do_aa = true;
+THREAD_LOCAL bool g_do_aa = true;
 
 //Perform DU analysis for MD to build du chain.
-bool g_do_md_du_ana = true;
+THREAD_LOCAL bool g_do_md_du_ana = true;
 
 //Compute DU chain.
-bool g_compute_du_chain = true;
+THREAD_LOCAL bool g_compute_du_chain = true;
+
+//Compute DU chain on demand for the passes that support it.
+THREAD_LOCAL bool g_lazy_du_chain = false;
 
 //Computem available expression during du analysis to
 //build more precise du chain.
-bool g_compute_available_exp = false;
+THREAD_LOCAL bool g_compute_available_exp = false;
 
 //Computem imported MD which are defined and used in region.
-bool g_compute_region_imported_defuse_md = false;
+THREAD_LOCAL bool g_compute_region_imported_defuse_md = false;
 
 //Build expression table to record lexicographic equally IR expression.
-bool g_do_expr_tab = true;
+THREAD_LOCAL bool g_do_expr_tab = true;
 
 //Perform aggressive copy propagation.
-bool g_do_cp_aggressive = true; //It may cost much compile time.
+THREAD_LOCAL bool g_do_cp_aggressive = true; //It may cost much compile time.
 
 //Perform copy propagation.
-bool g_do_cp = false;
+THREAD_LOCAL bool g_do_cp = false;
+
+//Perform sparse conditional constant propagation.
+//It requires PR SSA.
+THREAD_LOCAL bool g_do_ccp = false;
 
 //Perform dead code elimination.
-bool g_do_dce = false;
+THREAD_LOCAL bool g_do_dce = false;
 
 //Perform aggressive dead code elimination.
-bool g_do_dce_aggressive = true;
+THREAD_LOCAL bool g_do_dce_aggressive = true;
 
 //Perform dead store elimination.
-bool g_do_dse = false;
+THREAD_LOCAL bool g_do_dse = false;
 
 //Perform global common subexpression elimination.
-bool g_do_gcse = false;
+THREAD_LOCAL bool g_do_gcse = false;
 
 //Perform interprocedual analysis and optimization.
-bool g_do_ipa = false;
+THREAD_LOCAL bool g_do_ipa = false;
 
 //Build Call Graph.
-bool g_do_call_graph = false;
+THREAD_LOCAL bool g_do_call_graph = false;
 
 //If true to show compilation time.
-bool g_show_comp_time = false;
+THREAD_LOCAL bool g_show_comp_time = false;
 
 //If true to show memory usage for each Region.
-bool g_show_memory_usage = true;
+THREAD_LOCAL bool g_show_memory_usage = true;
 
 //Perform function inline.
-bool g_do_inline = false;
+THREAD_LOCAL bool g_do_inline = false;
 
 //Record the limit to inline.
-UINT g_inline_threshold = 10;
+THREAD_LOCAL UINT g_inline_threshold = 10;
 
 //Perform induction variable recognization.
-bool g_do_ivr = false;
+THREAD_LOCAL bool g_do_ivr = false;
 
 //Perform local common subexpression elimination.
-bool g_do_lcse = false;
+THREAD_LOCAL bool g_do_lcse = false;
 
 //Perform loop invariant code motion.
-bool g_do_licm = false;
+THREAD_LOCAL bool g_do_licm = false;
 
 //Perform global value numbering.
-bool g_do_gvn = true;
+THREAD_LOCAL bool g_do_gvn = true;
 
 //Perform global register allocation.
-bool g_do_gra = false;
+THREAD_LOCAL bool g_do_gra = false;
 
 //Perform partial redundant elimination.
-bool g_do_pre = false;
+THREAD_LOCAL bool g_do_pre = false;
 
 //Perform redundant code elimination.
-bool g_do_rce = false;
+THREAD_LOCAL bool g_do_rce = false;
 
 //Perform register promotion.
-bool g_do_rp = false;
+THREAD_LOCAL bool g_do_rp = false;
 
 //Build SSA form and perform optimization based on SSA.
-bool g_do_ssa = false;
+THREAD_LOCAL bool g_do_ssa = false;
+
+//Build Memory SSA, the SSA form of MD other than PR.
+THREAD_LOCAL bool g_do_md_ssa = false;
 
 //Record the maximum limit of the number of BB to perform optimizations.
-UINT g_thres_opt_bb_num = 100000;
+THREAD_LOCAL UINT g_thres_opt_bb_num = 100000;
 
 //Record the maximum limit of the number of IR to perform optimizations.
 //This is the threshold to do optimization.
-UINT g_thres_opt_ir_num = 30000;
+THREAD_LOCAL UINT g_thres_opt_ir_num = 30000;
 
 //Convert while-do to do-while loop.
-bool g_do_loop_convert = false;
+THREAD_LOCAL bool g_do_loop_convert = false;
 
 //Polyhedral Transformations.
-bool g_do_poly_tran = false;
+THREAD_LOCAL bool g_do_poly_tran = false;
 
 //Set to true to retain the PassMgr even if Region processing finished.
-bool g_retain_pass_mgr_for_region = false;
+THREAD_LOCAL bool g_retain_pass_mgr_for_region = false;
 
 //This variable show the verification level that compiler will perform.
 //More higher the level is, more verifications will be performed.
-UINT g_verify_level = VERIFY_LEVEL_2;
+THREAD_LOCAL UINT g_verify_level = VERIFY_LEVEL_2;
+
+//Set to true to represent sparse bitset in flat sorted segment array.
+//The flat array has better locality of reference than the linked list
+//when the set is iterated and merged frequently.
+THREAD_LOCAL bool g_is_flat_sbs = false;
+
+//Record the operations of sparse bitset during DU chain building into
+//the file, the trace can be replayed by com/bench/bench_sbs.cpp.
+THREAD_LOCAL CHAR const* g_sbs_trace_file = NULL;
+
+//Set to true to allocate IR and DU of region from arena, which
+//returns aligned memory by bumping pointer.
+THREAD_LOCAL bool g_is_arena_pool = false;
+
+//Set to true to compute idom and ipdom by Lengauer-Tarjan algorithm,
+//and answer the dominance query by the DFS interval of dominator tree.
+//The dominator set of BB is built only if someone asks for it.
+//In debug mode, the tree is checked with the iterative algorithm when
+//it is computed, and after each incremental update.
+THREAD_LOCAL bool g_is_dom_tree = true;
+
+//Set to true to memoize the union and intersection query of MDSets in
+//MDSetHash. Each MDSet referenced by IR and point-to set is hashed,
+//thus the operands are canonical and the result can be keyed by
+//the pointers of operands.
+THREAD_LOCAL bool g_is_intern_mdset = false;
+
+//Set to true to number values by optimistic iteration over SSA form,
+//that finds the congruences through loop-carried PHIs. The numbering
+//falls back to IR_GVN if PR SSA is not constructed.
+THREAD_LOCAL bool g_is_sparse_gvn = false;
 
 //We always simplify parameters to lowest height to
 //facilitate the query of point-to set.
@@ -233,6 +274,26 @@ UINT g_verify_level = VERIFY_LEVEL_2;
 //           mul (u32) id:13
 //               ld (i32 'i')
 //               intconst 24|0x18 (u32) id:14
-bool g_is_simplify_parameter = true;
+THREAD_LOCAL bool g_is_simplify_parameter = true;
+
+
+//
+//START OptionSnapshot
+//
+void OptionSnapshot::save()
+{
+    #define SAVE_OPTION(ty, name) this->name = ::xoc::name;
+    FOR_EACH_THREAD_OPTION(SAVE_OPTION)
+    #undef SAVE_OPTION
+}
+
+
+void OptionSnapshot::restore() const
+{
+    #define RESTORE_OPTION(ty, name) ::xoc::name = this->name;
+    FOR_EACH_THREAD_OPTION(RESTORE_OPTION)
+    #undef RESTORE_OPTION
+}
+//END OptionSnapshot
 
 } //namespace xoc
@@ -64,6 +64,8 @@ class PassMgr;
 #define OC_is_rpo_valid(o)              ((o).u1.s1.is_rpo_valid)
 #define OC_is_loopinfo_valid(o)         ((o).u1.s1.is_loopinfo_valid)
 #define OC_is_callg_valid(o)            ((o).u1.s1.is_callg_valid)
+#define OC_is_md_ssa_valid(o)           ((o).u1.s1.is_md_ssa_valid)
+#define OC_is_du_chain_dirty(o)         ((o).u1.s1.is_du_chain_dirty)
 #define OC_show_comp_time(o)            ((o).u2.s1.show_compile_time)
 class OptCtx {
 public:
@@ -93,6 +95,14 @@ public:
             UINT is_callg_valid:1; //Call graph is available.
 
             UINT is_rpo_valid:1; //Rporder is available.
+
+            UINT is_md_ssa_valid:1; //MD SSA form is available.
+
+            //DU chain is invalid only because of the stmts recorded by
+            //IR_DU_MGR::markDirtyStmt(), and it can be updated locally.
+            //The flag has to be cleared if DU chain is invalidated for
+            //other reasons.
+            UINT is_du_chain_dirty:1;
         } s1;
     } u1;
 
@@ -110,7 +120,11 @@ public:
         u2.int1 = 0;
     }
 
-    void set_all_valid() { u1.int1 = (UINT)-1; }
+    void set_all_valid()
+    {
+        u1.int1 = (UINT)-1;
+        OC_is_du_chain_dirty(*this) = false;
+    }
     void set_all_invalid() { u1.int1 = 0; }
 
     //This function reset the flag if control flow changed.
@@ -122,6 +136,12 @@ public:
         OC_is_pdom_valid(*this) = false;
         OC_is_rpo_valid(*this) = false;
         OC_is_loopinfo_valid(*this) = false;
+
+        //Phi of MD SSA depends on the predecessors of BB.
+        OC_is_md_ssa_valid(*this) = false;
+
+        //Recorded stmts do not cover the change of control flow.
+        OC_is_du_chain_dirty(*this) = false;
     }
 
     inline bool is_all_intra_valid()
@@ -187,44 +207,52 @@ typedef enum _PASS_TYPE {
 } PASS_TYPE;
 
 //Exported Variables
-extern CHAR * g_func_or_bb_option;
-extern INT g_opt_level;
-extern bool g_do_gra;
-extern bool g_do_refine;
-extern bool g_do_refine_auto_insert_cvt;
-extern bool g_is_hoist_type; //Hoist data type from less than INT to INT.
-extern bool g_do_ipa;
-extern bool g_do_call_graph; //Build call graph.
-extern bool g_show_comp_time;
-extern bool g_show_memory_usage; //Show the memory usage to dump file.
-extern bool g_do_inline;
-extern UINT g_inline_threshold;
-extern bool g_is_opt_float; //Optimize float point operation.
-extern bool g_is_lower_to_pr_mode; //Lower IR to PR mode.
+extern THREAD_LOCAL CHAR * g_func_or_bb_option;
+extern THREAD_LOCAL INT g_opt_level;
+extern THREAD_LOCAL bool g_do_gra;
+extern THREAD_LOCAL bool g_do_refine;
+extern THREAD_LOCAL bool g_do_refine_auto_insert_cvt;
+extern THREAD_LOCAL bool g_is_hoist_type; //Hoist data type from less than INT to INT.
+extern THREAD_LOCAL bool g_do_ipa;
+extern THREAD_LOCAL bool g_do_call_graph; //Build call graph.
+extern THREAD_LOCAL bool g_show_comp_time;
+extern THREAD_LOCAL bool g_show_memory_usage; //Show the memory usage to dump file.
+extern THREAD_LOCAL bool g_do_inline;
+extern THREAD_LOCAL UINT g_inline_threshold;
+extern THREAD_LOCAL bool g_is_opt_float; //Optimize float point operation.
+extern THREAD_LOCAL bool g_is_lower_to_pr_mode; //Lower IR to PR mode.
 
 //Enable XOC support dynamic type.
 //That means the type of IR_ST, IR_LD, IR_STPR, IR_PR may be VOID.
-extern bool g_is_support_dynamic_type;
-
-extern bool g_do_ssa; //Do optimization in SSA.
-extern bool g_do_cfg;
-extern bool g_do_rpo;
-extern bool g_do_loop_ana; //loop analysis.
-extern bool g_do_cfg_remove_empty_bb;
-extern bool g_do_cfg_remove_unreach_bb;
-extern bool g_do_cfg_remove_trampolin_bb;
-extern bool g_do_cfg_remove_redundant_branch;
-extern bool g_do_cfg_dom;
-extern bool g_do_cfg_pdom;
-extern bool g_do_cdg;
-extern bool g_do_aa;
-extern bool g_do_md_du_ana;
-extern bool g_compute_du_chain;
-extern bool g_compute_available_exp;
-extern bool g_compute_region_imported_defuse_md;
-extern bool g_do_expr_tab;
-
-extern bool g_do_dce;
+extern THREAD_LOCAL bool g_is_support_dynamic_type;
+
+extern THREAD_LOCAL bool g_do_ssa; //Do optimization in SSA.
+
+//Build SSA form of MD. At OPT_LEVEL3, if PR SSA is also enabled, the
+//MD DU chain is not computed unless pass requests it.
+extern THREAD_LOCAL bool g_do_md_ssa;
+extern THREAD_LOCAL bool g_do_cfg;
+extern THREAD_LOCAL bool g_do_rpo;
+extern THREAD_LOCAL bool g_do_loop_ana; //loop analysis.
+extern THREAD_LOCAL bool g_do_cfg_remove_empty_bb;
+extern THREAD_LOCAL bool g_do_cfg_remove_unreach_bb;
+extern THREAD_LOCAL bool g_do_cfg_remove_trampolin_bb;
+extern THREAD_LOCAL bool g_do_cfg_remove_redundant_branch;
+extern THREAD_LOCAL bool g_do_cfg_dom;
+extern THREAD_LOCAL bool g_do_cfg_pdom;
+extern THREAD_LOCAL bool g_do_cdg;
+extern THREAD_LOCAL bool g_do_aa;
+extern THREAD_LOCAL bool g_do_md_du_ana;
+extern THREAD_LOCAL bool g_compute_du_chain;
+
+//Compute DU chain on demand for the passes that support it, rather
+//than building the DU chain of entire region.
+extern THREAD_LOCAL bool g_lazy_du_chain;
+extern THREAD_LOCAL bool g_compute_available_exp;
+extern THREAD_LOCAL bool g_compute_region_imported_defuse_md;
+extern THREAD_LOCAL bool g_do_expr_tab;
+
+extern THREAD_LOCAL bool g_do_dce;
 
 //Set true to eliminate control-flow-structures.
 //Note this option may incur user unexpected result:
@@ -234,28 +262,52 @@ extern bool g_do_dce;
 //        for (;;) {}
 //    }
 //Aggressive DCE will remove the above dead cycle.
-extern bool g_do_dce_aggressive;
-
-extern bool g_do_cp_aggressive; //It may cost much compile time.
-extern bool g_do_cp;
-extern bool g_do_rp;
-extern bool g_do_gcse;
-extern bool g_do_lcse;
-extern bool g_do_pre;
-extern bool g_do_rce;
-extern bool g_do_dse;
-extern bool g_do_licm;
-extern bool g_do_ivr;
-extern bool g_do_gvn;
-extern bool g_do_cfs_opt;
-extern bool g_build_cfs;
-extern bool g_cst_bb_list; //Construct BB list.
-extern UINT g_thres_opt_ir_num;
-extern UINT g_thres_opt_bb_num;
-extern bool g_do_loop_convert;
-extern bool g_do_poly_tran;
-extern bool g_retain_pass_mgr_for_region;
-extern UINT g_verify_level;
+extern THREAD_LOCAL bool g_do_dce_aggressive;
+
+extern THREAD_LOCAL bool g_do_cp_aggressive; //It may cost much compile time.
+extern THREAD_LOCAL bool g_do_cp;
+extern THREAD_LOCAL bool g_do_ccp;
+extern THREAD_LOCAL bool g_do_rp;
+extern THREAD_LOCAL bool g_do_gcse;
+extern THREAD_LOCAL bool g_do_lcse;
+extern THREAD_LOCAL bool g_do_pre;
+extern THREAD_LOCAL bool g_do_rce;
+extern THREAD_LOCAL bool g_do_dse;
+extern THREAD_LOCAL bool g_do_licm;
+extern THREAD_LOCAL bool g_do_ivr;
+extern THREAD_LOCAL bool g_do_gvn;
+extern THREAD_LOCAL bool g_do_cfs_opt;
+extern THREAD_LOCAL bool g_build_cfs;
+extern THREAD_LOCAL bool g_cst_bb_list; //Construct BB list.
+extern THREAD_LOCAL UINT g_thres_opt_ir_num;
+extern THREAD_LOCAL UINT g_thres_opt_bb_num;
+extern THREAD_LOCAL bool g_do_loop_convert;
+extern THREAD_LOCAL bool g_do_poly_tran;
+extern THREAD_LOCAL bool g_retain_pass_mgr_for_region;
+extern THREAD_LOCAL UINT g_verify_level;
+
+//Set to true to represent sparse bitset, e.g: MDSet, DUSet, in flat
+//sorted array rather than linked list of segments.
+extern THREAD_LOCAL bool g_is_flat_sbs;
+
+//Record the sparse bitset operations of DU chain building into the file.
+//It is only available in debug mode.
+extern THREAD_LOCAL CHAR const* g_sbs_trace_file;
+
+//Set to true to allocate IR and DU of region from arena.
+extern THREAD_LOCAL bool g_is_arena_pool;
+
+//Set to true to represent dominator and post-dominator by tree rather
+//than by dominator set of each BB.
+extern THREAD_LOCAL bool g_is_dom_tree;
+
+//Set to true to memoize the union and intersection query of hashed
+//MDSet.
+extern THREAD_LOCAL bool g_is_intern_mdset;
+
+//Set to true to perform GVN on SSA form by IR_SGVN if PR SSA is
+//constructed, otherwise IR_GVN is used.
+extern THREAD_LOCAL bool g_is_sparse_gvn;
 
 //We always simplify parameters to lowest height to
 //facilitate the query of point-to set.
@@ -274,7 +326,98 @@ extern UINT g_verify_level;
 //               intconst 24|0x18 (u32) id:14
 //Note user should definitely confirm that the point-to information 
 //of parameters of call can be left out if the flag set to false.
-extern bool g_is_simplify_parameter;
+extern THREAD_LOCAL bool g_is_simplify_parameter;
+
+//The options listed here are thread local, each compilation thread has
+//its own copy, and the copy is initialized by the default value rather
+//than the value of main thread.
+#define FOR_EACH_THREAD_OPTION(X) \
+    X(CHAR*, g_func_or_bb_option) \
+    X(INT, g_opt_level) \
+    X(bool, g_do_gra) \
+    X(bool, g_do_refine) \
+    X(bool, g_do_refine_auto_insert_cvt) \
+    X(bool, g_is_hoist_type) \
+    X(bool, g_do_ipa) \
+    X(bool, g_do_call_graph) \
+    X(bool, g_show_comp_time) \
+    X(bool, g_show_memory_usage) \
+    X(bool, g_do_inline) \
+    X(UINT, g_inline_threshold) \
+    X(bool, g_is_opt_float) \
+    X(bool, g_is_lower_to_pr_mode) \
+    X(bool, g_is_support_dynamic_type) \
+    X(bool, g_do_ssa) \
+    X(bool, g_do_md_ssa) \
+    X(bool, g_do_cfg) \
+    X(bool, g_do_rpo) \
+    X(bool, g_do_loop_ana) \
+    X(bool, g_do_cfg_remove_empty_bb) \
+    X(bool, g_do_cfg_remove_unreach_bb) \
+    X(bool, g_do_cfg_remove_trampolin_bb) \
+    X(bool, g_do_cfg_remove_redundant_branch) \
+    X(bool, g_do_cfg_dom) \
+    X(bool, g_do_cfg_pdom) \
+    X(bool, g_do_cdg) \
+    X(bool, g_do_aa) \
+    X(bool, g_do_md_du_ana) \
+    X(bool, g_compute_du_chain) \
+    X(bool, g_lazy_du_chain) \
+    X(bool, g_compute_available_exp) \
+    X(bool, g_compute_region_imported_defuse_md) \
+    X(bool, g_do_expr_tab) \
+    X(bool, g_do_dce) \
+    X(bool, g_do_dce_aggressive) \
+    X(bool, g_do_cp_aggressive) \
+    X(bool, g_do_cp) \
+    X(bool, g_do_ccp) \
+    X(bool, g_do_rp) \
+    X(bool, g_do_gcse) \
+    X(bool, g_do_lcse) \
+    X(bool, g_do_pre) \
+    X(bool, g_do_rce) \
+    X(bool, g_do_dse) \
+    X(bool, g_do_licm) \
+    X(bool, g_do_ivr) \
+    X(bool, g_do_gvn) \
+    X(bool, g_do_cfs_opt) \
+    X(bool, g_build_cfs) \
+    X(bool, g_cst_bb_list) \
+    X(UINT, g_thres_opt_ir_num) \
+    X(UINT, g_thres_opt_bb_num) \
+    X(bool, g_do_loop_convert) \
+    X(bool, g_do_poly_tran) \
+    X(bool, g_retain_pass_mgr_for_region) \
+    X(UINT, g_verify_level) \
+    X(bool, g_is_flat_sbs) \
+    X(CHAR const*, g_sbs_trace_file) \
+    X(bool, g_is_arena_pool) \
+    X(bool, g_is_dom_tree) \
+    X(bool, g_is_intern_mdset) \
+    X(bool, g_is_sparse_gvn) \
+    X(bool, g_is_simplify_parameter)
+
+//This class records the value of thread local options. It is used to
+//propagate the options of main thread to compilation thread.
+//e.g: In main thread:
+//        OptionSnapshot os; //save options of main thread.
+//     In compilation thread:
+//        os.restore();
+class OptionSnapshot {
+public:
+    #define DECL_OPTION_MEMBER(ty, name) ty name;
+    FOR_EACH_THREAD_OPTION(DECL_OPTION_MEMBER)
+    #undef DECL_OPTION_MEMBER
+
+public:
+    OptionSnapshot() { save(); }
+
+    //Record the options of current thread.
+    void save();
+
+    //Set the options of current thread with recorded value.
+    void restore() const;
+};
 
 } //namespace xoc
 #endif
@@ -38,12 +38,29 @@ namespace xoc {
 
 class SimpCtx;
 
+//Describe the facts of IR that pass depends on or may change.
+//PassMgr performs pass again only if the facts it depends on have
+//been changed by other passes since its last run.
+typedef enum {
+    FACT_UNDEF = 0,
+    FACT_STMT = 0x1, //Insert, remove or move stmt.
+    FACT_EXP = 0x2, //Rewrite expression of stmt.
+    FACT_CFG = 0x4, //Change BB or edge of CFG.
+    FACT_LOOP = 0x8, //Change loop structure, or move stmt across loop.
+    FACT_ALL = 0xF,
+} FACT_TYPE;
+
+
 //Basis Class of pass.
 class Pass {
 protected:
     SimpCtx * m_simp;
+
+    //Record BBs that changed since last run of pass.
+    //NULL means all BBs have to be processed.
+    BitSet const* m_changed_bbs;
 public:
-    Pass() { m_simp = NULL; }
+    Pass() { m_simp = NULL; m_changed_bbs = NULL; }
     virtual ~Pass() {}
     COPY_CONSTRUCTOR(Pass);
 
@@ -59,6 +76,23 @@ public:
         return PASS_UNDEF;
     }
 
+    //Return the facts that pass depends on, the combination of FACT_TYPE.
+    virtual UINT get_consumed_fact() const { return FACT_ALL; }
+
+    //Return the facts that pass may change if it reports change,
+    //the combination of FACT_TYPE.
+    virtual UINT get_changed_fact() const { return FACT_ALL; }
+
+    //Return true if pass only transforms IR inside BB, and the result
+    //does not depend on other BBs. Such pass may skip the BBs that have
+    //not changed since its last run.
+    virtual bool is_bb_local() const { return false; }
+
+    //Return true if pass keeps MD SSA form up to date when it changes
+    //IR, otherwise MD SSA form is invalid after pass reports change.
+    virtual bool is_md_ssa_maintained() const { return false; }
+
+    void set_changed_bbs(BitSet const* bbs) { m_changed_bbs = bbs; }
     void set_simp_cont(SimpCtx * simp) { m_simp = simp; }
 
     virtual bool perform(OptCtx &)
@@ -117,8 +117,7 @@ Pass * PassMgr::allocRP()
 
 Pass * PassMgr::allocPRE()
 {
-    //return new IR_PRE(m_ru);
-    return NULL;
+    return new IR_PRE(m_ru);
 }
 
 
@@ -142,8 +141,7 @@ Pass * PassMgr::allocDCE()
 
 Pass * PassMgr::allocDSE()
 {
-    //return new IR_DSE(m_ru);
-    return NULL;
+    return new IR_DSE(m_ru);
 }
 
 
@@ -155,6 +153,9 @@ Pass * PassMgr::allocRCE()
 
 Pass * PassMgr::allocGVN()
 {
+    if (g_is_sparse_gvn) {
+        return new IR_SGVN(m_ru);
+    }
     return new IR_GVN(m_ru);
 }
 
@@ -171,6 +172,12 @@ Pass * PassMgr::allocSSAMgr()
 }
 
 
+Pass * PassMgr::allocMDSSAMgr()
+{
+    return new MDSSAMgr(m_ru);
+}
+
+
 Graph * PassMgr::allocCDG()
 {
     return new CDG(m_ru);
@@ -179,8 +186,7 @@ Graph * PassMgr::allocCDG()
 
 Pass * PassMgr::allocCCP()
 {
-    //return new IR_CCP(m_ru, (IR_SSA_MGR*)registerPass(PASS_SSA_MGR));
-    return NULL;
+    return new IR_CCP(m_ru, (IR_SSA_MGR*)registerPass(PASS_SSA_MGR));
 }
 
 
@@ -298,6 +304,9 @@ Pass * PassMgr::registerPass(PASS_TYPE opty)
     case PASS_SSA_MGR:
         pass = allocSSAMgr();
         break;
+    case PASS_MD_SSA_MGR:
+        pass = allocMDSSAMgr();
+        break;
     case PASS_CCP:
         pass = allocCCP();
         break;
@@ -324,6 +333,178 @@ Pass * PassMgr::registerPass(PASS_TYPE opty)
 }
 
 
+//Mix the attributes of 'ir' into 'h', except its kids.
+//Passes may modify these attributes in place, e.g: CP replaces the
+//value of constant, and RP renames PR.
+static UINT hashIRNode(IR const* ir, UINT h)
+{
+    h = h * 31 + (IR_id(ir) ^ ((UINT)ir->get_code() << 24));
+    h = h * 31 + (UINT)(size_t)ir->get_type();
+    h = h * 31 + ir->get_offset();
+    h = h * 31 + (UINT)(size_t)ir->get_label();
+    switch (ir->get_code()) {
+    case IR_CONST:
+        h = h * 31 + (UINT)CONST_int_val(ir);
+        h = h * 31 + (UINT)((ULONGLONG)CONST_int_val(ir) >> 32);
+        break;
+    case IR_ID: h = h * 31 + VAR_id(ID_info(ir)); break;
+    case IR_LD: h = h * 31 + VAR_id(LD_idinfo(ir)); break;
+    case IR_ST: h = h * 31 + VAR_id(ST_idinfo(ir)); break;
+    case IR_LDA: h = h * 31 + VAR_id(LDA_idinfo(ir)); break;
+    case IR_CALL:
+        h = h * 31 + VAR_id(CALL_idinfo(ir));
+        h = h * 31 + CALL_prno(ir);
+        break;
+    case IR_ICALL: h = h * 31 + CALL_prno(ir); break;
+    case IR_PR:
+    case IR_STPR:
+    case IR_GETELEM:
+    case IR_SETELEM:
+    case IR_PHI:
+        h = h * 31 + ir->get_prno();
+        break;
+    default: break;
+    }
+    return h;
+}
+
+
+//Compute the fingerprint of each BB, and record 'stamp' for the BB
+//whose fingerprint changed. The fingerprint covers the whole tree of
+//each stmt, it changes if stmt or expression in BB is inserted, removed,
+//replaced, or modified in place.
+void PassMgr::updateBBStamp(UINT stamp,
+                            IN OUT Vector<UINT> & bb_hash,
+                            IN OUT Vector<UINT> & bb_stamp)
+{
+    ConstIRIter it;
+    BBList * bbl = m_ru->get_bb_list();
+    C<IRBB*> * ctbb;
+    for (bbl->get_head(&ctbb); ctbb != bbl->end(); ctbb = bbl->get_next(ctbb)) {
+        IRBB * bb = ctbb->val();
+        UINT h = BB_irlist(bb).get_elem_count();
+        C<IR*> * ct;
+        for (BB_irlist(bb).get_head(&ct);
+             ct != BB_irlist(bb).end(); ct = BB_irlist(bb).get_next(ct)) {
+            it.clean();
+            for (IR const* x = iterInitC(ct->val(), it);
+                 x != NULL; x = iterNextC(it)) {
+                h = hashIRNode(x, h);
+            }
+        }
+        if (bb_hash.get(BB_id(bb)) != h) {
+            bb_hash.set(BB_id(bb), h);
+            bb_stamp.set(BB_id(bb), stamp);
+        }
+    }
+}
+
+
+//Perform passes in 'passlist' until none of them changes IR.
+//Pass is performed only if the facts it consumes have been changed since
+//its last run. Pass that only transforms IR inside BB is informed the
+//BBs changed since its last run.
+void PassMgr::performPassList(List<Pass*> & passlist, OptCtx & oc)
+{
+    //The following vectors are indexed by the position in 'passlist',
+    //since one pass may appear several times in list.
+    Vector<UINT> dirty; //facts changed since last run.
+    Vector<UINT> last_stamp; //stamp when pass performed last time.
+    Vector<ULONGLONG> time;
+    Vector<UINT> run_count;
+    Vector<UINT> change_count;
+    bool has_local = false;
+    UINT n = 0;
+    for (Pass * pass = passlist.get_head();
+         pass != NULL; pass = passlist.get_next(), n++) {
+        dirty.set(n, FACT_ALL);
+        has_local |= pass->is_bb_local();
+    }
+
+    //The stamp increases each time a pass is performed.
+    UINT stamp = 0;
+    Vector<UINT> bb_hash;
+    Vector<UINT> bb_stamp;
+    BitSet changed_bbs;
+    if (has_local) {
+        updateBBStamp(stamp, bb_hash, bb_stamp);
+    }
+
+    BBList * bbl = m_ru->get_bb_list();
+    IR_CFG * cfg = m_ru->get_cfg();
+    UNUSED(cfg);
+    bool has_dirty = true;
+    UINT count = 0;
+    while (has_dirty && count < 20) {
+        has_dirty = false;
+        UINT i = 0;
+        for (Pass * pass = passlist.get_head();
+             pass != NULL; pass = passlist.get_next(), i++) {
+            if ((dirty.get(i) & pass->get_consumed_fact()) == 0) { continue; }
+            dirty.set(i, FACT_UNDEF);
+
+            if (pass->is_bb_local() && run_count.get(i) != 0) {
+                changed_bbs.clean();
+                C<IRBB*> * ct;
+                for (bbl->get_head(&ct); ct != bbl->end();
+                     ct = bbl->get_next(ct)) {
+                    if (bb_stamp.get(BB_id(ct->val())) > last_stamp.get(i)) {
+                        changed_bbs.bunion(BB_id(ct->val()));
+                    }
+                }
+                pass->set_changed_bbs(&changed_bbs);
+            }
+
+            ASSERT0(verifyIRandBB(bbl, m_ru));
+            ULONGLONG t = getusec();
+            bool doit = pass->perform(oc);
+            time.set(i, time.get(i) + getusec() - t);
+            m_ru->destroyInvalidMDSSA(oc);
+            pass->set_changed_bbs(NULL);
+            run_count.set(i, run_count.get(i) + 1);
+            last_stamp.set(i, stamp);
+            stamp++;
+            if (!doit) { continue; }
+
+            change_count.set(i, change_count.get(i) + 1);
+            ASSERT0(verifyIRandBB(bbl, m_ru));
+            ASSERT0(cfg->verify());
+
+            UINT fact = pass->get_changed_fact();
+            RefineCtx rc;
+            if (m_ru->refineBBlist(bbl, rc)) {
+                fact |= FACT_STMT | FACT_EXP;
+                OC_is_md_ssa_valid(oc) = false;
+            } else if (!pass->is_md_ssa_maintained()) {
+                OC_is_md_ssa_valid(oc) = false;
+            }
+            ASSERT0(m_ru->verifyRPO(oc));
+
+            if (has_local) {
+                updateBBStamp(stamp, bb_hash, bb_stamp);
+            }
+
+            //Passes that consume the facts, include current pass itself,
+            //have to be performed again.
+            for (UINT j = 0; j < n; j++) {
+                dirty.set(j, dirty.get(j) | fact);
+            }
+            has_dirty = true;
+        }
+        count++;
+    }
+    ASSERT0(!has_dirty);
+
+    UINT i = 0;
+    for (Pass * pass = passlist.get_head();
+         pass != NULL; pass = passlist.get_next(), i++) {
+        if (run_count.get(i) == 0) { continue; }
+        appendTimeInfo(pass->get_pass_name(), time.get(i),
+                       run_count.get(i), change_count.get(i));
+    }
+}
+
+
 void PassMgr::performScalarOpt(OptCtx & oc)
 {
     TTab<Pass*> opt_tab;
@@ -365,6 +546,10 @@ void PassMgr::performScalarOpt(OptCtx & oc)
         }
     }
 
+    if (g_do_ccp && in_ssa_form) {
+        passlist.append_tail(registerPass(PASS_CCP));
+    }
+
     if (g_do_cp) {
         IR_CP * pass = (IR_CP*)registerPass(PASS_CP);
         pass->set_prop_kind(CP_PROP_SIMPLEX);
@@ -404,38 +589,15 @@ void PassMgr::performScalarOpt(OptCtx & oc)
         passlist.append_tail(registerPass(PASS_LOOP_CVT));
     }
 
-    bool change;
-    UINT count = 0;
-    BBList * bbl = m_ru->get_bb_list();
-    IR_CFG * cfg = m_ru->get_cfg();
-    UNUSED(cfg);
-    do {
-        change = false;
-        for (Pass * pass = passlist.get_head();
-             pass != NULL; pass = passlist.get_next()) {
-            CHAR const* passname = pass->get_pass_name();
-            ASSERT0(verifyIRandBB(bbl, m_ru));
-            ULONGLONG t = getusec();
-            bool doit = pass->perform(oc);
-            appendTimeInfo(passname, getusec() - t);
-            if (doit) {
-                change = true;
-                ASSERT0(verifyIRandBB(bbl, m_ru));
-                ASSERT0(cfg->verify());
-            }
-            RefineCtx rc;
-            m_ru->refineBBlist(bbl, rc);
-            ASSERT0(m_ru->verifyRPO(oc));
-        }
-        count++;
-    } while (change && count < 20);
-    ASSERT0(!change);
+    performPassList(passlist, oc);
 
     if (g_do_lcse) {
         IR_LCSE * lcse = (IR_LCSE*)registerPass(PASS_LCSE);
         lcse->set_enable_filter(false);
         ULONGLONG t = getusec();
-        lcse->perform(oc);
+        if (lcse->perform(oc)) {
+            OC_is_md_ssa_valid(oc) = false;
+        }
         t = getusec() - t;
         appendTimeInfo(lcse->get_pass_name(), t);
     }
@@ -443,7 +605,9 @@ void PassMgr::performScalarOpt(OptCtx & oc)
     if (g_do_rp) {
         IR_RP * r = (IR_RP*)registerPass(PASS_RP);
         ULONGLONG t = getusec();
-        r->perform(oc);
+        if (r->perform(oc)) {
+            OC_is_md_ssa_valid(oc) = false;
+        }
         appendTimeInfo(r->get_pass_name(), getusec() - t);
     }
 }
@@ -39,10 +39,14 @@ namespace xoc {
 //Time Info.
 #define TI_pn(ti)        (ti)->pass_name
 #define TI_pt(ti)        (ti)->pass_time
+#define TI_run(ti)       (ti)->run_count
+#define TI_chg(ti)       (ti)->change_count
 class TimeInfo {
 public:
     CHAR const* pass_name;
     ULONGLONG pass_time;
+    UINT run_count; //the number of times pass performed.
+    UINT change_count; //the number of times pass reported change.
 };
 
 
@@ -65,6 +69,9 @@ protected:
         return p;
     }
     Graph * registerGraphBasedPass(PASS_TYPE opty);
+    void updateBBStamp(UINT stamp, IN OUT Vector<UINT> & bb_hash,
+                       IN OUT Vector<UINT> & bb_stamp);
+    void performPassList(List<Pass*> & passlist, OptCtx & oc);
 public:
     PassMgr(Region * ru);
     COPY_CONSTRUCTOR(PassMgr);
@@ -74,11 +81,14 @@ public:
         smpoolDelete(m_pool);
     }
 
-    void appendTimeInfo(CHAR const* pass_name, ULONGLONG t)
+    void appendTimeInfo(CHAR const* pass_name, ULONGLONG t,
+                        UINT run_count = 1, UINT change_count = 0)
     {
         TimeInfo * ti = (TimeInfo*)xmalloc(sizeof(TimeInfo));
         TI_pn(ti) = pass_name;
         TI_pt(ti) = t;
+        TI_run(ti) = run_count;
+        TI_chg(ti) = change_count;
         m_ti_list.append_tail(ti);
     }
 
@@ -99,6 +109,7 @@ public:
     virtual Pass * allocGVN();
     virtual Pass * allocLoopCvt();
     virtual Pass * allocSSAMgr();
+    virtual Pass * allocMDSSAMgr();
     virtual Pass * allocCCP();
     virtual Pass * allocExprTab();
     virtual Pass * allocCfsMgr();
@@ -115,8 +126,8 @@ public:
         fprintf(g_tfile, "\n==---- PASS TIME INFO ----==");
         for (TimeInfo * ti = m_ti_list.get_head(); ti != NULL;
              ti = m_ti_list.get_next()) {
-            fprintf(g_tfile, "\n * %s --- use %llu ms ---",
-                    TI_pn(ti), TI_pt(ti));
+            fprintf(g_tfile, "\n * %s --- use %llu ms, run %u, change %u ---",
+                    TI_pn(ti), TI_pt(ti), TI_run(ti), TI_chg(ti));
         }
         fprintf(g_tfile, "\n===----------------------------------------===");
         fflush(g_tfile);
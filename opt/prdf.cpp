@@ -236,7 +236,8 @@ In actually , $pr4 only lived out from BB1, and $pr3 only lived out
 from BB2. For present, $pr4 both live out from BB1 and BB2, and $pr3
 is similar. */
 #ifdef STATISTIC_PRDF
-static UINT g_max_times = 0;
+//Regions may be processed by multiple threads.
+static THREAD_LOCAL UINT g_max_times = 0;
 #endif
 void PRDF::computeGlobal()
 {
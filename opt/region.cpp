@@ -122,9 +122,16 @@ AnalysisInstrument::AnalysisInstrument(Region * ru) :
 
     //Counter of IR_PR, and do not use '0' as prno.
     m_pr_count = 1;
-    m_pool = smpoolCreate(256, MEM_COMM);
-    m_du_pool = smpoolCreate(sizeof(DU) * 4, MEM_CONST_SIZE);
+    if (g_is_arena_pool) {
+        m_pool = smpoolCreateArena(256, MEM_COMM);
+        m_du_pool = smpoolCreateArena(sizeof(DU) * 4, MEM_CONST_SIZE);
+    } else {
+        m_pool = smpoolCreate(256, MEM_COMM);
+        m_du_pool = smpoolCreate(sizeof(DU) * 4, MEM_CONST_SIZE);
+    }
     memset(m_free_tab, 0, sizeof(m_free_tab));
+    m_sbs_mgr.set_flat(g_is_flat_sbs);
+    m_mds_hash.set_op_cache(g_is_intern_mdset);
 }
 
 
@@ -185,6 +192,8 @@ AnalysisInstrument::~AnalysisInstrument()
     if (REGION_refinfo(m_ru) != NULL) {
         REF_INFO_mayuse(REGION_refinfo(m_ru)).clean(m_sbs_mgr);
         REF_INFO_maydef(REGION_refinfo(m_ru)).clean(m_sbs_mgr);
+        REF_INFO_mod(REGION_refinfo(m_ru)).clean(m_sbs_mgr);
+        REF_INFO_ref(REGION_refinfo(m_ru)).clean(m_sbs_mgr);
 
         //REGION_refinfo allocated in pool.
         REGION_refinfo(m_ru) = NULL;
@@ -260,6 +269,9 @@ size_t AnalysisInstrument::count_mem()
     count += m_mds_hash.count_mem();
     count += m_ir_vector.count_mem();
     count += m_ir_bb_list.count_mem();
+    #ifdef _COMPACT_IR_
+    count += m_ir_slab.count_mem();
+    #endif
     return count;
 }
 //END AnalysisInstrument
@@ -2033,7 +2045,11 @@ IR * Region::allocIR(IR_TYPE irt)
     }
 
     if (ir == NULL) {
+        #ifdef _COMPACT_IR_
+        ir = REGION_analysis_instrument(this)->m_ir_slab.alloc(IRTSIZE(irt));
+        #else
         ir = (IR*)xmalloc(IRTSIZE(irt));
+        #endif
         INT v = MAX(get_ir_vec()->get_last_idx(), 0);
         IR_id(ir) = (UINT)(v+1);
         get_ir_vec()->set(IR_id(ir), ir);
@@ -2087,9 +2103,10 @@ void Region::freeIR(IR * ir)
     //Zero clearing all data fields.
     UINT res_id = IR_id(ir);
     UINT res_irt_sz = get_irt_size(ir);
+    IRAISlot res_ai_slot = IR_ai_slot(ir);
     memset(ir, 0, res_irt_sz);
     IR_id(ir) = res_id;
-    IR_ai(ir) = res_ai;
+    IR_ai_slot(ir) = res_ai_slot;
     set_irt_size(ir, res_irt_sz);
 
     UINT idx = res_irt_sz - sizeof(IR);
@@ -2141,11 +2158,11 @@ IR * Region::dupIR(IR const* src)
     ASSERT(res != NULL && src != NULL, ("res/src is NULL"));
 
     UINT res_id = IR_id(res);
-    AIContainer * res_ai = IR_ai(res);
+    IRAISlot res_ai_slot = IR_ai_slot(res);
     UINT res_irt_sz = get_irt_size(res);
     memcpy(res, src, IRTSIZE(irt));
     IR_id(res) = res_id;
-    IR_ai(res) = res_ai;
+    IR_ai_slot(res) = res_ai_slot;
     set_irt_size(res, res_irt_sz);
     IR_next(res) = IR_prev(res) = IR_parent(res) = NULL;
     res->cleanDU(); //Do not copy DU info.
@@ -2371,6 +2388,11 @@ void Region::dumpMemUsage()
     else { count /= 1024 * 1024 * 1024; str = "GB"; }
 
     note("\n'%s' use %lu%s memory", get_ru_name(), count, str);
+    if ((is_subregion() || is_function() || is_eh() || is_program()) &&
+        REGION_analysis_instrument(this) != NULL) {
+        dumpPoolStat(REGION_analysis_instrument(this)->m_pool, g_tfile);
+        dumpPoolStat(REGION_analysis_instrument(this)->m_du_pool, g_tfile);
+    }
 
     Vector<IR*> * v = get_ir_vec();
     UINT nid = 0;
@@ -2858,6 +2880,7 @@ void Region::dumpVarMD(VAR * v, UINT indent)
 {
     StrBuf buf(64);
     ConstMDIter iter;
+    MutexHolder h(get_md_sys()->get_lock());
     MDTab * mdtab = get_md_sys()->get_md_tab(v);
     if (mdtab != NULL) {
         MD const* x = mdtab->get_effect_md();
@@ -2970,6 +2993,19 @@ void Region::dumpVARInRegion()
 }
 
 
+//The form that is out of date may refer to IR that has been freed.
+//Destroy it, thus IR_DU_MGR will not maintain it while removing IR.
+void Region::destroyInvalidMDSSA(OptCtx const& oc)
+{
+    if (OC_is_md_ssa_valid(oc) || get_pass_mgr() == NULL) { return; }
+    MDSSAMgr * mdssamgr =
+        (MDSSAMgr*)get_pass_mgr()->queryPass(PASS_MD_SSA_MGR);
+    if (mdssamgr != NULL && mdssamgr->is_ssa_constructed()) {
+        mdssamgr->destroy();
+    }
+}
+
+
 void Region::checkValidAndRecompute(OptCtx * oc, ...)
 {
     BitSet opts;
@@ -2994,6 +3030,17 @@ void Region::checkValidAndRecompute(OptCtx * oc, ...)
     IR_CFG * cfg = (IR_CFG*)passmgr->queryPass(PASS_CFG);
     IR_AA * aa = NULL;
     IR_DU_MGR * dumgr = NULL;
+    destroyInvalidMDSSA(*oc);
+    MDSSAMgr * mdssamgr = (MDSSAMgr*)passmgr->queryPass(PASS_MD_SSA_MGR);
+
+    //DU chain can be updated locally if it is only dirty, namely,
+    //the changes have been recorded by DU manager and both of
+    //CFG and MD reference are still available.
+    bool du_dirty = OC_is_du_chain_dirty(*oc) &&
+                    !OC_is_du_chain_valid(*oc) &&
+                    OC_is_ref_valid(*oc) &&
+                    OC_is_cfg_valid(*oc) &&
+                    !opts.is_contain(PASS_REACH_DEF);
 
     if (opts.is_contain(PASS_CFG) && !OC_is_cfg_valid(*oc)) {
         if (cfg == NULL) {
@@ -3041,6 +3088,12 @@ void Region::checkValidAndRecompute(OptCtx * oc, ...)
         cfg->computePdomAndIpdom(*oc);
     }
 
+    if (cfg != NULL &&
+        (opts.is_contain(PASS_DOM) || opts.is_contain(PASS_PDOM))) {
+        //Dominator tree may have been updated incrementally.
+        cfg->computeDomTreeOrder();
+    }
+
     if (opts.is_contain(PASS_CDG) && !OC_is_cdg_valid(*oc)) {
         ASSERT0(passmgr);
         CDG * cdg = (CDG*)passmgr->registerPass(PASS_CDG);
@@ -3070,7 +3123,8 @@ void Region::checkValidAndRecompute(OptCtx * oc, ...)
 
     if (opts.is_contain(PASS_DU_CHAIN) &&
         !OC_is_du_chain_valid(*oc) &&
-        !OC_is_reach_def_valid(*oc)) {
+        !OC_is_reach_def_valid(*oc) &&
+        !du_dirty) {
         f |= SOL_REACH_DEF;
     }
 
@@ -3111,6 +3165,9 @@ void Region::checkValidAndRecompute(OptCtx * oc, ...)
         dumgr->perform(*oc, f);
         if (HAVE_FLAG(f, SOL_REF)) {
             ASSERT0(verifyMDRef());
+
+            //MD SSA is built on MD reference.
+            OC_is_md_ssa_valid(*oc) = false;
         }
         if (HAVE_FLAG(f, SOL_AVAIL_EXPR)) {
             ASSERT0(dumgr->verifyLiveinExp());
@@ -3125,13 +3182,28 @@ void Region::checkValidAndRecompute(OptCtx * oc, ...)
             dumgr = (IR_DU_MGR*)passmgr->registerPass(PASS_DU_MGR);
         }
 
-        if (opts.is_contain(PASS_REACH_DEF)) {
+        if (du_dirty && OC_is_ref_valid(*oc)) {
+            dumgr->updateDirtyDUChain(*oc);
+        } else if (opts.is_contain(PASS_REACH_DEF)) {
             dumgr->computeMDDUChain(*oc, true);
         } else {
             dumgr->computeMDDUChain(*oc, false);
         }
     }
 
+    if (opts.is_contain(PASS_MD_SSA_MGR) &&
+        (!OC_is_md_ssa_valid(*oc) ||
+         mdssamgr == NULL ||
+         !mdssamgr->is_ssa_constructed()) &&
+        get_bb_list() != NULL &&
+        get_bb_list()->get_elem_count() != 0) {
+        ASSERT(OC_is_ref_valid(*oc),
+               ("You should make MD reference available first."));
+        mdssamgr = (MDSSAMgr*)passmgr->registerPass(PASS_MD_SSA_MGR);
+        ASSERT0(mdssamgr);
+        mdssamgr->construction(*oc);
+    }
+
     if (opts.is_contain(PASS_EXPR_TAB) &&
         !OC_is_expr_tab_valid(*oc) &&
         get_bb_list() != NULL &&
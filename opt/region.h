@@ -73,6 +73,9 @@ public:
     IR * m_free_tab[MAX_OFFSET_AT_FREE_TABLE + 1];
     Vector<VAR*> m_prno2var; //map prno to related VAR.
     Vector<IR*> m_ir_vector; //record IR which have allocated.
+    #ifdef _COMPACT_IR_
+    IRSlabMgr m_ir_slab; //allocate IR in slabs.
+    #endif
     BitSetMgr m_bs_mgr;
     DefMiscBitSetMgr m_sbs_mgr;
     MDSetMgr m_mds_mgr;
@@ -98,16 +101,32 @@ public:
 //Region referrence info.
 #define REF_INFO_maydef(ri)     ((ri)->may_def_mds)
 #define REF_INFO_mayuse(ri)     ((ri)->may_use_mds)
+#define REF_INFO_mod(ri)        ((ri)->mod_mds)
+#define REF_INFO_ref(ri)        ((ri)->ref_mds)
+#define REF_INFO_is_modref_valid(ri) ((ri)->is_modref_valid)
 class RefInfo {
 public:
     MDSet may_def_mds; //Record the MD set for Region usage
     MDSet may_use_mds; //Record the MD set for Region usage
 
+    //Mod/Ref summary of function region that computed by IPA.
+    //They record the global MDs that may be modified or read by calling
+    //the function, include the side effect of callees. The memory that
+    //parameters pointed to is not recorded, caller takes it into
+    //account at each call site. The summary is valid only if the
+    //function does not access unknown memory, e.g: memory reachable
+    //from non-restrict parameter, see IPA::collectModRef().
+    MDSet mod_mds;
+    MDSet ref_mds;
+    bool is_modref_valid;
+
     size_t count_mem()
     {
         size_t c = sizeof(RefInfo);
         c += may_def_mds.count_mem();
         c += may_use_mds.count_mem();
+        c += mod_mds.count_mem();
+        c += ref_mds.count_mem();
         return c;
     }
 };
@@ -372,6 +391,9 @@ public:
 
     virtual void destroy();
     void destroyPassMgr();
+
+    //Destroy MD SSA form if it is invalid in 'oc'.
+    void destroyInvalidMDSSA(OptCtx const& oc);
     IR * dupIR(IR const* ir);
     IR * dupIRTree(IR const* ir);
     IR * dupIRTreeList(IR const* ir);
@@ -525,6 +547,22 @@ public:
     MDSet * get_may_use() const
     { return m_ref_info != NULL ? &REF_INFO_mayuse(m_ref_info) : NULL; }
 
+    //Get the Mod summary of function region.
+    //Return NULL if the summary is not available.
+    MDSet const* get_mod_summary() const
+    {
+        return m_ref_info != NULL && REF_INFO_is_modref_valid(m_ref_info) ?
+               &REF_INFO_mod(m_ref_info) : NULL;
+    }
+
+    //Get the Ref summary of function region.
+    //Return NULL if the summary is not available.
+    MDSet const* get_ref_summary() const
+    {
+        return m_ref_info != NULL && REF_INFO_is_modref_valid(m_ref_info) ?
+               &REF_INFO_ref(m_ref_info) : NULL;
+    }
+
     Region * getTopRegion()
     {
         Region * ru = this;
@@ -537,9 +575,7 @@ public:
     //Allocate a internal LabelInfo that is not declared by compiler user.
     inline LabelInfo * genIlabel()
     {
-        LabelInfo * li = genIlabel(RM_label_count(get_region_mgr()));
-        RM_label_count(get_region_mgr())++;
-        return li;
+        return genIlabel(get_region_mgr()->genLabelId());
     }
 
     //Allocate a LabelInfo accroding to given 'labid'.
@@ -65,6 +65,11 @@ RegionMgr::~RegionMgr()
         delete m_call_graph;
         m_call_graph = NULL;
     }
+
+    if (m_shared_lock != NULL) {
+        delete m_shared_lock;
+        m_shared_lock = NULL;
+    }
 }
 
 
@@ -80,6 +85,7 @@ MD const* RegionMgr::genDedicateStrMD()
     if (!m_is_regard_str_as_same_md) { return NULL; }
 
     //Regard all string variables as same unbound MD.
+    MutexHolder h(m_shared_lock);
     if (m_str_md == NULL) {
         SYM * s = addToSymbolTab("DedicatedVarBeRegardedAsString");
         VAR * sv = get_var_mgr()->registerStringVar("DedicatedStringVar", s, 1);
@@ -159,7 +165,8 @@ Region * RegionMgr::newRegion(REGION_TYPE rt)
     #endif
 
     Region * ru = allocRegion(rt);
-    UINT free_id = m_free_ru_id.remove_head();
+    MutexHolder h(m_shared_lock);
+    UINT free_id = m_shared_lock != NULL ? 0 : m_free_ru_id.remove_head();
     if (free_id == 0) {
         REGION_id(ru) = m_ru_count++;
     } else {
@@ -176,6 +183,7 @@ void RegionMgr::addToRegionTab(Region * ru)
     ASSERT(REGION_id(ru) > 0, ("should generate new region via newRegion()"));
     ASSERT0(get_region(REGION_id(ru)) == NULL);
     ASSERT0(REGION_id(ru) < m_ru_count);
+    MutexHolder h(m_shared_lock);
     m_id2ru.set(REGION_id(ru), ru);
 }
 
@@ -280,6 +288,7 @@ void RegionMgr::deleteRegion(Region * ru, bool collect_id)
     delete ru;
 
     if (collect_id && id != 0) {
+        MutexHolder h(m_shared_lock);
         m_id2ru.set(id, NULL);
         m_free_ru_id.append_head(id);
     }
@@ -291,6 +300,52 @@ void RegionMgr::deleteRegion(Region * ru, bool collect_id)
 }
 
 
+//Regard Regions, VARs and MDs allocated so far as persistent objects,
+//which will be kept by reset().
+void RegionMgr::setResetPoint()
+{
+    ASSERT(m_var_mgr && m_md_sys, ("invoke initVarMgr() at first"));
+    ASSERT(m_free_ru_id.get_elem_count() == 0,
+           ("region id can not be recycled before reset point"));
+    m_reset_ru_count = m_ru_count;
+    m_reset_label_count = m_label_count;
+    m_var_mgr->setResetPoint();
+    m_md_sys->setResetPoint();
+}
+
+
+//Reset RegionMgr to the state at the time setResetPoint() invoked.
+void RegionMgr::reset()
+{
+    ASSERT(m_reset_ru_count != 0, ("invoke setResetPoint() at first"));
+
+    //Regions should be destroyed before VARs and MDs since they
+    //may refer to them.
+    for (INT id = m_reset_ru_count; id <= m_id2ru.get_last_idx(); id++) {
+        Region * ru = m_id2ru.get(id);
+        if (ru == NULL) { continue; }
+        deleteRegion(ru, false);
+        m_id2ru.set(id, NULL);
+    }
+    m_free_ru_id.clean();
+    m_ru_count = m_reset_ru_count;
+    m_label_count = m_reset_label_count;
+
+    if (m_call_graph != NULL) {
+        delete m_call_graph;
+        m_call_graph = NULL;
+    }
+
+    //MDs should be freed before VARs since MDTab is keyed by VAR.
+    m_md_sys->reset();
+    if (m_str_md != NULL && m_md_sys->read_md(MD_id(m_str_md)) == NULL) {
+        //Dedicated string MD has been freed.
+        m_str_md = NULL;
+    }
+    m_var_mgr->reset();
+}
+
+
 void RegionMgr::estimateEV(
         OUT UINT & num_call,
         OUT UINT & num_ru,
@@ -350,6 +405,230 @@ bool RegionMgr::processFuncRegion(Region * func, OptCtx * oc)
 }
 
 
+void RegionMgr::setSharedLock(bool lock)
+{
+    if (lock == (m_shared_lock != NULL)) { return; }
+    Mutex * m = NULL;
+    if (lock) {
+        m = new Mutex();
+    }
+    m_type_mgr.set_lock(m);
+    if (m_var_mgr != NULL) {
+        m_var_mgr->set_lock(m);
+    }
+    if (m_md_sys != NULL) {
+        m_md_sys->set_lock(m);
+    }
+    if (m_shared_lock != NULL) {
+        delete m_shared_lock;
+    }
+    m_shared_lock = m;
+}
+
+
+//Describe the function regions that processed by ThreadPool.
+class FuncRegionTaskList {
+public:
+    RegionMgr * rumgr;
+    OptionSnapshot const* options;
+
+    //Regions of each task, they are processed in order.
+    Vector<List<Region*>*> * task2rus;
+
+    //Ranges of id reserved for each task.
+    TaskIdRange * ranges;
+
+    //Record whether each task succeeded.
+    bool * succ;
+};
+
+
+//Estimate the number of VAR, MD and label ids that processing 'ru'
+//consumes. Passes may introduce a few PRs for each IR, and each PR
+//corresponds to a VAR and a MD.
+static UINT estimateIdNum(Region * ru)
+{
+    UINT n = 0;
+    ConstIRIter it;
+    for (IR const* x = iterInitC(ru->get_ir_list(), it);
+         x != NULL; x = iterNextC(it)) {
+        n++;
+    }
+    BBList * bbl = ru->get_bb_list();
+    for (IRBB * bb = bbl->get_head(); bb != NULL; bb = bbl->get_next()) {
+        for (IR * ir = BB_first_ir(bb); ir != NULL; ir = BB_next_ir(bb)) {
+            it.clean();
+            for (IR const* x = iterInitC(ir, it);
+                 x != NULL; x = iterNextC(it)) {
+                n++;
+            }
+        }
+    }
+    return n * 4 + 16;
+}
+
+
+static void processFuncRegionTask(void * data, UINT task, UINT tid)
+{
+    FuncRegionTaskList * tl = (FuncRegionTaskList*)data;
+    List<Region*> * rus = tl->task2rus->get(task);
+    ASSERT0(rus);
+
+    //Options are thread local, propagate the value of main thread to
+    //current thread. Passes might modify options, restore them for
+    //each task.
+    tl->options->restore();
+
+    //Dump file is only accessed by main thread.
+    if (tid != 0) { g_tfile = NULL; }
+
+    g_task_id_range = &tl->ranges[task];
+    bool succ = true;
+    for (Region * ru = rus->get_head(); ru != NULL; ru = rus->get_next()) {
+        OptCtx oc;
+        if (!tl->rumgr->processFuncRegion(ru, &oc)) {
+            succ = false;
+        }
+    }
+    g_task_id_range = NULL;
+    tl->succ[task] = succ;
+}
+
+
+//Process function regions in bottom-up order of call graph.
+//Regions in same SCC of call graph are processed by one task in the
+//order of region id, and the SCCs in same level are processed
+//concurrently.
+//Before processing a level, each task reserves ranges of VAR, MD and
+//label id in the order of SCC id, and the MDs of global VARs, which are
+//shared by tasks, are registered in advance. Thus the ids do not depend
+//on the interleaving of threads. If a task uses up its range, the rest
+//ids are allocated from the shared counters.
+//NOTE: the ids of Region, VAR, MD and label are not recycled during
+//the processing.
+bool RegionMgr::processFuncRegionBottomUp(UINT thread_num)
+{
+    ASSERT0(thread_num > 0);
+    bool build_callg = m_call_graph == NULL;
+    if (build_callg) {
+        OptCtx oc;
+        buildCallGraph(oc, true, true);
+        if (!OC_is_callg_valid(oc)) {
+            delete m_call_graph;
+            m_call_graph = NULL;
+        }
+    }
+
+    //Collect function regions at first, since regions may be added
+    //during processing.
+    List<Region*> funcs;
+    for (UINT i = 0; i < getNumOfRegion(); i++) {
+        Region * ru = get_region(i);
+        if (ru == NULL || !ru->is_function()) { continue; }
+        funcs.append_tail(ru);
+    }
+
+    if (m_call_graph == NULL) {
+        //Can not determine the order, process regions serially.
+        bool succ = true;
+        for (Region * ru = funcs.get_head(); ru != NULL;
+             ru = funcs.get_next()) {
+            OptCtx oc;
+            if (!processFuncRegion(ru, &oc)) {
+                succ = false;
+            }
+        }
+        return succ;
+    }
+
+    Vector<UINT> cn2scc;
+    Vector<UINT> scc2level;
+    m_call_graph->computeBottomUpSCC(cn2scc, scc2level);
+
+    //Map SCC to its function regions.
+    Vector<List<Region*>*> scc2rus;
+    UINT maxlevel = 0;
+    for (Region * ru = funcs.get_head(); ru != NULL; ru = funcs.get_next()) {
+        CallNode * cn = m_call_graph->mapRegion2CallNode(ru);
+        ASSERT0(cn);
+        UINT scc = cn2scc.get(CN_id(cn));
+        ASSERT0(scc != 0);
+        List<Region*> * rus = scc2rus.get(scc);
+        if (rus == NULL) {
+            rus = new List<Region*>();
+            scc2rus.set(scc, rus);
+        }
+        rus->append_tail(ru);
+        maxlevel = MAX(maxlevel, scc2level.get(scc));
+    }
+
+    registerGlobalMD();
+
+    //Lock the shared tables even if thread_num is 1, so that the
+    //processing with different 'thread_num' are identical.
+    setSharedLock(true);
+
+    OptionSnapshot options;
+    Vector<List<Region*>*> task2rus;
+    FuncRegionTaskList tl;
+    tl.rumgr = this;
+    tl.options = &options;
+    tl.task2rus = &task2rus;
+    tl.ranges = new TaskIdRange[MAX(1, scc2rus.get_last_idx() + 1)];
+    tl.succ = (bool*)::malloc(sizeof(bool) *
+                              MAX(1, scc2rus.get_last_idx() + 1));
+    ASSERT0(tl.succ);
+
+    ThreadPool tp(thread_num);
+    bool succ = true;
+    for (UINT level = 0; level <= maxlevel; level++) {
+        task2rus.clean();
+        UINT n = 0;
+        for (INT scc = 1; scc <= scc2rus.get_last_idx(); scc++) {
+            List<Region*> * rus = scc2rus.get((UINT)scc);
+            if (rus == NULL || scc2level.get((UINT)scc) != level) {
+                continue;
+            }
+            UINT idnum = 0;
+            for (Region * ru = rus->get_head(); ru != NULL;
+                 ru = rus->get_next()) {
+                idnum += estimateIdNum(ru);
+            }
+            TaskIdRange & r = tl.ranges[n];
+            r.var.init(m_var_mgr->reserveId(idnum), idnum);
+            r.md.init(m_md_sys->reserveId(idnum), idnum);
+            r.label.init(reserveLabelId(idnum), idnum);
+            task2rus.set(n, rus);
+            n++;
+        }
+        if (n == 0) { continue; }
+
+        tp.run(n, processFuncRegionTask, &tl);
+
+        for (UINT i = 0; i < n; i++) {
+            if (!tl.succ[i]) { succ = false; }
+        }
+    }
+
+    setSharedLock(false);
+    delete [] tl.ranges;
+    ::free(tl.succ);
+    for (INT scc = 1; scc <= scc2rus.get_last_idx(); scc++) {
+        if (scc2rus.get((UINT)scc) != NULL) {
+            delete scc2rus.get((UINT)scc);
+        }
+    }
+
+    if (build_callg) {
+        //Call graph is built from the call sites before processing,
+        //regions may have changed them.
+        delete m_call_graph;
+        m_call_graph = NULL;
+    }
+    return succ;
+}
+
+
 //Process top-level region.
 //Top level region should be program.
 bool RegionMgr::processProgramRegion(Region * program, OptCtx * oc)
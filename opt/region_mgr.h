@@ -87,9 +87,16 @@ protected:
     UINT m_ru_count;
     List<UINT> m_free_ru_id;
     UINT m_label_count;
+    UINT m_reset_ru_count; //record m_ru_count when setResetPoint() invoked.
+    UINT m_reset_label_count; //record m_label_count at reset point.
     bool m_is_regard_str_as_same_md;
     TargInfo * m_targinfo;
 
+    //Lock of the objects shared by regions, it is not NULL only if
+    //regions are processed concurrently. The same lock is used by
+    //TypeMgr, VarMgr and MDSystem to avoid dead lock.
+    Mutex * m_shared_lock;
+
 protected:
     void estimateEV(OUT UINT & num_call,
                     OUT UINT & num_ru,
@@ -105,18 +112,26 @@ public:
         #endif
         m_ru_count = 1;
         m_label_count = 1;
+        m_reset_ru_count = 0;
+        m_reset_label_count = 0;
         m_var_mgr = NULL;
         m_md_sys = NULL;
         m_is_regard_str_as_same_md = true;
         m_str_md = NULL;
         m_call_graph = NULL;
         m_targinfo = NULL;
+        m_shared_lock = NULL;
         m_sym_tab.init(64);
+        m_sbs_mgr.set_flat(g_is_flat_sbs);
     }
     COPY_CONSTRUCTOR(RegionMgr);
     virtual ~RegionMgr();
 
-    SYM * addToSymbolTab(CHAR const* s) { return m_sym_tab.add(s); }
+    SYM * addToSymbolTab(CHAR const* s)
+    {
+        MutexHolder h(m_shared_lock);
+        return m_sym_tab.add(s);
+    }
 
     //This function will establish a map between region and its id.
     void addToRegionTab(Region * ru);
@@ -143,7 +158,11 @@ public:
 
     BitSetMgr * get_bs_mgr() { return &m_bs_mgr; }
     DefMiscBitSetMgr * get_sbs_mgr() { return &m_sbs_mgr; }
-    virtual Region * get_region(UINT id) { return m_id2ru.get(id); }
+    virtual Region * get_region(UINT id)
+    {
+        MutexHolder h(m_shared_lock);
+        return m_id2ru.get(id);
+    }
     UINT getNumOfRegion() const { return (UINT)(m_id2ru.get_last_idx() + 1); }
     VarMgr * get_var_mgr() { return m_var_mgr; }
     MD const* genDedicateStrMD();
@@ -154,6 +173,24 @@ public:
     VarMgr * get_var_mgr() const { return m_var_mgr; }
     TargInfo * get_targ_info() const { return m_targinfo; }
 
+    //Generate a new label id.
+    UINT genLabelId()
+    {
+        UINT rid = g_task_id_range != NULL ? g_task_id_range->label.alloc() : 0;
+        if (rid != 0) { return rid; }
+        MutexHolder h(m_shared_lock);
+        return m_label_count++;
+    }
+
+    //Reserve 'num' consecutive label ids, return the first one.
+    UINT reserveLabelId(UINT num)
+    {
+        MutexHolder h(m_shared_lock);
+        UINT start = m_label_count;
+        m_label_count += num;
+        return start;
+    }
+
     //Register exact MD for each global variable.
     //Note you should call this function as early as possible, e.g, before process
     //all regions. Because that will assign smaller MD id to global variable.
@@ -177,15 +214,50 @@ public:
 
     Region * newRegion(REGION_TYPE rt);
 
+    //Reset RegionMgr to the state at the time setResetPoint() invoked.
+    //Regions, VARs and MDs generated after reset point are destroyed,
+    //whereas SymTab, TypeMgr and memory pools are kept.
+    //The id of subsequent generated VAR, MD, Region and Label are
+    //identical to the situation of a fresh RegionMgr.
+    //e.g: Reuse RegionMgr for each function in non-IPA mode.
+    //    rm->initVarMgr();
+    //    ...register global VARs...
+    //    rm->setResetPoint();
+    //    for each function {
+    //        ...compile function...
+    //        rm->reset();
+    //    }
+    virtual void reset();
+
     void set_targ_info(TargInfo * ti) { m_targinfo = ti; }
 
+    //Regard Regions, VARs and MDs allocated so far as persistent objects,
+    //which will be kept by reset().
+    void setResetPoint();
+
     //Process region in the form of function type.
     virtual bool processFuncRegion(IN Region * func, OptCtx * oc);
 
+    //Process function regions recorded via addToRegionTab() in
+    //bottom-up order of call graph, callees are processed before
+    //callers. The strongly connected components of call graph that in
+    //same level are independent, and are processed by 'thread_num'
+    //threads concurrently.
+    //The ids of VAR, MD and label created by each component are allocated
+    //from the ranges reserved in the order of call graph, thus the result
+    //does not depend on 'thread_num'.
+    //Return false if any of region failed.
+    bool processFuncRegionBottomUp(UINT thread_num);
+
     //Process top-level region unit.
     //Top level region unit should be program unit.
     virtual bool processProgramRegion(IN Region * program, OptCtx * oc);
 
+    //Set whether regions are processed concurrently. If 'lock' is
+    //true, TypeMgr, VarMgr and MDSystem are protected by lock,
+    //and the id of Region, VAR and MD will not be recycled.
+    void setSharedLock(bool lock);
+
     bool verifyPreDefinedInfo();
 };
 //END RegionMgr
@@ -48,10 +48,10 @@ namespace xoc {
 #define ERR_BUF_LEN 1024
 
 //Print \l as the Carriage Return.
-bool g_prt_carriage_return_for_dot = false;
-INT g_indent = 0;
-FILE * g_tfile = NULL;
-static SMemPool * g_pool_tmp_used = NULL;
+THREAD_LOCAL bool g_prt_carriage_return_for_dot = false;
+THREAD_LOCAL INT g_indent = 0;
+THREAD_LOCAL FILE * g_tfile = NULL;
+static THREAD_LOCAL SMemPool * g_pool_tmp_used = NULL;
 static CHAR g_indent_chars = ' ';
 
 void interwarn(CHAR const* format, ...)
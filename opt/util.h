@@ -271,9 +271,9 @@ void dump_rbt(RBT<T, Ttgt> & rbt,
 }
 
 //Exported Variables
-extern FILE * g_tfile; //Only for dump.
-extern INT g_indent; //Only for dump.
-extern bool g_prt_carriage_return_for_dot; //Only for dump.
+extern THREAD_LOCAL FILE * g_tfile; //Only for dump.
+extern THREAD_LOCAL INT g_indent; //Only for dump.
+extern THREAD_LOCAL bool g_prt_carriage_return_for_dot; //Only for dump.
 
 void dumpIndent(FILE * h, UINT indent);
 void dumpIntVector(Vector<UINT> & v);
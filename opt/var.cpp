@@ -35,11 +35,16 @@ author: Su Zhenyu
 
 namespace xoc {
 
+THREAD_LOCAL TaskIdRange * g_task_id_range = NULL;
+
 VarMgr::VarMgr(RegionMgr * rm)
 {
     ASSERT0(rm);
+    m_lock = NULL;
     m_var_count = 1; //for enjoying bitset util
     m_str_count = 1;
+    m_reset_var_count = 0;
+    m_reset_str_count = 0;
     m_ru_mgr = rm;
     m_tm = rm->get_type_mgr();
 }
@@ -202,6 +207,7 @@ CHAR const* VAR::dump(StrBuf & buf, TypeMgr const* dm) const
 void VarMgr::destroyVar(VAR * v)
 {
     ASSERT0(VAR_id(v) != 0);
+    MutexHolder h(m_lock);
     m_freelist_of_varid.bunion(VAR_id(v), *m_ru_mgr->get_sbs_mgr());
     m_var_vec.set(VAR_id(v), NULL);
     delete v;
@@ -220,12 +226,49 @@ void VarMgr::destroy()
 }
 
 
+//Regard VARs registered so far as persistent, they will be kept
+//by reset().
+void VarMgr::setResetPoint()
+{
+    ASSERT(m_freelist_of_varid.is_empty(),
+           ("VAR id can not be recycled before reset point"));
+    m_reset_var_count = m_var_count;
+    m_reset_str_count = m_str_count;
+}
+
+
+//Destroy VARs registered after reset point, and the id of subsequent
+//registered VAR will be assigned from reset point.
+void VarMgr::reset()
+{
+    ASSERT(m_reset_var_count != 0, ("invoke setResetPoint() at first"));
+    for (INT i = (INT)m_reset_var_count; i <= m_var_vec.get_last_idx(); i++) {
+        VAR * v = m_var_vec.get((UINT)i);
+        if (v == NULL) { continue; }
+        if (v->is_string() && VAR_str(v) != NULL &&
+            m_str_tab.get(VAR_str(v)) == v) {
+            m_str_tab.remove(VAR_str(v));
+        }
+        m_var_vec.set((UINT)i, NULL);
+        delete v;
+    }
+    m_freelist_of_varid.clean(*m_ru_mgr->get_sbs_mgr());
+    m_var_count = m_reset_var_count;
+    m_str_count = m_reset_str_count;
+}
+
+
 void VarMgr::assignVarId(VAR * v)
 {
     SEGIter * iter = NULL;
-    INT id = m_freelist_of_varid.get_first(&iter);
+    //Do not reuse id while VarMgr is shared by multiple threads,
+    //otherwise the id depends on the order of thread.
+    INT id = m_lock != NULL ? -1 : m_freelist_of_varid.get_first(&iter);
     ASSERT0(id != 0);
-    if (id > 0) {
+    UINT rid = g_task_id_range != NULL ? g_task_id_range->var.alloc() : 0;
+    if (rid != 0) {
+        VAR_id(v) = rid;
+    } else if (id > 0) {
         m_freelist_of_varid.diff(id, *m_ru_mgr->get_sbs_mgr());
         VAR_id(v) = id;
     } else {
@@ -271,6 +314,7 @@ VAR * VarMgr::registerVar(
     //VAR is string type, but not const string.
     //ASSERT(!type->is_string(), ("use registerStringVar instead of"));
 
+    MutexHolder h(m_lock);
     VAR * v = allocVAR();
     VAR_type(v) = type;
     VAR_name(v) = var_name;
@@ -289,6 +333,7 @@ VAR * VarMgr::registerVar(
 VAR * VarMgr::registerStringVar(CHAR const* var_name, SYM const* s, UINT align)
 {
     ASSERT0(s != NULL);
+    MutexHolder h(m_lock);
     VAR * v;
     if ((v = m_str_tab.get(s)) != NULL) {
         return v;
@@ -331,14 +331,46 @@ typedef TMap<SYM const*, VAR*> ConstSym2Var;
 //Map from VAR id to VAR.
 typedef Vector<VAR*> VarVec;
 
+//Record a range of id, ids are allocated in ascending order.
+class IdRange {
+public:
+    UINT cur; //the next id to allocate.
+    UINT end; //the first id out of range.
+public:
+    IdRange() { cur = 0; end = 0; }
+
+    //Return the next id, or 0 if the range is exhausted.
+    UINT alloc() { return cur < end ? cur++ : 0; }
+    void init(UINT start, UINT num) { cur = start; end = start + num; }
+};
+
+
+//Ranges of VAR, MD and label id reserved for the task that current
+//thread is processing, see RegionMgr::processFuncRegionBottomUp().
+//Objects created by the task are numbered in the ranges rather than
+//by the counters shared by threads, thus their ids do not depend on
+//the interleaving of threads.
+class TaskIdRange {
+public:
+    IdRange var;
+    IdRange md;
+    IdRange label;
+};
+
+//It is NULL if ids are allocated from the shared counters.
+extern THREAD_LOCAL TaskIdRange * g_task_id_range;
+
 //This class is responsible for allocation and deallocation of VAR.
 //User can only create VAR via VarMgr, as well as delete it in the same way.
 class VarMgr {
 protected:
+    Mutex * m_lock;
     size_t m_var_count;
     VarVec m_var_vec;
     ConstSym2Var m_str_tab;
     size_t m_str_count;
+    size_t m_reset_var_count; //record m_var_count at reset point.
+    size_t m_reset_str_count; //record m_str_count at reset point.
     DefSBitSetCore m_freelist_of_varid;
     RegionMgr * m_ru_mgr;
     TypeMgr * m_tm;
@@ -357,9 +389,31 @@ public:
 
     TypeMgr * get_type_mgr() const { return m_tm; }
     VarVec * get_var_vec() { return &m_var_vec; }
-    VAR * get_var(size_t id) const { return m_var_vec.get((UINT)id); }
+    VAR * get_var(size_t id) const
+    {
+        MutexHolder h(m_lock);
+        return m_var_vec.get((UINT)id);
+    }
+
+    VAR * findStringVar(SYM const* str)
+    {
+        MutexHolder h(m_lock);
+        return m_str_tab.get(str);
+    }
 
-    VAR * findStringVar(SYM const* str) { return m_str_tab.get(str); }
+    //Set the lock to protect VarMgr from being accessed by multiple
+    //threads simultaneously. 'lock' may be NULL if there is only one
+    //thread. The id of destroyed VAR is not reused while the lock is set.
+    void set_lock(Mutex * lock) { m_lock = lock; }
+
+    //Reserve 'num' consecutive VAR ids, return the first one.
+    UINT reserveId(UINT num)
+    {
+        MutexHolder h(m_lock);
+        UINT start = (UINT)m_var_count;
+        m_var_count += num;
+        return start;
+    }
 
     //Interface to target machine.
     //Customer could specify additional attributions for specific purpose.
@@ -379,6 +433,13 @@ public:
 
     //Create a String VAR.
     VAR * registerStringVar(CHAR const* var_name, SYM const* s, UINT align);
+
+    //Destroy VARs registered after reset point.
+    void reset();
+
+    //Regard VARs registered so far as persistent, they will be kept
+    //by reset().
+    void setResetPoint();
 };
 
 } //namespace xoc